@@ -54,6 +54,7 @@ function( print_faodel_config_summary )
   message( STATUS "Faodel Common Config:" )
   message( STATUS "   Threading Model:         ${Faodel_THREADING_MODEL}" )
   message( STATUS "   Logging Method:          ${Faodel_LOGGING_METHOD}" )
+  message( STATUS "   Logging Min Level:       ${Faodel_LOGGING_MIN_LEVEL}" )
   message( STATUS "" )
   message( STATUS "Lunasa Config:" )
   if ( ${Faodel_ENABLE_TCMALLOC} )
@@ -92,6 +93,24 @@ function( print_faodel_config_summary )
       message( STATUS "   Not building the MPI Transport" )
     endif()
   endif()
+  if( NNTI_BUILD_SHM )
+    message( STATUS "   Building the SHM Transport" )
+  else()
+    if( NNTI_DISABLE_SHM_TRANSPORT )
+      message( STATUS "   SHM Transport explicitly disabled" )
+    else()
+      message( STATUS "   Not building the SHM Transport" )
+    endif()
+  endif()
+  if( NNTI_BUILD_SOCKETS )
+    message( STATUS "   Building the Sockets Transport" )
+  else()
+    if( NNTI_DISABLE_SOCKETS_TRANSPORT )
+      message( STATUS "   Sockets Transport explicitly disabled" )
+    else()
+      message( STATUS "   Not building the Sockets Transport" )
+    endif()
+  endif()
   if( ${NNTI_USE_XDR} )
     message( STATUS "   Using XDR for serialization" )
   else()
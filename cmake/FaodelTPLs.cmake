@@ -37,7 +37,7 @@ if( FAODEL_FORCE_BOOST_STATIC_LINKING OR REQUIRE_STATIC_LINKING )
   set( Boost_USE_STATIC_LIBS ON )
 endif()
 
-find_package( Boost 1.60
+find_package( Boost 1.66
   COMPONENTS system log log_setup thread serialization program_options
   REQUIRED )
 
@@ -42,6 +42,16 @@ bool GetRemoteDirectoryInfo(const ResourceURL &url, DirectoryInfo *dir_info) {
   return dirman::internal::Singleton::impl.core->GetDirectoryInfo(url, false, true,  dir_info);
 }
 
+//Lookup information about several directories at once. Results are appended to dir_infos in
+//the same order as urls, with an empty DirectoryInfo for each entry that was not found. Any
+//entries missing from the local cache are fetched from the remote node in a single request.
+bool GetDirectoryInfo(const vector<ResourceURL> &urls, vector<DirectoryInfo> *dir_infos) {
+  return dirman::internal::Singleton::impl.core->GetDirectoryInfoBatch(urls, true, true, dir_infos);
+}
+bool GetLocalDirectoryInfo(const vector<ResourceURL> &urls, vector<DirectoryInfo> *dir_infos) {
+  return dirman::internal::Singleton::impl.core->GetDirectoryInfoBatch(urls, true, false, dir_infos);
+}
+
 
 /**
  * @brief Define a new resource (when no nodes have been allocated yet)
@@ -105,6 +115,31 @@ bool DropDir(const faodel::ResourceURL &url) {
   return dirman::internal::Singleton::impl.core->DropDir(url);
 }
 
+/**
+ * @brief Get a callback each time a node joins or leaves a directory, or the directory is dropped
+ * @param url The directory to watch
+ * @param callback Function that is handed a DirectoryChange for each change
+ * @retval TRUE The watch was registered with the directory's owner
+ * @retval FALSE The url was invalid or the owner could not be reached
+ *
+ * The owner of the directory pushes each change to this node, which updates
+ * its cached copy of the directory before running the callback. Callbacks
+ * run on an opbox thread and should return quickly.
+ */
+bool Watch(const faodel::ResourceURL &url, fn_watch_t callback) {
+  return dirman::internal::Singleton::impl.core->Watch(url, std::move(callback));
+}
+
+/**
+ * @brief Remove this node's callbacks for a directory and stop receiving its changes
+ * @param url The directory to stop watching
+ * @retval TRUE This node was watching the directory
+ * @retval FALSE This node was not watching the directory
+ */
+bool Unwatch(const faodel::ResourceURL &url) {
+  return dirman::internal::Singleton::impl.core->Unwatch(url);
+}
+
 /**
  * @brief Return info on which node dirman talks to for locating info
  * @return nodeid_t The id of the node that's in charge (eg root node)
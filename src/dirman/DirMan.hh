@@ -9,6 +9,7 @@
 #include "faodel-common/DirectoryInfo.hh"
 
 #include "dirman/common/DirectoryCache.hh"
+#include "dirman/common/DirectoryChange.hh"
 #include "dirman/common/DirectoryOwnerCache.hh"
 
 
@@ -22,6 +23,9 @@ bool GetDirectoryInfo(const faodel::ResourceURL &url, faodel::DirectoryInfo *dir
 bool GetLocalDirectoryInfo(const faodel::ResourceURL &url, faodel::DirectoryInfo *dir_info);
 bool GetRemoteDirectoryInfo(const faodel::ResourceURL &url, faodel::DirectoryInfo *dir_info);
 
+bool GetDirectoryInfo(const std::vector<faodel::ResourceURL> &urls, std::vector<faodel::DirectoryInfo> *dir_infos);
+bool GetLocalDirectoryInfo(const std::vector<faodel::ResourceURL> &urls, std::vector<faodel::DirectoryInfo> *dir_infos);
+
 bool DefineNewDir(const faodel::ResourceURL &url);
 
 bool HostNewDir(const faodel::DirectoryInfo &dir_info);
@@ -34,6 +38,9 @@ bool LeaveDir(const faodel::ResourceURL &url, faodel::DirectoryInfo *dir_info=nu
 
 bool DropDir(const faodel::ResourceURL &url);
 
+bool Watch(const faodel::ResourceURL &url, fn_watch_t callback);
+bool Unwatch(const faodel::ResourceURL &url);
+
 faodel::nodeid_t GetAuthorityNode();
 
 void GetCachedNames(std::vector<std::string> *names);
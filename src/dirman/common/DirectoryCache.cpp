@@ -18,8 +18,14 @@ namespace dirman {
 
 const std::string DirectoryCache::auto_generate_option_label = "ag";
 
+//Don't bother sweeping for expired entries until at least this many are tracked
+static const size_t min_sweep_size = 64;
+
 DirectoryCache::DirectoryCache(const string &full_name)
-        : LoggingInterface(full_name), mutex(nullptr) {
+        : LoggingInterface(full_name),
+          lease_ttl(0), negative_ttl(0),
+          next_sweep_size(min_sweep_size),
+          mutex(nullptr) {
 
 }
 
@@ -39,6 +45,31 @@ void DirectoryCache::Init(const faodel::Configuration &config, string threading_
   mutex = GenerateMutex(threading_model, mutex_type);
 
 }
+
+/**
+ * @brief Set how long entries and misses remain valid in this cache
+ * @param[in] lease_ttl_ms How long an entry is returned by Lookup after it is written (0 = forever)
+ * @param[in] negative_ttl_ms How long MarkMissing remembers a resource is missing (0 = disabled)
+ * @note Leases only apply to entries written after this call
+ */
+void DirectoryCache::SetLeaseTimes(uint64_t lease_ttl_ms, uint64_t negative_ttl_ms) {
+  mutex->WriterLock();
+  lease_ttl = std::chrono::milliseconds(lease_ttl_ms);
+  negative_ttl = std::chrono::milliseconds(negative_ttl_ms);
+  if(negative_ttl.count()==0) missing_resources.clear();
+  mutex->Unlock();
+}
+
+/**
+ * @brief Replace the time source used for leases and misses
+ * @param[in] iuo Internal use only (testing)
+ * @param[in] clock_fn Function that reports the current time (empty = std::chrono::steady_clock)
+ */
+void DirectoryCache::SetClock(faodel::internal_use_only_t iuo, fn_clock_t clock_fn) {
+  mutex->WriterLock();
+  this->clock_fn = clock_fn;
+  mutex->Unlock();
+}
 /**
  * @brief Add a new DirectoryInfo to the cache. Abort if item already exists
  * @param resource -  The new resource
@@ -46,7 +77,7 @@ void DirectoryCache::Init(const faodel::Configuration &config, string threading_
  * @retval FALSE The resource already exists and therefore was NOT modified
  */
 bool DirectoryCache::Create(const DirectoryInfo &resource){
-  dbg("Create "+ resource.url.GetFullURL());
+  F_LOG_DBG("Create "+ resource.url.GetFullURL());
   return write(resource, false);
 }
 /**
@@ -57,7 +88,7 @@ bool DirectoryCache::Create(const DirectoryInfo &resource){
  * @retval FALSE One or more of the resources could not be created (already existed, or invalid)
  */
 bool DirectoryCache::Create(const vector<DirectoryInfo> &resources, int *num_created){
-  dbg("Create vector with "+to_string(resources.size())+" items");
+  F_LOG_DBG("Create vector with "+to_string(resources.size())+" items");
   return write(resources, num_created, false);
 }
 /**
@@ -69,7 +100,7 @@ bool DirectoryCache::Create(const vector<DirectoryInfo> &resources, int *num_cre
  */
 bool DirectoryCache::CreateAndLinkParents(const DirectoryInfo &resource){
   bool ok;
-  dbg("CreateAndLinkParents "+resource.url.GetFullURL());
+  F_LOG_DBG("CreateAndLinkParents "+resource.url.GetFullURL());
   if(!resource.url.Valid()) return false;
   mutex->WriterLock();
 
@@ -92,6 +123,7 @@ bool DirectoryCache::CreateAndLinkParents(const DirectoryInfo &resource){
         //Didn't find parent, so create it and add to the map
         pdir = new DirectoryInfo(parent_url);
         known_resources[parent_url.GetBucketPathName()] = pdir;
+        missing_resources.erase(parent_url.GetBucketPathName());
       }
 
       //Either way, link to the child. Note: child may already be here depending
@@ -112,7 +144,7 @@ bool DirectoryCache::CreateAndLinkParents(const DirectoryInfo &resource){
  * @retval FALSE Entry was not found in the cache
  */
 bool DirectoryCache::Remove(const ResourceURL &dir_url){
-  dbg("Remove "+ dir_url.GetFullURL());
+  F_LOG_DBG("Remove "+ dir_url.GetFullURL());
 
   mutex->WriterLock();
   DirectoryInfo *r;
@@ -151,7 +183,7 @@ bool DirectoryCache::Remove(const ResourceURL &dir_url){
  * @retval FALSE The resource wasn't valid
  */
 bool DirectoryCache::Update(const DirectoryInfo &resource) {
-  dbg("Update "+resource.url.GetFullURL());
+  F_LOG_DBG("Update "+resource.url.GetFullURL());
   return write(resource, true);
 }
 /**
@@ -162,7 +194,7 @@ bool DirectoryCache::Update(const DirectoryInfo &resource) {
  * @retval FALSE One or more of the resources were not valid
  */
 bool DirectoryCache::Update(const vector<DirectoryInfo> &resources, int *num_created){
-  dbg("Update vector with "+to_string(resources.size())+" items");
+  F_LOG_DBG("Update vector with "+to_string(resources.size())+" items");
   return write(resources, num_created, true);
 }
 
@@ -175,7 +207,7 @@ bool DirectoryCache::Update(const vector<DirectoryInfo> &resources, int *num_cre
  */
 bool DirectoryCache::write(const DirectoryInfo &resource, bool overwrite_existing){
   bool ok;
-  dbg("Write resource "+resource.url.GetFullURL());
+  F_LOG_DBG("Write resource "+resource.url.GetFullURL());
   if(!resource.url.Valid()) return false;
   mutex->WriterLock();
   ok = _write(resource, overwrite_existing);
@@ -219,7 +251,14 @@ bool DirectoryCache::_write(const DirectoryInfo &resource_info, bool overwrite_e
   //Copy the resource and place it in
   r = new DirectoryInfo;
   *r = resource_info;
-  known_resources[resource_info.url.GetBucketPathName()] = r;
+  string bucket_path_name = resource_info.url.GetBucketPathName();
+  known_resources[bucket_path_name] = r;
+  missing_resources.erase(bucket_path_name);
+  if(lease_ttl.count()>0) {
+    auto now = _now();
+    lease_expirations[bucket_path_name] = now + lease_ttl;
+    _sweepExpiredIfNeeded(now);
+  }
   return true;
 }
 
@@ -232,7 +271,7 @@ bool DirectoryCache::_write(const DirectoryInfo &resource_info, bool overwrite_e
  */
 bool DirectoryCache::Join(const faodel::ResourceURL &child_url, DirectoryInfo *resource_info){
 
-  dbg("Join resource "+child_url.GetURL());
+  F_LOG_DBG("Join resource "+child_url.GetURL());
 
   string option_autogen = child_url.GetOption(auto_generate_option_label);
   bool needs_autogen = (option_autogen=="1");
@@ -246,7 +285,7 @@ bool DirectoryCache::Join(const faodel::ResourceURL &child_url, DirectoryInfo *r
 
   //Abort if we were given a named child and its at the root - nowhere to add
   if((!needs_autogen) &&child_url.IsRootLevel()) {
-    dbg("Attempted join using a root url "+child_url.GetURL());
+    F_LOG_DBG("Attempted join using a root url "+child_url.GetURL());
     if(resource_info) *resource_info = DirectoryInfo();
     return false;
   }
@@ -276,11 +315,11 @@ bool DirectoryCache::Leave(const faodel::ResourceURL &child_url, DirectoryInfo *
   bool found;
   bool removed=false;
 
-  dbg("Leave resource "+child_url.GetURL());
+  F_LOG_DBG("Leave resource "+child_url.GetURL());
 
   //Abort if this was a root url. Nothing to join
   if(child_url.path=="/") {
-    dbg("Attempted join using a root url "+child_url.GetURL());
+    F_LOG_DBG("Attempted join using a root url "+child_url.GetURL());
     if(resource_info) *resource_info = DirectoryInfo();
     return false;
   }
@@ -307,7 +346,7 @@ bool DirectoryCache::Lookup(const faodel::ResourceURL &search_url, DirectoryInfo
   bool found;
   DirectoryInfo *r;
 
-  dbg("Lookup " + search_url.GetBucketPathName());
+  F_LOG_DBG("Lookup " + search_url.GetBucketPathName());
 
   mutex->ReaderLock();
 
@@ -319,6 +358,11 @@ bool DirectoryCache::Lookup(const faodel::ResourceURL &search_url, DirectoryInfo
   } else {
     //Normal lookup for a subdirectory
     found = _lookup(search_url, &r, reference_node);
+    if(found && _leaseExpired(search_url.GetBucketPathName(), _now())) {
+      F_LOG_DBG("Lookup lease expired for " + search_url.GetBucketPathName());
+      found = false;
+      if(reference_node) *reference_node = NODE_UNSPECIFIED;
+    }
     if(resource_info) *resource_info = (found) ? *r : DirectoryInfo(); //Not found: set to empty
   }
   mutex->Unlock();
@@ -337,6 +381,7 @@ bool DirectoryCache::Lookup(const vector<faodel::ResourceURL> &resource_urls, ve
   bool all_found=true;
 
   mutex->ReaderLock();
+  auto now = _now();
   for(const auto &resource_url : resource_urls) {
     DirectoryInfo *r;
     if(resource_url.IsRoot()) {
@@ -347,7 +392,8 @@ bool DirectoryCache::Lookup(const vector<faodel::ResourceURL> &resource_urls, ve
         resource_infos->push_back( (found) ? resource_info : DirectoryInfo() );
       }
     } else {
-      found = _lookup(resource_url, &r, nullptr);
+      found = _lookup(resource_url, &r, nullptr) &&
+              !_leaseExpired(resource_url.GetBucketPathName(), now);
       if(resource_infos){
         resource_infos->push_back( (found) ? *r : DirectoryInfo() );
       }
@@ -360,6 +406,38 @@ bool DirectoryCache::Lookup(const vector<faodel::ResourceURL> &resource_urls, ve
 }
 
 
+/**
+ * @brief Remember that a resource could not be found (negative caching)
+ * @param[in] url The resource that was missing
+ * @note Does nothing unless a negative ttl was set with SetLeaseTimes
+ */
+void DirectoryCache::MarkMissing(const faodel::ResourceURL &url) {
+  mutex->WriterLock();
+  if(negative_ttl.count()>0) {
+    auto now = _now();
+    missing_resources[url.GetBucketPathName()] = now + negative_ttl;
+    _sweepExpiredIfNeeded(now);
+  }
+  mutex->Unlock();
+}
+
+/**
+ * @brief Determine if a resource was recently marked as missing
+ * @param[in] url The resource to check
+ * @retval TRUE The resource was marked missing and the negative entry has not expired
+ * @retval FALSE The resource was not marked missing (or the negative entry expired)
+ */
+bool DirectoryCache::IsKnownMissing(const faodel::ResourceURL &url) {
+  bool missing=false;
+  mutex->ReaderLock();
+  if(!missing_resources.empty()) {
+    auto it = missing_resources.find(url.GetBucketPathName());
+    missing = ((it != missing_resources.end()) && (it->second > _now()));
+  }
+  mutex->Unlock();
+  if(missing) F_LOG_DBG("IsKnownMissing hit for "+url.GetBucketPathName());
+  return missing;
+}
 
 /**
  * @brief Return a copy of all the entries that are known
@@ -421,6 +499,7 @@ void DirectoryCache::whookieInfo(faodel::ReplyStream &rs){
 
 void DirectoryCache::sstr(stringstream &ss, int depth, int indent) const {
   ss << string(indent,' ')<<"["<<GetFullName()<<"] Items: "<<known_resources.size()
+     <<" KnownMissing: "<<missing_resources.size()
      <<" Debug: "<<GetDebug()<<endl;
   if(depth>0) {
     //for(map<string,DirectoryInfo *>::const_iterator it = known_resources.begin(); it!=known_resources.end(); it++){
@@ -462,7 +541,7 @@ bool DirectoryCache::_lookup(const faodel::ResourceURL &url, DirectoryInfo **res
 
   it=known_resources.find(bucket_path_name);
   if(it==known_resources.end()) {
-    dbg("_lookup miss for "+bucket_path_name);
+    F_LOG_DBG("_lookup miss for "+bucket_path_name);
     //cout <<"  DC known items:\n";
     //for(auto &name_rip : known_resources){
     //  cout <<"    "<<name_rip.first <<" --> "<<name_rip.second->url.str();
@@ -478,6 +557,49 @@ bool DirectoryCache::_lookup(const faodel::ResourceURL &url, DirectoryInfo **res
   if(reference_node) *reference_node = it->second->url.reference_node;
   return true;
 }
+/**
+ * @brief Determine if an entry's lease has run out (requires lock)
+ * @param bucket_path_name The entry's name
+ * @param now The current time
+ * @retval TRUE The entry has a lease and it has expired
+ * @retval FALSE The entry is still valid (or it never expires)
+ */
+bool DirectoryCache::_leaseExpired(const string &bucket_path_name, std::chrono::steady_clock::time_point now) const {
+  if(lease_expirations.empty()) return false;
+  auto it = lease_expirations.find(bucket_path_name);
+  return ((it != lease_expirations.end()) && (it->second <= now));
+}
+
+/**
+ * @brief Drop expired misses and lease-expired entries once enough have piled up (requires writer lock)
+ * @param now The current time
+ * @note The next sweep waits until the number of tracked expirations doubles, so the cost of
+ *       a sweep is spread over the writes that came before it
+ */
+void DirectoryCache::_sweepExpiredIfNeeded(std::chrono::steady_clock::time_point now) {
+
+  if(missing_resources.size() + lease_expirations.size() < next_sweep_size) return;
+
+  for(auto it=missing_resources.begin(); it!=missing_resources.end(); ) {
+    if(it->second <= now) it = missing_resources.erase(it);
+    else                  ++it;
+  }
+
+  //An expired entry is no longer returned by Lookup, so release it. Only drop this
+  //entry: its children have their own leases
+  for(auto it=lease_expirations.begin(); it!=lease_expirations.end(); ) {
+    if(it->second > now) { ++it; continue; }
+    auto rit = known_resources.find(it->first);
+    if(rit != known_resources.end()) {
+      delete rit->second;
+      known_resources.erase(rit);
+    }
+    it = lease_expirations.erase(it);
+  }
+
+  next_sweep_size = std::max(min_sweep_size, 2*(missing_resources.size() + lease_expirations.size()));
+}
+
 bool DirectoryCache::_lookupRootDir(bucket_t bucket, faodel::DirectoryInfo *resource_info) {
   bool found=false;
   F_ASSERT(resource_info != nullptr, "Invalid resource info pointer");
@@ -521,13 +643,14 @@ bool DirectoryCache::_removeSingleDir(const faodel::ResourceURL &url, std::vecto
   it=known_resources.find(bucket_path_name);
   if(it==known_resources.end()) return false;
 
-  dbg("_removeSingleDir removing: "+bucket_path_name);
+  F_LOG_DBG("_removeSingleDir removing: "+bucket_path_name);
 
   DirectoryInfo *r = it->second;
   known_resources.erase(it);
+  lease_expirations.erase(bucket_path_name);
   for( auto &name_node : r->members ){
     if((members!=nullptr) && (!name_node.name.empty())){
-      dbg("_removeSingleDir marking for removal: "+bucket_path_name+"/"+name_node.name);
+      F_LOG_DBG("_removeSingleDir marking for removal: "+bucket_path_name+"/"+name_node.name);
       members->push_back( ResourceURL(bucket_path_name+"/"+name_node.name));
     }
   }
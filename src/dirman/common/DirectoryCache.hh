@@ -5,6 +5,8 @@
 #ifndef DIRMAN_DIRECTORYCACHE_HH
 #define DIRMAN_DIRECTORYCACHE_HH
 
+#include <chrono>
+#include <functional>
 #include <string>
 #include <vector>
 #include <map>
@@ -21,6 +23,14 @@ namespace dirman {
  *
  * The DC is used to cache DirMan director resources. It stores the actual
  * DirectoryInfo resources.
+ *
+ * A cache that holds copies of remote entries can be given leases. When
+ * enabled, an entry that is written into the cache is only returned by
+ * Lookup until its lease expires. The cache can also remember which
+ * resources were recently found to be missing (negative caching), so a
+ * caller does not have to ask a remote node about them again right away.
+ * Expired entries and misses are dropped by a sweep that runs when writes
+ * have doubled the number of tracked expirations since the last sweep.
  */
 class DirectoryCache
         : public faodel::InfoInterface,
@@ -36,6 +46,10 @@ public:
   ~DirectoryCache() override;
 
   void Init(const faodel::Configuration &conf, std::string threading_model, std::string mutex_type);
+  void SetLeaseTimes(uint64_t lease_ttl_ms, uint64_t negative_ttl_ms);
+
+  using fn_clock_t = std::function<std::chrono::steady_clock::time_point()>;
+  void SetClock(faodel::internal_use_only_t iuo, fn_clock_t clock_fn); //!< Reserved for testing
 
   bool Create(const faodel::DirectoryInfo &resource);
   bool Create(const std::vector<faodel::DirectoryInfo> &resources, int *num_created=nullptr);
@@ -56,6 +70,9 @@ public:
   bool Lookup(const faodel::ResourceURL &search_url, faodel::DirectoryInfo *resource_info=nullptr, faodel::nodeid_t *reference_node=nullptr);
   bool Lookup(const std::vector<faodel::ResourceURL> &resource_urls, std::vector<faodel::DirectoryInfo> *resource_infos=nullptr);
 
+  void MarkMissing(const faodel::ResourceURL &url);
+  bool IsKnownMissing(const faodel::ResourceURL &url);
+
   //bool FindLastKnownParent(const faodel::ResourceURL &search_url, faodel::nodeid_t *node=nullptr, int *parent_steps_up=nullptr);
   void GetAllURLs(std::vector<faodel::ResourceURL> *urls=nullptr);
   std::vector<faodel::ResourceURL> GetAllURLs();
@@ -75,8 +92,17 @@ private:
   bool _lookup(const faodel::ResourceURL &url, faodel::DirectoryInfo **resource_info, faodel::nodeid_t *reference_node);
   bool _lookupRootDir(faodel::bucket_t, faodel::DirectoryInfo *resource_info);
   bool _removeSingleDir(const faodel::ResourceURL &url, std::vector<faodel::ResourceURL> *members=nullptr);
+  bool _leaseExpired(const std::string &bucket_path_name, std::chrono::steady_clock::time_point now) const;
+  void _sweepExpiredIfNeeded(std::chrono::steady_clock::time_point now);
+  std::chrono::steady_clock::time_point _now() const { return (clock_fn) ? clock_fn() : std::chrono::steady_clock::now(); }
 
   std::map<std::string, faodel::DirectoryInfo *> known_resources;
+  std::map<std::string, std::chrono::steady_clock::time_point> lease_expirations; //When entries stop being valid (leases only)
+  std::map<std::string, std::chrono::steady_clock::time_point> missing_resources; //Negative cache: when to forget a miss
+  std::chrono::milliseconds lease_ttl;    //How long an entry is valid after it is written (0=forever)
+  std::chrono::milliseconds negative_ttl; //How long a miss is remembered (0=disabled)
+  size_t next_sweep_size;                 //Sweep out expired entries when this many expirations are tracked
+  fn_clock_t clock_fn;                    //Time source for leases (empty=steady_clock)
   faodel::MutexWrapper *mutex;
 
 };
@@ -0,0 +1,62 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#ifndef DIRMAN_DIRECTORYCHANGE_HH
+#define DIRMAN_DIRECTORYCHANGE_HH
+
+#include <functional>
+#include <string>
+
+#include "faodel-common/Common.hh"
+
+namespace dirman {
+
+/**
+ * @brief A compact description of a single change to a directory's membership
+ *
+ * Nodes that watch a directory receive one of these for each change instead
+ * of a full copy of the DirectoryInfo. The url is the directory that
+ * changed. The member is the name/node that joined or left the directory and
+ * is empty when the whole directory was dropped.
+ */
+struct DirectoryChange {
+
+  enum class Type : uint8_t {
+    Invalid = 0,
+    Joined  = 1,
+    Left    = 2,
+    Dropped = 3
+  };
+
+  Type                type;   //!< What happened
+  faodel::ResourceURL url;    //!< The directory that changed
+  faodel::NameAndNode member; //!< Who joined or left (empty for Dropped)
+
+  DirectoryChange() : type(Type::Invalid), url(), member() {}
+  DirectoryChange(Type type, faodel::ResourceURL url, faodel::NameAndNode member=faodel::NameAndNode())
+    : type(type), url(std::move(url)), member(std::move(member)) {}
+
+  static std::string TypeName(Type t) {
+    switch(t) {
+      case Type::Joined:  return "Joined";
+      case Type::Left:    return "Left";
+      case Type::Dropped: return "Dropped";
+      default: return "Invalid";
+    }
+  }
+
+  template <typename Archive>
+  void serialize(Archive &ar, const unsigned int version) {
+    ar & type;
+    ar & url;
+    ar & member;
+  }
+};
+
+//Callback a watcher registers to hear about changes to a directory
+using fn_watch_t = std::function<void (const DirectoryChange &change)>;
+
+} // namespace dirman
+
+#endif // DIRMAN_DIRECTORYCHANGE_HH
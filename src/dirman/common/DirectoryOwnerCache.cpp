@@ -33,7 +33,7 @@ void DirectoryOwnerCache::Init(const faodel::Configuration &config, string threa
 
 bool DirectoryOwnerCache::Register(const faodel::ResourceURL &resource_url){
   bool ok;
-  dbg("Register URL "+resource_url.GetFullURL()+" Valid: "+to_string(resource_url.Valid()));
+  F_LOG_DBG("Register URL "+resource_url.GetFullURL()+" Valid: "+to_string(resource_url.Valid()));
   if(!resource_url.Valid()) return false;
   mutex->WriterLock();
   ok = _Register(resource_url);
@@ -46,7 +46,7 @@ bool DirectoryOwnerCache::Register(const std::vector<faodel::ResourceURL> &resou
 
   bool ok=true;
 
-  dbg("Register URL "+to_string(resource_urls.size())+" URLs");
+  F_LOG_DBG("Register URL "+to_string(resource_urls.size())+" URLs");
 
   //Only accept valid urls
   for(auto &url : resource_urls){
@@ -55,7 +55,7 @@ bool DirectoryOwnerCache::Register(const std::vector<faodel::ResourceURL> &resou
 
   mutex->WriterLock();
   for(auto &url: resource_urls){
-    dbg("Register URL "+url.GetURL()+" Valid: "+to_string(url.Valid()));
+    F_LOG_DBG("Register URL "+url.GetURL()+" Valid: "+to_string(url.Valid()));
     ok = ok && _Register(url);
   }
   mutex->Unlock();
@@ -81,7 +81,7 @@ bool DirectoryOwnerCache::Lookup(const faodel::ResourceURL &search_url, faodel::
   found = _Lookup(search_url, &node);
   if(reference_node) *reference_node = node; //_Lookup sets node to UNSPECIFIED if not found
   mutex->Unlock();
-  dbg("Lookup URL "+search_url.GetURL()+" found: "+to_string(found)+" node: "+node.GetHex());
+  F_LOG_DBG("Lookup URL "+search_url.GetURL()+" found: "+to_string(found)+" node: "+node.GetHex());
 
   return found;
 }
@@ -99,7 +99,7 @@ bool DirectoryOwnerCache::Lookup(const vector<faodel::ResourceURL> &search_urls,
     all_found = all_found && found;
   }
   mutex->Unlock();
-  dbg("Lookup "+to_string(search_urls.size())+" URLs, found_all: "+to_string(all_found));
+  F_LOG_DBG("Lookup "+to_string(search_urls.size())+" URLs, found_all: "+to_string(all_found));
   return all_found;
 }
 
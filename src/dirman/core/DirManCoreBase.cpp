@@ -6,8 +6,10 @@
 #include <fstream> //for ifstream parsing of file
 #include <unistd.h> //for sleep
 
+#include "opbox/OpBox.hh"
 #include "opbox/net/net.hh"
 #include "dirman/core/DirManCoreBase.hh"
+#include "dirman/ops/OpDirManCentralized.hh"
 
 using namespace std;
 using namespace faodel;
@@ -25,7 +27,8 @@ DirManCoreBase::DirManCoreBase(faodel::internal_use_only_t called_by_unconfigure
   : LoggingInterface("dirman","Unconfigured"),
     dc_others("dirman.cache.others"),
     dc_mine("dirman.cache.mine"),
-    doc("dirman.cache.owners"){
+    doc("dirman.cache.owners"),
+    watch_mutex(nullptr) {
 }
 
 /**
@@ -39,7 +42,8 @@ DirManCoreBase::DirManCoreBase(const faodel::Configuration &config, const string
     dc_mine("dirman.cache.mine"),
     doc("dirman.cache.owners"),
     my_node(NODE_UNSPECIFIED), 
-    strict_checking(false)  {
+    strict_checking(false),
+    watch_mutex(nullptr) {
 
   ConfigureLogging(config);
 
@@ -61,6 +65,7 @@ DirManCoreBase::DirManCoreBase(const faodel::Configuration &config, const string
   dc_others.Init(config, threading_model, mutex_type);
   dc_mine.Init(config, threading_model, mutex_type);
   doc.Init(config, threading_model, mutex_type);
+  watch_mutex = GenerateMutex(threading_model, mutex_type);
 
 
   //Load any references into our database
@@ -68,10 +73,10 @@ DirManCoreBase::DirManCoreBase(const faodel::Configuration &config, const string
     //A user can append several things in the url list. The assumption is
     //the last entry is the one to keep. Walk backwards through the list
     //and add to a map if the path/name doesn't already exist.
-    dbg("predefined resource size is "+std::to_string(predefined_resources.size()));
+    F_LOG_DBG("predefined resource size is "+std::to_string(predefined_resources.size()));
     map<std::string, ResourceURL> urls;
     for(int i=predefined_resources.size()-1; i>=0; i--){
-      dbg("Considering "+predefined_resources[i]);
+      F_LOG_DBG("Considering "+predefined_resources[i]);
       ResourceURL url(predefined_resources[i]);
       if(url.IsReference()) continue; //Never add pure references
       if(url.bucket == BUCKET_UNSPECIFIED) url.bucket = default_bucket;
@@ -95,11 +100,11 @@ DirManCoreBase::DirManCoreBase(const faodel::Configuration &config, const string
       set<string> ok_types={"local","trace","null"};
       bool not_local = ok_types.find(di.url.Type()) == ok_types.end();
       if((not_local) && (di.members.size()==0)) {
-        dbg("Not adding predefined resource "+key_url.first+" because it is not local and does not have any members");
+        F_LOG_DBG("Not adding predefined resource "+key_url.first+" because it is not local and does not have any members");
         throw runtime_error("Dirman aborted adding "+key_url.first+" because it was not a local resource and didn't have predefined members");
         continue;
       }
-      dbg("adding predefined resource "+key_url.first+" --> "+di.url.GetFullURL()+" Num Members="+std::to_string(di.members.size()));
+      F_LOG_DBG("adding predefined resource "+key_url.first+" --> "+di.url.GetFullURL()+" Num Members="+std::to_string(di.members.size()));
       dc_others.Create(di); //Note: this does not link parents
 
     }
@@ -125,7 +130,7 @@ DirManCoreBase::DirManCoreBase(const faodel::Configuration &config, const string
         if(new_url.bucket==BUCKET_UNSPECIFIED) new_url.bucket = default_bucket;
         if(new_url.resource_type == "") new_url.resource_type = "ref"; //Do not use! reference detection should be IsReference()
         urls_to_host.push_back(new_url);
-        dbg("This node now hosts: "+s+" which has url "+new_path);
+        F_LOG_DBG("This node now hosts: "+s+" which has url "+new_path);
       }
     }
   }
@@ -186,7 +191,9 @@ DirManCoreBase::DirManCoreBase(const faodel::Configuration &config, const string
 #endif
 
 }
-DirManCoreBase::~DirManCoreBase() = default;
+DirManCoreBase::~DirManCoreBase() {
+  delete watch_mutex;
+}
 
 /**
  * @brief Determine which node is the reference node for a particular resource
@@ -227,6 +234,28 @@ bool DirManCoreBase::GetDirectoryInfo(const faodel::ResourceURL &search_url, boo
   return false;
 }
 
+/**
+ * @brief Retrieve info about several resource directory entries at once
+ * @param search_urls - Resource URLs to look up
+ * @param check_local - Check our local cache for answers first
+ * @param check_remote - Check the remote node responsible for each dir (if local not successful)
+ * @param dir_infos - The resulting directory infos, appended in the same order as search_urls (empty value if no entry)
+ * @retval TRUE All entries were found
+ * @retval FALSE One or more entries were not found
+ * @note The base implementation does one GetDirectoryInfo per url. Derived classes should batch remote requests
+ */
+bool DirManCoreBase::GetDirectoryInfoBatch(const vector<faodel::ResourceURL> &search_urls, bool check_local, bool check_remote, vector<DirectoryInfo> *dir_infos) {
+  bool all_found=true;
+  for(const auto &url : search_urls) {
+    DirectoryInfo di;
+    bool ok = GetDirectoryInfo(url, check_local, check_remote, &di);
+    if(!ok) di = DirectoryInfo();
+    if(dir_infos) dir_infos->push_back(di);
+    all_found = all_found && ok;
+  }
+  return all_found;
+}
+
 
 
 /**
@@ -237,7 +266,7 @@ bool DirManCoreBase::GetDirectoryInfo(const faodel::ResourceURL &search_url, boo
  */
 bool DirManCoreBase::DefineNewDir(const DirectoryInfo &dir_info) {
 
-  dbg("DefineNewDir "+dir_info.url.GetFullURL());
+  F_LOG_DBG("DefineNewDir "+dir_info.url.GetFullURL());
 
   //Can't host it if it isn't valid
   if(!dir_info.url.Valid()){
@@ -265,7 +294,7 @@ bool DirManCoreBase::DefineNewDir(const DirectoryInfo &dir_info) {
  * @retval FALSE This did not complete because url wasn't valid
  */
 bool DirManCoreBase::DefineNewDir(const faodel::ResourceURL &url) {
-  dbg("DefineNewDir "+url.GetFullURL());
+  F_LOG_DBG("DefineNewDir "+url.GetFullURL());
   if(!url.Valid()){
     error("Attempted to define new resource with invalid url "+url.GetFullURL());
     return false;
@@ -281,7 +310,7 @@ bool DirManCoreBase::DefineNewDir(const faodel::ResourceURL &url) {
  */
 bool DirManCoreBase::HostNewDir(const DirectoryInfo &dir_info){
 
-  dbg("HostNewDir "+dir_info.url.GetFullURL());
+  F_LOG_DBG("HostNewDir "+dir_info.url.GetFullURL());
 
   //Can't host it if it isn't valid
   if(!dir_info.url.Valid()){
@@ -312,7 +341,7 @@ bool DirManCoreBase::HostNewDir(const DirectoryInfo &dir_info){
   //See if our parent is hosted here. Is so, join locally.
   nodeid_t parent_node;
   bool ok = discoverParent(dir_info.url, &parent_node);
-  dbg("hostresource discovered ok="+to_string(ok)+" parent was "+parent_node.GetHex());
+  F_LOG_DBG("hostresource discovered ok="+to_string(ok)+" parent was "+parent_node.GetHex());
 
   F_ASSERT(ok, "couldn't discover parent for "+dir_info.url.GetFullURL());
   if((parent_node == my_node)||(parent_node==NODE_LOCALHOST)){
@@ -367,6 +396,180 @@ void DirManCoreBase::GetCachedNames(std::vector<std::string> *resource_names) {
   dc_mine.GetAllNames(resource_names);
 }
 
+/**
+ * @brief Register a callback that runs whenever a directory's membership changes
+ * @param[in] url The directory to watch
+ * @param[in] callback The function to call with each change
+ * @retval TRUE The watch was registered
+ * @retval FALSE The url was invalid or the directory's owner could not be reached
+ *
+ * The first watch on a directory registers this node with the directory's
+ * owner, which replies with its current copy of the directory. After that,
+ * the owner sends a compact DirectoryChange for each join, leave, or drop.
+ * Each change is applied to this node's cached copy before the callbacks run,
+ * so GetDirectoryInfo() sees the new membership without asking the owner.
+ *
+ * @note Callbacks run on an opbox thread and should not block
+ */
+bool DirManCoreBase::Watch(const faodel::ResourceURL &url, fn_watch_t callback) {
+
+  ResourceURL url_mod = url;
+  if(url_mod.bucket == BUCKET_UNSPECIFIED)
+    url_mod.bucket = default_bucket;
+  if((!url_mod.Valid()) || (!callback)) return false;
+
+  string key = url_mod.GetBucketPathName();
+  watch_mutex->WriterLock();
+  auto &callbacks = watch_callbacks[key];
+  bool first_watch = callbacks.empty();
+  callbacks.push_back(std::move(callback));
+  watch_mutex->Unlock();
+
+  if(!first_watch) return true; //Owner already knows about us
+
+  nodeid_t owner = watchOwner(url_mod);
+  if(owner == my_node) {
+    AddWatcher(url_mod, my_node);
+    return true;
+  }
+
+  //Register with the owner. Its reply is the current copy of the dir
+  DirectoryInfo di;
+  try {
+    OpDirManCentralized *op = new OpDirManCentralized(OpDirManCentralized::RequestType::Watch, owner, url_mod);
+    future<DirectoryInfo> fut1 = op->GetFuture();
+    opbox::LaunchOp(op);
+    di = fut1.get();
+  } catch(const std::exception &e) {
+    warn("Could not watch "+url_mod.GetURL()+" at "+owner.GetHex()+": "+e.what());
+    watch_mutex->WriterLock();
+    watch_callbacks.erase(key);
+    watch_mutex->Unlock();
+    return false;
+  }
+  if(!di.IsEmpty())
+    dc_others.Update(di);
+  return true;
+}
+
+/**
+ * @brief Remove all of this node's callbacks for a directory and tell the owner to stop sending changes
+ * @param[in] url The directory to stop watching
+ * @retval TRUE This node was watching the directory
+ * @retval FALSE This node was not watching the directory
+ */
+bool DirManCoreBase::Unwatch(const faodel::ResourceURL &url) {
+
+  ResourceURL url_mod = url;
+  if(url_mod.bucket == BUCKET_UNSPECIFIED)
+    url_mod.bucket = default_bucket;
+
+  watch_mutex->WriterLock();
+  bool found = (watch_callbacks.erase(url_mod.GetBucketPathName()) > 0);
+  watch_mutex->Unlock();
+  if(!found) return false;
+
+  nodeid_t owner = watchOwner(url_mod);
+  if(owner == my_node) {
+    RemoveWatcher(url_mod, my_node);
+    return true;
+  }
+  try {
+    OpDirManCentralized *op = new OpDirManCentralized(OpDirManCentralized::RequestType::Unwatch, owner, url_mod);
+    future<DirectoryInfo> fut1 = op->GetFuture();
+    opbox::LaunchOp(op);
+    fut1.wait();
+  } catch(const std::exception &e) {
+    warn("Could not unwatch "+url_mod.GetURL()+" at "+owner.GetHex()+": "+e.what());
+  }
+  return true;
+}
+
+/**
+ * @brief Owner side: Remember that a node wants to hear about changes to one of this node's dirs
+ * @param[in] url The directory being watched
+ * @param[in] node The node that is watching
+ */
+void DirManCoreBase::AddWatcher(const faodel::ResourceURL &url, faodel::nodeid_t node) {
+  watch_mutex->WriterLock();
+  watchers[url.GetBucketPathName()].insert(node);
+  watch_mutex->Unlock();
+}
+
+/**
+ * @brief Owner side: Stop sending a node changes for a directory
+ * @param[in] url The directory being watched
+ * @param[in] node The node that is no longer watching
+ */
+void DirManCoreBase::RemoveWatcher(const faodel::ResourceURL &url, faodel::nodeid_t node) {
+  watch_mutex->WriterLock();
+  auto it = watchers.find(url.GetBucketPathName());
+  if(it != watchers.end()) {
+    it->second.erase(node);
+    if(it->second.empty()) watchers.erase(it);
+  }
+  watch_mutex->Unlock();
+}
+
+/**
+ * @brief Watcher side: Apply a change from a directory's owner to our cached copy and run the callbacks
+ * @param[in] change The change the owner sent
+ */
+void DirManCoreBase::DeliverChange(const DirectoryChange &change) {
+
+  dbg("Change "+DirectoryChange::TypeName(change.type)+" for "+change.url.GetURL());
+
+  //Patch our cached copy. If we don't have one, the next lookup will fetch it
+  if(change.type == DirectoryChange::Type::Dropped) {
+    dc_others.Remove(change.url);
+  } else {
+    DirectoryInfo di;
+    if(dc_others.Lookup(change.url, &di)) {
+      if(change.type == DirectoryChange::Type::Joined) {
+        di.Join(change.member.node, change.member.name);
+      } else if(!di.LeaveByName(change.member.name)) {
+        di.LeaveByNode(change.member.node);
+      }
+      dc_others.Update(di);
+    }
+  }
+
+  //Run the callbacks outside the lock so they can call back into dirman
+  watch_mutex->ReaderLock();
+  vector<fn_watch_t> callbacks;
+  auto it = watch_callbacks.find(change.url.GetBucketPathName());
+  if(it != watch_callbacks.end()) callbacks = it->second;
+  watch_mutex->Unlock();
+
+  for(auto &fn : callbacks)
+    fn(change);
+}
+
+/**
+ * @brief Owner side: Send a change to every node that is watching the directory. Does not wait for replies
+ * @param[in] change The change that was just applied to this node's master copy
+ */
+void DirManCoreBase::notifyWatchers(const DirectoryChange &change) {
+
+  watch_mutex->ReaderLock();
+  set<nodeid_t> nodes;
+  auto it = watchers.find(change.url.GetBucketPathName());
+  if(it != watchers.end()) nodes = it->second;
+  watch_mutex->Unlock();
+
+  for(auto &node : nodes) {
+    if(node == my_node) {
+      DeliverChange(change);
+      continue;
+    }
+    try {
+      opbox::LaunchOp(new OpDirManCentralized(OpDirManCentralized::RequestType::NotifyChange, node, change));
+    } catch(const std::exception &e) {
+      warn("Could not send change for "+change.url.GetURL()+" to "+node.GetHex()+": "+e.what());
+    }
+  }
+}
+
 /**
  * @brief Query local resources to see if info exists about a particular resource
  * @param search_url -  search url
@@ -476,7 +679,7 @@ nodeid_t DirManCoreBase::parseConfigForRootNode(const Configuration &config) con
 
   dbg("Parsing config for root node info");
   rc = config.GetString(&root_node_hex, "dirman.root_node");
-  dbg("Searching for dirman.root_node gave '"+root_node_hex+"'");
+  F_LOG_DBG("Searching for dirman.root_node gave '"+root_node_hex+"'");
   if(rc==ENOENT) {
 
     //See if we can find a root_node file. Check in this order:
@@ -485,7 +688,7 @@ nodeid_t DirManCoreBase::parseConfigForRootNode(const Configuration &config) con
     //  dirman.root_node.file.env_name = FAODEL_DIRMAN_ROOT_NODE_FILE
     //  FAODEL_DIRMAN_ROOT_NODE
     rc = config.GetFilename(&fname, "dirman.root_node", "FAODEL_DIRMAN_ROOT_NODE_FILE", "");
-    dbg("GetFilename: '"+fname+"'");
+    F_LOG_DBG("GetFilename: '"+fname+"'");
     if(rc == 0) {
       ifstream f;
       f.open(fname);
@@ -516,7 +719,7 @@ nodeid_t DirManCoreBase::parseConfigForRootNode(const Configuration &config) con
     }
   }
 
-  dbg("Root node is set to be "+root_node_hex);
+  F_LOG_DBG("Root node is set to be "+root_node_hex);
 
   nodeid_t node(root_node_hex);
   if(!node.Valid()) {
@@ -543,7 +746,7 @@ vector<string> DirManCoreBase::readURLsFromFilesWithRetry(string file_names){
       ifstream f;
       f.open(file_name);
       if(!f.is_open()){
-        dbg("could not open file "+file_name+".. Retry in "+to_string(sleep_time)+" seconds");
+        F_LOG_DBG("could not open file "+file_name+".. Retry in "+to_string(sleep_time)+" seconds");
         sleep(sleep_time);
         if(sleep_time<16) sleep_time*=2;
       } else {
@@ -597,7 +800,7 @@ bool DirManCoreBase::writeURLsToFileOrDie(const string file_name, const vector<f
  */
 bool DirManCoreBase::cacheForeignDir(const DirectoryInfo &dir_info){
 
-  dbg("cacheForeignDir "+dir_info.url.GetFullURL());
+  F_LOG_DBG("cacheForeignDir "+dir_info.url.GetFullURL());
   if((!dir_info.url.Valid()) ||
      (dir_info.url.reference_node == NODE_LOCALHOST) ||
      (dir_info.url.reference_node == my_node)     ){
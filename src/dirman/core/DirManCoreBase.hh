@@ -9,7 +9,11 @@
 #include "faodel-common/LoggingInterface.hh"
 #include "faodel-common/DirectoryInfo.hh"
 
+#include <map>
+#include <set>
+
 #include "dirman/common/DirectoryCache.hh"
+#include "dirman/common/DirectoryChange.hh"
 #include "dirman/common/DirectoryOwnerCache.hh"
 
 namespace dirman {
@@ -43,6 +47,7 @@ public:
   //DirMan Exposed API
   virtual bool Locate(const faodel::ResourceURL &search_url, faodel::nodeid_t *reference_node=nullptr);
   virtual bool GetDirectoryInfo(const faodel::ResourceURL &search_url, bool check_local, bool check_remote, faodel::DirectoryInfo *dir_info=nullptr) = 0;
+  virtual bool GetDirectoryInfoBatch(const std::vector<faodel::ResourceURL> &search_urls, bool check_local, bool check_remote, std::vector<faodel::DirectoryInfo> *dir_infos=nullptr);
 
   virtual bool DefineNewDir(const faodel::DirectoryInfo &dir_info) = 0;
           bool DefineNewDir(const faodel::ResourceURL &url);
@@ -66,6 +71,20 @@ public:
   //Get a list of names this node knows about
   virtual void GetCachedNames(std::vector<std::string> *resource_names);
 
+  //Replica API: A server calls these when another server pushes it a copy of an entry
+  virtual bool StoreReplica(const faodel::DirectoryInfo &dir_info) { return false; }
+  virtual bool DropReplica(const faodel::ResourceURL &url) { return false; }
+
+  //Watch API: Get a callback whenever a directory's membership changes
+  virtual bool Watch(const faodel::ResourceURL &url, fn_watch_t callback);
+  virtual bool Unwatch(const faodel::ResourceURL &url);
+
+  //Watch API: The owner of a directory uses these to track which nodes are watching it
+  //and a watcher uses DeliverChange to apply an incoming change
+  void AddWatcher(const faodel::ResourceURL &url, faodel::nodeid_t node);
+  void RemoveWatcher(const faodel::ResourceURL &url, faodel::nodeid_t node);
+  void DeliverChange(const DirectoryChange &change);
+
   //Different ways of looking up local info
   bool lookupLocal(const std::vector<faodel::ResourceURL> &search_url,  std::vector<faodel::DirectoryInfo> *dir_info=nullptr);  //for rpc
   bool lookupLocal(const faodel::ResourceURL &search_url,  faodel::DirectoryInfo *dir_info=nullptr, faodel::nodeid_t *reference_node=nullptr);
@@ -87,6 +106,10 @@ protected:
   faodel::bucket_t default_bucket; //Bucket to use
   bool strict_checking;            //Add additional hooks for checking requests
 
+  faodel::MutexWrapper *watch_mutex;                                   //Protects the watch maps
+  std::map<std::string, std::set<faodel::nodeid_t>> watchers;          //Owner side: nodes watching each of my dirs
+  std::map<std::string, std::vector<fn_watch_t>>    watch_callbacks;   //Watcher side: local callbacks for each dir
+
   //Internal API for implementing Exposed API
   virtual bool discoverParent(const faodel::ResourceURL &url, faodel::nodeid_t *reference_node) = 0;
   virtual bool cacheForeignDir(const faodel::DirectoryInfo &dir_info) = 0;
@@ -94,6 +117,10 @@ protected:
   virtual bool joinRemote(faodel::nodeid_t parent_node, const faodel::ResourceURL &child_url, bool send_detailed_reply=false) = 0;
   virtual void appendWhookieParameterTable(faodel::ReplyStream *rs);
 
+  //Watch helpers: which node owns a dir's master copy, and tell its watchers about a change
+  virtual faodel::nodeid_t watchOwner(const faodel::ResourceURL &url) { return my_node; }
+  void notifyWatchers(const DirectoryChange &change);
+
   //Helpers
   faodel::nodeid_t parseConfigForRootNode(const faodel::Configuration &config) const;
   std::vector<std::string> readURLsFromFilesWithRetry(std::string file_names);
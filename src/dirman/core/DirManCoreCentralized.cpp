@@ -25,8 +25,11 @@ DirManCoreCentralized::DirManCoreCentralized(const faodel::Configuration &config
 
   string root_node_hex;
   string write_root_filename;
+  uint64_t lease_ttl_ms, negative_ttl_ms;
   config.GetBool(&am_root,                     "dirman.host_root",            "false");
   config.GetFilename(&write_root_filename,     "dirman.write_root",            "", "");
+  config.GetUInt(&lease_ttl_ms,                "dirman.cache.lease_ttl_ms",    "0");
+  config.GetUInt(&negative_ttl_ms,             "dirman.cache.negative_ttl_ms", "0");
 
   my_node = whookie::Server::GetNodeID();
 
@@ -34,7 +37,7 @@ DirManCoreCentralized::DirManCoreCentralized(const faodel::Configuration &config
     dbg("Checking for root node");
     root_id  = parseConfigForRootNode(config); //May throw if no valid root
     am_root = (root_id == my_node);
-    dbg("Setting root node to " + root_id.GetHex());
+    F_LOG_DBG("Setting root node to " + root_id.GetHex());
   }
 
   if(am_root) {
@@ -45,7 +48,7 @@ DirManCoreCentralized::DirManCoreCentralized(const faodel::Configuration &config
     info("Node node id:   "+root_id.GetHex());
     //See if we've been instructed to write to a file
     if(!write_root_filename.empty()) {
-      dbg("Root is writing file "+write_root_filename);
+      F_LOG_DBG("Root is writing file "+write_root_filename);
       ofstream f;
       f.open(write_root_filename);
       if(!f.is_open()) {
@@ -66,7 +69,7 @@ DirManCoreCentralized::DirManCoreCentralized(const faodel::Configuration &config
   dc_others.Lookup(predefined_urls, &dirs);
   for(auto &d : dirs){
     if(am_root) {
-      dbg("Root Transplanting "+d.url.GetFullURL());
+      F_LOG_DBG("Root Transplanting "+d.url.GetFullURL());
       HostNewDir(d);
       dc_others.Remove(d.url);
     } else {
@@ -77,6 +80,11 @@ DirManCoreCentralized::DirManCoreCentralized(const faodel::Configuration &config
     }
   }
 
+  //Leases only apply to entries we get from root. Predefined entries are left as-is
+  if(!am_root) {
+    dc_others.SetLeaseTimes(lease_ttl_ms, negative_ttl_ms);
+  }
+
   //Register our Op
   opbox::RegisterOp<OpDirManCentralized>();
 
@@ -99,7 +107,7 @@ void DirManCoreCentralized::finish(){
  * @retval TRUE Always successful, as the answer in this case is always the root node
  */
 bool DirManCoreCentralized::Locate(const ResourceURL &search_url, nodeid_t *reference_node) {
-  dbg("Locate "+search_url.GetURL());
+  F_LOG_DBG("Locate "+search_url.GetURL());
   if(reference_node) *reference_node = root_id;
   return true;
 }
@@ -114,7 +122,7 @@ bool DirManCoreCentralized::Locate(const ResourceURL &search_url, nodeid_t *refe
  */
 bool DirManCoreCentralized::GetDirectoryInfo(const faodel::ResourceURL &url, bool check_local, bool check_remote, DirectoryInfo *dir_info) {
 
-  dbg("GetDirInfo request to (local="+to_string(check_local)+",remote="+to_string(check_remote)+ ") requesting resource "+url.GetBucketPathName());
+  F_LOG_DBG("GetDirInfo request to (local="+to_string(check_local)+",remote="+to_string(check_remote)+ ") requesting resource "+url.GetBucketPathName());
 
   //Fixup the url by filling in the bucket
   faodel::ResourceURL url_mod = localizeURL(url, false);
@@ -123,7 +131,7 @@ bool DirManCoreCentralized::GetDirectoryInfo(const faodel::ResourceURL &url, boo
     //We're the root node. Just query local structures to find answer
     if(dir_info) dir_info->url.reference_node = root_id; //Ensure we are listed as root
     bool found = dc_mine.Lookup(url_mod, dir_info);
-    dbg("On-Root local query found: "+to_string(found));
+    F_LOG_DBG("On-Root local query found: "+to_string(found));
     return found;
 
   } else {
@@ -131,8 +139,14 @@ bool DirManCoreCentralized::GetDirectoryInfo(const faodel::ResourceURL &url, boo
     //We're not the root. Check our cache first
     if(check_local){
       bool found = dc_others.Lookup(url_mod, dir_info);
-      dbg("Off-Root local cache query found: "+to_string(found));
+      F_LOG_DBG("Off-Root local cache query found: "+to_string(found));
       if(found) return found;
+
+      //Root recently told us this doesn't exist. Don't ask again until the negative entry expires
+      if(check_remote && dc_others.IsKnownMissing(url_mod)) {
+        F_LOG_DBG("Off-Root local cache has a recent miss for resource. Returning false");
+        return false;
+      }
     }
     //Didn't find. Bail out if remote search not enabled
     if(!check_remote) {
@@ -140,7 +154,7 @@ bool DirManCoreCentralized::GetDirectoryInfo(const faodel::ResourceURL &url, boo
       return false;
     }
 
-    dbg("Off-Root missed local cache. Issue request to root "+root_id.GetHex()+" for "+url_mod.GetPathName());
+    F_LOG_DBG("Off-Root missed local cache. Issue request to root "+root_id.GetHex()+" for "+url_mod.GetPathName());
 
     try {
       //Launch a message
@@ -154,13 +168,14 @@ bool DirManCoreCentralized::GetDirectoryInfo(const faodel::ResourceURL &url, boo
       //Skip out if the dirinfo we got back is empty
       if(di2.IsEmpty()) {
         dbg("GetDirInfo did not get a valid result from root node");
+        dc_others.MarkMissing(url_mod);
         return false;
       }
 
 
       //Pass valid result back
-      dbg("GetDirInfo Got remote result back: " + di2.to_string() + " members " + to_string(di2.members.size()));
-      dc_others.CreateAndLinkParents(di2);
+      F_LOG_DBG("GetDirInfo Got remote result back: " + di2.to_string() + " members " + to_string(di2.members.size()));
+      cacheRemoteResult(di2);
       if(dir_info) *dir_info = di2;
       return true;
 
@@ -174,6 +189,81 @@ bool DirManCoreCentralized::GetDirectoryInfo(const faodel::ResourceURL &url, boo
   return false;
 }
 
+/**
+ * @brief Retrieve info about several resource directory entries, using one request to root for all cache misses
+ * @param urls - Resource URLs to look up
+ * @param check_local - Check our local cache for answers first
+ * @param check_remote - Ask the root about any entries that were not found locally
+ * @param dir_infos - The resulting directory infos, appended in the same order as urls (empty value if no entry)
+ * @retval TRUE All entries were found
+ * @retval FALSE One or more entries were not found
+ */
+bool DirManCoreCentralized::GetDirectoryInfoBatch(const vector<faodel::ResourceURL> &urls, bool check_local, bool check_remote, vector<DirectoryInfo> *dir_infos) {
+
+  F_LOG_DBG("GetDirInfoBatch request to (local="+to_string(check_local)+",remote="+to_string(check_remote)+ ") requesting "+to_string(urls.size())+" resources");
+
+  vector<faodel::ResourceURL> urls_mod;
+  urls_mod.reserve(urls.size());
+  for(auto &url : urls)
+    urls_mod.push_back(localizeURL(url, false));
+
+  if(am_root) {
+    //We're the root node. Just query local structures to find answer
+    return dc_mine.Lookup(urls_mod, dir_infos);
+  }
+
+  //Fill in whatever we can from our cache and figure out what to ask root about
+  bool all_found=true;
+  vector<DirectoryInfo> results(urls_mod.size());
+  vector<size_t> remote_spots;
+  vector<faodel::ResourceURL> remote_urls;
+  for(size_t i=0; i<urls_mod.size(); i++) {
+    if(check_local) {
+      if(dc_others.Lookup(urls_mod[i], &results[i])) continue;
+      if(check_remote && dc_others.IsKnownMissing(urls_mod[i])) {
+        all_found=false;
+        continue;
+      }
+    }
+    if(!check_remote) {
+      all_found=false;
+      continue;
+    }
+    remote_spots.push_back(i);
+    remote_urls.push_back(urls_mod[i]);
+  }
+
+  if(!remote_urls.empty()) {
+    F_LOG_DBG("Off-Root missed local cache for "+to_string(remote_urls.size())+" resources. Issue batch request to root "+root_id.GetHex());
+    try {
+      OpDirManCentralized *op = new OpDirManCentralized(OpDirManCentralized::RequestType::GetInfoBatch, root_id, remote_urls);
+      future<vector<DirectoryInfo>> fut1 = op->GetBatchFuture();
+      opbox::LaunchOp(op);
+
+      //Block until get a result. Root replies with one entry (possibly empty) per url
+      vector<DirectoryInfo> remote_dirs = fut1.get();
+      for(size_t j=0; j<remote_spots.size(); j++) {
+        if((j>=remote_dirs.size()) || (remote_dirs[j].IsEmpty())) {
+          dc_others.MarkMissing(remote_urls[j]);
+          all_found=false;
+          continue;
+        }
+        cacheRemoteResult(remote_dirs[j]);
+        results[remote_spots[j]] = remote_dirs[j];
+      }
+
+    } catch(const std::exception &e) {
+      //Connect may throw if bad root node
+      error("DirMan Communication error "+string(e.what()));
+      all_found=false;
+    }
+  }
+
+  if(dir_infos)
+    dir_infos->insert(dir_infos->end(), results.begin(), results.end());
+  return all_found;
+}
+
 /**
  * @brief Define a new directory entry (but don't host it)
  * @param dir_info Information for new directory entry
@@ -181,7 +271,7 @@ bool DirManCoreCentralized::GetDirectoryInfo(const faodel::ResourceURL &url, boo
  * @retval FALSE The resource already exists and therefore was NOT modified
  */
 bool DirManCoreCentralized::DefineNewDir(const DirectoryInfo &dir_info) {
-  dbg("DefineNewDir "+dir_info.to_string());
+  F_LOG_DBG("DefineNewDir "+dir_info.to_string());
   return HostNewDir(dir_info); //Note: Nothing else needed because this sets reference node to root
 }
 
@@ -192,7 +282,7 @@ bool DirManCoreCentralized::DefineNewDir(const DirectoryInfo &dir_info) {
  * @retval FALSE The resource already exists and therefore was NOT modified
  */
 bool DirManCoreCentralized::HostNewDir(const DirectoryInfo &dir_info) {
-  dbg("HostNewDir "+dir_info.to_string());
+  F_LOG_DBG("HostNewDir "+dir_info.to_string());
 
   //Modify the dir_info so that (1) the url has our bucket in it if not set
   //and (2) the reference node is root.
@@ -212,7 +302,7 @@ bool DirManCoreCentralized::HostNewDir(const DirectoryInfo &dir_info) {
 
     //Block until get result
     DirectoryInfo di2 = fut1.get();
-    dbg("HostNewDir Got result back: "+di2.to_string());
+    F_LOG_DBG("HostNewDir Got result back: "+di2.to_string());
     return dc_others.CreateAndLinkParents(di2);
     //TODO: is this right?
   }
@@ -227,7 +317,7 @@ bool DirManCoreCentralized::HostNewDir(const DirectoryInfo &dir_info) {
  * @retval FALSE Did not find the resource here (or attempted to register root-level url). no changes made
  */
 bool DirManCoreCentralized::JoinDirWithName(const faodel::ResourceURL &url, string name, DirectoryInfo *dir_info) {
-  dbg("JoinDir "+url.GetURL());
+  F_LOG_DBG("JoinDir "+url.GetURL());
 
   //Fixup the dir_info by filling in the root/bucket
   faodel::ResourceURL url_mod = localizeURL(url, true);
@@ -237,7 +327,11 @@ bool DirManCoreCentralized::JoinDirWithName(const faodel::ResourceURL &url, stri
   }
 
   if(am_root){
-    return dc_mine.Join(url_mod, dir_info);
+    DirectoryInfo di;
+    bool ok = dc_mine.Join(url_mod, &di);
+    if(ok) notifyWatchers(DirectoryChange(DirectoryChange::Type::Joined, di.url, di.members.back()));
+    if(dir_info) *dir_info = di;
+    return ok;
 
   } else {
 
@@ -248,7 +342,7 @@ bool DirManCoreCentralized::JoinDirWithName(const faodel::ResourceURL &url, stri
 
     //Block until get result
     DirectoryInfo di2 = fut1.get();
-    dbg("JoinDir Got result back: "+di2.to_string());
+    F_LOG_DBG("JoinDir Got result back: "+di2.to_string());
     if(dir_info) *dir_info = di2;
     return dc_others.Update(di2);
 
@@ -263,13 +357,17 @@ bool DirManCoreCentralized::JoinDirWithName(const faodel::ResourceURL &url, stri
  * @retval FALSE Unable to remove the node (eg, not a member or resource does not exist)
  */
 bool DirManCoreCentralized::LeaveDir(const faodel::ResourceURL &url, DirectoryInfo *dir_info) {
-  dbg("LeaveDir "+url.GetURL());
+  F_LOG_DBG("LeaveDir "+url.GetURL());
 
   //Fixup the dir_info by filling in the bucket.
   faodel::ResourceURL url_mod = localizeURL(url, false);
 
   if(am_root){
-    return dc_mine.Leave(url_mod, dir_info);
+    DirectoryInfo di;
+    bool ok = dc_mine.Leave(url_mod, &di);
+    if(ok) notifyWatchers(DirectoryChange(DirectoryChange::Type::Left, di.url, NameAndNode(url_mod.name, url_mod.reference_node)));
+    if(dir_info) *dir_info = di;
+    return ok;
 
   } else {
 
@@ -280,7 +378,7 @@ bool DirManCoreCentralized::LeaveDir(const faodel::ResourceURL &url, DirectoryIn
 
     //Block until get result
     DirectoryInfo di2 = fut1.get();
-    dbg("LeaveDir Got result back: "+di2.to_string());
+    F_LOG_DBG("LeaveDir Got result back: "+di2.to_string());
     return dc_others.Update(di2);
   }
 }
@@ -293,16 +391,22 @@ bool DirManCoreCentralized::LeaveDir(const faodel::ResourceURL &url, DirectoryIn
  *       the actual resource or remove references to it at other nodes.
  */
 bool DirManCoreCentralized::DropDir(const faodel::ResourceURL &url) {
-  dbg("DropDir "+url.GetURL());
+  F_LOG_DBG("DropDir "+url.GetURL());
 
   //Fixup the dir_info by filling in the bucket. Note
   faodel::ResourceURL url_mod = localizeURL(url, false);
 
   if(am_root) {
-    return dc_mine.Remove(url_mod);
+    bool ok = dc_mine.Remove(url_mod);
+    if(ok) notifyWatchers(DirectoryChange(DirectoryChange::Type::Dropped, url_mod));
+    return ok;
 
   } else {
 
+    //If we watch this dir, the root's Dropped notice can reach us before
+    //its reply and remove our copy first, so check for it up front
+    bool was_cached = dc_others.Lookup(url_mod);
+
     //Launch a message
     OpDirManCentralized *op = new OpDirManCentralized(OpDirManCentralized::RequestType::DropDir, root_id, url_mod);
     future<DirectoryInfo> fut1 = op->GetFuture();
@@ -311,14 +415,15 @@ bool DirManCoreCentralized::DropDir(const faodel::ResourceURL &url) {
     //Block for a reply, though we don't need it
     DirectoryInfo di2 = fut1.get();
 
-    return dc_others.Remove(url_mod);
+    bool removed = dc_others.Remove(url_mod);
+    return removed || was_cached;
   }
 
 }
 
 bool DirManCoreCentralized::discoverParent(const ResourceURL &resource_url, nodeid_t *parent_node){
 
-  dbg("discover parent of "+resource_url.GetFullURL());
+  F_LOG_DBG("discover parent of "+resource_url.GetFullURL());
 
   if(resource_url.IsRootLevel()) return false;
   if(parent_node) *parent_node=root_id;
@@ -355,6 +460,17 @@ faodel::ResourceURL DirManCoreCentralized::localizeURL(const faodel::ResourceURL
   return url_mod;
 }
 
+/**
+ * @brief Store an entry that root sent us in our cache, replacing any older copy
+ * @param dir_info The entry from root
+ */
+void DirManCoreCentralized::cacheRemoteResult(const DirectoryInfo &dir_info) {
+  //Create fails if we already have a copy (eg, its lease expired). Replace it
+  if(!dc_others.CreateAndLinkParents(dir_info)) {
+    dc_others.Update(dir_info);
+  }
+}
+
 void DirManCoreCentralized::appendWhookieParameterTable(faodel::ReplyStream *rs){
   rs->tableRow({"Root Node:", rs->createLink(root_id.GetHex(), root_id.GetHttpLink(), true) });
   rs->tableRow({"Am Root:",   ((am_root) ?"True":"False")});
@@ -23,6 +23,12 @@ namespace internal {
  *
  * This DirManCore simplifies the directory management service to a single,
  * centralized node that is responsible for storing all DirMan entries.
+ *
+ * Non-root nodes cache the entries they retrieve from the root. Cached
+ * entries can be given a lease (dirman.cache.lease_ttl_ms) so they are
+ * refreshed periodically, and lookups that miss at the root can be
+ * remembered for a short time (dirman.cache.negative_ttl_ms) so a node
+ * does not keep asking the root about resources that do not exist yet.
  */
 class DirManCoreCentralized :
     public DirManCoreBase {
@@ -46,6 +52,7 @@ public:
   std::string GetType() const override { return "centralized"; }
   bool Locate(const faodel::ResourceURL &search_url, faodel::nodeid_t *reference_node= nullptr) override;
   bool GetDirectoryInfo(const faodel::ResourceURL &url, bool check_local, bool check_remote, faodel::DirectoryInfo *dir_info) override;
+  bool GetDirectoryInfoBatch(const std::vector<faodel::ResourceURL> &urls, bool check_local, bool check_remote, std::vector<faodel::DirectoryInfo> *dir_infos) override;
   bool DefineNewDir(const faodel::DirectoryInfo &dir_info) override;
   bool HostNewDir(const faodel::DirectoryInfo &dir_info) override;
   bool JoinDirWithName(const faodel::ResourceURL &url, std::string name, faodel::DirectoryInfo *dir_info= nullptr) override;
@@ -62,6 +69,7 @@ public:
   bool joinRemote(faodel::nodeid_t parent_node, const faodel::ResourceURL &child_url, bool send_detailed_reply=false) override;
 
   void appendWhookieParameterTable(faodel::ReplyStream *rs) override;
+  faodel::nodeid_t watchOwner(const faodel::ResourceURL &url) override { return root_id; }
   //InfoInterface
   void sstr(std::stringstream &ss, int depth=0, int indent=0) const override;
 
@@ -70,6 +78,7 @@ private:
   bool am_root;
 
   faodel::ResourceURL localizeURL(const faodel::ResourceURL &url, bool change_node=false);
+  void cacheRemoteResult(const faodel::DirectoryInfo &dir_info);
 
 };
 
@@ -0,0 +1,584 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#include <algorithm>
+#include <future>
+#include <map>
+
+#include "opbox/OpBox.hh"
+#include "opbox/net/net.hh"
+#include "dirman/core/DirManCoreSharded.hh"
+#include "dirman/ops/OpDirManCentralized.hh"
+
+#include "whookie/Server.hh"
+
+using namespace std;
+using namespace faodel;
+
+namespace dirman {
+namespace internal {
+
+
+DirManCoreSharded::DirManCoreSharded(const faodel::Configuration &config)
+  : DirManCoreBase(config, "Sharded"),
+    hot_replicas(1), read_slot(0), am_server(false) {
+
+  string shard_nodes_string;
+  string hot_paths_string;
+  uint64_t num_hot_replicas, lease_ttl_ms, negative_ttl_ms;
+  config.GetString(&shard_nodes_string,        "dirman.sharded.nodes",         "");
+  config.GetString(&hot_paths_string,          "dirman.sharded.hot_paths",     "");
+  config.GetUInt(&num_hot_replicas,            "dirman.sharded.hot_replicas",  "3");
+  config.GetUInt(&lease_ttl_ms,                "dirman.cache.lease_ttl_ms",    "0");
+  config.GetUInt(&negative_ttl_ms,             "dirman.cache.negative_ttl_ms", "0");
+
+  my_node = whookie::Server::GetNodeID();
+
+  for(auto &s : Split(shard_nodes_string, ',', true)) {
+    shard_nodes.push_back(nodeid_t(s));
+  }
+  if(shard_nodes.empty()) {
+    //No list of servers. Fall back to using the root as the only server
+    dbg("No shard nodes given. Checking for root node");
+    shard_nodes.push_back(parseConfigForRootNode(config)); //May throw if no valid root
+  }
+  hot_paths = Split(hot_paths_string, ',', true);
+
+  am_server = (find(shard_nodes.begin(), shard_nodes.end(), my_node) != shard_nodes.end());
+  hot_replicas = max<uint32_t>(1, min<uint64_t>(num_hot_replicas, shard_nodes.size()));
+  read_slot = hash32(my_node.GetHex());
+
+  F_LOG_DBG("Sharded over "+to_string(shard_nodes.size())+" nodes. Am server: "+to_string(am_server));
+
+  //The base class may have plugged a bunch of urls from config into dc_others. Servers
+  //move the ones they are responsible for into dc_mine, which is where they look first.
+  if(am_server) {
+    vector<ResourceURL> predefined_urls;
+    vector<DirectoryInfo> dirs;
+    dc_others.GetAllURLs(&predefined_urls);
+    dc_others.Lookup(predefined_urls, &dirs);
+    for(auto &d : dirs) {
+      if(!amReplica(d.url)) continue;
+      F_LOG_DBG("Server Transplanting "+d.url.GetFullURL());
+      dc_mine.Update(d);
+      dc_others.Remove(d.url);
+    }
+  }
+
+  //Leases only apply to entries we get from servers. Predefined entries are left as-is
+  dc_others.SetLeaseTimes(lease_ttl_ms, negative_ttl_ms);
+
+  //Sharded uses the same messages as centralized
+  opbox::RegisterOp<OpDirManCentralized>();
+
+}
+
+DirManCoreSharded::~DirManCoreSharded() {
+  opbox::DeregisterOp<OpDirManCentralized>(true);
+}
+
+void DirManCoreSharded::start(){
+}
+
+void DirManCoreSharded::finish(){
+}
+
+/**
+ * @brief Locate the server that is the primary for a resource
+ * @param search_url -  The resource to locate
+ * @param reference_node -  The server that owns the resource's entry
+ * @retval TRUE Always successful, as the answer is computed from the url
+ */
+bool DirManCoreSharded::Locate(const ResourceURL &search_url, nodeid_t *reference_node) {
+  F_LOG_DBG("Locate "+search_url.GetURL());
+  if(reference_node) *reference_node = primaryNode(localizeURL(search_url, false));
+  return true;
+}
+
+/**
+ * @brief Retrieve info about a particular resource directory entry
+ * @param url -  Resource URL to look up
+ * @param check_local - Check our local cache for answer first
+ * @param check_remote - Check the server responsible for dir (if local not successful)
+ * @param dir_info -  The resulting directory info (set to empty value if no entry)
+ * @retval TRUE The entry was found
+ * @retval FALSE The entry was no found
+ */
+bool DirManCoreSharded::GetDirectoryInfo(const faodel::ResourceURL &url, bool check_local, bool check_remote, DirectoryInfo *dir_info) {
+
+  vector<DirectoryInfo> results;
+  bool found = GetDirectoryInfoBatch({url}, check_local, check_remote, &results);
+  if(dir_info) *dir_info = results.at(0);
+  return found;
+}
+
+/**
+ * @brief Retrieve info about several resource directory entries, using one request per server for all cache misses
+ * @param urls - Resource URLs to look up
+ * @param check_local - Check our local cache for answers first
+ * @param check_remote - Ask the servers about any entries that were not found locally
+ * @param dir_infos - The resulting directory infos, appended in the same order as urls (empty value if no entry)
+ * @retval TRUE All entries were found
+ * @retval FALSE One or more entries were not found
+ */
+bool DirManCoreSharded::GetDirectoryInfoBatch(const vector<faodel::ResourceURL> &urls, bool check_local, bool check_remote, vector<DirectoryInfo> *dir_infos) {
+
+  F_LOG_DBG("GetDirInfoBatch request to (local="+to_string(check_local)+",remote="+to_string(check_remote)+ ") requesting "+to_string(urls.size())+" resources");
+
+  bool all_found=true;
+  vector<DirectoryInfo> results(urls.size());
+  vector<size_t> remote_spots;
+  vector<faodel::ResourceURL> remote_urls;
+  vector<nodeid_t> remote_nodes;
+  for(size_t i=0; i<urls.size(); i++) {
+    faodel::ResourceURL url_mod = localizeURL(urls[i], false);
+
+    if(amReplica(url_mod)) {
+      //We're a server for this entry. Only look at local structures, unless we're holding
+      //a hot copy that the primary has not pushed to us yet.
+      if(dc_mine.Lookup(url_mod, &results[i])) continue;
+      if(check_local && dc_others.Lookup(url_mod, &results[i])) continue;
+      if((!check_remote) || (primaryNode(url_mod) == my_node)) {
+        all_found=false;
+        continue;
+      }
+      remote_nodes.push_back(primaryNode(url_mod));
+
+    } else {
+      //Check our cache first
+      if(check_local) {
+        if(dc_others.Lookup(url_mod, &results[i])) continue;
+        //A server recently told us this doesn't exist. Don't ask again until the negative entry expires
+        if(check_remote && dc_others.IsKnownMissing(url_mod)) {
+          all_found=false;
+          continue;
+        }
+      }
+      if(!check_remote) {
+        all_found=false;
+        continue;
+      }
+      remote_nodes.push_back(readNode(url_mod));
+    }
+    remote_spots.push_back(i);
+    remote_urls.push_back(url_mod);
+  }
+
+  if(!remote_urls.empty()) {
+    F_LOG_DBG("Missed local cache for "+to_string(remote_urls.size())+" resources. Issue requests to servers");
+    try {
+      vector<DirectoryInfo> remote_dirs;
+      lookupServers(remote_urls, remote_nodes, &remote_dirs);
+
+      //A replica may not have received a new hot entry yet. Retry those at the primary
+      vector<size_t> retry_spots;
+      vector<faodel::ResourceURL> retry_urls;
+      vector<nodeid_t> retry_nodes;
+      for(size_t j=0; j<remote_urls.size(); j++) {
+        nodeid_t primary = primaryNode(remote_urls[j]);
+        if(remote_dirs[j].IsEmpty() && (remote_nodes[j] != primary)) {
+          retry_spots.push_back(j);
+          retry_urls.push_back(remote_urls[j]);
+          retry_nodes.push_back(primary);
+        }
+      }
+      if(!retry_urls.empty()) {
+        vector<DirectoryInfo> retry_dirs;
+        lookupServers(retry_urls, retry_nodes, &retry_dirs);
+        for(size_t k=0; k<retry_spots.size(); k++)
+          remote_dirs[retry_spots[k]] = retry_dirs[k];
+      }
+
+      for(size_t j=0; j<remote_urls.size(); j++) {
+        if(remote_dirs[j].IsEmpty()) {
+          dc_others.MarkMissing(remote_urls[j]);
+          all_found=false;
+          continue;
+        }
+        dc_others.Update(remote_dirs[j]);
+        results[remote_spots[j]] = remote_dirs[j];
+      }
+
+    } catch(const std::exception &e) {
+      //Connect may throw if bad server node
+      error("DirMan Communication error "+string(e.what()));
+      all_found=false;
+    }
+  }
+
+  if(dir_infos)
+    dir_infos->insert(dir_infos->end(), results.begin(), results.end());
+  return all_found;
+}
+
+/**
+ * @brief Define a new directory entry (but don't host it)
+ * @param dir_info Information for new directory entry
+ * @retval TRUE The resource was created ok
+ * @retval FALSE The resource already exists and therefore was NOT modified
+ */
+bool DirManCoreSharded::DefineNewDir(const DirectoryInfo &dir_info) {
+  F_LOG_DBG("DefineNewDir "+dir_info.to_string());
+  return HostNewDir(dir_info); //Note: Nothing else needed because this sets reference node to the primary
+}
+
+/**
+ * @brief Create a new directory entry. In this case, push info to the entry's primary server
+ * @param dir_info -  Information for new directory entry
+ * @retval TRUE The resource was created ok
+ * @retval FALSE The resource already exists and therefore was NOT modified
+ * @note Unlike centralized, parents are not created or linked, because they may live on other servers
+ */
+bool DirManCoreSharded::HostNewDir(const DirectoryInfo &dir_info) {
+  F_LOG_DBG("HostNewDir "+dir_info.to_string());
+
+  //Modify the dir_info so that (1) the url has our bucket in it if not set
+  //and (2) the reference node is the primary server.
+  DirectoryInfo dir_info_mod = dir_info;
+  dir_info_mod.url = localizeURL(dir_info.url, true);
+  nodeid_t primary = primaryNode(dir_info_mod.url);
+  dir_info_mod.url.reference_node = primary;
+
+  if(primary == my_node) {
+    bool ok = dc_mine.Create(dir_info_mod);
+    if(ok) pushReplicas(dir_info_mod);
+    return ok;
+  }
+
+  //Launch a message
+  OpDirManCentralized *op = new OpDirManCentralized(OpDirManCentralized::RequestType::HostNewDir, primary, dir_info_mod);
+  future<DirectoryInfo> fut1 = op->GetFuture();
+  opbox::LaunchOp(op);
+
+  //Block until get result
+  DirectoryInfo di2 = fut1.get();
+  F_LOG_DBG("HostNewDir Got result back: "+di2.to_string());
+  if(di2.IsEmpty()) return false;
+  return dc_others.Update(di2);
+}
+
+/**
+ * @brief Let a node join an existing resource.
+ * @param[in] url The url for the child (parent found via GetLineage)
+ * @param[in] name The name to use when joining
+ * @param[out] dir_info The updated directory entry
+ * @retval TRUE Found and updated the resource
+ * @retval FALSE Did not find the resource (or attempted to register root-level url). no changes made
+ */
+bool DirManCoreSharded::JoinDirWithName(const faodel::ResourceURL &url, string name, DirectoryInfo *dir_info) {
+  F_LOG_DBG("JoinDir "+url.GetURL());
+
+  faodel::ResourceURL url_mod = localizeURL(url, true);
+  if(!name.empty()){
+    url_mod.PushDir(name);
+  }
+
+  //The entry that changes is the parent, unless the owner is generating the name
+  bool needs_autogen = (url_mod.GetOption(DirectoryCache::auto_generate_option_label) == "1");
+  nodeid_t primary = primaryNode((needs_autogen) ? url_mod : url_mod.GetParent());
+
+  if(primary == my_node) {
+    DirectoryInfo di;
+    bool ok = dc_mine.Join(url_mod, &di);
+    if(ok) {
+      pushReplicas(di);
+      notifyWatchers(DirectoryChange(DirectoryChange::Type::Joined, di.url, di.members.back()));
+    }
+    if(dir_info) *dir_info = di;
+    return ok;
+  }
+
+  //Launch a message to the primary
+  OpDirManCentralized *op = new OpDirManCentralized(OpDirManCentralized::RequestType::JoinDir, primary, url_mod);
+  future<DirectoryInfo> fut1 = op->GetFuture();
+  opbox::LaunchOp(op);
+
+  //Block until get result
+  DirectoryInfo di2 = fut1.get();
+  F_LOG_DBG("JoinDir Got result back: "+di2.to_string());
+  if(dir_info) *dir_info = di2;
+  if(di2.IsEmpty()) return false;
+  return dc_others.Update(di2);
+}
+
+/**
+ * @brief Remove a node from a particular directory's membership list
+ * @param url -  The url for the node
+ * @param dir_info -  The updated directory info
+ * @retval TRUE Found the node and removed it from the resource
+ * @retval FALSE Unable to remove the node (eg, not a member or resource does not exist)
+ */
+bool DirManCoreSharded::LeaveDir(const faodel::ResourceURL &url, DirectoryInfo *dir_info) {
+  F_LOG_DBG("LeaveDir "+url.GetURL());
+
+  faodel::ResourceURL url_mod = localizeURL(url, false);
+  nodeid_t primary = primaryNode(url_mod.GetParent());
+
+  if(primary == my_node) {
+    DirectoryInfo di;
+    bool ok = dc_mine.Leave(url_mod, &di);
+    if(ok) {
+      pushReplicas(di);
+      notifyWatchers(DirectoryChange(DirectoryChange::Type::Left, di.url, NameAndNode(url_mod.name, url_mod.reference_node)));
+    }
+    if(dir_info) *dir_info = di;
+    return ok;
+  }
+
+  //Launch a message
+  OpDirManCentralized *op = new OpDirManCentralized(OpDirManCentralized::RequestType::LeaveDir, primary, url_mod);
+  future<DirectoryInfo> fut1 = op->GetFuture();
+  opbox::LaunchOp(op);
+
+  //Block until get result
+  DirectoryInfo di2 = fut1.get();
+  F_LOG_DBG("LeaveDir Got result back: "+di2.to_string());
+  if(dir_info) *dir_info = di2;
+  if(di2.IsEmpty()) return false;
+  return dc_others.Update(di2);
+}
+
+/**
+ * @brief Instruct the primary server to drop a specific directory
+ * @param url The resource reference to drop
+ * @return true
+ * @note This only removes the entry from the local and dirman nodes. It does not shutdown
+ *       the actual resource or remove references to it at other nodes.
+ */
+bool DirManCoreSharded::DropDir(const faodel::ResourceURL &url) {
+  F_LOG_DBG("DropDir "+url.GetURL());
+
+  faodel::ResourceURL url_mod = localizeURL(url, false);
+  nodeid_t primary = primaryNode(url_mod);
+
+  if(primary == my_node) {
+    bool ok = dc_mine.Remove(url_mod);
+    pushDrop(url_mod);
+    if(ok) notifyWatchers(DirectoryChange(DirectoryChange::Type::Dropped, url_mod));
+    return ok;
+  }
+
+  //Launch a message
+  OpDirManCentralized *op = new OpDirManCentralized(OpDirManCentralized::RequestType::DropDir, primary, url_mod);
+  future<DirectoryInfo> fut1 = op->GetFuture();
+  opbox::LaunchOp(op);
+
+  //Block for a reply, though we don't need it
+  DirectoryInfo di2 = fut1.get();
+
+  dc_others.Remove(url_mod);
+  return true;
+}
+
+/**
+ * @brief Store a copy of a hot entry that its primary pushed to this server
+ * @param dir_info The entry
+ * @retval TRUE Always stored
+ */
+bool DirManCoreSharded::StoreReplica(const DirectoryInfo &dir_info) {
+  F_LOG_DBG("StoreReplica "+dir_info.to_string());
+  return dc_mine.Update(dir_info);
+}
+
+/**
+ * @brief Remove a copy of a hot entry after its primary dropped it
+ * @param url The entry's url
+ * @retval TRUE The copy was removed
+ * @retval FALSE This server did not have a copy
+ */
+bool DirManCoreSharded::DropReplica(const ResourceURL &url) {
+  F_LOG_DBG("DropReplica "+url.GetURL());
+  return dc_mine.Remove(url);
+}
+
+bool DirManCoreSharded::discoverParent(const ResourceURL &resource_url, nodeid_t *parent_node){
+
+  F_LOG_DBG("discover parent of "+resource_url.GetFullURL());
+
+  if(resource_url.IsRootLevel()) return false;
+  if(parent_node) *parent_node=primaryNode(localizeURL(resource_url.GetParent(), false));
+
+  return true;
+}
+
+bool DirManCoreSharded::cacheForeignDir(const DirectoryInfo &dir_info) {
+  F_TODO("cacheForeignDir");
+}
+bool DirManCoreSharded::lookupRemote(faodel::nodeid_t nodeid, const faodel::ResourceURL &resource_url, DirectoryInfo *dir_info){
+  F_TODO("lookupRemote");
+}
+bool DirManCoreSharded::joinRemote(faodel::nodeid_t parent_node, const faodel::ResourceURL &child_url, bool send_detailed_reply){
+  F_TODO("joinRemote");
+}
+
+/**
+ * @brief Create a modified URL that fills in the default bucket (and node) if UNSPECIFIED
+ * @param url the source url to use
+ * @param change_node (optional) Also update reference_node w/ this node's value if NODE_UNSPECIFIED
+ * @retval url A new url with updated fields
+ */
+faodel::ResourceURL DirManCoreSharded::localizeURL(const faodel::ResourceURL &url, bool change_node){
+  faodel::ResourceURL url_mod = url;
+
+  if(url_mod.bucket == BUCKET_UNSPECIFIED)
+     url_mod.bucket = default_bucket;
+
+  if((change_node) &&
+     (url_mod.reference_node == NODE_UNSPECIFIED))
+     url_mod.reference_node = my_node;
+
+  return url_mod;
+}
+
+/**
+ * @brief Determine whether an entry's path falls under one of the hot_paths
+ * @param url The (localized) url of the entry
+ * @retval TRUE The entry is replicated on several servers
+ * @retval FALSE The entry only lives on its primary
+ */
+bool DirManCoreSharded::isHot(const faodel::ResourceURL &url) const {
+  if(hot_paths.empty()) return false;
+  string path_name = url.GetPathName();
+  for(auto &prefix : hot_paths) {
+    if(!StringBeginsWith(path_name, prefix)) continue;
+    if((path_name.size() == prefix.size()) || (prefix.back() == '/') || (path_name[prefix.size()] == '/'))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Map an entry to the spot in shard_nodes that holds its primary copy
+ * @param url The (localized) url of the entry
+ * @return Index into shard_nodes
+ */
+size_t DirManCoreSharded::primaryIndex(const faodel::ResourceURL &url) const {
+  return hash32(url.GetBucketPathName()) % shard_nodes.size();
+}
+
+nodeid_t DirManCoreSharded::primaryNode(const faodel::ResourceURL &url) const {
+  return shard_nodes[primaryIndex(url)];
+}
+
+/**
+ * @brief Pick the server this node should send lookups for an entry to
+ * @param url The (localized) url of the entry
+ * @return The primary for regular entries, or one of the replicas for hot entries
+ */
+nodeid_t DirManCoreSharded::readNode(const faodel::ResourceURL &url) const {
+  if(!isHot(url)) return primaryNode(url);
+  return shard_nodes[(primaryIndex(url) + (read_slot % hot_replicas)) % shard_nodes.size()];
+}
+
+/**
+ * @brief Get the list of servers that hold a copy of an entry
+ * @param url The (localized) url of the entry
+ * @return The primary, followed by the servers that hold copies (hot entries only)
+ */
+vector<nodeid_t> DirManCoreSharded::replicaNodes(const faodel::ResourceURL &url) const {
+  size_t spot = primaryIndex(url);
+  size_t num = (isHot(url)) ? hot_replicas : 1;
+  vector<nodeid_t> nodes;
+  for(size_t i=0; i<num; i++)
+    nodes.push_back(shard_nodes[(spot+i) % shard_nodes.size()]);
+  return nodes;
+}
+
+bool DirManCoreSharded::amReplica(const faodel::ResourceURL &url) const {
+  if(!am_server) return false;
+  auto nodes = replicaNodes(url);
+  return (find(nodes.begin(), nodes.end(), my_node) != nodes.end());
+}
+
+/**
+ * @brief Send one batched lookup to each server in a list and wait for all of them to reply
+ * @param[in] urls The entries to look up
+ * @param[in] nodes Which server to ask about each entry
+ * @param[out] results One entry per url (empty if the server did not have it)
+ */
+void DirManCoreSharded::lookupServers(const vector<faodel::ResourceURL> &urls, const vector<nodeid_t> &nodes,
+                                      vector<DirectoryInfo> *results) {
+
+  map<nodeid_t, vector<size_t>> spots_by_node;
+  for(size_t i=0; i<urls.size(); i++)
+    spots_by_node[nodes[i]].push_back(i);
+
+  //Launch all the requests before waiting on any of them
+  vector<vector<size_t>> spots;
+  vector<future<vector<DirectoryInfo>>> futs;
+  for(auto &node_spots : spots_by_node) {
+    vector<faodel::ResourceURL> node_urls;
+    for(auto i : node_spots.second)
+      node_urls.push_back(urls[i]);
+    OpDirManCentralized *op = new OpDirManCentralized(OpDirManCentralized::RequestType::GetInfoBatch, node_spots.first, node_urls);
+    futs.push_back(op->GetBatchFuture());
+    spots.push_back(node_spots.second);
+    opbox::LaunchOp(op);
+  }
+
+  results->assign(urls.size(), DirectoryInfo());
+  for(size_t j=0; j<futs.size(); j++) {
+    vector<DirectoryInfo> node_dirs = futs[j].get();
+    for(size_t k=0; (k<node_dirs.size()) && (k<spots[j].size()); k++)
+      (*results)[spots[j][k]] = node_dirs[k];
+  }
+}
+
+/**
+ * @brief Send copies of a hot entry to the other servers that hold it. Does not wait for replies
+ * @param dir_info The updated entry
+ */
+void DirManCoreSharded::pushReplicas(const DirectoryInfo &dir_info) {
+  if(!isHot(dir_info.url)) return;
+  for(auto &node : replicaNodes(dir_info.url)) {
+    if(node == my_node) continue;
+    try {
+      opbox::LaunchOp(new OpDirManCentralized(OpDirManCentralized::RequestType::ReplicateDir, node, dir_info));
+    } catch(const std::exception &e) {
+      warn("Could not push replica of "+dir_info.url.GetURL()+" to "+node.GetHex()+": "+e.what());
+    }
+  }
+}
+
+/**
+ * @brief Tell the other servers that hold a hot entry to drop it. Does not wait for replies
+ * @param url The entry that was dropped
+ */
+void DirManCoreSharded::pushDrop(const faodel::ResourceURL &url) {
+  if(!isHot(url)) return;
+  for(auto &node : replicaNodes(url)) {
+    if(node == my_node) continue;
+    try {
+      opbox::LaunchOp(new OpDirManCentralized(OpDirManCentralized::RequestType::DropReplica, node, url));
+    } catch(const std::exception &e) {
+      warn("Could not drop replica of "+url.GetURL()+" at "+node.GetHex()+": "+e.what());
+    }
+  }
+}
+
+void DirManCoreSharded::appendWhookieParameterTable(faodel::ReplyStream *rs){
+  rs->tableRow({"Shard Nodes:",  to_string(shard_nodes.size())});
+  rs->tableRow({"Am Server:",    ((am_server) ?"True":"False")});
+  rs->tableRow({"Hot Replicas:", to_string(hot_replicas)});
+  rs->tableRow({"Hot Paths:",    Join(hot_paths, ',')});
+}
+
+void DirManCoreSharded::sstr(stringstream &ss, int depth, int indent) const {
+  if(depth<0) return;
+  ss << string(indent,' ') << "[DirManSharded] "
+     << "AmServer: " << am_server
+     << " Shards: "<<shard_nodes.size()
+     << " HotReplicas: "<<hot_replicas
+     << endl;
+
+  if(depth>0) {
+    dc_mine.sstr(ss, depth-1, indent+2);
+    dc_others.sstr(ss, depth-1, indent+2);
+    doc.sstr(ss,depth-1, indent+2);
+  }
+
+}
+
+} // namespace internal
+} // namespace dirman
@@ -0,0 +1,112 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#ifndef DIRMAN_DIRECTORYMANAGERCORESHARDED_HH
+#define DIRMAN_DIRECTORYMANAGERCORESHARDED_HH
+
+#include <vector>
+
+#include "faodel-common/Common.hh"
+#include "faodel-common/LoggingInterface.hh"
+#include "faodel-common/DirectoryInfo.hh"
+
+#include "dirman/common/DirectoryCache.hh"
+#include "dirman/common/DirectoryOwnerCache.hh"
+
+#include "dirman/core/DirManCoreBase.hh"
+
+namespace dirman {
+namespace internal {
+
+/**
+ * @brief A sharded implementation of the DirManCore
+ *
+ * This DirManCore spreads directory entries across a set of server nodes
+ * (dirman.sharded.nodes). Each entry is owned by a primary server, which is
+ * selected by hashing the entry's bucket and path. All updates for an entry
+ * go to its primary.
+ *
+ * Entries that every rank is expected to look up (eg, pools) can be marked
+ * as hot by listing their path prefixes in dirman.sharded.hot_paths. The
+ * primary pushes copies of hot entries to the next servers in the shard list
+ * (dirman.sharded.hot_replicas servers in total), and each client reads a
+ * hot entry from one of these servers based on its node id. Copies are
+ * pushed asynchronously, so a client that misses on a replica retries at the
+ * primary.
+ *
+ * Clients cache the entries they retrieve, using the same lease and negative
+ * cache settings as the centralized core (dirman.cache.*).
+ */
+class DirManCoreSharded :
+    public DirManCoreBase {
+
+public:
+  DirManCoreSharded() = delete;
+  DirManCoreSharded(const DirManCoreSharded &d) = delete;
+
+  explicit DirManCoreSharded(const faodel::Configuration &conf);
+  ~DirManCoreSharded() override;
+
+  //Bootstrap Internal API: unconfigured calls these to start/finish
+  void start() override;
+  void finish() override;
+
+  //DirMan Exposed API extras
+  const std::vector<faodel::nodeid_t> & GetShardNodes() const { return shard_nodes; }
+  bool AmServer() const { return am_server; }
+
+  //DirMan Exposed API
+  std::string GetType() const override { return "sharded"; }
+  bool Locate(const faodel::ResourceURL &search_url, faodel::nodeid_t *reference_node= nullptr) override;
+  bool GetDirectoryInfo(const faodel::ResourceURL &url, bool check_local, bool check_remote, faodel::DirectoryInfo *dir_info) override;
+  bool GetDirectoryInfoBatch(const std::vector<faodel::ResourceURL> &urls, bool check_local, bool check_remote, std::vector<faodel::DirectoryInfo> *dir_infos) override;
+  bool DefineNewDir(const faodel::DirectoryInfo &dir_info) override;
+  bool HostNewDir(const faodel::DirectoryInfo &dir_info) override;
+  bool JoinDirWithName(const faodel::ResourceURL &url, std::string name, faodel::DirectoryInfo *dir_info= nullptr) override;
+  bool LeaveDir(const faodel::ResourceURL &url, faodel::DirectoryInfo *dir_info= nullptr) override;
+  bool DropDir(const faodel::ResourceURL &url) override;
+
+  faodel::nodeid_t GetAuthorityNode() const override { return shard_nodes.front(); }
+
+  //Replica API
+  bool StoreReplica(const faodel::DirectoryInfo &dir_info) override;
+  bool DropReplica(const faodel::ResourceURL &url) override;
+
+  //Internal API for implementing Exposed API
+  bool discoverParent(const faodel::ResourceURL &resource_url, faodel::nodeid_t *parent_node) override;
+  bool cacheForeignDir(const faodel::DirectoryInfo &dir_info) override;
+  bool lookupRemote(faodel::nodeid_t nodeid, const faodel::ResourceURL &resource_url, faodel::DirectoryInfo *dir_info= nullptr) override;
+  bool joinRemote(faodel::nodeid_t parent_node, const faodel::ResourceURL &child_url, bool send_detailed_reply=false) override;
+
+  void appendWhookieParameterTable(faodel::ReplyStream *rs) override;
+  faodel::nodeid_t watchOwner(const faodel::ResourceURL &url) override { return primaryNode(url); }
+  //InfoInterface
+  void sstr(std::stringstream &ss, int depth=0, int indent=0) const override;
+
+private:
+  std::vector<faodel::nodeid_t> shard_nodes; //Servers, in the order given by config
+  std::vector<std::string> hot_paths;        //Path prefixes for entries that get replicated
+  uint32_t hot_replicas;                     //How many servers hold each hot entry
+  uint32_t read_slot;                        //Which replica this node reads hot entries from
+  bool am_server;
+
+  faodel::ResourceURL localizeURL(const faodel::ResourceURL &url, bool change_node=false);
+
+  bool isHot(const faodel::ResourceURL &url) const;
+  size_t primaryIndex(const faodel::ResourceURL &url) const;
+  faodel::nodeid_t primaryNode(const faodel::ResourceURL &url) const;
+  faodel::nodeid_t readNode(const faodel::ResourceURL &url) const;
+  std::vector<faodel::nodeid_t> replicaNodes(const faodel::ResourceURL &url) const;
+  bool amReplica(const faodel::ResourceURL &url) const;
+
+  void lookupServers(const std::vector<faodel::ResourceURL> &urls, const std::vector<faodel::nodeid_t> &nodes, std::vector<faodel::DirectoryInfo> *results);
+  void pushReplicas(const faodel::DirectoryInfo &dir_info);
+  void pushDrop(const faodel::ResourceURL &url);
+
+};
+
+} //namespace internal
+} //namespace dirman
+
+#endif // DIRMAN_DIRECTORYMANAGERCORESHARDED_HH
@@ -123,7 +123,11 @@ bool DirManCoreStatic::JoinDirWithName(const faodel::ResourceURL &url, string na
     url_mod.PushDir(name);
   }
 
-  return dc_mine.Join(url_mod, dir_info);
+  DirectoryInfo di;
+  bool ok = dc_mine.Join(url_mod, &di);
+  if(ok) notifyWatchers(DirectoryChange(DirectoryChange::Type::Joined, di.url, di.members.back()));
+  if(dir_info) *dir_info = di;
+  return ok;
 }
 
 /**
@@ -139,7 +143,11 @@ bool DirManCoreStatic::LeaveDir(const faodel::ResourceURL &url, DirectoryInfo *d
   //Fixup the dir_info by filling in the bucket. Note
   faodel::ResourceURL url_mod = localizeURL(url, false);
 
-  return dc_mine.Leave(url_mod, dir_info);
+  DirectoryInfo di;
+  bool ok = dc_mine.Leave(url_mod, &di);
+  if(ok) notifyWatchers(DirectoryChange(DirectoryChange::Type::Left, di.url, NameAndNode(url_mod.name, url_mod.reference_node)));
+  if(dir_info) *dir_info = di;
+  return ok;
 }
 
 /**
@@ -154,7 +162,9 @@ bool DirManCoreStatic::DropDir(const faodel::ResourceURL &url) {
   //Fixup the dir_info by filling in the bucket. Note
   faodel::ResourceURL url_mod = localizeURL(url, false);
 
-  return dc_mine.Remove(url_mod);
+  bool ok = dc_mine.Remove(url_mod);
+  if(ok) notifyWatchers(DirectoryChange(DirectoryChange::Type::Dropped, url_mod));
+  return ok;
 }
 
 bool DirManCoreStatic::discoverParent(const ResourceURL &resource_url, nodeid_t *parent_node){
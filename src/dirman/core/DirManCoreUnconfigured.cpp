@@ -37,6 +37,8 @@ bool DirManCoreUnconfigured::HostNewDir(const DirectoryInfo &d)
 bool DirManCoreUnconfigured::JoinDirWithName(const ResourceURL &u, string name, DirectoryInfo *d)     { return Panic("JoinDirWithName"); }
 bool DirManCoreUnconfigured::LeaveDir(const ResourceURL &u, DirectoryInfo *d)                         { return Panic("LeaveDir"); }
 bool DirManCoreUnconfigured::DropDir(const ResourceURL &u)                                            { return Panic("DropDir");}
+bool DirManCoreUnconfigured::Watch(const ResourceURL &u, fn_watch_t f)                                { return Panic("Watch");}
+bool DirManCoreUnconfigured::Unwatch(const ResourceURL &u)                                            { return Panic("Unwatch");}
 //Internal API for implementing Exposed API. Most of these call Panic() to catch unconfigured system
 bool DirManCoreUnconfigured::discoverParent(const ResourceURL &u, nodeid_t *r)                        { return Panic("discoverParent"); }
 bool DirManCoreUnconfigured::cacheForeignDir(const DirectoryInfo &d)                                  { return Panic("cacheForeignDir"); }
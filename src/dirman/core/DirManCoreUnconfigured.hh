@@ -35,6 +35,8 @@ public:
   bool JoinDirWithName(const faodel::ResourceURL &url, std::string name, faodel::DirectoryInfo *dir_info=nullptr) override;
   bool LeaveDir(const faodel::ResourceURL &url, faodel::DirectoryInfo *dir_info=nullptr) override;
   bool DropDir(const faodel::ResourceURL &url) override;
+  bool Watch(const faodel::ResourceURL &url, fn_watch_t callback) override;
+  bool Unwatch(const faodel::ResourceURL &url) override;
 
   faodel::nodeid_t GetAuthorityNode() const { return faodel::NODE_UNSPECIFIED; }
 
@@ -7,6 +7,7 @@
 #include "dirman/core/Singleton.hh"
 #include "dirman/core/DirManCoreStatic.hh"
 #include "dirman/core/DirManCoreCentralized.hh"
+#include "dirman/core/DirManCoreSharded.hh"
 
 #include "whookie/Whookie.hh"
 #include "whookie/Server.hh"
@@ -80,8 +81,9 @@ void SingletonImpl::Init(const faodel::Configuration &config){
     return;
   } else if (dirman_type == "static") {      core = new DirManCoreStatic(config);
   } else if (dirman_type == "centralized"){  core = new DirManCoreCentralized(config);
+  } else if (dirman_type == "sharded"){      core = new DirManCoreSharded(config);
   } else {
-    error("Unknown dirman.type '"+dirman_type+"'. Options are 'none', 'static', or 'centralized'");
+    error("Unknown dirman.type '"+dirman_type+"'. Options are 'none', 'static', 'centralized', or 'sharded'");
     exit(-1);
   }
 
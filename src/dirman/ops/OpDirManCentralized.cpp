@@ -28,15 +28,16 @@ const string OpDirManCentralized::op_name = "OpDirManCentralized";
  * @param[in] dir_info The DirectoryInfo structure (which can include a list of participating nodes) to register
  */
 OpDirManCentralized::OpDirManCentralized(RequestType req_type, faodel::nodeid_t root_id, faodel::DirectoryInfo dir_info)
-        : Op(true), state(State::start), ldo_msg(), request_type(RequestType::HostNewDir) {
+        : Op(true), state(State::start), ldo_msg(), request_type(req_type) {
 
-  F_ASSERT(req_type == RequestType::HostNewDir, "Only supports hostnewdir now");
+  F_ASSERT((req_type == RequestType::HostNewDir) ||
+           (req_type == RequestType::ReplicateDir), "Only supports hostnewdir and replicatedir now");
 
   int rc = opbox::net::Connect(&peer, root_id); //Retrieve the root's peer ptr
   F_ASSERT((rc == 0), "Connect failed?");
 
   msg_dirman::AllocateRequest(ldo_msg,
-                              RequestType::HostNewDir,
+                              req_type,
                               root_id, GetAssignedMailbox(), dir_info);
 
   //Work picks up again in origin's state machine
@@ -56,6 +57,9 @@ OpDirManCentralized::OpDirManCentralized(RequestType req_type, faodel::nodeid_t
            (req_type == RequestType::JoinDir) ||
            (req_type == RequestType::LeaveDir) ||
            (req_type == RequestType::DropDir) ||
+           (req_type == RequestType::DropReplica) ||
+           (req_type == RequestType::Watch) ||
+           (req_type == RequestType::Unwatch) ||
            (req_type == RequestType::ReturnDirInfo), "Request type not handled");
 
   int rc = opbox::net::Connect(&peer, root_id); //Retrieve the root's peer ptr
@@ -70,6 +74,52 @@ OpDirManCentralized::OpDirManCentralized(RequestType req_type, faodel::nodeid_t
   //Work picks up again in origin's state machine
 }
 
+/**
+ * @brief Create the origin side of a batched GetInfo operation
+ * @param[in] req_type A constant expression to specify which operation is happening (must be GetInfoBatch)
+ * @param[in] root_id The root node where this message should be transmitted
+ * @param[in] urls The names of the resources that we're looking up
+ */
+OpDirManCentralized::OpDirManCentralized(RequestType req_type, faodel::nodeid_t root_id, const vector<faodel::ResourceURL> &urls)
+        : Op(true), state(State::start), ldo_msg(), request_type(req_type) {
+
+  F_ASSERT(req_type == RequestType::GetInfoBatch, "Only supports getinfobatch now");
+
+  int rc = opbox::net::Connect(&peer, root_id); //Retrieve the root's peer ptr
+  if(rc!=0) {
+    throw std::runtime_error("DirMan could not connect to server "+root_id.GetHex()+" - "+root_id.GetHttpLink());
+  }
+
+  msg_dirman::AllocateRequest(ldo_msg,
+                              req_type,
+                              root_id, GetAssignedMailbox(), urls);
+
+  //Work picks up again in origin's state machine
+}
+
+/**
+ * @brief Create the origin side of a NotifyChange operation
+ * @param[in] req_type A constant expression to specify which operation is happening (must be NotifyChange)
+ * @param[in] root_id The watcher node where this message should be transmitted
+ * @param[in] change The change that was made to the directory
+ */
+OpDirManCentralized::OpDirManCentralized(RequestType req_type, faodel::nodeid_t root_id, const DirectoryChange &change)
+        : Op(true), state(State::start), ldo_msg(), request_type(req_type) {
+
+  F_ASSERT(req_type == RequestType::NotifyChange, "Only supports notifychange now");
+
+  int rc = opbox::net::Connect(&peer, root_id); //Retrieve the watcher's peer ptr
+  if(rc!=0) {
+    throw std::runtime_error("DirMan could not connect to watcher "+root_id.GetHex()+" - "+root_id.GetHttpLink());
+  }
+
+  msg_dirman::AllocateRequest(ldo_msg,
+                              req_type,
+                              root_id, GetAssignedMailbox(), change);
+
+  //Work picks up again in origin's state machine
+}
+
 /**
  * @brief Create the target side of a new DirMan message. Allocates space for a reply message
  * @param t The op_create_as_target_t is used to signify that this Op is a target, not the initiator
@@ -95,6 +145,15 @@ future<faodel::DirectoryInfo> OpDirManCentralized::GetFuture() {
   return di_promise.get_future();
 }
 
+/**
+ * @brief Get a future for handing back the DirInfos from a batched lookup
+ * @return future
+ * @note This function must be executed **before** launching the Op
+ */
+future<vector<faodel::DirectoryInfo>> OpDirManCentralized::GetBatchFuture() {
+  return batch_promise.get_future();
+}
+
 /**
  * @brief Get a string label for the current state
  * @return string label
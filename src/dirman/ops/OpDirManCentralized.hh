@@ -6,11 +6,13 @@
 #define DIRMAN_OPDIRMANCENTRALIZED_HH
 
 #include <future>
-
+#include <vector>
 
 #include "faodel-common/DirectoryInfo.hh"
 #include "opbox/ops/Op.hh"
 
+#include "dirman/common/DirectoryChange.hh"
+
 namespace dirman {
 
 /**
@@ -22,10 +24,14 @@ namespace dirman {
  *    - Getting info about a dirman directory
  *    - Joinging a dirman directory
  *    - Leaving a dirman directory
+ *    - Getting info about several dirman directories in one request
+ *    - Pushing copies of directories to other servers (sharded DirMan)
+ *    - Watching a directory and sending its changes to the watchers
  *
  *  All requests result in an updated DirInfo entry being returned to the
  *  caller. This info can be retrieved through a future that is handed
  *  back by GetFuture(). GetFuture() MUST be called before launching the op.
+ *  Batched lookups return a list of DirInfos through GetBatchFuture() instead.
  *
  */
 class OpDirManCentralized : public Op {
@@ -39,13 +45,22 @@ class OpDirManCentralized : public Op {
 public:
   enum class RequestType : uint8_t {
     //Note: bit4 signifies this message packs a dirInfo structure
+    //      bit5 signifies this message packs a list of items
+    //      bit6 signifies this message packs a DirectoryChange
     Invalid=0,
-    HostNewDir    = 0x11,
-    GetInfo       = 0x02,
-    JoinDir       = 0x03,
-    LeaveDir      = 0x04,
-    DropDir       = 0x05,
-    ReturnDirInfo = 0x15
+    HostNewDir         = 0x11,
+    GetInfo            = 0x02,
+    JoinDir            = 0x03,
+    LeaveDir           = 0x04,
+    DropDir            = 0x05,
+    DropReplica        = 0x06,
+    Watch              = 0x07,
+    Unwatch            = 0x08,
+    ReturnDirInfo      = 0x15,
+    ReplicateDir       = 0x16,
+    GetInfoBatch       = 0x22,
+    ReturnDirInfoBatch = 0x35,
+    NotifyChange       = 0x40
   };
 
 
@@ -53,6 +68,8 @@ public:
   //An origin can issue any of the above requests, but they involve different data
   OpDirManCentralized(RequestType req_type, faodel::nodeid_t root_id, faodel::DirectoryInfo dir_info);
   OpDirManCentralized(RequestType req_type, faodel::nodeid_t root_id, faodel::ResourceURL url);
+  OpDirManCentralized(RequestType req_type, faodel::nodeid_t root_id, const std::vector<faodel::ResourceURL> &urls);
+  OpDirManCentralized(RequestType req_type, faodel::nodeid_t root_id, const DirectoryChange &change);
 
   //A target starts off the same way no matter what command
   explicit OpDirManCentralized(op_create_as_target_t t);
@@ -60,6 +77,7 @@ public:
 
   //Means for passing back the result
   std::future<faodel::DirectoryInfo> GetFuture();
+  std::future<std::vector<faodel::DirectoryInfo>> GetBatchFuture();
 
   //Unique name and id for this op
   const static unsigned int op_id;
@@ -80,6 +98,7 @@ private:
   RequestType request_type;
 
   std::promise<faodel::DirectoryInfo> di_promise;
+  std::promise<std::vector<faodel::DirectoryInfo>> batch_promise;
 
   WaitingType updateState(State new_state, WaitingType waiting_condition) {
     state=new_state;
@@ -65,6 +65,11 @@ WaitingType OpDirManCentralized::UpdateOrigin(OpArgs *args) {
           return updateState(State::done, WaitingType::done_and_destroy);
         }
 
+        case RequestType::ReturnDirInfoBatch: {
+          batch_promise.set_value(msg_dirman::ExtractDirInfos(msg));
+          return updateState(State::done, WaitingType::done_and_destroy);
+        }
+
         default: {
           cerr << "Unexpected message type returned to origin in OpDirManCentralized\n";
           exit(-1);
@@ -11,6 +11,7 @@
 #include "faodel-common/Debug.hh"
 
 #include "dirman/DirMan.hh"
+#include "dirman/core/Singleton.hh"
 #include "dirman/ops/OpDirManCentralized.hh"
 
 #include "dirman/ops/msg_dirman.hh"
@@ -39,12 +40,37 @@ WaitingType OpDirManCentralized::UpdateTarget(OpArgs *args) {
       auto *msg = args->ExpectMessageOrDie<message_t *>(&peer);
       auto req_type = static_cast<RequestType>(msg->user_flags);
 
+      if (req_type == RequestType::GetInfoBatch) {
+        //Batched lookups reply with a list instead of a single DirInfo
+        auto urls = msg_dirman::ExtractURLs(msg);
+        vector<DirectoryInfo> result_dir_infos;
+        dirman::GetLocalDirectoryInfo(urls, &result_dir_infos);
+
+        msg_dirman::AllocateReply(ldo_msg,
+                                  RequestType::ReturnDirInfoBatch,
+                                  msg,
+                                  result_dir_infos);
+
+        opbox::net::SendMsg(peer, std::move(ldo_msg));
+        return updateState(State::done, WaitingType::done_and_destroy);
+      }
+
       if (req_type == RequestType::HostNewDir) {
         //Only instance of a msg_dirman
         incoming_dir_info = msg_dirman::ExtractDirInfo(msg);
         dirman::HostNewDir(incoming_dir_info);
         dirman::GetLocalDirectoryInfo(incoming_dir_info.url, &result_dir_info);
 
+      } else if (req_type == RequestType::NotifyChange) {
+        //The owner of a dir we watch is telling us about a change
+        internal::Singleton::impl.core->DeliverChange(msg_dirman::ExtractChange(msg));
+
+      } else if (req_type == RequestType::ReplicateDir) {
+        //Another server pushed us a copy. Store it directly so it is not forwarded again
+        incoming_dir_info = msg_dirman::ExtractDirInfo(msg);
+        internal::Singleton::impl.core->StoreReplica(incoming_dir_info);
+        result_dir_info = incoming_dir_info;
+
       } else {
         //Everyone else sends a msg_dirman
         url = msg_dirman::ExtractURL(msg);
@@ -62,6 +88,17 @@ WaitingType OpDirManCentralized::UpdateTarget(OpArgs *args) {
           case RequestType::DropDir:
             dirman::DropDir(url);
             break;
+          case RequestType::DropReplica:
+            internal::Singleton::impl.core->DropReplica(url);
+            break;
+          case RequestType::Watch:
+            //Sender becomes a watcher. Give it our current copy as a starting point
+            internal::Singleton::impl.core->AddWatcher(url, msg->src);
+            dirman::GetLocalDirectoryInfo(url, &result_dir_info);
+            break;
+          case RequestType::Unwatch:
+            internal::Singleton::impl.core->RemoveWatcher(url, msg->src);
+            break;
           default: //Unknown?
             throw std::invalid_argument("Unknown case condition");
         }
@@ -19,14 +19,35 @@ namespace dirman {
  * @brief Determine if this message has a DirInfo embedded in it
  */
 bool msg_dirman::hasDirInfo() {
-  return ((hdr.op_id == OpDirManCentralized::op_id) && (hdr.user_flags & 0x10));
+  return ((hdr.op_id == OpDirManCentralized::op_id) && (hdr.user_flags & 0x10) && !(hdr.user_flags & 0x20));
 }
 
 /**
  * @brief Determine if this message has a URL embedded in it
  */
 bool msg_dirman::hasURL() {
-  return ((hdr.op_id == OpDirManCentralized::op_id) && !(hdr.user_flags & 0x10));
+  return ((hdr.op_id == OpDirManCentralized::op_id) && !(hdr.user_flags & 0x10) && !(hdr.user_flags & 0x20) && !(hdr.user_flags & 0x40));
+}
+
+/**
+ * @brief Determine if this message has a list of DirInfos embedded in it
+ */
+bool msg_dirman::hasDirInfos() {
+  return ((hdr.op_id == OpDirManCentralized::op_id) && (hdr.user_flags & 0x10) && (hdr.user_flags & 0x20));
+}
+
+/**
+ * @brief Determine if this message has a list of URLs embedded in it
+ */
+bool msg_dirman::hasURLs() {
+  return ((hdr.op_id == OpDirManCentralized::op_id) && !(hdr.user_flags & 0x10) && (hdr.user_flags & 0x20));
+}
+
+/**
+ * @brief Determine if this message has a DirectoryChange embedded in it
+ */
+bool msg_dirman::hasChange() {
+  return ((hdr.op_id == OpDirManCentralized::op_id) && (hdr.user_flags & 0x40));
 }
 
 /**
@@ -127,5 +148,123 @@ bool msg_dirman::AllocateReply(lunasa::DataObject &new_ldo,
           dir_info);
 }
 
+/**
+ * @brief Allocate a new LDO and fill it with a request for a list of URLs
+ * @param[out] new_ldo The resulting ldo that is allocated for this message
+ * @param[in] req_type The type of request this is
+ * @param[in] dst_node Which node this goes to
+ * @param[in] src_mailbox The sender's mailbox
+ * @param[in] urls The URLs we are requesting
+ * @retval True This fit in an MTU-sized allocation
+ * @retval False This was larger than an MTU
+ */
+bool msg_dirman::AllocateRequest(lunasa::DataObject &new_ldo,
+                                 const OpDirManCentralized::RequestType &req_type,
+                                 const faodel::nodeid_t &dst_node,
+                                 const mailbox_t &src_mailbox,
+                                 const vector<faodel::ResourceURL> &urls) {
+
+  //Send the full urls as strings to avoid needing a serializer for ResourceURL
+  vector<string> surls;
+  surls.reserve(urls.size());
+  for(auto &url : urls)
+    surls.push_back(url.GetFullURL());
+
+  return AllocateCerealRequestMessage<vector<string>>(
+          new_ldo,
+          dst_node, src_mailbox,
+          OpDirManCentralized::op_id,
+          static_cast<uint16_t>(req_type),
+          surls);
+}
+
+/**
+ * @brief Allocate a new LDO and fill it with a reply that includes a list of directory infos
+ * @param[out] new_ldo The resulting ldo that is allocated for this message
+ * @param[in] req_type The type of request this is
+ * @param[in] request_msg The message we're responding to (retrieve sender info)
+ * @param[in] dir_infos The DirectoryInfos the user wants to send
+ * @retval True This fit in an MTU-sized allocation
+ * @retval False This was larger than an MTU
+ */
+bool msg_dirman::AllocateReply(lunasa::DataObject &new_ldo,
+                               const OpDirManCentralized::RequestType &req_type,
+                               const message_t *request_msg,
+                               const vector<DirectoryInfo> &dir_infos) {
+
+  return AllocateCerealReplyMessage<vector<DirectoryInfo>>(
+          new_ldo,
+          request_msg,
+          static_cast<uint16_t>(req_type),
+          dir_infos);
+}
+
+/**
+ * @brief Extract a list of URLs from a message
+ * @param[in] hdr A pointer to an incoming message
+ * @return urls The URLs in the message
+ * @throws runtime_error if message does not have a list of urls
+ */
+vector<faodel::ResourceURL> msg_dirman::ExtractURLs(message_t *hdr) {
+  if (!(reinterpret_cast<msg_dirman_t *>(hdr))->hasURLs()) {
+    throw std::runtime_error("ExtractURLs called on a message that didn't contain a list of URLs");
+  }
+  auto surls = UnpackCerealMessage<vector<string>>(hdr);
+  vector<faodel::ResourceURL> urls;
+  urls.reserve(surls.size());
+  for(auto &s : surls)
+    urls.emplace_back(s);
+  return urls;
+}
+
+/**
+ * @brief Extract a list of DirInfos from a message
+ * @param[in] hdr A pointer to an incoming message
+ * @return dir_infos The DirInfos in the message
+ * @throws runtime_error if message does not have a list of DirInfos
+ */
+vector<DirectoryInfo> msg_dirman::ExtractDirInfos(message_t *hdr) {
+  if (!(reinterpret_cast<msg_dirman_t *>(hdr))->hasDirInfos()) {
+    throw std::runtime_error("ExtractDirInfos called on a message that didn't contain a list of DirInfos");
+  }
+  return UnpackCerealMessage<vector<DirectoryInfo>>(hdr);
+}
+
+/**
+ * @brief Allocate a new LDO and fill it with a DirectoryChange for a watcher
+ * @param[out] new_ldo The resulting ldo that is allocated for this message
+ * @param[in] req_type The type of request this is
+ * @param[in] dst_node Which node this goes to
+ * @param[in] src_mailbox The sender's mailbox
+ * @param[in] change The change that was made to a directory
+ * @retval True This fit in an MTU-sized allocation
+ * @retval False This was larger than an MTU
+ */
+bool msg_dirman::AllocateRequest(lunasa::DataObject &new_ldo,
+                                 const OpDirManCentralized::RequestType &req_type,
+                                 const faodel::nodeid_t &dst_node,
+                                 const mailbox_t &src_mailbox,
+                                 const DirectoryChange &change) {
+
+  return AllocateCerealRequestMessage<DirectoryChange>(
+          new_ldo,
+          dst_node, src_mailbox,
+          OpDirManCentralized::op_id,
+          static_cast<uint16_t>(req_type),
+          change);
+}
+
+/**
+ * @brief Extract a DirectoryChange from a message
+ * @param[in] hdr A pointer to an incoming message
+ * @return change The DirectoryChange in the message
+ * @throws runtime_error if message does not have a DirectoryChange
+ */
+DirectoryChange msg_dirman::ExtractChange(message_t *hdr) {
+  if (!(reinterpret_cast<msg_dirman_t *>(hdr))->hasChange()) {
+    throw std::runtime_error("ExtractChange called on a message that didn't contain a DirectoryChange");
+  }
+  return UnpackCerealMessage<DirectoryChange>(hdr);
+}
 
 } // namespace dirman
\ No newline at end of file
@@ -28,12 +28,19 @@ typedef struct msg_dirman {
   //Body: The body section following hdr contains either:
   //        - a url string
   //        - a cereal-packed DirInfo
-  //      bit[4] of hdr_flags specifies which type. Make sure your op id's agree
+  //        - a cereal-packed list of url strings
+  //        - a cereal-packed list of DirInfos
+  //        - a cereal-packed DirectoryChange
+  //      bit[4] of hdr_flags specifies url or DirInfo and bit[5] specifies
+  //      a list. bit[6] specifies a DirectoryChange. Make sure your op id's agree
 
   msg_dirman()=delete;
 
   bool hasDirInfo();
   bool hasURL();
+  bool hasDirInfos();
+  bool hasURLs();
+  bool hasChange();
   faodel::DirectoryInfo ExtractDirInfo() { return msg_dirman::ExtractDirInfo(&hdr); }
 
 
@@ -65,6 +72,35 @@ typedef struct msg_dirman {
   static faodel::DirectoryInfo ExtractDirInfo(message_t *hdr);
 
 
+  //For batched messages
+  static bool AllocateRequest(
+                    lunasa::DataObject &new_ldo,
+                    const OpDirManCentralized::RequestType &req_type,
+                    const faodel::nodeid_t &dst_node,
+                    const mailbox_t &src_mailbox,
+                    const std::vector<faodel::ResourceURL> &urls);
+
+  static bool AllocateReply(
+                    lunasa::DataObject &new_ldo,
+                    const OpDirManCentralized::RequestType &req_type,
+                    const message_t *request_msg,
+                    const std::vector<faodel::DirectoryInfo> &dir_infos);
+
+  static std::vector<faodel::ResourceURL> ExtractURLs(message_t *hdr);
+  static std::vector<faodel::DirectoryInfo> ExtractDirInfos(message_t *hdr);
+
+
+  //For watch notifications. Only sent as requests
+  static bool AllocateRequest(
+                    lunasa::DataObject &new_ldo,
+                    const OpDirManCentralized::RequestType &req_type,
+                    const faodel::nodeid_t &dst_node,
+                    const mailbox_t &src_mailbox,
+                    const DirectoryChange &change);
+
+  static DirectoryChange ExtractChange(message_t *hdr);
+
+
 
 } msg_dirman_t;
 
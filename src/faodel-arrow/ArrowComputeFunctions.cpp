@@ -0,0 +1,424 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#include "ArrowComputeFunctions.hh"
+
+#include <cerrno>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <arrow/compute/api.h>
+
+#include "faodel-common/StringHelpers.hh"
+
+#include "ArrowDataObject.hh"
+
+using namespace std;
+
+namespace faodel {
+
+/**
+ * @brief Register all of the Arrow compute functions with kelpie
+ * @note Must be called before bootstrap::Start()
+ */
+void RegisterArrowComputeFunctions() {
+  kelpie::RegisterComputeFunction("arrow_project", arrow_compute::fn_project);
+  kelpie::RegisterComputeFunction("arrow_filter",  arrow_compute::fn_filter);
+  kelpie::RegisterComputeFunction("arrow_limit",   arrow_compute::fn_limit);
+  kelpie::RegisterComputeFunction("arrow_sample",  arrow_compute::fn_sample);
+}
+
+namespace arrow_compute {
+
+namespace {
+
+using fn_table_op_t = std::function<arrow::Result<std::shared_ptr<arrow::Table>> (const std::shared_ptr<arrow::Table> &table,
+                                                                                  const std::string &args)>;
+
+string trim(const string &s) {
+  auto start = s.find_first_not_of(" \t");
+  if(start == string::npos) return "";
+  auto stop = s.find_last_not_of(" \t");
+  return s.substr(start, stop-start+1);
+}
+
+/// @brief Parse a whole token as a base-10 integer
+/// @note Unlike StringToInt64, "0.5" and "4k" are not integers here
+bool parseInteger(const string &token, int64_t *val) {
+  if(token.empty()) return false;
+  char *end = nullptr;
+  errno = 0;
+  long long v = strtoll(token.c_str(), &end, 10);
+  if((end==nullptr) || (*end!='\0') || (errno==ERANGE)) return false;
+  *val = v;
+  return true;
+}
+
+/// @brief Convert a predicate's value into an Arrow scalar (quoted string, integer, or double)
+arrow::Result<std::shared_ptr<arrow::Scalar>> parseValue(const string &token) {
+  if((token.size()>=2) && ((token[0]=='"') || (token[0]=='\'')) && (token.back()==token[0]))
+    return std::make_shared<arrow::StringScalar>(token.substr(1, token.size()-2));
+
+  int64_t ival;
+  if(parseInteger(token, &ival))
+    return std::make_shared<arrow::Int64Scalar>(ival);
+
+  char *end = nullptr;
+  double dval = strtod(token.c_str(), &end);
+  if((!token.empty()) && (end!=nullptr) && (*end=='\0'))
+    return std::make_shared<arrow::DoubleScalar>(dval);
+
+  return arrow::Status::Invalid("Could not parse value '"+token+"' in arrow filter");
+}
+
+/// @brief One 'column op value' comparison in a filter predicate
+struct clause_t {
+  string column;
+  string op;         //==, !=, <, <=, >, >=
+  string value;
+};
+
+/// @brief A parsed predicate: the OR of terms, where each term is the AND of its clauses
+using predicate_t = vector<vector<clause_t>>;
+
+/// @brief Find a token in a string, skipping over anything inside single or double quotes
+size_t findUnquoted(const string &s, const string &token, size_t pos=0) {
+  char quote = 0;
+  for(size_t i=pos; i<s.size(); i++) {
+    if(quote) {
+      if(s[i]==quote) quote = 0;
+    } else if((s[i]=='"') || (s[i]=='\'')) {
+      quote = s[i];
+    } else if(s.compare(i, token.size(), token)==0) {
+      return i;
+    }
+  }
+  return string::npos;
+}
+
+/// @brief Split a string on every occurrence of a multi-character separator that is not inside quotes
+vector<string> splitOn(const string &s, const string &separator) {
+  vector<string> parts;
+  size_t pos = 0;
+  while(true) {
+    auto next = findUnquoted(s, separator, pos);
+    parts.push_back(s.substr(pos, (next == string::npos) ? string::npos : next-pos));
+    if(next == string::npos) break;
+    pos = next + separator.size();
+  }
+  return parts;
+}
+
+/// @brief Parse a single 'column op value' comparison
+arrow::Status parseClause(const string &text, clause_t *clause) {
+
+  //Two-character ops must be checked before their one-character prefixes
+  const vector<string> ops = { "==", "!=", "<=", ">=", "<", ">" };
+
+  for(auto &op : ops) {
+    auto op_pos = findUnquoted(text, op);
+    if(op_pos == string::npos) continue;
+    clause->column = trim(text.substr(0, op_pos));
+    clause->op     = op;
+    clause->value  = trim(text.substr(op_pos + op.size()));
+    break;
+  }
+  if(clause->op.empty() || clause->column.empty() || clause->value.empty())
+    return arrow::Status::Invalid("No comparison found in arrow filter clause '"+text+"'");
+  return arrow::Status::OK();
+}
+
+/// @brief Split a predicate (eg "x>0.5 && type==3 || x<0") into its terms and clauses
+/// @note && binds tighter than ||, so the predicate is split on || first
+arrow::Status parsePredicate(const string &predicate, predicate_t *terms) {
+
+  for(auto &term_text : splitOn(predicate, "||")) {
+    vector<clause_t> term;
+    for(auto &clause_text : splitOn(term_text, "&&")) {
+      clause_t clause;
+      ARROW_RETURN_NOT_OK(parseClause(clause_text, &clause));
+      term.push_back(clause);
+    }
+    terms->push_back(term);
+  }
+  return arrow::Status::OK();
+}
+
+/// @brief Turn one clause into a boolean mask for the table
+arrow::Result<arrow::Datum> evaluateClause(const std::shared_ptr<arrow::Table> &table, const clause_t &clause) {
+
+  const map<string,string> op_functions = {
+          {"==", "equal"}, {"!=", "not_equal"}, {"<=", "less_equal"}, {">=", "greater_equal"},
+          {"<",  "less"},  {">",  "greater"} };
+
+  auto column = table->GetColumnByName(clause.column);
+  if(!column)
+    return arrow::Status::KeyError("Column '"+clause.column+"' not found in arrow filter");
+  ARROW_ASSIGN_OR_RAISE(auto scalar, parseValue(clause.value));
+  return arrow::compute::CallFunction(op_functions.at(clause.op), {column, scalar});
+}
+
+/// @brief Use a chunk's zone map to decide whether a clause could be true for any of its rows
+bool clauseMayMatch(const ArrowDataObject &fado, int chunk_id, const clause_t &clause) {
+
+  ArrowDataObject::ColumnStats stats;
+  if(!fado.GetColumnStats(chunk_id, clause.column, &stats)) return true; //No stats: must scan
+  if(!stats.has_range) return false; //All nulls never pass a comparison
+
+  int64_t ival;
+  bool int_value = parseInteger(clause.value, &ival);
+  char *end = nullptr;
+  double dval = strtod(clause.value.c_str(), &end);
+  if((!int_value) && ((end==nullptr) || (*end!='\0'))) return true; //Not a number: can't prune
+
+  if(stats.is_integer && int_value) {
+    if(clause.op=="==") return (stats.min_i <= ival) && (ival <= stats.max_i);
+    if(clause.op=="!=") return !((stats.min_i == ival) && (stats.max_i == ival));
+    if(clause.op=="<")  return stats.min_i <  ival;
+    if(clause.op=="<=") return stats.min_i <= ival;
+    if(clause.op==">")  return stats.max_i >  ival;
+    if(clause.op==">=") return stats.max_i >= ival;
+  } else {
+    if(clause.op=="==") return (stats.min_d <= dval) && (dval <= stats.max_d);
+    if(clause.op=="!=") return !((stats.min_d == dval) && (stats.max_d == dval));
+    if(clause.op=="<")  return stats.min_d <  dval;
+    if(clause.op=="<=") return stats.min_d <= dval;
+    if(clause.op==">")  return stats.max_d >  dval;
+    if(clause.op==">=") return stats.max_d >= dval;
+  }
+  return true;
+}
+
+/// @brief Run an operation on every ArrowDataObject in a compute request and pack the results in one object
+kelpie::rc_t applyToObjects(const string &args, const map<kelpie::Key, lunasa::DataObject> &ldos,
+                            lunasa::DataObject *ext_ldo, const fn_table_op_t &op) {
+
+  if(ldos.empty()) return kelpie::KELPIE_ENOENT;
+
+  vector<std::shared_ptr<arrow::Table>> results;
+  for(auto &key_ldo : ldos) {
+    ArrowDataObject fado(key_ldo.second);
+    if((!fado.Valid()) || (fado.NumberOfTables()==0)) continue;
+
+    auto table = fado.ExtractAllTables();
+    if(!table.ok()) return kelpie::KELPIE_EIO;
+    auto result = op(*table, args);
+    if(!result.ok()) return kelpie::KELPIE_EINVAL;
+    results.push_back(*result);
+  }
+  if(results.empty()) return kelpie::KELPIE_ENOENT;
+
+  auto fado = ArrowDataObject::Make(results);
+  if(!fado.ok()) return kelpie::KELPIE_EIO;
+  if(ext_ldo) *ext_ldo = fado->ExportDataObject();
+  return kelpie::KELPIE_OK;
+}
+
+} // namespace
+
+/**
+ * @brief Keep only the named columns of a table
+ * @param[in] table The source table
+ * @param[in] args Comma-separated list of column names, in the order they should appear
+ * @return The projected table or an error if a column is unknown
+ */
+arrow::Result<std::shared_ptr<arrow::Table>> Project(const std::shared_ptr<arrow::Table> &table, const string &args) {
+  vector<int> indices;
+  for(auto &name : Split(args, ',', true)) {
+    int idx = table->schema()->GetFieldIndex(trim(name));
+    if(idx < 0)
+      return arrow::Status::KeyError("Column '"+trim(name)+"' not found in arrow projection");
+    indices.push_back(idx);
+  }
+  if(indices.empty())
+    return arrow::Status::Invalid("No columns given for arrow projection");
+  return table->SelectColumns(indices);
+}
+
+/**
+ * @brief Keep only the rows of a table that match a predicate
+ * @param[in] table The source table
+ * @param[in] args Predicate (eg "x>0.5 && type==3"). && binds tighter than ||, as in C
+ * @return The filtered table or an error if the predicate could not be parsed
+ */
+arrow::Result<std::shared_ptr<arrow::Table>> Filter(const std::shared_ptr<arrow::Table> &table, const string &args) {
+
+  predicate_t terms;
+  ARROW_RETURN_NOT_OK(parsePredicate(args, &terms));
+
+  arrow::Datum mask;
+  for(size_t t=0; t<terms.size(); t++) {
+    arrow::Datum term_mask;
+    for(size_t c=0; c<terms[t].size(); c++) {
+      ARROW_ASSIGN_OR_RAISE(auto clause_mask, evaluateClause(table, terms[t][c]));
+      if(c==0) {
+        term_mask = clause_mask;
+      } else {
+        ARROW_ASSIGN_OR_RAISE(term_mask, arrow::compute::CallFunction("and", {term_mask, clause_mask}));
+      }
+    }
+    if(t==0) {
+      mask = term_mask;
+    } else {
+      ARROW_ASSIGN_OR_RAISE(mask, arrow::compute::CallFunction("or", {mask, term_mask}));
+    }
+  }
+
+  ARROW_ASSIGN_OR_RAISE(auto filtered, arrow::compute::CallFunction("filter", {table, mask}));
+  return filtered.table();
+}
+
+/**
+ * @brief Use an object's zone maps to decide whether any row in a chunk could match a predicate
+ * @param[in] fado The object holding the chunk
+ * @param[in] chunk_id The chunk to check
+ * @param[in] predicate A filter predicate (same syntax as Filter)
+ * @retval true The chunk may have matching rows (or it has no stats to rule them out)
+ * @retval false No row in the chunk can match, so it can be skipped without deserializing it
+ */
+bool ChunkMayMatch(const ArrowDataObject &fado, int chunk_id, const string &predicate) {
+
+  predicate_t terms;
+  if(!parsePredicate(predicate, &terms).ok()) return true; //Let the real filter report the problem
+
+  for(auto &term : terms) {
+    bool term_may_match = true;
+    for(auto &clause : term)
+      term_may_match = term_may_match && clauseMayMatch(fado, chunk_id, clause);
+    if(term_may_match) return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Decide whether any chunk in an object could match a predicate
+ * @param[in] fado The object to check
+ * @param[in] predicate A filter predicate (same syntax as Filter)
+ * @retval true At least one chunk may have matching rows
+ * @retval false The whole object can be skipped
+ */
+bool ObjectMayMatch(const ArrowDataObject &fado, const string &predicate) {
+  for(int i=0; i<fado.NumberOfTables(); i++)
+    if(ChunkMayMatch(fado, i, predicate)) return true;
+  return false;
+}
+
+/**
+ * @brief Keep only the first N rows of a table
+ * @param[in] table The source table
+ * @param[in] args The maximum number of rows to keep
+ * @return The (zero-copy) slice of the table
+ */
+arrow::Result<std::shared_ptr<arrow::Table>> Limit(const std::shared_ptr<arrow::Table> &table, const string &args) {
+  uint64_t num_rows;
+  if(StringToUInt64(&num_rows, trim(args)) != 0)
+    return arrow::Status::Invalid("Could not parse row limit '"+args+"'");
+  return table->Slice(0, std::min<int64_t>(num_rows, table->num_rows()));
+}
+
+/**
+ * @brief Keep a random fraction of the rows in a table
+ * @param[in] table The source table
+ * @param[in] args The fraction of rows to keep (0-1), optionally followed by ",seed"
+ * @return The sampled table
+ * @note The same seed always selects the same rows, so repeated queries are consistent
+ */
+arrow::Result<std::shared_ptr<arrow::Table>> Sample(const std::shared_ptr<arrow::Table> &table, const string &args) {
+
+  auto tokens = Split(args, ',', true);
+  if(tokens.empty() || (tokens.size()>2))
+    return arrow::Status::Invalid("Arrow sample expects 'fraction[,seed]'");
+
+  auto fraction_text = trim(tokens[0]);
+  char *end = nullptr;
+  double fraction = strtod(fraction_text.c_str(), &end);
+  if((end==nullptr) || (*end!='\0') || (fraction<0.0) || (fraction>1.0))
+    return arrow::Status::Invalid("Arrow sample fraction must be between 0 and 1");
+
+  uint64_t seed = 0;
+  if((tokens.size()==2) && (StringToUInt64(&seed, trim(tokens[1])) != 0))
+    return arrow::Status::Invalid("Could not parse sample seed '"+tokens[1]+"'");
+
+  std::mt19937_64 prng(seed);
+  std::uniform_real_distribution<double> distrib(0.0, 1.0);
+  arrow::BooleanBuilder builder;
+  ARROW_RETURN_NOT_OK(builder.Reserve(table->num_rows()));
+  for(int64_t i=0; i<table->num_rows(); i++)
+    builder.UnsafeAppend(distrib(prng) < fraction);
+  std::shared_ptr<arrow::Array> mask;
+  ARROW_RETURN_NOT_OK(builder.Finish(&mask));
+
+  ARROW_ASSIGN_OR_RAISE(auto sampled, arrow::compute::CallFunction("filter", {table, mask}));
+  return sampled.table();
+}
+
+
+/// @brief Compute function for arrow_project (see ArrowComputeFunctions.hh)
+kelpie::rc_t fn_project(faodel::bucket_t, const kelpie::Key &, const string &args,
+                        map<kelpie::Key, lunasa::DataObject> ldos, lunasa::DataObject *ext_ldo) {
+  return applyToObjects(args, ldos, ext_ldo, Project);
+}
+
+/// @brief Compute function for arrow_filter (see ArrowComputeFunctions.hh)
+/// @note Chunks whose zone maps rule out a match are skipped without being deserialized
+kelpie::rc_t fn_filter(faodel::bucket_t, const kelpie::Key &, const string &args,
+                       map<kelpie::Key, lunasa::DataObject> ldos, lunasa::DataObject *ext_ldo) {
+
+  if(ldos.empty()) return kelpie::KELPIE_ENOENT;
+
+  predicate_t terms;
+  if(!parsePredicate(args, &terms).ok()) return kelpie::KELPIE_EINVAL;
+
+  bool found_arrow = false;
+  vector<std::shared_ptr<arrow::Table>> results;
+  for(auto &key_ldo : ldos) {
+    ArrowDataObject fado(key_ldo.second);
+    if((!fado.Valid()) || (fado.NumberOfTables()==0)) continue;
+    found_arrow = true;
+
+    vector<std::shared_ptr<arrow::Table>> matches;
+    for(int i=0; i<fado.NumberOfTables(); i++) {
+      if(!ChunkMayMatch(fado, i, args)) continue;
+      auto table = fado.ExtractTable(i);
+      if(!table.ok()) return kelpie::KELPIE_EIO;
+      auto result = Filter(*table, args);
+      if(!result.ok()) return kelpie::KELPIE_EINVAL;
+      matches.push_back(*result);
+    }
+    if(matches.empty()) continue; //Whole object pruned
+
+    auto combined = arrow::ConcatenateTables(matches);
+    if(!combined.ok()) return kelpie::KELPIE_EIO;
+    results.push_back(*combined);
+  }
+  if(!found_arrow) return kelpie::KELPIE_ENOENT;
+
+  //Every object was pruned. Hand back a valid object with no tables
+  if(results.empty()) {
+    if(ext_ldo) *ext_ldo = ArrowDataObject(0).ExportDataObject();
+    return kelpie::KELPIE_OK;
+  }
+
+  auto fado = ArrowDataObject::Make(results);
+  if(!fado.ok()) return kelpie::KELPIE_EIO;
+  if(ext_ldo) *ext_ldo = fado->ExportDataObject();
+  return kelpie::KELPIE_OK;
+}
+
+/// @brief Compute function for arrow_limit (see ArrowComputeFunctions.hh)
+kelpie::rc_t fn_limit(faodel::bucket_t, const kelpie::Key &, const string &args,
+                      map<kelpie::Key, lunasa::DataObject> ldos, lunasa::DataObject *ext_ldo) {
+  return applyToObjects(args, ldos, ext_ldo, Limit);
+}
+
+/// @brief Compute function for arrow_sample (see ArrowComputeFunctions.hh)
+kelpie::rc_t fn_sample(faodel::bucket_t, const kelpie::Key &, const string &args,
+                       map<kelpie::Key, lunasa::DataObject> ldos, lunasa::DataObject *ext_ldo) {
+  return applyToObjects(args, ldos, ext_ldo, Sample);
+}
+
+} // namespace arrow_compute
+} // namespace faodel
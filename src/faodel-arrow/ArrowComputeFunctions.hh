@@ -0,0 +1,69 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#ifndef FAODEL_ARROWCOMPUTEFUNCTIONS_HH
+#define FAODEL_ARROWCOMPUTEFUNCTIONS_HH
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "kelpie/Kelpie.hh"
+
+#include <arrow/api.h>
+
+#include "faodel-arrow/ArrowDataObject.hh"
+
+namespace faodel {
+
+/**
+ * @brief Kelpie compute functions that reduce ArrowDataObjects on the node that stores them
+ *
+ * Analysis clients often only need a small part of a large table. These functions run inside
+ * a kelpie pool's Compute() call so that only the reduced result crosses the network. Every
+ * function walks all of the objects that matched the compute key, applies the operation to
+ * each object's tables, and returns a new ArrowDataObject with one chunk per input object.
+ * Objects that are not ArrowDataObjects are ignored.
+ *
+ * | Function     | Args                           | Result                                   |
+ * | ------------ | ------------------------------ | ---------------------------------------- |
+ * | arrow_project| col1,col2,...                  | Only the named columns                   |
+ * | arrow_filter | x>0.5 && type==3               | Only the rows that match the predicate   |
+ * | arrow_limit  | N                              | The first N rows of each object          |
+ * | arrow_sample | fraction[,seed]                | A random fraction of each object's rows  |
+ *
+ * Filter predicates are a list of `column op value` comparisons joined by `&&` or `||`.
+ * `&&` binds tighter than `||`, so `a || b && c` means `a || (b && c)`. Parentheses are not
+ * supported. The ops are ==, !=, <, <=, >, and >=. Values may be integers,
+ * floating point numbers, or quoted strings. arrow_filter checks each chunk's zone map
+ * (see ArrowDataObject::GetColumnStats) first and skips chunks that cannot match. Clients
+ * can do the same with ChunkMayMatch/ObjectMayMatch.
+ *
+ * @note Call RegisterArrowComputeFunctions() on every node before bootstrap::Start()
+ */
+void RegisterArrowComputeFunctions();
+
+namespace arrow_compute {
+
+arrow::Result<std::shared_ptr<arrow::Table>> Project(const std::shared_ptr<arrow::Table> &table, const std::string &args);
+arrow::Result<std::shared_ptr<arrow::Table>> Filter(const std::shared_ptr<arrow::Table> &table, const std::string &args);
+arrow::Result<std::shared_ptr<arrow::Table>> Limit(const std::shared_ptr<arrow::Table> &table, const std::string &args);
+arrow::Result<std::shared_ptr<arrow::Table>> Sample(const std::shared_ptr<arrow::Table> &table, const std::string &args);
+
+bool ChunkMayMatch(const ArrowDataObject &fado, int chunk_id, const std::string &predicate);
+bool ObjectMayMatch(const ArrowDataObject &fado, const std::string &predicate);
+
+kelpie::rc_t fn_project(faodel::bucket_t, const kelpie::Key &key, const std::string &args,
+                        std::map<kelpie::Key, lunasa::DataObject> ldos, lunasa::DataObject *ext_ldo);
+kelpie::rc_t fn_filter(faodel::bucket_t, const kelpie::Key &key, const std::string &args,
+                       std::map<kelpie::Key, lunasa::DataObject> ldos, lunasa::DataObject *ext_ldo);
+kelpie::rc_t fn_limit(faodel::bucket_t, const kelpie::Key &key, const std::string &args,
+                      std::map<kelpie::Key, lunasa::DataObject> ldos, lunasa::DataObject *ext_ldo);
+kelpie::rc_t fn_sample(faodel::bucket_t, const kelpie::Key &key, const std::string &args,
+                       std::map<kelpie::Key, lunasa::DataObject> ldos, lunasa::DataObject *ext_ldo);
+
+} // namespace arrow_compute
+} // namespace faodel
+
+#endif //FAODEL_ARROWCOMPUTEFUNCTIONS_HH
@@ -5,9 +5,19 @@
 #include "ArrowDataObject.hh"
 
 #include "faodel-common/StringHelpers.hh"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 #include <arrow/buffer.h>
+#include <arrow/compute/api.h>
+#include <arrow/type_traits.h>
 #include <arrow/ipc/api.h>
 #include <arrow/filesystem/filesystem.h>
 #include <parquet/arrow/writer.h>
@@ -21,20 +31,163 @@ using namespace std;
 
 namespace faodel {
 
+namespace {
+
+/// @brief A non-owning Arrow buffer that points into an LDO and holds a reference to it
+/// @note Arrays built by the IPC reader slice this buffer, so the LDO stays alive as long
+///       as any table that was extracted from it
+class LdoBuffer : public arrow::Buffer {
+public:
+  LdoBuffer(const lunasa::DataObject &ldo, const uint8_t *data, int64_t size)
+    : arrow::Buffer(data, size), ldo(ldo) {}
+
+private:
+  lunasa::DataObject ldo;
+};
+
+/// @brief Threads that parallelFor hands work to
+/// @note Workers are started the first time they are needed and kept for the life of the process, so
+///       encoding or decoding a table doesn't pay for thread creation. The pool only grows to the
+///       largest thread count a caller has asked for (see ArrowDataObject::SetThreadCount)
+class WorkerPool {
+public:
+  static WorkerPool & Get() {
+    static WorkerPool pool;
+    return pool;
+  }
+
+  /// @brief Queue a task, starting more workers if fewer than num_workers exist
+  void Submit(std::function<void()> task, int num_workers) {
+    std::lock_guard<std::mutex> lock(mutex);
+    while(static_cast<int>(workers.size()) < num_workers)
+      workers.emplace_back(&WorkerPool::run, this);
+    tasks.push_back(std::move(task));
+    cv.notify_one();
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    cv.notify_all();
+    for(auto &t : workers)
+      t.join();
+  }
+
+private:
+  WorkerPool() = default;
+
+  void run() {
+    while(true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+        if(tasks.empty()) return; //Stopping
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::function<void()>> tasks;
+  std::vector<std::thread> workers;
+  bool stopping = false;
+};
+
+std::atomic<int>     setting_thread_count(0);  //0: use the number of hardware threads
+std::atomic<int64_t> setting_min_rows_per_thread(ArrowDataObject::default_min_rows_per_thread);
+
+/// @brief Run fn on every item in [0,num_items), spread over up to num_threads threads
+/// @param num_items Number of work items
+/// @param num_threads Maximum number of threads to use (the caller's thread is one of them)
+/// @param fn Function to run on each item
+/// @return The first error any item reported, or Ok
+/// @note Once an item fails, no new items are started. Helpers come from the WorkerPool. A helper
+///       that starts after every item has been claimed exits without touching fn, so this only
+///       waits for items that are actually running
+arrow::Status parallelFor(int num_items, int num_threads, const std::function<arrow::Status(int)> &fn) {
+
+  if(num_threads > num_items) num_threads = num_items;
+  if(num_threads <= 1) {
+    for(int i=0; i<num_items; i++)
+      ARROW_RETURN_NOT_OK(fn(i));
+    return arrow::Status::OK();
+  }
+
+  struct loop_state_t {
+    const std::function<arrow::Status(int)> *fn;
+    int num_items;
+    std::atomic<int> next_item;
+    std::mutex mutex;
+    std::condition_variable cv;
+    int running;  //Threads that may be inside fn
+    arrow::Status first_error;
+  };
+  auto state = std::make_shared<loop_state_t>();
+  state->fn = &fn;
+  state->num_items = num_items;
+  state->next_item = 0;
+  state->running = 0;
+
+  auto worker = [](const std::shared_ptr<loop_state_t> &s) {
+    while(true) {
+      {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->running++;
+      }
+      int i = s->next_item.fetch_add(1);
+      arrow::Status status;
+      if(i < s->num_items) status = (*s->fn)(i);
+
+      std::lock_guard<std::mutex> lock(s->mutex);
+      if(!status.ok()) {
+        if(s->first_error.ok()) s->first_error = status;
+        s->next_item = s->num_items;
+      }
+      if(--s->running == 0) s->cv.notify_all();
+      if(i >= s->num_items) return;
+    }
+  };
+
+  auto &pool = WorkerPool::Get();
+  for(int t=1; t<num_threads; t++)
+    pool.Submit([state, worker]() { worker(state); }, num_threads-1);
+  worker(state);
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->cv.wait(lock, [&state] { return state->running == 0; });
+  return state->first_error;
+}
+
+/// @brief Determine whether a type has dictionary-encoded data anywhere inside it
+bool hasDictionary(const std::shared_ptr<arrow::DataType> &type) {
+  if(type->id() == arrow::Type::DICTIONARY) return true;
+  for(auto &field : type->fields())
+    if(hasDictionary(field->type())) return true;
+  return false;
+}
+
+} // namespace
+
 const string ArrowDataObject::object_type_name = "ArrowRecordBatch";
 const uint16_t ArrowDataObject::object_type_id = faodel::const_hash16("ArrowRecordBatch");
 
 
 /// @brief Constructor for creating an empty FADO that can hold max_capacity bytes
 /// @param max_arrow_capacity Space available for serialized data. Includes chunk overheads and serialized IPC data, but NOT the fado_meta_t size
-ArrowDataObject::ArrowDataObject(uint32_t max_arrow_capacity) {
-  ldo = lunasa::DataObject(sizeof(fado_meta_t) + max_arrow_capacity, //Include meta here, so caller doesn't think about it
-                           sizeof(fado_meta_t),
+/// @param max_column_stats Number of zone map entries (one per numeric column per chunk) to reserve in the meta section
+ArrowDataObject::ArrowDataObject(uint32_t max_arrow_capacity, uint32_t max_column_stats) {
+  ldo = lunasa::DataObject(metaSize(max_column_stats) + max_arrow_capacity, //Include meta here, so caller doesn't think about it
+                           metaSize(max_column_stats),
                            0,
                            lunasa::DataObject::AllocatorType::eager,
                            object_type_id);
-  auto *meta = ldo.GetMetaPtr<fado_meta_t *>();
-  meta->wipe(); //Make sure we start with no items
+  initMeta(max_column_stats); //Make sure we start with no items
 }
 
 /// @prief Wrap a FADO Class around an LDO that was previously used to hold FADO data
@@ -57,41 +210,48 @@ ArrowDataObject::ArrowDataObject(const std::shared_ptr<arrow::Table> &table,
   auto options = arrow::ipc::IpcWriteOptions::Defaults();
   options.codec = arrow::util::Codec::Create(codec).ValueOrDie();
 
-  //Run serialization w/ null out to get the packed size of the table
-  int64_t table_size_in_bytes = GetSerializedTableSize(table, options).ValueOrDie();
+  //Encode large tables in parallel, or just get the packed size of small ones
+  auto encoded = encodeTables({table}, options).ValueOrDie();
 
-  // Allocate an LDO big enough to hold this
+  // Allocate an LDO big enough to hold this (and its column stats)
+  uint32_t max_stats = countStatsColumns(table->schema());
   ldo = lunasa::DataObject(
-      sizeof(fado_meta_t) + sizeof(fado_chunk_t) + table_size_in_bytes,
-      sizeof(fado_meta_t),
+      metaSize(max_stats) + sizeof(fado_chunk_t) + encoded.size,
+      metaSize(max_stats),
       0,  // append will take care of this
       lunasa::DataObject::AllocatorType::eager, object_type_id);
 
   // Wipe out the meta so we start at the beginning
-  auto *meta = ldo.GetMetaPtr<fado_meta_t *>();
-  meta->wipe();  // Make sure we start with no items
+  initMeta(max_stats);
 
   // Serialize data directly into the LDO
-  auto status = doAppendTable(table, table_size_in_bytes, options);
+  auto status = doAppendEncoded(encoded, options);
   if (!status.ok()) ldo = lunasa::DataObject();  // Error: bail out
 }
 
 /// @brief Safety check that verifies we have an LDO allocation and the LDO's type id matches FADO
+/// @note Objects written before zone maps were added have a smaller meta section. They are still valid
 bool ArrowDataObject::Valid() const {
   if(ldo.isNull()) return false;
-  return (ldo.GetTypeID() == object_type_id);
+  return ((ldo.GetTypeID() == object_type_id) && (ldo.GetMetaSize() >= legacy_meta_size));
+}
+
+/// @brief Determine whether this object's meta section has the versioned layout that holds zone maps
+bool ArrowDataObject::hasZoneMaps() const {
+  if(!Valid() || (ldo.GetMetaSize() < sizeof(fado_meta_t))) return false;
+  auto *meta = ldo.GetMetaPtr<fado_meta_t *>();
+  return ((meta->version == meta_version) && (metaSize(meta->max_stats) <= ldo.GetMetaSize()));
 }
 
 /// @brief Inspects a chunk id and determines if it's in the range of valid chunks for this object
 bool ArrowDataObject::ValidChunk(int chunk_id) const {
-   return ( (!ldo.isNull()) &&
-            (ldo.GetTypeID() == object_type_id) &&
+   return ( Valid() &&
             (chunk_id>=0) &&
             (chunk_id<NumberOfTables()));
 }
 
 /// @brief Round a size up to the next 32b value
-uint32_t ArrowDataObject::roundupChunkSize(uint32_t size) const {
+uint32_t ArrowDataObject::roundupChunkSize(uint32_t size) {
   if(size & 0x03) {
     size = ((size & ~0x03) + 4); //Round up to 32b words
   }
@@ -114,10 +274,9 @@ arrow::Status ArrowDataObject::Append(const std::shared_ptr<arrow::Table>& table
   auto options = arrow::ipc::IpcWriteOptions::Defaults();
   ARROW_ASSIGN_OR_RAISE(options.codec, arrow::util::Codec::Create(codec));
 
-  ARROW_ASSIGN_OR_RAISE(auto table_size_in_bytes,
-                        GetSerializedTableSize(table, options));
+  ARROW_ASSIGN_OR_RAISE(auto encoded, encodeTables({table}, options));
 
-  ARROW_RETURN_NOT_OK(doAppendTable(table, table_size_in_bytes, options));
+  ARROW_RETURN_NOT_OK(doAppendEncoded(encoded, options));
   return arrow::Status::OK();
 }
 
@@ -135,12 +294,13 @@ arrow::Status ArrowDataObject::Append(ArrowDataObject src_fado) {
    if(src_tables==0) return arrow::Status::OK(); //No work
 
    auto src_ldo = src_fado.ExportDataObject();
+   uint32_t first_chunk = NumberOfTables();
 
    int rc = doAppendChunkStrip(src_ldo.GetDataPtr<fado_chunk_t *>(),
                                src_ldo.GetDataSize(),
                                src_tables);
    switch(rc){
-      case 0:      return arrow::Status::OK(); break;
+      case 0:      copyStats(src_fado, first_chunk); return arrow::Status::OK(); break;
       case ENOMEM: return arrow::Status::OutOfMemory("Not enough capacity to append existing ArrowDataObject"); break;
       case EINVAL: return arrow::Status::Invalid("Source ArrowDataObject did not have data to copy"); break;
       default: ;
@@ -156,7 +316,13 @@ void ArrowDataObject::Wipe(faodel::internal_use_only_t iot, bool zero_out_data)
     memset(ldo.GetDataPtr(), 0, ldo.GetDataSize());
   }
 
-  ldo.GetMetaPtr<fado_meta_t *>()->wipe();
+  auto *meta = ldo.GetMetaPtr<fado_meta_t *>();
+  if(hasZoneMaps()) {
+    meta->wipe();
+  } else {
+    meta->num_chunks = 0; //Legacy layout only has these two fields
+    meta->object_status = 0;
+  }
   ldo.ModifyUserSizes(ldo.GetMetaSize(), 0);
 }
 
@@ -221,8 +387,9 @@ uint64_t ArrowDataObject::NumberOfRows() const {
 /// @brief Revive one of the tables serialized in this object
 /// @param chunk_id The table to retrieve
 /// @param options Any additional Arrow read options
-/// @return The table (or dies!)
-/// @note This makes a shared buffer out of the serialized data. Do not destroy the FADO while table is valid
+/// @return The table, or an error
+/// @note The table references the LDO's memory directly (no copy) and keeps the LDO alive. Compressed
+///       chunks still have to be decompressed into new buffers.
 arrow::Result<std::shared_ptr<arrow::Table>> ArrowDataObject::ExtractTable(int chunk_id, arrow::ipc::IpcReadOptions options) const {
 
   if(!ValidChunk(chunk_id))
@@ -232,24 +399,95 @@ arrow::Result<std::shared_ptr<arrow::Table>> ArrowDataObject::ExtractTable(int c
   if((!chunk) || (!chunk->valid()))
      return arrow::Status::IndexError("Could not locate a valid chunk in this Faodel ArrowDataObject");
 
+  options.use_threads = true;
+  return extractChunk(chunk, options);
+}
+
+/// @brief Revive all of the tables serialized in this object as a single table
+/// @param options Any additional Arrow read options
+/// @param num_threads Number of threads used to decode chunks (0 uses DefaultThreadCount())
+/// @return One table containing the rows of every chunk, or an error
+/// @note All chunks must have the same schema. Chunks become the table's record batches without a
+///       copy, so the result references (and keeps alive) the LDO's memory like ExtractTable
+arrow::Result<std::shared_ptr<arrow::Table>> ArrowDataObject::ExtractAllTables(arrow::ipc::IpcReadOptions options, int num_threads) const {
+
+  int num_chunks = NumberOfTables();
+  if(num_chunks==0)
+     return arrow::Status::Invalid("Faodel ArrowDataObject does not contain any tables");
+
+  //Locate every chunk up front so they can be decoded independently
+  vector<const fado_chunk_t *> chunks;
+  auto *ptr = ldo.GetDataPtr<char *>();
+  for(int i=0; i<num_chunks; i++) {
+    auto *chunk = reinterpret_cast<fado_chunk_t*>(ptr);
+    if(!chunk->valid())
+       return arrow::Status::IndexError("Could not locate a valid chunk in this Faodel ArrowDataObject");
+    chunks.push_back(chunk);
+    ptr += roundupChunkSize(sizeof(fado_chunk_t) + chunk->data_length);
+  }
+
+  //Only let Arrow use its own threads when we aren't decoding chunks in parallel
+  if(num_threads<=0) num_threads = DefaultThreadCount();
+  options.use_threads = (std::min(num_threads, num_chunks) <= 1);
 
-  #if 1
-    //Normal version: create a buffer based on the pointers to the real data
-    auto buf = std::make_shared<arrow::Buffer>((const uint8_t *)chunk->data, chunk->data_length);
-  #else
-    //Extra copy: This version allocates a side buffer for unpacking the data. Shouldn't be used- included for paranoia
-    std::shared_ptr<faodel-arrow::Buffer> buf = *faodel-arrow::AllocateBuffer(chunk->data_length); //Normally a unique ptr
-    memcpy(buf->mutable_data(), chunk->data, chunk->data_length);
-  #endif
+  vector<std::shared_ptr<arrow::Table>> tables(num_chunks);
+  ARROW_RETURN_NOT_OK(parallelFor(num_chunks, num_threads, [&](int i) -> arrow::Status {
+    ARROW_ASSIGN_OR_RAISE(tables[i], extractChunk(chunks[i], options));
+    return arrow::Status::OK();
+  }));
+  if(tables.size()==1) return tables[0];
 
+  return arrow::ConcatenateTables(tables);
+}
+
+/// @brief Internal function for deserializing a chunk straight out of the LDO
+/// @param chunk The (valid) chunk to read
+/// @param options Any additional Arrow read options
+/// @return The table, or an error
+arrow::Result<std::shared_ptr<arrow::Table>> ArrowDataObject::extractChunk(const fado_chunk_t *chunk, arrow::ipc::IpcReadOptions options) const {
+
+  auto buf = std::make_shared<LdoBuffer>(ldo, reinterpret_cast<const uint8_t *>(chunk->data), chunk->data_length);
   auto buffer_reader = std::make_shared<arrow::io::BufferReader>(buf);
 
-  options.use_threads = true;
   ARROW_ASSIGN_OR_RAISE(auto reader,
                         arrow::ipc::RecordBatchStreamReader::Open(buffer_reader, options));
 
   return reader->ToTable();
+}
 
+/// @brief Look up the zone map entry for one column of one chunk
+/// @param chunk_id The chunk to inspect
+/// @param column_name The name of the (numeric) column
+/// @param[out] stats The column's statistics
+/// @retval true Stats were found
+/// @retval false No stats for this column (non-numeric column, unknown name, or meta section was full)
+/// @note This only reads the meta section. No table data is touched
+bool ArrowDataObject::GetColumnStats(int chunk_id, const std::string &column_name, ColumnStats *stats) const {
+  if(!ValidChunk(chunk_id) || !hasZoneMaps()) return false;
+  auto *meta = ldo.GetMetaPtr<fado_meta_t *>();
+  for(uint32_t i=0; i<meta->num_stats; i++) {
+    auto &entry = meta->stats[i];
+    if((entry.chunk_id != static_cast<uint32_t>(chunk_id)) ||
+       (strncmp(entry.column_name, column_name.c_str(), max_stats_name_len) != 0)) continue;
+    if(stats) {
+      stats->is_integer = entry.is_integer;
+      stats->has_range  = entry.has_range;
+      stats->min_i      = (entry.is_integer) ? entry.min.i : static_cast<int64_t>(entry.min.d);
+      stats->max_i      = (entry.is_integer) ? entry.max.i : static_cast<int64_t>(entry.max.d);
+      stats->min_d      = (entry.is_integer) ? static_cast<double>(entry.min.i) : entry.min.d;
+      stats->max_d      = (entry.is_integer) ? static_cast<double>(entry.max.i) : entry.max.d;
+      stats->null_count = entry.null_count;
+      stats->row_count  = entry.row_count;
+    }
+    return true;
+  }
+  return false;
+}
+
+/// @brief Report how many zone map entries are stored in this object's meta section
+uint32_t ArrowDataObject::NumberOfColumnStats() const {
+  if(!hasZoneMaps()) return 0;
+  return ldo.GetMetaPtr<fado_meta_t *>()->num_stats;
 }
 
 /// @brief Walk through all chunks and make sure each one has a non-zero length
@@ -268,7 +506,8 @@ bool ArrowDataObject::dbgAllChunksValid() const {
 /// @return String containing info
 std::string ArrowDataObject::str(bool show_details) const {
    stringstream ss;
-   ss<<"support : NumTables:" << NumberOfTables() <<" Valid: "<<Valid()<<" UtilizationRatio: "<<CurrentUtilizationRatio()<<endl;
+   ss<<"support : NumTables:" << NumberOfTables() <<" Valid: "<<Valid()<<" UtilizationRatio: "<<CurrentUtilizationRatio()
+     <<" ColumnStats: "<<NumberOfColumnStats()<<endl;
    if(show_details) {
       auto *data = ldo.GetDataPtr<char *>();
       int num_bundles = ldo.GetMetaPtr<fado_meta_t *>()->num_chunks;
@@ -326,18 +565,6 @@ arrow::Status ArrowDataObject::ToParquet(const std::string &full_path_filename,
 
 }
 
-/// @brief Internal function for appending a new table into this object. Requires knowing serialized size of table
-/// @param table Source table
-/// @param table_size_in_bytes  Serialized size of table
-/// @param options Any IPC options (eg compression) to pass in when serializing
-/// @return Arrow Status for the operation
-arrow::Status ArrowDataObject::doAppendTable(
-    const std::shared_ptr<arrow::Table> &table, int64_t table_size_in_bytes,
-    const arrow::ipc::IpcWriteOptions &options) {
-   return doAppendTables(vector<std::shared_ptr<arrow::Table>>{table},
-                         table_size_in_bytes, options);
-}
-
 /// @brief Internal function for appending multiple tables of same schema into an object
 /// @param tables Tables to be appended (must be same schema)
 /// @param tables_size_in_bytes Total size of the serialized tables
@@ -383,8 +610,128 @@ arrow::Status ArrowDataObject::doAppendTables(
    uint32_t new_chunk_size =
        roundupChunkSize(sizeof(fado_chunk_t) + tables_size_in_bytes);
    ldo.ModifyUserSizes(ldo.GetMetaSize(), ldo.GetDataSize() + new_chunk_size);
-   ldo.GetMetaPtr<fado_meta_t *>()->num_chunks++;
+   auto *meta = ldo.GetMetaPtr<fado_meta_t *>();
+   appendStats(meta->num_chunks, tables);
+   meta->num_chunks++;
+
+   return arrow::Status::OK();
+}
 
+/// @brief Work out how big a set of tables is when serialized into one chunk, encoding large tables in parallel
+/// @param tables Tables that will share a chunk (must be same schema)
+/// @param options IPC options (eg compression) to serialize with
+/// @return The sizes (and, when parallel, the encoded record batches), or an error
+/// @note When the tables are big enough and more than one thread is allowed, each table is split into record
+///       batches that are encoded (and compressed) at the same time. Uncompressed batches still point at the
+///       table's memory, so their data is only copied once, when it is written into the LDO. Otherwise this
+///       only measures the tables and doAppendEncoded() serializes them on one thread.
+arrow::Result<ArrowDataObject::encoded_tables_t> ArrowDataObject::encodeTables(
+    const vector<std::shared_ptr<arrow::Table>> &tables,
+    const arrow::ipc::IpcWriteOptions &options) {
+
+   encoded_tables_t encoded;
+   encoded.tables = tables;
+   encoded.size = 0;
+
+   int64_t num_rows = 0;
+   for(auto &table : tables)
+      num_rows += table->num_rows();
+
+   //Dictionaries need dictionary batches, which only the stream writer knows how to order
+   auto schema = tables[0]->schema();
+   bool has_dictionary = false;
+   for(auto &field : schema->fields())
+      has_dictionary |= hasDictionary(field->type());
+
+   int64_t min_rows = std::max<int64_t>(setting_min_rows_per_thread, 1);
+   int num_threads = std::min<int64_t>(DefaultThreadCount(), num_rows / min_rows);
+   if((num_threads <= 1) || has_dictionary || options.write_legacy_ipc_format) {
+      for(auto &table : tables) {
+         ARROW_ASSIGN_OR_RAISE(auto table_size_in_bytes, GetSerializedTableSize(table, options));
+         encoded.size += table_size_in_bytes;
+      }
+      return encoded;
+   }
+
+   //Split into about one batch per thread. Batches never cross the tables' own chunk boundaries
+   vector<std::shared_ptr<arrow::RecordBatch>> batches;
+   for(auto &table : tables) {
+      arrow::TableBatchReader reader(*table);
+      reader.set_chunksize((table->num_rows() + num_threads - 1) / num_threads);
+      std::shared_ptr<arrow::RecordBatch> batch;
+      while(true) {
+         ARROW_RETURN_NOT_OK(reader.ReadNext(&batch));
+         if(!batch) break;
+         batches.push_back(batch);
+      }
+   }
+
+   //Each batch is compressed on its own thread, so don't have Arrow spread the work out further
+   auto batch_options = options;
+   batch_options.use_threads = false;
+   encoded.batches.resize(batches.size());
+   ARROW_RETURN_NOT_OK(parallelFor(batches.size(), num_threads, [&](int i) -> arrow::Status {
+      return arrow::ipc::GetRecordBatchPayload(*batches[i], batch_options, &encoded.batches[i]);
+   }));
+
+   //Lay out the stream: schema message, the batches, then the end-of-stream marker
+   ARROW_ASSIGN_OR_RAISE(encoded.schema, arrow::ipc::SerializeSchema(*schema));
+   encoded.size = encoded.schema->size();
+   for(auto &payload : encoded.batches) {
+      encoded.offsets.push_back(encoded.size);
+      encoded.size += arrow::ipc::GetPayloadSize(payload, options);
+   }
+   encoded.size += 2*sizeof(int32_t);
+   return encoded;
+}
+
+/// @brief Internal function for writing tables from encodeTables() into a new chunk
+/// @param encoded The tables and their sizes
+/// @param options The IPC options the tables were sized with
+/// @return Arrow Status for the operation
+/// @note Every batch's offset is known before any data is written, so each thread writes its batch into its
+///       own slot. The object is only updated once every slot is written, so a failure leaves it unchanged.
+arrow::Status ArrowDataObject::doAppendEncoded(const encoded_tables_t &encoded,
+                                               const arrow::ipc::IpcWriteOptions &options) {
+
+   if(!encoded.schema) return doAppendTables(encoded.tables, encoded.size, options);
+
+   auto available_capacity = ldo.GetUserCapacity() - ldo.GetUserSize() - sizeof(fado_chunk_t);
+   if (available_capacity < encoded.size) {
+      return arrow::Status::CapacityError(
+          "Not enough capacity to append tables");
+   }
+
+   auto *chunk = reinterpret_cast<fado_chunk_t *>(ldo.GetDataPtr<char *>() +
+                                                  ldo.GetDataSize());
+   auto *data = reinterpret_cast<uint8_t *>(chunk->data);
+   memcpy(data, encoded.schema->data(), encoded.schema->size());
+
+   int num_batches = encoded.batches.size();
+   ARROW_RETURN_NOT_OK(parallelFor(num_batches, DefaultThreadCount(), [&](int i) -> arrow::Status {
+      int64_t batch_size = ((i+1 < num_batches) ? encoded.offsets[i+1] : encoded.size - 2*sizeof(int32_t)) - encoded.offsets[i];
+      arrow::io::FixedSizeBufferWriter sink(
+          std::make_shared<arrow::MutableBuffer>(data + encoded.offsets[i], batch_size));
+      int32_t metadata_length;
+      ARROW_RETURN_NOT_OK(arrow::ipc::WriteIpcPayload(encoded.batches[i], options, &sink, &metadata_length));
+      return sink.Close();
+   }));
+
+   //End of stream: a continuation marker followed by a zero length
+   int32_t eos[2] = { -1, 0 };
+   memcpy(data + encoded.size - sizeof(eos), eos, sizeof(eos));
+
+   chunk->setMagic();
+   chunk->data_length = encoded.size;
+   chunk->num_rows = 0;
+   for(auto &table : encoded.tables)
+      chunk->num_rows += table->num_rows();
+
+   uint32_t new_chunk_size = roundupChunkSize(sizeof(fado_chunk_t) + encoded.size);
+   ldo.ModifyUserSizes(ldo.GetMetaSize(), ldo.GetDataSize() + new_chunk_size);
+   auto *meta = ldo.GetMetaPtr<fado_meta_t *>();
+   appendStats(meta->num_chunks, encoded.tables);
+   meta->num_chunks++;
    return arrow::Status::OK();
 }
 
@@ -418,6 +765,97 @@ int ArrowDataObject::doAppendChunkStrip(const faodel::ArrowDataObject::fado_chun
    return 0;
 }
 
+/// @brief Wipe the meta section and record how many zone map entries it can hold
+void ArrowDataObject::initMeta(uint32_t max_stats) {
+  auto *meta = ldo.GetMetaPtr<fado_meta_t *>();
+  meta->wipe();
+  meta->version = meta_version;
+  meta->max_stats = max_stats;
+  meta->reserved = 0;
+}
+
+/// @brief Count the columns in a schema that get zone map entries (ie, the numeric ones)
+uint32_t ArrowDataObject::countStatsColumns(const std::shared_ptr<arrow::Schema> &schema) {
+  uint32_t count=0;
+  for(auto &field : schema->fields()) {
+    auto id = field->type()->id();
+    if(arrow::is_integer(id) || arrow::is_floating(id)) count++;
+  }
+  return count;
+}
+
+/// @brief Compute min/max/null/row stats for each numeric column of a new chunk and store them in the meta section
+/// @param chunk_id The chunk the tables were written to
+/// @param tables The tables that were serialized into the chunk (all with the same schema)
+/// @note Columns are skipped when the meta section is full. Missing stats just mean a chunk can't be pruned
+void ArrowDataObject::appendStats(uint32_t chunk_id, const std::vector<std::shared_ptr<arrow::Table>> &tables) {
+
+  if(!hasZoneMaps()) return; //Legacy object
+  auto *meta = ldo.GetMetaPtr<fado_meta_t *>();
+  auto schema = tables[0]->schema();
+
+  for(int c=0; (c<schema->num_fields()) && (meta->num_stats < meta->max_stats); c++) {
+    auto type_id = schema->field(c)->type()->id();
+    if(!(arrow::is_integer(type_id) || arrow::is_floating(type_id))) continue;
+    const auto &column_name = schema->field(c)->name();
+    if(column_name.size() >= max_stats_name_len) continue;
+
+    //uint64 may not fit in an int64, so keep its range as a double
+    bool is_integer = arrow::is_integer(type_id) && (type_id != arrow::Type::UINT64);
+    auto as_type = (is_integer) ? arrow::int64() : arrow::float64();
+
+    fado_stats_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.chunk_id    = chunk_id;
+    strncpy(entry.column_name, column_name.c_str(), max_stats_name_len);
+    entry.is_integer  = is_integer;
+
+    bool ok = true;
+    for(auto &table : tables) {
+      auto column = table->column(c);
+      entry.null_count += column->null_count();
+      entry.row_count  += column->length();
+
+      auto min_max = arrow::compute::CallFunction("min_max", {column});
+      if(!min_max.ok()) { ok=false; break; }
+      auto range = std::static_pointer_cast<arrow::StructScalar>(min_max->scalar());
+      if(!range->value[0]->is_valid) continue; //All nulls: no range for this table
+
+      auto lo = arrow::compute::Cast(range->value[0], as_type);
+      auto hi = arrow::compute::Cast(range->value[1], as_type);
+      if((!lo.ok()) || (!hi.ok())) { ok=false; break; }
+      fado_stats_t::value_t vlo, vhi;
+      if(is_integer) {
+        vlo.i = std::static_pointer_cast<arrow::Int64Scalar>(lo->scalar())->value;
+        vhi.i = std::static_pointer_cast<arrow::Int64Scalar>(hi->scalar())->value;
+        if(!entry.has_range || (vlo.i < entry.min.i)) entry.min.i = vlo.i;
+        if(!entry.has_range || (vhi.i > entry.max.i)) entry.max.i = vhi.i;
+      } else {
+        vlo.d = std::static_pointer_cast<arrow::DoubleScalar>(lo->scalar())->value;
+        vhi.d = std::static_pointer_cast<arrow::DoubleScalar>(hi->scalar())->value;
+        if(!entry.has_range || (vlo.d < entry.min.d)) entry.min.d = vlo.d;
+        if(!entry.has_range || (vhi.d > entry.max.d)) entry.max.d = vhi.d;
+      }
+      entry.has_range = 1;
+    }
+    if(ok) meta->stats[meta->num_stats++] = entry;
+  }
+}
+
+/// @brief Copy another object's zone map entries into this object, as space permits
+/// @param src_fado The object whose chunks were just appended to this one
+/// @param chunk_offset The id the source's first chunk has in this object
+void ArrowDataObject::copyStats(const ArrowDataObject &src_fado, uint32_t chunk_offset) {
+  if(!hasZoneMaps() || !src_fado.hasZoneMaps()) return;
+  auto *meta = ldo.GetMetaPtr<fado_meta_t *>();
+  auto *src_meta = src_fado.ldo.GetMetaPtr<fado_meta_t *>();
+  for(uint32_t i=0; (i<src_meta->num_stats) && (meta->num_stats < meta->max_stats); i++) {
+    meta->stats[meta->num_stats] = src_meta->stats[i];
+    meta->stats[meta->num_stats].chunk_id += chunk_offset;
+    meta->num_stats++;
+  }
+}
+
 /// @brief Debug function that checks to make sure a chunk is valid.
 void ArrowDataObject::validChunkOrDie(fado_chunk_t *chunk, int i, const std::string &function) const {
    if((chunk) && (chunk->valid())) return;
@@ -435,10 +873,9 @@ arrow::Result<ArrowDataObject> ArrowDataObject::Make(
    auto options = arrow::ipc::IpcWriteOptions::Defaults();
    ARROW_ASSIGN_OR_RAISE(options.codec, arrow::util::Codec::Create(codec));
 
-   ARROW_ASSIGN_OR_RAISE(auto table_size_in_bytes,
-                         GetSerializedTableSize(table, options));
-   ArrowDataObject fado(sizeof(fado_chunk_t) + table_size_in_bytes);
-   ARROW_RETURN_NOT_OK(fado.doAppendTable(table, table_size_in_bytes, options));
+   ARROW_ASSIGN_OR_RAISE(auto encoded, encodeTables({table}, options));
+   ArrowDataObject fado(sizeof(fado_chunk_t) + encoded.size, countStatsColumns(table->schema()));
+   ARROW_RETURN_NOT_OK(fado.doAppendEncoded(encoded, options));
    return fado;
 }
 
@@ -453,19 +890,20 @@ arrow::Result<ArrowDataObject> ArrowDataObject::Make(
    auto options = arrow::ipc::IpcWriteOptions::Defaults();
    ARROW_ASSIGN_OR_RAISE(options.codec, arrow::util::Codec::Create(codec));
 
-   vector<int64_t> table_sizes;
+   vector<encoded_tables_t> encoded_tables;
    size_t total_size = 0;
+   uint32_t total_stats = 0;
    for (const auto &table : tables) {
-      ARROW_ASSIGN_OR_RAISE(auto table_size_in_bytes,
-                            GetSerializedTableSize(table, options));
-      table_sizes.push_back(table_size_in_bytes);
-      total_size += sizeof(fado_chunk_t) + table_size_in_bytes;
+      ARROW_ASSIGN_OR_RAISE(auto encoded, encodeTables({table}, options));
+      total_size += sizeof(fado_chunk_t) + encoded.size;
+      total_stats += countStatsColumns(table->schema());
+      encoded_tables.push_back(std::move(encoded));
    }
 
    // Pack the tables into a single fado
-   ArrowDataObject fado(total_size);
-   for (int i = 0; i < tables.size(); i++) {
-      ARROW_RETURN_NOT_OK(fado.doAppendTable(tables[i], table_sizes[i], options));
+   ArrowDataObject fado(total_size, total_stats);
+   for (const auto &encoded : encoded_tables) {
+      ARROW_RETURN_NOT_OK(fado.doAppendEncoded(encoded, options));
    }
    return fado;
 }
@@ -478,15 +916,17 @@ arrow::Result<ArrowDataObject> ArrowDataObject::Make(const std::vector<faodel::A
 
    //Figure out how big to make the object
    uint32_t size = 0;
+   uint32_t total_stats = 0;
    for(auto src_fado: fados) {
       size+=src_fado.GetDataSize();
+      total_stats+=src_fado.NumberOfColumnStats();
    }
    //No data? return an empty object
    if(size==0) {
       return ArrowDataObject();
    }
    //Allocate the space
-   ArrowDataObject fado(size);
+   ArrowDataObject fado(size, total_stats);
 
    //Append each object
    for(auto src_fado: fados) {
@@ -509,19 +949,31 @@ arrow::Result<ArrowDataObject> ArrowDataObject::MakeMerged(
    auto options = arrow::ipc::IpcWriteOptions::Defaults();
    ARROW_ASSIGN_OR_RAISE(options.codec, arrow::util::Codec::Create(codec));
 
-   size_t total_size = 0;
-   for (const auto &table : tables) {
-      ARROW_ASSIGN_OR_RAISE(auto table_size_in_bytes,
-                            GetSerializedTableSize(table, options));
-      total_size += table_size_in_bytes;
-   }
+   ARROW_ASSIGN_OR_RAISE(auto encoded, encodeTables(tables, options));
 
    // Pack the tables into a single fado
-   ArrowDataObject fado(sizeof(fado_chunk_t) + total_size);
-   ARROW_RETURN_NOT_OK(fado.doAppendTables(tables, total_size, options));
+   ArrowDataObject fado(sizeof(fado_chunk_t) + encoded.size, countStatsColumns(tables[0]->schema()));
+   ARROW_RETURN_NOT_OK(fado.doAppendEncoded(encoded, options));
    return fado;
 }
 
+/// @brief Number of threads used to encode and decode tables when the caller does not pick one
+int ArrowDataObject::DefaultThreadCount() {
+   int num_threads = setting_thread_count;
+   if(num_threads<=0) num_threads = std::thread::hardware_concurrency();
+   return (num_threads>0) ? num_threads : 1;
+}
+
+/// @brief Set how many threads are used to encode and decode tables
+/// @param num_threads Threads to use (0 uses the number of hardware threads, 1 keeps all work on the caller's thread)
+/// @param min_rows_per_thread A table is only split up when each thread gets at least this many rows
+/// @note This is a process-wide setting. The pool of worker threads only grows, so lowering it later
+///       leaves idle workers behind
+void ArrowDataObject::SetThreadCount(int num_threads, int64_t min_rows_per_thread) {
+   setting_thread_count = std::max(num_threads, 0);
+   setting_min_rows_per_thread = min_rows_per_thread;
+}
+
 /// @brief Serialize an arrow table to a mock stream to calculate how big it is
 /// @param table The Apache Arrow table to serialize
 /// @param options Serialization options
@@ -556,6 +1008,7 @@ void fn_dumpArrowDataObject(const lunasa::DataObject &ldo, faodel::ReplyStream &
    rs.tableRow({"Total Rows", std::to_string(fado.NumberOfRows())});
    rs.tableRow({"Data Size", std::to_string(fado.GetDataSize())});
    rs.tableRow({"User Capacity", std::to_string(fado.GetCapacity())});
+   rs.tableRow({"Column Stats", std::to_string(fado.NumberOfColumnStats())});
    rs.tableEnd();
 
    int max_tables=fado.NumberOfTables();
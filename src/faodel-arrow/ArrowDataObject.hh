@@ -31,6 +31,17 @@ namespace faodel {
  * it is expected that most people will store tables with the same schema, FADO appends/extracts each
  * table individually.
  *
+ * When a chunk is written, FADO also records min/max/null/row statistics for each of its numeric
+ * columns in the LDO's meta section (a "zone map"). Queries can check these stats to skip chunks
+ * (or whole objects) that cannot match a predicate, without deserializing any table data. The meta
+ * section has room for a fixed number of entries. When it fills, later chunks have no stats and
+ * must always be scanned.
+ *
+ * Large tables are split into record batches that are encoded (and compressed) on a shared
+ * pool of threads. Each batch is written into its own pre-sized slot in the chunk, so a table
+ * still becomes one chunk. SetThreadCount() controls how many threads are used.
+ * ExtractAllTables() decodes chunks on multiple threads as well.
+ *
  * @note This class is intended to be a thin wrapper around an LDO. You can have multiple FADOs that
  *       read from the same LDO, but there are no locks to protect you if multiple FADOS try to modify
  *       the same FADO.
@@ -39,7 +50,7 @@ class ArrowDataObject {
 
 public:
   explicit ArrowDataObject() = default;
-  explicit ArrowDataObject(uint32_t max_arrow_capacity);
+  explicit ArrowDataObject(uint32_t max_arrow_capacity, uint32_t max_column_stats=default_max_column_stats);
   explicit ArrowDataObject(lunasa::DataObject import_ldo);
   explicit ArrowDataObject(const std::shared_ptr<arrow::Table> &table, arrow::Compression::type codec=arrow::Compression::UNCOMPRESSED);
 
@@ -64,14 +75,30 @@ public:
   int NumberOfTables() const;
   uint64_t NumberOfRows() const;
   arrow::Result<std::shared_ptr<arrow::Table>> ExtractTable(int chunk_id, arrow::ipc::IpcReadOptions options=arrow::ipc::IpcReadOptions::Defaults()) const;
+  arrow::Result<std::shared_ptr<arrow::Table>> ExtractAllTables(arrow::ipc::IpcReadOptions options=arrow::ipc::IpcReadOptions::Defaults(), int num_threads=0) const;
 
   uint32_t GetPackedRecordSize(int chunk_id) const;
 
+  /// @brief Statistics for one numeric column in one chunk (ie, a zone map entry)
+  struct ColumnStats {
+    bool     is_integer;  //!< True: range is in min_i/max_i. False: range is in min_d/max_d
+    bool     has_range;   //!< False when every value in the column is null
+    int64_t  min_i;
+    int64_t  max_i;
+    double   min_d;
+    double   max_d;
+    uint64_t null_count;
+    uint64_t row_count;
+  };
+  bool GetColumnStats(int chunk_id, const std::string &column_name, ColumnStats *stats) const;
+  uint32_t NumberOfColumnStats() const;
+  static const uint32_t default_max_column_stats = 32; //!< Zone map entries reserved by the capacity ctor
+
   lunasa::DataObject ExportDataObject() { return ldo; }
 
   //Stats about storage space from ldos
   uint32_t GetDataSize() const { return ldo.GetDataSize(); } //!< Amount of serialized data in this object
-  uint32_t GetCapacity() const { return ldo.GetUserCapacity() - sizeof(fado_meta_t); } //!< Total capacity for storing serialized tables
+  uint32_t GetCapacity() const { return ldo.GetUserCapacity() - ldo.GetMetaSize(); } //!< Total capacity for storing serialized tables
   uint32_t GetAvailableCapacity() const { return GetCapacity() - GetDataSize()  - sizeof(fado_chunk_t);} //!< Current space left for storing a serialized table
 
   double CurrentUtilizationRatio() const {
@@ -92,14 +119,48 @@ public:
 
   static void RegisterDataObjectType();
 
+  static int DefaultThreadCount();
+  static void SetThreadCount(int num_threads, int64_t min_rows_per_thread=default_min_rows_per_thread);
+  static const int64_t default_min_rows_per_thread = 8192; //!< Smaller tables are encoded on one thread
+
 private:
 
+  static const uint32_t max_stats_name_len = 32; //Columns with longer names (including the null) get no zone map entry
+
+  /// @brief Internal zone map entry that summarizes one numeric column of one chunk
+  struct fado_stats_t {
+    uint32_t chunk_id;
+    char     column_name[max_stats_name_len]; //Null-terminated
+    uint8_t  is_integer;
+    uint8_t  has_range;
+    uint8_t  pad[2];
+    uint64_t null_count;
+    uint64_t row_count;
+    union value_t { int64_t i; double d; } min, max;
+  };
+
    /// @brief Internal meta data that goes in the LDO meta section
+   /// @note Objects written before zone maps existed only have the first two fields (see legacy_meta_size).
+   ///       Anything else in this struct may only be touched when hasZoneMaps() is true
    struct fado_meta_t {
       uint32_t num_chunks;
       uint32_t object_status;
-      void wipe() { num_chunks=0; object_status=0;}
+      uint32_t version;        //meta_version for objects with zone maps
+      uint32_t num_stats;      //Zone map entries in use
+      uint32_t max_stats;      //Zone map entries that fit in the meta section
+      uint32_t reserved;
+      fado_stats_t stats[0];
+      void wipe() { num_chunks=0; object_status=0; num_stats=0;}
    };
+  static const uint32_t legacy_meta_size = 2*sizeof(uint32_t); //Meta size of objects without a version (num_chunks, object_status)
+  static const uint32_t meta_version = 2;
+
+  static uint32_t metaSize(uint32_t max_stats) { return sizeof(fado_meta_t) + max_stats*sizeof(fado_stats_t); }
+  bool hasZoneMaps() const;
+  static uint32_t countStatsColumns(const std::shared_ptr<arrow::Schema> &schema);
+  void initMeta(uint32_t max_stats);
+  void appendStats(uint32_t chunk_id, const std::vector<std::shared_ptr<arrow::Table>> &tables);
+  void copyStats(const ArrowDataObject &src_fado, uint32_t chunk_offset);
 
   /// @brief Internal header that goes in front of each serialized table chunk
   struct fado_chunk_t {
@@ -115,18 +176,29 @@ private:
 
   lunasa::DataObject ldo; //!< The underlying object that holds the serialized data
 
-  uint32_t roundupChunkSize(uint32_t size) const;
+  static uint32_t roundupChunkSize(uint32_t size);
   fado_chunk_t *locateChunk(int chunk_id) const;
+  arrow::Result<std::shared_ptr<arrow::Table>> extractChunk(const fado_chunk_t *chunk, arrow::ipc::IpcReadOptions options) const;
   void validChunkOrDie(fado_chunk_t *chunk, int i, const std::string &function) const;
 
   int doAppendChunkStrip(const fado_chunk_t *strip_start, uint32_t strip_bytes, uint32_t strip_chunks);
 
-   arrow::Status doAppendTable(const std::shared_ptr<arrow::Table> &table,
-                              int64_t table_size_in_bytes,
-                              const arrow::ipc::IpcWriteOptions &options);
   arrow::Status doAppendTables(const std::vector<std::shared_ptr<arrow::Table>> &tables,
                                int64_t tables_size_in_bytes,
                                const arrow::ipc::IpcWriteOptions &options);
+
+  /// @brief Tables that have been sized (and, for large tables, encoded) for one chunk
+  struct encoded_tables_t {
+    std::vector<std::shared_ptr<arrow::Table>> tables;  //Source tables, for row counts and stats
+    std::shared_ptr<arrow::Buffer>             schema;  //Encapsulated schema message. Null when encoded serially
+    std::vector<arrow::ipc::IpcPayload>        batches; //Encoded record batches
+    std::vector<int64_t>                       offsets; //Where each batch goes in the chunk's data
+    int64_t size;                                       //Serialized bytes in the chunk
+  };
+  static arrow::Result<encoded_tables_t> encodeTables(const std::vector<std::shared_ptr<arrow::Table>> &tables,
+                                                      const arrow::ipc::IpcWriteOptions &options);
+  arrow::Status doAppendEncoded(const encoded_tables_t &encoded,
+                                const arrow::ipc::IpcWriteOptions &options);
 };
 
 } // namespace faodel
@@ -9,6 +9,10 @@
 #include <vector>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
 #include <thread>
 #include <stdexcept>
 
@@ -19,6 +23,7 @@
 #endif
 
 #include "faodel-common/BootstrapImplementation.hh"
+#include "faodel-common/StringHelpers.hh"
 
 using namespace std;
 
@@ -33,10 +38,14 @@ Bootstrap::Bootstrap()
           status_on_shutdown(false),
           mpisyncstop_enabled(false),
           sleep_seconds_before_shutdown(0),
+          parallel_enabled(false),
+          parallel_threads(1),
+          stage_us{0,0},
           my_node_id(NODE_UNSPECIFIED),
           num_init_callers(0),
           state(State::UNINITIALIZED) {
   state_mutex = GenerateMutexByTypeID(MutexWrapperTypeID::PTHREADS_LOCK);
+  config_mutex = GenerateMutexByTypeID(MutexWrapperTypeID::PTHREADS_LOCK);
 }
 
 Bootstrap::~Bootstrap() {
@@ -46,6 +55,7 @@ Bootstrap::~Bootstrap() {
   if(state == State::INITIALIZED) { warn("Bootstrap was initialized but never started"); }
   if(state == State::STARTED) finish_(true);
   delete state_mutex;
+  delete config_mutex;
 }
 
 /**
@@ -91,6 +101,8 @@ void Bootstrap::RegisterComponent(string name,
   bs.start_function = start_function;
   bs.fini_function = fini_function;
   bs.optional_component_ptr = nullptr; //User didn't provide
+  bs.init_us = 0;
+  bs.start_us = 0;
 
   for(auto &tmp_bs : bstraps) {
     if(tmp_bs.name == name) {
@@ -144,6 +156,8 @@ void Bootstrap::RegisterComponent(BootstrapInterface *component, bool allow_over
   bs.start_function = [component]() { component->Start(); };
   bs.fini_function = [component]() { component->Finish(); };
   bs.optional_component_ptr = component;
+  bs.init_us = 0;
+  bs.start_us = 0;
 
   for(auto &tmp_bs : bstraps) {
     if(tmp_bs.name == name) {
@@ -185,8 +199,10 @@ bool Bootstrap::Init(const Configuration &config) {
 
 
   //We need to load any updates from references
+  config_mutex->Lock();
   configuration = config;
   configuration.AppendFromReferences();
+  config_mutex->Unlock();
 
   //Now we can update bootstrap's logging
   ConfigureLogging(configuration);
@@ -199,6 +215,14 @@ bool Bootstrap::Init(const Configuration &config) {
   configuration.GetUInt(&sleep_seconds_before_shutdown, "bootstrap.sleep_seconds_before_shutdown", "0");
   configuration.GetBool(&mpisyncstart_enabled,          "mpisyncstart.enable",           "false");
   configuration.GetBool(&mpisyncstop_enabled,           "mpisyncstop.enable",            "false");
+  configuration.GetBool(&parallel_enabled,              "bootstrap.parallel.enable",     "false");
+  configuration.GetUInt(&parallel_threads,              "bootstrap.parallel.threads",    "4");
+
+  string caller_thread_list;
+  configuration.GetString(&caller_thread_list, "bootstrap.parallel.caller_thread_components", "mpisyncstart;opbox");
+  auto caller_thread_names = Split(caller_thread_list, ';', true);
+  caller_thread_components = set<string>(caller_thread_names.begin(), caller_thread_names.end());
+  if(parallel_threads < 1) parallel_threads = 1;
 
   dbg("Init (" + std::to_string(bstraps.size()) + " bootstraps known)");
 
@@ -226,10 +250,7 @@ bool Bootstrap::Init(const Configuration &config) {
 
   //Execute each bootstrap
   try {
-    for(auto &bs : bstraps) {
-      dbg("Initializing service " + bs.name);
-      bs.init_function(&configuration);
-    }
+    runStage(Stage::INIT);
   } catch(const runtime_error &e) {
     state_mutex->Unlock();
     if(exit_on_errors) {
@@ -274,10 +295,7 @@ void Bootstrap::Start() {
   }
 
   dbg("Starting all services");
-  for(auto &bs : bstraps) {
-    dbg("Starting service " + bs.name);
-    bs.start_function();
-  }
+  runStage(Stage::START);
   dbg("Completed Starting services. Moved to 'started' state.");
   state = State::STARTED;
   state_mutex->Unlock();
@@ -293,6 +311,191 @@ void Bootstrap::Start(const Configuration &config) {
   if(we_initialized) Start();
 }
 
+/**
+ * @brief Get a copy of the configuration bootstrap handed to the components
+ * @return The configuration, including any changes components made during Init
+ */
+Configuration Bootstrap::GetConfiguration() const {
+  config_mutex->Lock();
+  Configuration c = configuration;
+  config_mutex->Unlock();
+  return c;
+}
+
+/**
+ * @brief Run the init or start function of every component
+ * @param[in] stage Which function to run
+ * @note Components run in startup order unless bootstrap.parallel.enable is set
+ */
+void Bootstrap::runStage(Stage stage) {
+
+  auto t_start = std::chrono::steady_clock::now();
+
+  if(parallel_enabled && (parallel_threads > 1) && (bstraps.size() > 1)) {
+    runStageParallel(stage);
+  } else {
+    for(auto &bs : bstraps) {
+      runComponent(stage, bs);
+    }
+  }
+
+  stage_us[static_cast<int>(stage)] = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - t_start).count();
+  F_LOG_DBG(string((stage==Stage::INIT) ? "Init" : "Start") + " of all services took "
+            + std::to_string(stage_us[static_cast<int>(stage)]) + " us");
+}
+
+/**
+ * @brief Run a stage on a pool of threads, launching each component as soon as its dependencies finish
+ * @param[in] stage Which function to run
+ * @throw exception The first exception a component threw (after all running components complete)
+ *
+ * The calling thread works alongside bootstrap.parallel.threads-1 helper threads. Components
+ * named in bootstrap.parallel.caller_thread_components (eg, ones that make MPI calls) are
+ * only run by the calling thread. When a component fails, no new components are launched.
+ */
+void Bootstrap::runStageParallel(Stage stage) {
+
+  //Convert the dependency table into a DAG using bstrap indices
+  map<string, set<string>> dep_lut;
+  stringstream emsg;
+  if(!expandDependencies(dep_lut, emsg)) {
+    throw std::runtime_error("Bootstrap: Dependency error " + emsg.str());
+  }
+
+  size_t num_components = bstraps.size();
+  map<string, size_t> index_of;
+  for(size_t i = 0; i < num_components; i++) {
+    index_of[bstraps[i].name] = i;
+  }
+  vector<int> num_waiting(num_components, 0);
+  vector<vector<size_t>> dependents(num_components);
+  for(size_t i = 0; i < num_components; i++) {
+    for(auto &dep : dep_lut[bstraps[i].name]) {
+      num_waiting[i]++;
+      dependents[index_of[dep]].push_back(i);
+    }
+  }
+
+  std::mutex m;
+  std::condition_variable cv;
+  deque<size_t> ready_any, ready_caller;
+  size_t num_finished = 0;
+  bool failed = false;
+  std::exception_ptr first_error;
+
+  auto enqueue = [&](size_t i) {
+    if(caller_thread_components.count(bstraps[i].name)) ready_caller.push_back(i);
+    else                                                ready_any.push_back(i);
+  };
+  for(size_t i = 0; i < num_components; i++) {
+    if(num_waiting[i] == 0) enqueue(i);
+  }
+
+  auto worker = [&](bool is_caller) {
+    std::unique_lock<std::mutex> lock(m);
+    while((num_finished < num_components) && (!failed)) {
+      deque<size_t> *q = nullptr;
+      if(is_caller && !ready_caller.empty()) q = &ready_caller;
+      else if(!ready_any.empty())            q = &ready_any;
+      if(q == nullptr) {
+        cv.wait(lock);
+        continue;
+      }
+      size_t i = q->front();
+      q->pop_front();
+      lock.unlock();
+
+      std::exception_ptr e;
+      try {
+        runComponent(stage, bstraps[i]);
+      } catch(...) {
+        e = std::current_exception();
+      }
+
+      lock.lock();
+      if(e) {
+        if(!failed) first_error = e;
+        failed = true;
+      } else {
+        num_finished++;
+        for(auto d : dependents[i]) {
+          if(--num_waiting[d] == 0) enqueue(d);
+        }
+      }
+      cv.notify_all();
+    }
+  };
+
+  size_t num_helpers = std::min<size_t>(parallel_threads, num_components) - 1;
+  vector<std::thread> helpers;
+  for(size_t t = 0; t < num_helpers; t++) {
+    helpers.emplace_back(worker, false);
+  }
+  worker(true);
+  for(auto &t : helpers) {
+    t.join();
+  }
+
+  if(first_error) std::rethrow_exception(first_error);
+}
+
+/**
+ * @brief Run one component's init or start function and record how long it took
+ * @param[in] stage Which function to run
+ * @param[in] bs The component
+ *
+ * @note When components init in parallel, each one works on its own copy of the
+ *       configuration. Any changes it makes are merged back into bootstrap's
+ *       configuration before its dependents are launched.
+ */
+void Bootstrap::runComponent(Stage stage, bstrap_t &bs) {
+
+  auto t_start = std::chrono::steady_clock::now();
+
+  if(stage == Stage::INIT) {
+    dbg("Initializing service " + bs.name);
+    if(!parallel_enabled) {
+      bs.init_function(&configuration);
+    } else {
+      config_mutex->Lock();
+      Configuration original = configuration;
+      config_mutex->Unlock();
+
+      Configuration modified = original;
+      bs.init_function(&modified);
+
+      vector<pair<string,string>> before, after;
+      original.GetAllSettings(&before);
+      modified.GetAllSettings(&after);
+      map<string,string> before_map(before.begin(), before.end());
+
+      config_mutex->Lock();
+      for(auto &k_v : after) {
+        auto ii = before_map.find(k_v.first);
+        if((ii == before_map.end()) || (ii->second != k_v.second)) {
+          configuration.Set(k_v.first, k_v.second);
+        }
+        if(ii != before_map.end()) before_map.erase(ii);
+      }
+      for(auto &k_v : before_map) {
+        configuration.Unset(k_v.first); //Component removed this setting
+      }
+      config_mutex->Unlock();
+    }
+    bs.init_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - t_start).count();
+    F_LOG_DBG("Initialized service " + bs.name + " in " + std::to_string(bs.init_us) + " us");
+
+  } else {
+    dbg("Starting service " + bs.name);
+    bs.start_function();
+    bs.start_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - t_start).count();
+    F_LOG_DBG("Started service " + bs.name + " in " + std::to_string(bs.start_us) + " us");
+  }
+}
+
 /**
  * @brief Get the number of times bootstrap Init was called
  * @return Current count
@@ -347,6 +550,16 @@ void Bootstrap::dumpInfo(ReplyStream &rs) const {
   rs.tableRow({"Status on Shutdown", std::to_string(status_on_shutdown)});
   rs.tableRow({"Halt on Shutdown", std::to_string(halt_on_shutdown) });
   rs.tableRow({"Sleep Seconds Before Shutdown", std::to_string(sleep_seconds_before_shutdown)});
+  rs.tableRow({"Parallel Init/Start", (parallel_enabled) ? "Enabled ("+std::to_string(parallel_threads)+" threads)" : "Disabled"});
+  rs.tableRow({"Init Time (us)",  std::to_string(stage_us[static_cast<int>(Stage::INIT)])});
+  rs.tableRow({"Start Time (us)", std::to_string(stage_us[static_cast<int>(Stage::START)])});
+  rs.tableEnd();
+
+  rs.tableBegin("Component Timing");
+  rs.tableTop({"Component", "Init (us)", "Start (us)"});
+  for(auto &bs : bstraps) {
+    rs.tableRow({bs.name, std::to_string(bs.init_us), std::to_string(bs.start_us)});
+  }
   rs.tableEnd();
 
   rs.mkList(faodel::bootstrap::GetStartupOrder(), "Bootstrap Startup Order" );
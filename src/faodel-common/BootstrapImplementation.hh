@@ -5,8 +5,10 @@
 #ifndef Faodel_COMMON_BOOTSTRAPINTERNAL_HH
 #define Faodel_COMMON_BOOTSTRAPINTERNAL_HH
 
+#include <cstdint>
 #include <string>
 #include <map>
+#include <set>
 #include <vector>
 
 #include "faodel-common/Bootstrap.hh"
@@ -28,6 +30,8 @@ typedef struct {
   fn_start start_function;
   fn_fini  fini_function;
   BootstrapInterface *optional_component_ptr;
+  uint64_t init_us;   //Time spent in init_function during the last Init
+  uint64_t start_us;  //Time spent in start_function during the last Start
 } bstrap_t;
 
 
@@ -63,7 +67,7 @@ public:
 
   std::string GetState() const;
   bool IsStarted() const { return state==State::STARTED; }
-  Configuration GetConfiguration() const { return configuration; }
+  Configuration GetConfiguration() const;
 
   int GetNumberOfUsers() const;
   bool HasComponent(const std::string &component_name) const;
@@ -75,12 +79,22 @@ private:
 
   void finish_(bool clear_list_of_bootstrap_users);
 
+  enum class Stage { INIT, START };
+  void runStage(Stage stage);
+  void runStageParallel(Stage stage);
+  void runComponent(Stage stage, bstrap_t &bs);
+
   Configuration configuration;
+  faodel::MutexWrapper *config_mutex; //!< Protects configuration while components init in parallel
   bool show_config_at_init;
   bool halt_on_shutdown;
   bool status_on_shutdown;
   bool mpisyncstop_enabled;
   uint64_t sleep_seconds_before_shutdown;
+  bool parallel_enabled;            //!< Init/Start independent components concurrently
+  uint64_t parallel_threads;        //!< Max number of components to run at once (including caller)
+  std::set<std::string> caller_thread_components; //!< Components that must run on the thread that called Init/Start
+  uint64_t stage_us[2];             //!< Wall time of the last Init and Start
   nodeid_t my_node_id;
   bool expandDependencies(std::map<std::string, std::set<std::string>> &dep_lut,
                           std::stringstream &emsg);
@@ -138,28 +138,21 @@ void LoggingInterface::ConfigureLoggingWarn(bool enable_warn) {
 }
 
 
-//TODO: Put some compile-time stuff to route these to SBL
-
 #if Faodel_LOGGINGINTERFACE_DISABLED==0
-void LoggingInterface::dbg(string s) const {
-  if(debug_enabled) {
-    LI_LOG_DEBUG(s);
-  }
+//Note: level checks happen inline in the header, before the message is built
+void LoggingInterface::logDebug(const string &s) const {
+  LI_LOG_DEBUG(s);
 }
-void LoggingInterface::info(string s) const {
-  if(info_enabled) {
-    LI_LOG_INFO(s);
-  }
+void LoggingInterface::logInfo(const string &s) const {
+  LI_LOG_INFO(s);
 }
-void LoggingInterface::warn(string s) {
-  if(warn_enabled) {
-    LI_LOG_WARN(s);
-  }
+void LoggingInterface::logWarn(const string &s) const {
+  LI_LOG_WARN(s);
 }
-void LoggingInterface::error(string s) const {
+void LoggingInterface::error(const string &s) const {
   LI_LOG_ERROR(s);
 }
-void LoggingInterface::fatal(string s) const {
+void LoggingInterface::fatal(const string &s) const {
   stringstream ss;
   ss<<"F "<<component_name <<": "<<s;
   LI_LOG_FATAL(s);
@@ -6,6 +6,7 @@
 #define FAODEL_COMMON_LOGGINGITERFACE_HH
 
 #include <string>
+#include <utility>
 
 #include <faodelConfig.h>
 
@@ -25,6 +26,12 @@ namespace faodel {
  * by different Faodel components. Inherit this from your class and specify
  * the name of this component. The owner of this class must then pass in
  * the runtime Configuration when bootstrap inits components.
+ *
+ * Messages that are expensive to build should be handed to dbg/info/warn
+ * as a lambda (eg, dbg([&]() { return "Get "+key.str(); })) or through
+ * the F_LOG_DBG/F_LOG_INFO/F_LOG_WARN macros. Both check the level before
+ * the message is formatted. Levels below Faodel_LOGGING_MIN_LEVEL are
+ * removed at compile time.
  */
 class LoggingInterface {
 
@@ -42,6 +49,11 @@ public:
   static int GetLoggingLevelFromConfiguration(const Configuration &config, const std::string &component_name);
 
   bool GetDebug() const { return debug_enabled; }
+
+  //Level checks that fold to false when a level is compiled out
+  bool IsDebugEnabled() const { return (Faodel_LOGGINGINTERFACE_DISABLED==0) && (Faodel_LOGGINGINTERFACE_MIN_LEVEL<=0) && debug_enabled; }
+  bool IsInfoEnabled() const  { return (Faodel_LOGGINGINTERFACE_DISABLED==0) && (Faodel_LOGGINGINTERFACE_MIN_LEVEL<=1) && info_enabled; }
+  bool IsWarnEnabled() const  { return (Faodel_LOGGINGINTERFACE_DISABLED==0) && (Faodel_LOGGINGINTERFACE_MIN_LEVEL<=2) && warn_enabled; }
   std::string GetFullName() const { if (subcomponent_name.empty()) return component_name; else return component_name+"."+subcomponent_name;}
   std::string GetComponentName() const { return component_name; }
   std::string GetSubcomponentName() const { return subcomponent_name; }
@@ -55,17 +67,29 @@ protected:
 
 
 #if Faodel_LOGGINGINTERFACE_DISABLED==1
-  void dbg(std::string s) const {}
-  void info(std::string s) const {}
-  void warn(std::string s) {}
-  void error(std::string s) const {}
-  void fatal(std::string s) const { exit(-1); }
+  void dbg(const std::string &s) const {}
+  void info(const std::string &s) const {}
+  void warn(const std::string &s) {}
+  void error(const std::string &s) const {}
+  void fatal(const std::string &s) const { exit(-1); }
+
+  template<typename F, typename = decltype(std::declval<F>()())> void dbg(F &&make_message) const {}
+  template<typename F, typename = decltype(std::declval<F>()())> void info(F &&make_message) const {}
+  template<typename F, typename = decltype(std::declval<F>()())> void warn(F &&make_message) {}
 #else
-  void dbg(std::string s) const;
-  void info(std::string s) const;
-  void warn(std::string s);
-  void error(std::string s) const;
-  void fatal(std::string s) const;
+  void dbg(const std::string &s) const  { if(IsDebugEnabled()) logDebug(s); }
+  void info(const std::string &s) const { if(IsInfoEnabled())  logInfo(s); }
+  void warn(const std::string &s)       { if(IsWarnEnabled())  logWarn(s); }
+  void error(const std::string &s) const;
+  void fatal(const std::string &s) const;
+
+  //Lazy versions: make_message only runs when the level is enabled
+  template<typename F, typename = decltype(std::declval<F>()())>
+  void dbg(F &&make_message) const { if(IsDebugEnabled()) logDebug(make_message()); }
+  template<typename F, typename = decltype(std::declval<F>()())>
+  void info(F &&make_message) const { if(IsInfoEnabled()) logInfo(make_message()); }
+  template<typename F, typename = decltype(std::declval<F>()())>
+  void warn(F &&make_message) { if(IsWarnEnabled()) logWarn(make_message()); }
 #endif
 
 private:
@@ -75,6 +99,12 @@ private:
   bool info_enabled;
   bool warn_enabled;
 
+#if Faodel_LOGGINGINTERFACE_DISABLED==0
+  void logDebug(const std::string &s) const;
+  void logInfo(const std::string &s) const;
+  void logWarn(const std::string &s) const;
+#endif
+
 #if Faodel_LOGGINGINTERFACE_DISABLED==0 && Faodel_LOGGINGINTERFACE_USE_SBL==1
   static sbl::logger *sbl_logger;
 #endif
@@ -86,5 +116,12 @@ private:
 } // namespace faodel
 
 
+// Level-checked logging for use inside classes that provide IsDebugEnabled()
+// and dbg() (eg, anything derived from LoggingInterface). The message
+// expression is not evaluated unless the level is enabled.
+#define F_LOG_DBG(msg)  do { if(this->IsDebugEnabled()) this->dbg(msg);  } while(0)
+#define F_LOG_INFO(msg) do { if(this->IsInfoEnabled())  this->info(msg); } while(0)
+#define F_LOG_WARN(msg) do { if(this->IsWarnEnabled())  this->warn(msg); } while(0)
+
 
 #endif // FAODEL_COMMON_LOGGINGITERFACE_HH
@@ -9,6 +9,16 @@
 #include "faodel-common/MutexWrapper.hh"
 #include "faodel-common/Debug.hh"
 
+#ifdef Faodel_THREADING_MODEL_PTHREADS
+#include <atomic>
+#include <sched.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
 using namespace std;
 
 namespace faodel {
@@ -65,9 +75,6 @@ private:
 // MutexWrapperPT: PThreads wrapper
 #ifdef Faodel_THREADING_MODEL_PTHREADS
 #include <pthread.h>
-#ifdef __APPLE__
-#include <sched.h>
-#endif
 
 class MutexWrapperPT : public MutexWrapper {
 
@@ -122,6 +129,231 @@ private:
 
 };
 
+
+//=============================================================================
+// Lightweight locks for tiny critical sections. These are built on atomics
+// and only fall back to the OS (futex or sched_yield) when a thread has to
+// wait longer than a short spin.
+namespace {
+
+const int LOCK_SPIN_LIMIT = 100;   //Spins before adaptive lock parks / others yield
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+inline void futexWait(std::atomic<int> *addr, int expected) {
+#ifdef __linux__
+  syscall(SYS_futex, reinterpret_cast<int *>(addr), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+  if(addr->load(std::memory_order_relaxed) == expected) sched_yield();
+#endif
+}
+
+inline void futexWakeOne(std::atomic<int> *addr) {
+#ifdef __linux__
+  syscall(SYS_futex, reinterpret_cast<int *>(addr), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+}
+
+//Threads are spread over the reader stripes the first time they take a
+//reader-biased lock. The stripe is seeded from the cpu the thread was on, but
+//stays fixed afterwards so an unlock always hits the counter its lock did.
+std::atomic<unsigned int> next_reader_stripe(0);
+thread_local int my_reader_stripe = -1;
+
+inline int getReaderStripe(int num_stripes) {
+  if(my_reader_stripe < 0) {
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    my_reader_stripe = (cpu >= 0) ? cpu : static_cast<int>(next_reader_stripe++);
+#else
+    my_reader_stripe = static_cast<int>(next_reader_stripe++);
+#endif
+  }
+  return my_reader_stripe % num_stripes;
+}
+
+} // namespace
+
+
+/**
+ * @brief Adaptive lock that spins for a short time before parking on a futex
+ *
+ * Most faodel critical sections (eg, a LocalKVRow lookup) are shorter than
+ * the cost of putting a thread to sleep. This lock spins briefly in user space
+ * and only makes a futex call when the lock stays busy. The state is 0 for
+ * unlocked, 1 for locked, and 2 for locked with (possible) sleepers.
+ */
+class MutexWrapperAdaptive : public MutexWrapper {
+
+public:
+  MutexWrapperAdaptive() : state(0) {}
+  ~MutexWrapperAdaptive() override = default;
+
+  void Lock() override {
+    int c = 0;
+    for(int i=0; i<LOCK_SPIN_LIMIT; i++) {
+      c = 0;
+      if(state.compare_exchange_weak(c, 1, std::memory_order_acquire, std::memory_order_relaxed)) return;
+      cpuRelax();
+    }
+    //Still busy: mark as contended and sleep until the holder wakes us
+    if(c != 2) c = state.exchange(2, std::memory_order_acquire);
+    while(c != 0) {
+      futexWait(&state, 2);
+      c = state.exchange(2, std::memory_order_acquire);
+    }
+  }
+  void ReaderLock() override { Lock(); }
+  void WriterLock() override { Lock(); }
+
+  void Unlock() override {
+    if(state.fetch_sub(1, std::memory_order_release) != 1) {
+      state.store(0, std::memory_order_release);
+      futexWakeOne(&state);
+    }
+  }
+  void yield() override { sched_yield(); }
+  std::string GetType() const override { return "pthreads-adaptive"; }
+  MutexWrapperTypeID GetTypeID() const override { return MutexWrapperTypeID::ADAPTIVE_LOCK; }
+  MutexWrapperAdaptive(const MutexWrapperAdaptive&) : state(0) {}
+  MutexWrapperAdaptive& operator= (const MutexWrapperAdaptive& ) { return *this; }
+
+private:
+  std::atomic<int> state;
+};
+
+
+/**
+ * @brief FIFO ticket lock
+ *
+ * Threads are granted the lock in the order they asked for it, which keeps
+ * a busy thread from starving others under heavy contention. Waiters spin
+ * briefly and then yield the cpu, so oversubscribed nodes still make progress.
+ */
+class MutexWrapperTicket : public MutexWrapper {
+
+public:
+  MutexWrapperTicket() : next_ticket(0), now_serving(0) {}
+  ~MutexWrapperTicket() override = default;
+
+  void Lock() override {
+    unsigned int my_ticket = next_ticket.fetch_add(1, std::memory_order_relaxed);
+    int spins = 0;
+    while(now_serving.load(std::memory_order_acquire) != my_ticket) {
+      if(++spins < LOCK_SPIN_LIMIT) cpuRelax();
+      else                          sched_yield();
+    }
+  }
+  void ReaderLock() override { Lock(); }
+  void WriterLock() override { Lock(); }
+
+  //Only the holder updates now_serving, so a relaxed read is safe
+  void Unlock() override {
+    now_serving.store(now_serving.load(std::memory_order_relaxed)+1, std::memory_order_release);
+  }
+  void yield() override { sched_yield(); }
+  std::string GetType() const override { return "pthreads-ticket"; }
+  MutexWrapperTypeID GetTypeID() const override { return MutexWrapperTypeID::TICKET_LOCK; }
+  MutexWrapperTicket(const MutexWrapperTicket&) : next_ticket(0), now_serving(0) {}
+  MutexWrapperTicket& operator= (const MutexWrapperTicket& ) { return *this; }
+
+private:
+  std::atomic<unsigned int> next_ticket;
+  char pad[64-sizeof(std::atomic<unsigned int>)]; //Keep arrivals off the holder's line
+  std::atomic<unsigned int> now_serving;
+};
+
+
+/**
+ * @brief Reader-biased readers/writer lock with striped reader counts
+ *
+ * Readers only touch the counter for their own stripe, so concurrent readers
+ * on different cores do not bounce a shared cache line. Writers first claim
+ * the writer flag (which stops new readers) and then wait for every stripe
+ * to drain. This makes reads very cheap and writes expensive, which matches
+ * read-mostly tables such as the LocalKV row map or the DirMan cache.
+ *
+ * @note Each instance carries NUM_STRIPES cache lines of counters (~1KB), so
+ *       avoid it for per-item locks such as LocalKV rows
+ */
+class MutexWrapperRBRW : public MutexWrapper {
+
+public:
+  MutexWrapperRBRW() : writer(WRITER_NONE) {
+    for(auto &s : stripes) s.readers.store(0);
+  }
+  ~MutexWrapperRBRW() override = default;
+
+  void Lock() override { WriterLock(); } //Assume worst-case
+
+  void ReaderLock() override {
+    auto &readers = stripes[getReaderStripe(NUM_STRIPES)].readers;
+    while(true) {
+      readers.fetch_add(1);
+      if(writer.load() == WRITER_NONE) return;
+      //A writer is active or pending. Back out and let it through
+      readers.fetch_sub(1);
+      int spins = 0;
+      while(writer.load(std::memory_order_relaxed) != WRITER_NONE) {
+        if(++spins < LOCK_SPIN_LIMIT) cpuRelax();
+        else                          sched_yield();
+      }
+    }
+  }
+
+  void WriterLock() override {
+    int spins = 0;
+    int expected = WRITER_NONE;
+    while(!writer.compare_exchange_weak(expected, WRITER_PENDING)) {
+      expected = WRITER_NONE;
+      if(++spins < LOCK_SPIN_LIMIT) cpuRelax();
+      else                          sched_yield();
+    }
+    for(auto &s : stripes) {
+      spins = 0;
+      while(s.readers.load() != 0) {
+        if(++spins < LOCK_SPIN_LIMIT) cpuRelax();
+        else                          sched_yield();
+      }
+    }
+    writer.store(WRITER_ACTIVE);
+  }
+
+  //Readers can only hold the lock while no writer is active, so the writer
+  //state tells us which kind of unlock this is
+  void Unlock() override {
+    if(writer.load() == WRITER_ACTIVE) {
+      writer.store(WRITER_NONE);
+    } else {
+      stripes[getReaderStripe(NUM_STRIPES)].readers.fetch_sub(1, std::memory_order_release);
+    }
+  }
+  void yield() override { sched_yield(); }
+  std::string GetType() const override { return "pthreads-rbrwlock"; }
+  MutexWrapperTypeID GetTypeID() const override { return MutexWrapperTypeID::RB_RWLOCK; }
+  MutexWrapperRBRW(const MutexWrapperRBRW&) : MutexWrapperRBRW() {}
+  MutexWrapperRBRW& operator= (const MutexWrapperRBRW& ) { return *this; }
+
+private:
+  static const int NUM_STRIPES = 16;
+  static const int WRITER_NONE = 0;
+  static const int WRITER_PENDING = 1;
+  static const int WRITER_ACTIVE = 2;
+
+  struct stripe_t {
+    std::atomic<int> readers;
+    char pad[64-sizeof(std::atomic<int>)];
+  };
+  stripe_t stripes[NUM_STRIPES];
+  std::atomic<int> writer;
+};
+
 #endif
 
 
@@ -134,6 +366,9 @@ int GetMutexInfoByID(MutexWrapperTypeID id, string *threading_model, string *mut
   case MutexWrapperTypeID::OMP_LOCK:        tm="openmp";   mt="lock"; break;
   case MutexWrapperTypeID::PTHREADS_LOCK:   tm="pthreads"; mt="lock"; break;
   case MutexWrapperTypeID::PTHREADS_RWLOCK: tm="pthreads"; mt="rwlock"; break;
+  case MutexWrapperTypeID::ADAPTIVE_LOCK:   tm="pthreads"; mt="adaptive"; break;
+  case MutexWrapperTypeID::TICKET_LOCK:     tm="pthreads"; mt="ticket"; break;
+  case MutexWrapperTypeID::RB_RWLOCK:       tm="pthreads"; mt="rbrwlock"; break;
   case MutexWrapperTypeID::UNSUPPORTED:     tm=mt="unsupported"; break;
   case MutexWrapperTypeID::ERROR:           tm=mt="error"; break;
   }
@@ -161,6 +396,11 @@ MutexWrapperTypeID GetMutexTypeID(std::string threading_model, std::string mutex
     //rwlock's are the thing to use in pthreads.
     if(mutex_type=="rwlock") return MutexWrapperTypeID::PTHREADS_RWLOCK;
 
+    //Lightweight locks for short critical sections
+    if(mutex_type=="adaptive") return MutexWrapperTypeID::ADAPTIVE_LOCK;
+    if(mutex_type=="ticket")   return MutexWrapperTypeID::TICKET_LOCK;
+    if(mutex_type=="rbrwlock") return MutexWrapperTypeID::RB_RWLOCK;
+
     //Default: fall back to standard Mutex
     return MutexWrapperTypeID::PTHREADS_LOCK;
   }
@@ -186,6 +426,9 @@ MutexWrapper * GenerateMutexByTypeID(MutexWrapperTypeID mutex_type_id) {
   case MutexWrapperTypeID::DEFAULT: //Default to plain lock
   case MutexWrapperTypeID::PTHREADS_LOCK: return static_cast<MutexWrapper *>(new MutexWrapperPT());
   case MutexWrapperTypeID::PTHREADS_RWLOCK: return static_cast<MutexWrapper *>(new MutexWrapperRWPT());
+  case MutexWrapperTypeID::ADAPTIVE_LOCK:   return static_cast<MutexWrapper *>(new MutexWrapperAdaptive());
+  case MutexWrapperTypeID::TICKET_LOCK:     return static_cast<MutexWrapper *>(new MutexWrapperTicket());
+  case MutexWrapperTypeID::RB_RWLOCK:       return static_cast<MutexWrapper *>(new MutexWrapperRBRW());
 #endif
 
  default: ;
@@ -206,7 +449,7 @@ string MutexWrapperCompileTimeInfo() {
   stringstream ss;
   ss << "faodel::MutexWrapper was compiled with support for : ";
   #ifdef Faodel_THREADING_MODEL_PTHREADS
-    ss << "pthreads ";
+    ss << "pthreads (lock rwlock adaptive ticket rbrwlock) ";
   #endif
   #ifdef Faodel_THREADING_MODEL_OPENMP
     ss << "openmp ";
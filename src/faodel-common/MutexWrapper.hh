@@ -9,6 +9,7 @@
 
 // MutexWrapper : a simple wrapper for handling locks
 //  Current types: "none", "pthread", or "openmp"
+//  Pthreads builds also provide "adaptive", "ticket", and "rbrwlock" locks
 
 namespace faodel {
 
@@ -19,7 +20,10 @@ enum class MutexWrapperTypeID: int {
     PTHREADS_LOCK=4,   //!< Pthreads plain lock
     PTHREADS_RWLOCK=5, //1< Pthreads readers/writer lock
     UNSUPPORTED=6,     //!< Asked for lock we weren't compiled for
-    ERROR=7            //!< parse problem
+    ERROR=7,           //!< parse problem
+    ADAPTIVE_LOCK=8,   //!< Spin briefly, then park on a futex
+    TICKET_LOCK=9,     //!< FIFO ticket lock (spin, then yield)
+    RB_RWLOCK=10       //!< Reader-biased readers/writer lock with striped reader counts
 };
 
 
@@ -103,17 +103,17 @@ void BackBurner::AddWork(fn_backburner_work work) {
 }
 
 void BackBurner::AddWork(vector<fn_backburner_work> work) {
-  dbg("Add Work["+std::to_string(work.size())+"]");
+  F_LOG_DBG("Add Work["+std::to_string(work.size())+"]");
   workers->at(0).AddWork(work);
 }
 
 void BackBurner::AddWork(uint32_t tag, fn_backburner_work work) {
-  dbg("Add work with tag "+std::to_string(tag));
+  F_LOG_DBG("Add work with tag "+std::to_string(tag));
   workers->at(tag%worker_count).AddWork(std::move(work));
 }
 
 void BackBurner::AddWork(uint32_t tag, vector<fn_backburner_work> work) {
-  dbg("Add work["+std::to_string(work.size())+"] with tag "+std::to_string(tag));
+  F_LOG_DBG("Add work["+std::to_string(work.size())+"] with tag "+std::to_string(tag));
   workers->at(tag%worker_count).AddWork(work);
 }
 
@@ -159,7 +159,7 @@ void BackBurner::Worker::SetConfiguration(const Configuration &config, int id) {
     //This version polls, but injects sleep time so we don't eat as much time
     uint64_t time_us;
     config.GetTimeUS(&time_us, "backburner.sleep_polling_time","100us");
-    dbg("Notification method: sleep_polling with a delay of "+std::to_string(time_us)+" us");
+    F_LOG_DBG("Notification method: sleep_polling with a delay of "+std::to_string(time_us)+" us");
     notifyNewWork = []() {};
     blockUntilWork = [=]() {
         std::this_thread::sleep_for(std::chrono::microseconds(time_us));
@@ -208,7 +208,7 @@ void BackBurner::Worker::AddWork(fn_backburner_work work) {
 }
 
 void BackBurner::Worker::AddWork(vector<fn_backburner_work> work) {
-  dbg("Add Work ["+std::to_string(work.size())+"]");
+  F_LOG_DBG("Add Work ["+std::to_string(work.size())+"]");
   mtx.lock();
   for(auto &w : work)
     tasks_producer->push(w);
@@ -218,7 +218,7 @@ void BackBurner::Worker::AddWork(vector<fn_backburner_work> work) {
 }
 
 void BackBurner::Worker::RegisterPollingFunction(string name, uint32_t group_id, fn_backburner_work polling_function) {
-  dbg("Register polling function "+name);
+  F_LOG_DBG("Register polling function "+name);
   auto it = registered_poll_functions.find(name);
   if(it != registered_poll_functions.end()) {
     cerr <<"Attempted to register function "<<name<<" more than once in BackBurner\n";
@@ -228,7 +228,7 @@ void BackBurner::Worker::RegisterPollingFunction(string name, uint32_t group_id,
 }
 
 void BackBurner::Worker::DisablePollingFunction(string name) {
-  dbg("Disabling polling function "+name);
+  F_LOG_DBG("Disabling polling function "+name);
   auto it = registered_poll_functions.find(name);
   if(it != registered_poll_functions.end()) {
     registered_poll_functions[name] = nullptr;
@@ -259,7 +259,7 @@ void BackBurner::Worker::server() {
         tasks_producer=tmp;
         mtx.unlock();
 
-        dbg("Found "+std::to_string(tasks_consumer->size())+" tasks to consume");
+        F_LOG_DBG("Found "+std::to_string(tasks_consumer->size())+" tasks to consume");
         num_bundles++;
 
         int bundle_spot=0;
@@ -271,7 +271,7 @@ void BackBurner::Worker::server() {
           tasks_consumer->pop();
           work();
           bundle_spot++;
-          dbg("Finished task "+std::to_string(num)+" ["+std::to_string(bundle_spot)+"/"+std::to_string(num_in_bundle)+"]");
+          F_LOG_DBG("Finished task "+std::to_string(num)+" ["+std::to_string(bundle_spot)+"/"+std::to_string(num_in_bundle)+"]");
           num++;
         }
       } else {
@@ -39,6 +39,7 @@ void MPISyncStart::InitAndModifyConfiguration(Configuration *config) {
 
   needs_patch = false;
   string dirman_root_mpi_string;
+  string dirman_shards_mpi_string;
 
   std::vector<string> dirman_resources_mpi;
   int64_t dirman_root_mpi;
@@ -49,6 +50,9 @@ void MPISyncStart::InitAndModifyConfiguration(Configuration *config) {
   config->GetStringVector(&dirman_resources_mpi, "dirman.resources_mpi");
   needs_patch |= (!dirman_resources_mpi.empty());
 
+  config->GetString(&dirman_shards_mpi_string, "dirman.sharded.nodes_mpi", "");
+  needs_patch |= (!dirman_shards_mpi_string.empty());
+
   dbg("Does this require an MPI Sync Start? " + ((needs_patch) ? string("yes") : string("no")));
 
   if (!needs_patch) return;
@@ -87,7 +91,7 @@ void MPISyncStart::InitAndModifyConfiguration(Configuration *config) {
     nodeid_t my_id = whookie::Server::GetNodeID();
 
     //See if we just need a barrier
-    if((dirman_root_mpi==-1) && (dirman_resources_mpi.empty())) {
+    if((dirman_root_mpi==-1) && (dirman_resources_mpi.empty()) && (dirman_shards_mpi_string.empty())) {
       dbg("mpi_sync_start requested, but no specific needs specified. Performing Barrier");
       MPI_Barrier(MPI_COMM_WORLD);
       dbg("Barrier completed.");
@@ -104,10 +108,10 @@ void MPISyncStart::InitAndModifyConfiguration(Configuration *config) {
       dbg("dirman root located.  Rank "+std::to_string(dirman_root_mpi)+" is " + root_node.GetHex());
     }
 
-    //One or more dirman resources were specified with mpi ranks. Update them in the config.
-    if(!dirman_resources_mpi.empty()) {
+    //One or more dirman resources or sharded servers were specified with mpi ranks. Update them in the config.
+    if((!dirman_resources_mpi.empty()) || (!dirman_shards_mpi_string.empty())) {
 
-      if((mpi_rank == 0) && (dirman_root_mpi<0)) {
+      if((mpi_rank == 0) && (dirman_root_mpi<0) && (dirman_shards_mpi_string.empty())) {
         F_WARN("Faodel configuration contained "+std::to_string(dirman_resources_mpi.size())+
                " dirman.resources_mpi[], but dirman.root_node_mpi was not set. Ignoring.");
       }
@@ -119,8 +123,20 @@ void MPISyncStart::InitAndModifyConfiguration(Configuration *config) {
                     nodes,  sizeof(faodel::nodeid_t), MPI_CHAR,
                     MPI_COMM_WORLD);
 
-      if(mpi_rank == dirman_root_mpi) {
-        //Only load up resources on the root node
+      //Convert the sharded server ranks to a list of nodeids
+      if(!dirman_shards_mpi_string.empty()) {
+        auto ids = ExtractIDs(dirman_shards_mpi_string, mpi_size);
+        if(ids.empty()) throw std::runtime_error("MPISyncStart Parse error for dirman.sharded.nodes_mpi " + dirman_shards_mpi_string);
+        vector<string> shard_nodes;
+        for(auto id : ids)
+          shard_nodes.push_back(nodes[id].GetHex());
+        config->Append("dirman.sharded.nodes", Join(shard_nodes, ','));
+        dbg("Sharded dirman servers: "+Join(shard_nodes, ','));
+      }
+
+      //Sharded servers are all peers, so every rank gets the resources
+      if((mpi_rank == dirman_root_mpi) || (!dirman_shards_mpi_string.empty())) {
+        //Only load up resources on the root node (or everywhere for sharded)
         for (const auto &line : dirman_resources_mpi) {
           //dbg("Working on line: "+line);
 
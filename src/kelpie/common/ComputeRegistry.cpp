@@ -54,7 +54,7 @@ void ComputeRegistry::RegisterComputeFunction(const std::string &compute_functio
 
   F_ASSERT(!started, "Attempted to register compute function after bootstrap Start().");
 
-  dbg("Registering compute function "+compute_function_name);
+  F_LOG_DBG("Registering compute function "+compute_function_name);
 
   auto name_fn = compute_fns.find(compute_function_name);
   F_ASSERT(name_fn == compute_fns.end(), "Attempting to overwrite existing compute function for "+compute_function_name);
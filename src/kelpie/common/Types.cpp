@@ -24,6 +24,14 @@ string availability_to_string(const Availability &a){
   }
 }
 
+string atomicop_to_string(const AtomicOp &op){
+  switch(op) {
+  case AtomicOp::Add:            return "Add";
+  case AtomicOp::CompareAndSwap: return "CompareAndSwap";
+  default: return "Unknown?";
+  }
+}
+
 
 void object_info_t::Wipe() {
   row_user_bytes=row_num_columns=col_user_bytes=col_dependencies=0;
@@ -97,6 +97,17 @@ struct object_info_t {
 };
 
 
+/**
+ * @brief Read-modify-write operations that run on the node that owns a key
+ * @note Atomic ops work on objects that hold a single int64_t. A missing object reads as zero
+ */
+enum class AtomicOp : uint8_t {
+  Add            = 0,                //!< Add operand to the value
+  CompareAndSwap = 1                 //!< Replace the value with operand if it equals compare
+};
+std::string atomicop_to_string(const AtomicOp &op);
+
+
 typedef uint8_t pool_behavior_t;
 /**
  * @brief Provides instructions on what actions to take in different stages of communication pipeline
@@ -141,6 +152,7 @@ using fn_publish_callback_t = std::function<void (kelpie::rc_t result, object_in
 using fn_want_callback_t    = std::function<void (bool success, Key key, lunasa::DataObject user_ldo, const object_info_t &info)>;
 using fn_drop_callback_t    = std::function<void (bool success, Key key)>;
 using fn_compute_callback_t = std::function<void (kelpie::rc_t, Key key, lunasa::DataObject user_ldo)>;
+using fn_atomic_callback_t  = std::function<void (kelpie::rc_t result, Key key, int64_t old_value)>;
 
 using fn_opget_result_t     = std::function<void (bool success, Key &key, lunasa::DataObject &ldo)>;       //!< Lambda for passing back an op get
 
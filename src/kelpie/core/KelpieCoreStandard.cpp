@@ -15,10 +15,12 @@
 #include "kelpie/pools/RFTPool/RFTPool.hh"
 #endif
 
+#include "kelpie/ops/direct/OpKelpieAtomic.hh"
 #include "kelpie/ops/direct/OpKelpieCompute.hh"
 #include "kelpie/ops/direct/OpKelpieDrop.hh"
 #include "kelpie/ops/direct/OpKelpieGetBounded.hh"
 #include "kelpie/ops/direct/OpKelpieGetUnbounded.hh"
+#include "kelpie/ops/direct/OpKelpieLease.hh"
 #include "kelpie/ops/direct/OpKelpieList.hh"
 #include "kelpie/ops/direct/OpKelpieMeta.hh"
 #include "kelpie/ops/direct/OpKelpiePublish.hh"
@@ -59,18 +61,22 @@ void KelpieCoreStandard::init(const faodel::Configuration &config) {
   #endif
 
   //Register OPs with opbox, program in their lkv
+  opbox::RegisterOp<OpKelpieAtomic>();
   opbox::RegisterOp<OpKelpieCompute>();
   opbox::RegisterOp<OpKelpieDrop>();
   opbox::RegisterOp<OpKelpieGetBounded>();
   opbox::RegisterOp<OpKelpieGetUnbounded>();
+  opbox::RegisterOp<OpKelpieLease>();
   opbox::RegisterOp<OpKelpieList>();
   opbox::RegisterOp<OpKelpieMeta>();
   opbox::RegisterOp<OpKelpiePublish>();
 
+  OpKelpieAtomic::configure(      faodel::internal_use_only, &config, &lkv);
   OpKelpieCompute::configure(     faodel::internal_use_only, &config, &lkv);
   OpKelpieDrop::configure(        faodel::internal_use_only, &config, &lkv);
   OpKelpieGetBounded::configure(  faodel::internal_use_only, &config, &lkv);
   OpKelpieGetUnbounded::configure(faodel::internal_use_only, &config, &lkv);
+  OpKelpieLease::configure(       faodel::internal_use_only, &config, &lkv);
   OpKelpieList::configure(        faodel::internal_use_only, &config, &lkv);
   OpKelpieMeta::configure(        faodel::internal_use_only, &config, &lkv);
   OpKelpiePublish::configure(     faodel::internal_use_only, &config, &lkv);
@@ -84,14 +90,17 @@ void KelpieCoreStandard::init(const faodel::Configuration &config) {
 }
 
 void KelpieCoreStandard::start(){
-
+  //Ioms opened in the background during init overlap with network startup. Make sure they're ready.
+  iom_registry.start();
 }
 
 void KelpieCoreStandard::finish(){
   whookie::Server::deregisterHook("/kelpie");
+  OpKelpieAtomic::configure(faodel::internal_use_only, nullptr, nullptr);
   OpKelpieDrop::configure(faodel::internal_use_only, nullptr, nullptr);
   OpKelpieGetBounded::configure(faodel::internal_use_only, nullptr, nullptr);
   OpKelpieGetUnbounded::configure(faodel::internal_use_only, nullptr, nullptr);
+  OpKelpieLease::configure(faodel::internal_use_only, nullptr, nullptr);
   OpKelpieList::configure(faodel::internal_use_only, nullptr, nullptr);
   OpKelpieMeta::configure(faodel::internal_use_only, nullptr, nullptr );
   OpKelpiePublish::configure(faodel::internal_use_only, nullptr, nullptr);
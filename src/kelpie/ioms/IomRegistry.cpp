@@ -2,6 +2,7 @@
 // (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
 // Government retains certain rights in this software.
 
+#include <set>
 #include <sstream>
 #include <stdexcept>
 
@@ -60,35 +61,48 @@ void IomRegistry::RegisterIom(string type, string name, const map<string,string>
     throw std::runtime_error("Attempted to register Iom '"+name+"', which already exists");
   }
 
+  iom = constructIom(type, name, settings);
+
+  //Store it in the list. Check finalized under the lock so nothing lands in the
+  //pre-init list after start() makes it lock-free
+  iom_hash_t hid = faodel::hash32(name);
+  mutex->Lock();
+  auto &ioms = (finalized) ? ioms_by_hash_post : ioms_by_hash_pre;
+  //Recheck in case it came in since we checked at the top of this function
+  if(ioms.find(hid)!=ioms.end()){
+    mutex->Unlock();
+    throw std::runtime_error("IOM Registration race detected for '"+name+"'");
+  }
+  ioms[hid] = iom;
+  mutex->Unlock();
+
+}
+
+/**
+ * @brief Use a registered driver to create a new IOM instance (without storing it)
+ * @param type The IOM driver type to use
+ * @param name The name of the IOM instance
+ * @param settings Settings to pass into the IOM
+ * @retval iom The new instance
+ * @throw runtime_error if the driver is not known or fails to create the iom
+ */
+IomBase * IomRegistry::constructIom(string type, const string &name, const map<string,string> &settings) {
+
+  faodel::ToLowercaseInPlace(type);
+
   //Make sure ctor exists
   auto name_fn = iom_ctors.find(type);
   if(name_fn == iom_ctors.end()) {
     throw std::runtime_error("Driver '"+type+"' has not been registered for Iom '"+name+"'");
   }
 
-  //Construct the iom 
-  iom = name_fn->second(name, settings);
+  //Construct the iom
+  IomBase *iom = name_fn->second(name, settings);
   if(iom==nullptr){
-    throw std::runtime_error("Driver creation problem for Iom '"+name+"' with driver '"+type+"'"); 
+    throw std::runtime_error("Driver creation problem for Iom '"+name+"' with driver '"+type+"'");
   }
   iom->SetLoggingLevel(default_logging_level);
-
-  //Store it in the list
-  iom_hash_t hid = faodel::hash32(name);
-  if(!finalized) {
-    ioms_by_hash_pre[hid] = iom;
-  } else {
-    mutex->Lock();
-    //Recheck in case it came in since we checked at the top of this function
-    auto rhash_rptr = ioms_by_hash_post.find(hid);
-    if(rhash_rptr!=ioms_by_hash_post.end()){
-      mutex->Unlock();
-      throw std::runtime_error("IOM Registration race detected for '"+name+"'");
-    }
-    ioms_by_hash_post[hid] = iom;
-    mutex->Unlock();
-  }
-  
+  return iom;
 }
 
 /**
@@ -211,13 +225,16 @@ void IomRegistry::init(const faodel::Configuration &config) {
   
   //Get the list of Ioms this Configuration wants to use
   string s,role;
+  bool background_open;
   config.GetString(&s, "kelpie.ioms");
+  config.GetBool(&background_open, "kelpie.ioms.background_open", "false");
   role = config.GetRole();
 
   
   if(!s.empty()) {
     dbg("Registering "+s);
     vector<string> names = faodel::Split(s,';',true);
+    set<string> known_names;
     for(auto &name : names) {
 
       //Get all settings for this iom. Do hierarchy of default, kelpie.iom.name, then role.kelpie.iom.name
@@ -233,7 +250,7 @@ void IomRegistry::init(const faodel::Configuration &config) {
       //Check for errors
       if(type == "") {
         emsg="Iom '"+name+"' does not have a type specified in Configuration";
-      } else if (Find(name)!=nullptr) {
+      } else if ((ioms_by_hash_pre.count(faodel::hash32(name))) || (known_names.count(name))) {
         emsg="Iom '"+name+"' defined multiple times in Configuration iom_names";
       } else if( iom_ctors.find(type)==iom_ctors.end()) {
         emsg="Iom type '"+type+"' is unknown. Deferred iom types not currently supported";
@@ -244,8 +261,18 @@ void IomRegistry::init(const faodel::Configuration &config) {
         throw std::runtime_error("IOM Configuration error. "+emsg);
       }
 
-      //Do the actual creation
-      RegisterIom(type, name, settings);
+      known_names.insert(name);
+
+      //Do the actual creation. Opening an iom may involve slow file system or
+      //database work, so it can overlap with the rest of startup
+      if(background_open) {
+        dbg("Opening iom "+name+" in the background");
+        pending_opens.push_back(std::async(std::launch::async, [this, type, name, settings]() {
+          return constructIom(type, name, settings);
+        }));
+      } else {
+        RegisterIom(type, name, settings);
+      }
     }
   }
 
@@ -255,12 +282,56 @@ void IomRegistry::init(const faodel::Configuration &config) {
 
 }
 
+/**
+ * @brief Wait for any background iom opens and mark the registry as started
+ * @throw runtime_error if a background iom open failed
+ * @note Ioms opened in the background are not visible to Find() until this runs.
+ *       Afterwards, lookups of pre-init ioms do not take a lock.
+ */
+void IomRegistry::start() {
+  finishPendingOpens();
+  mutex->Lock();
+  finalized=true;
+  mutex->Unlock();
+}
+
+/**
+ * @brief Wait for ioms that init() opened in the background and add them to the registry
+ * @throw runtime_error if a background iom open failed
+ * @note Only called by start() and finish(). This is a no-op unless kelpie.ioms.background_open was set
+ */
+void IomRegistry::finishPendingOpens() {
+  if(pending_opens.empty()) return;
+
+  string emsg;
+  for(auto &f : pending_opens) {
+    try {
+      IomBase *iom = f.get();
+      mutex->Lock();
+      ioms_by_hash_pre[faodel::hash32(iom->Name())] = iom;
+      mutex->Unlock();
+    } catch(const std::exception &e) {
+      emsg += string(e.what()) + " ";
+    }
+  }
+  pending_opens.clear();
+
+  if(!emsg.empty()) {
+    throw std::runtime_error("IOM background open failed: " + emsg);
+  }
+}
+
 /**
  * @brief Shutdown all ioms and remove all references to instances/drivers
  */
 void IomRegistry::finish() {
 
   dbg("Finishing");
+  try {
+    finishPendingOpens(); //Don't leave any opens running while we tear down
+  } catch(const std::exception &e) {
+    dbg(string("Ignoring failed background open during finish: ")+e.what());
+  }
   whookie::Server::deregisterHook("kelpie/iom_registry");
   
   //Tell all ioms to shutdown (may trigger some close operations)
@@ -289,22 +360,30 @@ void IomRegistry::finish() {
  */
 IomBase * IomRegistry::Find(iom_hash_t iom_hash) {
 
-  //Start with pre-init items
+  //Before start, the pre-init list may still be changing
+  if(!finalized.load(std::memory_order_acquire)) {
+    mutex->Lock();
+    auto rhash_rptr = ioms_by_hash_pre.find(iom_hash);
+    IomBase *iom = (rhash_rptr != ioms_by_hash_pre.end()) ? rhash_rptr->second : nullptr;
+    mutex->Unlock();
+    return iom;
+  }
+
+  //Start with pre-init items. These are fixed once started
   auto rhash_rptr = ioms_by_hash_pre.find(iom_hash);
   if(rhash_rptr != ioms_by_hash_pre.end()) {
     return rhash_rptr->second;
   }
 
   //Continue into finalized section
-  if(finalized) {
-    mutex->Lock();
-    rhash_rptr = ioms_by_hash_post.find(iom_hash);
-    if(rhash_rptr != ioms_by_hash_post.end()) {
-      mutex->Unlock();
-      return rhash_rptr->second;
-    }
+  mutex->Lock();
+  rhash_rptr = ioms_by_hash_post.find(iom_hash);
+  if(rhash_rptr != ioms_by_hash_post.end()) {
     mutex->Unlock();
+    return rhash_rptr->second;
   }
+  mutex->Unlock();
+
   //Not found
   return nullptr;
 }
@@ -323,8 +402,8 @@ void IomRegistry::HandleWhookieStatus(const std::map<std::string,std::string> &a
   
     faodel::ReplyStream rs(args, "Kelpie IOM "+iom_name, &results);
     rs.mkSection("IOM Info");
+    IomBase *iom = Find(iom_name); //Takes the lock itself
     mutex->Lock();
-    IomBase *iom = Find(iom_name);
     if(iom==nullptr) {
       rs.mkText("Error: Iom '"+iom_name+"' was not found in registry");
     } else {
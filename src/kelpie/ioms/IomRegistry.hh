@@ -5,8 +5,11 @@
 #ifndef KELPIE_IOMREGISTRY_HH
 #define KELPIE_IOMREGISTRY_HH
 
+#include <atomic>
+#include <future>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "faodel-common/InfoInterface.hh"
 #include "faodel-common/LoggingInterface.hh"
@@ -40,7 +43,7 @@ public:
   ~IomRegistry() override;
 
   void init(const faodel::Configuration &config);
-  void start() { finalized=true; }
+  void start();
   void finish();
 
   void RegisterIom(std::string type, std::string name,  const std::map<std::string,std::string> &settings);
@@ -62,9 +65,15 @@ public:
 private:
   faodel::MutexWrapper *mutex;
   int default_logging_level;
-  bool finalized;
-  std::map<iom_hash_t, IomBase *> ioms_by_hash_pre;
-  std::map<iom_hash_t, IomBase *> ioms_by_hash_post;
+  std::atomic<bool> finalized;                        //Set by start(). ioms_by_hash_pre is read-only afterwards
+  std::map<iom_hash_t, IomBase *> ioms_by_hash_pre;   //Registered before start. Guarded by mutex until finalized
+  std::map<iom_hash_t, IomBase *> ioms_by_hash_post;  //Registered after start. Always guarded by mutex
+
+  //Ioms from the Configuration that are being opened in the background (kelpie.ioms.background_open)
+  std::vector<std::future<IomBase *>> pending_opens;
+
+  IomBase * constructIom(std::string type, const std::string &name, const std::map<std::string,std::string> &settings);
+  void finishPendingOpens();
   
   std::map<std::string, fn_IomConstructor_t> iom_ctors;
   std::map<std::string, fn_IomGetValidSetting_t> iom_valid_setting_fns;
@@ -0,0 +1,126 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#include <cstring>
+
+#include "faodel-common/Debug.hh"
+
+#include "kelpie/localkv/LeaseTable.hh"
+
+using namespace std;
+
+namespace kelpie {
+
+LeaseTable::LeaseTable()
+  : max_leases(0), next_version(1), grace(0) {
+}
+
+LeaseTable::~LeaseTable() {
+  //Readers may still hold leases. Make sure none of them validate after we're gone
+  lock_guard<mutex> lock(lease_mutex);
+  if(!ldo_words.isNull()) {
+    auto words = getWords();
+    for(uint32_t i=0; i<=max_leases; i++)
+      words[i] = 0;
+  }
+}
+
+/**
+ * @brief Set how many objects may be leased at once. Must be called before the first Grant
+ * @param[in] max_leases_ The number of lease slots (0 disables leases)
+ * @param[in] grace_ms How long a revoked slot keeps its object alive for reads already in flight
+ */
+void LeaseTable::SetCapacity(uint32_t max_leases_, uint32_t grace_ms) {
+  lock_guard<mutex> lock(lease_mutex);
+  F_ASSERT(ldo_words.isNull(), "LeaseTable capacity changed after leases were granted");
+  max_leases = max_leases_;
+  grace = chrono::milliseconds(grace_ms);
+}
+
+volatile uint64_t * LeaseTable::getWords() {
+  return ldo_words.GetDataPtr<volatile uint64_t *>();
+}
+
+/**
+ * @brief Drop the objects of revoked slots whose grace period is over and free the slots
+ * @note Caller holds lease_mutex
+ */
+void LeaseTable::releaseRetired() {
+  auto now = chrono::steady_clock::now();
+  while(!retired_slots.empty() && (now - retired_slots.front().second >= grace)) {
+    uint32_t slot = retired_slots.front().first;
+    slot_ldos[slot] = lunasa::DataObject();
+    free_slots.push_back(slot);
+    retired_slots.pop_front();
+  }
+}
+
+/**
+ * @brief Lease an object, or refresh the lease a cell already holds
+ * @param[in] ldo The object being leased
+ * @param[in,out] slot The cell's slot (0 if the cell holds no lease). Set to the granted slot
+ * @param[out] lease The lease to hand to a reader
+ * @retval KELPIE_OK The lease was granted
+ * @retval KELPIE_ENOENT Leases are disabled or every slot is in use
+ */
+rc_t LeaseTable::Grant(const lunasa::DataObject &ldo, uint32_t *slot, object_lease_t *lease) {
+
+  lock_guard<mutex> lock(lease_mutex);
+  if(max_leases==0) return KELPIE_ENOENT;
+
+  //First grant: allocate the words. Slot 0 means "no lease" and is never handed out
+  if(ldo_words.isNull()) {
+    ldo_words = lunasa::DataObject(0, (max_leases+1)*sizeof(uint64_t), lunasa::DataObject::AllocatorType::eager);
+    memset(ldo_words.GetDataPtr(), 0, (max_leases+1)*sizeof(uint64_t));
+    slot_ldos.resize(max_leases+1);
+    for(uint32_t i=1; i<=max_leases; i++)
+      free_slots.push_back(i);
+  }
+
+  auto words = getWords();
+  if(*slot==0) {
+    releaseRetired();
+    if(free_slots.empty()) return KELPIE_ENOENT;
+    *slot = free_slots.front();
+    free_slots.pop_front();
+    slot_ldos[*slot] = ldo;  //Pin the object while the lease is out
+    words[*slot] = next_version++;
+  }
+
+  net::NetBufferLocal *nbl = nullptr;
+  lunasa::DataObject ldo_data = slot_ldos[*slot];
+  net::GetRdmaPtr(&ldo_data, &nbl, &lease->data_nbr);
+  net::GetRdmaPtr(&ldo_words,
+                  ldo_words.GetLocalHeaderSize() + ldo_words.GetHeaderSize() + ldo_words.GetMetaSize() + (*slot)*sizeof(uint64_t),
+                  sizeof(uint64_t), &nbl, &lease->version_nbr);
+  lease->meta_plus_data_size = ldo_data.GetMetaSize() + ldo_data.GetDataSize();
+  lease->version = words[*slot];
+
+  return KELPIE_OK;
+}
+
+/**
+ * @brief Invalidate a slot's lease and retire the slot
+ * @param[in] slot The slot to revoke (0 is ignored)
+ * @note The slot keeps its object pinned for the grace period, then the slot is freed
+ */
+void LeaseTable::Revoke(uint32_t slot) {
+  if(slot==0) return;
+  lock_guard<mutex> lock(lease_mutex);
+  getWords()[slot] = 0;
+  retired_slots.emplace_back(slot, chrono::steady_clock::now());
+  releaseRetired();
+}
+
+/**
+ * @brief Count the leases currently handed out (revoked slots in their grace period are not counted)
+ */
+uint32_t LeaseTable::GetNumActive() {
+  lock_guard<mutex> lock(lease_mutex);
+  if(ldo_words.isNull()) return 0;
+  releaseRetired();
+  return max_leases - free_slots.size() - retired_slots.size();
+}
+
+}  // namespace kelpie
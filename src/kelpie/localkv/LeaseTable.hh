@@ -0,0 +1,88 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#ifndef KELPIE_LEASETABLE_HH
+#define KELPIE_LEASETABLE_HH
+
+#include <chrono>
+#include <cinttypes>
+#include <deque>
+#include <utility>
+#include <mutex>
+#include <vector>
+
+#include "opbox/net/net.hh"
+#include "lunasa/DataObject.hh"
+
+#include "kelpie/common/Types.hh"
+
+namespace kelpie {
+
+/**
+ * @brief Everything a client needs to read an object without the owner's help
+ *
+ * A lease names the owner's copy of an object (data_nbr) and an 8-byte lease
+ * word (version_nbr). The lease is good while the lease word still holds
+ * version. A reader holding an older lease checks the lease word before it
+ * fetches the data, then checks it again, and only trusts the data if the
+ * word has not changed.
+ */
+struct object_lease_t {
+  net::NetBufferRemote   data_nbr;              //!< The object's meta+data at the owner
+  net::NetBufferRemote   version_nbr;           //!< The lease word at the owner
+  uint64_t               meta_plus_data_size;   //!< Bytes to read from data_nbr
+  uint64_t               version;               //!< Lease word value while the lease is valid (0 for no lease)
+};
+
+
+/**
+ * @brief Hands out leases on LocalKV objects and revokes them
+ *
+ * The table keeps one lease word per slot in a single registered LDO. A slot
+ * is bound to one cell while that cell's object is leased. Each grant stores
+ * a new version in the slot's word. Revoking zeroes the word, so every reader
+ * holding the old version sees that its lease is gone.
+ *
+ * A revoked slot keeps a reference to the object it pointed at for a grace
+ * period, so a read that was already in flight when the lease was revoked
+ * still lands in live memory. Slots stay out of use until the grace period
+ * ends. The first table call after that drops the reference and frees the slot.
+ *
+ * Slots are only touched under the table's mutex. The lease word LDO is
+ * allocated on the first grant.
+ */
+class LeaseTable {
+
+public:
+  LeaseTable();
+  ~LeaseTable();
+
+  void SetCapacity(uint32_t max_leases, uint32_t grace_ms);
+
+  rc_t Grant(const lunasa::DataObject &ldo, uint32_t *slot, object_lease_t *lease);
+  void Revoke(uint32_t slot);
+
+  uint32_t GetCapacity() const { return max_leases; }
+  uint32_t GetNumActive();
+
+private:
+  std::mutex lease_mutex;
+
+  uint32_t max_leases;
+  uint64_t next_version;
+  std::chrono::milliseconds grace;
+
+  lunasa::DataObject ldo_words;                 //!< Registered array of lease words (slot 0 unused)
+  std::vector<lunasa::DataObject> slot_ldos;    //!< The object each slot points at
+  std::deque<uint32_t> free_slots;              //!< Unused slots that pin nothing
+  std::deque<std::pair<uint32_t, std::chrono::steady_clock::time_point>> retired_slots; //!< Revoked slots still in their grace period, oldest first
+
+  volatile uint64_t * getWords();
+  void releaseRetired();
+
+};
+
+}  // namespace kelpie
+
+#endif  // KELPIE_LEASETABLE_HH
@@ -52,8 +52,14 @@ rc_t LocalKV::Init(const Configuration &config){
   //Enable our configuration
   ConfigureLogging(config);
 
-  //Create our mutex
+  //Create our mutex. Rows each get their own (usually short-held) lock
   table_mutex = config.GenerateComponentMutex("kelpie.lkv", "rwlock");
+  row_mutex_type_id = config.GetComponentMutexTypeID("kelpie.lkv.row", "default");
+
+  uint64_t max_leases, lease_grace_ms;
+  config.GetUInt(&max_leases, "kelpie.lkv.max_leases", "1024");
+  config.GetUInt(&lease_grace_ms, "kelpie.lkv.lease_grace_ms", "1000");
+  leases.SetCapacity(static_cast<uint32_t>(max_leases), static_cast<uint32_t>(lease_grace_ms));
   configured=true;
 
   //Register whookies
@@ -92,7 +98,7 @@ rc_t LocalKV::put(bucket_t bucket, const Key &key,
 
   F_ASSERT(key.valid(), "Put given invalid key");
 
-  dbg("Put "+bucket.GetHex()+"|"+key.str()+" length "+to_string(new_ldo.GetUserSize())+" behavior: "+to_string(behavior_flags));
+  F_LOG_DBG("Put "+bucket.GetHex()+"|"+key.str()+" length "+to_string(new_ldo.GetUserSize())+" behavior: "+to_string(behavior_flags));
 
   //Only create if writing to local, but always see if we trigger dependencies
   lambda_flags_t lambda_flags = LambdaFlags::TRIGGER_DEPENDENCIES;
@@ -111,7 +117,8 @@ rc_t LocalKV::put(bucket_t bucket, const Key &key,
                         //Exists - ignore updates
                         return KELPIE_EEXIST;
                       }
-                      //New item. Entry created, we just need to fill in the data
+                      //New item. Entry created, we just need to fill in the data. Overwrites end any lease
+                      col.revokeLease();
                       col.availability = Availability::InLocalMemory;
                       col.ldo = new_ldo;  //todo: deep copy?
                       col.time_posted = col.getTime();
@@ -119,7 +126,7 @@ rc_t LocalKV::put(bucket_t bucket, const Key &key,
                       return KELPIE_OK;
                     });
 
-  dbg("put to lkv returned "+to_string(rc));
+  F_LOG_DBG("put to lkv returned "+to_string(rc));
 
   //See if we need to write out to storage
   if(behavior_flags & PoolBehavior::WriteToIOM) {
@@ -155,7 +162,7 @@ rc_t LocalKV::get(faodel::bucket_t bucket, const Key &key,
 
   F_ASSERT(key.valid(), "get given invalid key");
 
-  dbg("Get "+bucket.GetHex()+"|"+key.str());
+  F_LOG_DBG("Get "+bucket.GetHex()+"|"+key.str());
 
   rc_t rc = doColOp(bucket, key,
                     lkv::LambdaFlags::DONT_CREATE_OR_TRIGGER, //<--Get doesn't create or trigger
@@ -179,7 +186,7 @@ rc_t LocalKV::getAvailable(faodel::bucket_t bucket, const Key &key,
   F_ASSERT(key.valid(), "getAvailable given invalid key");
   F_ASSERT(!key.IsRowWildcard(), "getAvailable given a row wildcard");
 
-  dbg("Get "+bucket.GetHex()+"|"+key.str());
+  F_LOG_DBG("Get "+bucket.GetHex()+"|"+key.str());
 
   rc_t rc=KELPIE_ENOENT;
 
@@ -237,7 +244,7 @@ rc_t LocalKV::getForOp(faodel::bucket_t bucket, const Key &key,
 
   F_ASSERT(key.valid(), "get given invalid key");
 
-  dbg("Get "+bucket.GetHex()+"|"+key.str());
+  F_LOG_DBG("Get "+bucket.GetHex()+"|"+key.str());
 
   rc_t rc = doColOp(bucket, key,
                     LambdaFlags::CREATE_IF_MISSING, //Get: creates mailbox dependency but doesn't trigger a dependency check
@@ -325,6 +332,113 @@ rc_t LocalKV::getData(bucket_t bucket, const Key &key,
   return rc;
 }
 
+/**
+ * @brief Lease an item so a remote node can read it with one-sided gets
+ * @param[in] bucket The user id that is marked as the bucket of this data
+ * @param[in] key The key used to reference this data
+ * @param[out] lease Where the object and its lease word live, plus the lease version
+ * @retval KELPIE_OK Success. The lease stays valid until the item is dropped or overwritten
+ * @retval KELPIE_ENOENT Item not here, or no lease slots are available. Nothing was queued
+ * @note Every remote reader of an item shares the item's one lease
+ */
+rc_t LocalKV::lease(bucket_t bucket, const Key &key, object_lease_t *lease) {
+
+  F_ASSERT(key.valid(), "lease given invalid key");
+
+  F_LOG_DBG("Lease "+bucket.GetHex()+"|"+key.str());
+
+  rc_t rc = doColOp(bucket, key,
+                    lkv::LambdaFlags::DONT_CREATE_OR_TRIGGER,
+                    nullptr,
+                    [this, lease] (LocalKVRow &row, LocalKVCell &col, bool previously_existed) {
+
+                      if(col.availability != Availability::InLocalMemory)
+                        return KELPIE_ENOENT;
+
+                      rc_t rc_grant = leases.Grant(col.ldo, &col.lease_slot, lease);
+                      if(rc_grant==KELPIE_OK) col.lease_table = &leases;
+                      return rc_grant;
+                    });
+  return rc;
+}
+
+/**
+ * @brief Atomically update an item that holds a single int64_t
+ * @param[in] bucket The user id that is marked as the bucket of this data
+ * @param[in] key The key used to reference this data
+ * @param[in] op The operation to perform
+ * @param[in] operand The value to add (Add) or the new value (CompareAndSwap)
+ * @param[in] compare The value the item must hold for a CompareAndSwap to happen
+ * @param[out] old_value The item's value before the operation (may be nullptr)
+ * @retval KELPIE_OK The item was updated
+ * @retval KELPIE_RECHECK CompareAndSwap did not match, so the item was left alone
+ * @retval KELPIE_EINVAL The item exists, but is not the size of an int64_t
+ * @retval KELPIE_EIO The item is known here but its value is not in memory (eg, only on disk), so it can't be updated
+ * @note The op runs under the row lock. A missing item (or one that is only requested) reads as zero and is created by the update,
+ *       which releases anyone waiting on it (a failed swap does not). Updates install a new LDO
+ *       instead of changing the old one, so earlier readers and leases never see the value change.
+ */
+rc_t LocalKV::atomic(bucket_t bucket, const Key &key,
+                     AtomicOp op, int64_t operand, int64_t compare,
+                     int64_t *old_value) {
+
+  F_ASSERT(key.valid(), "atomic given invalid key");
+
+  F_LOG_DBG("Atomic "+atomicop_to_string(op)+" "+bucket.GetHex()+"|"+key.str());
+
+  //Only create when the op will write to a missing item
+  lambda_flags_t lambda_flags = LambdaFlags::DONT_CREATE_OR_TRIGGER;
+  if((op == AtomicOp::Add) || (compare == 0)) {
+    lambda_flags |= lkv::LambdaFlags::CREATE_IF_MISSING;
+  }
+
+  int64_t old = 0;
+  rc_t rc = doColOp(bucket, key,
+                    lambda_flags,
+                    nullptr,
+                    [&key, op, operand, compare, &old] (LocalKVRow &row, LocalKVCell &col, bool previously_existed) {
+
+                      switch(col.availability) {
+                        case Availability::Unavailable:
+                        case Availability::Requested:
+                          break; //No value yet. Reads as zero
+                        case Availability::InLocalMemory:
+                          if(col.ldo.GetDataSize() != sizeof(int64_t))
+                            return KELPIE_EINVAL;
+                          memcpy(&old, col.ldo.GetDataPtr(), sizeof(int64_t));
+                          break;
+                        default:
+                          return KELPIE_EIO; //Value lives somewhere we can't update under the row lock
+                      }
+
+                      int64_t new_value;
+                      if(op == AtomicOp::Add) {
+                        new_value = static_cast<int64_t>(static_cast<uint64_t>(old) + static_cast<uint64_t>(operand));
+                      } else {
+                        if(old != compare) return KELPIE_RECHECK;
+                        new_value = operand;
+                      }
+
+                      lunasa::DataObject ldo(0, sizeof(int64_t), lunasa::DataObject::AllocatorType::eager);
+                      memcpy(ldo.GetDataPtr(), &new_value, sizeof(int64_t));
+
+                      col.revokeLease();
+                      col.availability = Availability::InLocalMemory;
+                      col.ldo = ldo;
+                      col.time_posted = col.getTime();
+
+                      //Only release waiters when a value was actually written
+                      col.dispatchCallbacksAndNotifications(&row, key);
+                      return KELPIE_OK;
+                    });
+
+  //A CompareAndSwap against a missing item only works when it expects zero
+  if(rc == KELPIE_ENOENT) rc = KELPIE_RECHECK;
+
+  if(old_value) *old_value = old;
+  return rc;
+}
+
 /**
  * @brief Process a want request, which provides a means of leaving a callback if an item is not available
  *
@@ -340,7 +454,7 @@ rc_t LocalKV::wantLocal(bucket_t bucket, const Key &key,
 
   F_ASSERT(key.valid(), "want given invalid key");
 
-  dbg("Want "+bucket.GetHex()+"|"+key.str());
+  F_LOG_DBG("Want "+bucket.GetHex()+"|"+key.str());
 
   rc_t rc = doColOp(bucket, key,
                     LambdaFlags::CREATE_IF_MISSING,    //Creates entry if missing, but does not dispatch callbacks
@@ -391,7 +505,7 @@ rc_t LocalKV::drop(bucket_t bucket, const Key &key_prefix){
 
   F_ASSERT(key_prefix.valid(), "drop given invalid key_prefix");
 
-  dbg("Drop "+bucket.GetHex()+"|"+key_prefix.str());
+  F_LOG_DBG("Drop "+bucket.GetHex()+"|"+key_prefix.str());
 
   int found_items=0;
 
@@ -466,7 +580,7 @@ rc_t LocalKV::list(bucket_t bucket, const Key &key_prefix,
 
   F_ASSERT(key_prefix.valid(), "list given an invalid key");
 
-  dbg("List "+key_prefix.str());
+  F_LOG_DBG("List "+key_prefix.str());
 
   bool found_items=false;
   bool needs_an_iom_check = (iom!=nullptr);
@@ -667,7 +781,7 @@ rc_t LocalKV::doRowOp(bucket_t bucket, const Key &key,
  */
 rc_t LocalKV::getInfo(bucket_t bucket, const Key &key, object_info_t *info) {
 
-  dbg("GetRowInfo "+bucket.GetHex()+"|"+key.str());
+  F_LOG_DBG("GetRowInfo "+bucket.GetHex()+"|"+key.str());
   rc_t rc = doColOp(bucket, key,
                     LambdaFlags::DONT_CREATE_OR_TRIGGER,
                     info,
@@ -755,6 +869,7 @@ void LocalKV::whookieInfo(faodel::ReplyStream &rs, bool detailed){
   rs.tableTop({"Parameter","Setting"});
   rs.tableRow({"Configured:", (configured)?"True":"False"});
   rs.tableRow({"Current Rows:", to_string(rows.size())});
+  rs.tableRow({"Active Leases:", to_string(leases.GetNumActive())+" of "+to_string(leases.GetCapacity())});
   rs.tableEnd();
 
   if(!detailed){
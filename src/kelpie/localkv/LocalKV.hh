@@ -17,6 +17,7 @@
 #include "faodel-common/ReplyStream.hh"
 
 #include "kelpie/Key.hh"
+#include "kelpie/localkv/LeaseTable.hh"
 #include "kelpie/localkv/LocalKVTypes.hh"
 #include "kelpie/localkv/LocalKVRow.hh"
 #include "kelpie/pools/Pool.hh"
@@ -93,6 +94,15 @@ public:
                     size_t *copied_size,
                     object_info_t *info);
 
+  //Lease an available item so remote readers can fetch it without us
+  rc_t lease(faodel::bucket_t bucket, const Key &key,
+                    object_lease_t *lease);
+
+  //Run an atomic add/swap on an item that holds a single int64
+  rc_t atomic(faodel::bucket_t bucket, const Key &key,
+                    AtomicOp op, int64_t operand, int64_t compare,
+                    int64_t *old_value);
+
   //Request a callback be made when an item becomes available
   rc_t wantLocal(faodel::bucket_t bucket, const Key &key,
                     bool caller_will_fetch_if_missing,
@@ -148,6 +158,8 @@ private:
   std::map<std::string, LocalKVRow *> rows;      //!< Map for storing each row's LocalKVRow
   faodel::MutexWrapper *table_mutex;             //!< Mutex needed for controlling single-access to the top-level row map
 
+  LeaseTable leases;                             //!< Leases handed to remote readers. Revoked when a cell is dropped or overwritten
+
   std::string makeRowname(faodel::bucket_t bucket, const Key &key);
   LocalKVRow * getRow(const std::string &full_row_name);
 
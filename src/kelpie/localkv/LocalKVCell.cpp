@@ -12,6 +12,7 @@
 #include "faodel-services/BackBurner.hh"
 #include "opbox/OpBox.hh"
 
+#include "kelpie/localkv/LeaseTable.hh"
 #include "kelpie/localkv/LocalKVCell.hh"
 #include "kelpie/localkv/LocalKVRow.hh"
 #include "kelpie/common/OpArgsObjectAvailable.hh"
@@ -24,10 +25,24 @@ namespace kelpie {
 
 LocalKVCell::LocalKVCell()
   : availability(Availability::Unavailable), hold_until(0), drop_requested(false),
-    time_offloaded(0) {
+    time_offloaded(0), lease_table(nullptr), lease_slot(0) {
   time_posted = getTime();
   time_accessed = time_posted;
 }
+
+LocalKVCell::~LocalKVCell() {
+  revokeLease();
+}
+
+/**
+ * @brief Invalidate any lease remote readers hold on this cell's object
+ * @note Called when the object is dropped or overwritten. Caller holds the row lock
+ */
+void LocalKVCell::revokeLease() {
+  if(lease_slot==0) return;
+  lease_table->Revoke(lease_slot);
+  lease_slot = 0;
+}
 /** @brief Get a 32b time marker */
 uint32_t LocalKVCell::getTime(){
   return (uint32_t) time(NULL);
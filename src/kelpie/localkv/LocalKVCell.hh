@@ -26,6 +26,8 @@
 
 namespace kelpie {
 
+class LeaseTable;  //Forward reference
+
 /**
  *   @brief A class for holding the final references to a block of memory
  */
@@ -36,6 +38,7 @@ public:
 
   LocalKVCell();
   LocalKVCell(const LocalKVCell &x) = delete;
+  ~LocalKVCell() override;
 
   bool operator<( const LocalKVCell &x) const;
   
@@ -54,6 +57,12 @@ public:
 
   lunasa::DataObject        ldo;            //!< The actual data object stored by Kelpie
 
+  //Lease that remote readers hold on ldo (see LeaseTable)
+  LeaseTable               *lease_table;    //!< Table that granted the lease, if any
+  uint32_t                  lease_slot;     //!< Slot of the lease in lease_table (0 for none)
+
+  void   revokeLease();
+
   //Functions for transferring ownership over to some other entity
   int    evict(const Key &key, const Availability new_availability, lunasa::DataObject *new_owners_ldo);
 
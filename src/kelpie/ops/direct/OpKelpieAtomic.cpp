@@ -0,0 +1,154 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#include <iostream>
+
+#include "faodel-common/Debug.hh"
+#include "kelpie/ops/direct/OpKelpieAtomic.hh"
+
+using namespace std;
+using namespace kelpie;
+
+//Statics: Standard id/name info for an op
+const unsigned int OpKelpieAtomic::op_id = const_hash("OpKelpieAtomic");
+const string OpKelpieAtomic::op_name = "OpKelpieAtomic";
+bool OpKelpieAtomic::debug_enabled = false;
+
+//Statics: This op has a static localkv pointer. lkv lives inside KelpieCore instance
+LocalKV * OpKelpieAtomic::lkv = nullptr;
+
+/**
+ * @brief Internal startup command for setting static variables
+ *
+ * @param[in] iuo Designates this function is for internal use only
+ * @param[in] config Pointer to configuration so that kelpie.op.atomic settings can be retrieved
+ * @param[in] new_lkv A pointer to the kelpie localkv we should use
+ */
+void OpKelpieAtomic::configure(faodel::internal_use_only_t iuo, const faodel::Configuration *config, LocalKV *new_lkv) {
+  lkv = new_lkv;
+  if(config) {
+    config->GetComponentLoggingSettings(&OpKelpieAtomic::debug_enabled, nullptr, nullptr, "kelpie.op.atomic");
+  }
+}
+
+
+/**
+ * @brief Create a new atomic op
+ *
+ * @param[in] target_node The node that owns the object
+ * @param[in] target_ptr The target node's peer pointer
+ * @param[in] bucket The bucket namespace for this object
+ * @param[in] key The key label for the object
+ * @param[in] op The operation to perform
+ * @param[in] operand Value to add, or the new value for a swap
+ * @param[in] compare Value the object must hold for a swap
+ * @param[in] cb_result Callback function invoked when the result is known
+ * @return OpKelpieAtomic
+ */
+OpKelpieAtomic::OpKelpieAtomic(
+                     const faodel::nodeid_t target_node,
+                     const net::peer_ptr_t target_ptr,
+                     const faodel::bucket_t bucket,
+                     const Key &key,
+                     const AtomicOp op,
+                     const int64_t operand,
+                     const int64_t compare,
+                     fn_atomic_callback_t cb_result)
+  :
+    Op(true),
+    state(State::orig_atomic_send),
+    peer(target_ptr),
+    key(key),
+    cb_atomic_result(cb_result) {
+
+  msg_direct_atomic_t::Alloc(ldo_msg, op_id, target_node, GetAssignedMailbox(),
+                             bucket, key, op, operand, compare);
+}
+
+/**
+ * @brief Create target-side handler for a new OpKelpieAtomic
+ *
+ * @param[in] t Marker designating this ctor is just for creating a target op
+ * @return OpKelpieAtomic
+ */
+OpKelpieAtomic::OpKelpieAtomic(Op::op_create_as_target_t t)
+  : Op(t), state(State::trgt_atomic_start), ldo_msg() {
+
+  //No work to do - done in target's state machine
+  peer = nullptr;
+}
+
+
+/**
+ * @brief Destructor for OpKelpieAtomic
+ */
+OpKelpieAtomic::~OpKelpieAtomic(){
+  if(state!=State::done) {
+    F_TODO("Atomic dtor called when not in done state");
+  }
+}
+
+
+//ORIGIN: Send the op to the owner
+WaitingType OpKelpieAtomic::smo_Atomic_Send(){
+  F_LOG_DBG("Sending atomic request for "+key.str());
+  net::SendMsg(peer, std::move(ldo_msg));
+  return updateState(State::orig_wait_for_reply, WaitingType::waiting_on_cq);
+}
+
+
+//TARGET: Run the op and send back the result. Never waits
+WaitingType OpKelpieAtomic::smt_Atomic_Start(OpArgs *args) {
+  auto imsg = args->ExpectMessageOrDie<msg_direct_atomic_t *>(&peer);
+
+  key = imsg->ExtractKey();
+  F_LOG_DBG("Received atomic "+atomicop_to_string(imsg->op)+" request for "+key.str());
+
+  int64_t old_value = 0;
+  rc_t rc = lkv->atomic(imsg->bucket, key, imsg->op, imsg->operand, imsg->compare, &old_value);
+
+  msg_direct_atomic_t::AllocReply(ldo_msg, &imsg->hdr, rc, old_value);
+  net::SendMsg(peer, std::move(ldo_msg));
+  return updateStateDone();
+}
+
+
+//ORIGIN: Hand the result back to the user
+WaitingType OpKelpieAtomic::smo_WaitReply(OpArgs *args) {
+
+  auto imsg = args->ExpectMessageOrDie<msg_direct_atomic_t *>();
+
+  F_LOG_DBG("Received atomic result "+std::to_string(imsg->remote_rc));
+  if(cb_atomic_result) {
+    cb_atomic_result(imsg->remote_rc, key, imsg->old_value);
+  }
+  return updateStateDone();
+}
+
+
+WaitingType OpKelpieAtomic::Update(opbox::OpArgs *args) {
+  switch(state){
+  case State::orig_atomic_send:       return smo_Atomic_Send();
+  case State::trgt_atomic_start:      return smt_Atomic_Start(args);
+  case State::orig_wait_for_reply:    return smo_WaitReply(args);
+  case State::done:                   return updateStateDone();
+  }
+  F_FAIL();
+  return WaitingType::error;
+}
+
+
+/**
+ * @brief Get a string name for the current state
+ * @retval string Human-readable name for state
+ */
+std::string OpKelpieAtomic::GetStateName() const {
+  switch(state){
+  case State::orig_atomic_send:       return "Origin-Atomic-Send";
+  case State::trgt_atomic_start:      return "Target-Atomic-Start";
+  case State::orig_wait_for_reply:    return "Origin-WaitForReply";
+  case State::done:                   return "Done";
+  }
+  F_FAIL();
+}
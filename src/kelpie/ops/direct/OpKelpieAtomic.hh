@@ -0,0 +1,110 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#ifndef KELPIE_OPKELPIEATOMIC_HH
+#define KELPIE_OPKELPIEATOMIC_HH
+
+#include "opbox/OpBox.hh"
+#include "opbox/ops/OpHelpers.hh"
+#include "lunasa/Lunasa.hh"
+#include "lunasa/DataObject.hh"
+
+#include "kelpie/Kelpie.hh"
+#include "kelpie/localkv/LocalKV.hh"
+
+#include "kelpie/ops/direct/msg_direct.hh"
+
+namespace kelpie {
+
+/**
+ * @brief An OpBox state machine for running an atomic op on an object's owner
+ *
+ * The origin sends the op and its operands to the owner. The owner runs it
+ * under the row lock and replies with the result and the object's old value.
+ */
+class OpKelpieAtomic : public opbox::Op {
+
+  //States
+  enum class State : int {
+    orig_atomic_send=0,
+    trgt_atomic_start,
+
+    orig_wait_for_reply,
+
+    done };
+
+public:
+
+  OpKelpieAtomic(const faodel::nodeid_t target_node,
+                 const net::peer_ptr_t target_ptr,
+                 const faodel::bucket_t bucket,
+                 const Key &key,
+                 const AtomicOp op,
+                 const int64_t operand,
+                 const int64_t compare,
+                 fn_atomic_callback_t cb_result);
+
+  //A target starts off the same way no matter what command
+  explicit OpKelpieAtomic(Op::op_create_as_target_t t);
+  ~OpKelpieAtomic() override;
+
+  //Unique name and id for this op
+  const static unsigned int op_id;
+  const static std::string  op_name;
+  static bool debug_enabled; //!< Dump debug messages
+
+  unsigned int getOpID() const override { return op_id; }
+  std::string  getOpName() const override { return op_name; }
+
+  WaitingType Update(OpArgs *args) override; //Combined use
+  WaitingType UpdateOrigin(OpArgs *args) override { return WaitingType::error; }  //Remove
+  WaitingType UpdateTarget(OpArgs *args) override { return WaitingType::error; }  //Remove
+
+  std::string GetStateName() const override;
+
+  static void configure(faodel::internal_use_only_t iuo, const faodel::Configuration *config, LocalKV *new_lkv);
+
+private:
+
+  #if Faodel_LOGGINGINTERFACE_DISABLED==0
+  bool IsDebugEnabled() const { return (Faodel_LOGGINGINTERFACE_MIN_LEVEL==0) && OpKelpieAtomic::debug_enabled; }
+  void dbg(const std::string &s) const {
+    if(IsDebugEnabled()) {
+      std::cout << "\033[1;93mD " << op_name << ": ["<<GetStateName()<<"]:\033[0m\t" << (s) << std::endl;
+    }
+  }
+  #else
+  bool IsDebugEnabled() const { return false; }
+  void dbg(const std::string &s) const {}
+  #endif
+
+
+  static LocalKV *lkv;  //Pointer back to the lkv, set at start time
+
+  State state;
+
+  net::peer_ptr_t       peer;              //For handoffs between ctor and start
+  Key                   key;               //Key to hand back to the user
+  lunasa::DataObject    ldo_msg;           //Outgoing message, allocated/managed by net
+  fn_atomic_callback_t  cb_atomic_result;  //Returns rc and the object's old value
+
+  //Origin/Target States (in order)
+  WaitingType smo_Atomic_Send();
+  WaitingType smt_Atomic_Start(opbox::OpArgs *args);
+  WaitingType smo_WaitReply(opbox::OpArgs *args);
+
+  WaitingType updateState(State new_state, WaitingType waiting_condition) {
+    state=new_state;
+    return waiting_condition;
+  }
+  WaitingType updateStateDone(){
+    state=State::done;
+    return WaitingType::done_and_destroy;
+  }
+
+};
+
+}  // namespace kelpie
+
+#endif  // KELPIE_OPKELPIEATOMIC_HH
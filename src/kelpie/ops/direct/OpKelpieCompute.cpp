@@ -105,7 +105,7 @@ OpKelpieCompute::~OpKelpieCompute(){
 
 //ORIGIN: Send the initial request
 WaitingType OpKelpieCompute::smo_Compute_Send() {
-  dbg("Send compute request for "+key.str());
+  F_LOG_DBG("Send compute request for "+key.str());
   net::SendMsg(peer, std::move(ldo_msg));
   return updateState(State::orig_compute_wait_for_info, WaitingType::waiting_on_cq);
 }
@@ -119,13 +119,13 @@ WaitingType OpKelpieCompute::smt_Compute_Start(OpArgs *args) {
   string function_name, function_args;
   imsg->ExtractComputeArgs(&key, &function_name, &function_args);
 
-  dbg("Received new compute request for function "+function_name+" on key "+key.str()+" args "+function_args);
+  F_LOG_DBG("Received new compute request for function "+function_name+" on key "+key.str()+" args "+function_args);
 
   //Have the lkv take care of all the fetching. We either get ok or op is queued up
   rc_t rc = lkv->doCompute(function_name, function_args,
                            bucket, key, &ldo_data);
 
-  dbg("lkv-compute success was "+to_string(rc));
+  F_LOG_DBG("lkv-compute success was "+to_string(rc));
 
 
   if(rc==KELPIE_OK) {
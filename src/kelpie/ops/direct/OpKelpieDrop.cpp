@@ -69,7 +69,7 @@ OpKelpieDrop::~OpKelpieDrop() {
 //Origin: Send out requests to all targets. Set counters on expected replies
 WaitingType OpKelpieDrop::smo_Drop_Send() {
 
-  dbg("Starting to send. NumTargets="+to_string(targets.size()));
+  F_LOG_DBG("Starting to send. NumTargets="+to_string(targets.size()));
 
   bool expects_reply = (callback!=nullptr);
   mailbox_t mbox = (expects_reply) ? GetAssignedMailbox() : opbox::MAILBOX_UNSPECIFIED;
@@ -77,7 +77,7 @@ WaitingType OpKelpieDrop::smo_Drop_Send() {
 
   //Note: assumes caller has correctly filtered this node from list
   for(auto &node_peerptr : targets) {
-    dbg("Sending to target "+node_peerptr.first.GetHex());
+    F_LOG_DBG("Sending to target "+node_peerptr.first.GetHex());
 
     lunasa::DataObject ldo;
     msg_direct_simple_t::Alloc(
@@ -115,7 +115,7 @@ WaitingType OpKelpieDrop::smt_Drop_Start(opbox::OpArgs *args) {
     auto omsg = msg_direct_status_t::AllocAck(ldo_reply, &imsg->hdr);  //Success changed below
     if(rc!=KELPIE_OK)
       omsg->Success(false);
-    dbg("Sending a reply message. Dropped items: "+to_string(rc==KELPIE_OK));
+    F_LOG_DBG("Sending a reply message. Dropped items: "+to_string(rc==KELPIE_OK));
     net::SendMsg(peer, std::move(ldo_reply));
 
     state=State::done;
@@ -137,7 +137,7 @@ WaitingType OpKelpieDrop::smo_Drop_WaitForResults(opbox::OpArgs *args) {
     successful_drops++;
 
   num_targets_left--;
-  dbg("Got a reply message. Num Targets now left "+to_string(num_targets_left));
+  F_LOG_DBG("Got a reply message. Num Targets now left "+to_string(num_targets_left));
   if(num_targets_left<1) {
     callback((successful_drops>0), search_key);
     state=State::done;
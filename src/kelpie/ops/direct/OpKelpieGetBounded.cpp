@@ -105,7 +105,7 @@ OpKelpieGetBounded::~OpKelpieGetBounded(){
 
 //ORIGIN: Send the initial request
 WaitingType OpKelpieGetBounded::smo_GetBounded_Send(){
-  dbg("Send bounded request for "+key.str());
+  F_LOG_DBG("Send bounded request for "+key.str());
   net::SendMsg(peer, std::move(ldo_msg));
   return updateState(State::orig_getbounded_wait_for_ack, WaitingType::waiting_on_cq);
 }
@@ -120,7 +120,7 @@ WaitingType OpKelpieGetBounded::smt_GetBounded_Start(OpArgs *args) {
   key    = imsg->ExtractKey();
 
 
-  dbg("Received new bounded request for "+key.str());
+  F_LOG_DBG("Received new bounded request for "+key.str());
 
   //Create an ack message (though success may change below)
   auto omsg = msg_direct_status_t::AllocAck(ldo_msg, &imsg->hdr);  //Success changed below
@@ -188,7 +188,7 @@ WaitingType OpKelpieGetBounded::smo_GetBounded_WaitAck(OpArgs *args) {
 
   auto imsg = args->ExpectMessageOrDie<msg_direct_status_t *>();
 
-  dbg("Received completion. Status is "+std::to_string(imsg->Success()));
+  F_LOG_DBG("Received completion. Status is "+std::to_string(imsg->Success()));
   cb_opget_result(imsg->Success(), key, ldo_data);
 
   return updateStateDone();
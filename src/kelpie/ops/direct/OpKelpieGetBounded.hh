@@ -68,13 +68,15 @@ private:
 
   //todo: put this in a standard form so it can be reused
   #if Faodel_LOGGINGINTERFACE_DISABLED==0
+  bool IsDebugEnabled() const { return (Faodel_LOGGINGINTERFACE_MIN_LEVEL==0) && OpKelpieGetBounded::debug_enabled; }
   void dbg(const std::string &s) const {
-    if(OpKelpieGetBounded::debug_enabled) {
+    if(IsDebugEnabled()) {
       std::cout << "\033[1;93mD " << op_name << ": ["<<GetStateName()<<"]:\033[0m\t" << (s) << std::endl;
     }
   }
   #else
-  void dbg(std::string s) const {}
+  bool IsDebugEnabled() const { return false; }
+  void dbg(const std::string &s) const {}
   #endif
 
   static LocalKV *lkv;  //Pointer back to the lkv, set at start time
@@ -102,7 +102,7 @@ OpKelpieGetUnbounded::~OpKelpieGetUnbounded(){
 
 //ORIGIN: Send the initial request
 WaitingType OpKelpieGetUnbounded::smo_GetUnbounded_Send() {
-  dbg("Send unbounded request for "+key.str());
+  F_LOG_DBG("Send unbounded request for "+key.str());
   net::SendMsg(peer, std::move(ldo_msg));
   return updateState(State::orig_getunbounded_wait_for_info, WaitingType::waiting_on_cq);
 }
@@ -115,7 +115,7 @@ WaitingType OpKelpieGetUnbounded::smt_GetUnbounded_Start(OpArgs *args) {
   bucket = imsg->bucket;
   key    = imsg->ExtractKey();
 
-  dbg("Received new unbounded request for "+key.str());
+  F_LOG_DBG("Received new unbounded request for "+key.str());
 
   //Create a message that can hold our buffer pointer
   msg_direct_buffer_t::Alloc(ldo_msg, op_id, DirectFlags::CMD_GET_UNBOUNDED, imsg->hdr.src, GetAssignedMailbox(),
@@ -127,7 +127,7 @@ WaitingType OpKelpieGetUnbounded::smt_GetUnbounded_Start(OpArgs *args) {
                           &ldo_data, nullptr); //todo: does not pass back row/col info
 
 
-  dbg("lkv-get success was "+to_string(rc)+" iom hash is "+to_string(imsg->iom_hash));
+  F_LOG_DBG("lkv-get success was "+to_string(rc)+" iom hash is "+to_string(imsg->iom_hash));
 
   if(rc==KELPIE_OK) {
     dbg("Item located. Sending pointers");
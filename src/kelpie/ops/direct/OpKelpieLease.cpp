@@ -0,0 +1,240 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "kelpie/core/Singleton.hh"
+#include "kelpie/ops/direct/OpKelpieLease.hh"
+
+using namespace std;
+using namespace kelpie;
+
+//Statics: Standard id/name info for an op
+const unsigned int OpKelpieLease::op_id = const_hash("OpKelpieLease");
+const string OpKelpieLease::op_name = "OpKelpieLease";
+bool OpKelpieLease::debug_enabled = false;
+
+//Statics: This op has a static localkv pointer. lkv lives inside KelpieCore instance
+LocalKV * OpKelpieLease::lkv = nullptr;
+
+/**
+ * @brief Internal startup command for setting static variables
+ *
+ * @param[in] iuo Designates this function is for internal use only
+ * @param[in] config Pointer to configuration so that kelpie.op.lease settings can be retrieved
+ * @param[in] new_lkv A pointer to the kelpie localkv we should use
+ */
+void OpKelpieLease::configure(faodel::internal_use_only_t iuo, const faodel::Configuration *config, LocalKV *new_lkv) {
+  lkv = new_lkv;
+  if(config) {
+    config->GetComponentLoggingSettings(&OpKelpieLease::debug_enabled, nullptr, nullptr, "kelpie.op.lease");
+  }
+}
+
+
+/**
+ * @brief Create a new Lease operation
+ *
+ * @param[in] target_node The node that owns the object
+ * @param[in] target_ptr The target node's peer pointer
+ * @param[in] bucket The bucket namespace for this object
+ * @param[in] key The key label for the object
+ * @param[in] lease A lease from an earlier read, or nullptr to request one
+ * @param[in] cb_result Callback function invoked when success/failure known
+ * @return OpKelpieLease
+ */
+OpKelpieLease::OpKelpieLease(
+                    const faodel::nodeid_t target_node,
+                    const net::peer_ptr_t target_ptr,
+                    const faodel::bucket_t bucket,
+                    const Key &key,
+                    const object_lease_t *lease,
+                    fn_oplease_result_t cb_result)
+  : Op(true),
+    state(State::orig_lease_start), peer(target_ptr),
+    bucket(bucket), key(key),
+    cb_oplease_result(cb_result) {
+
+  if(lease) {
+    this->lease = *lease;
+  } else {
+    memset(&this->lease, 0, sizeof(object_lease_t));
+  }
+
+  //Only need a request message if we don't have a lease to use
+  if(this->lease.version==0) {
+    msg_direct_simple_t::Alloc(ldo_msg, op_id,
+                               DirectFlags::CMD_GET_UNBOUNDED, target_node,
+                               GetAssignedMailbox(), opbox::MAILBOX_UNSPECIFIED,
+                               bucket, key, 0, PoolBehavior::NoAction);
+  }
+}
+
+
+/**
+ * @brief Create target-side handler for a new OpKelpieLease
+ *
+ * @param[in] t Marker designating this ctor is just for creating a target op
+ * @return OpKelpieLease
+ */
+OpKelpieLease::OpKelpieLease(Op::op_create_as_target_t t)
+  : Op(t), state(State::trgt_lease_start), ldo_msg()  {
+  //No work to do - done in target's state machine
+  peer = nullptr;
+  memset(&lease, 0, sizeof(object_lease_t));
+}
+
+
+/**
+ * @brief Destructor for OpKelpieLease
+ */
+OpKelpieLease::~OpKelpieLease(){
+  if(state!=State::done){
+    F_TODO("Lease dtor called when not in done state");
+  }
+}
+
+//ORIGIN: Read through our lease if we have one. Otherwise ask for one
+WaitingType OpKelpieLease::smo_Lease_Start(){
+  if(lease.version!=0) {
+    F_LOG_DBG("Checking existing lease for "+key.str());
+    return startVersionGet(State::orig_lease_wait_for_check);
+  }
+  F_LOG_DBG("Send lease request for "+key.str());
+  net::SendMsg(peer, std::move(ldo_msg));
+  return updateState(State::orig_lease_wait_for_lease, WaitingType::waiting_on_cq);
+}
+
+//ORIGIN: Start pulling the object
+WaitingType OpKelpieLease::startDataGet(){
+  ldo_data = lunasa::DataObject(0, lease.meta_plus_data_size, lunasa::DataObject::AllocatorType::eager);
+  net::Get(peer, &lease.data_nbr, ldo_data, AllEventsCallback(this));
+  return updateState(State::orig_lease_wait_for_data, WaitingType::waiting_on_cq);
+}
+
+//ORIGIN: Start pulling the lease word
+WaitingType OpKelpieLease::startVersionGet(State next_state){
+  ldo_version = lunasa::DataObject(0, sizeof(uint64_t), lunasa::DataObject::AllocatorType::eager);
+  net::Get(peer, &lease.version_nbr, 0,
+           ldo_version, ldo_version.GetHeaderSize()+ldo_version.GetMetaSize(), sizeof(uint64_t),
+           AllEventsCallback(this));
+  return updateState(next_state, WaitingType::waiting_on_cq);
+}
+
+//ORIGIN: True if the get worked and the lease word still holds our version
+bool OpKelpieLease::versionMatches(OpArgs *args) {
+  if(args->type != UpdateType::get_success) {
+    F_LOG_DBG("Lease read failed with "+str(args->type));
+    return false;
+  }
+  return (*ldo_version.GetDataPtr<uint64_t *>() == lease.version);
+}
+
+//ORIGIN: The lease is gone. Tell the caller so it can ask for a new one
+WaitingType OpKelpieLease::leaseRevoked() {
+  memset(&lease, 0, sizeof(object_lease_t));
+  ldo_data = lunasa::DataObject();
+  cb_oplease_result(false, key, ldo_data, lease);
+  return updateStateDone();
+}
+
+//ORIGIN: Target answered. Read the object if we got a lease
+WaitingType OpKelpieLease::smo_Lease_WaitLease(OpArgs *args) {
+
+  auto imsg = args->ExpectMessageOrDie<msg_direct_lease_t *>();
+  if(!imsg->Success()) {
+    F_LOG_DBG("Target did not grant a lease");
+    memset(&lease, 0, sizeof(object_lease_t));
+    cb_oplease_result(false, key, ldo_data, lease);
+    return updateStateDone();
+  }
+
+  //A fresh lease is inside the owner's grace period, so it can skip the first check
+  F_LOG_DBG("Lease granted. Retrieving data");
+  lease = imsg->lease;
+  return startDataGet();
+}
+
+//ORIGIN: Only touch the object's memory if the lease is still in place
+WaitingType OpKelpieLease::smo_Lease_WaitCheck(OpArgs *args) {
+
+  if(!versionMatches(args)) {
+    F_LOG_DBG("Lease was revoked before the read");
+    return leaseRevoked();
+  }
+  return startDataGet();
+}
+
+//ORIGIN: Object is here. Read the lease word to see if it changed underneath us
+WaitingType OpKelpieLease::smo_Lease_WaitData(OpArgs *args) {
+
+  if(args->type != UpdateType::get_success) {
+    F_LOG_DBG("Lease data read failed with "+str(args->type));
+    return leaseRevoked();
+  }
+  return startVersionGet(State::orig_lease_wait_for_version);
+}
+
+//ORIGIN: The data is good only if the lease is still in place
+WaitingType OpKelpieLease::smo_Lease_WaitVersion(OpArgs *args) {
+
+  if(!versionMatches(args)) {
+    F_LOG_DBG("Lease was revoked during the read");
+    return leaseRevoked();
+  }
+  cb_oplease_result(true, key, ldo_data, lease);
+  return updateStateDone();
+}
+
+//TARGET: Grant a lease if the object is here. Never waits for it
+WaitingType OpKelpieLease::smt_Lease_Start(OpArgs *args) {
+
+  auto imsg = args->ExpectMessageOrDie<msg_direct_simple_t *>(&peer);
+  bucket = imsg->bucket;
+  key    = imsg->ExtractKey();
+
+  F_LOG_DBG("Received lease request for "+key.str());
+
+  auto omsg = msg_direct_lease_t::Alloc(ldo_msg, &imsg->hdr);
+  rc_t rc = lkv->lease(bucket, key, &omsg->lease);
+  omsg->Success(rc==KELPIE_OK);
+
+  net::SendMsg(peer, std::move(ldo_msg));
+  return updateStateDone();
+}
+
+
+WaitingType OpKelpieLease::Update(opbox::OpArgs *args) {
+  switch(state){
+  case State::orig_lease_start:             return smo_Lease_Start();
+  case State::orig_lease_wait_for_lease:    return smo_Lease_WaitLease(args);
+  case State::orig_lease_wait_for_check:    return smo_Lease_WaitCheck(args);
+  case State::orig_lease_wait_for_data:     return smo_Lease_WaitData(args);
+  case State::orig_lease_wait_for_version:  return smo_Lease_WaitVersion(args);
+  case State::trgt_lease_start:             return smt_Lease_Start(args);
+  case State::done:                         return updateStateDone();
+  }
+  F_FAIL();
+  return WaitingType::error;
+}
+
+
+/**
+ * @brief Get a string name for the current state
+ * @retval string Human-readable name for state
+ */
+std::string OpKelpieLease::GetStateName() const {
+  switch(state){
+  case State::orig_lease_start:             return "Origin-Lease-Start";
+  case State::orig_lease_wait_for_lease:    return "Origin-Lease-WaitForLease";
+  case State::orig_lease_wait_for_check:    return "Origin-Lease-WaitForCheck";
+  case State::orig_lease_wait_for_data:     return "Origin-Lease-WaitForData";
+  case State::orig_lease_wait_for_version:  return "Origin-Lease-WaitForVersion";
+  case State::trgt_lease_start:             return "Target-Lease-Start";
+  case State::done:                         return "Done";
+  }
+  F_FAIL();
+}
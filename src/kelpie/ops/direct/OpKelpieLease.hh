@@ -0,0 +1,133 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#ifndef KELPIE_OPKELPIELEASE_HH
+#define KELPIE_OPKELPIELEASE_HH
+
+#include "opbox/OpBox.hh"
+#include "opbox/ops/OpHelpers.hh"
+#include "lunasa/Lunasa.hh"
+#include "lunasa/DataObject.hh"
+
+#include "kelpie/Kelpie.hh"
+#include "kelpie/localkv/LeaseTable.hh"
+#include "kelpie/localkv/LocalKV.hh"
+
+#include "kelpie/ops/direct/msg_direct.hh"
+
+namespace kelpie {
+
+//Passes back whether the read worked, the object, and the lease used to read it (version 0 if none)
+using fn_oplease_result_t = std::function<void (bool success, Key &key, lunasa::DataObject &ldo, const object_lease_t &lease)>;
+
+/**
+ * @brief An OpBox state machine for reading an object through a lease
+ *
+ * If the origin already holds a lease, the op reads the lease word, the
+ * object, and the lease word again with one-sided gets, and never talks to
+ * the target's op engine. It skips the object if the first read shows the
+ * lease is gone, and a failed get counts as a revoked lease. Otherwise it
+ * first asks the target for a lease. The target answers right away: it
+ * nacks if the object is not there yet or it is out of lease slots, so
+ * the caller can fall back to a normal get.
+ */
+class OpKelpieLease : public opbox::Op {
+
+  //States
+  enum class State : int {
+    orig_lease_start=0,
+    orig_lease_wait_for_lease,
+    orig_lease_wait_for_check,
+    orig_lease_wait_for_data,
+    orig_lease_wait_for_version,
+    trgt_lease_start,
+    done };
+
+public:
+
+  //Read an item, asking for a lease first if lease is nullptr or has no version
+  OpKelpieLease(
+          const faodel::nodeid_t target_node,
+          const net::peer_ptr_t target_ptr,
+          const faodel::bucket_t bucket,
+          const Key &key,
+          const object_lease_t *lease,
+          fn_oplease_result_t cb_result);
+
+  //A target starts off the same way no matter what command
+  OpKelpieLease(Op::op_create_as_target_t t);
+  ~OpKelpieLease() override;
+
+  //Unique name and id for this op
+  const static unsigned int op_id;
+  const static std::string  op_name;
+  static bool debug_enabled; //!< Dump debug messages
+
+  unsigned int getOpID() const override { return op_id; }
+  std::string  getOpName() const override { return op_name; }
+
+  WaitingType Update(OpArgs *args) override; //Combined use
+  WaitingType UpdateOrigin(OpArgs *args) override { return WaitingType::error; }  //Remove
+  WaitingType UpdateTarget(OpArgs *args) override { return WaitingType::error; }  //Remove
+
+  std::string GetStateName() const override;
+
+  static void configure(faodel::internal_use_only_t iuo, const faodel::Configuration *config, LocalKV *new_lkv);
+
+private:
+
+  #if Faodel_LOGGINGINTERFACE_DISABLED==0
+  bool IsDebugEnabled() const { return (Faodel_LOGGINGINTERFACE_MIN_LEVEL==0) && OpKelpieLease::debug_enabled; }
+  void dbg(const std::string &s) const {
+    if(IsDebugEnabled()) {
+      std::cout << "\033[1;93mD " << op_name << ": ["<<GetStateName()<<"]:\033[0m\t" << (s) << std::endl;
+    }
+  }
+  #else
+  bool IsDebugEnabled() const { return false; }
+  void dbg(const std::string &s) const {}
+  #endif
+
+  static LocalKV *lkv;  //Pointer back to the lkv, set at start time
+
+  State state;
+  net::peer_ptr_t peer;
+
+  object_lease_t lease;
+  faodel::bucket_t bucket;
+  Key key;
+
+  lunasa::DataObject ldo_msg;       //Outgoing message, allocated/managed by net
+  lunasa::DataObject ldo_data;      //Object being read
+  lunasa::DataObject ldo_version;   //Lease word read before and after the object
+
+  fn_oplease_result_t cb_oplease_result;
+
+  //Origin/Target States (in order)
+  WaitingType smo_Lease_Start();
+  WaitingType smo_Lease_WaitLease(opbox::OpArgs *args);
+  WaitingType smo_Lease_WaitCheck(opbox::OpArgs *args);
+  WaitingType smo_Lease_WaitData(opbox::OpArgs *args);
+  WaitingType smo_Lease_WaitVersion(opbox::OpArgs *args);
+  WaitingType smt_Lease_Start(opbox::OpArgs *args);
+
+  WaitingType startDataGet();
+  WaitingType startVersionGet(State next_state);
+  bool versionMatches(opbox::OpArgs *args);
+  WaitingType leaseRevoked();
+
+  WaitingType updateState(State new_state, WaitingType waiting_condition) {
+    state=new_state;
+    return waiting_condition;
+  }
+  WaitingType updateStateDone(){
+    state=State::done;
+    return WaitingType::done_and_destroy;
+  }
+
+};
+
+}  // namespace kelpie
+
+#endif  // KELPIE_OPKELPIELEASE_HH
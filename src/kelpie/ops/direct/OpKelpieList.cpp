@@ -85,7 +85,7 @@ WaitingType OpKelpieList::smo_List_Send() {
   auto mbox = GetAssignedMailbox();
 
   for(auto &node_peerptr : targets) {
-    dbg("Sending to target "+node_peerptr.first.GetHex());
+    F_LOG_DBG("Sending to target "+node_peerptr.first.GetHex());
 
     lunasa::DataObject ldo;
     msg_direct_simple_t::Alloc(
@@ -109,13 +109,13 @@ WaitingType OpKelpieList::smt_List_Start(opbox::OpArgs *args) {
 
   ObjectCapacities found_object_capacities;
 
-  dbg("Target received a list request for "+search_key.str());
+  F_LOG_DBG("Target received a list request for "+search_key.str());
 
   // If there's an IOM, attempt to find matching objects there.
   auto *iom = kelpie::internal::FindIOM(imsg->iom_hash);
 
   rc_t rc = lkv->list(imsg->bucket, search_key, iom, &found_object_capacities);
-  dbg("Target list found objects final: "+to_string(found_object_capacities.capacities.size()));
+  F_LOG_DBG("Target list found objects final: "+to_string(found_object_capacities.capacities.size()));
 
   uint16_t simple_rc = (rc==KELPIE_OK) ? 0 : 1;
 
@@ -138,7 +138,7 @@ WaitingType OpKelpieList::smo_List_WaitForResults(opbox::OpArgs *args) {
   user_object_capacities->Append(found_object_capacities);
 
   num_targets_left--;
-  dbg("Origin received response. num_left="+std::to_string(num_targets_left));
+  F_LOG_DBG("Origin received response. num_left="+std::to_string(num_targets_left));
 
   if(num_targets_left<1) {
     dbg("Received last item. Notifying user of result");
@@ -151,7 +151,7 @@ WaitingType OpKelpieList::smo_List_WaitForResults(opbox::OpArgs *args) {
 }
 
 WaitingType OpKelpieList::Update(OpArgs *args) {
-  dbg("Got an update. Processing state "+GetStateName());
+  F_LOG_DBG("Got an update. Processing state "+GetStateName());
   switch(state) {
     case State::orig_list_send:             return smo_List_Send();
     case State::trgt_list_start:            return smt_List_Start(args);
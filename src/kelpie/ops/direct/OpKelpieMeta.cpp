@@ -112,7 +112,7 @@ WaitingType OpKelpieMeta::smt_Meta_Start(OpArgs *args) {
   bool is_colinfo = (cmd == DirectFlags::CMD_GET_COLINFO);
   bool is_rowinfo = (cmd == DirectFlags::CMD_GET_ROWINFO);
 
-  dbg("Received meta request for "+key.str());
+  F_LOG_DBG("Received meta request for "+key.str());
   if( is_colinfo || is_rowinfo) {
 
     //Allocate a result message for us to store our row/col info
@@ -119,7 +119,7 @@ WaitingType OpKelpiePublish::smt_Publish_Start(OpArgs *args) {
   target_behavior_flags = PoolBehavior::ChangeRemoteToLocal(imsg->behavior_flags);
 
   //cout <<"OPPUB-TRG: message is a publish. OMBox="<<imsg->hdr.src_mailbox<<" Meta+Data Length is "<<imsg->meta_plus_data_size<<" key is "<<key.str()<<"\n";
-  dbg("Received new publish for "+key.str()+" length "+std::to_string(imsg->meta_plus_data_size));
+  F_LOG_DBG("Received new publish for "+key.str()+" length "+std::to_string(imsg->meta_plus_data_size));
 
   //Create return ack message
   msg_direct_status_t::AllocAck(ldo_msg, &imsg->hdr);
@@ -155,7 +155,7 @@ WaitingType OpKelpiePublish::smt_Publish_Start(OpArgs *args) {
 WaitingType OpKelpiePublish::smt_Publish_WaitRDMA(opbox::OpArgs *args){
 
   //cout <<"OPPUB-TRG: got dma done notification. sending ack. Key is "<<key.str()<<"\n";
-  dbg("Finished receiving data for "+key.str());
+  F_LOG_DBG("Finished receiving data for "+key.str());
 
   //FIXME
   if(args->type == UpdateType::send_success) {
@@ -203,7 +203,7 @@ WaitingType OpKelpiePublish::smo_Publish_WaitAck(opbox::OpArgs *args) {
   //Got a reply. We no longer have to hold on to the publish data's ldo. If
   //caller specified a callback, pass the result back
   if(cb_info_result!=nullptr){
-    dbg("Got ack Reply. Remote rc was "+to_string(imsg->remote_rc)+" success "+ to_string(imsg->Success())+"\n");
+    F_LOG_DBG("Got ack Reply. Remote rc was "+to_string(imsg->remote_rc)+" success "+ to_string(imsg->Success())+"\n");
     imsg->object_info.ChangeAvailabilityFromLocalToRemote();
     cb_info_result(imsg->remote_rc, imsg->object_info);
   }
@@ -267,6 +267,95 @@ msg_direct_status_t * msg_direct_status_t::Alloc(
 
 
 
+/**
+ * @brief Allocate a reply to a lease request. The reply starts out as a nack with no lease
+ * @param[out] ldo_msg A new message LDO
+ * @param[in] incoming_msg_hdr The lease request being answered
+ * @return A pointer to the message inside ldo_msg
+ */
+msg_direct_lease_t * msg_direct_lease_t::Alloc(
+                    lunasa::DataObject &ldo_msg,
+                    message_t *incoming_msg_hdr) {
+
+  ldo_msg = net::NewMessage(sizeof(msg_direct_lease_t));
+
+  auto msg = ldo_msg.GetDataPtr<msg_direct_lease_t *>();
+  memset((void *)msg, 0, sizeof(msg_direct_lease_t));
+
+  msg->hdr.SetStandardReply(incoming_msg_hdr,
+                    DirectFlags::CMD_STATUS_NACK,
+                    sizeof(msg_direct_lease_t)-sizeof(message_t));
+
+  return msg;
+}
+
+
+/**
+ * @brief Allocate an atomic op request
+ * @retval true The message is larger than the MTU
+ */
+bool
+msg_direct_atomic_t::Alloc(lunasa::DataObject &ldo_msg, const uint32_t op_id, const faodel::nodeid_t dst,
+                           const opbox::mailbox_t src_mailbox, const faodel::bucket_t bucket,
+                           const kelpie::Key &key, const AtomicOp op, const int64_t operand, const int64_t compare) {
+
+  //Allocate the message
+  ldo_msg = net::NewMessage(sizeof(msg_direct_atomic_t)+key.size());
+
+  auto *msg = ldo_msg.GetDataPtr<msg_direct_atomic_t *>();
+  memset((void *)msg, 0, sizeof(msg_direct_atomic_t));
+
+  msg->operand = operand;
+  msg->compare = compare;
+  msg->k1_size = key.k1_size();
+  msg->k2_size = key.k2_size();
+  msg->bucket = bucket;
+  msg->op = op;
+
+  msg->hdr.SetStandardRequest(dst, src_mailbox, op_id, DirectFlags::CMD_COMPUTE);
+  msg->hdr.body_len = (sizeof(msg_direct_atomic_t) - sizeof(opbox::message_t) + key.size());
+
+  //Append the key at the end
+  char *ptr = &msg->string_data[0];
+  memcpy(ptr, key.K1().c_str(), msg->k1_size); ptr += msg->k1_size;
+  memcpy(ptr, key.K2().c_str(), msg->k2_size);
+
+  return (ldo_msg.GetWireSize() > MESSAGE_MTU);
+}
+
+kelpie::Key msg_direct_atomic_t::ExtractKey() const {
+  kelpie::Key key( std::string(&string_data[0],       static_cast<size_t>(k1_size)),
+                   std::string(&string_data[k1_size], static_cast<size_t>(k2_size)) );
+  if(!key.valid()){
+    throw std::invalid_argument("msg_direct_atomic had an invalid key");
+  }
+  return key;
+}
+
+/**
+ * @brief Allocate the reply to an atomic op request. Acks if the op updated the object
+ */
+msg_direct_atomic_t * msg_direct_atomic_t::AllocReply(
+                    lunasa::DataObject &ldo_msg,
+                    message_t *incoming_msg_hdr,
+                    rc_t remote_rc,
+                    int64_t old_value) {
+
+  ldo_msg = net::NewMessage(sizeof(msg_direct_atomic_t));
+
+  auto msg = ldo_msg.GetDataPtr<msg_direct_atomic_t *>();
+  memset((void *)msg, 0, sizeof(msg_direct_atomic_t));
+
+  msg->remote_rc = remote_rc;
+  msg->old_value = old_value;
+
+  msg->hdr.SetStandardReply(incoming_msg_hdr,
+                    (remote_rc==KELPIE_OK) ? DirectFlags::CMD_STATUS_ACK : DirectFlags::CMD_STATUS_NACK,
+                    sizeof(msg_direct_atomic_t)-sizeof(message_t));
+
+  return msg;
+}
+
 
 
 }  // namespace kelpie
@@ -11,14 +11,17 @@
 #include "lunasa/Lunasa.hh"
 #include "lunasa/DataObject.hh"
 #include "kelpie/Kelpie.hh"
+#include "kelpie/localkv/LeaseTable.hh"
 #include "kelpie/localkv/LocalKV.hh"
 
 
 namespace kelpie {
 
-// The Direct ops use three kinds of messages:
+// The Direct ops use five kinds of messages:
 //  - buffer : for sending a buffer handle, bucket, and key to remote
 //  - status : for passing back ack/nacks and info about a k/v
+//  - lease : for passing back a lease on an object
+//  - atomic : for sending an atomic op and passing back its result
 //  - listreply : custom cereal-packed message with info for reply messages
 //
 // The following messages are sent during different types of
@@ -54,6 +57,18 @@ namespace kelpie {
 //    target: sends custom cereal message with all the info packed into a message
 //    origin: gathers all responses. Ends when all collected.
 //
+// lease: read an object with one-sided gets (origin may skip the first two steps if it has a lease)
+//    origin: sends SIMPLE message with CMD_GET_UNBOUNDED, bucket, key
+//    target: sends LEASE message with Success flag and a lease if the object is here. Never waits
+//    origin: if it already had a lease, gets the lease word first and stops if it changed
+//    origin: does a get rdma transfer of the object, then of the lease word
+//    origin: data is good if the lease word still matches the lease's version. A failed get counts as revoked
+//
+// atomic: add to or compare-and-swap an int64 object on its owner
+//    origin: sends ATOMIC message with CMD_COMPUTE, bucket, key, op, and operands
+//    target: performs the op under the row lock
+//    target: sends ATOMIC message with the rc and the value from before the op
+//
 // drop: specify node should drop all objects matching a search string
 //    origin: sends BUFFER message with CMD_DROP to one or more targets
 //    target: optional send STATUS message with Ack/Nack info
@@ -258,6 +273,68 @@ struct msg_direct_status_t {
 
 };
 
+/**
+ * @brief Reply to a lease request
+ * @note Call Alloc to create an appropriately-sized LDO and get a cast of it.
+ */
+struct msg_direct_lease_t {
+  opbox::message_t                   hdr;                         //!< Standard header field
+  object_lease_t                     lease;                       //!< The lease (only valid if Success is set)
+
+  void Success(bool is_success) { return DirectFlags::Success(&hdr, is_success); }
+  bool Success()                { return DirectFlags::Success(&hdr); }
+
+  msg_direct_lease_t()=delete; //Intentionally disable. Call Alloc instead
+
+  static msg_direct_lease_t * Alloc(
+                    lunasa::DataObject &new_ldo_ptr,              //!< New LDO generated for holding this message
+                    message_t *origin_msg_hdr                     //!< Original request to reference
+                    );
+};
+
+/**
+ * @brief Message format for an atomic op request and its reply
+ * @note Key data is manually packed into the string_data section at the end of
+ *       a request, so you MUST use the Alloc() function to create a new message.
+ *       Replies do not carry the key.
+ */
+struct msg_direct_atomic_t {
+  opbox::message_t                   hdr;                         //!< Standard header field
+
+  int64_t                            operand;                     //!< Value to add, or the new value for a swap
+  int64_t                            compare;                     //!< Value the object must hold for a swap
+  int64_t                            old_value;                   //!< Reply: object's value before the op
+  int32_t                            remote_rc;                   //!< Reply: return code seen at the target
+  uint16_t                           k1_size;                     //!< Used for serdes of key.k1
+  uint16_t                           k2_size;                     //!< Used for serdes of key.k2
+  faodel::bucket_t                   bucket;                      //!< Hashed bucket id
+  AtomicOp                           op;                          //!< Operation to perform
+
+  char                               string_data[0];              //!< Place where packed key data is stored
+
+  msg_direct_atomic_t()=delete; //Intentionally disable. Call an Alloc instead
+
+  kelpie::Key ExtractKey() const;
+
+  static bool Alloc(lunasa::DataObject &new_ldo,                     //!< New LDO generated for holding this message
+                    const uint32_t op_id,                            //!< Which op this is for
+                    const faodel::nodeid_t dst,                      //!< Where this message is going
+                    const opbox::mailbox_t src_mailbox,              //!< What our mailbox should be
+                    const faodel::bucket_t bucket,                   //!< Hashed bucket id for message
+                    const kelpie::Key &key,                          //!< The key for this request
+                    const AtomicOp op,                               //!< The operation to perform
+                    const int64_t operand,                           //!< Value to add, or the new value for a swap
+                    const int64_t compare                            //!< Value the object must hold for a swap
+  );
+
+  static msg_direct_atomic_t * AllocReply(
+                    lunasa::DataObject &new_ldo_ptr,              //!< New LDO generated for holding this message
+                    message_t *origin_msg_hdr,                    //!< Original request to reference
+                    rc_t remote_rc,                               //!< Result of the op
+                    int64_t old_value                             //!< Object's value before the op
+                    );
+};
+
 #pragma GCC diagnostic pop //For ignoring array[0] kinds of allocation
 
 }  // namespace kelpie
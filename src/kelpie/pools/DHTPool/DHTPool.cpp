@@ -17,9 +17,11 @@
 
 #include "kelpie/Kelpie.hh"
 #include "kelpie/pools/DHTPool/DHTPool.hh"
+#include "kelpie/ops/direct/OpKelpieAtomic.hh"
 #include "kelpie/ops/direct/OpKelpieCompute.hh"
 #include "kelpie/ops/direct/OpKelpieGetBounded.hh"
 #include "kelpie/ops/direct/OpKelpieGetUnbounded.hh"
+#include "kelpie/ops/direct/OpKelpieLease.hh"
 #include "kelpie/ops/direct/OpKelpieMeta.hh"
 #include "kelpie/ops/direct/OpKelpiePublish.hh"
 
@@ -32,7 +34,7 @@ namespace kelpie {
 
 
 DHTPool::DHTPool(const ResourceURL &pool_url)
-  : PoolBase(pool_url, PoolBehavior::DefaultRemote) {
+  : PoolBase(pool_url, PoolBehavior::DefaultRemote), use_leases(false) {
 
 
   bool ok = dirman::GetDirectoryInfo(pool_url, &dir_info);
@@ -43,18 +45,21 @@ DHTPool::DHTPool(const ResourceURL &pool_url)
 
   bool we_are_in_pool=false;
 
-  //Allocate peers and connect to each one
+  //Record the members. Their peers are connected when first used (see getPeer)
   for(size_t i=0; i<dir_info.members.size(); i++) {
 
     if(dir_info.members[i].node == my_nodeid)
       we_are_in_pool=true;
 
-    net::peer_ptr_t peer;
-    int rc = net::Connect(&peer, dir_info.members[i].node);
-    if(rc!=0) {
-      throw std::runtime_error("Pool "+TypeName()+" could not connect to peer "+dir_info.members[i].name);
+    nodes.emplace_back(pair<nodeid_t, net::peer_ptr_t>(dir_info.members[i].node, nullptr));
+  }
+
+  //Optionally read remote objects through leases
+  string lease_option = pool_url.GetOption("lease");
+  if(!lease_option.empty()) {
+    if(faodel::StringToBoolean(&use_leases, lease_option)!=0) {
+      throw std::runtime_error("Pool "+TypeName()+" given an invalid lease option in "+pool_url.str());
     }
-    nodes.emplace_back(pair<nodeid_t, net::peer_ptr_t>(dir_info.members[i].node, peer));
   }
 
   //Change default behavior when we have an iom attached
@@ -99,7 +104,7 @@ DHTPool::DHTPool(const ResourceURL &pool_url)
  */
 rc_t DHTPool::Publish(const Key &key, const fn_publish_callback_t &callback){
 
-  dbg("Publish (from lkv) bucket "+default_bucket.GetHex()+" key "+key.str());
+  F_LOG_DBG("Publish (from lkv) bucket "+default_bucket.GetHex()+" key "+key.str());
 
   //Retrieve the item from lkv so we can send to the destination
   lunasa::DataObject ldo;
@@ -124,7 +129,7 @@ rc_t DHTPool::Publish(const Key &key,
   //Figure out which node in our list gets the spot
   uint32_t spot = findNodeIndex(key);
 
-  dbg("Publish ldo to dht node "+std::to_string(spot)+" for bucket "+default_bucket.GetHex()+" key "+key.str());
+  F_LOG_DBG("Publish ldo to dht node "+std::to_string(spot)+" for bucket "+default_bucket.GetHex()+" key "+key.str());
 
 
   //Skip ops if we're actually the target node in the dht
@@ -138,7 +143,7 @@ rc_t DHTPool::Publish(const Key &key,
 
   //Send it off to the right destination for processing
   auto *op = new OpKelpiePublish(
-                                nodes[spot].first, nodes[spot].second,
+                                nodes[spot].first, getPeer(spot),
                                 default_bucket,
                                 key,
                                 user_ldo,
@@ -168,7 +173,7 @@ rc_t DHTPool::Publish(const Key &key,
  */
 rc_t DHTPool::Want(const Key &key, size_t expected_ldo_user_bytes, const fn_want_callback_t &callback){
 
-  dbg("Want (size="+to_string(expected_ldo_user_bytes)+") key "+key.str());
+  F_LOG_DBG("Want (size="+to_string(expected_ldo_user_bytes)+") key "+key.str());
 
   //Check the lkv to see if it already exists. If it does, have lkv do
   //the callback. If it doesn't, leave the callback in place so it can
@@ -196,12 +201,28 @@ rc_t DHTPool::Want(const Key &key, size_t expected_ldo_user_bytes, const fn_want
     return KELPIE_OK;
   }
 
-  
+  if(use_leases) {
+    launchLeaseRead(spot, key, expected_ldo_user_bytes);
+  } else {
+    launchGet(spot, key, expected_ldo_user_bytes);
+  }
+
+  return KELPIE_OK;
+}
+
+/**
+ * @brief Launch an op that fetches an object from its owner and places it in the lkv
+ * @param[in] spot The index of the owner in nodes
+ * @param[in] key The Key for the desired blob
+ * @param[in] expected_ldo_user_bytes The expected size of the item (if known), or zero (if unknown)
+ */
+void DHTPool::launchGet(uint32_t spot, const Key &key, size_t expected_ldo_user_bytes) {
+
   if(expected_ldo_user_bytes > 0) {
 
     //We know length. Do a Bounded Get op
     auto *op = new OpKelpieGetBounded(
-                                   nodes[spot].first, nodes[spot].second,
+                                   nodes[spot].first, getPeer(spot),
                                    default_bucket,
                                    key,
                                    expected_ldo_user_bytes,
@@ -219,7 +240,7 @@ rc_t DHTPool::Want(const Key &key, size_t expected_ldo_user_bytes, const fn_want
 
     //Don't know length. Use an Unbounded Get op
     auto *op = new OpKelpieGetUnbounded(
-                                   nodes[spot].first, nodes[spot].second,
+                                   nodes[spot].first, getPeer(spot),
                                    default_bucket,
                                    key,
                                    iom_hash,
@@ -234,8 +255,60 @@ rc_t DHTPool::Want(const Key &key, size_t expected_ldo_user_bytes, const fn_want
     opbox::LaunchOp(op);
 
   }
+}
 
-  return KELPIE_OK;
+/**
+ * @brief Read an object through a lease and place it in the lkv
+ * @param[in] spot The index of the owner in nodes
+ * @param[in] key The Key for the desired blob
+ * @param[in] expected_ldo_user_bytes The expected size of the item (if known), or zero (if unknown)
+ * @note A revoked lease is replaced by asking for a new one. Falls back to launchGet when the owner refuses a lease
+ * @note Without ReadToLocal an object this read placed in the lkv is dropped once waiters have it, so the next read uses the lease
+ */
+void DHTPool::launchLeaseRead(uint32_t spot, const Key &key, size_t expected_ldo_user_bytes) {
+
+  object_lease_t lease;
+  bool have_lease=false;
+  {
+    lock_guard<mutex> lock(lease_mutex);
+    auto key_lease = leases.find(key);
+    if(key_lease != leases.end()) {
+      lease = key_lease->second;
+      have_lease = true;
+    }
+  }
+
+  auto *op = new OpKelpieLease(
+                               nodes[spot].first, getPeer(spot),
+                               default_bucket,
+                               key,
+                               (have_lease) ? &lease : nullptr,
+                               [this, spot, expected_ldo_user_bytes, have_lease] (bool success, Key &key, lunasa::DataObject &ldo,
+                                                                                  const object_lease_t &new_lease) {
+                                 {
+                                   lock_guard<mutex> lock(lease_mutex);
+                                   if(success) leases[key] = new_lease;
+                                   else        leases.erase(key);
+                                 }
+                                 if(success) {
+                                   if(behavior_flags & PoolBehavior::ReadToLocal) {
+                                     lkv->put(default_bucket, key, ldo, behavior_flags, nullptr, nullptr);
+                                   } else {
+                                     //Only hand the object to waiters. Never replace a copy that was already
+                                     //here, and only drop the object if this put is what placed it
+                                     rc_t rc = lkv->put(default_bucket, key, ldo,
+                                                        static_cast<pool_behavior_t>(behavior_flags & ~PoolBehavior::EnableOverwrites), nullptr, nullptr);
+                                     if(rc==KELPIE_OK) lkv->drop(default_bucket, key);
+                                   }
+                                 } else if(have_lease) {
+                                   //Lease was revoked. Object may have been replaced, so ask for a new one
+                                   launchLeaseRead(spot, key, expected_ldo_user_bytes);
+                                 } else {
+                                   //Owner refused. A normal get also waits for the object to appear
+                                   launchGet(spot, key, expected_ldo_user_bytes);
+                                 }
+                               });
+  opbox::LaunchOp(op);
 }
 
 /**
@@ -247,7 +320,7 @@ rc_t DHTPool::Want(const Key &key, size_t expected_ldo_user_bytes, const fn_want
  */
 rc_t DHTPool::Need(const Key &key, size_t expected_ldo_user_bytes, lunasa::DataObject *returned_ldo){
 
-  dbg("Need (size="+to_string(expected_ldo_user_bytes)+") key "+key.str());
+  F_LOG_DBG("Need (size="+to_string(expected_ldo_user_bytes)+") key "+key.str());
 
   std::promise<bool> found_promise;
   std::future<bool> found_future = found_promise.get_future();
@@ -291,7 +364,7 @@ rc_t DHTPool::Need(const Key &key, size_t expected_ldo_user_bytes, lunasa::DataO
  * @retval KELPIE_EINVAL The function name was not known at the object
  */
 rc_t DHTPool::Compute(const Key &key, const std::string &function_name, const std::string &function_args, const fn_compute_callback_t &callback) {
-  dbg("Compute function "+function_name+" for key "+key.str());
+  F_LOG_DBG("Compute function "+function_name+" for key "+key.str());
   F_ASSERT(!key.IsRowWildcard(), "Requested a key with a row wildcard. Only column wildcards are supported");
 
   //Figure out which node in our list gets the spot
@@ -308,7 +381,7 @@ rc_t DHTPool::Compute(const Key &key, const std::string &function_name, const st
 
   //Node lives elsewhere - start an op to dispatch it
   auto *op = new OpKelpieCompute(
-            nodes[spot].first, nodes[spot].second,
+            nodes[spot].first, getPeer(spot),
             default_bucket,
             key,
             iom_hash,
@@ -321,6 +394,43 @@ rc_t DHTPool::Compute(const Key &key, const std::string &function_name, const st
   return KELPIE_OK;
 }
 
+/**
+ * @brief Perform an atomic op on the node that owns an object (NonBlocking Version)
+ * @param[in] key The Key that references a single int64 object
+ * @param[in] op The atomic operation to perform
+ * @param[in] operand Value to add, or the new value for a swap
+ * @param[in] compare Value the object must hold for a swap
+ * @param[in] callback A callback to execute when the result is returned
+ * @retval KELPIE_OK Operation dispatched properly
+ * @note Atomics only touch the owner's memory. They are not written to the pool's IOM
+ */
+rc_t DHTPool::Atomic(const Key &key, AtomicOp op, int64_t operand, int64_t compare, const fn_atomic_callback_t &callback) {
+  F_LOG_DBG("Atomic "+atomicop_to_string(op)+" for key "+key.str());
+  F_ASSERT(!key.IsWildcard(), "Atomic ops require a fully-specified key");
+
+  //Figure out which node in our list gets the spot
+  uint32_t spot = findNodeIndex(key);
+
+  //See if this item belongs here, we don't send anything
+  if(nodes[spot].first == my_nodeid) {
+    int64_t old_value = 0;
+    rc_t rc = lkv->atomic(default_bucket, key, op, operand, compare, &old_value);
+    callback(rc, key, old_value);
+    return KELPIE_OK; //Always launch ok.. real result is handed back in callback
+  }
+
+  //Node lives elsewhere - start an op to dispatch it
+  auto *op_atomic = new OpKelpieAtomic(
+            nodes[spot].first, getPeer(spot),
+            default_bucket,
+            key,
+            op, operand, compare,
+            callback);
+  opbox::LaunchOp(op_atomic);
+
+  return KELPIE_OK;
+}
+
 /**
  * @brief Get info about a particular key/blob. Does not wait for blob to be generated
  * @param[in] key The Key label for the blob
@@ -331,7 +441,7 @@ rc_t DHTPool::Compute(const Key &key, const std::string &function_name, const st
  */
 rc_t DHTPool::Info(const Key &key, object_info_t *info){
 
-  dbg("Info for key "+key.str());
+  F_LOG_DBG("Info for key "+key.str());
 
   //Check local first. Only issue request if we aren't already waiting
   rc_t rc = lkv->getInfo(default_bucket, key, info);
@@ -357,7 +467,7 @@ rc_t DHTPool::Info(const Key &key, object_info_t *info){
 
   //Hosting node is somewhere else. Launch a new op to get the info
   opbox::LaunchOp( new OpKelpieMeta(DirectFlags::CMD_GET_COLINFO,
-                              nodes[spot].first, nodes[spot].second,
+                              nodes[spot].first, getPeer(spot),
                               default_bucket, key,
                               iom_hash,
                               [info, &got_result, &found_promise, &rc](rc_t result, object_info_t &new_info) {
@@ -390,7 +500,7 @@ rc_t DHTPool::Info(const Key &key, object_info_t *info){
  */
 rc_t DHTPool::RowInfo(const Key &key, object_info_t *info) {
 
-  dbg("RowInfo for key "+key.str());
+  F_LOG_DBG("RowInfo for key "+key.str());
 
   //Check local first. Only issue request if we aren't already waiting
   rc_t rc = lkv->getInfo(default_bucket, key, info);
@@ -411,7 +521,7 @@ rc_t DHTPool::RowInfo(const Key &key, object_info_t *info) {
 
   //Hosting node is somewhere else. Launch a new op to get the info
   opbox::LaunchOp( new OpKelpieMeta(DirectFlags::CMD_GET_ROWINFO,
-                                    nodes[spot].first, nodes[spot].second,
+                                    nodes[spot].first, getPeer(spot),
                                     default_bucket, key,
                                     iom_hash,
                                     [info, &got_result, &found_promise, &rc](rc_t result, object_info_t &new_info) {
@@ -445,7 +555,16 @@ rc_t DHTPool::RowInfo(const Key &key, object_info_t *info) {
  */
 rc_t DHTPool::Drop(const Key &key, fn_drop_callback_t callback) {
 
-  dbg("Drop key "+key.str());
+  F_LOG_DBG("Drop key "+key.str());
+
+  //Forget leases on anything being dropped. The owner revokes them too
+  if(use_leases) {
+    lock_guard<mutex> lock(lease_mutex);
+    for(auto key_lease = leases.begin(); key_lease != leases.end(); ) {
+      if(key_lease->first.Matches(key)) key_lease = leases.erase(key_lease);
+      else                              ++key_lease;
+    }
+  }
 
   //Check here first if caching
   rc_t rc_local = KELPIE_ENOENT;
@@ -463,10 +582,12 @@ rc_t DHTPool::Drop(const Key &key, fn_drop_callback_t callback) {
     } else {
       //Single external node
       needs_external_search=true;
-      tmp_nodes.push_back(nodes[spot]);
+      tmp_nodes.push_back(pair<nodeid_t, net::peer_ptr_t>(nodes[spot].first, getPeer(spot)));
     }
   } else {
     //Row Wildcard. Build a list of external nodes to check
+    connectAllPeers();
+    lock_guard<mutex> lock(peer_mutex);
     for(auto &node_peer : nodes) {
       if (node_peer.first == my_nodeid) needs_local_search=true;
       else {
@@ -476,14 +597,14 @@ rc_t DHTPool::Drop(const Key &key, fn_drop_callback_t callback) {
     }
   }
 
-  dbg("DHT-DROP: needs_local "+to_string(needs_local_search)+" needs_external "+to_string(needs_external_search)+ " num_targets: "+to_string(tmp_nodes.size()));
+  F_LOG_DBG("DHT-DROP: needs_local "+to_string(needs_local_search)+" needs_external "+to_string(needs_external_search)+ " num_targets: "+to_string(tmp_nodes.size()));
 
   //Actually do the local version
   if(needs_local_search) {
     rc_local = lkv->drop(default_bucket, key);
   }
 
-  dbg("DHT-DROP: Cleared local, found was "+to_string(rc_local==KELPIE_OK)+", now working on remote");
+  F_LOG_DBG("DHT-DROP: Cleared local, found was "+to_string(rc_local==KELPIE_OK)+", now working on remote");
 
   //See if we need to launch to external nodes
   if(needs_external_search) {
@@ -507,7 +628,7 @@ rc_t DHTPool::Drop(const Key &key, fn_drop_callback_t callback) {
  */
 rc_t DHTPool::List(const kelpie::Key &search_key, ObjectCapacities *object_capacities) {
 
-  dbg("List key "+search_key.str());
+  F_LOG_DBG("List key "+search_key.str());
 
   bool needs_local_search=false;
   bool needs_external_search=false;
@@ -522,10 +643,12 @@ rc_t DHTPool::List(const kelpie::Key &search_key, ObjectCapacities *object_capac
     } else {
       //Single external node
       needs_external_search=true;
-      tmp_nodes.push_back(nodes[spot]);
+      tmp_nodes.push_back(pair<nodeid_t, net::peer_ptr_t>(nodes[spot].first, getPeer(spot)));
     }
   } else {
     //Row Wildcard. Build a list of external nodes to check
+    connectAllPeers();
+    lock_guard<mutex> lock(peer_mutex);
     for(auto &node_peer : nodes) {
       if (node_peer.first == my_nodeid) needs_local_search=true;
       else {
@@ -569,10 +692,66 @@ int DHTPool::FindTargetNode(const Key &key, faodel::nodeid_t *node_id, net::peer
   if(nodes.empty()) return 0;
   uint32_t spot = findNodeIndex(key);
   if(node_id)  *node_id  = nodes[spot].first;
-  if(peer_ptr) *peer_ptr = nodes[spot].second;
+  if(peer_ptr) *peer_ptr = getPeer(spot);
   return 1;  //Always lives on one of these nodes
 }
 
+/**
+ * @brief Get the peer for a node in the pool, connecting to it if this is the first use
+ * @param spot The index of the node in the DHT array
+ * @return The node's peer
+ * @throw std::runtime_error if the node could not be reached
+ */
+net::peer_ptr_t DHTPool::getPeer(uint32_t spot) {
+  {
+    lock_guard<mutex> lock(peer_mutex);
+    if(nodes[spot].second != nullptr) return nodes[spot].second;
+  }
+
+  //Connect without the lock so other nodes can be reached in parallel. Net
+  //handles two threads connecting to the same node at the same time.
+  net::peer_ptr_t peer;
+  int rc = net::Connect(&peer, nodes[spot].first);
+  if(rc!=0) {
+    throw std::runtime_error("Pool "+TypeName()+" could not connect to peer "+dir_info.members[spot].name);
+  }
+
+  lock_guard<mutex> lock(peer_mutex);
+  nodes[spot].second = peer;
+  return peer;
+}
+
+/**
+ * @brief Connect to every external node that has not been used yet, doing the handshakes concurrently
+ * @throw std::runtime_error if any node could not be reached
+ */
+void DHTPool::connectAllPeers() {
+
+  vector<uint32_t> spots;
+  vector<nodeid_t> missing;
+  {
+    lock_guard<mutex> lock(peer_mutex);
+    for(uint32_t i=0; i<nodes.size(); i++) {
+      if((nodes[i].second == nullptr) && (nodes[i].first != my_nodeid)) {
+        spots.push_back(i);
+        missing.push_back(nodes[i].first);
+      }
+    }
+  }
+  if(missing.empty()) return;
+
+  vector<net::peer_ptr_t> peers;
+  int rc = net::Connect(&peers, missing);
+  if(rc!=0) {
+    throw std::runtime_error("Pool "+TypeName()+" could not connect to all of its peers");
+  }
+
+  lock_guard<mutex> lock(peer_mutex);
+  for(size_t i=0; i<spots.size(); i++) {
+    nodes[spots[i]].second = peers[i];
+  }
+}
+
 /**
  * @brief Determine the index of the DHT list that owns the data
  * @param key The Key label for the blob (only ROW portion used)
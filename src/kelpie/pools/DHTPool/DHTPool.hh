@@ -10,6 +10,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 
 #include "faodel-common/Common.hh"
@@ -17,6 +18,7 @@
 #include "opbox/net/net.hh"
 
 #include "kelpie/Key.hh"
+#include "kelpie/localkv/LeaseTable.hh"
 #include "kelpie/localkv/LocalKV.hh"
 #include "kelpie/common/Types.hh"
 #include "kelpie/pools/Pool.hh"
@@ -37,6 +39,19 @@ namespace kelpie {
  *
  * A DHTPool with only one node functions as a way to do direct communication.
  *
+ * Nodes are not connected when the pool is created. Each node is connected
+ * the first time an operation needs it, so opening a handle to a large pool
+ * does not pay for a connection to every member up front.
+ *
+ * A pool opened with the lease=true url option reads remote objects through
+ * leases. The first read of an object asks its owner for a lease. Later reads
+ * use the lease to pull the object with one-sided gets, so the owner's op
+ * engine is not involved. The owner revokes the lease when the object is
+ * dropped or overwritten, and the next read asks for a new lease. Only use
+ * leases for objects that are not modified in place after publication. Leases
+ * pay off when reads are not cached locally (no ReadToLocal in the behavior),
+ * because every read of an object then goes back to its owner.
+ *
  * It is important to understand that only the row portion of the key is
  * used in the location hash. Users may use this trait in a positive way to
  * force a number of releate items to be pushed to the same DHT node (eg, use
@@ -60,6 +75,7 @@ public:
   rc_t Need(const Key &key, size_t expected_ldo_user_bytes, lunasa::DataObject *returned_ldo) override;  //Block until get
 
   rc_t Compute(const Key &key, const std::string &function_name, const std::string &function_args, const fn_compute_callback_t &callback) override; //Async compute
+  rc_t Atomic(const Key &key, AtomicOp op, int64_t operand, int64_t compare, const fn_atomic_callback_t &callback) override; //Async atomic op
 
   rc_t Info(const Key &key, object_info_t *col_info) override;
   rc_t RowInfo(const Key &key, object_info_t *row_info) override;
@@ -74,10 +90,21 @@ public:
   void sstr(std::stringstream &ss, int depth, int indent) const override;
 
 protected:
-  std::vector<std::pair<faodel::nodeid_t, net::peer_ptr_t>> nodes;
+  std::vector<std::pair<faodel::nodeid_t, net::peer_ptr_t>> nodes; //Peers are connected on first use
+  std::mutex peer_mutex; //Guards the peers in nodes
 
   virtual uint32_t findNodeIndex(const Key &key);
 
+  net::peer_ptr_t getPeer(uint32_t spot);
+  void connectAllPeers();
+
+  bool use_leases;                                  //Read remote objects through leases
+  std::mutex lease_mutex;                           //Guards leases
+  std::map<Key, object_lease_t> leases;             //Leases from earlier reads
+
+  void launchGet(uint32_t spot, const Key &key, size_t expected_ldo_user_bytes);
+  void launchLeaseRead(uint32_t spot, const Key &key, size_t expected_ldo_user_bytes);
+
 };  //DHTPool
 
 
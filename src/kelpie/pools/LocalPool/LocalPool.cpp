@@ -65,7 +65,7 @@ rc_t LocalPool::Publish(const Key &key, const fn_publish_callback_t &callback){
   object_info_t info;
   lunasa::DataObject ldo;
 
-  dbg("Publish (from lkv) bucket "+default_bucket.GetHex()+" key "+key.str());
+  F_LOG_DBG("Publish (from lkv) bucket "+default_bucket.GetHex()+" key "+key.str());
 
   //Get the ldo
   rc_t rc = lkv->get(default_bucket, key, &ldo, &info );
@@ -95,7 +95,7 @@ rc_t LocalPool::Publish(const Key &key,
   object_info_t info;
   rc_t rc = KELPIE_OK;
 
-  dbg("Publish ldo for bucket "+default_bucket.GetHex()+" key "+key.str());
+  F_LOG_DBG("Publish ldo for bucket "+default_bucket.GetHex()+" key "+key.str());
 
   //Default to putting in the lkv
   rc = lkv->put(default_bucket, key, user_ldo, behavior_flags, iom, &info);
@@ -115,7 +115,7 @@ rc_t LocalPool::Publish(const Key &key,
  */
 rc_t LocalPool::Want(const Key &key, size_t expected_ldo_user_bytes, const fn_want_callback_t &callback) {
 
-  dbg("Want (size="+to_string(expected_ldo_user_bytes)+") key "+key.str());
+  F_LOG_DBG("Want (size="+to_string(expected_ldo_user_bytes)+") key "+key.str());
 
   int rc = lkv->wantLocal(default_bucket, key, false, callback);
 
@@ -142,12 +142,12 @@ rc_t LocalPool::Want(const Key &key, size_t expected_ldo_user_bytes, const fn_wa
  */
 rc_t LocalPool::Need(const Key &key, size_t expected_ldo_user_bytes, lunasa::DataObject *returned_ldo){
 
-  dbg("Key is "+key.str()+" return ldo count is "+to_string(returned_ldo->internal_use_only.GetRefCount())+" expected size "+to_string(expected_ldo_user_bytes));
+  F_LOG_DBG("Key is "+key.str()+" return ldo count is "+to_string(returned_ldo->internal_use_only.GetRefCount())+" expected size "+to_string(expected_ldo_user_bytes));
   F_ASSERT(returned_ldo != nullptr, "User must provide an LDO");
   F_ASSERT(returned_ldo->internal_use_only.GetRefCount() == 0, "User gave an preallocated LDO to Need. Refusing to overwrite it");
 
 
-  dbg("Need (size="+to_string(expected_ldo_user_bytes)+") key "+key.str());
+  F_LOG_DBG("Need (size="+to_string(expected_ldo_user_bytes)+") key "+key.str());
 
   //TODO: Redo and use depends to wakeup
   //Hack: keep polling until someone notifies us
@@ -184,7 +184,7 @@ rc_t LocalPool::Need(const Key &key, size_t expected_ldo_user_bytes, lunasa::Dat
 
 rc_t LocalPool::Compute(const Key &key, const std::string &function_name, const std::string &function_args,
                         const fn_compute_callback_t &callback) {
-  dbg("Key is "+key.str()+" function is "+function_name);
+  F_LOG_DBG("Key is "+key.str()+" function is "+function_name);
   lunasa::DataObject ext_ldo;
   rc_t rc = lkv->doCompute(function_name, function_args, default_bucket, key,  &ext_ldo);
   callback(rc, key, ext_ldo);
@@ -192,6 +192,16 @@ rc_t LocalPool::Compute(const Key &key, const std::string &function_name, const
   return KELPIE_OK;
 }
 
+rc_t LocalPool::Atomic(const Key &key, AtomicOp op, int64_t operand, int64_t compare,
+                       const fn_atomic_callback_t &callback) {
+  F_LOG_DBG("Key is "+key.str()+" op is "+atomicop_to_string(op));
+  int64_t old_value = 0;
+  rc_t rc = lkv->atomic(default_bucket, key, op, operand, compare, &old_value);
+  callback(rc, key, old_value);
+
+  return KELPIE_OK;
+}
+
 /**
  * @brief Get info about a particular key/blob. Does not wait for blob to be generated
  * @param key The Key label for the blob
@@ -202,7 +212,7 @@ rc_t LocalPool::Compute(const Key &key, const std::string &function_name, const
  */
 rc_t LocalPool::Info(const Key &key, object_info_t *info) {
 
-  dbg("Info for key "+key.str());
+  F_LOG_DBG("Info for key "+key.str());
 
 
   rc_t rc = lkv->getInfo(default_bucket, key, info);
@@ -225,7 +235,7 @@ rc_t LocalPool::Info(const Key &key, object_info_t *info) {
  */
 rc_t LocalPool::RowInfo(const Key &key, object_info_t *info) {
 
-  dbg("RowInfo for key "+key.str());
+  F_LOG_DBG("RowInfo for key "+key.str());
 
   //TODO: add disk check for row info
   return lkv->getInfo(default_bucket, key, info);
@@ -239,7 +249,7 @@ rc_t LocalPool::RowInfo(const Key &key, object_info_t *info) {
  * @note This does not affect the IOM
  */
 rc_t LocalPool::Drop(const Key &key, fn_drop_callback_t callback){
-  dbg("Drop key "+key.str());
+  F_LOG_DBG("Drop key "+key.str());
 
   //Don't delete from disk
   rc_t rc = lkv->drop(default_bucket, key);
@@ -255,7 +265,7 @@ rc_t LocalPool::Drop(const Key &key, fn_drop_callback_t callback){
  * @retval KELPIE_ENOENT Did not find matches
  */
 rc_t LocalPool::List(const kelpie::Key &search_key, ObjectCapacities *object_capacities) {
-  dbg("List key "+search_key.str());
+  F_LOG_DBG("List key "+search_key.str());
 
   return lkv->list(default_bucket, search_key, iom, object_capacities);
 }
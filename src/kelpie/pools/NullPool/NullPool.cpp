@@ -140,6 +140,21 @@ rc_t NullPool::Compute(const Key &key, const std::string &function_name, const s
   return KELPIE_OK;
 }
 
+/**
+ * @brief Perform an atomic op on an object's owner (NonBlocking Version)
+ * @param[in] key The Key that references a single int64 object
+ * @param[in] op The atomic operation to perform
+ * @param[in] operand Value to add, or the new value for a swap
+ * @param[in] compare Value the object must hold for a swap
+ * @param[in] callback A callback to execute when the result is returned (answer is always KELPIE_ENOENT and 0)
+ * @retval KELPIE_OK Operation dispatched properly and completed correctly
+ */
+rc_t NullPool::Atomic(const Key &key, AtomicOp op, int64_t operand, int64_t compare, const fn_atomic_callback_t &callback) {
+  dbg("Key is "+key.str()+" op is "+atomicop_to_string(op));
+  callback(KELPIE_ENOENT, key, 0);
+  return KELPIE_OK;
+}
+
 /**
  * @brief Get info about a particular key/blob. Does not wait for blob to be generated
  * @param key The Key label for the blob
@@ -46,6 +46,7 @@ public:
   rc_t Need(const Key &key, size_t expected_ldo_user_bytes, lunasa::DataObject *returned_ldo) override;  //Block until get
 
   rc_t Compute(const Key &key, const std::string &function_name, const std::string &function_args, const fn_compute_callback_t &callback) override; //Async compute
+  rc_t Atomic(const Key &key, AtomicOp op, int64_t operand, int64_t compare, const fn_atomic_callback_t &callback) override; //Async atomic op
 
   rc_t Info(const Key &key, object_info_t *col_info) override;
   rc_t RowInfo(const Key &key, object_info_t *row_info) override;
@@ -135,6 +135,69 @@ rc_t Pool::Publish(const Key &key, const lunasa::DataObject &user_ldo, object_in
   return rc2;
 }
 
+/**
+ * @brief Perform an atomic op on a small object at the node that owns it (NonBlocking Version)
+ * @param[in] key The Key that references a single int64 object (wildcards are not supported)
+ * @param[in] op The atomic operation to perform
+ * @param[in] operand Value to add, or the new value for a swap
+ * @param[in] compare Value the object must hold for a swap
+ * @param[in] callback A callback that receives the result and the object's old value
+ * @retval KELPIE_OK The request was successfully launched (failures may happen in callback)
+ * @throw runtime_error if the key contains a wildcard
+ */
+rc_t Pool::Atomic(const Key &key, AtomicOp op, int64_t operand, int64_t compare, const fn_atomic_callback_t &callback) {
+  if(key.IsWildcard()) {
+    throw std::runtime_error("Kelpie Atomic called with wildcard key "+key.str());
+  }
+  return impl->Atomic(key, op, operand, compare, callback);
+}
+
+/**
+ * @brief Add a value to an int64 object at its owner and get the value it held before (Blocking Version)
+ * @param[in] key The Key that references a single int64 object. A missing object starts at zero
+ * @param[in] delta The value to add (use 0 to read the current value)
+ * @param[out] old_value The object's value before the add
+ * @retval KELPIE_OK The add was applied
+ * @retval KELPIE_EINVAL The object exists but is not a single int64
+ */
+rc_t Pool::AtomicAdd(const Key &key, int64_t delta, int64_t *old_value) {
+  rc_t rc1, rc2;
+  atomic<int> num_left(1);
+  rc1 = Atomic(key, AtomicOp::Add, delta, 0,
+               [&num_left, &rc2, &old_value](kelpie::rc_t result, Key key, int64_t value) {
+                   rc2 = result;
+                   if(old_value) *old_value = value;
+                   num_left--;
+               });
+  if(rc1!=KELPIE_OK) return rc1;
+  while(num_left) { std::this_thread::yield(); }
+  return rc2;
+}
+
+/**
+ * @brief Replace an int64 object at its owner if it holds an expected value (Blocking Version)
+ * @param[in] key The Key that references a single int64 object. A missing object reads as zero
+ * @param[in] expected The value the object must hold for the swap to happen
+ * @param[in] desired The value to store when the object holds the expected value
+ * @param[out] old_value The object's value before the op (the current value on a mismatch)
+ * @retval KELPIE_OK The swap was applied
+ * @retval KELPIE_RECHECK The object did not hold the expected value and was not changed
+ * @retval KELPIE_EINVAL The object exists but is not a single int64
+ */
+rc_t Pool::CompareAndSwap(const Key &key, int64_t expected, int64_t desired, int64_t *old_value) {
+  rc_t rc1, rc2;
+  atomic<int> num_left(1);
+  rc1 = Atomic(key, AtomicOp::CompareAndSwap, desired, expected,
+               [&num_left, &rc2, &old_value](kelpie::rc_t result, Key key, int64_t value) {
+                   rc2 = result;
+                   if(old_value) *old_value = value;
+                   num_left--;
+               });
+  if(rc1!=KELPIE_OK) return rc1;
+  while(num_left) { std::this_thread::yield(); }
+  return rc2;
+}
+
 /**
  * @brief Asynchronously publish an object to the pool
  * @param[in] key A global Key for referencing the blob
@@ -64,6 +64,10 @@ public:
   rc_t Compute(const Key &key, const std::string &function_name, const std::string &function_args, ResultCollector &collector);               //Async compute w/ ResultCollector
   rc_t Compute(const Key &key, const std::string &function_name, const std::string &function_args, lunasa::DataObject *returned_ldo=nullptr); //Blocking compute
 
+  rc_t Atomic(const Key &key, AtomicOp op, int64_t operand, int64_t compare, const fn_atomic_callback_t &callback); //Async atomic op
+  rc_t AtomicAdd(const Key &key, int64_t delta, int64_t *old_value=nullptr);                                      //Blocking fetch-and-add
+  rc_t CompareAndSwap(const Key &key, int64_t expected, int64_t desired, int64_t *old_value=nullptr);             //Blocking compare-and-swap
+
   rc_t Info(const Key &key, object_info_t *info);
   rc_t RowInfo(const Key &key, object_info_t *info);
 
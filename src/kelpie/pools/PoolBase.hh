@@ -55,6 +55,8 @@ public:
 
   virtual rc_t Compute(const Key &key, const std::string &function_name, const std::string &function_args, const fn_compute_callback_t &callback) = 0;                                  //Async compute
 
+  virtual rc_t Atomic(const Key &key, AtomicOp op, int64_t operand, int64_t compare, const fn_atomic_callback_t &callback) = 0; //Async atomic op on the owner
+
   virtual rc_t Info(const Key &key,  object_info_t *col_info) = 0;
   virtual rc_t RowInfo(const Key &key,  object_info_t *row_info) = 0;
 
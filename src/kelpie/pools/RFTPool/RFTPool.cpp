@@ -10,7 +10,10 @@
 #include <iostream>
 #include <thread>
 
+#include "faodelConfig.h"
+#ifdef Faodel_ENABLE_MPI_SUPPORT
 #include <mpi.h>
+#endif
 
 #include "faodel-common/Common.hh"
 #include "faodel-common/Debug.hh"
@@ -33,7 +36,10 @@ RFTPool::RFTPool(const ResourceURL &pool_url)
 
   string intended_rank = pool_url.GetOption("rank");
   if(intended_rank.empty()) {
+    mpi_rank = 0;
+    #ifdef Faodel_ENABLE_MPI_SUPPORT
     MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    #endif
   } else {
     mpi_rank = std::stoi(intended_rank, nullptr, 0);
   }
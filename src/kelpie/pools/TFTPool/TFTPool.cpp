@@ -10,7 +10,10 @@
 #include <iostream>
 #include <thread>
 
+#include "faodelConfig.h"
+#ifdef Faodel_ENABLE_MPI_SUPPORT
 #include <mpi.h>
+#endif
 
 #include "faodel-common/Common.hh"
 #include "faodel-common/Debug.hh"
@@ -111,6 +111,16 @@ rc_t TracePool::Compute(const Key &key, const std::string &function_name, const
   return next_pool.Compute(key, function_name, function_args, callback);
 }
 
+rc_t TracePool::Atomic(const Key &key, AtomicOp op, int64_t operand, int64_t compare, const fn_atomic_callback_t &callback) {
+  stringstream ss;
+  ss<<key.str_as_args()
+    <<" -O "<<atomicop_to_string(op)
+    <<" -V "<<operand
+    <<" -C "<<compare<<endl;
+  appendTrace("katomic", ss.str());
+  return next_pool.Atomic(key, op, operand, compare, callback);
+}
+
 rc_t TracePool::Info(const Key &key, object_info_t *info) {
 
   appendTrace("kinfo", key.str_as_args());
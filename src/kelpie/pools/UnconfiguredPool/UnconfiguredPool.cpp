@@ -33,6 +33,8 @@ rc_t UnconfiguredPool::Need(const Key &key, size_t expected_ldo_user_bytes,
 rc_t UnconfiguredPool::Compute(const Key &key, const std::string &function_name,
                                const std::string &function_args,
                                const fn_compute_callback_t &callback)                     { Panic("Compute"); return KELPIE_OK;}
+rc_t UnconfiguredPool::Atomic(const Key &key, AtomicOp op, int64_t operand, int64_t compare,
+                              const fn_atomic_callback_t &callback)                       { Panic("Atomic");  return KELPIE_OK; }
 rc_t UnconfiguredPool::Info(const Key &key, object_info_t *col_info)                      { Panic("Info");    return KELPIE_OK; }
 rc_t UnconfiguredPool::RowInfo(const Key &key, object_info_t *row_info)                   { Panic("RowInfo"); return KELPIE_OK; }
 rc_t UnconfiguredPool::Drop(const Key &key, fn_drop_callback_t callback)                  { Panic("Drop");    return KELPIE_OK; }
@@ -34,9 +34,47 @@ DataObjectPacker::DataObjectPacker(const vector<std::string> &names,
     throw std::runtime_error("DataObjectPacker given vectors of different sizes");
   }
 
-  if((dop_format_version<1) || (dop_format_version>2))
+  if((dop_format_version<1) || (dop_format_version>3))
     throw std::runtime_error("DataObjectPacker constructed with an invalid format version number");
 
+  if(version==3) {
+    //Version 3 keeps a sorted index in the meta section and only aligned data in the data section
+    uint32_t meta_size = metaSizeV3(names.size());
+    size_t payload_size=0;
+    for(size_t i=0; i<names.size(); i++) {
+      payload_size += computeEntrySize(names[i], bytes[i]);
+    }
+    ldo = DataObject(meta_size, payload_size, memory_type, DataObjectPacker::object_type_id);
+
+    auto *meta = ldo.GetMetaPtr<dop_meta_v3_t *>();
+    meta->base.num_vars = names.size();
+    meta->base.packing_version = version;
+    meta->base.data_type_hash = data_type_hash;
+    meta->max_vars = names.size();
+
+    auto *payload = ldo.GetDataPtr<uint8_t *>();
+    uint32_t offset=0;
+    for(size_t i=0; i<names.size(); i++) {
+      uint32_t entry_size = computeEntrySize(names[i], bytes[i]);
+      if((!using_null_ptrs) && (ptrs[i])) memcpy(payload+offset, ptrs[i], bytes[i]);
+      memset(payload+offset+bytes[i], 0, entry_size-bytes[i]); //Don't ship stale memory in the padding
+      meta->index[i].hash = faodel::hash32(names[i]);
+      meta->index[i].data_offset = offset;
+      meta->index[i].data_length = bytes[i];
+      meta->index[i].data_type = types[i];
+      offset += entry_size;
+    }
+    std::sort(meta->index, meta->index + names.size(),
+              [](const dop_index_v3_t &a, const dop_index_v3_t &b) { return a.hash < b.hash; });
+
+    //Lookups only see the hash, so a repeated name (or a colliding one) could never be retrieved
+    auto *dup = std::adjacent_find(meta->index, meta->index + names.size(),
+                                   [](const dop_index_v3_t &a, const dop_index_v3_t &b) { return a.hash == b.hash; });
+    if(dup != meta->index + names.size())
+      throw std::runtime_error("DataObjectPacker version 3 given duplicate (or hash-colliding) variable names");
+    return;
+  }
+
   //Figure out how much space we'll need
   size_t payload_size=0;
   for(int i=0; i<names.size(); i++) {
@@ -68,14 +106,26 @@ DataObjectPacker::DataObjectPacker(const vector<std::string> &names,
  * @param[in] data_type_hash A user tag for this data (eg hash("MyParticleData)")
  * @param[in] dop_format_version Which version of the packer to use
  * @param[in] memory_type The Lunasa memory allocation strategy
+ * @param[in] max_vars How many variables can be appended (version 3 only, where the index is preallocated)
  */
 DataObjectPacker::DataObjectPacker(size_t max_data_capacity, uint32_t data_type_hash, int dop_format_version,
-                                   DataObject::AllocatorType memory_type)
+                                   DataObject::AllocatorType memory_type, uint32_t max_vars)
   : finalized(false), version(dop_format_version) {
 
-  if((dop_format_version<1) || (dop_format_version>2))
+  if((dop_format_version<1) || (dop_format_version>3))
     throw std::runtime_error("DataObjectPacker constructed with an invalid format version number");
 
+  if(version==3) {
+    uint32_t meta_size = metaSizeV3(max_vars);
+    ldo = DataObject(meta_size + max_data_capacity, meta_size, 0, memory_type, DataObjectPacker::object_type_id);
+
+    auto *meta = ldo.GetMetaPtr<dop_meta_v3_t *>();
+    meta->base.num_vars = 0;
+    meta->base.packing_version = dop_format_version;
+    meta->base.data_type_hash = data_type_hash;
+    meta->max_vars = max_vars;
+    return;
+  }
 
   ldo = DataObject(sizeof(dop_meta_t) + max_data_capacity, sizeof(dop_meta_t), 0, memory_type, DataObjectPacker::object_type_id);
 
@@ -97,11 +147,24 @@ DataObjectPacker::DataObjectPacker(const lunasa::DataObject &ldo)
   if(ldo.GetTypeID() != DataObjectPacker::object_type_id) {
     throw std::runtime_error("DataObjectPacker asked to parse a DataObject that does not match its TypeID");
   }
+  if(ldo.GetMetaSize() < sizeof(dop_meta_t)) {
+    throw std::runtime_error("DataObjectPacker asked to parse a DataObject with a truncated meta section");
+  }
   auto *meta = ldo.GetMetaPtr<dop_meta_t *>();
   version = meta->packing_version;
-  if((version < 1) || (version >2))
+  if((version < 1) || (version >3))
     throw std::runtime_error("DataObjectPacker asked to parse DataObject with invalid packing version number");
 
+  //Version 3 lookups binary search the index in the meta section, so make sure it's all there
+  if(version==3) {
+    auto *meta3 = ldo.GetMetaPtr<dop_meta_v3_t *>();
+    if((ldo.GetMetaSize() < sizeof(dop_meta_v3_t)) ||
+       (meta3->base.num_vars > meta3->max_vars) ||
+       (ldo.GetMetaSize() < sizeof(dop_meta_v3_t) + uint64_t(meta3->base.num_vars)*sizeof(dop_index_v3_t))) {
+      throw std::runtime_error("DataObjectPacker asked to parse a version 3 DataObject whose index does not fit in its meta section");
+    }
+  }
+
 }
 
 /**
@@ -129,17 +192,33 @@ size_t DataObjectPacker::ComputeEntrySize(int dop_format_version, const string &
   switch(dop_format_version) {
     case 1: return sizeof(dop_entry_v1_t) + std::min(name.size(), size_t(255)) + data_bytes;
     case 2: return sizeof(dop_entry_v2_t) + data_bytes;
+    case 3: return roundupV3(data_bytes); //Overhead is in the meta section's index
     default:
       throw std::runtime_error("Attempted to pack with unknown version number: "+std::to_string(dop_format_version));
   }
 }
 
+/**
+ * @brief Determine how big a version 3 meta section needs to be for an index with max_vars slots
+ * @param[in] max_vars Number of index slots
+ * @return MetaSize Bytes for the meta section, rounded up so data starts on an aligned boundary
+ */
+uint32_t DataObjectPacker::metaSizeV3(uint32_t max_vars) {
+  uint64_t size = sizeof(dop_meta_v3_t) + uint64_t(max_vars)*sizeof(dop_index_v3_t);
+  size = (size + v3_alignment - 1) & ~uint64_t(v3_alignment - 1);
+  if(size > 0xFFFF)
+    throw std::runtime_error("DataObjectPacker version 3 index cannot hold "+std::to_string(max_vars)+" variables");
+  return static_cast<uint32_t>(size);
+}
+
 /**
  * @brief Determine how much space is left in this allocation for additional variables
  * @return bytes Raw space left (note: user must take into account Entry Overhead!)
  */
 uint32_t DataObjectPacker::RemainingCapacity() {
   if(finalized) return 0;
+  if((version==3) && (ldo.GetMetaPtr<dop_meta_v3_t *>()->base.num_vars >= ldo.GetMetaPtr<dop_meta_v3_t *>()->max_vars))
+    return 0; //Index is full
 
   uint32_t dspace_left = ldo.GetUserCapacity() - (ldo.GetMetaSize() + ldo.GetDataSize());
   if(dspace_left < getEntryOverhead()) return 0;
@@ -154,25 +233,40 @@ uint32_t DataObjectPacker::RemainingCapacity() {
  * @param[in] data_bytes How many bytes of data there are for this variable
  * @param[in] type The data type ID a user has assigned to this variable
  * @retval 0 Success: Variable was appended successfully
- * @retval -1 Failure: Either the object is finalized or there wasn't enough capacity left for the data
+ * @retval -1 Failure: Either the object is finalized, there wasn't enough capacity left for the data, or
+ *             (version 3 only) the name is already in the index
  * @note: This function is only for GenericPackers allocated using the max capacity ctor
- * @note: This function does not check to see if you inserted the same variable name multiple times
+ * @note: Versions 1 and 2 do not check to see if you inserted the same variable name multiple times
  */
 int DataObjectPacker::AppendVariable(const string &name, void *data_ptr, size_t data_bytes, uint8_t type) {
 
   //Bail out if we don't allow modifications
   if(finalized) return -1;
 
+  //Version 3 has a fixed number of index slots, and can only look up one entry per hash
+  if(version==3) {
+    if(ldo.GetMetaPtr<dop_meta_v3_t *>()->base.num_vars >= ldo.GetMetaPtr<dop_meta_v3_t *>()->max_vars)
+      return -1;
+    if(findV3(faodel::hash32(name), nullptr, nullptr, nullptr) == 0)
+      return -1;
+  }
+
   //Figure out how big this is and where it goes
   size_t entry_size = computeEntrySize(name, data_bytes);
   uint32_t offset = ldo.GetDataSize();
 
   //Try to adjust the data size. Exit if no room left
-  int rc = ldo.ModifyUserSizes(sizeof(dop_meta_t), offset + entry_size);
+  int rc = ldo.ModifyUserSizes(ldo.GetMetaSize(), offset + entry_size);
   if(rc < 0) return -1; //No capacity left, ldo did not update
 
   auto *entry_ptr = ldo.GetDataPtr<uint8_t *>() + offset;
-  writeEntry(entry_ptr, name, type, data_ptr, data_bytes);
+  if(version==3) {
+    if(data_ptr) memcpy(entry_ptr, data_ptr, data_bytes);
+    memset(entry_ptr+data_bytes, 0, entry_size-data_bytes);
+    insertIndexV3(faodel::hash32(name), offset, data_bytes, type);
+  } else {
+    writeEntry(entry_ptr, name, type, data_ptr, data_bytes);
+  }
 
   //Update the metadata
   auto *meta = ldo.GetMetaPtr<dop_meta_t *>();
@@ -199,6 +293,7 @@ int DataObjectPacker::GetVarPointer(const std::string &name, void **raw_ptr_to_d
   switch(version){
     case 1: hash = faodel::hash16(name); break;
     case 2: hash = faodel::hash32(name); break;
+    case 3: return findV3(faodel::hash32(name), raw_ptr_to_data, bytes, type);
   }
 
   //Second, build the index if we haven't already done so
@@ -254,6 +349,7 @@ int DataObjectPacker::GetVarPointer(const std::string &name, void **raw_ptr_to_d
 int DataObjectPacker::GetVarPointer(uint32_t hash, void **raw_ptr_to_data, size_t *bytes, uint8_t *type) {
 
   //Version 1 only has a 16b hash and is therefore not suitable. Bail out
+  if(version==3) return findV3(hash, raw_ptr_to_data, bytes, type);
   if(version!=2) return EINVAL;
 
   //First, build the index if we haven't already done so
@@ -284,6 +380,55 @@ int DataObjectPacker::GetVarPointer(uint32_t hash, void **raw_ptr_to_data, size_
 
 
 
+/**
+ * @brief Binary search the version 3 index for a hash
+ * @param[in] hash The hash of the variable name to be retrieved
+ * @param[out] raw_ptr_to_data Pointer to the variable's data inside the DataObject
+ * @param[out] bytes How many bytes of data there are for this variable
+ * @param[out] type The data type ID users assigned to this variable
+ * @retval 0 Found
+ * @retval ENOENT Item not found
+ */
+int DataObjectPacker::findV3(uint32_t hash, void **raw_ptr_to_data, size_t *bytes, uint8_t *type) {
+
+  auto *meta = ldo.GetMetaPtr<dop_meta_v3_t *>();
+  auto *end = meta->index + meta->base.num_vars;
+  auto *entry = std::lower_bound(meta->index, end, hash,
+                                 [](const dop_index_v3_t &e, uint32_t h) { return e.hash < h; });
+
+  if((entry == end) || (entry->hash != hash)) {
+    if(raw_ptr_to_data) *raw_ptr_to_data = nullptr;
+    if(bytes) *bytes=0;
+    if(type) *type=0;
+    return ENOENT;
+  }
+  if(uint64_t(entry->data_offset) + entry->data_length > ldo.GetDataSize()) {
+    throw std::runtime_error("DataObjectPacker index entry exceeds boundaries for DataObject");
+  }
+  if(raw_ptr_to_data) *raw_ptr_to_data = ldo.GetDataPtr<uint8_t *>() + entry->data_offset;
+  if(bytes) *bytes = entry->data_length;
+  if(type) *type = entry->data_type;
+  return 0;
+}
+
+/**
+ * @brief Add an entry to the version 3 index, keeping it sorted by hash
+ * @note Caller must make sure the hash is not already in the index, and updates num_vars
+ */
+void DataObjectPacker::insertIndexV3(uint32_t hash, uint32_t data_offset, uint32_t data_length, uint8_t type) {
+
+  auto *meta = ldo.GetMetaPtr<dop_meta_v3_t *>();
+  auto *end = meta->index + meta->base.num_vars;
+  auto *spot = std::upper_bound(meta->index, end, hash,
+                                [](uint32_t h, const dop_index_v3_t &e) { return h < e.hash; });
+  memmove(spot+1, spot, (end-spot)*sizeof(dop_index_v3_t));
+  memset(spot, 0, sizeof(dop_index_v3_t));
+  spot->hash = hash;
+  spot->data_offset = data_offset;
+  spot->data_length = data_length;
+  spot->data_type = type;
+}
+
 /**
  * @brief Get a list of all (truncated) variable names from a DataObject, when using version 1 format
  * @param[out] names All of the truncated names
@@ -372,6 +517,7 @@ size_t DataObjectPacker::getEntryOverhead() {
   switch(version) {
     case 1: return sizeof(dop_entry_v1_t);
     case 2: return sizeof(dop_entry_v2_t);
+    case 3: return 0;
   }
   throw std::runtime_error("Unknown GeneralPacker format version");
 }
@@ -13,6 +13,43 @@
 
 namespace lunasa {
 
+/**
+ * @brief A typed, non-owning view of an array that lives inside a DataObject
+ *
+ * This is what DataObjectPacker::GetArray() returns. The view points directly at
+ * the packed data, so it is only valid while the packer's DataObject is alive.
+ */
+template<typename T>
+class DataObjectArray {
+public:
+  DataObjectArray() : ptr(nullptr), num_items(0) {}
+  DataObjectArray(T *ptr, size_t num_items) : ptr(ptr), num_items(num_items) {}
+
+  T *data() const { return ptr; }
+  size_t size() const { return num_items; }
+  bool empty() const { return num_items==0; }
+  T *begin() const { return ptr; }
+  T *end() const { return ptr+num_items; }
+  T &operator[](size_t i) const { return ptr[i]; }
+
+private:
+  T *ptr;
+  size_t num_items;
+};
+
+/**
+ * @brief Packs a collection of named variables into a single DataObject
+ *
+ * Three packing formats are available:
+ *  - Version 1: Each entry holds the (truncated) name. Lookups build an index on first use
+ *  - Version 2: Each entry holds a 32b hash of the name. Lookups build an index on first use
+ *  - Version 3: The meta section holds a sorted index of name hashes, so lookups are a binary
+ *               search with no index to build when an object is opened. Each variable's data
+ *               starts 64B after the previous one, measured from the start of the user section
+ *               (GetMetaPtr()). Lunasa does not align the user section itself, so the absolute
+ *               addresses are not 64B aligned: use unaligned loads when vectorizing. Use
+ *               GetArray<T>() to read a variable in place.
+ */
 class DataObjectPacker {
 
 public:
@@ -27,7 +64,8 @@ public:
   DataObjectPacker(size_t                         max_data_capacity,
                    uint32_t                       data_type_hash,
                    int                            dop_format_version=1,
-                   DataObject::AllocatorType      memory_type = DataObject::AllocatorType::eager);
+                   DataObject::AllocatorType      memory_type = DataObject::AllocatorType::eager,
+                   uint32_t                       max_vars = default_max_vars);
 
   explicit DataObjectPacker(const DataObject &ldo);
 
@@ -47,11 +85,30 @@ public:
 
   int GetVarNames(std::vector<std::string> *names);
 
+  /**
+   * @brief Get a typed view of a variable's data, without copying it
+   * @param[in] name The name of the variable
+   * @return View of the data (empty if not found, or if the size is not a multiple of sizeof(T))
+   * @note Any format version works. Version 3 places the data at a 64B offset from the user
+   *       section, but the pointer itself is only as aligned as the allocator made the object
+   */
+  template<typename T>
+  DataObjectArray<T> GetArray(const std::string &name) {
+    void *ptr;
+    size_t bytes;
+    if((GetVarPointer(name, &ptr, &bytes, nullptr) != 0) || (bytes % sizeof(T) != 0))
+      return DataObjectArray<T>();
+    return DataObjectArray<T>(static_cast<T *>(ptr), bytes/sizeof(T));
+  }
+
   DataObject GetDataObject();
 
   const static uint16_t object_type_id;
   const static std::string  object_type_name;
 
+  const static uint32_t default_max_vars = 64;  //!< Index slots reserved by the capacity ctor (version 3 only)
+  const static uint32_t v3_alignment = 64;      //!< Alignment of each variable's data offset (from the user section) in version 3
+
 private:
 
   struct dop_meta_t {
@@ -90,6 +147,24 @@ private:
     uint8_t * GetDataPtr() { return &data[0]; }
   };
 
+  //Version 3: The index lives in the meta section and the data section only holds aligned data
+  struct dop_index_v3_t {
+    uint32_t hash;         //!< hash32 of the variable's name. Index is sorted on this
+    uint32_t data_offset;  //!< Where the data starts in the data section
+    uint32_t data_length;
+    uint8_t  data_type;
+    uint8_t  pad[3];
+  };
+  struct dop_meta_v3_t {
+    dop_meta_t     base;
+    uint32_t       max_vars;  //!< Number of index slots in the meta section
+    dop_index_v3_t index[0];
+  };
+  static uint32_t metaSizeV3(uint32_t max_vars);
+  static uint32_t roundupV3(uint32_t size) { return (size + v3_alignment - 1) & ~(v3_alignment - 1); }
+  int findV3(uint32_t hash, void **raw_ptr_to_data, size_t *bytes, uint8_t *type);
+  void insertIndexV3(uint32_t hash, uint32_t data_offset, uint32_t data_length, uint8_t type);
+
 
 
   bool finalized;  //!< Prevent user from appending new variables
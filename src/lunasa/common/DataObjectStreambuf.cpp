@@ -0,0 +1,138 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#include <cstring>
+#include <limits>
+
+#include "lunasa/common/DataObjectStreambuf.hh"
+
+using namespace std;
+
+namespace lunasa {
+
+/**
+ * @brief Create an output streambuf backed by a new eager LDO
+ * @param[in] initial_data_capacity How many bytes of data to allocate up front
+ * @param[in] meta_size Size of the meta section to reserve in the LDO (left for the caller to fill in)
+ * @param[in] type_id The type id to assign to the LDO
+ */
+DataObjectOutputStreambuf::DataObjectOutputStreambuf(uint32_t initial_data_capacity,
+                                                     uint16_t meta_size,
+                                                     dataobject_type_t type_id)
+  : meta_size(meta_size), type_id(type_id), bytes_copied(0), num_grows(0) {
+
+  if(initial_data_capacity==0) initial_data_capacity = 1;
+  ldo = DataObject(meta_size + initial_data_capacity, meta_size, 0,
+                   DataObject::AllocatorType::eager, type_id);
+  auto *start = ldo.GetDataPtr<char *>();
+  setp(start, start + initial_data_capacity);
+}
+
+/**
+ * @brief Set the LDO's data size to the number of bytes written and hand it to the caller
+ * @retval ldo The LDO holding the serialized data
+ * @note The streambuf has no LDO afterwards, so further writes fail
+ */
+DataObject DataObjectOutputStreambuf::Finish() {
+  if(ldo.isNull()) return ldo;
+  ldo.ModifyUserSizes(meta_size, GetBytesWritten());
+  DataObject result = ldo;
+  ldo = DataObject();
+  setp(nullptr, nullptr);
+  return result;
+}
+
+/**
+ * @brief Replace the LDO with one that holds at least min_data_capacity bytes of data
+ * @param[in] min_data_capacity The smallest data capacity that will satisfy the pending write
+ * @retval true The LDO was replaced and the put area now points into it
+ * @retval false No LDO (already finished) or the request exceeds what an LDO can hold
+ */
+bool DataObjectOutputStreambuf::grow(uint64_t min_data_capacity) {
+
+  if(ldo.isNull()) return false;
+
+  const uint64_t max_data_capacity = numeric_limits<uint32_t>::max() - meta_size;
+  if(min_data_capacity > max_data_capacity) return false;
+
+  uint64_t new_capacity = 2 * static_cast<uint64_t>(epptr() - pbase());
+  if(new_capacity < min_data_capacity) new_capacity = min_data_capacity;
+  if(new_capacity > max_data_capacity) new_capacity = max_data_capacity;
+
+  uint32_t used = GetBytesWritten();
+  DataObject new_ldo(static_cast<uint32_t>(meta_size + new_capacity), meta_size, 0,
+                     DataObject::AllocatorType::eager, type_id);
+  if(meta_size) memcpy(new_ldo.GetMetaPtr(), ldo.GetMetaPtr(), meta_size);
+  memcpy(new_ldo.GetDataPtr(), ldo.GetDataPtr(), used);
+  bytes_copied += used;
+  num_grows++;
+
+  ldo = new_ldo;
+  auto *start = ldo.GetDataPtr<char *>();
+  setp(start, start + new_capacity);
+  advance(used);
+  return true;
+}
+
+/// @brief Move the put pointer forward (pbump only takes an int)
+void DataObjectOutputStreambuf::advance(uint64_t num_bytes) {
+  while(num_bytes > static_cast<uint64_t>(numeric_limits<int>::max())) {
+    pbump(numeric_limits<int>::max());
+    num_bytes -= numeric_limits<int>::max();
+  }
+  pbump(static_cast<int>(num_bytes));
+}
+
+DataObjectOutputStreambuf::int_type DataObjectOutputStreambuf::overflow(int_type ch) {
+  if(traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+  if(!grow(static_cast<uint64_t>(GetBytesWritten()) + 1)) return traits_type::eof();
+  *pptr() = traits_type::to_char_type(ch);
+  pbump(1);
+  return ch;
+}
+
+std::streamsize DataObjectOutputStreambuf::xsputn(const char *s, std::streamsize n) {
+  if(n <= 0) return 0;
+  if(n > (epptr() - pptr())) {
+    if(!grow(static_cast<uint64_t>(GetBytesWritten()) + n)) return 0;
+  }
+  memcpy(pptr(), s, n);
+  advance(n);
+  return n;
+}
+
+
+/**
+ * @brief Create an input streambuf that reads an LDO's data section in place
+ * @param[in] ldo The LDO to read from (a reference is held until the streambuf is destroyed)
+ */
+DataObjectInputStreambuf::DataObjectInputStreambuf(const DataObject &ldo)
+  : ldo(ldo) {
+  if(ldo.isNull()) return;
+  //The get area is never written through, it is only non-const because streambuf requires it
+  auto *start = ldo.GetDataPtr<char *>();
+  setg(start, start, start + ldo.GetDataSize());
+}
+
+DataObjectInputStreambuf::pos_type DataObjectInputStreambuf::seekoff(off_type off, std::ios_base::seekdir dir,
+                                                                   std::ios_base::openmode which) {
+  if(!(which & std::ios_base::in)) return pos_type(off_type(-1));
+  off_type base;
+  switch(dir) {
+    case std::ios_base::beg: base = 0; break;
+    case std::ios_base::cur: base = gptr() - eback(); break;
+    case std::ios_base::end: base = egptr() - eback(); break;
+    default: return pos_type(off_type(-1));
+  }
+  off_type target = base + off;
+  if((target < 0) || (target > (egptr() - eback()))) return pos_type(off_type(-1));
+  setg(eback(), eback() + target, egptr());
+  return pos_type(target);
+}
+
+DataObjectInputStreambuf::pos_type DataObjectInputStreambuf::seekpos(pos_type pos, std::ios_base::openmode which) {
+  return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+} // namespace lunasa
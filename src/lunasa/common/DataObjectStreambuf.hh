@@ -0,0 +1,79 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#ifndef LUNASA_DATAOBJECTSTREAMBUF_HH
+#define LUNASA_DATAOBJECTSTREAMBUF_HH
+
+#include <cstdint>
+#include <streambuf>
+
+#include "lunasa/DataObject.hh"
+
+namespace lunasa {
+
+/**
+ * @brief A streambuf that serializes straight into the data section of an LDO
+ *
+ * Serialization libraries (Boost, Cereal) write to a std::ostream. Wrapping this
+ * streambuf in an ostream lets them write directly into an eager LDO instead of
+ * building a std::string that must then be copied into an LDO. When the LDO fills,
+ * a new one with twice the capacity is allocated and the data written so far is
+ * copied over, so picking a good initial capacity avoids all copies. Call Finish()
+ * when serialization is done to set the LDO's data size and take the object.
+ */
+class DataObjectOutputStreambuf : public std::streambuf {
+
+public:
+  explicit DataObjectOutputStreambuf(uint32_t initial_data_capacity=default_initial_capacity,
+                                     uint16_t meta_size=0,
+                                     dataobject_type_t type_id=0);
+  ~DataObjectOutputStreambuf() override = default;
+
+  DataObject Finish();
+
+  uint32_t GetBytesWritten() const { return static_cast<uint32_t>(pptr() - pbase()); }
+  uint64_t GetBytesCopied() const { return bytes_copied; } //!< Bytes moved when the LDO had to grow
+  uint32_t GetNumGrows() const { return num_grows; }       //!< Times the LDO had to grow
+
+  static const uint32_t default_initial_capacity = 4096;
+
+protected:
+  int_type overflow(int_type ch) override;
+  std::streamsize xsputn(const char *s, std::streamsize n) override;
+
+private:
+  bool grow(uint64_t min_data_capacity);
+  void advance(uint64_t num_bytes);
+
+  DataObject ldo;
+  uint16_t meta_size;
+  dataobject_type_t type_id;
+  uint64_t bytes_copied;
+  uint32_t num_grows;
+};
+
+/**
+ * @brief A read-only streambuf that deserializes straight from the data section of an LDO
+ *
+ * The stream reads the LDO's memory in place, so unpacking does not need a copy of
+ * the data in a std::string. The streambuf holds a reference to the LDO while it is
+ * in use.
+ */
+class DataObjectInputStreambuf : public std::streambuf {
+
+public:
+  explicit DataObjectInputStreambuf(const DataObject &ldo);
+  ~DataObjectInputStreambuf() override = default;
+
+protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+  DataObject ldo;
+};
+
+} // namespace lunasa
+
+#endif //LUNASA_DATAOBJECTSTREAMBUF_HH
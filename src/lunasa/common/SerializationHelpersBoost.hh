@@ -0,0 +1,52 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#ifndef LUNASA_SERIALIZATION_HELPERS_BOOST_HH
+#define LUNASA_SERIALIZATION_HELPERS_BOOST_HH
+
+// These are the LDO versions of faodel::BoostPack()/BoostUnpack(). Instead
+// of going through a std::string, the archive writes straight into an LDO
+// and reads straight out of an LDO's data section. See
+// faodel-common/SerializationHelpersBoost.hh for how to make a class
+// serializable.
+
+#include <istream>
+#include <ostream>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+
+#include "lunasa/DataObject.hh"
+#include "lunasa/common/DataObjectStreambuf.hh"
+
+namespace lunasa {
+
+template<typename T>
+DataObject BoostPackToLDO(const T &t1,
+                          uint32_t initial_data_capacity=DataObjectOutputStreambuf::default_initial_capacity,
+                          dataobject_type_t type_id=0) {
+  DataObjectOutputStreambuf buf(initial_data_capacity, 0, type_id);
+  std::ostream astream(&buf);
+  { //<--Important, put archive in {} to finalize last write at end
+    boost::archive::binary_oarchive archive(astream); //Binary archive
+    archive & t1;
+  }
+  return buf.Finish();
+}
+
+template<typename T>
+T BoostUnpackFromLDO(const DataObject &ldo) {
+  T t1;
+  DataObjectInputStreambuf buf(ldo);
+  std::istream astream(&buf);
+  {
+    boost::archive::binary_iarchive archive(astream);
+    archive & t1;
+  }
+  return t1;
+}
+
+} // namespace lunasa
+
+#endif // LUNASA_SERIALIZATION_HELPERS_BOOST_HH
@@ -0,0 +1,49 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#ifndef LUNASA_SERIALIZATION_HELPERS_CEREAL_HH
+#define LUNASA_SERIALIZATION_HELPERS_CEREAL_HH
+
+// These are the LDO versions of faodel::CerealPack()/CerealUnpack(). They
+// are kept apart from the Boost helpers for the same reason as in
+// faodel-common: cereal is not installed with faodel.
+
+#include <istream>
+#include <ostream>
+
+#include <cereal/archives/binary.hpp>
+
+#include "lunasa/DataObject.hh"
+#include "lunasa/common/DataObjectStreambuf.hh"
+
+namespace lunasa {
+
+template<class T>
+DataObject CerealPackToLDO(const T &t1,
+                           uint32_t initial_data_capacity=DataObjectOutputStreambuf::default_initial_capacity,
+                           dataobject_type_t type_id=0) {
+  DataObjectOutputStreambuf buf(initial_data_capacity, 0, type_id);
+  std::ostream ss(&buf);
+  { //<--Important, put archive in {} to finalize last write at end
+    cereal::BinaryOutputArchive oarchive(ss); //Binary archive
+    oarchive(t1);
+  }
+  return buf.Finish();
+}
+
+template<class T>
+T CerealUnpackFromLDO(const DataObject &ldo) {
+  T t1;
+  DataObjectInputStreambuf buf(ldo);
+  std::istream astream(&buf);
+  {
+    cereal::BinaryInputArchive iarchive(astream);
+    iarchive(t1);
+  }
+  return t1;
+}
+
+} // namespace lunasa
+
+#endif //LUNASA_SERIALIZATION_HELPERS_CEREAL_HH
@@ -308,6 +308,32 @@ NNTI_result_t NNTI_eq_wait(
 }
 
 
+/**
+ * @brief Wait for one or more events to arrive on an event queue.
+ */
+extern "C"
+NNTI_result_t NNTI_eq_wait_many(
+        NNTI_event_queue_t  eq,
+        NNTI_event_t       *events,
+        const uint32_t      max,
+        const int           timeout,
+        uint32_t           *count)
+{
+    NNTI_result_t rc=NNTI_OK;
+
+    nnti::transports::transport *t = ((nnti::datatype::nnti_datatype *)eq)->transport();
+
+    rc = t->eq_wait_many(
+            eq,
+            events,
+            max,
+            timeout,
+            count);
+
+    return(rc);
+}
+
+
 /**
  * @brief Retrieves the next message from the unexpected list.
  */
@@ -917,11 +943,13 @@ static void setup_logging(void)
     char                logfile[1024];
     sbl::severity_level severity = sbl::severity_level::error;
     bool                include_ffl = false;
+    uint32_t            async_entries = 0;
 
     const char *log_filename = getenv("NNTI_LOG_FILENAME");
     const char *log_fileper  = getenv("NNTI_LOG_FILEPER");
     const char *log_level    = getenv("NNTI_LOG_LEVEL");
     const char *log_ffl      = getenv("NNTI_LOG_FFL");
+    const char *log_async    = getenv("NNTI_LOG_ASYNC");
 
     if (log_level) {
         if (!strcasecmp(log_level, "FATAL") || !strcmp(log_level, "5")) {
@@ -943,6 +971,15 @@ static void setup_logging(void)
         }
     }
 
+    // NNTI_LOG_ASYNC is TRUE/1 for the default ring size or the number of ring entries
+    if (log_async) {
+        if (!strcasecmp(log_async, "TRUE") || !strcmp(log_async, "1")) {
+            async_entries = sbl::async_stream::default_ring_entries;
+        } else {
+            async_entries = strtoul(log_async, nullptr, 10);
+        }
+    }
+
     if (log_filename) {
         if (log_fileper != nullptr && (!strcasecmp(log_fileper, "TRUE") || !strcmp(log_fileper, "1"))) {
             int mypid = getpid();
@@ -950,8 +987,16 @@ static void setup_logging(void)
         } else {
             strcpy(logfile, log_filename);
         }
-        nnti::core::logger::init(logfile, include_ffl, severity);
+        if (async_entries > 0) {
+            nnti::core::logger::init(logfile, include_ffl, severity, async_entries);
+        } else {
+            nnti::core::logger::init(logfile, include_ffl, severity);
+        }
     } else {
-        nnti::core::logger::init(include_ffl, severity);
+        if (async_entries > 0) {
+            nnti::core::logger::init(include_ffl, severity, async_entries);
+        } else {
+            nnti::core::logger::init(include_ffl, severity);
+        }
     }
 }
@@ -160,6 +160,26 @@ NNTI_result_t NNTI_eq_wait(
     uint32_t           *which,
     NNTI_event_t       *event);
 
+/**
+ * @brief Wait for one or more events to arrive on an event queue.
+ *
+ * Returns as many events as are already queued, up to max, or waits up
+ * to timeout milliseconds for the first one to arrive.
+ *
+ * \param[in]  eq       The event queue to wait on.
+ * \param[out] events   An array of at least max events.
+ * \param[in]  max      The most events to return.
+ * \param[in]  timeout  The amount of time (in milliseconds) to wait.
+ * \param[out] count    The number of events returned.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t NNTI_eq_wait_many(
+    NNTI_event_queue_t  eq,
+    NNTI_event_t       *events,
+    const uint32_t      max,
+    const int           timeout,
+    uint32_t           *count);
+
 /**
  * @brief Retrieves the next message from the unexpected list.
  *
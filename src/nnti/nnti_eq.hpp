@@ -305,6 +305,28 @@ public:
     {
         return notification_pipe_[0];
     }
+    /*
+     * Read up to count notifications without blocking.  The mpi progress
+     * thread notifies once per batch of events (see flush_notifications()),
+     * so there can be fewer notifications than events and this may read
+     * fewer than count.  Reading too many or too few is harmless: waiters
+     * pop everything already queued before polling the pipe, each push is
+     * eventually followed by a notify(), and a notification that finds
+     * the queue empty is dropped and the wait goes on.
+     */
+    void
+    consume_notifications(uint64_t count)
+    {
+        uint32_t dummy[64];
+        while (count > 0) {
+            uint64_t n = (count < 64) ? count : 64;
+            ssize_t bytes_read = read(notification_pipe_[0], dummy, n*4);
+            if (bytes_read <= 0) {
+                break;
+            }
+            count -= (bytes_read / 4);
+        }
+    }
 
 
 
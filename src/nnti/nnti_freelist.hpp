@@ -19,7 +19,12 @@
 
 #include <fcntl.h>
 
+#include <algorithm>
 #include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <boost/lockfree/stack.hpp>
 #include <boost/lockfree/queue.hpp>
@@ -33,22 +38,206 @@
 namespace nnti  {
 namespace core {
 
+/*
+ * A freelist shared by every thread of a transport.
+ *
+ * When magazine_size is not zero, each thread keeps a private magazine
+ * of up to 2*magazine_size items in front of the shared lists.  pop()
+ * and push() only use the magazine until it runs empty or fills up.
+ * Then magazine_size items move to or from a mutex protected depot in
+ * one step, so the depot lock is taken once per magazine_size items
+ * instead of once per item.  The lockfree stack is not used in this mode.
+ * An atomic count of the items in the magazines and the depot keeps the
+ * freelist bounded by size, so push() still fails when it is full.
+ */
 template <typename _Tp>
 class nnti_freelist {
 private:
+    struct magazine {
+        nnti_freelist         *owner;    // nullptr after the freelist is destroyed
+        std::vector<_Tp>       items;
+        std::atomic<uint64_t>  hits;     // pop()s served from items
+        std::atomic<uint64_t>  misses;   // pop()s that had to refill items
+
+        magazine(nnti_freelist *o)
+        : owner(o),
+          hits(0),
+          misses(0)
+        {
+            return;
+        }
+    };
+
+    /*
+     * The magazines of one thread, keyed by freelist id.  ids are never
+     * reused, so a magazine left behind by a destroyed freelist can never
+     * be mistaken for a magazine of a new one.
+     */
+    struct thread_cache {
+        uint64_t                                  last_id  = 0;
+        magazine                                 *last_mag = nullptr;
+        std::unordered_map< uint64_t, magazine* > mags;
+
+        ~thread_cache()
+        {
+            // give this thread's items back to the freelists that are still around
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            for (auto &m : mags) {
+                if (m.second->owner != nullptr) {
+                    m.second->owner->retire(m.second);
+                }
+                delete m.second;
+            }
+        }
+    };
+
     const uint64_t                                                   stack_size_;
     boost::lockfree::stack<_Tp, boost::lockfree::fixed_sized<true>>  stack_;
 
+    const uint64_t                  magazine_size_;
+    const uint64_t                  id_;
+
+    std::mutex                      depot_mutex_;
+    std::vector<std::vector<_Tp>>   depot_;            // batches of magazine_size_ items
+    std::atomic<uint64_t>           count_;            // items in the magazines and the depot
+
+    std::vector<magazine*>          magazines_;        // protected by registry_mutex()
+    uint64_t                        retired_hits_;     // protected by registry_mutex()
+    uint64_t                        retired_misses_;   // protected by registry_mutex()
+
+    static std::mutex &
+    registry_mutex(void)
+    {
+        static std::mutex m;
+        return m;
+    }
+    static uint64_t
+    next_id(void)
+    {
+        static std::atomic<uint64_t> id(1);
+        return id.fetch_add(1);
+    }
+    static thread_cache &
+    my_cache(void)
+    {
+        static thread_local thread_cache c;
+        return c;
+    }
+
+    magazine *
+    find_magazine(void)
+    {
+        thread_cache &c = my_cache();
+        if (c.last_id == id_) {
+            return c.last_mag;
+        }
+        auto iter = c.mags.find(id_);
+        if (iter == c.mags.end()) {
+            return nullptr;
+        }
+        c.last_id  = id_;
+        c.last_mag = iter->second;
+        return iter->second;
+    }
+    magazine *
+    my_magazine(void)
+    {
+        magazine *m = find_magazine();
+        if (m != nullptr) {
+            return m;
+        }
+
+        // first time this thread has used this freelist
+        thread_cache &c = my_cache();
+        m = new magazine(this);
+        m->items.reserve(2*magazine_size_);
+
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        for (auto iter = c.mags.begin(); iter != c.mags.end(); ) {
+            if (iter->second->owner == nullptr) {
+                delete iter->second;
+                iter = c.mags.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+        magazines_.push_back(m);
+        c.mags[id_] = m;
+        c.last_id   = id_;
+        c.last_mag  = m;
+
+        return m;
+    }
+
+    // move the oldest magazine_size_ items into the depot
+    void
+    flush(magazine *m)
+    {
+        std::vector<_Tp> batch(m->items.begin(), m->items.begin()+magazine_size_);
+        m->items.erase(m->items.begin(), m->items.begin()+magazine_size_);
+
+        std::lock_guard<std::mutex> lock(depot_mutex_);
+        depot_.push_back(std::move(batch));
+    }
+    // fill an empty magazine from the depot
+    void
+    refill(magazine *m)
+    {
+        std::lock_guard<std::mutex> lock(depot_mutex_);
+        if (!depot_.empty()) {
+            m->items.insert(m->items.end(), depot_.back().begin(), depot_.back().end());
+            depot_.pop_back();
+        }
+    }
+    // caller holds registry_mutex()
+    void
+    retire(magazine *m)
+    {
+        if (!m->items.empty()) {
+            std::lock_guard<std::mutex> lock(depot_mutex_);
+            depot_.push_back(std::move(m->items));
+            m->items.clear();
+        }
+        retired_hits_   += m->hits.load();
+        retired_misses_ += m->misses.load();
+        magazines_.erase(std::remove(magazines_.begin(), magazines_.end(), m), magazines_.end());
+    }
+
+    // only the owning thread writes the counters, so skip the locked increment
+    static void
+    count(std::atomic<uint64_t> &counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed)+1, std::memory_order_relaxed);
+    }
+
 public:
     nnti_freelist(
         uint64_t size)
+        : nnti_freelist(size, 0)
+    {
+        return;
+    }
+    nnti_freelist(
+        uint64_t size,
+        uint64_t magazine_size)
         : stack_size_(size),
-          stack_(size)
+          stack_(size),
+          magazine_size_(magazine_size),
+          id_(next_id()),
+          count_(0),
+          retired_hits_(0),
+          retired_misses_(0)
     {
         return;
     }
     virtual ~nnti_freelist()
     {
+        // items still cached by other threads are not reachable from here.
+        // call reclaim() first to get them back.
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        for (auto m : magazines_) {
+            m->owner = nullptr;
+        }
     }
 
     bool
@@ -56,28 +245,114 @@ public:
         _Tp &t)
     {
         log_debug("nnti_freelist", "pushing (stack_=%x)", &stack_);
-        return stack_.push(t);
+        if (magazine_size_ == 0) {
+            return stack_.push(t);
+        }
+
+        // full.  the caller keeps the item.
+        if (count_.fetch_add(1, std::memory_order_relaxed) >= stack_size_) {
+            count_.fetch_sub(1, std::memory_order_relaxed);
+            log_debug("nnti_freelist", "push fail (stack_=%x)", &stack_);
+            return false;
+        }
+
+        magazine *m = my_magazine();
+        if (m->items.size() >= 2*magazine_size_) {
+            flush(m);
+        }
+        m->items.push_back(t);
+        return true;
     }
 
     bool
     pop(
         _Tp &t)
     {
-        _Tp tmp;
-        if (stack_.pop(tmp)) {
-            t = tmp;
-            log_debug("nnti_freelist", "pop success (stack_=%x)", &stack_);
-            return true;
+        if (magazine_size_ == 0) {
+            _Tp tmp;
+            if (stack_.pop(tmp)) {
+                t = tmp;
+                log_debug("nnti_freelist", "pop success (stack_=%x)", &stack_);
+                return true;
+            }
+            log_debug("nnti_freelist", "pop fail (stack_=%x)", &stack_);
+            return false;
+        }
+
+        magazine *m = my_magazine();
+        if (m->items.empty()) {
+            count(m->misses);
+            refill(m);
+            if (m->items.empty()) {
+                log_debug("nnti_freelist", "pop fail (stack_=%x)", &stack_);
+                return false;
+            }
+        } else {
+            count(m->hits);
         }
-        log_debug("nnti_freelist", "pop fail (stack_=%x)", &stack_);
-        return false;
+        t = m->items.back();
+        m->items.pop_back();
+        count_.fetch_sub(1, std::memory_order_relaxed);
+        log_debug("nnti_freelist", "pop success (stack_=%x)", &stack_);
+        return true;
     }
 
     bool
     empty(void)
     {
+        if (magazine_size_ != 0) {
+            magazine *m = find_magazine();
+            if ((m != nullptr) && !m->items.empty()) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(depot_mutex_);
+            if (!depot_.empty()) {
+                return false;
+            }
+        }
         return stack_.empty();
     }
+
+    /*
+     * Move the items cached by every thread into the depot, so that
+     * pop() on this thread can reach all of them.  The other threads must
+     * not be using the freelist, so only call this at teardown.
+     */
+    void
+    reclaim(void)
+    {
+        std::lock_guard<std::mutex> registry_lock(registry_mutex());
+        std::lock_guard<std::mutex> depot_lock(depot_mutex_);
+        for (auto m : magazines_) {
+            if (!m->items.empty()) {
+                depot_.push_back(std::move(m->items));
+                m->items.clear();
+            }
+        }
+    }
+
+    uint64_t
+    magazine_size(void) const
+    {
+        return magazine_size_;
+    }
+    /*
+     * Sum the magazine counters of every thread, including threads that
+     * have exited.  The counts of running threads are approximate.
+     */
+    void
+    cache_stats(
+        uint64_t &hits,
+        uint64_t &misses)
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        hits   = retired_hits_;
+        misses = retired_misses_;
+        for (auto m : magazines_) {
+            hits   += m->hits.load(std::memory_order_relaxed);
+            misses += m->misses.load(std::memory_order_relaxed);
+        }
+    }
 };
 
 } /* namespace datatype */
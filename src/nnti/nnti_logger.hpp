@@ -117,6 +117,30 @@ public:
         }
     }
 
+    static void
+    init(
+        const bool                include_ffl,
+        const sbl::severity_level severity,
+        const uint32_t            async_ring_entries)
+    {
+        if (sbl_logger == nullptr) {
+            sbl_logger             = new sbl::logger(severity, async_ring_entries);
+            include_file_func_line = include_ffl;
+        }
+    }
+    static void
+    init(
+        const std::string         filename,
+        const bool                include_ffl,
+        const sbl::severity_level severity,
+        const uint32_t            async_ring_entries)
+    {
+        if (sbl_logger == nullptr) {
+            sbl_logger             = new sbl::logger(filename, severity, async_ring_entries);
+            include_file_func_line = include_ffl;
+        }
+    }
+
     static void
     fini()
     {
@@ -34,7 +34,7 @@
 /**
  * @brief The number of transport mechanisms supported by NNTI.
  */
-#define NNTI_TRANSPORT_COUNT 4
+#define NNTI_TRANSPORT_COUNT 5
 
 
 /********** Enumerations **********/
@@ -66,7 +66,10 @@ enum NNTI_transport_id_t {
     NNTI_TRANSPORT_UGNI,
 
     /** @brief Use MPI to transfer rpc requests. */
-    NNTI_TRANSPORT_MPI
+    NNTI_TRANSPORT_MPI,
+
+    /** @brief Use TCP sockets to transfer rpc requests. */
+    NNTI_TRANSPORT_SOCKETS
 };
 typedef enum NNTI_transport_id_t NNTI_transport_id_t;
 
@@ -76,6 +79,8 @@ typedef enum NNTI_transport_id_t NNTI_transport_id_t;
 #define NNTI_DEFAULT_TRANSPORT NNTI_TRANSPORT_UGNI
 #elif defined(NNTI_BUILD_MPI)
 #define NNTI_DEFAULT_TRANSPORT NNTI_TRANSPORT_MPI
+#elif defined(NNTI_BUILD_SOCKETS)
+#define NNTI_DEFAULT_TRANSPORT NNTI_TRANSPORT_SOCKETS
 #else
 #define NNTI_DEFAULT_TRANSPORT NNTI_TRANSPORT_NULL
 #endif
@@ -123,6 +123,28 @@ struct NNTI_mpi_process_p_t {
 };
 
 
+/***********  Sockets Process Types  ***********/
+
+/**
+ * @brief Remote process identifier for the sockets transport.
+ *
+ * The <tt>\ref NNTI_sockets_process_p_t</tt> identifies the TCP port
+ * where a process accepts data channels.
+ */
+struct NNTI_sockets_process_p_t {
+    /** @brief IPv4 address in network byte order. */
+    NNTI_ip_addr  addr;
+    /** @brief TCP port of the data channel listener in host byte order. */
+    NNTI_tcp_port port;
+
+    template<class Archive>
+    void serialize(Archive & archive)
+    {
+        archive( addr, port );
+    }
+};
+
+
 /***********  Local Process Types  ***********/
 
 /**
@@ -160,6 +182,8 @@ struct NNTI_remote_process_p_t {
         NNTI_ugni_process_p_t    ugni;
         /** @brief The MPI representation of a process on the network. */
         NNTI_mpi_process_p_t     mpi;
+        /** @brief The sockets representation of a process on the network. */
+        NNTI_sockets_process_p_t sockets;
     } NNTI_remote_process_p_t_u;
 
     template<class Archive>
@@ -183,6 +207,10 @@ struct NNTI_remote_process_p_t {
             case NNTI_TRANSPORT_MPI:
                 archive( NNTI_remote_process_p_t_u.mpi );
                 break;
+                /** @brief The sockets representation of a process on the network. */
+            case NNTI_TRANSPORT_SOCKETS:
+                archive( NNTI_remote_process_p_t_u.sockets );
+                break;
         }
     }
 };
@@ -306,11 +334,32 @@ struct NNTI_mpi_rdma_addr_p_t {
     uint64_t buf;
     /** @brief Size of the the memory buffer. */
     uint32_t size;
+    /** @brief Displacement of the buffer in the owner's RMA window.  0 if it isn't attached. */
+    uint64_t rma_disp;
 
     template<class Archive>
     void serialize(Archive & archive)
     {
-        archive( cmd_tag, get_data_tag, put_data_tag, atomic_data_tag, buf, size );
+        archive( cmd_tag, get_data_tag, put_data_tag, atomic_data_tag, buf, size, rma_disp );
+    }
+};
+
+
+/***********  Sockets RDMA Address Types  ***********/
+
+/**
+ * @brief RDMA address used for the sockets implementation.
+ */
+struct NNTI_sockets_rdma_addr_p_t {
+    /** @brief Address of the memory buffer cast to a uint64_t . */
+    uint64_t buf;
+    /** @brief Size of the the memory buffer. */
+    uint32_t size;
+
+    template<class Archive>
+    void serialize(Archive & archive)
+    {
+        archive( buf, size );
     }
 };
 
@@ -351,6 +400,8 @@ struct NNTI_remote_addr_p_t {
         NNTI_ugni_rdma_addr_p_t    ugni;
         /** @brief The MPI representation of a memory region. */
         NNTI_mpi_rdma_addr_p_t     mpi;
+        /** @brief The sockets representation of a memory region. */
+        NNTI_sockets_rdma_addr_p_t sockets;
     } NNTI_remote_addr_p_t_u;
 
     template<class Archive>
@@ -374,6 +425,10 @@ struct NNTI_remote_addr_p_t {
             case NNTI_TRANSPORT_MPI:
                 archive( NNTI_remote_addr_p_t_u.mpi );
                 break;
+                /** @brief The sockets representation of a process on the network. */
+            case NNTI_TRANSPORT_SOCKETS:
+                archive( NNTI_remote_addr_p_t_u.sockets );
+                break;
         }
     }
 };
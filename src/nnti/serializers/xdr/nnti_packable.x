@@ -99,6 +99,22 @@ struct NNTI_mpi_process_p_t {
 };
 
 
+/***********  Sockets Process Types  ***********/
+
+/**
+ * @brief Remote process identifier for the sockets transport.
+ *
+ * The <tt>\ref NNTI_sockets_process_p_t</tt> identifies the TCP port
+ * where a process accepts data channels.
+ */
+struct NNTI_sockets_process_p_t {
+    /** @brief IPv4 address in network byte order. */
+    NNTI_ip_addr  addr;
+    /** @brief TCP port of the data channel listener in host byte order. */
+    NNTI_tcp_port port;
+};
+
+
 /***********  Local Process Types  ***********/
 
 /**
@@ -131,6 +147,8 @@ union NNTI_remote_process_p_t switch (NNTI_transport_id_p_t transport_id) {
     case NNTI_TRANSPORT_UGNI:    NNTI_ugni_process_p_t    ugni;
     /** @brief The MPI representation of a process on the network. */
     case NNTI_TRANSPORT_MPI:     NNTI_mpi_process_p_t     mpi;
+    /** @brief The sockets representation of a process on the network. */
+    case NNTI_TRANSPORT_SOCKETS: NNTI_sockets_process_p_t sockets;
 };
 #else
 union NNTI_remote_process_p_t {
@@ -142,6 +160,8 @@ union NNTI_remote_process_p_t {
     NNTI_ugni_process_p_t    ugni
     /** @brief The MPI representation of a process on the network. */
     NNTI_mpi_process_p_t     mpi;
+    /** @brief The sockets representation of a process on the network. */
+    NNTI_sockets_process_p_t sockets;
 };
 #endif
 
@@ -235,6 +255,21 @@ struct NNTI_mpi_rdma_addr_p_t {
     uint64_t buf;
     /** @brief Size of the the memory buffer. */
     uint32_t size;
+    /** @brief Displacement of the buffer in the owner's RMA window.  0 if it isn't attached. */
+    uint64_t rma_disp;
+};
+
+
+/***********  Sockets RDMA Address Types  ***********/
+
+/**
+ * @brief RDMA address used for the sockets implementation.
+ */
+struct NNTI_sockets_rdma_addr_p_t {
+    /** @brief Address of the memory buffer cast to a uint64_t . */
+    uint64_t buf;
+    /** @brief Size of the the memory buffer. */
+    uint32_t size;
 };
 
 
@@ -267,6 +302,8 @@ union NNTI_remote_addr_p_t switch (NNTI_transport_id_p_t transport_id) {
     case NNTI_TRANSPORT_UGNI:    NNTI_ugni_rdma_addr_p_t    ugni;
     /** @brief The MPI representation of a memory region. */
     case NNTI_TRANSPORT_MPI:     NNTI_mpi_rdma_addr_p_t     mpi;
+    /** @brief The sockets representation of a memory region. */
+    case NNTI_TRANSPORT_SOCKETS: NNTI_sockets_rdma_addr_p_t sockets;
 };
 #else
 union NNTI_remote_addr_p_t {
@@ -278,6 +315,8 @@ union NNTI_remote_addr_p_t {
     NNTI_ugni_rdma_addr_p_t    ugni;
     /** @brief The MPI representation of a memory region. */
     NNTI_mpi_rdma_addr_p_t     mpi;
+    /** @brief The sockets representation of a memory region. */
+    NNTI_sockets_rdma_addr_p_t sockets;
 };
 #endif
 
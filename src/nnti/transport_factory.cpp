@@ -29,6 +29,12 @@
 #if (NNTI_BUILD_MPI==1)
 #include "nnti/transports/mpi/mpi_transport.hpp"
 #endif
+#if (NNTI_BUILD_SHM==1)
+#include "nnti/transports/shm/shm_transport.hpp"
+#endif
+#if (NNTI_BUILD_SOCKETS==1)
+#include "nnti/transports/sockets/sockets_transport.hpp"
+#endif
 #if (NNTI_BUILD_UGNI==1)
 #include "nnti/transports/ugni/ugni_transport.hpp"
 #endif
@@ -106,6 +112,11 @@ factory::get_instance(
                 trans_id = NNTI_TRANSPORT_IBVERBS;
             } else if (trans_name == "mpi") {
                 trans_id = NNTI_TRANSPORT_MPI;
+            } else if (trans_name == "shm") {
+                // mpi with a shared memory path to peers on the same node
+                trans_id = NNTI_TRANSPORT_MPI;
+            } else if (trans_name == "sockets") {
+                trans_id = NNTI_TRANSPORT_SOCKETS;
             } else if (trans_name == "ugni") {
                 trans_id = NNTI_TRANSPORT_UGNI;
             } else {
@@ -162,13 +173,48 @@ factory::get_instance(
         trans_id = NNTI_TRANSPORT_MPI;
 #endif
     }
-    if (trans_id == NNTI_TRANSPORT_MPI) {
-#if (NNTI_BUILD_MPI==1)
-        trans_name = "mpi";
-        proto = "mpi";
+    if (trans_id == NNTI_TRANSPORT_SOCKETS) {
+#if (NNTI_BUILD_SOCKETS==1)
+        trans_name = "sockets";
+        proto = "sockets";
         config.Set(name_key, trans_name);
         config.Set(proto_key, proto);
-        t = mpi_transport::get_instance(config);
+        t = sockets_transport::get_instance(config);
+#else
+        // sockets is not configured.  try failing back to MPI.
+        std::stringstream ss;
+        ss<<
+        "------------------------------------------------------------------\n"
+        "The FAODEL_CONFIG 'net.transport.name' key is set to 'sockets'.\n"
+        "The 'sockets' transport was not configured into the Faodel network\n"
+        "library.  The 'mpi' transport will be used instead.\n"
+        "------------------------------------------------------------------";
+        std::cerr<<ss.str()<<std::endl;
+        trans_id = NNTI_TRANSPORT_MPI;
+#endif
+    }
+    if (trans_id == NNTI_TRANSPORT_MPI) {
+#if (NNTI_BUILD_MPI==1)
+        // the id is the same for mpi and shm, so look at the name again
+        if ( (0 != config.GetLowercaseString(&trans_name, name_key2)) &&
+             (0 != config.GetLowercaseString(&trans_name, name_key))   ) {
+            trans_name = "mpi";
+        }
+#if (NNTI_BUILD_SHM==1)
+        if (trans_name == "shm") {
+            proto = "mpi";
+            config.Set(name_key, trans_name);
+            config.Set(proto_key, proto);
+            t = shm_transport::get_instance(config);
+        } else
+#endif
+        {
+            trans_name = "mpi";
+            proto = "mpi";
+            config.Set(name_key, trans_name);
+            config.Set(proto_key, proto);
+            t = mpi_transport::get_instance(config);
+        }
 #else
         // mpi is not configured.  there is no fallback.
         std::stringstream ss;
@@ -16,6 +16,9 @@
 
 #include "nnti/nntiConfig.h"
 
+#include <poll.h>
+#include <string.h>
+
 #include <chrono>
 #include <string>
 
@@ -27,6 +30,7 @@
 #include "nnti/nnti_transport.hpp"
 #include "nnti/transports/base/base_transport.hpp"
 #include "nnti/nnti_buffer.hpp"
+#include "nnti/nnti_eq.hpp"
 #include "nnti/nnti_logger.hpp"
 #include "nnti/nnti_peer.hpp"
 #include "nnti/nnti_wid.hpp"
@@ -134,6 +138,13 @@ base_transport::init_logger(
         log_level = sbl::severity_level::fatal;
     }
 
+    // an async logger moves formatting and I/O to a background thread so
+    // that debug logging doesn't stall the progress thread
+    bool     async;
+    uint64_t async_ring_entries;
+    config.GetBool(&async, "nnti.logger.async", "false");
+    config.GetUInt(&async_ring_entries, "nnti.logger.async_ring_entries", "1024");
+
     std::string logfile_str;
     rc = config.GetString(&logfile_str, "nnti.logger.filename");
     if (rc == 0) {
@@ -151,9 +162,17 @@ base_transport::init_logger(
             int mypid = getpid();
             logfile_str.replace(index, 2, std::to_string(mypid));
         }
-        nnti::core::logger::init(logfile_str, true, log_level);
+        if (async) {
+            nnti::core::logger::init(logfile_str, true, log_level, async_ring_entries);
+        } else {
+            nnti::core::logger::init(logfile_str, true, log_level);
+        }
     } else {
-        nnti::core::logger::init(true, log_level);
+        if (async) {
+            nnti::core::logger::init(true, log_level, async_ring_entries);
+        } else {
+            nnti::core::logger::init(true, log_level);
+        }
     }
 }
 
@@ -266,5 +285,102 @@ base_transport::dt_free(
     return(rc);
 }
 
+/**
+ * @brief Wait for one or more events to arrive on an event queue.
+ *
+ * \param[in]  event_freelist  Where the transport recycles popped events.
+ * \param[in]  eq_hdl          The event queue to wait on.
+ * \param[out] events          An array of at least max events.
+ * \param[in]  max             The most events to return.
+ * \param[in]  timeout         The amount of time (in milliseconds) to wait.
+ * \param[out] count           The number of events returned.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+base_transport::wait_for_events(
+    nnti::core::nnti_freelist<NNTI_event_t*> *event_freelist,
+    NNTI_event_queue_t                        eq_hdl,
+    NNTI_event_t                             *events,
+    const uint32_t                            max,
+    const int                                 timeout,
+    uint32_t                                 *count)
+{
+    int poll_rc;
+    NNTI_result_t nnti_rc = NNTI_OK;
+
+    struct pollfd poll_fd;
+
+    NNTI_event_t *e;
+
+    // stale notifications send us around the loop again, so poll() only gets what's left of timeout
+    int  remaining = timeout;
+    auto start     = std::chrono::steady_clock::now();
+
+    nnti::datatype::nnti_event_queue *eq = nnti::datatype::nnti_event_queue::to_obj(eq_hdl);
+
+    log_debug("eq_wait_many", "enter");
+
+    *count = 0;
+    if (max == 0) {
+        return NNTI_EINVAL;
+    }
+
+    poll_fd.fd     = eq->read_fd();
+    poll_fd.events = POLLIN;
+
+    while (true) {
+        // take everything that is already queued before touching the pipe
+        while ((*count < max) && eq->pop(e)) {
+            events[*count] = *e;
+            event_freelist->push(e);
+            (*count)++;
+        }
+        if (*count > 0) {
+            eq->consume_notifications(*count);
+            nnti_rc = NNTI_OK;
+            break;
+        }
+
+        if (timeout > 0) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+            remaining = (elapsed >= timeout) ? 0 : (int)(timeout - elapsed);
+        }
+        log_debug("eq_wait_many", "polling with timeout==%d", remaining);
+
+        // Test for errno==EINTR to deal with timing interrupts from HPCToolkit
+        poll_fd.revents = 0;
+        do {
+            poll_rc = poll(&poll_fd, 1, remaining);
+        } while ((poll_rc < 0) && (errno == EINTR));
+
+        if (poll_rc == 0) {
+            log_debug("eq_wait_many", "poll() timed out: poll_rc=%d", poll_rc);
+            nnti_rc = NNTI_ETIMEDOUT;
+            break;
+        } else if (poll_rc < 0) {
+            if (errno == ENOMEM) {
+                log_error("eq_wait_many", "poll() out of memory: poll_rc=%d (%s)", poll_rc, strerror(errno));
+                nnti_rc = NNTI_ENOMEM;
+            } else {
+                log_error("eq_wait_many", "poll() invalid args: poll_rc=%d (%s)", poll_rc, strerror(errno));
+                nnti_rc = NNTI_EINVAL;
+            }
+            break;
+        }
+        if (eq->pop(e)) {
+            events[(*count)++] = *e;
+            event_freelist->push(e);
+        } else {
+            // the pipe is readable but the queue is empty, so these notifications
+            // belong to events that were already popped.  drop them and wait again.
+            eq->consume_notifications(64);
+        }
+    }
+
+    log_debug("eq_wait_many", "exit (count=%u)", *count);
+
+    return nnti_rc;
+}
+
 } /* namespace transports */
 } /* namespace nnti */
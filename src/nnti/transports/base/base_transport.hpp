@@ -19,6 +19,8 @@
 #include "faodel-common/Configuration.hh"
 
 #include "nnti/nnti_transport.hpp"
+#include "nnti/nnti_logger.hpp"
+#include "nnti/nnti_freelist.hpp"
 #include "nnti/nnti_peer.hpp"
 #include "nnti/nnti_url.hpp"
 
@@ -112,6 +114,27 @@ public:
     dt_free(
         void *nnti_dt) override;
 
+protected:
+    /**
+     * @brief The body of eq_wait_many() that every transport shares.
+     *
+     * \param[in]  event_freelist  Where the transport recycles popped events.
+     * \param[in]  eq_hdl          The event queue to wait on.
+     * \param[out] events          An array of at least max events.
+     * \param[in]  max             The most events to return.
+     * \param[in]  timeout         The amount of time (in milliseconds) to wait.
+     * \param[out] count           The number of events returned.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    wait_for_events(
+        nnti::core::nnti_freelist<NNTI_event_t*> *event_freelist,
+        NNTI_event_queue_t                        eq_hdl,
+        NNTI_event_t                             *events,
+        const uint32_t                            max,
+        const int                                 timeout,
+        uint32_t                                 *count);
+
 };
 
 } /* namespace transports */
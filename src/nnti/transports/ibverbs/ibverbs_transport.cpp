@@ -80,7 +80,8 @@ ibverbs_transport::ibverbs_transport(
       event_freelist_size_(128),
       cmd_op_freelist_size_(128),
       rdma_op_freelist_size_(128),
-      atomic_op_freelist_size_(128)
+      atomic_op_freelist_size_(128),
+      freelist_magazine_size_(16)
 {
     faodel::rc_t rc = 0;
     uint64_t uint_value = 0;
@@ -102,10 +103,12 @@ ibverbs_transport::ibverbs_transport(
         rdma_op_freelist_size_   = uint_value;
         atomic_op_freelist_size_ = uint_value;
     }
-    event_freelist_     = new nnti::core::nnti_freelist<NNTI_event_t*>(event_freelist_size_);
-    cmd_op_freelist_    = new nnti::core::nnti_freelist<nnti::core::ibverbs_cmd_op*>(cmd_op_freelist_size_);
-    rdma_op_freelist_   = new nnti::core::nnti_freelist<nnti::core::ibverbs_rdma_op*>(rdma_op_freelist_size_);
-    atomic_op_freelist_ = new nnti::core::nnti_freelist<nnti::core::ibverbs_atomic_op*>(atomic_op_freelist_size_);
+    // per-thread cache in front of each freelist.  0 turns the cache off.
+    config.GetUInt(&freelist_magazine_size_, "nnti.freelist.magazine_size", "16");
+    event_freelist_     = new nnti::core::nnti_freelist<NNTI_event_t*>(event_freelist_size_, freelist_magazine_size_);
+    cmd_op_freelist_    = new nnti::core::nnti_freelist<nnti::core::ibverbs_cmd_op*>(cmd_op_freelist_size_, freelist_magazine_size_);
+    rdma_op_freelist_   = new nnti::core::nnti_freelist<nnti::core::ibverbs_rdma_op*>(rdma_op_freelist_size_, freelist_magazine_size_);
+    atomic_op_freelist_ = new nnti::core::nnti_freelist<nnti::core::ibverbs_atomic_op*>(atomic_op_freelist_size_, freelist_magazine_size_);
 
     return;
 }
@@ -692,6 +695,27 @@ cleanup:
     return nnti_rc;
 }
 
+/**
+ * @brief Wait for one or more events to arrive on an event queue.
+ *
+ * \param[in]  eq       The event queue to wait on.
+ * \param[out] events   An array of at least max events.
+ * \param[in]  max      The most events to return.
+ * \param[in]  timeout  The amount of time (in milliseconds) to wait.
+ * \param[out] count    The number of events returned.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+ibverbs_transport::eq_wait_many(
+    NNTI_event_queue_t  eq_hdl,
+    NNTI_event_t       *events,
+    const uint32_t      max,
+    const int           timeout,
+    uint32_t           *count)
+{
+    return wait_for_events(event_freelist_, eq_hdl, events, max, timeout, count);
+}
+
 /**
  * @brief Retrieves the next message from the unexpected list.
  *
@@ -1708,6 +1732,12 @@ ibverbs_transport::setup_freelists(void)
 NNTI_result_t
 ibverbs_transport::teardown_freelists(void)
 {
+    // the progress thread has exited.  collect whatever the app threads still cache.
+    event_freelist_->reclaim();
+    cmd_op_freelist_->reclaim();
+    rdma_op_freelist_->reclaim();
+    atomic_op_freelist_->reclaim();
+
     while(!event_freelist_->empty()) {
         NNTI_event_t *e = nullptr;
         if (event_freelist_->pop(e)) {
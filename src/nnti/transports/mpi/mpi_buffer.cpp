@@ -33,7 +33,8 @@ std::atomic<uint32_t> mpi_buffer::buffer_tag_counter_ = {mpi_buffer::max_reserve
 
 
 mpi_buffer::mpi_buffer()
-    : nnti_buffer()
+    : nnti_buffer(),
+      rma_attached_(false)
 {
     return;
 }
@@ -47,7 +48,8 @@ mpi_buffer::mpi_buffer()
 //}
 mpi_buffer::mpi_buffer(
     nnti::datatype::mpi_buffer &b)
-: nnti_buffer(b)
+: nnti_buffer(b),
+  rma_attached_(false)
 {
     memcpy(packed_, b.packed_, packed_size_);
 
@@ -65,7 +67,8 @@ mpi_buffer::mpi_buffer(
               flags,
               eq,
               cb,
-              cb_context)
+              cb_context),
+  rma_attached_(false)
 {
     register_buffer();
     internal_pack();
@@ -86,7 +89,8 @@ mpi_buffer::mpi_buffer(
               flags,
               eq,
               cb,
-              cb_context)
+              cb_context),
+  rma_attached_(false)
 {
     register_buffer();
     internal_pack();
@@ -99,7 +103,8 @@ mpi_buffer::mpi_buffer(
     const uint64_t               packed_len)
 : nnti_buffer(transport,
               packed_buf,
-              packed_len)
+              packed_len),
+  rma_attached_(false)
 {
     payload_      = (char *)packable_.buffer.NNTI_remote_addr_p_t_u.mpi.buf;
     payload_size_ = packable_.buffer.NNTI_remote_addr_p_t_u.mpi.size;
@@ -112,6 +117,9 @@ mpi_buffer::mpi_buffer(
 
 mpi_buffer::~mpi_buffer()
 {
+    if (rma_attached_) {
+        ((nnti::transports::mpi_transport *)transport_)->rma_detach(payload_);
+    }
     return;
 }
 
@@ -158,6 +166,12 @@ mpi_buffer::atomic_tag(void)
     return packable_.buffer.NNTI_remote_addr_p_t_u.mpi.atomic_data_tag;
 }
 
+uint64_t
+mpi_buffer::rma_disp(void)
+{
+    return packable_.buffer.NNTI_remote_addr_p_t_u.mpi.rma_disp;
+}
+
 
 NNTI_result_t
 mpi_buffer::register_buffer(void)
@@ -176,14 +190,22 @@ mpi_buffer::register_buffer(void)
     packable_.buffer.NNTI_remote_addr_p_t_u.mpi.put_data_tag    = buffer_tag_counter_++;
     packable_.buffer.NNTI_remote_addr_p_t_u.mpi.atomic_data_tag = buffer_tag_counter_++;
 
-    log_debug("mpi_buffer", "exit (payload_==%p, buf==%p, size==%u, cmd_tag==%u, get_data_tag=%u, put_data_tag=%u, atomic_data_tag=%u)",
+    // peers read and write this buffer with one-sided MPI if the transport has an RMA window
+    uint64_t disp = 0;
+    if (((nnti::transports::mpi_transport *)transport_)->rma_attach(payload_, payload_size_, &disp) == NNTI_OK) {
+        packable_.buffer.NNTI_remote_addr_p_t_u.mpi.rma_disp = disp;
+        rma_attached_ = true;
+    }
+
+    log_debug("mpi_buffer", "exit (payload_==%p, buf==%p, size==%u, cmd_tag==%u, get_data_tag=%u, put_data_tag=%u, atomic_data_tag=%u, rma_disp=%lu)",
         payload_,
         packable_.buffer.NNTI_remote_addr_p_t_u.mpi.buf,
         packable_.buffer.NNTI_remote_addr_p_t_u.mpi.size,
         packable_.buffer.NNTI_remote_addr_p_t_u.mpi.cmd_tag,
         packable_.buffer.NNTI_remote_addr_p_t_u.mpi.get_data_tag,
         packable_.buffer.NNTI_remote_addr_p_t_u.mpi.put_data_tag,
-        packable_.buffer.NNTI_remote_addr_p_t_u.mpi.atomic_data_tag);
+        packable_.buffer.NNTI_remote_addr_p_t_u.mpi.atomic_data_tag,
+        packable_.buffer.NNTI_remote_addr_p_t_u.mpi.rma_disp);
 
     return rc;
 }
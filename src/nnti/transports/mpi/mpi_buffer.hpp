@@ -42,6 +42,7 @@ private:
 
 private:
     MPI_Request request;
+    bool        rma_attached_;  // this process attached the payload to the transport's RMA window
 
 private:
     NNTI_result_t
@@ -91,6 +92,8 @@ public:
     put_tag(void);
     uint32_t
     atomic_tag(void);
+    uint64_t
+    rma_disp(void);
 };
 
 } /* namespace datatype */
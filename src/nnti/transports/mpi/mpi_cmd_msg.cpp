@@ -112,12 +112,18 @@ mpi_cmd_msg::size(void)
     return cmd_msg_size_;
 }
 
-void
+NNTI_result_t
 mpi_cmd_msg::unpack(void)
 {
     log_debug("mpi_cmd_msg", "unpack - enter");
 
-    initiator_peer_ = (nnti::datatype::mpi_peer*)transport_->conn_map_.get(cmd_msg_buf_->initiator)->peer();
+    // the initiator may have disconnected while this message was in flight
+    nnti::core::nnti_connection *conn = transport_->conn_map_.get(cmd_msg_buf_->initiator);
+    if (conn == nullptr) {
+        log_debug("mpi_cmd_msg", "unpack - message id(%u) from an unknown peer", cmd_msg_buf_->id);
+        return NNTI_ENOENT;
+    }
+    initiator_peer_ = (nnti::datatype::mpi_peer*)conn->peer();
 
     if (*(uint32_t*)cmd_msg_buf_->packed_initiator_hdl != 0) {
         initiator_hdl_ = (nnti::datatype::mpi_buffer*)transport_->unpack_buffer(cmd_msg_buf_->packed_initiator_hdl,
@@ -143,7 +149,7 @@ mpi_cmd_msg::unpack(void)
 
     log_debug("mpi_cmd_msg", "unpack - exit");
 
-    return;
+    return NNTI_OK;
 }
 
 uint64_t
@@ -109,7 +109,7 @@ public:
     uint32_t
     size(void);
 
-    void
+    NNTI_result_t
     unpack(void);
 
     static uint64_t
@@ -67,6 +67,9 @@ private:
 
     size_t                           index_;
 
+    bool                             rma_;       // rdma_request_ is an MPI_Rget()/MPI_Rput() on the RMA window
+    bool                             cmd_done_;  // cmd_request_ is done.  the op is waiting on its data request.
+
     nnti::core::mpi_cmd_msg          cmd_msg_;
 
 public:
@@ -74,6 +77,8 @@ public:
         nnti::transports::mpi_transport *transport,
         const uint32_t                   cmd_msg_size)
     : nnti_op(),
+      rma_(false),
+      cmd_done_(false),
       cmd_msg_(transport, cmd_msg_size)
     {
         return;
@@ -83,6 +88,8 @@ public:
         const uint32_t                   cmd_msg_size,
         nnti::datatype::nnti_work_id    *wid)
     : nnti_op(wid),
+      rma_(false),
+      cmd_done_(false),
       cmd_msg_(transport, cmd_msg_size)
     {
         set(wid);
@@ -92,6 +99,8 @@ public:
         nnti::transports::mpi_transport *transport,
         nnti::datatype::nnti_work_id    *wid)
     : nnti_op(wid),
+      rma_(false),
+      cmd_done_(false),
       cmd_msg_(transport, id_, wid)
     {
         return;
@@ -106,6 +115,8 @@ public:
     {
         id_  = next_id_.fetch_add(1);
         wid_ = wid;
+        rma_ = false;
+        cmd_done_ = false;
         cmd_msg_.set(id_, wid);
         if (wid_->wr().op() == NNTI_OP_ATOMIC_FADD) {
             atomic_op_header_t *hdr = (atomic_op_header_t *)cmd_msg_.eager_payload();
@@ -160,6 +171,28 @@ public:
 //        return put_send_request_;
 //    }
 
+    void
+    rma(bool r)
+    {
+        rma_ = r;
+    }
+    bool
+    rma(void)
+    {
+        return rma_;
+    }
+
+    void
+    cmd_done(bool d)
+    {
+        cmd_done_ = d;
+    }
+    bool
+    cmd_done(void)
+    {
+        return cmd_done_;
+    }
+
     void
     index(size_t index)
     {
@@ -12,7 +12,9 @@
 //#define _POSIX_C_SOURCE 199309
 #include <time.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <thread>
 #include <mutex>
 #include <map>
@@ -63,8 +65,11 @@ mpi_transport::mpi_transport(
                      config),
       started_(false),
       external_mpi_init_(true),
+      rma_enabled_(false),
+      rma_win_(MPI_WIN_NULL),
       event_freelist_size_(128),
-      cmd_op_freelist_size_(128)
+      cmd_op_freelist_size_(128),
+      freelist_magazine_size_(16)
 {
     faodel::rc_t rc = 0;
     uint64_t uint_value = 0;
@@ -76,8 +81,12 @@ mpi_transport::mpi_transport(
         event_freelist_size_     = uint_value;
         cmd_op_freelist_size_    = uint_value;
     }
-    event_freelist_     = new nnti::core::nnti_freelist<NNTI_event_t*>(event_freelist_size_);
-    cmd_op_freelist_    = new nnti::core::nnti_freelist<nnti::core::mpi_cmd_op*>(cmd_op_freelist_size_);
+    // per-thread cache in front of each freelist.  0 turns the cache off.
+    config.GetUInt(&freelist_magazine_size_, "nnti.freelist.magazine_size", "16");
+    config.GetBool(&rma_enabled_, "nnti.mpi.rma", "false");
+
+    event_freelist_     = new nnti::core::nnti_freelist<NNTI_event_t*>(event_freelist_size_, freelist_magazine_size_);
+    cmd_op_freelist_    = new nnti::core::nnti_freelist<nnti::core::mpi_cmd_op*>(cmd_op_freelist_size_, freelist_magazine_size_);
 
     return;
 }
@@ -116,6 +125,15 @@ mpi_transport::start(void)
     MPI_Comm_size(nnti_comm_, &nnti_comm_size_);
     MPI_Comm_rank(nnti_comm_, &nnti_comm_rank_);
 
+    if (rma_enabled_) {
+        rc = setup_rma_window();
+        if (rc) {
+            // gets and puts fall back to command messages
+            log_warn("mpi_transport", "setup_rma_window() failed - continuing without RMA");
+            rc = NNTI_OK;
+        }
+    }
+
     faodel::nodeid_t nodeid = whookie::Server::GetNodeID();
     std::string addr = nodeid.GetIP();
     std::string port = nodeid.GetPort();
@@ -201,6 +219,10 @@ mpi_transport::stop(void)
     teardown_command_buffer();
     teardown_freelists();
 
+    if (rma_win_ != MPI_WIN_NULL) {
+        teardown_rma_window();
+    }
+
     if (!external_mpi_init_) {
         MPI_Finalize();
     }
@@ -480,8 +502,13 @@ mpi_transport::eq_wait(
 
     NNTI_event_t *e;
 
+    // stale notifications send us back to retry, so poll() only gets what's left of timeout
+    int  remaining = timeout;
+    auto start     = std::chrono::steady_clock::now();
+
     log_debug("eq_wait", "enter");
 
+retry:
     for (uint32_t i=0;i<eq_count;i++) {
         nnti::datatype::nnti_event_queue *eq = nnti::datatype::nnti_event_queue::to_obj(eq_list[i]);
         rc = eq->pop(e);
@@ -503,11 +530,11 @@ mpi_transport::eq_wait(
         poll_fds[i].events  = POLLIN;
         poll_fds[i].revents = 0;
     }
-    log_debug("eq_wait", "polling with timeout==%d", timeout);
+    log_debug("eq_wait", "polling with timeout==%d", remaining);
 
     // Test for errno==EINTR to deal with timing interrupts from HPCToolkit
     do {
-        poll_rc = poll(&poll_fds[0], poll_fds.size(), timeout);
+        poll_rc = poll(&poll_fds[0], poll_fds.size(), remaining);
     } while ((poll_rc < 0) && (errno == EINTR));
 
     if (poll_rc == 0) {
@@ -558,6 +585,14 @@ mpi_transport::eq_wait(
                 }
             }
         }
+        // the progress thread notifies after it pushes, so the events behind
+        // these notifications were already popped above.  wait again.
+        log_debug("eq_wait", "stale notification(s) with no events.  polling again.");
+        if (timeout >= 0) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+            remaining = (elapsed >= timeout) ? 0 : (int)(timeout - elapsed);
+        }
+        goto retry;
     }
 
 
@@ -568,6 +603,27 @@ cleanup:
     return nnti_rc;
 }
 
+/**
+ * @brief Wait for one or more events to arrive on an event queue.
+ *
+ * \param[in]  eq       The event queue to wait on.
+ * \param[out] events   An array of at least max events.
+ * \param[in]  max      The most events to return.
+ * \param[in]  timeout  The amount of time (in milliseconds) to wait.
+ * \param[out] count    The number of events returned.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+mpi_transport::eq_wait_many(
+    NNTI_event_queue_t  eq_hdl,
+    NNTI_event_t       *events,
+    const uint32_t      max,
+    const int           timeout,
+    uint32_t           *count)
+{
+    return wait_for_events(event_freelist_, eq_hdl, events, max, timeout, count);
+}
+
 /**
  * @brief Retrieves the next message from the unexpected list.
  *
@@ -603,36 +659,20 @@ mpi_transport::next_unexpected(
         }
         NNTI_FAST_STAT(stats_->short_recvs++;)
     } else {
-        nnti::datatype::mpi_buffer *initiator_buffer = unexpected_msg->initiator_buffer();
-        nnti::datatype::mpi_peer   *peer             = unexpected_msg->initiator_peer();
-
-        MPI_Request req;
-        MPI_Status  status;
+        log_debug("mpi_transport", "unexpected long send");
 
-        log_debug("mpi_transport", "unexpected long send Irecv()");
-
-        std::unique_lock<std::mutex> mpi_lock(mpi_mutex_);
-        MPI_Irecv((char*)b->payload() + dst_offset,
-                           unexpected_msg->payload_length(),
-                           MPI_BYTE,
-                           peer->rank(),
-                           initiator_buffer->cmd_tag(),
-                           MPI_COMM_WORLD,
-                           &req);
-        MPI_Wait(&req, &status);
-        mpi_lock.unlock();
+        rc = recv_long_payload(unexpected_msg, (char*)b->payload() + dst_offset);
+        if (rc != NNTI_OK) {
+            log_error("next_unexpected", "recv_long_payload() failed (rc=%d)", rc);
+        }
 
-        log_debug("mpi_transport", "unexpected long send Wait() complete");
+        log_debug("mpi_transport", "unexpected long send complete");
 
         NNTI_FAST_STAT(stats_->long_recvs++;)
     }
 
-    unexpected_msg->post_recv();
-    add_outstanding_cmd_msg(unexpected_msg->cmd_request(), unexpected_msg);
-    log_debug("mpi_transport", "reposting unexpected_msg (index=%d)", unexpected_msg->index());
-
     result_event->trans_hdl  = nnti::transports::transport::to_hdl(this);
-    result_event->result     = NNTI_OK;
+    result_event->result     = rc;
     result_event->op         = NNTI_OP_SEND;
     result_event->peer       = nnti::datatype::nnti_peer::to_hdl(unexpected_msg->initiator_peer());
     result_event->length     = unexpected_msg->payload_length();
@@ -643,6 +683,9 @@ mpi_transport::next_unexpected(
 
     log_debug("mpi_transport", "result_event->peer = %p", result_event->peer);
 
+    log_debug("mpi_transport", "reposting unexpected_msg (index=%d)", unexpected_msg->index());
+    repost_cmd_msg(unexpected_msg);
+
     log_debug("next_unexpected", "exit");
 
     return rc;
@@ -1191,6 +1234,44 @@ mpi_transport::get_instance(
     return instance;
 }
 
+NNTI_result_t
+mpi_transport::rma_attach(
+    char           *buf,
+    const uint64_t  len,
+    uint64_t       *disp)
+{
+    int      mpi_rc = MPI_SUCCESS;
+    MPI_Aint addr;
+
+    std::unique_lock<std::mutex> mpi_lock(mpi_mutex_);
+
+    if (rma_win_ == MPI_WIN_NULL) {
+        return NNTI_ENOENT;
+    }
+
+    mpi_rc = MPI_Win_attach(rma_win_, buf, len);
+    if (mpi_rc != MPI_SUCCESS) {
+        log_error("mpi_transport", "MPI_Win_attach() failed - rc=%d", mpi_rc);
+        return NNTI_EIO;
+    }
+    MPI_Get_address(buf, &addr);
+    *disp = (uint64_t)addr;
+
+    return NNTI_OK;
+}
+
+void
+mpi_transport::rma_detach(
+    char           *buf)
+{
+    std::unique_lock<std::mutex> mpi_lock(mpi_mutex_);
+
+    // MPI_Win_free() detaches whatever is still attached
+    if (rma_win_ != MPI_WIN_NULL) {
+        MPI_Win_detach(rma_win_, buf);
+    }
+}
+
 /*************************************************************
  * Accessors for data members specific to this interconnect.
  *************************************************************/
@@ -1250,6 +1331,10 @@ mpi_transport::setup_freelists(void)
 NNTI_result_t
 mpi_transport::teardown_freelists(void)
 {
+    // the progress thread has exited.  collect whatever the app threads still cache.
+    event_freelist_->reclaim();
+    cmd_op_freelist_->reclaim();
+
     while(!event_freelist_->empty()) {
         NNTI_event_t *e = nullptr;
         if (event_freelist_->pop(e)) {
@@ -1297,10 +1382,67 @@ mpi_transport::teardown_command_buffer(void)
     return(NNTI_OK);
 }
 
+/*
+ * Create the dynamic window that registered buffers get attached to.
+ * This is collective over nnti_comm_, so every process must agree on
+ * nnti.mpi.rma.  The passive target epoch lasts until stop(), so
+ * MPI_Rget()/MPI_Rput() can go to any peer at any time.
+ *
+ * Not every osc component can create a dynamic window (Open MPI's can't
+ * on a single rank), and creation errors are raised on the communicator,
+ * so swap in MPI_ERRORS_RETURN while the window is created.
+ */
+NNTI_result_t
+mpi_transport::setup_rma_window(void)
+{
+    int            mpi_rc = MPI_SUCCESS;
+    MPI_Errhandler comm_errhandler;
+
+    log_debug("mpi_transport", "setup_rma_window: enter");
+
+    MPI_Comm_get_errhandler(nnti_comm_, &comm_errhandler);
+    MPI_Comm_set_errhandler(nnti_comm_, MPI_ERRORS_RETURN);
+    mpi_rc = MPI_Win_create_dynamic(MPI_INFO_NULL, nnti_comm_, &rma_win_);
+    MPI_Comm_set_errhandler(nnti_comm_, comm_errhandler);
+    MPI_Errhandler_free(&comm_errhandler);
+    if (mpi_rc != MPI_SUCCESS) {
+        log_error("mpi_transport", "MPI_Win_create_dynamic() failed - rc=%d", mpi_rc);
+        rma_win_ = MPI_WIN_NULL;
+        return(NNTI_EIO);
+    }
+    MPI_Win_set_errhandler(rma_win_, MPI_ERRORS_RETURN);
+
+    mpi_rc = MPI_Win_lock_all(MPI_MODE_NOCHECK, rma_win_);
+    if (mpi_rc != MPI_SUCCESS) {
+        log_error("mpi_transport", "MPI_Win_lock_all() failed - rc=%d", mpi_rc);
+        MPI_Win_free(&rma_win_);
+        return(NNTI_EIO);
+    }
+
+    log_debug("mpi_transport", "setup_rma_window: exit");
+
+    return(NNTI_OK);
+}
+
+NNTI_result_t
+mpi_transport::teardown_rma_window(void)
+{
+    log_debug("mpi_transport", "teardown_rma_window: enter");
+
+    std::unique_lock<std::mutex> mpi_lock(mpi_mutex_);
+    MPI_Win_unlock_all(rma_win_);
+    MPI_Win_free(&rma_win_);
+    mpi_lock.unlock();
+
+    log_debug("mpi_transport", "teardown_rma_window: exit");
+
+    return(NNTI_OK);
+}
+
 void
 mpi_transport::progress(void)
 {
-    NNTI_result_t msg_rc, op_rc;
+    NNTI_result_t msg_rc, op_rc, local_rc;
     struct timespec ts;
 
     ts.tv_sec = 0;
@@ -1311,8 +1453,12 @@ mpi_transport::progress(void)
 
         msg_rc = progress_msg_requests();
         op_rc = progress_op_requests();
+        local_rc = progress_local_requests();
 
-        if (msg_rc == NNTI_OK || op_rc == NNTI_OK) {
+        // wake the event queues once for everything delivered above
+        flush_notifications();
+
+        if (msg_rc == NNTI_OK || op_rc == NNTI_OK || local_rc == NNTI_OK) {
             ts.tv_nsec = poll_min_nsec;
         } else {
             log_debug("mpi_transport", "sleep(%d) after poll_*_requests()", ts.tv_nsec);
@@ -1439,6 +1585,18 @@ mpi_transport::stats_cb(
     rs.tableRow({"long_recvs",        std::to_string(stats_->long_recvs.load())});
     rs.tableRow({"gets",              std::to_string(stats_->gets.load())});
     rs.tableRow({"puts",              std::to_string(stats_->puts.load())});
+    rs.tableRow({"rma_gets",          std::to_string(stats_->rma_gets.load())});
+    rs.tableRow({"rma_puts",          std::to_string(stats_->rma_puts.load())});
+    rs.tableEnd();
+
+    uint64_t event_hits, event_misses, cmd_op_hits, cmd_op_misses;
+    event_freelist_->cache_stats(event_hits, event_misses);
+    cmd_op_freelist_->cache_stats(cmd_op_hits, cmd_op_misses);
+
+    rs.tableBegin("Freelist Caches");
+    rs.tableTop({"freelist", "magazine_size", "hits", "misses"});
+    rs.tableRow({"event",  std::to_string(event_freelist_->magazine_size()),  std::to_string(event_hits),  std::to_string(event_misses)});
+    rs.tableRow({"cmd_op", std::to_string(cmd_op_freelist_->magazine_size()), std::to_string(cmd_op_hits), std::to_string(cmd_op_misses)});
     rs.tableEnd();
     rs.Finish();
 }
@@ -1534,52 +1692,28 @@ mpi_transport::add_outstanding_cmd_op(
     add_outstanding_cmd_op(req_lock, r, op);
     req_lock.unlock();
 }
+/*
+ * Drop the slots whose cmd_op was cleared, starting at first, in one
+ * pass.  The survivors keep the order they were posted in.
+ */
 void
-mpi_transport::remove_outstanding_cmd_op(
+mpi_transport::compact_outstanding_cmd_ops(
     std::unique_lock<std::mutex> &req_lock,
-    int index)
-{
-    outstanding_op_requests_[index] = MPI_REQUEST_NULL;
-    outstanding_ops_[index]         = nullptr;
-
-    log_debug("mpi_transport", "removed at index %d", index);
-
-    int current_size = outstanding_op_requests_.size();
-    if (outstanding_op_requests_.size() > cmd_msg_count_) {
-        outstanding_op_requests_.erase( std::remove( outstanding_op_requests_.begin(), outstanding_op_requests_.end(), MPI_REQUEST_NULL ), outstanding_op_requests_.end() );
-        outstanding_ops_.erase( std::remove( outstanding_ops_.begin(), outstanding_ops_.end(), nullptr ), outstanding_ops_.end() );
-
-        int new_size = outstanding_op_requests_.size();
-        log_debug("mpi_transport", "removing %d elements", current_size-new_size);
-
-        outstanding_ops_.resize(new_size);
-        outstanding_op_requests_.resize(new_size);
-
-        // reindex
-        int i=0;
-        auto iter = outstanding_ops_.begin();
-        while (iter != outstanding_ops_.end()) {
-            (*iter)->index(i);
-            ++iter;
-            ++i;
+    int first)
+{
+    size_t j=first;
+    for (size_t i=first;i<outstanding_ops_.size();i++) {
+        if (outstanding_ops_[i] != nullptr) {
+            outstanding_op_requests_[j] = outstanding_op_requests_[i];
+            outstanding_ops_[j]         = outstanding_ops_[i];
+            outstanding_ops_[j]->index(j);
+            j++;
         }
     }
-}
-void
-mpi_transport::remove_outstanding_cmd_op(
-    int index)
-{
-    std::unique_lock<std::mutex> req_lock(outstanding_requests_mutex_);
-    remove_outstanding_cmd_op(req_lock, index);
-    req_lock.unlock();
-}
-void
-mpi_transport::remove_outstanding_cmd_op(
-    nnti::core::mpi_cmd_op *op)
-{
-    std::unique_lock<std::mutex> req_lock(outstanding_requests_mutex_);
-    remove_outstanding_cmd_op(req_lock, op->index());
-    req_lock.unlock();
+    log_debug("mpi_transport", "compacted %lu slots", outstanding_ops_.size()-j);
+
+    outstanding_op_requests_.resize(j);
+    outstanding_ops_.resize(j);
 }
 void
 mpi_transport::purge_outstanding_cmd_ops()
@@ -1611,52 +1745,28 @@ mpi_transport::add_outstanding_cmd_msg(
     req_lock.unlock();
 }
 
+/*
+ * Drop the slots whose cmd_msg was cleared, starting at first, in one
+ * pass.  The survivors keep the order they were posted in.
+ */
 void
-mpi_transport::remove_outstanding_cmd_msg(
+mpi_transport::compact_outstanding_cmd_msgs(
     std::unique_lock<std::mutex> &req_lock,
-    int index)
-{
-    outstanding_msg_requests_[index] = MPI_REQUEST_NULL;
-    outstanding_msgs_[index]         = nullptr;
-
-    log_debug("mpi_transport", "removed at index %d", index);
-
-    int current_size = outstanding_msg_requests_.size();
-    if (outstanding_msg_requests_.size() > cmd_msg_count_*2) {
-        outstanding_msg_requests_.erase( std::remove( outstanding_msg_requests_.begin(), outstanding_msg_requests_.end(), MPI_REQUEST_NULL ), outstanding_msg_requests_.end() );
-        outstanding_msgs_.erase( std::remove( outstanding_msgs_.begin(), outstanding_msgs_.end(), nullptr ), outstanding_msgs_.end() );
-
-        int new_size = outstanding_msg_requests_.size();
-        log_debug("mpi_transport", "removing %d elements", current_size-new_size);
-
-        outstanding_msgs_.resize(new_size);
-        outstanding_msg_requests_.resize(new_size);
-
-        // reindex
-        int i=0;
-        auto iter = outstanding_msgs_.begin();
-        while (iter != outstanding_msgs_.end()) {
-            (*iter)->index(i);
-            ++iter;
-            ++i;
+    int first)
+{
+    size_t j=first;
+    for (size_t i=first;i<outstanding_msgs_.size();i++) {
+        if (outstanding_msgs_[i] != nullptr) {
+            outstanding_msg_requests_[j] = outstanding_msg_requests_[i];
+            outstanding_msgs_[j]         = outstanding_msgs_[i];
+            outstanding_msgs_[j]->index(j);
+            j++;
         }
     }
-}
-void
-mpi_transport::remove_outstanding_cmd_msg(
-    int index)
-{
-    std::unique_lock<std::mutex> req_lock(outstanding_requests_mutex_);
-    remove_outstanding_cmd_msg(req_lock, index);
-    req_lock.unlock();
-}
-void
-mpi_transport::remove_outstanding_cmd_msg(
-    nnti::core::mpi_cmd_msg *msg)
-{
-    std::unique_lock<std::mutex> req_lock(outstanding_requests_mutex_);
-    remove_outstanding_cmd_msg(req_lock, msg->index());
-    req_lock.unlock();
+    log_debug("mpi_transport", "compacted %lu slots", outstanding_msgs_.size()-j);
+
+    outstanding_msg_requests_.resize(j);
+    outstanding_msgs_.resize(j);
 }
 void
 mpi_transport::purge_outstanding_cmd_msgs()
@@ -1847,6 +1957,11 @@ mpi_transport::execute_rdma_op(
         return NNTI_EMSGSIZE;
     }
 
+    if ((rma_win_ != MPI_WIN_NULL) && (remote_buffer->rma_disp() != 0)) {
+        // the target attached this buffer to its RMA window, so it doesn't have to take part
+        return execute_rma_op(work_id, rdma_op);
+    }
+
     switch (work_id->wr().op()) {
         case NNTI_OP_GET:
             mpi_lock.lock();
@@ -1907,6 +2022,59 @@ mpi_transport::execute_rdma_op(
     return rc;
 }
 
+/*
+ * One-sided GET/PUT on the RMA window.  There is no command message.
+ * The op completes when its MPI_Rget()/MPI_Rput() request does (see
+ * progress_op_requests()).
+ */
+NNTI_result_t
+mpi_transport::execute_rma_op(
+    nnti::datatype::nnti_work_id *work_id,
+    nnti::core::mpi_cmd_op       *rdma_op)
+{
+    int mpi_rc = MPI_SUCCESS;
+
+    log_debug("mpi_transport", "execute_rma_op() - enter");
+
+    nnti::datatype::mpi_peer   *peer          = (nnti::datatype::mpi_peer *)work_id->wr().peer();
+    nnti::datatype::mpi_buffer *local_buffer  = (nnti::datatype::mpi_buffer *)work_id->wr().local_hdl();
+    nnti::datatype::mpi_buffer *remote_buffer = (nnti::datatype::mpi_buffer *)work_id->wr().remote_hdl();
+
+    char     *local_addr  = (char*)local_buffer->payload() + work_id->wr().local_offset();
+    MPI_Aint  target_disp = (MPI_Aint)(remote_buffer->rma_disp() + work_id->wr().remote_offset());
+    int       op_length   = work_id->wr().length();
+
+    rdma_op->rma(true);
+
+    std::unique_lock<std::mutex> mpi_lock(mpi_mutex_);
+    if (work_id->wr().op() == NNTI_OP_GET) {
+        mpi_rc = MPI_Rget(local_addr, op_length, MPI_BYTE,
+                          peer->rank(), target_disp, op_length, MPI_BYTE,
+                          rma_win_, &rdma_op->rdma_request());
+        stats_->rma_gets++;
+    } else {
+        mpi_rc = MPI_Rput(local_addr, op_length, MPI_BYTE,
+                          peer->rank(), target_disp, op_length, MPI_BYTE,
+                          rma_win_, &rdma_op->rdma_request());
+        stats_->rma_puts++;
+    }
+    mpi_lock.unlock();
+    if (mpi_rc != MPI_SUCCESS) {
+        log_error("mpi_transport", "MPI_Rget()/MPI_Rput() failed - rc=%d", mpi_rc);
+        return NNTI_EIO;
+    }
+
+    log_debug("mpi_transport", "posted rma_op(%s)", rdma_op->toString().c_str());
+
+    mpi_transport::add_outstanding_cmd_op(
+        rdma_op->rdma_request(),
+        rdma_op);
+
+    log_debug("mpi_transport", "execute_rma_op() - exit");
+
+    return NNTI_OK;
+}
+
 NNTI_result_t
 mpi_transport::create_fadd_op(
     nnti::datatype::nnti_work_id  *work_id,
@@ -2033,7 +2201,7 @@ mpi_transport::complete_send_command(nnti::core::mpi_cmd_msg *cmd_msg)
             NNTI_event_t *e = create_event(cmd_msg);
             if (unexpected_queue_->invoke_cb(e) != NNTI_OK) {
                 unexpected_queue_->push(e);
-                unexpected_queue_->notify();
+                notify_queue(unexpected_queue_);
             } else {
                 event_freelist_->push(e);
             }
@@ -2062,7 +2230,7 @@ mpi_transport::complete_send_command(nnti::core::mpi_cmd_msg *cmd_msg)
             if (b->invoke_cb(e) != NNTI_OK) {
                 if (q && q->invoke_cb(e) != NNTI_OK) {
                     q->push(e);
-                    q->notify();
+                    notify_queue(q);
                     release_event = false;
                 }
             }
@@ -2070,37 +2238,24 @@ mpi_transport::complete_send_command(nnti::core::mpi_cmd_msg *cmd_msg)
                 // we're done with the event
                 event_freelist_->push(e);
             }
-            cmd_msg->post_recv();
-            add_outstanding_cmd_msg(cmd_msg->cmd_request(), cmd_msg);
+            repost_cmd_msg(cmd_msg);
 
             NNTI_FAST_STAT(stats_->short_recvs++;)
         } else {
-            nnti::datatype::mpi_buffer *initiator_buffer = cmd_msg->initiator_buffer();
             nnti::datatype::mpi_buffer *target_buffer    = cmd_msg->target_buffer();
-            nnti::datatype::mpi_peer   *peer             = cmd_msg->initiator_peer();
 
-            MPI_Request req;
-            MPI_Status  status;
+            log_debug("mpi_transport", "long send");
 
-            log_debug("mpi_transport", "long send Irecv()");
+            NNTI_result_t recv_rc = recv_long_payload(cmd_msg, (char*)target_buffer->payload() + cmd_msg->target_offset());
 
-            std::unique_lock<std::mutex> mpi_lock(mpi_mutex_);
-            MPI_Irecv((char*)target_buffer->payload() + cmd_msg->target_offset(),
-                               cmd_msg->payload_length(),
-                               MPI_BYTE,
-                               peer->rank(),
-                               initiator_buffer->cmd_tag(),
-                               MPI_COMM_WORLD,
-                               &req);
-            MPI_Wait(&req, &status);
-            mpi_lock.unlock();
-            log_debug("mpi_transport", "long send Wait() complete");
+            log_debug("mpi_transport", "long send complete (rc=%d)", recv_rc);
 
             e  = create_event(cmd_msg, cmd_msg->target_offset());
+            e->result = recv_rc;
             if (b->invoke_cb(e) != NNTI_OK) {
                 if (q && q->invoke_cb(e) != NNTI_OK) {
                     q->push(e);
-                    q->notify();
+                    notify_queue(q);
                     release_event = false;
                 }
             }
@@ -2109,8 +2264,7 @@ mpi_transport::complete_send_command(nnti::core::mpi_cmd_msg *cmd_msg)
                 event_freelist_->push(e);
             }
 
-            cmd_msg->post_recv();
-            add_outstanding_cmd_msg(cmd_msg->cmd_request(), cmd_msg);
+            repost_cmd_msg(cmd_msg);
 
             NNTI_FAST_STAT(stats_->long_recvs++;)
         }
@@ -2144,8 +2298,7 @@ mpi_transport::complete_get_command(nnti::core::mpi_cmd_msg *cmd_msg)
     }
     mpi_lock.unlock();
 
-    cmd_msg->post_recv();
-    add_outstanding_cmd_msg(cmd_msg->cmd_request(), cmd_msg);
+    repost_cmd_msg(cmd_msg);
 
     log_debug("mpi_transport", "complete_get_command() - exit");
 
@@ -2174,8 +2327,7 @@ mpi_transport::complete_put_command(nnti::core::mpi_cmd_msg *cmd_msg)
     MPI_Wait(&req, &status);
     mpi_lock.unlock();
 
-    cmd_msg->post_recv();
-    add_outstanding_cmd_msg(cmd_msg->cmd_request(), cmd_msg);
+    repost_cmd_msg(cmd_msg);
 
     log_debug("mpi_transport", "complete_put_command() - exit");
 
@@ -2219,8 +2371,7 @@ mpi_transport::complete_fadd_command(nnti::core::mpi_cmd_msg *cmd_msg)
     MPI_Wait(&req, &status);
     mpi_lock.unlock();
 
-    cmd_msg->post_recv();
-    add_outstanding_cmd_msg(cmd_msg->cmd_request(), cmd_msg);
+    repost_cmd_msg(cmd_msg);
 
     log_debug("mpi_transport", "fadd result (fetch=%ld ; sum=%ld)", current, *op_addr);
 
@@ -2268,8 +2419,7 @@ mpi_transport::complete_cswap_command(nnti::core::mpi_cmd_msg *cmd_msg)
     MPI_Wait(&req, &status);
     mpi_lock.unlock();
 
-    cmd_msg->post_recv();
-    add_outstanding_cmd_msg(cmd_msg->cmd_request(), cmd_msg);
+    repost_cmd_msg(cmd_msg);
 
     log_debug("mpi_transport", "cswap result (operand1=%ld ; operand2=%ld ; target=%ld)", h->operand1, h->operand2, *op_addr);
 
@@ -2279,16 +2429,24 @@ mpi_transport::complete_cswap_command(nnti::core::mpi_cmd_msg *cmd_msg)
 }
 
 int
-mpi_transport::poll_msg_requests(std::vector<MPI_Request> &reqs, int &index, int &done, MPI_Status &event, nnti::core::mpi_cmd_msg *&cmd_msg)
+mpi_transport::poll_msg_requests(std::vector<nnti::core::mpi_cmd_msg *> &completed, int &outcount)
 {
     std::unique_lock<std::mutex> req_lock(outstanding_requests_mutex_, std::defer_lock);
     std::unique_lock<std::mutex> mpi_lock(mpi_mutex_, std::defer_lock);
     std::lock(req_lock, mpi_lock);
-    int mpi_rc = MPI_Testany(outstanding_msg_requests_.size(), &outstanding_msg_requests_[0], &index, &done, &event);
-    if ((mpi_rc == MPI_SUCCESS) && (index >= 0) && (done == 1)) {
-        // get the cmd_msg now while we hold the lock
-        cmd_msg = outstanding_msgs_[index];
-        remove_outstanding_cmd_msg(req_lock, cmd_msg->index());
+    testsome_indices_.resize(outstanding_msg_requests_.size());
+    int mpi_rc = MPI_Testsome(outstanding_msg_requests_.size(), outstanding_msg_requests_.data(), &outcount, testsome_indices_.data(), MPI_STATUSES_IGNORE);
+    mpi_lock.unlock();
+    if ((mpi_rc == MPI_SUCCESS) && (outcount != MPI_UNDEFINED) && (outcount > 0)) {
+        // get the cmd_msgs now while we hold the lock.  the receives are
+        // matched in the order they were posted, so handing them out in
+        // index order keeps each peer's commands in order.
+        std::sort(testsome_indices_.begin(), testsome_indices_.begin()+outcount);
+        for (int i=0;i<outcount;i++) {
+            completed.push_back(outstanding_msgs_[testsome_indices_[i]]);
+            outstanding_msgs_[testsome_indices_[i]] = nullptr;
+        }
+        compact_outstanding_cmd_msgs(req_lock, testsome_indices_[0]);
     }
     return mpi_rc;
 }
@@ -2299,59 +2457,58 @@ mpi_transport::progress_msg_requests(void)
     int mpi_rc = MPI_SUCCESS;
     NNTI_result_t nnti_rc = NNTI_OK;
 
-    int        index = -1;
-    int        done  = -1;
-    MPI_Status event;
-
-    nnti::core::mpi_cmd_msg *cmd_msg = nullptr;
+    int outcount = 0;
 
     log_debug("mpi_transport", "poll_msg_requests() - enter");
 
-    mpi_rc = poll_msg_requests(outstanding_msg_requests_, index, done, event, cmd_msg);
+    completed_msgs_.clear();
+    mpi_rc = poll_msg_requests(completed_msgs_, outcount);
 
-    /* MPI_Testany() says no active requests.  this is not fatal. */
-    if ((mpi_rc == MPI_SUCCESS) && (index == MPI_UNDEFINED) && (done == 1)) {
-        log_debug("mpi_transport", "MPI_Testany() says there a no active requests (mpi_rc=%d, index=%d, done=%d)", mpi_rc, index, done);
+    /* MPI_Testsome() says no active requests.  this is not fatal. */
+    if ((mpi_rc == MPI_SUCCESS) && (outcount == MPI_UNDEFINED)) {
+        log_debug("mpi_transport", "MPI_Testsome() says there a no active requests (mpi_rc=%d)", mpi_rc);
         nnti_rc = NNTI_ENOENT;
     }
-    /* MPI_Testany() says requests have completed */
+    /* MPI_Testsome() says requests have completed */
     else if (mpi_rc == MPI_SUCCESS) {
         /* case 1: success */
-        if (done == 0) {
+        if (outcount == 0) {
             nnti_rc = NNTI_EWOULDBLOCK;
         } else {
             nnti_rc = NNTI_OK;
 
-            log_debug("mpi_transport", "polling status is %d, which_req=%d, done=%d", mpi_rc, index, done);
-            log_debug("mpi_transport", "Poll Event= {");
-            log_debug("mpi_transport", "\tsource  = %d", event.MPI_SOURCE);
-            log_debug("mpi_transport", "\ttag     = %d", event.MPI_TAG);
-            log_debug("mpi_transport", "\terror   = %d", event.MPI_ERROR);
-            log_debug("mpi_transport", "}");
-
-            cmd_msg->unpack();
-            switch (cmd_msg->op()) {
-                case NNTI_OP_SEND:
-                    complete_send_command(cmd_msg);
-                    break;
-                case NNTI_OP_GET:
-                    complete_get_command(cmd_msg);
-                    break;
-                case NNTI_OP_PUT:
-                    complete_put_command(cmd_msg);
-                    break;
-                case NNTI_OP_ATOMIC_FADD:
-                    complete_fadd_command(cmd_msg);
-                    break;
-                case NNTI_OP_ATOMIC_CSWAP:
-                    complete_cswap_command(cmd_msg);
-                    break;
+            log_debug("mpi_transport", "MPI_Testsome() harvested %d cmd_msgs", outcount);
+
+            for (auto cmd_msg : completed_msgs_) {
+
+                if (cmd_msg->unpack() != NNTI_OK) {
+                    // the sender is gone.  drop the message.
+                    repost_cmd_msg(cmd_msg);
+                    continue;
+                }
+                switch (cmd_msg->op()) {
+                    case NNTI_OP_SEND:
+                        complete_send_command(cmd_msg);
+                        break;
+                    case NNTI_OP_GET:
+                        complete_get_command(cmd_msg);
+                        break;
+                    case NNTI_OP_PUT:
+                        complete_put_command(cmd_msg);
+                        break;
+                    case NNTI_OP_ATOMIC_FADD:
+                        complete_fadd_command(cmd_msg);
+                        break;
+                    case NNTI_OP_ATOMIC_CSWAP:
+                        complete_cswap_command(cmd_msg);
+                        break;
+                }
             }
         }
     }
-    /* MPI_Testany() failure */
+    /* MPI_Testsome() failure */
     else {
-        log_error("mpi_transport", "MPI_Testany() failed: rc=%d",
+        log_error("mpi_transport", "MPI_Testsome() failed: rc=%d",
                 mpi_rc);
         nnti_rc = NNTI_EIO;
     }
@@ -2371,154 +2528,264 @@ mpi_transport::progress_msg_requests(void)
 
 
 int
-mpi_transport::poll_op_requests(std::vector<MPI_Request> &reqs, int &index, int &done, MPI_Status &event, nnti::core::mpi_cmd_op *&cmd_op)
+mpi_transport::poll_op_requests(std::vector<nnti::core::mpi_cmd_op *> &completed, int &outcount)
 {
     std::unique_lock<std::mutex> req_lock(outstanding_requests_mutex_, std::defer_lock);
     std::unique_lock<std::mutex> mpi_lock(mpi_mutex_, std::defer_lock);
     std::lock(req_lock, mpi_lock);
-    int mpi_rc = MPI_Testany(outstanding_op_requests_.size(), &outstanding_op_requests_[0], &index, &done, &event);
-    if ((mpi_rc == MPI_SUCCESS) && (index >= 0) && (done == 1)) {
-        // get the cmd_op now while we hold the lock
-        cmd_op = outstanding_ops_[index];
-        remove_outstanding_cmd_op(req_lock, cmd_op->index());
+    testsome_indices_.resize(outstanding_op_requests_.size());
+    int mpi_rc = MPI_Testsome(outstanding_op_requests_.size(), outstanding_op_requests_.data(), &outcount, testsome_indices_.data(), MPI_STATUSES_IGNORE);
+    mpi_lock.unlock();
+    if ((mpi_rc == MPI_SUCCESS) && (outcount != MPI_UNDEFINED) && (outcount > 0)) {
+        // get the cmd_ops now while we hold the lock.  see poll_msg_requests().
+        std::sort(testsome_indices_.begin(), testsome_indices_.begin()+outcount);
+        for (int i=0;i<outcount;i++) {
+            completed.push_back(outstanding_ops_[testsome_indices_[i]]);
+            outstanding_ops_[testsome_indices_[i]] = nullptr;
+        }
+        compact_outstanding_cmd_ops(req_lock, testsome_indices_[0]);
     }
     return mpi_rc;
 }
 
+NNTI_result_t
+mpi_transport::progress_local_requests(void)
+{
+    // all traffic goes through MPI
+    return NNTI_ENOENT;
+}
+
+/*
+ * Receive the payload of a long send directly into its destination.
+ */
+NNTI_result_t
+mpi_transport::recv_long_payload(
+    nnti::core::mpi_cmd_msg *cmd_msg,
+    char                    *dst)
+{
+    nnti::datatype::mpi_buffer *initiator_buffer = cmd_msg->initiator_buffer();
+    nnti::datatype::mpi_peer   *peer             = cmd_msg->initiator_peer();
+
+    MPI_Request req;
+    MPI_Status  status;
+
+    log_debug("mpi_transport", "long send Irecv()");
+
+    std::unique_lock<std::mutex> mpi_lock(mpi_mutex_);
+    MPI_Irecv(dst,
+              cmd_msg->payload_length(),
+              MPI_BYTE,
+              peer->rank(),
+              initiator_buffer->cmd_tag(),
+              MPI_COMM_WORLD,
+              &req);
+    MPI_Wait(&req, &status);
+    mpi_lock.unlock();
+
+    log_debug("mpi_transport", "long send Wait() complete");
+
+    return NNTI_OK;
+}
+
+/*
+ * Make a command message available for the next incoming command.
+ */
+void
+mpi_transport::repost_cmd_msg(
+    nnti::core::mpi_cmd_msg *cmd_msg)
+{
+    cmd_msg->post_recv();
+    add_outstanding_cmd_msg(cmd_msg->cmd_request(), cmd_msg);
+}
+
+/*
+ * Deliver the event for a finished operation and recycle the cmd_op.
+ * A result other than NNTI_OK is reported in the event.
+ */
+NNTI_result_t
+mpi_transport::complete_cmd_op(
+    nnti::core::mpi_cmd_op *cmd_op,
+    NNTI_result_t           result)
+{
+    nnti::datatype::nnti_work_request &wr = cmd_op->wid()->wr();
+
+    nnti::datatype::nnti_event_queue    *alt_q          = nnti::datatype::nnti_event_queue::to_obj(wr.alt_eq());
+    nnti::datatype::nnti_buffer         *b              = nnti::datatype::nnti_buffer::to_obj(wr.local_hdl());
+    nnti::datatype::nnti_event_queue    *buf_q          = nnti::datatype::nnti_event_queue::to_obj(b->eq());
+    NNTI_event_t                        *e              = create_event(cmd_op);
+    bool                                 event_complete = false;
+    bool                                 release_event  = true;
+
+    e->result = result;
+
+    log_debug("mpi_transport", "complete_cmd_op() - buf_q=%p  alt_q=%p", buf_q, alt_q);
+
+    if (wr.invoke_cb(e) == NNTI_OK) {
+        log_debug("mpi_transport", "complete_cmd_op() - wr.invoke_cb()");
+        event_complete = true;
+    }
+    if (!event_complete && alt_q && alt_q->invoke_cb(e) == NNTI_OK) {
+        log_debug("mpi_transport", "complete_cmd_op() - alt_q->invoke_cb()");
+        event_complete = true;
+    }
+    if (!event_complete && buf_q && buf_q->invoke_cb(e) == NNTI_OK) {
+        log_debug("mpi_transport", "complete_cmd_op() - buf_q->invoke_cb()");
+        event_complete = true;
+    }
+    if (!event_complete && alt_q) {
+        log_debug("mpi_transport", "complete_cmd_op() - pushing on alt_q");
+        alt_q->push(e);
+        notify_queue(alt_q);
+        event_complete = true;
+        release_event = false;
+    }
+    if (!event_complete && buf_q) {
+        log_debug("mpi_transport", "complete_cmd_op() - pushing on buf_q");
+        buf_q->push(e);
+        notify_queue(buf_q);
+        event_complete = true;
+        release_event = false;
+    }
+    if (release_event) {
+        event_freelist_->push(e);
+    }
+
+    log_debug("mpi_transport", "complete_cmd_op() - event_complete == %d", event_complete ? 1 : 0);
+
+    cmd_op_freelist_->push(cmd_op);
+
+    if (cmd_op->eager()) {
+        stats_->short_sends++;
+    } else {
+        stats_->long_sends++;
+    }
+
+    if (wr.remote_hdl() == NNTI_INVALID_HANDLE) {
+        stats_->unexpected_sends++;
+    }
+
+    return NNTI_OK;
+}
+
+/*
+ * Wake anyone waiting on q.  The progress thread delivers completions in
+ * batches, so it writes each queue's notification pipe once per batch
+ * (see flush_notifications()) instead of once per event.
+ */
+void
+mpi_transport::notify_queue(nnti::datatype::nnti_event_queue *q)
+{
+    if (std::this_thread::get_id() != progress_thread_.get_id()) {
+        q->notify();
+        return;
+    }
+    if (std::find(pending_notify_.begin(), pending_notify_.end(), q) == pending_notify_.end()) {
+        pending_notify_.push_back(q);
+    }
+}
+
+void
+mpi_transport::flush_notifications(void)
+{
+    for (auto q : pending_notify_) {
+        q->notify();
+    }
+    pending_notify_.clear();
+}
+
 NNTI_result_t
 mpi_transport::progress_op_requests(void)
 {
     int mpi_rc = MPI_SUCCESS;
     NNTI_result_t nnti_rc = NNTI_OK;
 
-    int        index = -1;
-    int        done  = -1;
-    MPI_Status event;
-
-    nnti::core::mpi_cmd_op *cmd_op = nullptr;
+    int        outcount = 0;
 
     log_debug("mpi_transport", "poll_op_requests() - enter");
 
-    mpi_rc = poll_op_requests(outstanding_op_requests_, index, done, event, cmd_op);
+    completed_ops_.clear();
+    mpi_rc = poll_op_requests(completed_ops_, outcount);
 
-    /* MPI_Testany() says no active requests.  this is not fatal. */
-    if ((mpi_rc == MPI_SUCCESS) && (index == MPI_UNDEFINED) && (done == 1)) {
-        log_debug("mpi_transport", "MPI_Testany() says there a no active requests (mpi_rc=%d, index=%d, done=%d)", mpi_rc, index, done);
+    /* MPI_Testsome() says no active requests.  this is not fatal. */
+    if ((mpi_rc == MPI_SUCCESS) && (outcount == MPI_UNDEFINED)) {
+        log_debug("mpi_transport", "MPI_Testsome() says there a no active requests (mpi_rc=%d)", mpi_rc);
         nnti_rc = NNTI_ENOENT;
     }
-    /* MPI_Testany() says requests have completed */
+    /* MPI_Testsome() says requests have completed */
     else if (mpi_rc == MPI_SUCCESS) {
         /* case 1: success */
-        if (done == 0) {
+        if (outcount == 0) {
             nnti_rc = NNTI_EWOULDBLOCK;
         } else {
             nnti_rc = NNTI_OK;
 
-            log_debug("mpi_transport", "polling status is %d, which_req=%d, done=%d", mpi_rc, index, done);
-            log_debug("mpi_transport", "Poll Event= {");
-            log_debug("mpi_transport", "\tsource  = %d", event.MPI_SOURCE);
-            log_debug("mpi_transport", "\ttag     = %d", event.MPI_TAG);
-            log_debug("mpi_transport", "\terror   = %d", event.MPI_ERROR);
-            log_debug("mpi_transport", "}");
+            log_debug("mpi_transport", "MPI_Testsome() harvested %d cmd_ops", outcount);
 
             std::unique_lock<std::mutex> mpi_lock(mpi_mutex_, std::defer_lock);
-            nnti::datatype::nnti_work_request &wr = cmd_op->wid()->wr();
-            switch (wr.op()) {
-                case NNTI_OP_NOOP:
-                    log_error("mpi_transport", "Should never get here!!!");
-                    break;
-                case NNTI_OP_SEND:
-                    if (!cmd_op->eager()) {
-                        mpi_lock.lock();
-                        mpi_rc = MPI_Wait(&cmd_op->long_send_request(), &event);
-                        mpi_lock.unlock();
-
-                        if (mpi_rc != MPI_SUCCESS) {
-                            log_error("mpi_transport", "MPI_Wait(long_send_request) (mpi_rc=%d)", mpi_rc);
+            for (auto cmd_op : completed_ops_) {
+                nnti::datatype::nnti_work_request &wr = cmd_op->wid()->wr();
+                MPI_Request                       *data_request = nullptr;
+
+                switch (wr.op()) {
+                    case NNTI_OP_NOOP:
+                        log_error("mpi_transport", "Should never get here!!!");
+                        break;
+                    case NNTI_OP_SEND:
+                        if (!cmd_op->eager()) {
+                            data_request = &cmd_op->long_send_request();
                         }
-                        log_debug("mpi_transport", "Long Send Event= {");
-                        log_debug("mpi_transport", "\tsource  = %d", event.MPI_SOURCE);
-                        log_debug("mpi_transport", "\ttag     = %d", event.MPI_TAG);
-                        log_debug("mpi_transport", "\terror   = %d", event.MPI_ERROR);
-                        log_debug("mpi_transport", "}");
-                    }
-                    break;
-                case NNTI_OP_GET:
-                case NNTI_OP_PUT:
-                case NNTI_OP_ATOMIC_FADD:
-                case NNTI_OP_ATOMIC_CSWAP:
+                        break;
+                    case NNTI_OP_GET:
+                    case NNTI_OP_PUT:
+                        if (cmd_op->rma()) {
+                            // the request that completed is the MPI_Rget()/MPI_Rput() itself
+                            if (wr.op() == NNTI_OP_PUT) {
+                                // MPI_Rput() completes locally.  flush so the data is at the target before the app hears about it.
+                                nnti::datatype::mpi_peer *peer = (nnti::datatype::mpi_peer *)wr.peer();
+                                mpi_lock.lock();
+                                mpi_rc = MPI_Win_flush(peer->rank(), rma_win_);
+                                mpi_lock.unlock();
+
+                                if (mpi_rc != MPI_SUCCESS) {
+                                    log_error("mpi_transport", "MPI_Win_flush() failed (mpi_rc=%d)", mpi_rc);
+                                }
+                            }
+                            break;
+                        }
+                        /* fall through */
+                    case NNTI_OP_ATOMIC_FADD:
+                    case NNTI_OP_ATOMIC_CSWAP:
+                        data_request = &cmd_op->rdma_request();
+                        break;
+                }
+
+                if (data_request != nullptr && !cmd_op->cmd_done()) {
+                    // the target moves the data after it handles the command.
+                    // don't wait for it here.  if the target is this process,
+                    // only this thread can handle the command.
+                    int done = 0;
                     mpi_lock.lock();
-                    mpi_rc = MPI_Wait(&cmd_op->rdma_request(), &event);
+                    mpi_rc = MPI_Test(data_request, &done, MPI_STATUS_IGNORE);
                     mpi_lock.unlock();
 
                     if (mpi_rc != MPI_SUCCESS) {
-                        log_error("mpi_transport", "MPI_Wait(rdma_request) (mpi_rc=%d)", mpi_rc);
+                        log_error("mpi_transport", "MPI_Test(data_request) (mpi_rc=%d)", mpi_rc);
                     }
-                    log_debug("mpi_transport", "RDMA Event= {");
-                    log_debug("mpi_transport", "\tsource  = %d", event.MPI_SOURCE);
-                    log_debug("mpi_transport", "\ttag     = %d", event.MPI_TAG);
-                    log_debug("mpi_transport", "\terror   = %d", event.MPI_ERROR);
-                    log_debug("mpi_transport", "}");
-                    break;
-            }
-
-            nnti::datatype::nnti_event_queue    *alt_q          = nnti::datatype::nnti_event_queue::to_obj(wr.alt_eq());
-            nnti::datatype::nnti_buffer         *b              = nnti::datatype::nnti_buffer::to_obj(wr.local_hdl());
-            nnti::datatype::nnti_event_queue    *buf_q          = nnti::datatype::nnti_event_queue::to_obj(b->eq());
-            NNTI_event_t                        *e              = create_event(cmd_op);
-            bool                                 event_complete = false;
-            bool                                 release_event  = true;
-
-            log_debug("mpi_transport", "poll_op_requests() - buf_q=%p  alt_q=%p", buf_q, alt_q);
-
-            if (wr.invoke_cb(e) == NNTI_OK) {
-                log_debug("mpi_transport", "poll_op_requests() - wr.invoke_cb()");
-                event_complete = true;
-            }
-            if (!event_complete && alt_q && alt_q->invoke_cb(e) == NNTI_OK) {
-                log_debug("mpi_transport", "poll_op_requests() - alt_q->invoke_cb()");
-                event_complete = true;
-            }
-            if (!event_complete && buf_q && buf_q->invoke_cb(e) == NNTI_OK) {
-                log_debug("mpi_transport", "poll_op_requests() - buf_q->invoke_cb()");
-                event_complete = true;
-            }
-            if (!event_complete && alt_q) {
-                log_debug("mpi_transport", "poll_op_requests() - pushing on alt_q");
-                alt_q->push(e);
-                alt_q->notify();
-                event_complete = true;
-                release_event = false;
-            }
-            if (!event_complete && buf_q) {
-                log_debug("mpi_transport", "poll_op_requests() - pushing on buf_q");
-                buf_q->push(e);
-                buf_q->notify();
-                event_complete = true;
-                release_event = false;
-            }
-            if (release_event) {
-                event_freelist_->push(e);
-            }
-
-            log_debug("mpi_transport", "poll_op_requests() - event_complete == %d", event_complete ? 1 : 0);
-
-            cmd_op_freelist_->push(cmd_op);
-
-            if (cmd_op->eager()) {
-                stats_->short_sends++;
-            } else {
-                stats_->long_sends++;
-            }
+                    if (!done) {
+                        log_debug("mpi_transport", "cmd_op(id_==%d) is waiting on its data", cmd_op->id());
+                        cmd_op->cmd_done(true);
+                        add_outstanding_cmd_op(*data_request, cmd_op);
+                        continue;
+                    }
+                }
 
-            if (wr.remote_hdl() == NNTI_INVALID_HANDLE) {
-                stats_->unexpected_sends++;
+                complete_cmd_op(cmd_op);
             }
         }
     }
-    /* MPI_Testany() failure */
+    /* MPI_Testsome() failure */
     else {
-        log_error("mpi_transport", "MPI_Testany() failed: rc=%d",
+        log_error("mpi_transport", "MPI_Testsome() failed: rc=%d",
                 mpi_rc);
         nnti_rc = NNTI_EIO;
     }
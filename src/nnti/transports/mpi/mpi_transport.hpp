@@ -65,7 +65,7 @@ class mpi_transport
 
     friend class nnti::datatype::mpi_buffer;
 
-private:
+protected:
     struct whookie_stats {
         std::atomic<uint64_t> pinned_bytes;
         std::atomic<uint64_t> pinned_buffers;
@@ -78,6 +78,8 @@ private:
         std::atomic<uint64_t> long_recvs;
         std::atomic<uint64_t> gets;
         std::atomic<uint64_t> puts;
+        std::atomic<uint64_t> rma_gets;
+        std::atomic<uint64_t> rma_puts;
 
         whookie_stats()
         {
@@ -92,6 +94,8 @@ private:
             long_recvs.store(0);
             gets.store(0);
             puts.store(0);
+            rma_gets.store(0);
+            rma_puts.store(0);
         }
     };
 
@@ -128,8 +132,18 @@ private:
     std::vector<nnti::core::mpi_cmd_msg *> outstanding_msgs_;
     std::mutex                             outstanding_requests_mutex_;
 
+    // progress thread only.  completions harvested by one MPI_Testsome()
+    // and the queues to notify once the whole batch has been delivered.
+    std::vector<int>                                  testsome_indices_;
+    std::vector<nnti::core::mpi_cmd_msg *>            completed_msgs_;
+    std::vector<nnti::core::mpi_cmd_op *>             completed_ops_;
+    std::vector<nnti::datatype::nnti_event_queue *>   pending_notify_;
+
     std::mutex                             mpi_mutex_;
 
+    bool                                   rma_enabled_;  // nnti.mpi.rma
+    MPI_Win                                rma_win_;      // dynamic window that registered buffers are attached to
+
     nnti::datatype::nnti_event_queue       *unexpected_queue_;
     std::deque<nnti::core::mpi_cmd_msg *>   unexpected_msgs_;   //
 
@@ -137,12 +151,13 @@ private:
     nnti::core::nnti_freelist<NNTI_event_t*>              *event_freelist_;
     uint64_t                                               cmd_op_freelist_size_;
     nnti::core::nnti_freelist<nnti::core::mpi_cmd_op*>    *cmd_op_freelist_;
+    uint64_t                                               freelist_magazine_size_;
 
     struct whookie_stats *stats_;
 
     NNTI_attrs_t attrs_;
 
-private:
+protected:
     /**
      * @brief Initialize NNTI to use a specific transport.
      *
@@ -282,6 +297,24 @@ public:
         uint32_t           *which,
         NNTI_event_t       *event) override;
 
+    /**
+     * @brief Wait for one or more events to arrive on an event queue.
+     *
+     * \param[in]  eq       The event queue to wait on.
+     * \param[out] events   An array of at least max events.
+     * \param[in]  max      The most events to return.
+     * \param[in]  timeout  The amount of time (in milliseconds) to wait.
+     * \param[out] count    The number of events returned.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    eq_wait_many(
+        NNTI_event_queue_t  eq,
+        NNTI_event_t       *events,
+        const uint32_t      max,
+        const int           timeout,
+        uint32_t           *count) override;
+
     /**
      * @brief Retrieves the next message from the unexpected list.
      *
@@ -570,7 +603,21 @@ public:
     get_instance(
         faodel::Configuration &config);
 
-private:
+    /*
+     * Attach a registered buffer to the RMA window so that peers can
+     * reach it with MPI_Rget()/MPI_Rput().  disp is the displacement
+     * peers use to address it.  Fails if there is no RMA window.
+     */
+    NNTI_result_t
+    rma_attach(
+        char           *buf,
+        const uint64_t  len,
+        uint64_t       *disp);
+    void
+    rma_detach(
+        char           *buf);
+
+protected:
 
     void
     add_outstanding_cmd_op(
@@ -582,15 +629,9 @@ private:
         MPI_Request r,
         nnti::core::mpi_cmd_op *op);
     void
-    remove_outstanding_cmd_op(
+    compact_outstanding_cmd_ops(
         std::unique_lock<std::mutex> &req_lock,
-        int index);
-    void
-    remove_outstanding_cmd_op(
-        int index);
-    void
-    remove_outstanding_cmd_op(
-        nnti::core::mpi_cmd_op *op);
+        int first);
     void
     purge_outstanding_cmd_ops();
 
@@ -604,15 +645,9 @@ private:
         MPI_Request r,
         nnti::core::mpi_cmd_msg *msg);
     void
-    remove_outstanding_cmd_msg(
+    compact_outstanding_cmd_msgs(
         std::unique_lock<std::mutex> &req_lock,
-        int index);
-    void
-    remove_outstanding_cmd_msg(
-        int index);
-    void
-    remove_outstanding_cmd_msg(
-        nnti::core::mpi_cmd_msg *msg);
+        int first);
     void
     purge_outstanding_cmd_msgs();
 
@@ -629,6 +664,11 @@ private:
     NNTI_result_t
     teardown_command_buffer(void);
 
+    NNTI_result_t
+    setup_rma_window(void);
+    NNTI_result_t
+    teardown_rma_window(void);
+
     void
     progress(void);
     void
@@ -697,6 +737,10 @@ private:
         nnti::datatype::nnti_work_id *work_id,
         nnti::core::mpi_cmd_op       *rdma_op);
     NNTI_result_t
+    execute_rma_op(
+        nnti::datatype::nnti_work_id *work_id,
+        nnti::core::mpi_cmd_op       *rdma_op);
+    NNTI_result_t
     execute_atomic_op(
         nnti::datatype::nnti_work_id *work_id,
         nnti::core::mpi_cmd_op       *atomic_op);
@@ -713,14 +757,39 @@ private:
     complete_cswap_command(nnti::core::mpi_cmd_msg *cmd_msg);
 
     int
-    poll_msg_requests(std::vector<MPI_Request> &reqs, int &index, int &done, MPI_Status &event, nnti::core::mpi_cmd_msg *&cmd_msg);
+    poll_msg_requests(std::vector<nnti::core::mpi_cmd_msg *> &completed, int &outcount);
     NNTI_result_t
     progress_msg_requests(void);
     int
-    poll_op_requests(std::vector<MPI_Request> &reqs, int &index, int &done, MPI_Status &event, nnti::core::mpi_cmd_op *&cmd_op);
+    poll_op_requests(std::vector<nnti::core::mpi_cmd_op *> &completed, int &outcount);
     NNTI_result_t
     progress_op_requests(void);
 
+    NNTI_result_t
+    complete_cmd_op(
+        nnti::core::mpi_cmd_op *cmd_op,
+        NNTI_result_t           result = NNTI_OK);
+
+    void
+    notify_queue(nnti::datatype::nnti_event_queue *q);
+    void
+    flush_notifications(void);
+
+    /*
+     * Extension points for transports that carry some traffic outside
+     * of MPI.  progress_local_requests() is called from the progress
+     * thread and returns NNTI_OK if it did any work.
+     */
+    virtual NNTI_result_t
+    progress_local_requests(void);
+    virtual NNTI_result_t
+    recv_long_payload(
+        nnti::core::mpi_cmd_msg *cmd_msg,
+        char                    *dst);
+    virtual void
+    repost_cmd_msg(
+        nnti::core::mpi_cmd_msg *cmd_msg);
+
     NNTI_event_t *
     create_event(
         nnti::core::mpi_cmd_msg *cmd_msg,
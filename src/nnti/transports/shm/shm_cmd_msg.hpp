@@ -0,0 +1,69 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#ifndef SHM_CMD_MSG_HPP_
+#define SHM_CMD_MSG_HPP_
+
+#include "nnti/nntiConfig.h"
+
+#include <sys/types.h>
+
+#include "nnti/transports/mpi/mpi_cmd_msg.hpp"
+
+
+namespace nnti {
+namespace core {
+
+/**
+ * @brief A command message that arrived through a shared memory ring.
+ *
+ * The body is the same command message the mpi transport would have sent,
+ * so it goes through the same unpack and completion code.  The extra
+ * fields say who sent it so that a long payload can be read straight out
+ * of the sender's memory and the sender can be told when that is done.
+ */
+class shm_cmd_msg
+: public mpi_cmd_msg {
+private:
+    pid_t    sender_os_pid_;
+    uint32_t sender_op_id_;
+
+public:
+    shm_cmd_msg(
+        nnti::transports::mpi_transport *transport,
+        const uint32_t                   cmd_msg_size,
+        const char                      *body,
+        const uint32_t                   body_len,
+        const pid_t                      sender_os_pid,
+        const uint32_t                   sender_op_id)
+    : mpi_cmd_msg(transport, cmd_msg_size),
+      sender_os_pid_(sender_os_pid),
+      sender_op_id_(sender_op_id)
+    {
+        memcpy(buf(), body, (body_len < cmd_msg_size) ? body_len : cmd_msg_size);
+        return;
+    }
+
+    ~shm_cmd_msg() override {
+        return;
+    }
+
+    pid_t
+    sender_os_pid(void)
+    {
+        return sender_os_pid_;
+    }
+
+    uint32_t
+    sender_op_id(void)
+    {
+        return sender_op_id_;
+    }
+};
+
+} /* namespace core */
+} /* namespace nnti */
+
+#endif /* SHM_CMD_MSG_HPP_ */
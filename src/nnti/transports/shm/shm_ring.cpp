@@ -0,0 +1,231 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#include "nnti/nntiConfig.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+
+#include "nnti/nnti_logger.hpp"
+
+#include "nnti/transports/shm/shm_ring.hpp"
+
+// The ring lives in memory shared by several processes.  That only works
+// if the atomics are real hardware atomics and not a lock in this process.
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shm_ring needs lock free 64-bit atomics");
+
+
+namespace nnti {
+namespace core {
+
+namespace {
+
+uint64_t
+slot_stride(uint32_t slot_size)
+{
+    // slot header (16 bytes) plus the message, rounded up to a cache line
+    return ((16 + (uint64_t)slot_size) + 63) & ~(uint64_t)63;
+}
+
+}
+
+shm_ring::shm_ring(
+    const std::string &name,
+    bool               owner,
+    size_t             segment_size,
+    char              *segment)
+: name_(name),
+  owner_(owner),
+  segment_size_(segment_size),
+  segment_(segment),
+  header_((ring_header *)segment)
+{
+    return;
+}
+
+shm_ring::~shm_ring()
+{
+    munmap(segment_, segment_size_);
+    if (owner_) {
+        shm_unlink(name_.c_str());
+    }
+}
+
+shm_ring *
+shm_ring::create(
+    const std::string &name,
+    uint32_t           slot_count,
+    uint32_t           slot_size)
+{
+    uint32_t count = 1;
+    while (count < slot_count) {
+        count <<= 1;
+    }
+    size_t segment_size = sizeof(ring_header) + count * slot_stride(slot_size);
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0 && errno == EEXIST) {
+        // left behind by a process that had our pid and did not clean up
+        log_debug("shm_ring", "removing stale segment %s", name.c_str());
+        shm_unlink(name.c_str());
+        fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    }
+    if (fd < 0) {
+        log_error("shm_ring", "shm_open(%s) failed: %s", name.c_str(), strerror(errno));
+        return nullptr;
+    }
+    if (ftruncate(fd, segment_size) < 0) {
+        log_error("shm_ring", "ftruncate(%s) failed: %s", name.c_str(), strerror(errno));
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    void *segment = mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED) {
+        log_error("shm_ring", "mmap(%s) failed: %s", name.c_str(), strerror(errno));
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    shm_ring *ring = new shm_ring(name, true, segment_size, (char *)segment);
+    ring->header_->slot_count = count;
+    ring->header_->slot_size  = slot_size;
+    ring->header_->head.store(0);
+    ring->header_->tail.store(0);
+    for (uint64_t i=0;i<count;i++) {
+        ring->slot(i)->seq.store(i);
+    }
+    // publish the magic last so an early attach() can tell the ring isn't ready
+    ring->header_->magic.store(ring_magic_, std::memory_order_release);
+
+    log_debug("shm_ring", "created %s with %u slots of %u bytes", name.c_str(), count, slot_size);
+
+    return ring;
+}
+
+shm_ring *
+shm_ring::attach(
+    const std::string &name)
+{
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        log_debug("shm_ring", "shm_open(%s) failed: %s", name.c_str(), strerror(errno));
+        return nullptr;
+    }
+    struct stat st;
+    if ((fstat(fd, &st) < 0) || ((size_t)st.st_size < sizeof(ring_header))) {
+        close(fd);
+        return nullptr;
+    }
+    void *segment = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED) {
+        log_error("shm_ring", "mmap(%s) failed: %s", name.c_str(), strerror(errno));
+        return nullptr;
+    }
+
+    shm_ring *ring = new shm_ring(name, false, st.st_size, (char *)segment);
+    if (ring->header_->magic.load(std::memory_order_acquire) != ring_magic_) {
+        log_debug("shm_ring", "%s is not a ready ring", name.c_str());
+        delete ring;
+        return nullptr;
+    }
+
+    return ring;
+}
+
+shm_ring::slot_header *
+shm_ring::slot(uint64_t pos)
+{
+    uint64_t index = pos & (header_->slot_count - 1);
+    return (slot_header *)(segment_ + sizeof(ring_header) + index * slot_stride(header_->slot_size));
+}
+
+bool
+shm_ring::push(
+    const void *hdr,
+    uint32_t    hdr_len,
+    const void *body,
+    uint32_t    body_len)
+{
+    if (hdr_len + body_len > header_->slot_size) {
+        return false;
+    }
+
+    uint64_t     pos = header_->head.load(std::memory_order_relaxed);
+    slot_header *s   = nullptr;
+    while (true) {
+        s = slot(pos);
+        uint64_t seq = s->seq.load(std::memory_order_acquire);
+        int64_t  dif = (int64_t)seq - (int64_t)pos;
+        if (dif == 0) {
+            if (header_->head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return false;  // full
+        } else {
+            pos = header_->head.load(std::memory_order_relaxed);
+        }
+    }
+
+    char *payload = (char *)(s + 1);
+    memcpy(payload, hdr, hdr_len);
+    if (body_len > 0) {
+        memcpy(payload + hdr_len, body, body_len);
+    }
+    s->length = hdr_len + body_len;
+    s->seq.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+uint32_t
+shm_ring::pop(
+    char     *buf,
+    uint32_t  buf_len)
+{
+    uint64_t     pos = header_->tail.load(std::memory_order_relaxed);
+    slot_header *s   = slot(pos);
+    uint64_t     seq = s->seq.load(std::memory_order_acquire);
+
+    if (seq != pos + 1) {
+        return 0;  // empty or the producer hasn't finished copying
+    }
+
+    uint32_t length = s->length;
+    if (length > buf_len) {
+        log_error("shm_ring", "message (%u bytes) is bigger than the pop buffer (%u bytes)", length, buf_len);
+        length = buf_len;
+    }
+    memcpy(buf, (char *)(s + 1), length);
+
+    s->seq.store(pos + header_->slot_count, std::memory_order_release);
+    header_->tail.store(pos + 1, std::memory_order_relaxed);
+
+    return length;
+}
+
+uint32_t
+shm_ring::slot_size(void) const
+{
+    return header_->slot_size;
+}
+
+const std::string &
+shm_ring::name(void) const
+{
+    return name_;
+}
+
+} /* namespace core */
+} /* namespace nnti */
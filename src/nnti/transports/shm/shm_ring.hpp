@@ -0,0 +1,130 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#ifndef SHM_RING_HPP_
+#define SHM_RING_HPP_
+
+#include "nnti/nntiConfig.h"
+
+#include <atomic>
+#include <string>
+
+
+namespace nnti {
+namespace core {
+
+/**
+ * @brief A fixed size message ring in a POSIX shared memory segment.
+ *
+ * Every process using the shm transport owns one ring and drains it from
+ * its progress thread.  Other processes on the same node attach to the
+ * ring by name and push messages into it.  Any number of processes may
+ * push at the same time.  Only the owner pops.
+ *
+ * Each slot carries a sequence number.  A producer claims a slot by
+ * advancing head, copies the message in and then publishes the slot by
+ * bumping its sequence number.  The consumer only reads a slot once it
+ * has been published, so a slow producer never exposes a partial
+ * message.
+ */
+class shm_ring {
+private:
+    const static uint64_t ring_magic_ = 0x46414f44454c5348;  // "FAODELSH"
+
+    struct ring_header {
+        std::atomic<uint64_t> magic;      // set last, once the ring is ready
+        uint32_t              slot_count;
+        uint32_t              slot_size;
+        char                  pad0[48];
+        std::atomic<uint64_t> head;       // next slot a producer claims
+        char                  pad1[56];
+        std::atomic<uint64_t> tail;       // next slot the owner reads
+        char                  pad2[56];
+    };
+    struct slot_header {
+        std::atomic<uint64_t> seq;
+        uint32_t              length;
+        uint32_t              pad;
+    };
+
+private:
+    std::string  name_;
+    bool         owner_;
+    size_t       segment_size_;
+    char        *segment_;
+    ring_header *header_;
+
+private:
+    shm_ring(
+        const std::string &name,
+        bool               owner,
+        size_t             segment_size,
+        char              *segment);
+
+    slot_header *
+    slot(uint64_t pos);
+
+public:
+    ~shm_ring();
+
+    /**
+     * @brief Create a new ring that this process owns.
+     *
+     * \param[in]  name        The name of the shared memory segment (must start with '/').
+     * \param[in]  slot_count  The number of slots in the ring.  Rounded up to a power of two.
+     * \param[in]  slot_size   The largest message the ring carries.
+     * \return The new ring or nullptr if the segment could not be created.
+     */
+    static shm_ring *
+    create(
+        const std::string &name,
+        uint32_t           slot_count,
+        uint32_t           slot_size);
+
+    /**
+     * @brief Attach to a ring owned by another process.
+     *
+     * \param[in]  name  The name of the shared memory segment.
+     * \return The ring or nullptr if the segment does not exist.
+     */
+    static shm_ring *
+    attach(
+        const std::string &name);
+
+    /**
+     * @brief Copy a message made of a header and a body into the ring.
+     *
+     * \return True if the message was queued.  False if the ring is full or the message is too big.
+     */
+    bool
+    push(
+        const void *hdr,
+        uint32_t    hdr_len,
+        const void *body,
+        uint32_t    body_len);
+
+    /**
+     * @brief Copy the next message out of the ring (owner only).
+     *
+     * \param[out] buf      Where the message goes.
+     * \param[in]  buf_len  The size of buf.  Must be at least slot_size().
+     * \return The length of the message or 0 if the ring is empty.
+     */
+    uint32_t
+    pop(
+        char     *buf,
+        uint32_t  buf_len);
+
+    uint32_t
+    slot_size(void) const;
+
+    const std::string &
+    name(void) const;
+};
+
+} /* namespace core */
+} /* namespace nnti */
+
+#endif /* SHM_RING_HPP_ */
@@ -0,0 +1,891 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#include "nnti/nnti_pch.hpp"
+
+#include <mpi.h>
+
+#include <sys/prctl.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "faodel-common/Configuration.hh"
+
+#include "nnti/nnti_transport.hpp"
+#include "nnti/transports/base/base_transport.hpp"
+
+#include "nnti/nnti_types.h"
+
+#include "nnti/nnti_peer.hpp"
+#include "nnti/nnti_wid.hpp"
+#include "nnti/nnti_wr.hpp"
+#include "nnti/nnti_url.hpp"
+#include "nnti/nnti_util.hpp"
+#include "nnti/nnti_logger.hpp"
+
+#include "nnti/transports/mpi/mpi_buffer.hpp"
+#include "nnti/transports/mpi/mpi_cmd_msg.hpp"
+#include "nnti/transports/mpi/mpi_cmd_op.hpp"
+#include "nnti/transports/mpi/mpi_peer.hpp"
+
+#include "nnti/transports/shm/shm_cmd_msg.hpp"
+#include "nnti/transports/shm/shm_ring.hpp"
+#include "nnti/transports/shm/shm_transport.hpp"
+
+#include "whookie/Whookie.hh"
+#include "whookie/Server.hh"
+#include "whookie/client/Client.hh"
+
+
+namespace nnti  {
+namespace transports {
+
+namespace {
+
+const uint64_t cma_probe_magic = 0x5348414445444d41;  // "SHADEDMA"
+
+// Something that is the same for every process on this node and different
+// on every other node.  The boot id keeps two containers with the same
+// hostname on different machines apart.
+std::string
+local_host_id(void)
+{
+    char hostname[256];
+    if (gethostname(hostname, sizeof(hostname)) != 0) {
+        hostname[0] = '\0';
+    }
+    hostname[sizeof(hostname)-1] = '\0';
+
+    std::string   boot_id;
+    std::ifstream f("/proc/sys/kernel/random/boot_id");
+    std::getline(f, boot_id);
+
+    return std::string(hostname) + "/" + boot_id;
+}
+
+// Copy between this process and another one.  Loops because the kernel
+// may move less than was asked for.
+ssize_t
+cma_copy(
+    bool    read,
+    pid_t   os_pid,
+    char   *local_addr,
+    char   *remote_addr,
+    size_t  length)
+{
+    size_t done = 0;
+    while (done < length) {
+        struct iovec local  = { local_addr + done,  length - done };
+        struct iovec remote = { remote_addr + done, length - done };
+        ssize_t n = (read) ? process_vm_readv(os_pid, &local, 1, &remote, 1, 0)
+                           : process_vm_writev(os_pid, &local, 1, &remote, 1, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) {
+            errno = EFAULT;
+            return -1;
+        }
+        done += n;
+    }
+    return done;
+}
+
+}
+
+/**
+ * @brief Initialize NNTI to use a specific transport.
+ *
+ * \param[in]  config    A Configuration object that NNTI should use to configure itself.
+ * \return A result code (NNTI_OK or an error)
+ *
+ */
+shm_transport::shm_transport(
+    faodel::Configuration &config)
+    : mpi_transport(config),
+      shm_enabled_(false),
+      ring_slots_(256),
+      cma_ptracer_(false),
+      cma_probe_(cma_probe_magic),
+      ring_(nullptr),
+      pop_buf_(nullptr)
+{
+    uint64_t uint_value = 0;
+
+    if (config.GetUInt(&uint_value, "nnti.shm.ring_slots", "256") == 0) {
+        ring_slots_ = uint_value;
+    }
+    config.GetBool(&cma_ptracer_, "nnti.shm.cma", "false");
+
+    shm_stats_.ring_sends    = 0;
+    shm_stats_.ring_recvs    = 0;
+    shm_stats_.cma_gets      = 0;
+    shm_stats_.cma_puts      = 0;
+    shm_stats_.cma_bytes     = 0;
+    shm_stats_.mpi_fallbacks = 0;
+
+    return;
+}
+
+/**
+ * @brief Deactivates a specific transport.
+ *
+ * \return A result code (NNTI_OK or an error)
+ */
+shm_transport::~shm_transport()
+{
+    return;
+}
+
+NNTI_result_t
+shm_transport::start(void)
+{
+    NNTI_result_t rc = NNTI_OK;
+
+    log_debug("shm_transport", "enter");
+
+    rc = mpi_transport::start();
+    if (rc != NNTI_OK) {
+        return rc;
+    }
+
+#ifdef PR_SET_PTRACER
+    // Yama (ptrace_scope=1) only lets a process read another process's
+    // memory if the target says so.  That also lets any other process of
+    // this user ptrace us, so only do it when asked.  Without it, peers
+    // get EPERM from process_vm_readv() and fall back to MPI.
+    if (cma_ptracer_ &&
+        (prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0) != 0)) {
+        log_warn("shm_transport", "prctl(PR_SET_PTRACER) failed: %s", strerror(errno));
+    }
+#endif
+
+    host_id_ = local_host_id();
+
+    // a slot holds one of our headers plus a full mpi command message
+    uint32_t slot_size = sizeof(shm_msg_header) + cmd_msg_size_;
+    ring_ = nnti::core::shm_ring::create(ring_name(getpid()), ring_slots_, slot_size);
+    if (ring_ == nullptr) {
+        log_warn("shm_transport", "could not create a shared memory ring.  All traffic will use MPI.");
+    } else {
+        pop_buf_ = new char[slot_size];
+        shm_enabled_ = true;
+    }
+
+    whookie::Server::registerHook("/nnti/shm/info", [this] (const std::map<std::string,std::string> &args, std::stringstream &results){
+        info_cb(args, results);
+    });
+    whookie::Server::registerHook("/nnti/shm/stats", [this] (const std::map<std::string,std::string> &args, std::stringstream &results){
+        shm_stats_cb(args, results);
+    });
+
+    log_debug("shm_transport", "exit");
+
+    return NNTI_OK;
+}
+
+NNTI_result_t
+shm_transport::stop(void)
+{
+    NNTI_result_t rc = NNTI_OK;
+
+    log_debug("shm_transport", "enter");
+
+    whookie::Server::deregisterHook("/nnti/shm/info");
+    whookie::Server::deregisterHook("/nnti/shm/stats");
+
+    // stops the progress thread, so nothing touches the rings after this
+    rc = mpi_transport::stop();
+
+    shm_enabled_ = false;
+
+    std::unique_lock<std::mutex> peers_lock(peers_mutex_);
+    for (auto &p : peers_) {
+        delete p.second->ring;
+        delete p.second;
+    }
+    peers_.clear();
+    peers_lock.unlock();
+
+    delete ring_;
+    ring_ = nullptr;
+    delete[] pop_buf_;
+    pop_buf_ = nullptr;
+
+    log_debug("shm_transport", "exit");
+
+    return rc;
+}
+
+/**
+ * @brief Prepare for communication with the peer identified by url.
+ *
+ * \param[in]  url       A string that describes a peer's location on the network.
+ * \param[in]  timeout   The amount of time (in milliseconds) to wait before aborting the connection attempt.
+ * \param[out] peer_hdl  A handle to a peer that can be used for network operations.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+shm_transport::connect(
+    const char  *url,
+    const int    timeout,
+    NNTI_peer_t *peer_hdl)
+{
+    NNTI_result_t rc = mpi_transport::connect(url, timeout, peer_hdl);
+    if (rc == NNTI_OK) {
+        // find out now if the peer is local instead of on the first send
+        lookup_peer((nnti::datatype::nnti_peer *)*peer_hdl);
+    }
+    return rc;
+}
+
+/**
+ * @brief Terminate communication with this peer.
+ *
+ * \param[in] peer_hdl  A handle to a peer.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+shm_transport::disconnect(
+    NNTI_peer_t peer_hdl)
+{
+    nnti::datatype::nnti_peer *peer = (nnti::datatype::nnti_peer *)peer_hdl;
+
+    forget_peer(peer->pid());
+
+    return mpi_transport::disconnect(peer_hdl);
+}
+
+/**
+ * @brief Send a message to a peer.
+ *
+ * \param[in]  wr   A work request that describes the operation
+ * \param[out] wid  Identifier used to track this work request
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+shm_transport::send(
+    nnti::datatype::nnti_work_request *wr,
+    NNTI_work_id_t                    *wid)
+{
+    NNTI_result_t rc = NNTI_OK;
+
+    local_peer *lp = lookup_peer((nnti::datatype::nnti_peer *)wr->peer());
+    if (!lp->local) {
+        return mpi_transport::send(wr, wid);
+    }
+
+    // check before allocating anything, so a bad request has nothing to clean up
+    rc = check_lengths(wr, "SEND");
+    if (rc != NNTI_OK) {
+        return rc;
+    }
+
+    nnti::datatype::nnti_work_id *work_id = new nnti::datatype::nnti_work_id(*wr);
+    nnti::core::mpi_cmd_op       *cmd_op  = nullptr;
+
+    log_debug("shm_transport", "send - wr.local_offset=%lu", wr->local_offset());
+
+    rc = create_send_op(work_id, &cmd_op);
+    if (rc != NNTI_OK) {
+        log_error("shm_transport", "create_send_op() failed");
+        return rc;
+    }
+
+    // Only copy the part of the command message that is in use.  A long
+    // send is just the header.  The receiver reads the payload from us.
+    uint64_t header_len  = nnti::core::mpi_cmd_msg::header_length();
+    uint64_t payload_len = work_id->wr().length();
+    if (work_id->wr().flags() & NNTI_OF_ZERO_COPY) {
+        payload_len -= header_len;
+    }
+    uint64_t body_len = header_len + (cmd_op->eager() ? payload_len : 0);
+
+    if ((!cmd_op->eager() && !lp->cma) ||
+        (sizeof(shm_msg_header) + body_len > lp->ring->slot_size())) {
+        shm_stats_.mpi_fallbacks++;
+        rc = execute_cmd_op(work_id, cmd_op);
+        if (rc != NNTI_OK) {
+            log_error("shm_transport", "execute_cmd_op() failed");
+            return rc;
+        }
+        *wid = (NNTI_work_id_t)work_id;
+        return NNTI_OK;
+    }
+
+    shm_msg_header hdr;
+    hdr.type      = SHM_MSG_SEND;
+    hdr.op_id     = cmd_op->id();
+    hdr.os_pid    = getpid();
+    hdr.pad       = 0;
+    hdr.initiator = me_.pid();
+
+    if (cmd_op->eager()) {
+        // the payload is in the ring, so the send is done as far as the app is concerned
+        ring_push(lp, hdr, cmd_op->cmd_msg(), body_len);
+        std::lock_guard<std::mutex> lock(completed_mutex_);
+        completed_ops_.push_back(cmd_op);
+    } else {
+        // done when the receiver says it has read the payload
+        std::unique_lock<std::mutex> acks_lock(acks_mutex_);
+        pending_acks_[cmd_op->id()] = cmd_op;
+        acks_lock.unlock();
+        ring_push(lp, hdr, cmd_op->cmd_msg(), body_len);
+    }
+    shm_stats_.ring_sends++;
+
+    *wid = (NNTI_work_id_t)work_id;
+
+    return NNTI_OK;
+}
+
+/**
+ * @brief Transfer data to a peer.
+ *
+ * \param[in]  wr   A work request that describes the operation
+ * \param[out] wid  Identifier used to track this work request
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+shm_transport::put(
+    nnti::datatype::nnti_work_request *wr,
+    NNTI_work_id_t                    *wid)
+{
+    NNTI_result_t rc = NNTI_OK;
+
+    local_peer *lp = lookup_peer((nnti::datatype::nnti_peer *)wr->peer());
+    if (!lp->cma) {
+        return mpi_transport::put(wr, wid);
+    }
+
+    rc = check_lengths(wr, "RDMA");
+    if (rc != NNTI_OK) {
+        return rc;
+    }
+
+    nnti::datatype::nnti_work_id *work_id = new nnti::datatype::nnti_work_id(*wr);
+    nnti::core::mpi_cmd_op       *put_op  = nullptr;
+
+    rc = create_put_op(work_id, &put_op);
+    if (rc != NNTI_OK) {
+        log_error("shm_transport", "create_put_op() failed");
+        return rc;
+    }
+
+    rc = cma_transfer(lp, work_id);
+    if (rc != NNTI_OK) {
+        // not allowed to touch the peer's memory.  don't try again.
+        lp->cma = false;
+        shm_stats_.mpi_fallbacks++;
+        rc = execute_rdma_op(work_id, put_op);
+        if (rc != NNTI_OK) {
+            log_error("shm_transport", "execute_rdma_op() failed");
+            return rc;
+        }
+    } else {
+        shm_stats_.cma_puts++;
+        std::lock_guard<std::mutex> lock(completed_mutex_);
+        completed_ops_.push_back(put_op);
+    }
+
+    *wid = (NNTI_work_id_t)work_id;
+
+    return NNTI_OK;
+}
+
+/**
+ * @brief Transfer data from a peer.
+ *
+ * \param[in]  wr   A work request that describes the operation
+ * \param[out] wid  Identifier used to track this work request
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+shm_transport::get(
+    nnti::datatype::nnti_work_request *wr,
+    NNTI_work_id_t                    *wid)
+{
+    NNTI_result_t rc = NNTI_OK;
+
+    local_peer *lp = lookup_peer((nnti::datatype::nnti_peer *)wr->peer());
+    if (!lp->cma) {
+        return mpi_transport::get(wr, wid);
+    }
+
+    rc = check_lengths(wr, "RDMA");
+    if (rc != NNTI_OK) {
+        return rc;
+    }
+
+    nnti::datatype::nnti_work_id *work_id = new nnti::datatype::nnti_work_id(*wr);
+    nnti::core::mpi_cmd_op       *get_op  = nullptr;
+
+    rc = create_get_op(work_id, &get_op);
+    if (rc != NNTI_OK) {
+        log_error("shm_transport", "create_get_op() failed");
+        return rc;
+    }
+
+    rc = cma_transfer(lp, work_id);
+    if (rc != NNTI_OK) {
+        // not allowed to touch the peer's memory.  don't try again.
+        lp->cma = false;
+        shm_stats_.mpi_fallbacks++;
+        rc = execute_rdma_op(work_id, get_op);
+        if (rc != NNTI_OK) {
+            log_error("shm_transport", "execute_rdma_op() failed");
+            return rc;
+        }
+    } else {
+        shm_stats_.cma_gets++;
+        std::lock_guard<std::mutex> lock(completed_mutex_);
+        completed_ops_.push_back(get_op);
+    }
+
+    *wid = (NNTI_work_id_t)work_id;
+
+    return NNTI_OK;
+}
+
+/*************************************************************/
+
+shm_transport *
+shm_transport::get_instance(
+    faodel::Configuration &config)
+{
+    static shm_transport *instance = new shm_transport(config);
+    return instance;
+}
+
+/*************************************************************
+ * Accessors for data members specific to this interconnect.
+ *************************************************************/
+
+NNTI_result_t
+shm_transport::progress_local_requests(void)
+{
+    if (!shm_enabled_) {
+        return NNTI_ENOENT;
+    }
+
+    bool busy = false;
+    busy |= drain_completed();
+    busy |= drain_ring();
+    busy |= drain_backlogs();
+
+    return busy ? NNTI_OK : NNTI_ENOENT;
+}
+
+NNTI_result_t
+shm_transport::recv_long_payload(
+    nnti::core::mpi_cmd_msg *cmd_msg,
+    char                    *dst)
+{
+    nnti::core::shm_cmd_msg *shm_msg = dynamic_cast<nnti::core::shm_cmd_msg *>(cmd_msg);
+    if (shm_msg == nullptr) {
+        return mpi_transport::recv_long_payload(cmd_msg, dst);
+    }
+
+    NNTI_result_t               rc               = NNTI_OK;
+    nnti::datatype::mpi_buffer *initiator_buffer = cmd_msg->initiator_buffer();
+    char                       *src              = initiator_buffer->payload() + cmd_msg->initiator_offset();
+
+    log_debug("shm_transport", "long send process_vm_readv(pid=%d, src=%p, length=%lu)",
+              shm_msg->sender_os_pid(), src, cmd_msg->payload_length());
+
+    if (cma_copy(true, shm_msg->sender_os_pid(), dst, src, cmd_msg->payload_length()) < 0) {
+        log_error("shm_transport", "process_vm_readv() from pid %d failed: %s", shm_msg->sender_os_pid(), strerror(errno));
+        rc = NNTI_EIO;
+    } else {
+        shm_stats_.cma_bytes += cmd_msg->payload_length();
+    }
+
+    // let the sender finish its send, with an error if we couldn't read it
+    local_peer *lp = lookup_peer(cmd_msg->initiator_peer());
+    shm_msg_header hdr;
+    hdr.type      = (rc == NNTI_OK) ? SHM_MSG_ACK : SHM_MSG_NACK;
+    hdr.op_id     = shm_msg->sender_op_id();
+    hdr.os_pid    = getpid();
+    hdr.pad       = 0;
+    hdr.initiator = me_.pid();
+    ring_push(lp, hdr, nullptr, 0);
+
+    return rc;
+}
+
+void
+shm_transport::repost_cmd_msg(
+    nnti::core::mpi_cmd_msg *cmd_msg)
+{
+    if (dynamic_cast<nnti::core::shm_cmd_msg *>(cmd_msg) != nullptr) {
+        // ring messages are copies, not posted receives
+        delete cmd_msg;
+        return;
+    }
+    mpi_transport::repost_cmd_msg(cmd_msg);
+}
+
+std::string
+shm_transport::ring_name(pid_t os_pid)
+{
+    return "/faodel-nnti-" + std::to_string(os_pid);
+}
+
+void
+shm_transport::info_cb(
+    const std::map<std::string,std::string> &args,
+    std::stringstream                       &results)
+{
+    results << "host_id="   << host_id_                  << std::endl;
+    results << "os_pid="    << getpid()                  << std::endl;
+    results << "ring="      << (shm_enabled_ ? 1 : 0)    << std::endl;
+    results << "cma_probe=" << (uint64_t)&cma_probe_     << std::endl;
+}
+
+void
+shm_transport::shm_stats_cb(
+    const std::map<std::string,std::string> &args,
+    std::stringstream                       &results)
+{
+    faodel::ReplyStream rs(args, "Shared Memory Statistics", &results);
+
+    uint64_t local_peers = 0;
+    std::unique_lock<std::mutex> peers_lock(peers_mutex_);
+    for (auto &p : peers_) {
+        if (p.second->local) local_peers++;
+    }
+    peers_lock.unlock();
+
+    rs.tableBegin("Shared Memory Statistics");
+    rs.tableRow({"ring",          (ring_) ? ring_->name() : "none"});
+    rs.tableRow({"local_peers",   std::to_string(local_peers)});
+    rs.tableRow({"ring_sends",    std::to_string(shm_stats_.ring_sends.load())});
+    rs.tableRow({"ring_recvs",    std::to_string(shm_stats_.ring_recvs.load())});
+    rs.tableRow({"cma_gets",      std::to_string(shm_stats_.cma_gets.load())});
+    rs.tableRow({"cma_puts",      std::to_string(shm_stats_.cma_puts.load())});
+    rs.tableRow({"cma_bytes",     std::to_string(shm_stats_.cma_bytes.load())});
+    rs.tableRow({"mpi_fallbacks", std::to_string(shm_stats_.mpi_fallbacks.load())});
+    rs.tableEnd();
+    rs.Finish();
+}
+
+/*
+ * Find out if a peer is on this node.  The answer is cached, so only the
+ * first lookup of a peer asks its whookie server.
+ */
+shm_transport::local_peer *
+shm_transport::lookup_peer(
+    nnti::datatype::nnti_peer *peer)
+{
+    NNTI_process_id_t pid = peer->pid();
+
+    std::unique_lock<std::mutex> peers_lock(peers_mutex_);
+    auto iter = peers_.find(pid);
+    if (iter != peers_.end()) {
+        return iter->second;
+    }
+    peers_lock.unlock();
+
+    local_peer *lp = new local_peer();
+
+    std::string reply;
+    if (shm_enabled_ &&
+        whookie::retrieveData(peer->url().hostname(), peer->url().port(), "/nnti/shm/info", &reply) == 0) {
+
+        std::map<std::string,std::string> info;
+        std::istringstream iss(reply);
+        std::string line;
+        while (std::getline(iss, line)) {
+            size_t eq = line.find('=');
+            if (eq != std::string::npos) {
+                info[line.substr(0, eq)] = line.substr(eq+1);
+            }
+        }
+
+        if ((info["host_id"] == host_id_) && (info["ring"] == "1")) {
+            lp->os_pid = nnti::util::str2int32(info["os_pid"]);
+            lp->ring   = nnti::core::shm_ring::attach(ring_name(lp->os_pid));
+            lp->local  = (lp->ring != nullptr);
+
+            // see if the kernel lets us read the peer's memory
+            uint64_t probe = 0;
+            char    *probe_addr = (char *)nnti::util::str2uint64(info["cma_probe"]);
+            if (lp->local &&
+                (cma_copy(true, lp->os_pid, (char *)&probe, probe_addr, sizeof(probe)) == sizeof(probe)) &&
+                (probe == cma_probe_magic)) {
+                lp->cma = true;
+            }
+        }
+    }
+
+    log_debug("shm_transport", "peer %s is %s (os_pid=%d, cma=%d)",
+              peer->url().url().c_str(), lp->local.load() ? "local" : "remote", lp->os_pid, lp->cma.load() ? 1 : 0);
+
+    peers_lock.lock();
+    iter = peers_.find(pid);
+    if (iter != peers_.end()) {
+        // another thread got here first
+        delete lp->ring;
+        delete lp;
+        return iter->second;
+    }
+    peers_[pid] = lp;
+
+    return lp;
+}
+
+/*
+ * Record a peer that just sent us something through our ring.  It is on
+ * this node, so there is no need to ask it.
+ */
+shm_transport::local_peer *
+shm_transport::add_local_peer(
+    NNTI_process_id_t pid,
+    pid_t             os_pid)
+{
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+
+    auto iter = peers_.find(pid);
+    if (iter != peers_.end()) {
+        local_peer *lp = iter->second;
+        if (!lp->local && (lp->ring == nullptr)) {
+            // we thought it was remote, but it just used our ring
+            lp->os_pid = os_pid;
+            lp->ring   = nnti::core::shm_ring::attach(ring_name(os_pid));
+            lp->cma    = (lp->ring != nullptr);
+            lp->local  = (lp->ring != nullptr);
+        }
+        return lp;
+    }
+
+    local_peer *lp = new local_peer();
+    lp->os_pid = os_pid;
+    lp->ring   = nnti::core::shm_ring::attach(ring_name(os_pid));
+    lp->local  = (lp->ring != nullptr);
+    lp->cma    = lp->local.load();  // assume so until a transfer fails
+    peers_[pid] = lp;
+
+    return lp;
+}
+
+void
+shm_transport::forget_peer(
+    NNTI_process_id_t pid)
+{
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+
+    auto iter = peers_.find(pid);
+    if (iter != peers_.end()) {
+        delete iter->second->ring;
+        delete iter->second;
+        peers_.erase(iter);
+    }
+}
+
+/*
+ * Queue a message in a peer's ring.  If the ring is full, the message is
+ * kept in a backlog that the progress thread retries, so neither the app
+ * nor the progress thread ever block on a busy peer.
+ */
+void
+shm_transport::ring_push(
+    local_peer        *lp,
+    shm_msg_header    &hdr,
+    const char        *body,
+    uint32_t           body_len)
+{
+    if (lp->ring == nullptr) {
+        log_error("shm_transport", "no ring for peer with os_pid %d.  Message dropped.", lp->os_pid);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(lp->backlog_mutex);
+
+    if (lp->backlog.empty() && lp->ring->push(&hdr, sizeof(hdr), body, body_len)) {
+        return;
+    }
+
+    std::string msg((char *)&hdr, sizeof(hdr));
+    if (body_len > 0) {
+        msg.append(body, body_len);
+    }
+    lp->backlog.push_back(std::move(msg));
+}
+
+bool
+shm_transport::drain_backlogs(void)
+{
+    bool busy = false;
+
+    std::lock_guard<std::mutex> peers_lock(peers_mutex_);
+    for (auto &p : peers_) {
+        local_peer *lp = p.second;
+        std::lock_guard<std::mutex> lock(lp->backlog_mutex);
+        while (!lp->backlog.empty()) {
+            std::string &msg = lp->backlog.front();
+            if (!lp->ring->push(msg.data(), msg.size(), nullptr, 0)) {
+                break;
+            }
+            lp->backlog.pop_front();
+            busy = true;
+        }
+    }
+
+    return busy;
+}
+
+bool
+shm_transport::drain_ring(void)
+{
+    bool busy = false;
+
+    // don't starve the mpi side if the ring is always busy
+    for (int i=0;i<16;i++) {
+        uint32_t len = ring_->pop(pop_buf_, ring_->slot_size());
+        if (len < sizeof(shm_msg_header)) {
+            break;
+        }
+        busy = true;
+
+        shm_msg_header *hdr = (shm_msg_header *)pop_buf_;
+
+        if ((hdr->type == SHM_MSG_ACK) || (hdr->type == SHM_MSG_NACK)) {
+            std::unique_lock<std::mutex> acks_lock(acks_mutex_);
+            auto iter = pending_acks_.find(hdr->op_id);
+            if (iter == pending_acks_.end()) {
+                log_error("shm_transport", "ack for unknown op %u", hdr->op_id);
+                continue;
+            }
+            nnti::core::mpi_cmd_op *cmd_op = iter->second;
+            pending_acks_.erase(iter);
+            acks_lock.unlock();
+
+            if (hdr->type == SHM_MSG_NACK) {
+                // the peer can't read our memory.  send long messages over mpi from now on.
+                add_local_peer(hdr->initiator, hdr->os_pid)->cma = false;
+                complete_cmd_op(cmd_op, NNTI_EIO);
+                continue;
+            }
+            complete_cmd_op(cmd_op);
+            continue;
+        }
+
+        local_peer *lp = add_local_peer(hdr->initiator, hdr->os_pid);
+
+        nnti::core::shm_cmd_msg *cmd_msg = new nnti::core::shm_cmd_msg(this,
+                                                                        cmd_msg_size_,
+                                                                        pop_buf_ + sizeof(shm_msg_header),
+                                                                        len - sizeof(shm_msg_header),
+                                                                        hdr->os_pid,
+                                                                        hdr->op_id);
+        NNTI_result_t unpack_rc = cmd_msg->unpack();
+        shm_stats_.ring_recvs++;
+
+        if ((unpack_rc != NNTI_OK) ||
+            (cmd_msg->unexpected() && (unexpected_queue_ == nullptr))) {
+            // the sender is gone or nobody can take it.  drop it, but don't leave the sender waiting.
+            if (unpack_rc == NNTI_OK) {
+                NNTI_FAST_STAT(stats_->dropped_unexpected++;);
+            }
+            if (!cmd_msg->eager()) {
+                shm_msg_header ack = *hdr;
+                ack.type      = SHM_MSG_ACK;
+                ack.os_pid    = getpid();
+                ack.initiator = me_.pid();
+                ring_push(lp, ack, nullptr, 0);
+            }
+            delete cmd_msg;
+            continue;
+        }
+
+        complete_send_command(cmd_msg);
+    }
+
+    return busy;
+}
+
+bool
+shm_transport::drain_completed(void)
+{
+    std::deque<nnti::core::mpi_cmd_op *> ops;
+
+    std::unique_lock<std::mutex> lock(completed_mutex_);
+    ops.swap(completed_ops_);
+    lock.unlock();
+
+    for (auto op : ops) {
+        complete_cmd_op(op);
+    }
+
+    return !ops.empty();
+}
+
+/*
+ * Make sure a request stays inside its local and remote buffers.  An
+ * unexpected SEND has no remote buffer.
+ */
+NNTI_result_t
+shm_transport::check_lengths(
+    nnti::datatype::nnti_work_request *wr,
+    const char                        *op_name)
+{
+    nnti::datatype::mpi_buffer *local_buffer  = (nnti::datatype::mpi_buffer *)wr->local_hdl();
+    nnti::datatype::mpi_buffer *remote_buffer = (nnti::datatype::mpi_buffer *)wr->remote_hdl();
+
+    if (wr->local_offset() + wr->length() > local_buffer->length()) {
+        log_error("shm_transport", "%s length extends beyond the end of local buffer", op_name);
+        return NNTI_EMSGSIZE;
+    }
+    if (remote_buffer &&
+        (wr->remote_offset() + wr->length() > remote_buffer->length())) {
+        log_error("shm_transport", "%s length extends beyond the end of remote buffer", op_name);
+        return NNTI_EMSGSIZE;
+    }
+
+    return NNTI_OK;
+}
+
+/*
+ * Move the data for a GET or PUT with one copy between the two processes.
+ * The caller has already checked the lengths.
+ */
+NNTI_result_t
+shm_transport::cma_transfer(
+    local_peer                   *lp,
+    nnti::datatype::nnti_work_id *work_id)
+{
+    nnti::datatype::mpi_buffer *local_buffer  = (nnti::datatype::mpi_buffer *)work_id->wr().local_hdl();
+    uint64_t                    local_offset  = work_id->wr().local_offset();
+    nnti::datatype::mpi_buffer *remote_buffer = (nnti::datatype::mpi_buffer *)work_id->wr().remote_hdl();
+    uint64_t                    remote_offset = work_id->wr().remote_offset();
+    uint64_t                    op_length     = work_id->wr().length();
+
+    bool    read = (work_id->wr().op() == NNTI_OP_GET);
+    ssize_t n    = cma_copy(read,
+                            lp->os_pid,
+                            local_buffer->payload() + local_offset,
+                            remote_buffer->payload() + remote_offset,
+                            op_length);
+    if (n < 0) {
+        log_warn("shm_transport", "%s with pid %d failed (%s).  Using MPI for this peer.",
+                 read ? "process_vm_readv()" : "process_vm_writev()", lp->os_pid, strerror(errno));
+        return NNTI_EPERM;
+    }
+    shm_stats_.cma_bytes += op_length;
+
+    return NNTI_OK;
+}
+
+} /* namespace transports */
+} /* namespace nnti */
@@ -0,0 +1,258 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#ifndef SHM_TRANSPORT_HPP_
+#define SHM_TRANSPORT_HPP_
+
+#include "nnti/nntiConfig.h"
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "faodel-common/Configuration.hh"
+
+#include "nnti/transports/mpi/mpi_transport.hpp"
+
+
+namespace nnti  {
+
+namespace core {
+    class shm_ring;
+}
+
+namespace transports {
+
+/**
+ * @brief The mpi transport with a shared memory fast path for peers on the same node.
+ *
+ * Connections, buffers and the wire format are the mpi transport's, so the
+ * two interoperate and this transport registers under the MPI transport
+ * id.  When a peer turns out to be on the same node:
+ *  - NNTI_send() copies the command message into the peer's shared memory
+ *    ring instead of calling MPI.  Long payloads are not copied into the
+ *    ring.  The receiver reads them straight out of the sender's buffer.
+ *  - NNTI_get() and NNTI_put() are a single process_vm_readv() or
+ *    process_vm_writev() between the two registered buffers.
+ * Everything else, including atomics and all traffic to remote peers, is
+ * handed to the mpi transport.
+ */
+class shm_transport
+: public mpi_transport {
+
+private:
+    // prefix of every message in a ring
+    struct shm_msg_header {
+        uint32_t          type;       // shm_msg_type
+        uint32_t          op_id;      // id of the sender's cmd_op
+        int32_t           os_pid;     // the sender's process id
+        uint32_t          pad;
+        NNTI_process_id_t initiator;  // the sender's NNTI pid
+    };
+    enum shm_msg_type {
+        SHM_MSG_SEND = 1,  // an mpi command message follows the header
+        SHM_MSG_ACK  = 2,  // the receiver is done reading a long send
+        SHM_MSG_NACK = 3   // the receiver could not read a long send
+    };
+
+    // what we know about a peer after asking it where it runs
+    struct local_peer {
+        std::atomic<bool>                     local;    // same node and attached to its ring
+        std::atomic<bool>                     cma;      // process_vm_readv() works on it
+        pid_t                                 os_pid;
+        nnti::core::shm_ring                 *ring;
+        std::mutex                            backlog_mutex;
+        std::deque<std::string>               backlog;  // messages waiting for room in ring
+
+        local_peer()
+        : local(false), cma(false), os_pid(0), ring(nullptr)
+        {}
+    };
+
+    std::atomic<bool>                         shm_enabled_;
+    uint32_t                                  ring_slots_;
+    bool                                      cma_ptracer_;  // let any process of ours attach to us (nnti.shm.cma)
+    std::string                               host_id_;
+    uint64_t                                  cma_probe_;  // peers read this to test cross memory attach
+    nnti::core::shm_ring                     *ring_;
+    char                                     *pop_buf_;
+
+    std::mutex                                peers_mutex_;
+    std::map<NNTI_process_id_t, local_peer *> peers_;
+
+    std::mutex                                completed_mutex_;
+    std::deque<nnti::core::mpi_cmd_op *>      completed_ops_;   // local ops waiting for their event
+
+    std::mutex                                acks_mutex_;
+    std::map<uint32_t, nnti::core::mpi_cmd_op *> pending_acks_; // long sends the receiver hasn't read yet
+
+    struct {
+        std::atomic<uint64_t> ring_sends;
+        std::atomic<uint64_t> ring_recvs;
+        std::atomic<uint64_t> cma_gets;
+        std::atomic<uint64_t> cma_puts;
+        std::atomic<uint64_t> cma_bytes;
+        std::atomic<uint64_t> mpi_fallbacks;
+    } shm_stats_;
+
+protected:
+    /**
+     * @brief Initialize NNTI to use a specific transport.
+     *
+     * \param[in]  config    A Configuration object that NNTI should use to configure itself.
+     * \return A result code (NNTI_OK or an error)
+     *
+     */
+    shm_transport(
+        faodel::Configuration &config);
+
+public:
+    /**
+     * @brief Deactivates a specific transport.
+     *
+     * \return A result code (NNTI_OK or an error)
+     */
+    virtual
+    ~shm_transport();
+
+    NNTI_result_t
+    start(void) override;
+
+    NNTI_result_t
+    stop(void) override;
+
+    /**
+     * @brief Prepare for communication with the peer identified by url.
+     *
+     * \param[in]  url       A string that describes a peer's location on the network.
+     * \param[in]  timeout   The amount of time (in milliseconds) to wait before aborting the connection attempt.
+     * \param[out] peer_hdl  A handle to a peer that can be used for network operations.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    connect(
+        const char  *url,
+        const int    timeout,
+        NNTI_peer_t *peer_hdl) override;
+
+    /**
+     * @brief Terminate communication with this peer.
+     *
+     * \param[in] peer_hdl  A handle to a peer.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    disconnect(
+        NNTI_peer_t peer_hdl) override;
+
+    /**
+     * @brief Send a message to a peer.
+     *
+     * \param[in]  wr   A work request that describes the operation
+     * \param[out] wid  Identifier used to track this work request
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    send(
+        nnti::datatype::nnti_work_request *wr,
+        NNTI_work_id_t                    *wid) override;
+
+    /**
+     * @brief Transfer data to a peer.
+     *
+     * \param[in]  wr   A work request that describes the operation
+     * \param[out] wid  Identifier used to track this work request
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    put(
+        nnti::datatype::nnti_work_request *wr,
+        NNTI_work_id_t                    *wid) override;
+
+    /**
+     * @brief Transfer data from a peer.
+     *
+     * \param[in]  wr   A work request that describes the operation
+     * \param[out] wid  Identifier used to track this work request
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    get(
+        nnti::datatype::nnti_work_request *wr,
+        NNTI_work_id_t                    *wid) override;
+
+public:
+    static shm_transport*
+    get_instance(
+        faodel::Configuration &config);
+
+protected:
+    NNTI_result_t
+    progress_local_requests(void) override;
+
+    NNTI_result_t
+    recv_long_payload(
+        nnti::core::mpi_cmd_msg *cmd_msg,
+        char                    *dst) override;
+
+    void
+    repost_cmd_msg(
+        nnti::core::mpi_cmd_msg *cmd_msg) override;
+
+private:
+    static std::string
+    ring_name(pid_t os_pid);
+
+    void
+    info_cb(
+        const std::map<std::string,std::string> &args,
+        std::stringstream                       &results);
+    void
+    shm_stats_cb(
+        const std::map<std::string,std::string> &args,
+        std::stringstream                       &results);
+
+    local_peer *
+    lookup_peer(
+        nnti::datatype::nnti_peer *peer);
+    local_peer *
+    add_local_peer(
+        NNTI_process_id_t pid,
+        pid_t             os_pid);
+    void
+    forget_peer(
+        NNTI_process_id_t pid);
+
+    void
+    ring_push(
+        local_peer        *lp,
+        shm_msg_header    &hdr,
+        const char        *body,
+        uint32_t           body_len);
+    bool
+    drain_backlogs(void);
+    bool
+    drain_ring(void);
+    bool
+    drain_completed(void);
+
+    NNTI_result_t
+    check_lengths(
+        nnti::datatype::nnti_work_request *wr,
+        const char                        *op_name);
+    NNTI_result_t
+    cma_transfer(
+        local_peer                   *lp,
+        nnti::datatype::nnti_work_id *work_id);
+};
+
+} /* namespace transports */
+} /* namespace nnti */
+
+#endif /* SHM_TRANSPORT_HPP_*/
@@ -0,0 +1,139 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#include "nnti/nnti_pch.hpp"
+
+#include "nnti/nntiConfig.h"
+
+#include <assert.h>
+
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "nnti/nnti_logger.hpp"
+#include "nnti/nnti_serialize.hpp"
+#include "nnti/nnti_types.h"
+
+#include "nnti/nnti_callback.hpp"
+
+#include "nnti/transports/sockets/sockets_transport.hpp"
+#include "nnti/transports/sockets/sockets_buffer.hpp"
+
+
+namespace nnti  {
+namespace datatype {
+
+sockets_buffer::sockets_buffer()
+    : nnti_buffer()
+{
+    return;
+}
+
+sockets_buffer::sockets_buffer(
+    nnti::datatype::sockets_buffer &b)
+: nnti_buffer(b)
+{
+    memcpy(packed_, b.packed_, packed_size_);
+
+    return;
+}
+
+sockets_buffer::sockets_buffer(
+    nnti::transports::sockets_transport *transport,
+    const uint64_t                       size,
+    const NNTI_buffer_flags_t            flags,
+    NNTI_event_queue_t                   eq,
+    nnti_event_callback                  cb,
+    void                                *cb_context)
+: nnti_buffer(transport,
+              size,
+              flags,
+              eq,
+              cb,
+              cb_context)
+{
+    register_buffer();
+    internal_pack();
+
+    return;
+}
+
+sockets_buffer::sockets_buffer(
+    nnti::transports::sockets_transport *transport,
+    char                                *buffer,
+    const uint64_t                       size,
+    const NNTI_buffer_flags_t            flags,
+    NNTI_event_queue_t                   eq,
+    nnti_event_callback                  cb,
+    void                                *cb_context)
+: nnti_buffer(transport,
+              buffer,
+              size,
+              flags,
+              eq,
+              cb,
+              cb_context)
+{
+    register_buffer();
+    internal_pack();
+
+    return;
+}
+
+sockets_buffer::sockets_buffer(
+    nnti::transports::transport *transport,
+    char                        *packed_buf,
+    const uint64_t               packed_len)
+: nnti_buffer(transport,
+              packed_buf,
+              packed_len)
+{
+    payload_      = (char *)packable_.buffer.NNTI_remote_addr_p_t_u.sockets.buf;
+    payload_size_ = packable_.buffer.NNTI_remote_addr_p_t_u.sockets.size;
+
+    log_debug("sockets_buffer", "ctor unpack - buf(%p) size(%u)",
+        payload_, packable_.buffer.NNTI_remote_addr_p_t_u.sockets.size);
+
+    return;
+}
+
+sockets_buffer::~sockets_buffer()
+{
+    return;
+}
+
+char*
+sockets_buffer::payload(void)
+{
+    return payload_;
+}
+
+size_t
+sockets_buffer::length(void)
+{
+    return packable_.buffer.NNTI_remote_addr_p_t_u.sockets.size;
+}
+
+NNTI_result_t
+sockets_buffer::register_buffer(void)
+{
+    log_debug("sockets_buffer", "enter buffer(%p) len(%d)", payload_, payload_size_);
+
+    memset(&packable_, 0, sizeof(NNTI_buffer_p_t));
+    packable_.buffer.transport_id                        = NNTI_TRANSPORT_SOCKETS;
+    packable_.buffer.NNTI_remote_addr_p_t_u.sockets.buf  = (uint64_t)payload_;
+    packable_.buffer.NNTI_remote_addr_p_t_u.sockets.size = payload_size_;
+
+    log_debug("sockets_buffer", "exit (payload_==%p, buf==%p, size==%u)",
+        payload_,
+        packable_.buffer.NNTI_remote_addr_p_t_u.sockets.buf,
+        packable_.buffer.NNTI_remote_addr_p_t_u.sockets.size);
+
+    return NNTI_OK;
+}
+
+} /* namespace datatype */
+} /* namespace nnti */
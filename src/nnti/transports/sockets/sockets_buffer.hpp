@@ -0,0 +1,82 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#ifndef SOCKETS_BUFFER_HPP_
+#define SOCKETS_BUFFER_HPP_
+
+#include "nnti/nntiConfig.h"
+
+#include <assert.h>
+
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "nnti/nnti_serialize.hpp"
+#include "nnti/nnti_types.h"
+
+#include "nnti/nnti_buffer.hpp"
+#include "nnti/nnti_callback.hpp"
+
+
+namespace nnti  {
+
+namespace transports {
+    // forward declaration
+    class sockets_transport;
+}
+
+namespace datatype {
+
+/**
+ * @brief A buffer that the sockets transport can move data in and out of.
+ *
+ * There is nothing to pin or register.  A peer names the buffer by its
+ * base address and the target looks the address up in its buffer map
+ * before it reads or writes anything.
+ */
+class sockets_buffer
+: public nnti_buffer {
+private:
+    NNTI_result_t
+    register_buffer(void);
+
+public:
+    sockets_buffer(void);
+    sockets_buffer(
+        nnti::datatype::sockets_buffer &b);
+    sockets_buffer(
+        nnti::transports::sockets_transport *transport,
+        const uint64_t                       size,
+        const NNTI_buffer_flags_t            flags,
+        NNTI_event_queue_t                   eq,
+        nnti_event_callback                  cb,
+        void                                *cb_context);
+    sockets_buffer(
+        nnti::transports::sockets_transport *transport,
+        char                                *buffer,
+        const uint64_t                       size,
+        const NNTI_buffer_flags_t            flags,
+        NNTI_event_queue_t                   eq,
+        nnti_event_callback                  cb,
+        void                                *cb_context);
+    sockets_buffer(
+        nnti::transports::transport *transport,
+        char                        *packed_buf,
+        const uint64_t               packed_len);
+
+    virtual ~sockets_buffer();
+
+    char*
+    payload(void) override;
+
+    size_t
+    length(void);
+};
+
+} /* namespace datatype */
+} /* namespace nnti */
+
+#endif /* SOCKETS_BUFFER_HPP_ */
@@ -0,0 +1,145 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#ifndef SOCKETS_CHANNEL_HPP_
+#define SOCKETS_CHANNEL_HPP_
+
+#include "nnti/nntiConfig.h"
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "nnti/nnti_types.h"
+
+#include "nnti/transports/sockets/sockets_msg.hpp"
+
+
+namespace nnti {
+
+namespace transports {
+    class sockets_transport;
+}
+
+namespace core {
+
+class sockets_cmd_op;
+
+/**
+ * @brief One TCP connection between two sockets transports.
+ *
+ * A process opens an outbound channel to each peer it starts operations
+ * on.  The peer accepts it as an inbound channel and sends its replies
+ * back on it, so every reply arrives on the channel its request left on.
+ *
+ * Any thread may queue messages.  Whoever queues a message tries to
+ * write it right away and leaves the rest to the progress thread.  Only
+ * the progress thread reads.
+ */
+class sockets_channel {
+
+    friend class nnti::transports::sockets_transport;
+
+private:
+    enum recv_state {
+        RECV_HEADER,
+        RECV_PAYLOAD
+    };
+
+    int                                   fd_;
+    bool                                  outbound_;
+    NNTI_process_id_t                     peer_pid_;   // 0 for inbound channels
+
+    // send side (send_mutex_)
+    std::mutex                            send_mutex_;
+    std::deque<sockets_msg *>             send_queue_;
+    bool                                  want_write_; // EPOLLOUT is armed
+    bool                                  closed_;
+
+    // ops waiting for a reply from the peer (ops_mutex_)
+    std::mutex                            ops_mutex_;
+    std::map<uint32_t, sockets_cmd_op *>  waiting_ops_;
+
+    // receive side (progress thread only)
+    recv_state                            state_;
+    sockets_msg_header                    hdr_;          // the message being received
+    uint32_t                              hdr_have_;
+    sockets_msg_header                    next_hdr_;     // read ahead while finishing a payload
+    char                                 *dst_;          // where the payload goes.  nullptr discards it.
+    uint64_t                              have_;         // payload bytes received so far
+    std::vector<char>                     staging_;      // payload bound for a queuing buffer
+    char                                 *unexpected_;   // payload of an unexpected send
+    sockets_cmd_op                       *reply_op_;     // op this reply belongs to
+
+public:
+    sockets_channel(
+        int               fd,
+        bool              outbound,
+        NNTI_process_id_t peer_pid)
+    : fd_(fd),
+      outbound_(outbound),
+      peer_pid_(peer_pid),
+      want_write_(false),
+      closed_(false),
+      state_(RECV_HEADER),
+      hdr_have_(0),
+      dst_(nullptr),
+      have_(0),
+      unexpected_(nullptr),
+      reply_op_(nullptr)
+    {
+        return;
+    }
+
+    ~sockets_channel()
+    {
+        delete [] unexpected_;
+        return;
+    }
+
+    int
+    fd(void) const
+    {
+        return fd_;
+    }
+
+    bool
+    outbound(void) const
+    {
+        return outbound_;
+    }
+
+    NNTI_process_id_t
+    peer_pid(void) const
+    {
+        return peer_pid_;
+    }
+
+    void
+    add_waiting_op(uint32_t id, sockets_cmd_op *op)
+    {
+        std::lock_guard<std::mutex> lock(ops_mutex_);
+        waiting_ops_[id] = op;
+    }
+
+    sockets_cmd_op *
+    take_waiting_op(uint32_t id)
+    {
+        std::lock_guard<std::mutex> lock(ops_mutex_);
+        sockets_cmd_op *op = nullptr;
+        auto iter = waiting_ops_.find(id);
+        if (iter != waiting_ops_.end()) {
+            op = iter->second;
+            waiting_ops_.erase(iter);
+        }
+        return op;
+    }
+};
+
+} /* namespace core */
+} /* namespace nnti */
+
+#endif /* SOCKETS_CHANNEL_HPP_ */
@@ -0,0 +1,105 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#ifndef SOCKETS_CMD_OP_HPP_
+#define SOCKETS_CMD_OP_HPP_
+
+#include "nnti/nntiConfig.h"
+
+#include <sstream>
+#include <string>
+
+#include "nnti/nnti_op.hpp"
+#include "nnti/nnti_wid.hpp"
+
+#include "nnti/transports/sockets/sockets_msg.hpp"
+
+
+namespace nnti {
+namespace core {
+
+class sockets_channel;
+
+/**
+ * @brief An operation started by this process.
+ *
+ * The op owns the message that starts the operation.  Sends complete
+ * once the message has been written.  Everything else waits on its
+ * channel for the target's reply.
+ */
+class sockets_cmd_op
+: public nnti_op {
+private:
+    sockets_msg      msg_;
+    sockets_channel *channel_;
+    NNTI_result_t    result_;
+
+public:
+    sockets_cmd_op(void)
+    : nnti_op(),
+      channel_(nullptr),
+      result_(NNTI_OK)
+    {
+        return;
+    }
+
+    ~sockets_cmd_op() override {
+        return;
+    }
+
+    /*
+     * Reuse this op for a new work request.
+     */
+    void
+    set(nnti::datatype::nnti_work_id *wid)
+    {
+        id_      = next_id_.fetch_add(1);
+        wid_     = wid;
+        msg_     = sockets_msg();
+        msg_.op  = this;
+        channel_ = nullptr;
+        result_  = NNTI_OK;
+    }
+
+    sockets_msg *
+    msg(void)
+    {
+        return &msg_;
+    }
+
+    void
+    channel(sockets_channel *c)
+    {
+        channel_ = c;
+    }
+    sockets_channel *
+    channel(void)
+    {
+        return channel_;
+    }
+
+    void
+    result(NNTI_result_t rc)
+    {
+        result_ = rc;
+    }
+    NNTI_result_t
+    result(void)
+    {
+        return result_;
+    }
+
+    std::string
+    toString(void) override {
+        std::stringstream out;
+        out << "id_==" << id_ << " type==" << msg_.hdr.type << " payload_length==" << msg_.hdr.payload_length;
+        return out.str();
+    }
+};
+
+} /* namespace core */
+} /* namespace nnti */
+
+#endif /* SOCKETS_CMD_OP_HPP_ */
@@ -0,0 +1,183 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#ifndef SOCKETS_CONNECTION_HPP_
+#define SOCKETS_CONNECTION_HPP_
+
+#include "nnti/nntiConfig.h"
+
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include "nnti/nnti_connection.hpp"
+#include "nnti/nnti_util.hpp"
+
+#include "nnti/transports/sockets/sockets_peer.hpp"
+#include "nnti/transports/sockets/sockets_transport.hpp"
+
+
+namespace nnti {
+namespace core {
+
+class sockets_channel;
+
+/**
+ * @brief What the sockets transport knows about a peer.
+ *
+ * The parameters come from the whookie connect handshake.  The data
+ * channel is opened the first time this process has something to send
+ * to the peer, so a peer that only ever replies to us never opens one.
+ */
+class sockets_connection
+: public nnti_connection {
+private:
+    struct connection_params {
+        std::string hostname;
+        uint32_t    addr;
+        uint32_t    port;
+        std::string fingerprint;
+        uint32_t    data_port;
+
+        connection_params(void)
+        : addr(0), port(0), data_port(0)
+        {
+            return;
+        }
+        connection_params(const std::map<std::string,std::string> &peer)
+        : addr(0), port(0), data_port(0)
+        {
+            try {
+                hostname    = peer.at("hostname");
+                addr        = nnti::util::str2uint32(peer.at("addr"));
+                port        = nnti::util::str2uint32(peer.at("port"));
+                fingerprint = peer.at("fingerprint");
+                data_port   = nnti::util::str2uint32(peer.at("data_port"));
+            }
+            catch (const std::out_of_range& oor) {
+                log_error_stream("connection_params") << "Out of Range error: " << oor.what();
+            }
+        }
+    };
+
+private:
+    nnti::transports::sockets_transport *transport_;
+    connection_params                    peer_params_;
+
+    std::mutex                           channel_mutex_;
+    sockets_channel                     *channel_;
+
+public:
+    sockets_connection(
+        nnti::transports::sockets_transport *transport)
+    : nnti_connection(),
+      transport_(transport),
+      channel_(nullptr)
+    {
+        return;
+    }
+    sockets_connection(
+        nnti::transports::sockets_transport     *transport,
+        const std::map<std::string,std::string> &peer)
+    : nnti_connection(),
+      transport_(transport),
+      peer_params_(peer),
+      channel_(nullptr)
+    {
+        nnti::core::nnti_url url = nnti::core::nnti_url(peer_params_.hostname, peer_params_.port);
+        peer_pid_ = url.pid();
+        peer_     = new nnti::datatype::sockets_peer(transport, url, peer_params_.data_port);
+        peer_->conn(this);
+        fingerprint_ = peer_params_.fingerprint;
+
+        log_debug("sockets_connection", "hostname=%s port=%u data_port=%u fingerprint=%s",
+                  peer_params_.hostname.c_str(), peer_params_.port, peer_params_.data_port, peer_params_.fingerprint.c_str());
+    }
+
+    ~sockets_connection() override {
+        return;
+    }
+
+    void
+    peer_params(
+        const std::string &params)
+    {
+        std::map<std::string,std::string> param_map;
+        std::istringstream iss(params);
+        std::string line;
+        while (std::getline(iss, line)) {
+            size_t p = line.find('=');
+            if (p == std::string::npos) {
+                continue;
+            }
+            param_map[line.substr(0, p)] = line.substr(p+1);
+        }
+
+        peer_params_ = connection_params(param_map);
+        nnti::core::nnti_url url = nnti::core::nnti_url(peer_params_.hostname, peer_params_.port);
+        peer_pid_ = url.pid();
+        ((nnti::datatype::sockets_peer*)peer_)->data_port(peer_params_.data_port);
+        fingerprint_ = peer_params_.fingerprint;
+
+        log_debug("sockets_connection", "hostname=%s port=%u data_port=%u fingerprint=%s",
+                  peer_params_.hostname.c_str(), peer_params_.port, peer_params_.data_port, peer_params_.fingerprint.c_str());
+    }
+
+    const std::string &
+    hostname(void) const
+    {
+        return peer_params_.hostname;
+    }
+
+    uint32_t
+    data_port(void) const
+    {
+        return peer_params_.data_port;
+    }
+
+    /*
+     * The channel used to send to this peer.  Opens it if necessary.
+     * Returns nullptr if the peer can't be reached.
+     */
+    sockets_channel *
+    channel(void)
+    {
+        std::lock_guard<std::mutex> lock(channel_mutex_);
+        if (channel_ == nullptr) {
+            channel_ = transport_->open_channel(this);
+        }
+        return channel_;
+    }
+
+    /*
+     * Forget the channel.  The caller is responsible for closing it.
+     */
+    sockets_channel *
+    detach_channel(void)
+    {
+        std::lock_guard<std::mutex> lock(channel_mutex_);
+        sockets_channel *c = channel_;
+        channel_ = nullptr;
+        return c;
+    }
+
+    /*
+     * Forget the channel if it is c, which the transport is closing.
+     */
+    void
+    forget_channel(sockets_channel *c)
+    {
+        std::lock_guard<std::mutex> lock(channel_mutex_);
+        if (channel_ == c) {
+            channel_ = nullptr;
+        }
+    }
+};
+
+} /* namespace core */
+} /* namespace nnti */
+
+#endif /* SOCKETS_CONNECTION_HPP_ */
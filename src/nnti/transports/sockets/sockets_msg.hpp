@@ -0,0 +1,77 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#ifndef SOCKETS_MSG_HPP_
+#define SOCKETS_MSG_HPP_
+
+#include "nnti/nntiConfig.h"
+
+#include <stdint.h>
+#include <string.h>
+
+
+namespace nnti {
+namespace core {
+
+class sockets_cmd_op;
+
+/*
+ * Every message on a data channel is this header followed by
+ * payload_length bytes of payload.  The header is 64 bytes so that a
+ * header and a short payload usually arrive in one segment.
+ */
+struct sockets_msg_header {
+    uint32_t type;              // sockets_msg_type
+    uint32_t op_id;             // the initiator's op, echoed in replies
+    uint64_t initiator;         // NNTI pid of the process that started the operation
+    uint64_t target_base_addr;  // base address of the target buffer.  0 for unexpected sends.
+    uint64_t target_offset;
+    uint64_t payload_length;
+    int64_t  operand1;          // atomics and get lengths.  replies carry the fetched value here.
+    int64_t  operand2;          // replies carry an NNTI_result_t here
+    uint64_t pad;
+};
+
+enum sockets_msg_type {
+    SOCKETS_MSG_SEND         = 1,  // payload is the message
+    SOCKETS_MSG_GET_REQUEST  = 2,  // no payload.  operand1 is the length.  target answers with GET_REPLY.
+    SOCKETS_MSG_GET_REPLY    = 3,  // payload is the data read from the target buffer
+    SOCKETS_MSG_PUT          = 4,  // payload is written into the target buffer
+    SOCKETS_MSG_PUT_ACK      = 5,  // no payload.  the put is visible at the target.
+    SOCKETS_MSG_FADD         = 6,  // no payload
+    SOCKETS_MSG_CSWAP        = 7,  // no payload
+    SOCKETS_MSG_ATOMIC_REPLY = 8   // no payload.  operand1 is the value before the atomic.
+};
+
+/**
+ * @brief One message waiting in a channel's send queue.
+ *
+ * The payload is not copied.  It points into a registered buffer, so the
+ * header and the payload go out together with one sendmsg() and the
+ * buffer must not be released until the message has been written.
+ */
+struct sockets_msg {
+    sockets_msg_header  hdr;
+    char               *payload;
+    uint64_t            written;   // bytes of header plus payload already written
+    sockets_cmd_op     *op;        // completes when the message is written, or nullptr
+
+    sockets_msg()
+    : payload(nullptr), written(0), op(nullptr)
+    {
+        memset(&hdr, 0, sizeof(hdr));
+    }
+
+    uint64_t
+    total_length(void) const
+    {
+        return sizeof(hdr) + hdr.payload_length;
+    }
+};
+
+} /* namespace core */
+} /* namespace nnti */
+
+#endif /* SOCKETS_MSG_HPP_ */
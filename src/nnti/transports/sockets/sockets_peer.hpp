@@ -0,0 +1,72 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#ifndef SOCKETS_PEER_HPP
+#define SOCKETS_PEER_HPP
+
+#include "nnti/nntiConfig.h"
+
+#include <assert.h>
+
+#include <sstream>
+#include <string>
+
+#include "nnti/nnti_serialize.hpp"
+#include "nnti/nnti_peer.hpp"
+#include "nnti/nnti_url.hpp"
+
+
+namespace nnti  {
+namespace datatype {
+
+/**
+ * @brief A peer of the sockets transport.
+ *
+ * The url is the peer's whookie address, which is what the pid is made
+ * from.  The data connection goes to the same address on the port the
+ * peer's transport listens on.
+ */
+class sockets_peer
+: public nnti_peer {
+public:
+    sockets_peer(
+        nnti::transports::transport *transport,
+        const nnti::core::nnti_url  &url,
+        const NNTI_tcp_port          data_port)
+    : nnti_peer(transport,
+                url)
+    {
+        memset(&packable_, 0, sizeof(NNTI_peer_p_t));
+        packable_.peer.transport_id                            = transport->id();
+        packable_.peer.NNTI_remote_process_p_t_u.sockets.addr  = url_.addr();
+        packable_.peer.NNTI_remote_process_p_t_u.sockets.port  = data_port;
+        packable_.pid = url_.pid();
+
+        log_debug_stream("sockets_peer") << "sockets_peer.url == " << url_;
+
+        return;
+    }
+
+    ~sockets_peer() override {
+        return;
+    }
+
+    void
+    data_port(NNTI_tcp_port port)
+    {
+        packable_.peer.NNTI_remote_process_p_t_u.sockets.port = port;
+    }
+
+    NNTI_tcp_port
+    data_port(void)
+    {
+        return packable_.peer.NNTI_remote_process_p_t_u.sockets.port;
+    }
+};
+
+} /* namespace datatype */
+} /* namespace nnti */
+
+#endif /* SOCKETS_PEER_HPP */
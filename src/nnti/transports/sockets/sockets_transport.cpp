@@ -0,0 +1,2391 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#include "nnti/nnti_pch.hpp"
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <map>
+#include <vector>
+
+#include "faodel-common/Configuration.hh"
+
+#include "nnti/nnti_transport.hpp"
+#include "nnti/transports/base/base_transport.hpp"
+
+#include "nnti/nnti_types.h"
+
+#include "nnti/nnti_callback.hpp"
+#include "nnti/nnti_connection.hpp"
+#include "nnti/nnti_eq.hpp"
+#include "nnti/nnti_peer.hpp"
+#include "nnti/nnti_wid.hpp"
+#include "nnti/nnti_wr.hpp"
+#include "nnti/nnti_url.hpp"
+#include "nnti/nnti_util.hpp"
+#include "nnti/nnti_logger.hpp"
+
+#include "nnti/transports/sockets/sockets_buffer.hpp"
+#include "nnti/transports/sockets/sockets_channel.hpp"
+#include "nnti/transports/sockets/sockets_cmd_op.hpp"
+#include "nnti/transports/sockets/sockets_connection.hpp"
+#include "nnti/transports/sockets/sockets_msg.hpp"
+#include "nnti/transports/sockets/sockets_peer.hpp"
+
+#include "nnti/transports/sockets/sockets_transport.hpp"
+
+#include "whookie/Whookie.hh"
+#include "whookie/Server.hh"
+
+
+namespace nnti  {
+namespace transports {
+
+/**
+ * @brief Initialize NNTI to use a specific transport.
+ *
+ * \param[in]  config    A Configuration object that NNTI should use to configure itself.
+ * \return A result code (NNTI_OK or an error)
+ *
+ */
+sockets_transport::sockets_transport(
+    faodel::Configuration &config)
+    : base_transport(NNTI_TRANSPORT_SOCKETS,
+                     config),
+      started_(false),
+      listen_fd_(-1),
+      data_port_(0),
+      epoll_fd_(-1),
+      wakeup_fd_(-1),
+      listen_tag_(0),
+      wakeup_tag_(0),
+      unexpected_queue_(nullptr),
+      event_freelist_size_(128),
+      cmd_op_freelist_size_(128),
+      freelist_magazine_size_(16),
+      stats_(nullptr)
+{
+    faodel::rc_t rc = 0;
+    uint64_t uint_value = 0;
+
+    nthread_lock_init(&new_connection_lock_);
+
+    rc = config.GetUInt(&uint_value, "nnti.freelist.size", "128");
+    if (rc == 0) {
+        event_freelist_size_     = uint_value;
+        cmd_op_freelist_size_    = uint_value;
+    }
+    // per-thread cache in front of each freelist.  0 turns the cache off.
+    config.GetUInt(&freelist_magazine_size_, "nnti.freelist.magazine_size", "16");
+    event_freelist_     = new nnti::core::nnti_freelist<NNTI_event_t*>(event_freelist_size_, freelist_magazine_size_);
+    cmd_op_freelist_    = new nnti::core::nnti_freelist<nnti::core::sockets_cmd_op*>(cmd_op_freelist_size_, freelist_magazine_size_);
+
+    // 0 lets the kernel pick the port.  Peers learn it from the connect handshake.
+    rc = config.GetUInt(&uint_value, "nnti.sockets.port", "0");
+    if (rc == 0) {
+        data_port_ = uint_value;
+    }
+
+    return;
+}
+
+/**
+ * @brief Deactivates a specific transport.
+ *
+ * \return A result code (NNTI_OK or an error)
+ */
+sockets_transport::~sockets_transport()
+{
+    nthread_lock_fini(&new_connection_lock_);
+
+    return;
+}
+
+NNTI_result_t
+sockets_transport::start(void)
+{
+    NNTI_result_t rc = NNTI_OK;
+
+    log_debug("sockets_transport", "enter");
+
+    rc = setup_listener();
+    if (rc) {
+        log_error("sockets_transport", "setup_listener() failed");
+        return NNTI_EIO;
+    }
+    rc = setup_epoll();
+    if (rc) {
+        log_error("sockets_transport", "setup_epoll() failed");
+        return NNTI_EIO;
+    }
+
+    faodel::nodeid_t nodeid = whookie::Server::GetNodeID();
+    std::string addr = nodeid.GetIP();
+    std::string port = nodeid.GetPort();
+    url_ = nnti::core::nnti_url(addr, port);
+    me_ = nnti::datatype::sockets_peer(this, url_, data_port_);
+    log_debug_stream("sockets_transport") << "me_ = " << me_.url().url() << " data_port_ = " << data_port_;
+
+    cmd_msg_size_  = 2048;
+    cmd_msg_count_ = 64;
+    log_debug("sockets_transport", "cmd_msg_size_(%u) cmd_msg_count_(%u)", cmd_msg_size_, cmd_msg_count_);
+
+    attrs_.mtu                 = cmd_msg_size_;
+    attrs_.max_cmd_header_size = sizeof(nnti::core::sockets_msg_header);
+    attrs_.max_eager_size      = attrs_.mtu - attrs_.max_cmd_header_size;
+    attrs_.cmd_queue_size      = cmd_msg_count_;
+    log_debug("sockets_transport", "attrs_.mtu                =%d", attrs_.mtu);
+    log_debug("sockets_transport", "attrs_.max_cmd_header_size=%d", attrs_.max_cmd_header_size);
+    log_debug("sockets_transport", "attrs_.max_eager_size     =%d", attrs_.max_eager_size);
+    log_debug("sockets_transport", "attrs_.cmd_queue_size     =%d", attrs_.cmd_queue_size);
+
+    rc = setup_freelists();
+    if (rc) {
+        log_error("sockets_transport", "setup_freelists() failed");
+        return NNTI_EIO;
+    }
+
+    stats_ = new struct whookie_stats;
+
+    assert(whookie::Server::IsRunning() && "whookie is not running.  Confirm Bootstrap configuration and try again.");
+
+    register_whookie_cb();
+
+    log_debug("sockets_transport", "url_=%s", url_.url().c_str());
+
+    start_progress_thread();
+
+    started_ = true;
+
+    log_debug("sockets_transport", "exit");
+
+    return NNTI_OK;
+}
+
+NNTI_result_t
+sockets_transport::stop(void)
+{
+    NNTI_result_t rc=NNTI_OK;;
+    nnti::core::nnti_connection_map_iter_t iter;
+
+    log_debug("sockets_transport", "enter");
+
+    started_ = false;
+
+    // purge any remaining connections from the map
+    nthread_lock(&new_connection_lock_);
+    for (iter = conn_map_.begin() ; iter != conn_map_.end() ; ) {
+        nnti::core::nnti_connection *conn = *iter;
+        ++iter;
+        ((nnti::core::sockets_connection*)conn)->detach_channel();
+        conn_map_.remove(conn);
+    }
+    nthread_unlock(&new_connection_lock_);
+
+    unregister_whookie_cb();
+
+    stop_progress_thread();
+
+    // nobody else is using the channels now
+    std::vector<nnti::core::sockets_channel*> open_channels(channels_.begin(), channels_.end());
+    for (auto c : open_channels) {
+        close_channel(c);
+    }
+    drain_completed();
+    for (auto c : dead_channels_) {
+        delete c;
+    }
+    dead_channels_.clear();
+    closing_channels_.clear();
+
+    for (auto &m : unexpected_msgs_) {
+        delete [] m.payload;
+    }
+    unexpected_msgs_.clear();
+
+    teardown_sockets();
+    teardown_freelists();
+
+    log_debug("sockets_transport", "exit");
+
+    return rc;
+}
+
+/**
+ * @brief Indicates if a transport has been initialized.
+ *
+ * \return A result code (NNTI_OK or an error)
+ *
+ */
+bool
+sockets_transport::initialized(void)
+{
+    return started_ ? true : false;
+}
+
+/**
+ * @brief Return the URL field of this transport.
+ *
+ * \param[out] url       A string that describes this process in a transport specific way.
+ * \param[in]  maxlen    The length of the 'url' string parameter.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::get_url(
+    char           *url,
+    const uint64_t  maxlen)
+{
+    strncpy(url, me_.url().url().c_str(), maxlen);
+    return NNTI_OK;
+}
+
+/**
+ * @brief Get the process ID of this process.
+ *
+ * \param[out] pid   the process ID of this process
+ * \return A result code (NNTI_OK or an error)
+ *
+ */
+NNTI_result_t
+sockets_transport::pid(NNTI_process_id_t *pid)
+{
+    *pid = me_.pid();
+    return NNTI_OK;
+}
+
+/**
+ * @brief Get attributes of the transport.
+ *
+ * \param[out] attrs   the current attributes
+ * \return A result code (NNTI_OK or an error)
+ *
+ */
+NNTI_result_t
+sockets_transport::attrs(NNTI_attrs_t *attrs)
+{
+    *attrs = attrs_;
+
+    return NNTI_OK;
+}
+
+/**
+ * @brief Prepare for communication with the peer identified by url.
+ *
+ * \param[in]  url       A string that describes a peer's location on the network.
+ * \param[in]  timeout   The amount of time (in milliseconds) to wait before aborting the connection attempt.
+ * \param[out] peer_hdl  A handle to a peer that can be used for network operations.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::connect(
+    const char  *url,
+    const int    timeout,
+    NNTI_peer_t *peer_hdl)
+{
+    nnti::core::nnti_url            peer_url(url);
+    nnti::datatype::nnti_peer      *peer = new nnti::datatype::sockets_peer(this, peer_url, 0);
+    nnti::core::sockets_connection *conn;
+
+    nthread_lock(&new_connection_lock_);
+
+    // look for an existing connection to reuse
+    log_debug("sockets_transport", "Looking for connection with pid=%016lx", peer->pid());
+    conn = (nnti::core::sockets_connection*)conn_map_.get(peer->pid());
+    if (conn != nullptr) {
+        log_debug("sockets_transport", "Found connection with pid=%016lx", peer->pid());
+        // reuse an existing connection
+        *peer_hdl = (NNTI_peer_t)conn->peer();
+        nthread_unlock(&new_connection_lock_);
+        delete peer;
+        return NNTI_OK;
+    }
+    log_debug("sockets_transport", "Couldn't find connection with pid=%016lx", peer->pid());
+
+    conn = new nnti::core::sockets_connection(this);
+
+    peer->conn(conn);
+    conn->peer(peer);
+
+    conn_map_.insert(conn);
+
+    nthread_unlock(&new_connection_lock_);
+
+    std::string reply;
+    std::string wh_path = build_whookie_path("connect");
+    int wh_rc = 0;
+    int retries = 5;
+    wh_rc = whookie::retrieveData(peer_url.hostname(), peer_url.port(), wh_path, &reply);
+    while (wh_rc != 0 && --retries) {
+        sleep(1);
+        wh_rc = whookie::retrieveData(peer_url.hostname(), peer_url.port(), wh_path, &reply);
+        log_debug("sockets_transport", "retrieveData() rc=%d", wh_rc);
+    }
+    if (wh_rc != 0) {
+        return(NNTI_ETIMEDOUT);
+    }
+
+    log_debug("sockets_transport", "connect - reply=%s", reply.c_str());
+
+    conn->peer_params(reply);
+
+    // Open the data channel now so that an unreachable peer is reported
+    // here rather than by the first send.
+    if (conn->channel() == nullptr) {
+        log_error("sockets_transport", "couldn't open a data channel to %s (data_port=%u)",
+                  peer_url.url().c_str(), conn->data_port());
+        return NNTI_EIO;
+    }
+
+    *peer_hdl = (NNTI_peer_t)conn->peer();
+
+    return NNTI_OK;
+}
+
+/**
+ * @brief Terminate communication with this peer.
+ *
+ * \param[in] peer_hdl  A handle to a peer.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::disconnect(
+    NNTI_peer_t peer_hdl)
+{
+    nnti::datatype::nnti_peer      *peer     = (nnti::datatype::nnti_peer *)peer_hdl;
+    nnti::core::nnti_url           &peer_url = peer->url();
+    std::string                     reply;
+    nnti::core::sockets_connection *conn     = nullptr;
+
+    log_debug("sockets_transport", "disconnecting from %s", peer_url.url().c_str());
+
+    nthread_lock(&new_connection_lock_);
+
+    conn = (nnti::core::sockets_connection*)conn_map_.get(peer->pid());
+    if (conn == nullptr) {
+        log_debug("sockets_transport", "disconnect couldn't find connection to %s. Already disconnected?", peer_url.url().c_str());
+        nthread_unlock(&new_connection_lock_);
+        return NNTI_EINVAL;
+    }
+
+    conn_map_.remove(conn);
+
+    nthread_unlock(&new_connection_lock_);
+
+    nnti::core::sockets_channel *c = conn->detach_channel();
+    if (c != nullptr) {
+        std::unique_lock<std::mutex> lock(channels_mutex_);
+        closing_channels_.push_back(c);
+        lock.unlock();
+        wakeup();
+    }
+
+    if (*peer != me_) {
+        std::string wh_path = build_whookie_path("disconnect");
+        int wh_rc = whookie::retrieveData(peer_url.hostname(), peer_url.port(), wh_path, &reply);
+        if (wh_rc != 0) {
+            return(NNTI_ETIMEDOUT);
+        }
+    }
+
+    log_debug("sockets_transport", "disconnect from %s (pid=%x) succeeded", peer->url().url().c_str(), peer->pid());
+
+    delete conn;
+    delete peer;
+
+    return NNTI_OK;
+}
+
+/**
+ * @brief Create an event queue.
+ *
+ * \param[in]  size      The number of events the queue can hold.
+ * \param[in]  flags     Control the behavior of the queue.
+ * \param[out] eq        The new event queue.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::eq_create(
+    uint64_t            size,
+    NNTI_eq_flags_t     flags,
+    NNTI_event_queue_t *eq)
+{
+    nnti::datatype::nnti_event_queue *new_eq = new nnti::datatype::nnti_event_queue(true, size, this);
+
+    if (flags & NNTI_EQF_UNEXPECTED) {
+        unexpected_queue_ = new_eq;
+    }
+
+    *eq = (NNTI_event_queue_t)new_eq;
+
+    return NNTI_OK;
+}
+
+NNTI_result_t
+sockets_transport::eq_create(
+    uint64_t                             size,
+    NNTI_eq_flags_t                      flags,
+    nnti::datatype::nnti_event_callback  cb,
+    void                                *cb_context,
+    NNTI_event_queue_t                  *eq)
+{
+    nnti::datatype::nnti_event_queue *new_eq = new nnti::datatype::nnti_event_queue(true, size, cb, cb_context, this);
+
+    if (flags & NNTI_EQF_UNEXPECTED) {
+        unexpected_queue_ = new_eq;
+    }
+
+    *eq = (NNTI_event_queue_t)new_eq;
+
+    return NNTI_OK;
+}
+
+/**
+ * @brief Destroy an event queue.
+ *
+ * \param[in] eq  The event queue to destroy.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::eq_destroy(
+    NNTI_event_queue_t eq)
+{
+    if (unexpected_queue_ == (nnti::datatype::nnti_event_queue *)eq) {
+        unexpected_queue_ = nullptr;
+    }
+    delete (nnti::datatype::nnti_event_queue *)eq;
+
+    return NNTI_OK;
+}
+
+/**
+ * @brief Wait for an event to arrive on an event queue.
+ *
+ * \param[in]  eq_list   A list of event queues to wait on.
+ * \param[in]  eq_count  The number of event queues in the list.
+ * \param[in]  timeout   The amount of time (in milliseconds) to wait.
+ * \param[out] which     The index of the EQ where the event occurred.
+ * \param[out] event     The details of the event.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::eq_wait(
+    NNTI_event_queue_t *eq_list,
+    const uint32_t      eq_count,
+    const int           timeout,
+    uint32_t           *which,
+    NNTI_event_t       *event)
+{
+    bool rc;
+    int poll_rc;
+    NNTI_result_t nnti_rc = NNTI_ETIMEDOUT;
+
+    std::vector<struct pollfd> poll_fds(eq_count);
+
+    NNTI_event_t *e;
+
+    log_debug("eq_wait", "enter");
+
+    for (uint32_t i=0;i<eq_count;i++) {
+        nnti::datatype::nnti_event_queue *eq = nnti::datatype::nnti_event_queue::to_obj(eq_list[i]);
+        rc = eq->pop(e);
+        if (rc) {
+            uint32_t dummy=0;
+            read(eq->read_fd(), &dummy, 4);
+
+            *which = i;
+            *event = *e;
+            event_freelist_->push(e);
+            nnti_rc = NNTI_OK;
+            goto cleanup;
+        }
+    }
+
+    for (uint32_t i=0;i<eq_count;i++) {
+        nnti::datatype::nnti_event_queue *eq = nnti::datatype::nnti_event_queue::to_obj(eq_list[i]);
+        poll_fds[i].fd      = eq->read_fd();
+        poll_fds[i].events  = POLLIN;
+        poll_fds[i].revents = 0;
+    }
+    log_debug("eq_wait", "polling with timeout==%d", timeout);
+
+    // Test for errno==EINTR to deal with timing interrupts from HPCToolkit
+    do {
+        poll_rc = poll(&poll_fds[0], poll_fds.size(), timeout);
+    } while ((poll_rc < 0) && (errno == EINTR));
+
+    if (poll_rc == 0) {
+        log_debug("eq_wait", "poll() timed out: poll_rc=%d", poll_rc);
+        nnti_rc = NNTI_ETIMEDOUT;
+        event->result = NNTI_ETIMEDOUT;
+        goto cleanup;
+    } else if (poll_rc < 0) {
+        if (errno == ENOMEM) {
+            log_error("eq_wait", "poll() out of memory: poll_rc=%d (%s)", poll_rc, strerror(errno));
+            nnti_rc = NNTI_ENOMEM;
+            event->result = NNTI_ENOMEM;
+        } else {
+            log_error("eq_wait", "poll() invalid args: poll_rc=%d (%s)", poll_rc, strerror(errno));
+            nnti_rc = NNTI_EINVAL;
+            event->result = NNTI_EINVAL;
+        }
+        goto cleanup;
+    } else {
+        for (uint32_t i=0;i<eq_count;i++) {
+            if (poll_fds[i].revents == POLLIN) {
+                log_debug("eq_wait", "poll() events on eq[%d]", i);
+                uint32_t dummy=0;
+                read(poll_fds[i].fd, &dummy, 4);
+                if (dummy != 0xAAAAAAAA) {
+                    log_warn("eq_wait", "notification byte is %X, should be 0xAAAAAAAA", dummy);
+                }
+
+                nnti::datatype::nnti_event_queue *eq = nnti::datatype::nnti_event_queue::to_obj(eq_list[i]);
+                rc = eq->pop(e);
+                if (rc) {
+                    *which = i;
+                    *event = *e;
+                    event_freelist_->push(e);
+                    nnti_rc = NNTI_OK;
+                    goto cleanup;
+                }
+            }
+        }
+    }
+
+
+cleanup:
+    log_debug_stream("sockets_transport") << event;
+    log_debug("eq_wait", "exit");
+
+    return nnti_rc;
+}
+
+/**
+ * @brief Wait for one or more events to arrive on an event queue.
+ *
+ * \param[in]  eq       The event queue to wait on.
+ * \param[out] events   An array of at least max events.
+ * \param[in]  max      The most events to return.
+ * \param[in]  timeout  The amount of time (in milliseconds) to wait.
+ * \param[out] count    The number of events returned.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::eq_wait_many(
+    NNTI_event_queue_t  eq_hdl,
+    NNTI_event_t       *events,
+    const uint32_t      max,
+    const int           timeout,
+    uint32_t           *count)
+{
+    return wait_for_events(event_freelist_, eq_hdl, events, max, timeout, count);
+}
+
+/**
+ * @brief Retrieves the next message from the unexpected list.
+ *
+ * \param[in]  dst_hdl        Buffer where the message is delivered.
+ * \param[in]  dst_offset     Offset into dst_hdl where the message is delivered.
+ * \param[out] result_event   Event describing the message delivered to dst_hdl.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::next_unexpected(
+    NNTI_buffer_t  dst_hdl,
+    uint64_t       dst_offset,
+    NNTI_event_t  *result_event)
+{
+    NNTI_result_t rc = NNTI_OK;
+    uint64_t actual_offset=0;
+    nnti::datatype::nnti_buffer *b = (nnti::datatype::nnti_buffer *)dst_hdl;
+
+    log_debug("next_unexpected", "enter");
+
+    std::unique_lock<std::mutex> lock(unexpected_mutex_);
+    if (unexpected_msgs_.size() == 0) {
+        log_debug("sockets_transport", "next_unexpected - unexpected_msgs_ list is empty");
+        return NNTI_ENOENT;
+    }
+    unexpected_msg m = unexpected_msgs_.front();
+    unexpected_msgs_.pop_front();
+    lock.unlock();
+
+    rc = b->copy_in(dst_offset, m.payload, m.length, &actual_offset);
+    if (rc != NNTI_OK) {
+        log_error("next_unexpected", "copy_in() failed (rc=%d)", rc);
+    }
+    delete [] m.payload;
+
+    result_event->trans_hdl  = nnti::transports::transport::to_hdl(this);
+    result_event->result     = rc;
+    result_event->op         = NNTI_OP_SEND;
+    result_event->peer       = nnti::datatype::nnti_peer::to_hdl(m.peer);
+    result_event->length     = m.length;
+    result_event->type       = NNTI_EVENT_SEND;
+    result_event->start      = b->payload();
+    result_event->offset     = actual_offset;
+    result_event->context    = 0;
+
+    stats_->recvs++;
+
+    log_debug("next_unexpected", "exit");
+
+    return rc;
+}
+
+/**
+ * @brief Retrieves a specific message from the unexpected list.
+ *
+ * \param[in]  unexpected_event  Event describing the message to retrieve.
+ * \param[in]  dst_hdl           Buffer where the message is delivered.
+ * \param[in]  dst_offset        Offset into dst_hdl where the message is delivered.
+ * \param[out] result_event      Event describing the message delivered to dst_hdl.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::get_unexpected(
+    NNTI_event_t  *unexpected_event,
+    NNTI_buffer_t  dst_hdl,
+    uint64_t       dst_offset,
+    NNTI_event_t  *result_event)
+{
+    return NNTI_OK;
+}
+
+/**
+ * @brief Marks a send operation as complete.
+ *
+ * \param[in] event  The event to mark complete.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::event_complete(
+    NNTI_event_t *event)
+{
+    nnti::datatype::nnti_buffer *b = nullptr;
+
+    b = buffer_map_.get((char*)event->start);
+    b->event_complete(event);
+
+    return NNTI_OK;
+}
+
+/**
+ * @brief Decode an array of bytes into an NNTI datatype.
+ *
+ * \param[out] nnti_dt        The NNTI data structure cast to void*.
+ * \param[in]  packed_buf     A array of bytes containing the encoded data structure.
+ * \param[in]  packed_len     The number of encoded bytes.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::dt_unpack(
+    void           *nnti_dt,
+    char           *packed_buf,
+    const uint64_t  packed_len)
+{
+    NNTI_result_t                   rc = NNTI_OK;
+    nnti::datatype::sockets_buffer *b  = nullptr;
+    nnti::datatype::nnti_peer      *p  = nullptr;
+
+    NNTI_datatype_t t = nnti::serialize::get_datatype(packed_buf, packed_len);
+    switch (t) {
+        case NNTI_dt_buffer:
+            log_debug("base_transport", "dt is a buffer");
+            b = new nnti::datatype::sockets_buffer(this, packed_buf, packed_len);
+            *(NNTI_buffer_t*)nnti_dt = nnti::datatype::nnti_buffer::to_hdl(b);
+            break;
+        case NNTI_dt_peer:
+            log_debug("base_transport", "dt is a peer");
+            p = new nnti::datatype::nnti_peer(this, packed_buf, packed_len);
+            *(NNTI_peer_t*)nnti_dt = nnti::datatype::nnti_peer::to_hdl(p);
+            break;
+        default:
+            // unsupported datatype
+            rc = NNTI_EINVAL;
+            break;
+    }
+
+    return(rc);
+}
+
+/**
+ * @brief Allocate a block of memory and prepare it for network operations.
+ *
+ * \param[in]  size        The size (in bytes) of the new buffer.
+ * \param[in]  flags       Control the behavior of this buffer.
+ * \param[in]  eq          Events occurring on the memory region are delivered to this event queue.
+ * \param[in]  cb          A callback that gets called for events delivered to eq.
+ * \param[in]  cb_context  A blob of data that is passed to each invocation of cb.
+ * \param[out] reg_ptr     A pointer to the memory buffer allocated.
+ * \param[out] reg_buf     A handle to a memory buffer that can be used for network operations.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::alloc(
+    const uint64_t                       size,
+    const NNTI_buffer_flags_t            flags,
+    NNTI_event_queue_t                   eq,
+    nnti::datatype::nnti_event_callback  cb,
+    void                                *cb_context,
+    char                               **reg_ptr,
+    NNTI_buffer_t                       *reg_buf)
+{
+    nnti::datatype::nnti_buffer *b = new nnti::datatype::sockets_buffer(this,
+                                                                          size,
+                                                                          flags,
+                                                                          eq,
+                                                                          cb,
+                                                                          cb_context);
+
+    buffer_map_.insert(b);
+
+    stats_->pinned_buffers++;
+    stats_->pinned_bytes  += b->size();
+
+    *reg_ptr = b->payload();
+    *reg_buf = (NNTI_buffer_t)b;
+
+    return NNTI_OK;
+}
+
+/**
+ * @brief Disables network operations on the block of memory and frees it.
+ *
+ * \param[in]  reg_buf The buffer to cleanup.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::free(
+    NNTI_buffer_t reg_buf)
+{
+    nnti::datatype::nnti_buffer *b = (nnti::datatype::nnti_buffer *)reg_buf;
+
+    buffer_map_.remove(b);
+
+    stats_->pinned_buffers--;
+    stats_->pinned_bytes  -= b->size();
+
+    delete b;
+
+    return NNTI_OK;
+}
+
+/**
+ * @brief Prepare a block of memory for network operations.
+ *
+ * \param[in]  buffer      Pointer to a memory block.
+ * \param[in]  size        The size (in bytes) of buffer.
+ * \param[in]  flags       Control the behavior of this buffer.
+ * \param[in]  eq          Events occurring on the memory region are delivered to this event queue.
+ * \param[in]  cb          A callback that gets called for events delivered to eq.
+ * \param[in]  cb_context  A blob of data that is passed to each invocation of cb.
+ * \param[out] reg_buf     A handle to a memory buffer that can be used for network operations.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::register_memory(
+    char                                *buffer,
+    const uint64_t                       size,
+    const NNTI_buffer_flags_t            flags,
+    NNTI_event_queue_t                   eq,
+    nnti::datatype::nnti_event_callback  cb,
+    void                                *cb_context,
+    NNTI_buffer_t                       *reg_buf)
+{
+    nnti::datatype::nnti_buffer *b = new nnti::datatype::sockets_buffer(this,
+                                                                          buffer,
+                                                                          size,
+                                                                          flags,
+                                                                          eq,
+                                                                          cb,
+                                                                          cb_context);
+
+    buffer_map_.insert(b);
+
+    stats_->pinned_buffers++;
+    stats_->pinned_bytes  += b->size();
+
+    *reg_buf = (NNTI_buffer_t)b;
+
+    return NNTI_OK;
+}
+
+/**
+ * @brief Disables network operations on a memory buffer.
+ *
+ * \param[in]  reg_buf  A handle to a memory buffer to unregister.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::unregister_memory(
+    NNTI_buffer_t reg_buf)
+{
+    nnti::datatype::nnti_buffer *b = (nnti::datatype::nnti_buffer *)reg_buf;
+
+    buffer_map_.remove(b);
+
+    stats_->pinned_buffers--;
+    stats_->pinned_bytes  -= b->size();
+
+    delete b;
+
+    return NNTI_OK;
+}
+
+/**
+ * @brief Convert an NNTI peer to an NNTI_process_id_t.
+ *
+ * \param[in]   peer_hdl  A handle to a peer that can be used for network operations.
+ * \param[out]  pid       Compact binary representation of a process's location on the network.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::dt_peer_to_pid(
+    NNTI_peer_t        peer_hdl,
+    NNTI_process_id_t *pid)
+{
+    nnti::datatype::nnti_peer *peer = (nnti::datatype::nnti_peer *)peer_hdl;
+    *pid = peer->pid();
+    return NNTI_OK;
+}
+
+/**
+ * @brief Convert an NNTI_process_id_t to an NNTI peer.
+ *
+ * \param[in]   pid       Compact binary representation of a process's location on the network.
+ * \param[out]  peer_hdl  A handle to a peer that can be used for network operations.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::dt_pid_to_peer(
+    NNTI_process_id_t  pid,
+    NNTI_peer_t       *peer_hdl)
+{
+    nnti::core::nnti_connection *conn = conn_map_.get(pid);
+    *peer_hdl = (NNTI_peer_t)conn->peer();
+    return NNTI_OK;
+}
+
+/**
+ * @brief Send a message to a peer.
+ *
+ * \param[in]  wr   A work request that describes the operation
+ * \param[out] wid  Identifier used to track this work request
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::send(
+    nnti::datatype::nnti_work_request *wr,
+    NNTI_work_id_t                    *wid)
+{
+    return start_op(wr, nnti::core::SOCKETS_MSG_SEND, wid);
+}
+
+/**
+ * @brief Transfer data to a peer.
+ *
+ * \param[in]  wr   A work request that describes the operation
+ * \param[out] wid  Identifier used to track this work request
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::put(
+    nnti::datatype::nnti_work_request *wr,
+    NNTI_work_id_t                    *wid)
+{
+    return start_op(wr, nnti::core::SOCKETS_MSG_PUT, wid);
+}
+
+/**
+ * @brief Transfer data from a peer.
+ *
+ * \param[in]  wr   A work request that describes the operation
+ * \param[out] wid  Identifier used to track this work request
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::get(
+    nnti::datatype::nnti_work_request *wr,
+    NNTI_work_id_t                    *wid)
+{
+    return start_op(wr, nnti::core::SOCKETS_MSG_GET_REQUEST, wid);
+}
+
+/**
+ * perform a 64-bit atomic operation with GET semantics
+ *
+ * \param[in]  wr   A work request that describes the operation
+ * \param[out] wid  Identifier used to track this work request
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::atomic_fop(
+    nnti::datatype::nnti_work_request *wr,
+    NNTI_work_id_t                    *wid)
+{
+    return start_op(wr, nnti::core::SOCKETS_MSG_FADD, wid);
+}
+
+/**
+ * perform a 64-bit compare-and-swap operation
+ *
+ * \param[in]  wr   A work request that describes the operation
+ * \param[out] wid  Identifier used to track this work request
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::atomic_cswap(
+    nnti::datatype::nnti_work_request *wr,
+    NNTI_work_id_t                    *wid)
+{
+    return start_op(wr, nnti::core::SOCKETS_MSG_CSWAP, wid);
+}
+
+/**
+ * @brief Attempts to cancel an NNTI operation.
+ *
+ * \param[in]  wid   A work ID to cancel.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::cancel(
+    NNTI_work_id_t wid)
+{
+    return NNTI_OK;
+}
+
+
+/**
+ * @brief Attempts to cancel a list of NNTI operations.
+ *
+ * \param[in]  wid_list   A list of work IDs to cancel.
+ * \param[in]  wid_count  The number of work IDs in wid_list.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::cancelall(
+    NNTI_work_id_t *wid_list,
+    const uint32_t  wid_count)
+{
+    return NNTI_OK;
+}
+
+
+/**
+ * @brief Sends a signal to interrupt NNTI_wait*().
+ *
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::interrupt()
+{
+    return NNTI_OK;
+}
+
+
+/**
+ * @brief Wait for a specific operation (wid) to complete.
+ *
+ * \param[in]  wid      The operation to wait for.
+ * \param[in]  timeout  The amount of time (in milliseconds) to wait.
+ * \param[out] status   The details of the completed (or timed out) operation.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::wait(
+    NNTI_work_id_t  wid,
+    const int64_t   timeout,
+    NNTI_status_t  *status)
+{
+    return NNTI_OK;
+}
+
+/**
+ * @brief Wait for any operation (wid_list) in the list to complete.
+ *
+ * \param[in]  wid_list   The list of operations to wait for.
+ * \param[in]  wid_count  The number of operations in wid_list.
+ * \param[in]  timeout    The amount of time (in milliseconds) to wait.
+ * \param[out] which      The index of the operation that completed.
+ * \param[out] status     The details of the completed (or timed out) operation.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::waitany(
+    NNTI_work_id_t *wid_list,
+    const uint32_t  wid_count,
+    const int64_t   timeout,
+    uint32_t       *which,
+    NNTI_status_t  *status)
+{
+    return NNTI_OK;
+}
+
+/**
+ * @brief Waits for all the operations (wid_list) in the list to complete.
+ *
+ * \param[in]  wid_list   The list of operations to wait for.
+ * \param[in]  wid_count  The number of operations in wid_list.
+ * \param[in]  timeout    The amount of time (in milliseconds) to wait.
+ * \param[out] status     The details of the completed (or timed out) operations (one per operation).
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+sockets_transport::waitall(
+    NNTI_work_id_t *wid_list,
+    const uint32_t  wid_count,
+    const int64_t   timeout,
+    NNTI_status_t  *status)
+{
+    return NNTI_OK;
+}
+
+/*************************************************************/
+
+sockets_transport *
+sockets_transport::get_instance(
+    faodel::Configuration &config)
+{
+    static sockets_transport *instance = new sockets_transport(config);
+    return instance;
+}
+
+/*************************************************************
+ * Accessors for data members specific to this interconnect.
+ *************************************************************/
+
+static int
+set_nonblocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0) {
+        return -1;
+    }
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static void
+set_nodelay(int fd)
+{
+    int one = 1;
+    if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) < 0) {
+        log_warn("sockets_transport", "setsockopt(TCP_NODELAY) failed: %s", strerror(errno));
+    }
+}
+
+NNTI_result_t
+sockets_transport::setup_listener(void)
+{
+    struct sockaddr_in addr;
+    socklen_t          addr_len = sizeof(addr);
+    int                one = 1;
+
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        log_error("sockets_transport", "socket() failed: %s", strerror(errno));
+        return NNTI_EIO;
+    }
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons((uint16_t)data_port_);
+    if (bind(listen_fd_, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        log_error("sockets_transport", "bind() to port %u failed: %s", data_port_, strerror(errno));
+        return NNTI_EIO;
+    }
+    if (listen(listen_fd_, 128) < 0) {
+        log_error("sockets_transport", "listen() failed: %s", strerror(errno));
+        return NNTI_EIO;
+    }
+    if (getsockname(listen_fd_, (struct sockaddr *)&addr, &addr_len) < 0) {
+        log_error("sockets_transport", "getsockname() failed: %s", strerror(errno));
+        return NNTI_EIO;
+    }
+    data_port_ = ntohs(addr.sin_port);
+
+    if (set_nonblocking(listen_fd_) < 0) {
+        log_error("sockets_transport", "failed to set the listen socket to nonblocking: %s", strerror(errno));
+        return NNTI_EIO;
+    }
+
+    log_debug("sockets_transport", "listening on port %u", data_port_);
+
+    return(NNTI_OK);
+}
+
+NNTI_result_t
+sockets_transport::setup_epoll(void)
+{
+    struct epoll_event ev;
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        log_error("sockets_transport", "epoll_create1() failed: %s", strerror(errno));
+        return NNTI_EIO;
+    }
+    wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd_ < 0) {
+        log_error("sockets_transport", "eventfd() failed: %s", strerror(errno));
+        return NNTI_EIO;
+    }
+
+    ev.events   = EPOLLIN;
+    ev.data.ptr = &listen_tag_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &ev) < 0) {
+        log_error("sockets_transport", "epoll_ctl(listen_fd_) failed: %s", strerror(errno));
+        return NNTI_EIO;
+    }
+    ev.events   = EPOLLIN;
+    ev.data.ptr = &wakeup_tag_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &ev) < 0) {
+        log_error("sockets_transport", "epoll_ctl(wakeup_fd_) failed: %s", strerror(errno));
+        return NNTI_EIO;
+    }
+
+    return(NNTI_OK);
+}
+
+void
+sockets_transport::teardown_sockets(void)
+{
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+    }
+    if (wakeup_fd_ >= 0) {
+        close(wakeup_fd_);
+        wakeup_fd_ = -1;
+    }
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+        epoll_fd_ = -1;
+    }
+}
+
+NNTI_result_t
+sockets_transport::setup_freelists(void)
+{
+    for (uint64_t i=0;i<cmd_op_freelist_size_;i++) {
+        nnti::core::sockets_cmd_op *op = new nnti::core::sockets_cmd_op();
+        cmd_op_freelist_->push(op);
+    }
+
+    for (uint64_t i=0;i<event_freelist_size_;i++) {
+        NNTI_event_t *e = new NNTI_event_t;
+        event_freelist_->push(e);
+    }
+
+    return(NNTI_OK);
+}
+NNTI_result_t
+sockets_transport::teardown_freelists(void)
+{
+    // the progress thread has exited.  collect whatever the app threads still cache.
+    event_freelist_->reclaim();
+    cmd_op_freelist_->reclaim();
+
+    while(!event_freelist_->empty()) {
+        NNTI_event_t *e = nullptr;
+        if (event_freelist_->pop(e)) {
+            delete e;
+        }
+    }
+
+    while(!cmd_op_freelist_->empty()) {
+        nnti::core::sockets_cmd_op *op = nullptr;
+        if (cmd_op_freelist_->pop(op)) {
+            if (op->wid()) {
+                delete op->wid();
+            }
+            delete op;
+        }
+    }
+
+    return(NNTI_OK);
+}
+
+/*
+ * The progress thread.  It owns the receive side of every channel,
+ * accepts new channels, finishes writes that didn't fit in the socket
+ * buffer and delivers all completion events.
+ */
+void
+sockets_transport::progress(void)
+{
+    struct epoll_event events[max_epoll_events];
+
+    while (terminate_progress_thread_.load() == false) {
+        int n = epoll_wait(epoll_fd_, events, max_epoll_events, 1000);
+        if (n < 0) {
+            if (errno != EINTR) {
+                log_error("sockets_transport", "epoll_wait() failed: %s", strerror(errno));
+            }
+            continue;
+        }
+        stats_->epoll_wakeups++;
+
+        // sends written before these events arrived complete first, so the
+        // app sees a send complete before any reply the peer sent to it
+        drain_completed();
+
+        for (int i=0;i<n;i++) {
+            void *ptr = events[i].data.ptr;
+            if (ptr == &listen_tag_) {
+                accept_channels();
+                continue;
+            }
+            if (ptr == &wakeup_tag_) {
+                uint64_t count;
+                read(wakeup_fd_, &count, sizeof(count));
+                continue;
+            }
+
+            nnti::core::sockets_channel *c = (nnti::core::sockets_channel *)ptr;
+            if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                if (read_channel(c) == false) {
+                    close_channel(c);
+                    continue;
+                }
+            }
+            if (events[i].events & EPOLLOUT) {
+                std::unique_lock<std::mutex> lock(c->send_mutex_);
+                flush_channel(c);
+            }
+        }
+
+        std::deque<nnti::core::sockets_channel*> closing;
+        std::unique_lock<std::mutex> lock(channels_mutex_);
+        closing.swap(closing_channels_);
+        lock.unlock();
+        for (auto c : closing) {
+            close_channel(c);
+        }
+
+        drain_completed();
+    }
+
+    log_debug("progress", "progress() is finished");
+
+    return;
+}
+void
+sockets_transport::start_progress_thread(void)
+{
+    terminate_progress_thread_ = false;
+    progress_thread_ = std::thread(&nnti::transports::sockets_transport::progress, this);
+}
+void
+sockets_transport::stop_progress_thread(void)
+{
+    terminate_progress_thread_ = true;
+    wakeup();
+    progress_thread_.join();
+}
+void
+sockets_transport::wakeup(void)
+{
+    uint64_t one = 1;
+    write(wakeup_fd_, &one, sizeof(one));
+}
+
+void
+sockets_transport::connect_cb(
+    const std::map<std::string,std::string> &args,
+    std::stringstream                       &results)
+{
+    nnti::core::sockets_connection *conn;
+    nnti::core::sockets_channel    *stale_channel = nullptr;
+
+    log_debug("sockets_transport", "inbound connection from %s", std::string(args.at("hostname")+":"+args.at("port")).c_str());
+
+    nthread_lock(&new_connection_lock_);
+
+    nnti::core::nnti_url peer_url = nnti::core::nnti_url(args.at("hostname"), args.at("port"));
+    std::string fingerprint = args.at("fingerprint");
+
+    log_debug("sockets_transport", "Looking for connection with pid=%016lx fingerprint=%s", peer_url.pid(), fingerprint.c_str());
+    conn = (nnti::core::sockets_connection*)conn_map_.get(peer_url.pid());
+    if (conn != nullptr) {
+        if (conn->fingerprint() == fingerprint) {
+            log_debug("sockets_transport", "Found matching connection with pid=%016lx fingerprint=%s", peer_url.pid(), fingerprint.c_str());
+        } else if (conn->fingerprint().empty()) {
+            log_debug("sockets_transport", "Found connection with matching pid=%016lx and empty fingerprint=%s", peer_url.pid(), conn->fingerprint().c_str());
+        } else {
+            log_debug("sockets_transport", "Found mismatched connection with pid=%016lx fingerprint=%s", peer_url.pid(), conn->fingerprint().c_str());
+
+            // the peer restarted.  its old channel is useless.
+            stale_channel = conn->detach_channel();
+            conn_map_.remove(conn);
+            delete conn;
+
+            conn = new nnti::core::sockets_connection(this, args);
+            conn_map_.insert(conn);
+        }
+    } else {
+        log_debug("sockets_transport", "Couldn't find connection with pid=%016lx", peer_url.pid());
+
+        conn = new nnti::core::sockets_connection(this, args);
+        conn_map_.insert(conn);
+    }
+
+    nthread_unlock(&new_connection_lock_);
+
+    if (stale_channel != nullptr) {
+        std::unique_lock<std::mutex> lock(channels_mutex_);
+        closing_channels_.push_back(stale_channel);
+        lock.unlock();
+        wakeup();
+    }
+
+    results << "hostname="    << url_.hostname() << std::endl;
+    results << "addr="        << url_.addr()     << std::endl;
+    results << "port="        << url_.port()     << std::endl;
+    results << "fingerprint=" << fingerprint_    << std::endl;
+    results << "data_port="   << data_port_      << std::endl;
+
+    log_debug("sockets_transport", "connect_cb - results=%s", results.str().c_str());
+}
+
+void
+sockets_transport::disconnect_cb(
+    const std::map<std::string,std::string> &args,
+    std::stringstream                       &results)
+{
+    nnti::core::sockets_connection *conn = nullptr;
+    nnti::core::sockets_channel    *c    = nullptr;
+    nnti::core::nnti_url            peer_url(args.at("hostname"), args.at("port"));
+
+    nthread_lock(&new_connection_lock_);
+
+    log_debug("sockets_transport", "%s is disconnecting", peer_url.url().c_str());
+    conn = (nnti::core::sockets_connection*)conn_map_.get(peer_url.pid());
+    log_debug("sockets_transport", "connection map says %s => conn(%p)", peer_url.url().c_str(), conn);
+
+    if (conn != nullptr) {
+        c = conn->detach_channel();
+        conn_map_.remove(conn);
+        delete conn;
+    }
+
+    nthread_unlock(&new_connection_lock_);
+
+    if (c != nullptr) {
+        std::unique_lock<std::mutex> lock(channels_mutex_);
+        closing_channels_.push_back(c);
+        lock.unlock();
+        wakeup();
+    }
+
+    log_debug("sockets_transport", "disconnect_cb - results=%s", results.str().c_str());
+}
+
+void
+sockets_transport::stats_cb(
+    const std::map<std::string,std::string> &args,
+    std::stringstream                       &results)
+{
+    faodel::ReplyStream rs(args, "Transfer Statistics", &results);
+
+    rs.tableBegin("Transport Statistics");
+    rs.tableRow({"data_port",          std::to_string(data_port_)});
+    rs.tableRow({"pinned_bytes",       std::to_string(stats_->pinned_bytes.load())});
+    rs.tableRow({"pinned_buffers",     std::to_string(stats_->pinned_buffers.load())});
+    rs.tableRow({"unexpected_sends",   std::to_string(stats_->unexpected_sends.load())});
+    rs.tableRow({"unexpected_recvs",   std::to_string(stats_->unexpected_recvs.load())});
+    rs.tableRow({"dropped_unexpected", std::to_string(stats_->dropped_unexpected.load())});
+    rs.tableRow({"sends",              std::to_string(stats_->sends.load())});
+    rs.tableRow({"recvs",              std::to_string(stats_->recvs.load())});
+    rs.tableRow({"gets",               std::to_string(stats_->gets.load())});
+    rs.tableRow({"puts",               std::to_string(stats_->puts.load())});
+    rs.tableRow({"atomics",            std::to_string(stats_->atomics.load())});
+    rs.tableRow({"bytes_sent",         std::to_string(stats_->bytes_sent.load())});
+    rs.tableRow({"bytes_recvd",        std::to_string(stats_->bytes_recvd.load())});
+    rs.tableRow({"sendmsg_calls",      std::to_string(stats_->sendmsg_calls.load())});
+    rs.tableRow({"readv_calls",        std::to_string(stats_->readv_calls.load())});
+    rs.tableRow({"epoll_wakeups",      std::to_string(stats_->epoll_wakeups.load())});
+    rs.tableEnd();
+
+    uint64_t event_hits, event_misses, cmd_op_hits, cmd_op_misses;
+    event_freelist_->cache_stats(event_hits, event_misses);
+    cmd_op_freelist_->cache_stats(cmd_op_hits, cmd_op_misses);
+
+    rs.tableBegin("Freelist Caches");
+    rs.tableTop({"freelist", "magazine_size", "hits", "misses"});
+    rs.tableRow({"event",  std::to_string(event_freelist_->magazine_size()),  std::to_string(event_hits),  std::to_string(event_misses)});
+    rs.tableRow({"cmd_op", std::to_string(cmd_op_freelist_->magazine_size()), std::to_string(cmd_op_hits), std::to_string(cmd_op_misses)});
+    rs.tableEnd();
+    rs.Finish();
+}
+
+void
+sockets_transport::peers_cb(
+    const std::map<std::string,std::string> &args,
+    std::stringstream                       &results)
+{
+    html::mkHeader(results, "Connected Peers");
+    html::mkText(results,"Connected Peers",1);
+
+    std::vector<std::string> links;
+    nnti::core::nnti_connection_map_iter_t iter;
+    for (iter = conn_map_.begin() ; iter != conn_map_.end() ; iter++) {
+        std::string p((*iter)->peer()->url().url());
+        links.push_back(html::mkLink(p, p));
+    }
+    html::mkList(results, links);
+
+    html::mkFooter(results);
+}
+
+std::string
+sockets_transport::build_whookie_path(
+    const char *service)
+{
+    std::stringstream wh_url;
+
+    wh_url << "/nnti/sockets/" << service;
+    wh_url << "&hostname="     << url_.hostname();
+    wh_url << "&addr="         << url_.addr();
+    wh_url << "&port="         << url_.port();
+    wh_url << "&fingerprint="  << fingerprint_;
+    wh_url << "&data_port="    << data_port_;
+
+    return wh_url.str();
+}
+
+void
+sockets_transport::register_whookie_cb(void)
+{
+    whookie::Server::registerHook("/nnti/sockets/connect", [this] (const std::map<std::string,std::string> &args, std::stringstream &results){
+        connect_cb(args, results);
+    });
+    whookie::Server::registerHook("/nnti/sockets/disconnect", [this] (const std::map<std::string,std::string> &args, std::stringstream &results){
+        disconnect_cb(args, results);
+    });
+    whookie::Server::registerHook("/nnti/sockets/stats", [this] (const std::map<std::string,std::string> &args, std::stringstream &results){
+        stats_cb(args, results);
+    });
+    whookie::Server::registerHook("/nnti/sockets/peers", [this] (const std::map<std::string,std::string> &args, std::stringstream &results){
+        peers_cb(args, results);
+    });
+}
+
+void
+sockets_transport::unregister_whookie_cb(void)
+{
+    whookie::Server::deregisterHook("/nnti/sockets/connect");
+    whookie::Server::deregisterHook("/nnti/sockets/disconnect");
+    whookie::Server::deregisterHook("/nnti/sockets/stats");
+    whookie::Server::deregisterHook("/nnti/sockets/peers");
+}
+
+/*
+ * Open an outbound channel to conn's peer.  Called with the
+ * connection's channel lock held.
+ */
+nnti::core::sockets_channel *
+sockets_transport::open_channel(
+    nnti::core::sockets_connection *conn)
+{
+    struct addrinfo  hints;
+    struct addrinfo *res = nullptr;
+    int              fd  = -1;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    std::string port = std::to_string(conn->data_port());
+    int rc = getaddrinfo(conn->hostname().c_str(), port.c_str(), &hints, &res);
+    if (rc != 0) {
+        log_error("sockets_transport", "getaddrinfo(%s:%s) failed: %s", conn->hostname().c_str(), port.c_str(), gai_strerror(rc));
+        return nullptr;
+    }
+
+    for (struct addrinfo *ai = res ; ai != nullptr ; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            break;
+        }
+        log_debug("sockets_transport", "connect(%s:%s) failed: %s", conn->hostname().c_str(), port.c_str(), strerror(errno));
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+
+    if (fd < 0) {
+        log_error("sockets_transport", "couldn't connect to %s:%s", conn->hostname().c_str(), port.c_str());
+        return nullptr;
+    }
+
+    set_nonblocking(fd);
+    set_nodelay(fd);
+
+    nnti::core::sockets_channel *c = new nnti::core::sockets_channel(fd, true, conn->peer_pid());
+    add_channel(c);
+
+    log_debug("sockets_transport", "opened channel fd=%d to %s:%s", fd, conn->hostname().c_str(), port.c_str());
+
+    return c;
+}
+
+void
+sockets_transport::add_channel(
+    nnti::core::sockets_channel *c)
+{
+    struct epoll_event ev;
+
+    std::unique_lock<std::mutex> lock(channels_mutex_);
+    channels_.insert(c);
+    lock.unlock();
+
+    ev.events   = EPOLLIN;
+    ev.data.ptr = c;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, c->fd(), &ev) < 0) {
+        log_error("sockets_transport", "epoll_ctl(ADD, fd=%d) failed: %s", c->fd(), strerror(errno));
+    }
+}
+
+void
+sockets_transport::accept_channels(void)
+{
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                log_error("sockets_transport", "accept4() failed: %s", strerror(errno));
+            }
+            return;
+        }
+        set_nodelay(fd);
+        add_channel(new nnti::core::sockets_channel(fd, false, 0));
+        log_debug("sockets_transport", "accepted channel fd=%d", fd);
+    }
+}
+
+/*
+ * Close a channel and fail everything still waiting on it.  Only the
+ * progress thread (or stop() after the progress thread has exited)
+ * calls this.
+ */
+void
+sockets_transport::close_channel(
+    nnti::core::sockets_channel *c)
+{
+    std::unique_lock<std::mutex> channels_lock(channels_mutex_);
+    if (channels_.erase(c) == 0) {
+        // already closed
+        return;
+    }
+    channels_lock.unlock();
+
+    log_debug("sockets_transport", "closing channel fd=%d outbound=%d", c->fd(), c->outbound() ? 1 : 0);
+
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, c->fd(), nullptr);
+
+    std::deque<nnti::core::sockets_msg *> unsent;
+    std::unique_lock<std::mutex> send_lock(c->send_mutex_);
+    c->closed_ = true;
+    unsent.swap(c->send_queue_);
+    close(c->fd_);
+    send_lock.unlock();
+
+    std::map<uint32_t, nnti::core::sockets_cmd_op *> waiting;
+    std::unique_lock<std::mutex> ops_lock(c->ops_mutex_);
+    waiting.swap(c->waiting_ops_);
+    ops_lock.unlock();
+
+    for (auto &w : waiting) {
+        w.second->result(NNTI_EIO);
+        complete_cmd_op(w.second);
+    }
+    for (auto msg : unsent) {
+        if (msg->op == nullptr) {
+            // a reply
+            delete msg;
+        } else if (msg->hdr.type == nnti::core::SOCKETS_MSG_SEND) {
+            msg->op->result(NNTI_EIO);
+            complete_cmd_op(msg->op);
+        }
+        // everything else was in waiting
+    }
+
+    if (c->outbound()) {
+        nthread_lock(&new_connection_lock_);
+        nnti::core::sockets_connection *conn = (nnti::core::sockets_connection*)conn_map_.get(c->peer_pid());
+        if (conn != nullptr) {
+            conn->forget_channel(c);
+        }
+        nthread_unlock(&new_connection_lock_);
+        // Another thread may have looked the channel up just before we
+        // closed it.  Keep it until stop() so that queue_msg() finds it
+        // closed instead of freed.
+        channels_lock.lock();
+        dead_channels_.push_back(c);
+        channels_lock.unlock();
+    } else {
+        delete c;
+    }
+}
+
+/*
+ * Queue a message on a channel and write as much of it as the socket
+ * will take.  Returns false if the channel is closed.
+ */
+bool
+sockets_transport::queue_msg(
+    nnti::core::sockets_channel *c,
+    nnti::core::sockets_msg     *msg)
+{
+    std::unique_lock<std::mutex> lock(c->send_mutex_);
+    if (c->closed_) {
+        return false;
+    }
+    c->send_queue_.push_back(msg);
+    if (!c->want_write_) {
+        // if EPOLLOUT is armed, the progress thread will get to it
+        flush_channel(c);
+    }
+    return true;
+}
+
+/*
+ * Write queued messages until the queue is empty or the socket is full.
+ * The header and payload of several messages are gathered into a single
+ * sendmsg().  Called with the channel's send lock held.  Returns false
+ * if the socket failed.  The progress thread closes the channel when
+ * epoll reports the error.
+ */
+bool
+sockets_transport::flush_channel(
+    nnti::core::sockets_channel *c)
+{
+    const int max_iov = 64;
+
+    struct iovec              iov[max_iov];
+    nnti::core::sockets_msg  *msgs[max_iov];
+    uint64_t                  remaining[max_iov];
+    nnti::core::sockets_cmd_op *completes[max_iov];
+    bool                      completed_any = false;
+
+    while (!c->send_queue_.empty()) {
+        int  iov_count = 0;
+        int  msg_count = 0;
+
+        /*
+         * Read everything we need from the messages now.  Once a request
+         * is on the wire, its reply can arrive and its op can be reused
+         * before sendmsg() returns.
+         */
+        for (auto iter = c->send_queue_.begin() ; iter != c->send_queue_.end() && iov_count < max_iov-1 ; ++iter) {
+            nnti::core::sockets_msg *msg = *iter;
+            uint64_t written = msg->written;
+            if (written < sizeof(msg->hdr)) {
+                iov[iov_count].iov_base = (char*)&msg->hdr + written;
+                iov[iov_count].iov_len  = sizeof(msg->hdr) - written;
+                iov_count++;
+                written = sizeof(msg->hdr);
+            }
+            if (msg->hdr.payload_length > 0) {
+                uint64_t payload_written = written - sizeof(msg->hdr);
+                iov[iov_count].iov_base = msg->payload + payload_written;
+                iov[iov_count].iov_len  = msg->hdr.payload_length - payload_written;
+                iov_count++;
+            }
+            msgs[msg_count]      = msg;
+            remaining[msg_count] = msg->total_length() - msg->written;
+            if (msg->op != nullptr && msg->hdr.type == nnti::core::SOCKETS_MSG_SEND) {
+                completes[msg_count] = msg->op;
+            } else {
+                completes[msg_count] = nullptr;
+            }
+            msg_count++;
+        }
+
+        struct msghdr mh;
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_iov    = iov;
+        mh.msg_iovlen = iov_count;
+
+        ssize_t n = sendmsg(c->fd_, &mh, MSG_NOSIGNAL | MSG_DONTWAIT);
+        stats_->sendmsg_calls++;
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (!c->want_write_) {
+                    arm_write(c, true);
+                }
+                break;
+            }
+            log_debug("sockets_transport", "sendmsg(fd=%d) failed: %s", c->fd_, strerror(errno));
+            return false;
+        }
+        stats_->bytes_sent += n;
+
+        uint64_t left = n;
+        for (int i=0 ; i<msg_count && left > 0 ; i++) {
+            if (left < remaining[i]) {
+                msgs[i]->written += left;
+                left = 0;
+                break;
+            }
+            left -= remaining[i];
+            c->send_queue_.pop_front();
+            if (completes[i] != nullptr) {
+                std::lock_guard<std::mutex> lock(completed_mutex_);
+                completed_ops_.push_back(completes[i]);
+                completed_any = true;
+            } else if (msgs[i]->op == nullptr) {
+                // we own replies
+                delete msgs[i];
+            }
+        }
+    }
+
+    if (c->send_queue_.empty() && c->want_write_) {
+        arm_write(c, false);
+    }
+
+    if (completed_any && std::this_thread::get_id() != progress_thread_.get_id()) {
+        wakeup();
+    }
+
+    return true;
+}
+
+/*
+ * Ask epoll to tell the progress thread when the socket can take more
+ * data.  Called with the channel's send lock held.
+ */
+void
+sockets_transport::arm_write(
+    nnti::core::sockets_channel *c,
+    bool                         on)
+{
+    struct epoll_event ev;
+
+    ev.events   = EPOLLIN | (on ? EPOLLOUT : 0);
+    ev.data.ptr = c;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, c->fd_, &ev) < 0) {
+        log_error("sockets_transport", "epoll_ctl(MOD, fd=%d) failed: %s", c->fd_, strerror(errno));
+        return;
+    }
+    c->want_write_ = on;
+}
+
+/*
+ * Read from a channel until the socket is drained or we've handled
+ * max_msgs_per_read messages.  Payloads are read straight into their
+ * destination, together with the start of the next header.  Returns
+ * false if the channel should be closed.
+ */
+bool
+sockets_transport::read_channel(
+    nnti::core::sockets_channel *c)
+{
+    char scratch[16384];
+    int  msg_count = 0;
+
+    while (msg_count < max_msgs_per_read) {
+        if (c->state_ == nnti::core::sockets_channel::RECV_HEADER) {
+            if (c->hdr_have_ < sizeof(c->hdr_)) {
+                ssize_t n = recv(c->fd_, (char*)&c->hdr_ + c->hdr_have_, sizeof(c->hdr_) - c->hdr_have_, MSG_DONTWAIT);
+                if (n == 0) {
+                    log_debug("sockets_transport", "fd=%d closed by peer", c->fd_);
+                    return false;
+                }
+                if (n < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                        return true;
+                    }
+                    log_debug("sockets_transport", "recv(fd=%d) failed: %s", c->fd_, strerror(errno));
+                    return false;
+                }
+                stats_->bytes_recvd += n;
+                c->hdr_have_ += n;
+                if (c->hdr_have_ < sizeof(c->hdr_)) {
+                    continue;
+                }
+            }
+
+            begin_payload(c);
+            if (c->hdr_.payload_length == 0) {
+                finish_message(c);
+                c->hdr_have_ = 0;
+                msg_count++;
+                continue;
+            }
+            c->state_ = nnti::core::sockets_channel::RECV_PAYLOAD;
+        }
+
+        uint64_t     want = c->hdr_.payload_length - c->have_;
+        struct iovec iov[2];
+        int          iov_count = 1;
+        if (c->dst_ != nullptr) {
+            iov[0].iov_base = c->dst_ + c->have_;
+            iov[0].iov_len  = want;
+        } else {
+            iov[0].iov_base = scratch;
+            iov[0].iov_len  = (want < sizeof(scratch)) ? want : sizeof(scratch);
+        }
+        if (iov[0].iov_len == want) {
+            // read ahead into the next header
+            iov[1].iov_base = &c->next_hdr_;
+            iov[1].iov_len  = sizeof(c->next_hdr_);
+            iov_count = 2;
+        }
+
+        ssize_t n = readv(c->fd_, iov, iov_count);
+        stats_->readv_calls++;
+        if (n == 0) {
+            log_debug("sockets_transport", "fd=%d closed by peer", c->fd_);
+            return false;
+        }
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return true;
+            }
+            log_debug("sockets_transport", "readv(fd=%d) failed: %s", c->fd_, strerror(errno));
+            return false;
+        }
+        stats_->bytes_recvd += n;
+
+        uint64_t got = n;
+        if (got < want) {
+            c->have_ += got;
+            continue;
+        }
+        c->have_ = c->hdr_.payload_length;
+        uint64_t extra = got - want;
+
+        finish_message(c);
+        msg_count++;
+
+        memcpy(&c->hdr_, &c->next_hdr_, extra);
+        c->hdr_have_ = extra;
+        c->state_    = nnti::core::sockets_channel::RECV_HEADER;
+    }
+
+    // we stopped early.  make sure epoll wakes us up for the rest.
+    return true;
+}
+
+/*
+ * A header has arrived.  Decide where its payload goes.
+ */
+void
+sockets_transport::begin_payload(
+    nnti::core::sockets_channel *c)
+{
+    nnti::core::sockets_msg_header &hdr = c->hdr_;
+    nnti::datatype::nnti_buffer    *b   = nullptr;
+
+    c->dst_      = nullptr;
+    c->have_     = 0;
+    c->reply_op_ = nullptr;
+
+    switch (hdr.type) {
+        case nnti::core::SOCKETS_MSG_SEND:
+            if (hdr.target_base_addr == 0) {
+                c->unexpected_ = new char[hdr.payload_length];
+                c->dst_        = c->unexpected_;
+                break;
+            }
+            b = target_buffer(hdr);
+            if (b == nullptr) {
+                log_error("sockets_transport", "SEND to unknown buffer %p.  dropping %lu bytes.",
+                          (void*)hdr.target_base_addr, hdr.payload_length);
+            } else if (b->queuing()) {
+                c->staging_.resize(hdr.payload_length);
+                c->dst_ = c->staging_.data();
+            } else if (hdr.target_offset + hdr.payload_length <= b->size()) {
+                c->dst_ = b->payload() + hdr.target_offset;
+            } else {
+                log_error("sockets_transport", "SEND length extends beyond the end of target buffer.  dropping %lu bytes.",
+                          hdr.payload_length);
+            }
+            break;
+        case nnti::core::SOCKETS_MSG_PUT:
+            b = target_buffer(hdr);
+            if (b == nullptr) {
+                log_error("sockets_transport", "PUT to unknown buffer %p.  dropping %lu bytes.",
+                          (void*)hdr.target_base_addr, hdr.payload_length);
+            } else if (hdr.target_offset + hdr.payload_length <= b->size()) {
+                c->dst_ = b->payload() + hdr.target_offset;
+            } else {
+                log_error("sockets_transport", "PUT length extends beyond the end of target buffer.  dropping %lu bytes.",
+                          hdr.payload_length);
+            }
+            break;
+        case nnti::core::SOCKETS_MSG_GET_REPLY:
+        case nnti::core::SOCKETS_MSG_PUT_ACK:
+        case nnti::core::SOCKETS_MSG_ATOMIC_REPLY:
+            c->reply_op_ = c->take_waiting_op(hdr.op_id);
+            if (c->reply_op_ == nullptr) {
+                log_error("sockets_transport", "reply type=%u for unknown op %u", hdr.type, hdr.op_id);
+                break;
+            }
+            if (hdr.type == nnti::core::SOCKETS_MSG_GET_REPLY && hdr.payload_length > 0) {
+                nnti::datatype::nnti_work_request &wr = c->reply_op_->wid()->wr();
+                nnti::datatype::nnti_buffer *local = nnti::datatype::nnti_buffer::to_obj(wr.local_hdl());
+                if (hdr.payload_length <= wr.length()) {
+                    c->dst_ = local->payload() + wr.local_offset();
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * A whole message has arrived.  Act on it.
+ */
+void
+sockets_transport::finish_message(
+    nnti::core::sockets_channel *c)
+{
+    nnti::core::sockets_msg_header &hdr = c->hdr_;
+    nnti::datatype::nnti_buffer    *b   = nullptr;
+    NNTI_event_t                   *e   = nullptr;
+
+    switch (hdr.type) {
+        case nnti::core::SOCKETS_MSG_SEND:
+            if (hdr.target_base_addr == 0) {
+                if (unexpected_queue_ == nullptr) {
+                    // If there is no unexpected queue, then there is no way
+                    // to communicate unexpected messages to the app.
+                    // Drop this message.
+                    stats_->dropped_unexpected++;
+                    delete [] c->unexpected_;
+                    c->unexpected_ = nullptr;
+                    break;
+                }
+                unexpected_msg m;
+                m.peer    = initiator_peer(hdr);
+                m.length  = hdr.payload_length;
+                m.payload = c->unexpected_;
+                c->unexpected_ = nullptr;
+
+                std::unique_lock<std::mutex> lock(unexpected_mutex_);
+                unexpected_msgs_.push_back(m);
+                lock.unlock();
+
+                if (event_freelist_->pop(e) == false) {
+                    e = new NNTI_event_t;
+                }
+                e->trans_hdl  = nnti::transports::transport::to_hdl(this);
+                e->result     = NNTI_OK;
+                e->op         = NNTI_OP_SEND;
+                e->peer       = nnti::datatype::nnti_peer::to_hdl(m.peer);
+                e->length     = m.length;
+                e->type       = NNTI_EVENT_UNEXPECTED;
+                e->start      = nullptr;
+                e->offset     = 0;
+                e->context    = 0;
+                if (unexpected_queue_->invoke_cb(e) != NNTI_OK) {
+                    unexpected_queue_->push(e);
+                    unexpected_queue_->notify();
+                } else {
+                    event_freelist_->push(e);
+                }
+                stats_->unexpected_recvs++;
+            } else if (c->dst_ != nullptr) {
+                uint64_t actual_offset = hdr.target_offset;
+                b = target_buffer(hdr);
+                if (b->queuing()) {
+                    NNTI_result_t rc = b->copy_in(hdr.target_offset, c->staging_.data(), hdr.payload_length, &actual_offset);
+                    if (rc != NNTI_OK) {
+                        log_error("sockets_transport", "copy_in() failed (rc=%d)", rc);
+                    }
+                }
+
+                if (event_freelist_->pop(e) == false) {
+                    e = new NNTI_event_t;
+                }
+                e->trans_hdl  = nnti::transports::transport::to_hdl(this);
+                e->result     = NNTI_OK;
+                e->op         = NNTI_OP_SEND;
+                e->peer       = nnti::datatype::nnti_peer::to_hdl(initiator_peer(hdr));
+                e->length     = hdr.payload_length;
+                e->type       = NNTI_EVENT_RECV;
+                e->start      = b->payload();
+                e->offset     = actual_offset;
+                e->context    = 0;
+                deliver_event(b, e);
+                stats_->recvs++;
+            }
+            break;
+        case nnti::core::SOCKETS_MSG_GET_REQUEST:
+            {
+                uint64_t length = (uint64_t)hdr.operand1;
+                b = target_buffer(hdr);
+                if (b == nullptr || hdr.target_offset + length > b->size()) {
+                    log_error("sockets_transport", "GET from %p+%lu (length=%lu) is out of bounds",
+                              (void*)hdr.target_base_addr, hdr.target_offset, length);
+                    send_reply(c, nnti::core::SOCKETS_MSG_GET_REPLY, hdr.op_id, nullptr, 0, 0, NNTI_EINVAL);
+                } else {
+                    send_reply(c, nnti::core::SOCKETS_MSG_GET_REPLY, hdr.op_id, b->payload() + hdr.target_offset, length, 0, NNTI_OK);
+                }
+            }
+            break;
+        case nnti::core::SOCKETS_MSG_PUT:
+            send_reply(c, nnti::core::SOCKETS_MSG_PUT_ACK, hdr.op_id, nullptr, 0, 0,
+                       (c->dst_ != nullptr) ? NNTI_OK : NNTI_EINVAL);
+            break;
+        case nnti::core::SOCKETS_MSG_FADD:
+        case nnti::core::SOCKETS_MSG_CSWAP:
+            b = target_buffer(hdr);
+            if (b == nullptr || hdr.target_offset + sizeof(int64_t) > b->size()) {
+                log_error("sockets_transport", "atomic at %p+%lu is out of bounds",
+                          (void*)hdr.target_base_addr, hdr.target_offset);
+                send_reply(c, nnti::core::SOCKETS_MSG_ATOMIC_REPLY, hdr.op_id, nullptr, 0, 0, NNTI_EINVAL);
+            } else {
+                // the progress thread is the only writer, so this is atomic
+                // with respect to every other peer's atomics.
+                int64_t *op_addr = (int64_t *)(b->payload() + hdr.target_offset);
+                int64_t  current = *op_addr;
+                if (hdr.type == nnti::core::SOCKETS_MSG_FADD) {
+                    *op_addr += hdr.operand1;
+                } else if (current == hdr.operand1) {
+                    *op_addr = hdr.operand2;
+                }
+                send_reply(c, nnti::core::SOCKETS_MSG_ATOMIC_REPLY, hdr.op_id, nullptr, 0, current, NNTI_OK);
+            }
+            break;
+        case nnti::core::SOCKETS_MSG_GET_REPLY:
+        case nnti::core::SOCKETS_MSG_PUT_ACK:
+        case nnti::core::SOCKETS_MSG_ATOMIC_REPLY:
+            if (c->reply_op_ != nullptr) {
+                nnti::core::sockets_cmd_op *op = c->reply_op_;
+                NNTI_result_t               rc = (NNTI_result_t)hdr.operand2;
+                if (hdr.type == nnti::core::SOCKETS_MSG_GET_REPLY && rc == NNTI_OK && c->dst_ == nullptr) {
+                    rc = NNTI_EMSGSIZE;
+                }
+                if (hdr.type == nnti::core::SOCKETS_MSG_ATOMIC_REPLY && rc == NNTI_OK) {
+                    nnti::datatype::nnti_work_request &wr = op->wid()->wr();
+                    nnti::datatype::nnti_buffer *local = nnti::datatype::nnti_buffer::to_obj(wr.local_hdl());
+                    *(int64_t*)(local->payload() + wr.local_offset()) = hdr.operand1;
+                }
+                op->result(rc);
+                c->reply_op_ = nullptr;
+                complete_cmd_op(op);
+            }
+            break;
+        default:
+            log_error("sockets_transport", "unknown message type %u on fd=%d", hdr.type, c->fd_);
+            break;
+    }
+}
+
+void
+sockets_transport::send_reply(
+    nnti::core::sockets_channel *c,
+    uint32_t                     type,
+    uint32_t                     op_id,
+    char                        *payload,
+    uint64_t                     payload_length,
+    int64_t                      operand1,
+    NNTI_result_t                result)
+{
+    nnti::core::sockets_msg *msg = new nnti::core::sockets_msg();
+
+    msg->hdr.type           = type;
+    msg->hdr.op_id          = op_id;
+    msg->hdr.initiator      = me_.pid();
+    msg->hdr.payload_length = payload_length;
+    msg->hdr.operand1       = operand1;
+    msg->hdr.operand2       = result;
+    msg->payload            = payload;
+
+    if (!queue_msg(c, msg)) {
+        delete msg;
+    }
+}
+
+/*
+ * Start a send, put, get or atomic.  They all begin with a message to
+ * the target.  Everything but a send then waits for the target's reply.
+ */
+NNTI_result_t
+sockets_transport::start_op(
+    nnti::datatype::nnti_work_request *wr,
+    uint32_t                           type,
+    NNTI_work_id_t                    *wid)
+{
+    nnti::datatype::nnti_work_id   *work_id       = new nnti::datatype::nnti_work_id(*wr);
+    nnti::datatype::sockets_buffer *local_buffer  = (nnti::datatype::sockets_buffer *)wr->local_hdl();
+    nnti::datatype::sockets_buffer *remote_buffer = (nnti::datatype::sockets_buffer *)wr->remote_hdl();
+    uint64_t                        op_length     = wr->length();
+    nnti::core::sockets_connection *conn          = nullptr;
+    nnti::core::sockets_channel    *c             = nullptr;
+    nnti::core::sockets_cmd_op     *cmd_op        = nullptr;
+
+    if (type == nnti::core::SOCKETS_MSG_FADD || type == nnti::core::SOCKETS_MSG_CSWAP) {
+        op_length = sizeof(int64_t);
+    }
+
+    // bounds checking.  the target checks again.
+    if (wr->local_offset() + op_length > local_buffer->length()) {
+        log_error("sockets_transport", "length extends beyond the end of local buffer");
+        delete work_id;
+        return NNTI_EMSGSIZE;
+    }
+    if (remote_buffer && (wr->remote_offset() + op_length > remote_buffer->length())) {
+        log_error("sockets_transport", "length extends beyond the end of remote buffer");
+        delete work_id;
+        return NNTI_EMSGSIZE;
+    }
+
+    conn = (nnti::core::sockets_connection*)conn_map_.get(wr->peer_pid());
+    if (conn == nullptr) {
+        log_error("sockets_transport", "no connection to peer pid=%016lx", wr->peer_pid());
+        delete work_id;
+        return NNTI_EINVAL;
+    }
+    c = conn->channel();
+    if (c == nullptr) {
+        delete work_id;
+        return NNTI_EIO;
+    }
+
+    if (cmd_op_freelist_->pop(cmd_op) == false) {
+        cmd_op = new nnti::core::sockets_cmd_op();
+    }
+    cmd_op->set(work_id);
+    cmd_op->channel(c);
+
+    nnti::core::sockets_msg *msg = cmd_op->msg();
+    msg->hdr.type             = type;
+    msg->hdr.op_id            = cmd_op->id();
+    msg->hdr.initiator        = me_.pid();
+    msg->hdr.target_base_addr = remote_buffer ? (uint64_t)remote_buffer->payload() : 0;
+    msg->hdr.target_offset    = wr->remote_offset();
+
+    switch (type) {
+        case nnti::core::SOCKETS_MSG_SEND:
+            msg->payload            = local_buffer->payload() + wr->local_offset();
+            msg->hdr.payload_length = op_length;
+            if (wr->flags() & NNTI_OF_ZERO_COPY) {
+                // the app left room for a command header at the front of the message
+                msg->payload            += sizeof(nnti::core::sockets_msg_header);
+                msg->hdr.payload_length -= sizeof(nnti::core::sockets_msg_header);
+            }
+            stats_->sends++;
+            break;
+        case nnti::core::SOCKETS_MSG_PUT:
+            msg->payload            = local_buffer->payload() + wr->local_offset();
+            msg->hdr.payload_length = op_length;
+            stats_->puts++;
+            break;
+        case nnti::core::SOCKETS_MSG_GET_REQUEST:
+            msg->hdr.operand1 = op_length;
+            stats_->gets++;
+            break;
+        case nnti::core::SOCKETS_MSG_FADD:
+        case nnti::core::SOCKETS_MSG_CSWAP:
+            msg->hdr.operand1 = wr->operand1();
+            msg->hdr.operand2 = wr->operand2();
+            stats_->atomics++;
+            break;
+    }
+
+    if (type != nnti::core::SOCKETS_MSG_SEND) {
+        c->add_waiting_op(cmd_op->id(), cmd_op);
+    }
+    if (!queue_msg(c, msg)) {
+        log_error("sockets_transport", "channel to peer pid=%016lx is closed", wr->peer_pid());
+        c->take_waiting_op(cmd_op->id());
+        cmd_op_freelist_->push(cmd_op);
+        delete work_id;
+        return NNTI_EIO;
+    }
+
+    *wid = (NNTI_work_id_t)work_id;
+
+    return NNTI_OK;
+}
+
+void
+sockets_transport::complete_cmd_op(
+    nnti::core::sockets_cmd_op *cmd_op)
+{
+    nnti::datatype::nnti_work_request &wr = cmd_op->wid()->wr();
+
+    nnti::datatype::nnti_event_queue    *alt_q          = nnti::datatype::nnti_event_queue::to_obj(wr.alt_eq());
+    nnti::datatype::nnti_buffer         *b              = nnti::datatype::nnti_buffer::to_obj(wr.local_hdl());
+    nnti::datatype::nnti_event_queue    *buf_q          = nnti::datatype::nnti_event_queue::to_obj(b->eq());
+    NNTI_event_t                        *e              = create_event(cmd_op);
+    bool                                 event_complete = false;
+    bool                                 release_event  = true;
+
+    log_debug("sockets_transport", "complete_cmd_op() - buf_q=%p  alt_q=%p", buf_q, alt_q);
+
+    if (wr.invoke_cb(e) == NNTI_OK) {
+        event_complete = true;
+    }
+    if (!event_complete && alt_q && alt_q->invoke_cb(e) == NNTI_OK) {
+        event_complete = true;
+    }
+    if (!event_complete && buf_q && buf_q->invoke_cb(e) == NNTI_OK) {
+        event_complete = true;
+    }
+    if (!event_complete && alt_q) {
+        alt_q->push(e);
+        alt_q->notify();
+        event_complete = true;
+        release_event = false;
+    }
+    if (!event_complete && buf_q) {
+        buf_q->push(e);
+        buf_q->notify();
+        event_complete = true;
+        release_event = false;
+    }
+    if (release_event) {
+        event_freelist_->push(e);
+    }
+
+    if (wr.op() == NNTI_OP_SEND && wr.remote_hdl() == NNTI_INVALID_HANDLE) {
+        stats_->unexpected_sends++;
+    }
+
+    cmd_op_freelist_->push(cmd_op);
+}
+
+/*
+ * Deliver the completions of sends that have been written.  Returns true
+ * if there were any.
+ */
+bool
+sockets_transport::drain_completed(void)
+{
+    std::deque<nnti::core::sockets_cmd_op*> completed;
+    bool                                    busy = false;
+
+    // callbacks often start the next send, which may finish writing
+    // right away.  keep going so it doesn't wait for the next wakeup.
+    while (true) {
+        std::unique_lock<std::mutex> lock(completed_mutex_);
+        completed.swap(completed_ops_);
+        lock.unlock();
+
+        if (completed.empty()) {
+            break;
+        }
+        busy = true;
+
+        for (auto op : completed) {
+            complete_cmd_op(op);
+        }
+        completed.clear();
+    }
+
+    return busy;
+}
+
+nnti::datatype::nnti_buffer *
+sockets_transport::target_buffer(
+    const nnti::core::sockets_msg_header &hdr)
+{
+    return buffer_map_.get((char*)hdr.target_base_addr);
+}
+
+nnti::datatype::nnti_peer *
+sockets_transport::initiator_peer(
+    const nnti::core::sockets_msg_header &hdr)
+{
+    nnti::core::nnti_connection *conn = conn_map_.get(hdr.initiator);
+    if (conn == nullptr) {
+        log_warn("sockets_transport", "no connection to initiator pid=%016lx", hdr.initiator);
+        return nullptr;
+    }
+    return conn->peer();
+}
+
+/*
+ * Hand an event to the target buffer's callback, then its queue's
+ * callback, then its queue.
+ */
+void
+sockets_transport::deliver_event(
+    nnti::datatype::nnti_buffer *b,
+    NNTI_event_t                *e)
+{
+    nnti::datatype::nnti_event_queue *q             = nnti::datatype::nnti_event_queue::to_obj(b->eq());
+    bool                              release_event = true;
+
+    if (b->invoke_cb(e) != NNTI_OK) {
+        if (q && q->invoke_cb(e) != NNTI_OK) {
+            q->push(e);
+            q->notify();
+            release_event = false;
+        }
+    }
+    if (release_event) {
+        // we're done with the event
+        event_freelist_->push(e);
+    }
+}
+
+NNTI_event_t *
+sockets_transport::create_event(
+    nnti::core::sockets_cmd_op *cmd_op)
+{
+    nnti::datatype::nnti_work_id            *wid = cmd_op->wid();
+    const nnti::datatype::nnti_work_request &wr  = wid->wr();
+    nnti::datatype::nnti_buffer             *b   = nnti::datatype::nnti_buffer::to_obj(wr.local_hdl());
+    NNTI_event_t                            *e   = nullptr;
+
+    if (event_freelist_->pop(e) == false) {
+        e = new NNTI_event_t;
+    }
+
+    e->trans_hdl  = nnti::transports::transport::to_hdl(this);
+    e->result     = cmd_op->result();
+    e->op         = wr.op();
+    e->peer       = wr.peer();
+    e->length     = wr.length();
+
+    if (wr.op() == NNTI_OP_SEND) {
+        e->type = NNTI_EVENT_SEND;
+    }
+    if (wr.op() == NNTI_OP_PUT) {
+        e->type = NNTI_EVENT_PUT;
+    }
+    if (wr.op() == NNTI_OP_GET) {
+        e->type = NNTI_EVENT_GET;
+    }
+    if ((wr.op() == NNTI_OP_ATOMIC_FADD) || (wr.op() == NNTI_OP_ATOMIC_CSWAP)) {
+        e->type = NNTI_EVENT_ATOMIC;
+    }
+    e->start      = b->payload();
+    e->offset     = wr.local_offset();
+    e->context    = wr.event_context();
+
+    return(e);
+}
+
+} /* namespace transports */
+} /* namespace nnti */
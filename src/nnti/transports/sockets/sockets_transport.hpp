@@ -0,0 +1,723 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#ifndef SOCKETS_TRANSPORT_HPP_
+#define SOCKETS_TRANSPORT_HPP_
+
+#include "nnti/nnti_pch.hpp"
+
+#include "nnti/nntiConfig.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "faodel-common/Configuration.hh"
+
+#include "nnti/nnti_transport.hpp"
+#include "nnti/transports/base/base_transport.hpp"
+
+#include "nnti/nnti_types.h"
+
+#include "nnti/nnti_buffer.hpp"
+#include "nnti/nnti_connection.hpp"
+#include "nnti/nnti_freelist.hpp"
+#include "nnti/nnti_wr.hpp"
+
+
+namespace nnti  {
+
+namespace datatype {
+    class nnti_event_queue;
+    class nnti_event_callback;
+    class nnti_work_id;
+}
+
+namespace core {
+    // forward declaration of friend
+    class sockets_channel;
+    class sockets_cmd_op;
+    class sockets_connection;
+    struct sockets_msg;
+    struct sockets_msg_header;
+}
+
+namespace transports {
+
+/**
+ * @brief An NNTI transport that runs over plain TCP sockets.
+ *
+ * Nothing here needs MPI or RDMA hardware, so this transport works from
+ * login nodes, cloud instances and CI machines.  Peers find each other
+ * with the same whookie handshake as the other transports and then open
+ * a TCP connection to the port this transport listens on.
+ *
+ * One progress thread waits on epoll for every socket.  One-sided get and
+ * put are emulated with request and reply messages that the target's
+ * progress thread serves.  Payloads are never staged.  They are written
+ * out of and read into the registered buffers with scatter/gather I/O.
+ */
+class sockets_transport
+: public base_transport {
+
+    friend class nnti::core::sockets_connection;
+
+private:
+    struct whookie_stats {
+        std::atomic<uint64_t> pinned_bytes;
+        std::atomic<uint64_t> pinned_buffers;
+        std::atomic<uint64_t> unexpected_sends;
+        std::atomic<uint64_t> unexpected_recvs;
+        std::atomic<uint64_t> dropped_unexpected;
+        std::atomic<uint64_t> sends;
+        std::atomic<uint64_t> recvs;
+        std::atomic<uint64_t> gets;
+        std::atomic<uint64_t> puts;
+        std::atomic<uint64_t> atomics;
+        std::atomic<uint64_t> bytes_sent;
+        std::atomic<uint64_t> bytes_recvd;
+        std::atomic<uint64_t> sendmsg_calls;
+        std::atomic<uint64_t> readv_calls;
+        std::atomic<uint64_t> epoll_wakeups;
+
+        whookie_stats()
+        {
+            pinned_bytes.store(0);
+            pinned_buffers.store(0);
+            unexpected_sends.store(0);
+            unexpected_recvs.store(0);
+            dropped_unexpected.store(0);
+            sends.store(0);
+            recvs.store(0);
+            gets.store(0);
+            puts.store(0);
+            atomics.store(0);
+            bytes_sent.store(0);
+            bytes_recvd.store(0);
+            sendmsg_calls.store(0);
+            readv_calls.store(0);
+            epoll_wakeups.store(0);
+        }
+    };
+
+    // an unexpected send waiting for next_unexpected()
+    struct unexpected_msg {
+        nnti::datatype::nnti_peer *peer;
+        uint64_t                   length;
+        char                      *payload;
+    };
+
+    const static int max_epoll_events = 64;
+    const static int max_msgs_per_read = 64;   // then give the other channels a turn
+
+    bool                                   started_;
+
+    uint32_t                               cmd_msg_size_;
+    uint32_t                               cmd_msg_count_;
+
+    int                                    listen_fd_;
+    uint32_t                               data_port_;
+    int                                    epoll_fd_;
+    int                                    wakeup_fd_;
+    int                                    listen_tag_;  // epoll tags for the two fds that aren't channels
+    int                                    wakeup_tag_;
+
+    std::atomic<bool>                      terminate_progress_thread_;
+    std::thread                            progress_thread_;
+
+    nthread_lock_t                         new_connection_lock_;
+    nnti::core::nnti_connection_map        conn_map_;
+    nnti::datatype::nnti_buffer_map        buffer_map_;
+
+    std::mutex                             channels_mutex_;
+    std::set<nnti::core::sockets_channel*> channels_;          // every open channel
+    std::deque<nnti::core::sockets_channel*> closing_channels_;  // disconnected, for the progress thread to close
+    std::deque<nnti::core::sockets_channel*> dead_channels_;     // closed outbound channels.  freed in stop().
+
+    std::mutex                             completed_mutex_;
+    std::deque<nnti::core::sockets_cmd_op*> completed_ops_;    // sends written by an app thread
+
+    std::mutex                             unexpected_mutex_;
+    nnti::datatype::nnti_event_queue      *unexpected_queue_;
+    std::deque<unexpected_msg>             unexpected_msgs_;
+
+    uint64_t                                                  event_freelist_size_;
+    nnti::core::nnti_freelist<NNTI_event_t*>                 *event_freelist_;
+    uint64_t                                                  cmd_op_freelist_size_;
+    nnti::core::nnti_freelist<nnti::core::sockets_cmd_op*>   *cmd_op_freelist_;
+    uint64_t                                                  freelist_magazine_size_;
+
+    struct whookie_stats *stats_;
+
+    NNTI_attrs_t attrs_;
+
+private:
+    /**
+     * @brief Initialize NNTI to use a specific transport.
+     *
+     * \param[in]  config    A Configuration object that NNTI should use to configure itself.
+     * \return A result code (NNTI_OK or an error)
+     *
+     */
+    sockets_transport(
+        faodel::Configuration &config);
+
+public:
+    /**
+     * @brief Deactivates a specific transport.
+     *
+     * \return A result code (NNTI_OK or an error)
+     */
+    ~sockets_transport();
+
+    NNTI_result_t
+    start(void) override;
+
+    NNTI_result_t
+    stop(void) override;
+
+    /**
+     * @brief Indicates if a transport has been initialized.
+     *
+     * \return A result code (NNTI_OK or an error)
+     *
+     */
+    bool
+    initialized(void) override;
+
+    /**
+     * @brief Return the URL field of this transport.
+     *
+     * \param[out] url       A string that describes this process in a transport specific way.
+     * \param[in]  maxlen    The length of the 'url' string parameter.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    get_url(
+        char           *url,
+        const uint64_t  maxlen) override;
+
+    /**
+     * @brief Get the process ID of this process.
+     *
+     * \param[out] pid   the process ID of this process
+     * \return A result code (NNTI_OK or an error)
+     *
+     */
+    NNTI_result_t
+    pid(NNTI_process_id_t *pid) override;
+
+    /**
+     * @brief Get attributes of the transport.
+     *
+     * \param[out] attrs   the current attributes
+     * \return A result code (NNTI_OK or an error)
+     *
+     */
+    NNTI_result_t
+    attrs(NNTI_attrs_t *attrs) override;
+
+    /**
+     * @brief Prepare for communication with the peer identified by url.
+     *
+     * \param[in]  url       A string that describes a peer's location on the network.
+     * \param[in]  timeout   The amount of time (in milliseconds) to wait before aborting the connection attempt.
+     * \param[out] peer_hdl  A handle to a peer that can be used for network operations.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    connect(
+        const char  *url,
+        const int    timeout,
+        NNTI_peer_t *peer_hdl) override;
+
+    /**
+     * @brief Terminate communication with this peer.
+     *
+     * \param[in] peer_hdl  A handle to a peer.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    disconnect(
+        NNTI_peer_t peer_hdl) override;
+
+    /**
+     * @brief Create an event queue.
+     *
+     * \param[in]  size      The number of events the queue can hold.
+     * \param[in]  flags     Control the behavior of the queue.
+     * \param[out] eq        The new event queue.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    eq_create(
+        uint64_t            size,
+        NNTI_eq_flags_t     flags,
+        NNTI_event_queue_t *eq) override;
+
+    NNTI_result_t
+    eq_create(
+        uint64_t                             size,
+        NNTI_eq_flags_t                      flags,
+        nnti::datatype::nnti_event_callback  cb,
+        void                                *cb_context,
+        NNTI_event_queue_t                  *eq) override;
+
+    /**
+     * @brief Destroy an event queue.
+     *
+     * \param[in] eq  The event queue to destroy.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    eq_destroy(
+        NNTI_event_queue_t eq) override;
+
+    /**
+     * @brief Wait for an event to arrive on an event queue.
+     *
+     * \param[in]  eq_list   A list of event queues to wait on.
+     * \param[in]  eq_count  The number of event queues in the list.
+     * \param[in]  timeout   The amount of time (in milliseconds) to wait.
+     * \param[out] which     The index of the EQ where the event occurred.
+     * \param[out] event     The details of the event.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    eq_wait(
+        NNTI_event_queue_t *eq_list,
+        const uint32_t      eq_count,
+        const int           timeout,
+        uint32_t           *which,
+        NNTI_event_t       *event) override;
+
+    /**
+     * @brief Wait for one or more events to arrive on an event queue.
+     *
+     * \param[in]  eq       The event queue to wait on.
+     * \param[out] events   An array of at least max events.
+     * \param[in]  max      The most events to return.
+     * \param[in]  timeout  The amount of time (in milliseconds) to wait.
+     * \param[out] count    The number of events returned.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    eq_wait_many(
+        NNTI_event_queue_t  eq,
+        NNTI_event_t       *events,
+        const uint32_t      max,
+        const int           timeout,
+        uint32_t           *count) override;
+
+    /**
+     * @brief Retrieves the next message from the unexpected list.
+     *
+     * \param[in]  dst_hdl        Buffer where the message is delivered.
+     * \param[in]  dst_offset     Offset into dst_hdl where the message is delivered.
+     * \param[out] result_event   Event describing the message delivered to dst_hdl.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    next_unexpected(
+        NNTI_buffer_t  dst_hdl,
+        uint64_t       dst_offset,
+        NNTI_event_t  *result_event) override;
+
+    /**
+     * @brief Retrieves a specific message from the unexpected list.
+     *
+     * \param[in]  unexpected_event  Event describing the message to retrieve.
+     * \param[in]  dst_hdl           Buffer where the message is delivered.
+     * \param[in]  dst_offset        Offset into dst_hdl where the message is delivered.
+     * \param[out] result_event      Event describing the message delivered to dst_hdl.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    get_unexpected(
+        NNTI_event_t  *unexpected_event,
+        NNTI_buffer_t  dst_hdl,
+        uint64_t       dst_offset,
+        NNTI_event_t  *result_event) override;
+
+    /**
+     * @brief Marks a send operation as complete.
+     *
+     * \param[in] event  The event to mark complete.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    event_complete(
+        NNTI_event_t *event) override;
+
+    /**
+     * @brief Decode an array of bytes into an NNTI datatype.
+     *
+     * \param[out] nnti_dt        The NNTI data structure cast to void*.
+     * \param[in]  packed_buf     A array of bytes containing the encoded data structure.
+     * \param[in]  packed_len     The number of encoded bytes.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    dt_unpack(
+        void           *nnti_dt,
+        char           *packed_buf,
+        const uint64_t  packed_len) override;
+
+    /**
+     * @brief Allocate a block of memory and prepare it for network operations.
+     *
+     * \param[in]  size        The size (in bytes) of the new buffer.
+     * \param[in]  flags       Control the behavior of this buffer.
+     * \param[in]  eq          Events occurring on the memory region are delivered to this event queue.
+     * \param[in]  cb          A callback that gets called for events delivered to eq.
+     * \param[in]  cb_context  A blob of data that is passed to each invocation of cb.
+     * \param[out] reg_ptr     A pointer to the memory buffer allocated.
+     * \param[out] reg_buf     A handle to a memory buffer that can be used for network operations.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    alloc(
+        const uint64_t                       size,
+        const NNTI_buffer_flags_t            flags,
+        NNTI_event_queue_t                   eq,
+        nnti::datatype::nnti_event_callback  cb,
+        void                                *cb_context,
+        char                               **reg_ptr,
+        NNTI_buffer_t                       *reg_buf) override;
+
+    /**
+     * @brief Disables network operations on the block of memory and frees it.
+     *
+     * \param[in]  reg_buf The buffer to cleanup.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    free(
+        NNTI_buffer_t reg_buf) override;
+
+    /**
+     * @brief Prepare a block of memory for network operations.
+     *
+     * \param[in]  buffer      Pointer to a memory block.
+     * \param[in]  size        The size (in bytes) of buffer.
+     * \param[in]  flags       Control the behavior of this buffer.
+     * \param[in]  eq          Events occurring on the memory region are delivered to this event queue.
+     * \param[in]  cb          A callback that gets called for events delivered to eq.
+     * \param[in]  cb_context  A blob of data that is passed to each invocation of cb.
+     * \param[out] reg_buf     A handle to a memory buffer that can be used for network operations.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    register_memory(
+        char                                *buffer,
+        const uint64_t                       size,
+        const NNTI_buffer_flags_t            flags,
+        NNTI_event_queue_t                   eq,
+        nnti::datatype::nnti_event_callback  cb,
+        void                                *cb_context,
+        NNTI_buffer_t                       *reg_buf) override;
+
+    /**
+     * @brief Disables network operations on a memory buffer.
+     *
+     * \param[in]  reg_buf  A handle to a memory buffer to unregister.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    unregister_memory(
+        NNTI_buffer_t reg_buf) override;
+
+    /**
+     * @brief Convert an NNTI peer to an NNTI_process_id_t.
+     *
+     * \param[in]   peer_hdl  A handle to a peer that can be used for network operations.
+     * \param[out]  pid       Compact binary representation of a process's location on the network.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    dt_peer_to_pid(
+        NNTI_peer_t        peer_hdl,
+        NNTI_process_id_t *pid) override;
+
+    /**
+     * @brief Convert an NNTI_process_id_t to an NNTI peer.
+     *
+     * \param[in]   pid       Compact binary representation of a process's location on the network.
+     * \param[out]  peer_hdl  A handle to a peer that can be used for network operations.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    dt_pid_to_peer(
+        NNTI_process_id_t  pid,
+        NNTI_peer_t       *peer_hdl) override;
+
+    /**
+     * @brief Send a message to a peer.
+     *
+     * \param[in]  wr   A work request that describes the operation
+     * \param[out] wid  Identifier used to track this work request
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    send(
+        nnti::datatype::nnti_work_request *wr,
+        NNTI_work_id_t                    *wid) override;
+
+    /**
+     * @brief Transfer data to a peer.
+     *
+     * \param[in]  wr   A work request that describes the operation
+     * \param[out] wid  Identifier used to track this work request
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    put(
+        nnti::datatype::nnti_work_request *wr,
+        NNTI_work_id_t                    *wid) override;
+
+    /**
+     * @brief Transfer data from a peer.
+     *
+     * \param[in]  wr   A work request that describes the operation
+     * \param[out] wid  Identifier used to track this work request
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    get(
+        nnti::datatype::nnti_work_request *wr,
+        NNTI_work_id_t                    *wid) override;
+
+    /**
+     * perform a 64-bit atomic operation with GET semantics
+     *
+     * \param[in]  wr   A work request that describes the operation
+     * \param[out] wid  Identifier used to track this work request
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    atomic_fop(
+        nnti::datatype::nnti_work_request *wr,
+        NNTI_work_id_t                    *wid) override;
+
+    /**
+     * perform a 64-bit compare-and-swap operation
+     *
+     * \param[in]  wr   A work request that describes the operation
+     * \param[out] wid  Identifier used to track this work request
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    atomic_cswap(
+        nnti::datatype::nnti_work_request *wr,
+        NNTI_work_id_t                    *wid) override;
+
+    /**
+     * @brief Attempts to cancel an NNTI operation.
+     *
+     * \param[in]  wid   A work ID to cancel.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    cancel(
+        NNTI_work_id_t wid) override;
+
+
+    /**
+     * @brief Attempts to cancel a list of NNTI operations.
+     *
+     * \param[in]  wid_list   A list of work IDs to cancel.
+     * \param[in]  wid_count  The number of work IDs in wid_list.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    cancelall(
+        NNTI_work_id_t *wid_list,
+        const uint32_t  wid_count) override;
+
+
+    /**
+     * @brief Sends a signal to interrupt NNTI_wait*().
+     *
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    interrupt() override;
+
+
+    /**
+     * @brief Wait for a specific operation (wid) to complete.
+     *
+     * \param[in]  wid      The operation to wait for.
+     * \param[in]  timeout  The amount of time (in milliseconds) to wait.
+     * \param[out] status   The details of the completed (or timed out) operation.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    wait(
+        NNTI_work_id_t  wid,
+        const int64_t   timeout,
+        NNTI_status_t  *status) override;
+
+    /**
+     * @brief Wait for any operation (wid_list) in the list to complete.
+     *
+     * \param[in]  wid_list   The list of operations to wait for.
+     * \param[in]  wid_count  The number of operations in wid_list.
+     * \param[in]  timeout    The amount of time (in milliseconds) to wait.
+     * \param[out] which      The index of the operation that completed.
+     * \param[out] status     The details of the completed (or timed out) operation.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    waitany(
+        NNTI_work_id_t *wid_list,
+        const uint32_t  wid_count,
+        const int64_t   timeout,
+        uint32_t       *which,
+        NNTI_status_t  *status) override;
+
+    /**
+     * @brief Waits for all the operations (wid_list) in the list to complete.
+     *
+     * \param[in]  wid_list   The list of operations to wait for.
+     * \param[in]  wid_count  The number of operations in wid_list.
+     * \param[in]  timeout    The amount of time (in milliseconds) to wait.
+     * \param[out] status     The details of the completed (or timed out) operations (one per operation).
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    waitall(
+        NNTI_work_id_t *wid_list,
+        const uint32_t  wid_count,
+        const int64_t   timeout,
+        NNTI_status_t  *status) override;
+
+public:
+    static sockets_transport*
+    get_instance(
+        faodel::Configuration &config);
+
+private:
+    NNTI_result_t
+    setup_listener(void);
+    NNTI_result_t
+    setup_epoll(void);
+    void
+    teardown_sockets(void);
+
+    NNTI_result_t
+    setup_freelists(void);
+    NNTI_result_t
+    teardown_freelists(void);
+
+    void
+    progress(void);
+    void
+    start_progress_thread(void);
+    void
+    stop_progress_thread(void);
+    void
+    wakeup(void);
+
+    void
+    connect_cb(
+        const std::map<std::string,std::string> &args,
+        std::stringstream &results);
+    void
+    disconnect_cb(
+        const std::map<std::string,std::string> &args,
+        std::stringstream &results);
+    void
+    stats_cb(
+        const std::map<std::string,std::string> &args,
+        std::stringstream &results);
+    void
+    peers_cb(
+        const std::map<std::string,std::string> &args,
+        std::stringstream &results);
+    std::string
+    build_whookie_path(
+        const char *service);
+    void
+    register_whookie_cb(void);
+    void
+    unregister_whookie_cb(void);
+
+    nnti::core::sockets_channel *
+    open_channel(
+        nnti::core::sockets_connection *conn);
+    void
+    add_channel(
+        nnti::core::sockets_channel *c);
+    void
+    accept_channels(void);
+    void
+    close_channel(
+        nnti::core::sockets_channel *c);
+
+    bool
+    queue_msg(
+        nnti::core::sockets_channel *c,
+        nnti::core::sockets_msg     *msg);
+    bool
+    flush_channel(
+        nnti::core::sockets_channel *c);
+    void
+    arm_write(
+        nnti::core::sockets_channel *c,
+        bool                         on);
+
+    bool
+    read_channel(
+        nnti::core::sockets_channel *c);
+    void
+    begin_payload(
+        nnti::core::sockets_channel *c);
+    void
+    finish_message(
+        nnti::core::sockets_channel *c);
+    void
+    send_reply(
+        nnti::core::sockets_channel *c,
+        uint32_t                     type,
+        uint32_t                     op_id,
+        char                        *payload,
+        uint64_t                     payload_length,
+        int64_t                      operand1,
+        NNTI_result_t                result);
+
+    NNTI_result_t
+    start_op(
+        nnti::datatype::nnti_work_request *wr,
+        uint32_t                           type,
+        NNTI_work_id_t                    *wid);
+    void
+    complete_cmd_op(
+        nnti::core::sockets_cmd_op *cmd_op);
+    bool
+    drain_completed(void);
+
+    nnti::datatype::nnti_buffer *
+    target_buffer(
+        const nnti::core::sockets_msg_header &hdr);
+    nnti::datatype::nnti_peer *
+    initiator_peer(
+        const nnti::core::sockets_msg_header &hdr);
+
+    void
+    deliver_event(
+        nnti::datatype::nnti_buffer *b,
+        NNTI_event_t                *e);
+    NNTI_event_t *
+    create_event(
+        nnti::core::sockets_cmd_op *cmd_op);
+};
+
+} /* namespace transports */
+} /* namespace nnti */
+
+#endif /* SOCKETS_TRANSPORT_HPP_*/
@@ -67,7 +67,8 @@ ugni_transport::ugni_transport(
       cmd_op_freelist_size_(128),
       rdma_op_freelist_size_(128),
       atomic_op_freelist_size_(128),
-      cmd_tgt_freelist_size_(128)
+      cmd_tgt_freelist_size_(128),
+      freelist_magazine_size_(16)
 {
     faodel::rc_t rc = 0;
     uint64_t uint_value = 0;
@@ -84,11 +85,13 @@ ugni_transport::ugni_transport(
         rdma_op_freelist_size_   = uint_value;
         atomic_op_freelist_size_ = uint_value;
     }
-    event_freelist_     = new nnti::core::nnti_freelist<NNTI_event_t*>(event_freelist_size_);
-    cmd_op_freelist_    = new nnti::core::nnti_freelist<nnti::core::ugni_cmd_op*>(cmd_op_freelist_size_);
-    cmd_tgt_freelist_   = new nnti::core::nnti_freelist<nnti::core::ugni_cmd_tgt*>(cmd_tgt_freelist_size_);
-    rdma_op_freelist_   = new nnti::core::nnti_freelist<nnti::core::ugni_rdma_op*>(rdma_op_freelist_size_);
-    atomic_op_freelist_ = new nnti::core::nnti_freelist<nnti::core::ugni_atomic_op*>(atomic_op_freelist_size_);
+    // per-thread cache in front of each freelist.  0 turns the cache off.
+    config.GetUInt(&freelist_magazine_size_, "nnti.freelist.magazine_size", "16");
+    event_freelist_     = new nnti::core::nnti_freelist<NNTI_event_t*>(event_freelist_size_, freelist_magazine_size_);
+    cmd_op_freelist_    = new nnti::core::nnti_freelist<nnti::core::ugni_cmd_op*>(cmd_op_freelist_size_, freelist_magazine_size_);
+    cmd_tgt_freelist_   = new nnti::core::nnti_freelist<nnti::core::ugni_cmd_tgt*>(cmd_tgt_freelist_size_, freelist_magazine_size_);
+    rdma_op_freelist_   = new nnti::core::nnti_freelist<nnti::core::ugni_rdma_op*>(rdma_op_freelist_size_, freelist_magazine_size_);
+    atomic_op_freelist_ = new nnti::core::nnti_freelist<nnti::core::ugni_atomic_op*>(atomic_op_freelist_size_, freelist_magazine_size_);
 
     return;
 }
@@ -747,6 +750,27 @@ cleanup:
     return nnti_rc;
 }
 
+/**
+ * @brief Wait for one or more events to arrive on an event queue.
+ *
+ * \param[in]  eq       The event queue to wait on.
+ * \param[out] events   An array of at least max events.
+ * \param[in]  max      The most events to return.
+ * \param[in]  timeout  The amount of time (in milliseconds) to wait.
+ * \param[out] count    The number of events returned.
+ * \return A result code (NNTI_OK or an error)
+ */
+NNTI_result_t
+ugni_transport::eq_wait_many(
+    NNTI_event_queue_t  eq_hdl,
+    NNTI_event_t       *events,
+    const uint32_t      max,
+    const int           timeout,
+    uint32_t           *count)
+{
+    return wait_for_events(event_freelist_, eq_hdl, events, max, timeout, count);
+}
+
 /**
  * @brief Retrieves the next message from the unexpected list.
  *
@@ -1665,6 +1689,13 @@ ugni_transport::setup_freelists(void)
 NNTI_result_t
 ugni_transport::teardown_freelists(void)
 {
+    // the progress thread has exited.  collect whatever the app threads still cache.
+    event_freelist_->reclaim();
+    cmd_op_freelist_->reclaim();
+    rdma_op_freelist_->reclaim();
+    atomic_op_freelist_->reclaim();
+    cmd_tgt_freelist_->reclaim();
+
     while(!event_freelist_->empty()) {
         NNTI_event_t *e = nullptr;
         if (event_freelist_->pop(e)) {
@@ -207,6 +207,7 @@ private:
     nnti::core::nnti_freelist<nnti::core::ugni_atomic_op*> *atomic_op_freelist_;
     uint64_t                                                cmd_tgt_freelist_size_;
     nnti::core::nnti_freelist<nnti::core::ugni_cmd_tgt*>   *cmd_tgt_freelist_;
+    uint64_t                                                freelist_magazine_size_;
 
 private:
     /**
@@ -346,6 +347,24 @@ public:
         uint32_t           *which,
         NNTI_event_t       *event) override;
 
+    /**
+     * @brief Wait for one or more events to arrive on an event queue.
+     *
+     * \param[in]  eq       The event queue to wait on.
+     * \param[out] events   An array of at least max events.
+     * \param[in]  max      The most events to return.
+     * \param[in]  timeout  The amount of time (in milliseconds) to wait.
+     * \param[out] count    The number of events returned.
+     * \return A result code (NNTI_OK or an error)
+     */
+    NNTI_result_t
+    eq_wait_many(
+        NNTI_event_queue_t  eq,
+        NNTI_event_t       *events,
+        const uint32_t      max,
+        const int           timeout,
+        uint32_t           *count) override;
+
     /**
      * @brief Retrieves the next message from the unexpected list.
      *
@@ -4,6 +4,7 @@
 
 #include <iostream>
 
+#include "faodel-common/StringHelpers.hh"
 #include "opbox/net/net.hh"
 #include "opbox/common/Message.hh"
 #include "opbox/common/OpArgs.hh"
@@ -12,6 +13,8 @@ using namespace std;
 
 namespace opbox {
 
+const lunasa::dataobject_type_t message_t::object_type_id = faodel::const_hash16("OpBoxMessage");
+
 /**
  * @brief Pull the body section of the message out and return it as a string
  *
@@ -72,6 +75,7 @@ void message_t::SetStandardRequest(faodel::nodeid_t dst_node, mailbox_t src_mail
   this->op_id = op_id;
   this->user_flags = user_flags;
   this->body_len = body_len;
+  this->trace_id = 0;
 }
 
 /**
@@ -90,6 +94,7 @@ void message_t::SetStandardReply(const message_t *hdr, uint16_t user_flags,
   this->op_id = hdr->op_id;
   this->user_flags = user_flags;
   this->body_len = body_len;
+  this->trace_id = hdr->trace_id;
 }
 
 /**
@@ -110,7 +115,8 @@ void message_t::sstr(std::stringstream &ss, int depth, int indent) const {
        << " dmb "   <<this->dst_mailbox
        << " opid "  <<this->op_id
        << " uflg "  <<this->user_flags
-       << " blen "  <<this->body_len<<endl;
+       << " blen "  <<this->body_len
+       << " trc "   <<this->trace_id<<endl;
 
   } else {
     ss << string(indent,' ')  <<"[msg] "<<endl
@@ -120,7 +126,8 @@ void message_t::sstr(std::stringstream &ss, int depth, int indent) const {
        << string(indent+1,' ')<<"dst_mbox:   "<<this->dst_mailbox<<endl
        << string(indent+1,' ')<<"op_id:      "<<this->op_id<<endl
        << string(indent+1,' ')<<"user_flags: "<<this->user_flags<<endl
-       << string(indent+1,' ')<<"body_len:   "<<this->body_len<<endl;
+       << string(indent+1,' ')<<"body_len:   "<<this->body_len<<endl
+       << string(indent+1,' ')<<"trace_id:   "<<this->trace_id<<endl;
   }
 }
 
@@ -34,7 +34,10 @@ namespace net {
  * This struct provides a basic header structure for messages transmitted in
  * opbox. It provides basic sender/receiver info as well as an ID for
  * specifying which type of registered operation this is. Users can put
- * 16 bits of flag info a user_flags variable.
+ * 16 bits of flag info a user_flags variable. net::NewMessage zeroes
+ * trace_id and tags the LDO with object_type_id. When op tracing is
+ * enabled, opbox fills in trace_id as a tagged message is sent. LDOs that
+ * were not made by net::NewMessage are sent untouched.
  *
  * If you need to send additional info in this message, you can use the
  * body section of this message. The idea is that you create a struct of
@@ -57,6 +60,7 @@ struct message_t {
   uint16_t          user_flags;   //!< Small place for user to put simple flags
   uint16_t          user_flags2;  //!< Reserved for future use
   uint32_t          body_len;     //!< Length of this message's body (should be less than MTU - sizeof(message_t))
+  uint32_t          trace_id;     //!< Id for correlating an op's spans across nodes (0 when not traced). Occupies former padding
 
   //Body follows next. We use the non-compliant zero-length array here to make pointers easier
   char              body[0];      //!< Starting point for any other op-specific data in this message
@@ -64,6 +68,8 @@ struct message_t {
   std::string GetBodyAsString() const;
 
   //Tests to see if this message is what we expected
+  const static lunasa::dataobject_type_t object_type_id; //!< LDO type id net::NewMessage gives messages
+
   bool IsExpected(uint32_t expected_op_id);
   bool IsExpected(uint32_t expected_op_id, uint16_t expected_flags);
   bool IsExpected(uint32_t expected_op_id, uint16_t flag_mask, uint16_t expected_flags);
@@ -63,6 +63,7 @@ bool AllocateStringMessage(lunasa::DataObject &new_ldo,
   msg->dst_mailbox = dst_mailbox;
   msg->op_id = op_id;
   msg->user_flags = user_flags;
+  msg->trace_id = 0;
   msg->body_len =  static_cast<uint32_t>(user_string.size());
 
   //Append the packed data to the end of the message
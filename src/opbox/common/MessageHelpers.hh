@@ -81,6 +81,7 @@ bool AllocateCerealMessage(lunasa::DataObject &new_ldo,
   msg->dst_mailbox = dst_mailbox;
   msg->op_id = op_id;
   msg->user_flags = user_flags;
+  msg->trace_id = 0;
   msg->body_len =  static_cast<uint32_t>(packed_object.size());
 
   //Append the packed data to the end of the message
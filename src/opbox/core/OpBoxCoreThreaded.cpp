@@ -86,6 +86,11 @@ void OpBoxCoreThreaded::init(const faodel::Configuration &config) {
     if(enable_timers) op_timer = new OpTimer();
   #endif
 
+  //Tracing is a runtime option because it is useful in production builds
+  bool enable_tracing;
+  config.GetBool(&enable_tracing, "opbox.trace.enable", "false");
+  if(enable_tracing) op_tracer = new OpTracer(config);
+
 
   opbox::net::RegisterRecvCallback(opbox::internal::HandleIncomingMessage);
 
@@ -111,6 +116,7 @@ void OpBoxCoreThreaded::start() {
   dbg("private Start");
   F_ASSERT(initialized, "Attempted to start OpBoxCoreThreaded before initialization");
   opbox::net::Start();
+  if(op_tracer) op_tracer->Start();
   running=true;
 }
 
@@ -144,6 +150,11 @@ void OpBoxCoreThreaded::finish() {
     op_timer->Dump();
     delete op_timer;
   }
+  if(op_tracer) {
+    op_tracer->Dump();
+    delete op_tracer;
+    op_tracer = nullptr;
+  }
 
   running=false;
 }
@@ -161,7 +172,7 @@ void OpBoxCoreThreaded::finish() {
  */
 int OpBoxCoreThreaded::doAction(faodel::internal_use_only_t iuo, mailbox_t mailbox, Op *op, OpArgs *args){
 
-  dbg("doAction enter mailbox "+to_string(mailbox));
+  F_LOG_DBG("doAction enter mailbox "+to_string(mailbox));
   // SanityCheckArgs(args);
 
   //Verify this op is still active
@@ -171,9 +182,22 @@ int OpBoxCoreThreaded::doAction(faodel::internal_use_only_t iuo, mailbox_t mailb
     return args->result;
   }
 
+  string traced_state;
+  uint64_t traced_start_us = 0;
+  if(op_tracer) {
+    traced_state = op->GetStateName();
+    traced_start_us = OpTracer::GetTimeUS();
+    OpTracer::current_trace_id = op->GetTraceID(); //Stamped on any messages the op sends
+  }
+
   WaitingType rc = op->Update(args);
   op->touch();
 
+  if(op_tracer) {
+    op_tracer->RecordSpan(op, mailbox, traced_state, traced_start_us, OpTracer::GetTimeUS());
+    OpTracer::current_trace_id = 0;
+  }
+
   OP_TIMER(op,OpTimerEvent::ActionComplete);
 
   switch(rc){
@@ -215,11 +239,11 @@ int OpBoxCoreThreaded::HandleIncomingMessage(opbox::net::peer_ptr_t peer, messag
   //OpArgs *args = new OpArgs(peer, incoming_message, true);
   mailbox_t my_mailbox = incoming_message->dst_mailbox;
 
-  dbg("Incoming message for mailbox "+to_string(my_mailbox));
+  F_LOG_DBG("Incoming message for mailbox "+to_string(my_mailbox));
 
   //See if this is an unexpected message
   if(my_mailbox == 0){
-    dbg("Creating new TargetOp. OpID is "+std::to_string(incoming_message->op_id));
+    F_LOG_DBG("Creating new TargetOp. OpID is "+std::to_string(incoming_message->op_id));
 
 
     //New communication. Spin up a new op to andle it.
@@ -228,6 +252,7 @@ int OpBoxCoreThreaded::HandleIncomingMessage(opbox::net::peer_ptr_t peer, messag
     if(op==nullptr) {
       F_HALT("Incoming message asked for an opid that was not known");
     }
+    if(op_tracer) op->SetTraceID(incoming_message->trace_id);
 
     addActiveOp(op); //Sets the mailbox if needed
     my_mailbox = op->GetAssignedMailbox();
@@ -316,7 +341,13 @@ int OpBoxCoreThreaded::LaunchOp(Op *op, mailbox_t *resulting_mailbox){
   F_ASSERT(initialized && running, "Attempted to StartOp when OpBoxCoreThreaded that is not running");
   F_ASSERT(op != nullptr, "Tried starting a null op");
 
-  dbg("LaunchOp "+op->getOpName() +" state "+op->GetStateName());
+  F_LOG_DBG("LaunchOp "+op->getOpName() +" state "+op->GetStateName());
+
+  //Ops launched while another op is updating join that op's trace
+  if(op_tracer && (op->GetTraceID()==0)) {
+    op->SetTraceID((OpTracer::current_trace_id) ? OpTracer::current_trace_id
+                                                : op_tracer->NewTraceID());
+  }
 
   addActiveOp(op);
 
@@ -351,7 +382,7 @@ int OpBoxCoreThreaded::LaunchOp(Op *op, mailbox_t *resulting_mailbox){
  * @retval -1 Failure
  */
 int OpBoxCoreThreaded::TriggerOp(mailbox_t mailbox, std::shared_ptr<OpArgs> args) {
-  dbg("TriggerOp enter mailbox "+to_string(mailbox));
+  F_LOG_DBG("TriggerOp enter mailbox "+to_string(mailbox));
   SanityCheckArgs(args);
 
   args->result = 0;
@@ -425,13 +456,13 @@ void OpBoxCoreThreaded::addActiveOp(Op *op){
  */
 void OpBoxCoreThreaded::endActiveOp(mailbox_t mailbox){
   F_ASSERT(mailbox != 0, "Op had a zero-value mailbox");
-  dbg("EndActiveOp for mailbox "+to_string(mailbox));
+  F_LOG_DBG("EndActiveOp for mailbox "+to_string(mailbox));
   Op *op;
   op_mutex->WriterLock();
   auto it = active_ops.find(mailbox);
   if(it!=active_ops.end()){
     op = it->second;
-    dbg("  EndActiveOp op is "+op->getOpName()+" state is "+ op->GetStateName());
+    F_LOG_DBG("  EndActiveOp op is "+op->getOpName()+" state is "+ op->GetStateName());
     active_ops.erase(mailbox);
     delete op;
   }
@@ -472,6 +503,7 @@ void OpBoxCoreThreaded::HandleWhookieStatus(
     rs.tableRow({"Core Type", GetType()});
     rs.tableRow({"State", ((shutdown_requested) ? "Shutdown Requested" : ((running) ? "Running" : ((initialized) ? "Initialized" : "Uninitialized")))});
     rs.tableRow({"Active Ops", to_string(active_ops.size())});
+    rs.tableRow({"Op Tracing", ((op_tracer) ? "Enabled ("+op_tracer->GetFilename()+")" : "Disabled")});
     rs.tableEnd();
 
     rs.mkText(html::mkLink("Current Active Ops", "/opbox/ops"));
@@ -14,6 +14,7 @@
 #include "opbox/ops/Op.hh"
 #include "opbox/core/OpBoxCoreBase.hh"
 #include "opbox/core/OpTimer.hh"
+#include "opbox/core/OpTracer.hh"
 
 namespace opbox {
 namespace internal {
@@ -71,6 +72,7 @@ private:
   std::map<int, opbox::Op *> active_ops;
 
   OpTimer *op_timer = nullptr; //Debug: collect info about how long each op took
+  OpTracer *op_tracer = nullptr; //Optional: per-state spans correlated across nodes
 
 };
 
@@ -0,0 +1,192 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "faodel-common/Debug.hh"
+
+#include "opbox/OpBox.hh"
+#include "opbox/core/OpTracer.hh"
+#include "opbox/ops/Op.hh"
+
+using namespace std;
+
+namespace opbox {
+namespace internal {
+
+thread_local uint32_t OpTracer::current_trace_id = 0;
+
+namespace {
+//Each tracer instance gets a new generation so stale thread-local ring
+//pointers from a previous Init/Finish cycle are never reused
+std::atomic<uint64_t> tracer_generations(1);
+
+struct thread_ring_ref_t {
+  uint64_t generation;
+  void    *ring;
+};
+thread_local thread_ring_ref_t my_ring = { 0, nullptr };
+
+//Chrome trace strings only need quotes and backslashes escaped for our names
+string jsonEscape(const string &s) {
+  string out;
+  for(auto c : s) {
+    if((c=='"') || (c=='\\')) out.push_back('\\');
+    out.push_back(c);
+  }
+  return out;
+}
+} // namespace
+
+
+/**
+ * @brief Create a tracer using the opbox.trace settings in the configuration
+ *
+ * @param[in] config The configuration for this node
+ */
+OpTracer::OpTracer(const faodel::Configuration &config)
+  : generation(tracer_generations++), trace_seed(0), next_trace(1) {
+
+  uint64_t num_entries;
+  config.GetUInt(&num_entries, "opbox.trace.buffer_entries", "16384");
+  config.GetString(&prefix, "opbox.trace.file_prefix", "./opbox_trace");
+  ring_entries = (num_entries) ? num_entries : 1;
+
+  mutex = faodel::GenerateMutex();
+}
+
+OpTracer::~OpTracer() {
+  for(auto r : rings)
+    delete r;
+  delete mutex;
+}
+
+/**
+ * @brief Pick up this node's id once the network is running
+ * @note The node id seeds trace ids and names the output file
+ */
+void OpTracer::Start() {
+  my_id = opbox::net::GetMyID();
+  filename = prefix + "." + my_id.GetHex() + ".json";
+
+  //Top 12 bits come from a multiplicative hash of the node id so ids from
+  //different nodes rarely collide
+  uint64_t h = my_id.nid * 0x9E3779B97F4A7C15ull;
+  trace_seed = static_cast<uint32_t>(h >> 32) & 0xFFF00000;
+}
+
+/**
+ * @brief Generate a new trace id for an op launched on this node
+ * @retval id A nonzero trace id
+ */
+uint32_t OpTracer::NewTraceID() {
+  uint32_t id;
+  do {
+    id = trace_seed | (next_trace.fetch_add(1) & 0x000FFFFF);
+  } while(id == 0);
+  return id;
+}
+
+uint64_t OpTracer::GetTimeUS() {
+  //Use the system clock so spans from different nodes line up (to NTP precision)
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Locate (or create) the ring buffer that belongs to the calling thread
+ * @retval ring The calling thread's ring
+ */
+OpTracer::ring_t * OpTracer::getThreadRing() {
+  if((my_ring.generation == generation) && (my_ring.ring != nullptr))
+    return reinterpret_cast<ring_t *>(my_ring.ring);
+
+  mutex->Lock();
+  auto ring = new ring_t(ring_entries, static_cast<int>(rings.size()));
+  rings.push_back(ring);
+  mutex->Unlock();
+
+  my_ring.generation = generation;
+  my_ring.ring = ring;
+  return ring;
+}
+
+/**
+ * @brief Record the time an op spent processing one update in a particular state
+ *
+ * @param[in] op The op that was updated
+ * @param[in] mailbox The op's mailbox (MAILBOX_UNSPECIFIED if it never needed one)
+ * @param[in] state_name The state the op was in when the update began
+ * @param[in] start_us When the update began (from GetTimeUS)
+ * @param[in] end_us When the update completed (from GetTimeUS)
+ */
+void OpTracer::RecordSpan(Op *op, mailbox_t mailbox, const string &state_name, uint64_t start_us, uint64_t end_us) {
+
+  auto ring = getThreadRing();
+  uint64_t h = ring->head.load(std::memory_order_relaxed);
+  span_t &span = ring->spans[h % ring_entries];
+  span.start_us  = start_us;
+  span.end_us    = end_us;
+  span.trace_id  = op->GetTraceID();
+  span.op_id     = op->getOpID();
+  span.mailbox   = mailbox;
+  span.is_origin = op->isOrigin();
+  strncpy(span.state_name, state_name.c_str(), MAX_STATE_NAME_LEN-1);
+  span.state_name[MAX_STATE_NAME_LEN-1] = '\0';
+  ring->head.store(h+1, std::memory_order_release);
+}
+
+/**
+ * @brief Write all recorded spans to this node's Chrome-trace JSON file
+ *
+ * @note Spans are emitted as complete ("X") events. The process id is the
+ *       node id and each recording thread gets its own track. The trace id
+ *       is stored in the args so spans can be matched across node files.
+ */
+void OpTracer::Dump() {
+
+  ofstream f(filename);
+  if(!f.is_open()) {
+    cerr << "OpTracer: could not open trace file " << filename << endl;
+    return;
+  }
+
+  uint64_t pid = my_id.nid;
+  f << "{\"traceEvents\":[\n"
+    << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+    << ",\"args\":{\"name\":\"opbox " << my_id.GetHex() << "\"}}";
+
+  uint64_t num_dropped = 0;
+  mutex->Lock();
+  for(auto ring : rings) {
+    uint64_t h = ring->head.load(std::memory_order_acquire);
+    uint64_t first = (h > ring_entries) ? h - ring_entries : 0;
+    num_dropped += first;
+    for(uint64_t i = first; i < h; i++) {
+      const span_t &span = ring->spans[i % ring_entries];
+      string op_name = opbox::GetOpName(span.op_id);
+      if(op_name.empty()) op_name = "Unknown";
+      f << ",\n{\"name\":\"" << jsonEscape(span.state_name) << "\""
+        << ",\"cat\":\"" << jsonEscape(op_name) << "\""
+        << ",\"ph\":\"X\""
+        << ",\"ts\":" << span.start_us
+        << ",\"dur\":" << (span.end_us - span.start_us)
+        << ",\"pid\":" << pid
+        << ",\"tid\":" << ring->thread_index
+        << ",\"args\":{\"trace_id\":\"0x" << std::hex << span.trace_id << std::dec << "\""
+        << ",\"mailbox\":" << span.mailbox
+        << ",\"role\":\"" << ((span.is_origin) ? "origin" : "target") << "\"}}";
+    }
+  }
+  mutex->Unlock();
+
+  f << "\n],\"otherData\":{\"node\":\"" << my_id.GetHex() << "\""
+    << ",\"overwritten_spans\":" << num_dropped << "}}\n";
+}
+
+} //namespace internal
+} //namespace opbox
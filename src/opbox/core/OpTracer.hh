@@ -0,0 +1,102 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#ifndef OPBOX_OPBOX_OPTRACER_HH
+#define OPBOX_OPBOX_OPTRACER_HH
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "faodel-common/Configuration.hh"
+#include "faodel-common/MutexWrapper.hh"
+
+#include "opbox/common/Message.hh"
+
+namespace opbox {
+
+class Op;
+
+namespace internal {
+
+/**
+ * @brief Opt-in tracer that records per-state spans for ops on origin and target
+ *
+ * When enabled (opbox.trace.enable), every op launched on this node is given a
+ * trace id. The id travels in the message_t header of every message the op
+ * sends, and target ops adopt the id of the message that created them. This
+ * allows the spans of a multi-leg exchange (eg, a kelpie GetUnbounded) to be
+ * correlated across nodes.
+ *
+ * Each thread that updates ops writes its spans into its own fixed-size ring
+ * buffer, so recording a span never takes a lock. When a ring fills, the
+ * oldest spans are overwritten. The rings are written to a Chrome-trace
+ * (Perfetto-compatible) JSON file when the core finishes.
+ */
+class OpTracer {
+
+public:
+  explicit OpTracer(const faodel::Configuration &config);
+  ~OpTracer();
+
+  void Start();
+  uint32_t NewTraceID();
+  void RecordSpan(Op *op, mailbox_t mailbox, const std::string &state_name, uint64_t start_us, uint64_t end_us);
+  void Dump();
+
+  std::string GetFilename() const { return filename; }
+
+  static uint64_t GetTimeUS();
+
+  //Trace id of the op this thread is currently updating (0 when none)
+  static thread_local uint32_t current_trace_id;
+
+  /**
+   * @brief Place the current thread's trace id in an outgoing message
+   * @param[in] msg The message about to be sent (untouched when no op is being traced)
+   * @note Only LDOs made by net::NewMessage hold a message_t. Anything else is user data and is never stamped
+   */
+  static void StampOutgoingMessage(lunasa::DataObject &msg) {
+    if(current_trace_id && (msg.GetTypeID() == message_t::object_type_id) && (msg.GetDataSize() >= sizeof(message_t)))
+      msg.GetDataPtr<message_t *>()->trace_id = current_trace_id;
+  }
+
+private:
+  static const int MAX_STATE_NAME_LEN = 48;
+
+  struct span_t {
+    uint64_t  start_us;
+    uint64_t  end_us;
+    uint32_t  trace_id;
+    uint32_t  op_id;
+    mailbox_t mailbox;
+    bool      is_origin;
+    char      state_name[MAX_STATE_NAME_LEN];
+  };
+
+  struct ring_t {
+    explicit ring_t(size_t num_entries, int id) : spans(num_entries), head(0), thread_index(id) {}
+    std::vector<span_t>   spans;
+    std::atomic<uint64_t> head;          //Only written by the owning thread
+    int                   thread_index;
+  };
+
+  ring_t * getThreadRing();
+
+  uint64_t generation;                   //Distinguishes this tracer from previous instances
+  size_t ring_entries;
+  std::string prefix;
+  std::string filename;
+  faodel::nodeid_t my_id;
+  uint32_t trace_seed;
+  std::atomic<uint32_t> next_trace;
+
+  faodel::MutexWrapper *mutex;           //Only guards the list of rings (registration/dump)
+  std::vector<ring_t *> rings;
+};
+
+} //namespace internal
+} //namespace opbox
+
+#endif //OPBOX_OPBOX_OPTRACER_HH
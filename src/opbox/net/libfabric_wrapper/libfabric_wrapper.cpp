@@ -67,6 +67,7 @@
 #include "lunasa/DataObject.hh"
 
 #include "opbox/common/Types.hh"
+#include "opbox/core/OpTracer.hh"
 
 
 
@@ -375,6 +376,22 @@ Connect(
     return 0;
 }
 
+int
+Connect(
+    std::vector<peer_ptr_t>              *peers,
+    const std::vector<faodel::nodeid_t>  &peer_nodeids)
+{
+    int result = 0;
+    peers->assign(peer_nodeids.size(), nullptr);
+    for (size_t i=0; i<peer_nodeids.size(); i++) {
+        int rc = Connect(&(*peers)[i], peer_nodeids[i]);
+        if ((rc != 0) && (result == 0)) {
+            result = rc;
+        }
+    }
+    return result;
+}
+
 int
 Disconnect(
     peer_ptr_t peer)
@@ -406,6 +423,12 @@ NewMessage(
     //FAB_RECV_SIZE 4096 for each cmd message receive
     uint32_t meta_size = 0;
     DataObject ldo(meta_size, size,  DataObject::AllocatorType::eager);
+    // receivers adopt trace_id, so hand-built messages must not carry garbage.
+    // the type id tells the tracer this LDO holds a message_t it may stamp.
+    if (size >= sizeof(opbox::message_t)) {
+        ldo.GetDataPtr<opbox::message_t *>()->trace_id = 0;
+        ldo.SetTypeID(opbox::message_t::object_type_id);
+    }
     return std::move(ldo);
 }
 
@@ -494,6 +517,8 @@ SendMsg(
     fabBufferLocal  *msg_bl = NULL;
     uint32_t         msg_bl_offset = 0;
 
+    opbox::internal::OpTracer::StampOutgoingMessage(msg);
+
 //    fprintf(stdout, "SendMsg(): peer=%p  peer->p=%p  peer->p->nodeid=%s\n", peer, peer->p, peer->p->remote_nodeid.GetHex().c_str());
 
     //int rc = msg.getRdmaPtr( (void **)&msg_bl, msg_bl_offset);
@@ -514,6 +539,8 @@ SendMsg(
     fabBufferLocal *msg_bl        = NULL;
     uint32_t         msg_bl_offset = 0;
 
+    opbox::internal::OpTracer::StampOutgoingMessage(msg);
+
 //    fprintf(stdout, "SendMsg(): peer=%p  peer->p=%p  peer->p->nodeid=%s\n", remote_peer, remote_peer->p, remote_peer->p->remote_nodeid.GetHex().c_str());
 
     //int rc = msg.getRdmaPtr( (void **)&msg_bl, msg_bl_offset);
@@ -11,11 +11,13 @@
 #include "nnti/nntiConfig.h"
 
 #if NNTI_BUILD_MPI
-#define MAX_NET_BUFFER_REMOTE_SIZE 68 /* 4 + 4 + 60 */
+#define MAX_NET_BUFFER_REMOTE_SIZE 76 /* 4 + 4 + 68 */
 #elif NNTI_BUILD_UGNI
 #define MAX_NET_BUFFER_REMOTE_SIZE 48 /* 4 + 4 + 40 */
 #elif NNTI_BUILD_IBVERBS
-#define MAX_NET_BUFFER_REMOTE_SIZE 36 /* 4 + 4 + 28 */
+#define MAX_NET_BUFFER_REMOTE_SIZE 36 /* 4 + 4 + 28 (also holds a 24 byte sockets handle) */
+#elif NNTI_BUILD_SOCKETS
+#define MAX_NET_BUFFER_REMOTE_SIZE 32 /* 4 + 4 + 24 */
 #else
 #error NNTI did not have a valid transport. OpBox cannot be built.
 #endif
@@ -16,6 +16,7 @@
 #include <functional>
 #include <string>
 #include <sstream>
+#include <vector>
 
 
 
@@ -182,6 +183,16 @@ int Connect(
 int Connect(
     peer_ptr_t        *peer,
     faodel::nodeid_t  peer_nodeid);
+/**
+ * @brief Prepare for communication with many peers, running the handshakes concurrently.
+ *
+ * \param[out] peers         Handles to the peers, in the same order as peer_nodeids.
+ * \param[in]  peer_nodeids  The node IDs of the peers.
+ * \return A result code (the first failure if any handshake failed)
+ */
+int Connect(
+    std::vector<peer_ptr_t>              *peers,
+    const std::vector<faodel::nodeid_t>  &peer_nodeids);
 
 int Disconnect(
     peer_ptr_t peer);
@@ -3,8 +3,14 @@
 // Government retains certain rights in this software.
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <future>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <thread>
 
@@ -33,6 +39,7 @@
 
 #include "opbox/common/Types.hh"
 #include "opbox/OpBox.hh"
+#include "opbox/core/OpTracer.hh"
 
 
 using namespace std;
@@ -47,6 +54,14 @@ namespace net {
 typedef struct peer_t {
   NNTI_peer_t p;
 
+  //Only used by peers made with Connect(). These outlive their connection,
+  //so an op on a peer whose idle connection was closed reconnects it.
+  bool                                   pooled = false;
+  bool                                   connected = false;
+  faodel::nodeid_t                       nodeid;
+  std::chrono::steady_clock::time_point  last_used;
+  std::shared_ptr<std::atomic<uint32_t>> in_flight;  //Ops not yet completed. Shared with their callbacks.
+
   peer_t() {} //Empty when given nothing
   peer_t(const NNTI_peer_t &p_) : p(p_) {}
   peer_t(const peer_t &p_) : p(p_.p) {}
@@ -67,17 +82,58 @@ namespace NetNnti
     typedef nodeid_peer_bimap::value_type                    nodeid_peer_value;
     nodeid_peer_bimap peer_bimap;
 
+    /*
+     * Connect() may be called from many threads at once.  Handshakes run
+     * without holding peer_mutex_, so different peers connect in
+     * parallel, while a second Connect() to a peer that is already
+     * connecting waits on that handshake instead of starting another.
+     *
+     * When net.peer_pool.max_connected is not zero, making a new
+     * connection first closes the least recently used connections that
+     * have been idle for at least net.peer_pool.min_idle_ms.  Their
+     * peer_t stays in peer_bimap and is reconnected by its next op.
+     */
+    std::mutex                                              peer_mutex_;
+    std::map<faodel::nodeid_t, std::shared_future<void>>    connecting_;
+    uint64_t                                                max_connected_;
+    uint64_t                                                min_idle_ms_;
+    uint64_t                                                max_concurrent_connects_;
+
     NNTI_attrs_t nnti_attrs_;
 
     faodel::nodeid_t myid_;
 
     bool use_zero_copy_;
 
+    /*
+     * In a bounded pool, each op holds its peer's in_flight count up
+     * from usePeer() until the op's callback runs, so the connection is
+     * not closed under it.  The callback holds its own reference to the
+     * count because the peer_t may be disconnected before the op is done.
+     */
+    typedef std::shared_ptr<std::atomic<uint32_t>> busy_count_t;
+
+    void releasePeer(const busy_count_t &busy)
+    {
+        if (busy) {
+            (*busy)--;
+        }
+    }
+
+    // Tell user_cb about an op that failed before it reached the transport
+    void failOp(const lambda_net_update_t &user_cb, UpdateType type)
+    {
+        if (user_cb) {
+            user_cb(new OpArgs(type));
+        }
+    }
+
     class user_invoking_callback
     {
     private:
         std::function< WaitingType(OpArgs *args) > user_cb_;
         void *context_;
+        busy_count_t busy_;
 
         UpdateType event_to_update_type(NNTI_event_t *event) {
             switch(event->type) {
@@ -103,10 +159,11 @@ namespace NetNnti
         {
             return;
         }
-        user_invoking_callback(lambda_net_update_t user_cb, void *context)
+        user_invoking_callback(lambda_net_update_t user_cb, void *context, busy_count_t busy = nullptr)
         {
             user_cb_ = user_cb;
             context_ = context;
+            busy_    = busy;
             return;
         }
 
@@ -132,6 +189,8 @@ namespace NetNnti
             user_cb_(args);
             //CDU: end
 
+            releasePeer(busy_);
+
 
             // if the LDO was used to send a message, then we own it so release it.
             // an LDO used for RDMAs or atomics is  owned by the app, so it should release it.
@@ -147,12 +206,17 @@ namespace NetNnti
 
     class default_callback
     {
+    private:
+        busy_count_t busy_;
     public:
+        default_callback(busy_count_t busy = nullptr) : busy_(busy) {}
+
         NNTI_result_t operator() (NNTI_event_t *event, void *context)
         {
             DataObject *ldo = (DataObject*)context;
 //            opbox::net::ReleaseMessage(ldo);
             delete ldo;
+            releasePeer(busy_);
             return NNTI_OK;
         }
     };
@@ -160,6 +224,10 @@ namespace NetNnti
     bool initialized_;
     bool started_;
 
+    // set when an unexpected message arrived before Start() finished.  its
+    // event is waiting on unexpected_eq_.
+    std::atomic<bool> deferred_unexpected_(false);
+
     faodel::Configuration config_;
 
     nnti::transports::transport *t_;
@@ -212,6 +280,157 @@ namespace NetNnti
         }
     }
 
+    // caller holds peer_mutex_
+    peer_t *findPeer(const faodel::nodeid_t &nodeid)
+    {
+        auto it = peer_bimap.left.find(nodeid);
+        return (it == peer_bimap.left.end()) ? nullptr : it->second;
+    }
+
+    /*
+     * Choose the connections to close so that one more fits under
+     * max_connected_.  Connections that were used recently or have ops
+     * in flight are never chosen, so the pool
+     * may go over its limit when every connection is in use.  The caller
+     * holds peer_mutex_ and disconnects the returned peers after
+     * releasing it.
+     */
+    std::vector<NNTI_peer_t> evictIdlePeers()
+    {
+        std::vector<NNTI_peer_t> victims;
+        if (max_connected_ == 0) {
+            return victims;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        uint64_t connected = connecting_.size();
+        std::vector<peer_t*> idle;
+        for (auto it = peer_bimap.left.begin() ; it != peer_bimap.left.end() ; ++it) {
+            peer_t *peer = it->second;
+            if (!peer->connected) {
+                continue;
+            }
+            connected++;
+            if ((*peer->in_flight == 0) &&
+                (now - peer->last_used >= std::chrono::milliseconds(min_idle_ms_))) {
+                idle.push_back(peer);
+            }
+        }
+        if (connected <= max_connected_) {
+            return victims;
+        }
+
+        std::sort(idle.begin(), idle.end(), [](const peer_t *a, const peer_t *b) { return a->last_used < b->last_used; });
+        for (auto peer : idle) {
+            if (connected <= max_connected_) {
+                break;
+            }
+            log_debug("NetNnti", "Closing idle connection to %s", peer->nodeid.GetHex().c_str());
+            victims.push_back(peer->p);
+            peer->p         = 0;
+            peer->connected = false;
+            connected--;
+        }
+        if (connected > max_connected_) {
+            log_debug("NetNnti", "%lu connections are open, but none are idle enough to close", connected);
+        }
+        return victims;
+    }
+
+    /*
+     * Make sure nodeid has an open connection and return its peer.  The
+     * caller holds peer_mutex_ in lock, which is released during the
+     * handshake.
+     */
+    int connectPeer(std::unique_lock<std::mutex> &lock, faodel::nodeid_t nodeid, peer_t **peer)
+    {
+        peer_t *p = findPeer(nodeid);
+
+        // wait for a handshake that another thread already started
+        auto it = connecting_.find(nodeid);
+        while (it != connecting_.end()) {
+            std::shared_future<void> done = it->second;
+            lock.unlock();
+            done.wait();
+            lock.lock();
+            p  = findPeer(nodeid);
+            it = connecting_.find(nodeid);
+        }
+        if ((p != nullptr) && p->connected) {
+            p->last_used = std::chrono::steady_clock::now();
+            *peer = p;
+            return NNTI_OK;
+        }
+
+        std::promise<void> promise;
+        connecting_[nodeid] = promise.get_future().share();
+        std::vector<NNTI_peer_t> victims = evictIdlePeers();
+        lock.unlock();
+
+        for (auto victim : victims) {
+            t_->disconnect(victim);
+        }
+
+        std::stringstream url;
+        url << "http://" << nodeid.GetIP() << ":" << nodeid.GetPort() << "/";
+
+        log_debug("NetNnti", "Connecting to %s", url.str().c_str());
+
+        NNTI_peer_t   nnti_peer = 0;
+        NNTI_result_t rc        = t_->connect(url.str().c_str(), 1000, &nnti_peer);
+
+        log_debug("NetNnti", "Connected to %p", (void*)nnti_peer);
+
+        lock.lock();
+        p = findPeer(nodeid);
+        if (p == nullptr) {
+            p = new peer_t(nnti_peer);
+            p->pooled    = true;
+            p->nodeid    = nodeid;
+            p->in_flight = std::make_shared<std::atomic<uint32_t>>(0);
+            peer_bimap.insert(nodeid_peer_value(nodeid, p));
+        } else {
+            p->p = nnti_peer;
+        }
+        p->connected = (rc == NNTI_OK);
+        p->last_used = std::chrono::steady_clock::now();
+        connecting_.erase(nodeid);
+        promise.set_value();
+
+        *peer = p;
+        return rc;
+    }
+
+    /*
+     * Get the transport's handle for an op on peer.  Only peers in a
+     * bounded pool need any work here: a closed connection is reopened,
+     * the use is recorded for the LRU, and the op is counted in busy
+     * until its callback calls releasePeer().  Returns an error if the
+     * connection could not be reopened.
+     */
+    int usePeer(peer_t *peer, NNTI_peer_t *peer_hdl, busy_count_t *busy)
+    {
+        if (!peer->pooled || (max_connected_ == 0)) {
+            *peer_hdl = peer->p;
+            return NNTI_OK;
+        }
+
+        std::unique_lock<std::mutex> lock(peer_mutex_);
+        if (!peer->connected) {
+            peer_t *p;
+            int rc = connectPeer(lock, peer->nodeid, &p);
+            if (rc != NNTI_OK) {
+                log_error("NetNnti", "couldn't reconnect to %s: %d", peer->nodeid.GetHex().c_str(), rc);
+                return rc;
+            }
+        }
+        peer->last_used = std::chrono::steady_clock::now();
+        (*peer->in_flight)++;
+        *busy     = peer->in_flight;
+        *peer_hdl = peer->p;
+        return NNTI_OK;
+    }
+
     void translateConfig(faodel::Configuration &config)
     {
         faodel::rc_t rc;
@@ -261,11 +480,6 @@ namespace NetNnti
             } else if (transport_name == "verbs") {
                 // translate the libfabric name to the NNTI name
                 transport_name = "ibverbs";
-            } else if (transport_name == "sockets") {
-                // NNTI doesn't have a sockets transport.  warn and try MPI.
-                // TODO: the logger isn't initialized yet.  use cerr until this is fixed.
-                std::cerr << "NetNnti -> net.transport.name has unsupported value 'sockets'.  Failing back to 'mpi'." << std::endl;
-                transport_name = "mpi";
             }
             config.Set("nnti.transport.name", transport_name);
         }
@@ -360,9 +574,45 @@ namespace NetNnti
             log_debug("NetNnti", "unexpected_callback->operator()");
 
             if (!started_) {
+                // the transport queues the event on unexpected_eq_ and keeps the message
+                deferred_unexpected_ = true;
                 return NNTI_EIO;
             }
 
+            if (deferred_unexpected_) {
+                drainDeferred();
+            }
+
+            deliver(event);
+
+            return NNTI_OK;
+        }
+
+    private:
+        /*
+         * Messages that arrived before Start() finished are still at the
+         * front of the transport's unexpected list, so they have to be
+         * delivered before this one or next_unexpected() would pair each
+         * event with the wrong message.  Drain their events from
+         * unexpected_eq_ a batch at a time.  This runs on the transport's
+         * progress thread, like every other unexpected delivery.
+         */
+        void drainDeferred()
+        {
+            NNTI_event_t events[16];
+            uint32_t     count;
+
+            deferred_unexpected_ = false;
+            while ((t_->eq_wait_many(unexpected_eq_, events, 16, 0, &count) == NNTI_OK) && (count > 0)) {
+                log_debug("NetNnti", "delivering %u deferred unexpected messages", count);
+                for (uint32_t i=0;i<count;i++) {
+                    deliver(&events[i]);
+                }
+            }
+        }
+
+        void deliver(NNTI_event_t *event)
+        {
             if (event->length <= nnti_attrs_.max_eager_size) {
                 log_debug("NetNnti", "using short message path");
                 log_debug_stream("NetNnti") << event;
@@ -427,9 +677,6 @@ namespace NetNnti
                 message_t *msg = (message_t*)long_msg.GetDataPtr();
                 recv_cb_(sender, msg);
             }
-
-
-            return NNTI_OK;
         }
     };
 }
@@ -455,6 +702,13 @@ void Init(
 
   use_zero_copy_=false;
 
+  config_.GetUInt(&max_connected_,           "net.peer_pool.max_connected", "0");
+  config_.GetUInt(&min_idle_ms_,             "net.peer_pool.min_idle_ms",   "1000");
+  config_.GetUInt(&max_concurrent_connects_, "net.connect.max_concurrent",  "16");
+  if (max_concurrent_connects_ == 0) {
+      max_concurrent_connects_ = 1;
+  }
+
   initialized_=true;
 }
 
@@ -516,12 +770,17 @@ void Finish()
 
     started_=false;
 
+    std::unique_lock<std::mutex> lock(peer_mutex_);
     auto it = peer_bimap.begin();
     while (it != peer_bimap.end()) {
         log_debug("NetNnti", "Disconnecting nodeid %s (%x)", it->left.GetHex().c_str(), it->right);
-        Disconnect(it->right);
+        peer_t *peer = it->right;
+        lock.unlock();
+        Disconnect(peer);
+        lock.lock();
         it = peer_bimap.begin();
     }
+    lock.unlock();
 
     teardownRecvQueue();
     t_->stop();
@@ -559,6 +818,7 @@ faodel::nodeid_t ConvertPeerToNodeID(
     opbox::net::peer_t *peer)
 {
     faodel::nodeid_t nodeid;
+    std::lock_guard<std::mutex> lock(peer_mutex_);
     try {
         nodeid = peer_bimap.right.at(peer);
     }
@@ -578,6 +838,7 @@ opbox::net::peer_t *ConvertNodeIDToPeer(
     faodel::nodeid_t nodeid)
 {
     opbox::net::peer_t *peer = nullptr;
+    std::lock_guard<std::mutex> lock(peer_mutex_);
     try {
         peer = peer_bimap.left.at(nodeid);
     }
@@ -653,36 +914,84 @@ int Connect(
     peer_ptr_t        *peer,
     faodel::nodeid_t  peer_nodeid)
 {
-    NNTI_result_t rc = NNTI_OK;
-
-    *peer = ConvertNodeIDToPeer(peer_nodeid);
-
-    if (nullptr == *peer) {
-        std::stringstream url;
-        NNTI_peer_t p;
+    std::unique_lock<std::mutex> lock(peer_mutex_);
 
-        url << "http://" << peer_nodeid.GetIP() << ":" << peer_nodeid.GetPort() << "/";
-
-        log_debug("NetNnti", "Connecting to %s", url.str().c_str());
-
-        rc = t_->connect(url.str().c_str(), 1000, &p);
+    peer_t *p = findPeer(peer_nodeid);
+    if ((p != nullptr) && p->connected) {
+        p->last_used = std::chrono::steady_clock::now();
+        *peer = p;
+        return NNTI_OK;
+    }
 
-        log_debug("NetNnti", "Connected to %p", (void*)p);
+    return connectPeer(lock, peer_nodeid, peer);
+}
 
-        *peer = new peer_t(p);
+/**
+ * @brief Prepare for communication with many peers at once.
+ *
+ * @param[out] peers         Handles to the peers, in the same order as peer_nodeids.
+ * @param[in]  peer_nodeids  The node IDs of the peers.
+ * @return A result code (the first failure if any handshake failed)
+ *
+ * Up to net.connect.max_concurrent handshakes are in flight at a time,
+ * so connecting to a large pool does not cost one round trip per member.
+ */
+int Connect(
+    std::vector<peer_ptr_t>              *peers,
+    const std::vector<faodel::nodeid_t>  &peer_nodeids)
+{
+    peers->assign(peer_nodeids.size(), nullptr);
+
+    std::atomic<size_t> next(0);
+    std::atomic<int>    result(NNTI_OK);
+    auto worker = [&]() {
+        size_t i;
+        while ((i = next.fetch_add(1)) < peer_nodeids.size()) {
+            int rc = Connect(&(*peers)[i], peer_nodeids[i]);
+            if (rc != NNTI_OK) {
+                int expected = NNTI_OK;
+                result.compare_exchange_strong(expected, rc);
+            }
+        }
+    };
 
-        peer_bimap.insert(nodeid_peer_value(peer_nodeid,*peer));
+    size_t num_threads = std::min<size_t>(max_concurrent_connects_, peer_nodeids.size());
+    std::vector<std::thread> threads;
+    for (size_t i=1;i<num_threads;i++) {
+        threads.push_back(std::thread(worker));
+    }
+    worker();
+    for (auto &t : threads) {
+        t.join();
     }
 
-    return rc;
+    return result.load();
 }
 
 int Disconnect(
     peer_ptr_t peer)
 {
     int rc = NNTI_OK;
-    peer_bimap.right.erase(peer);
-    rc = t_->disconnect(peer->p);
+    std::unique_lock<std::mutex> lock(peer_mutex_);
+    auto it = peer_bimap.right.find(peer);
+    if (it != peer_bimap.right.end()) {
+        // a handshake in progress still writes to peer, so let it finish
+        faodel::nodeid_t nodeid = it->second;
+        auto c = connecting_.find(nodeid);
+        while (c != connecting_.end()) {
+            std::shared_future<void> done = c->second;
+            lock.unlock();
+            done.wait();
+            lock.lock();
+            c = connecting_.find(nodeid);
+        }
+        peer_bimap.right.erase(peer);
+    }
+    bool connected = (!peer->pooled || peer->connected);
+    lock.unlock();
+    if (connected) {
+        rc = t_->disconnect(peer->p);
+    }
     delete peer;
     return rc;
 }
@@ -711,6 +1020,12 @@ DataObject NewMessage(
 {
     uint32_t meta_size = nnti_attrs_.mtu - nnti_attrs_.max_eager_size;
     DataObject ldo(meta_size, size, DataObject::AllocatorType::eager);
+    // receivers adopt trace_id, so hand-built messages must not carry garbage.
+    // the type id tells the tracer this LDO holds a message_t it may stamp.
+    if (size >= sizeof(opbox::message_t)) {
+        ldo.GetDataPtr<opbox::message_t *>()->trace_id = 0;
+        ldo.SetTypeID(opbox::message_t::object_type_id);
+    }
     return std::move(ldo);
 }
 
@@ -847,10 +1162,17 @@ void SendMsg(
 {
     volatile int rc;
 
+    opbox::internal::OpTracer::StampOutgoingMessage(msg);
+
     NNTI_work_request_t base_wr = NNTI_WR_INITIALIZER;
     NNTI_work_id_t      wid;
 
-    NNTI_peer_t peer_hdl = peer->p;
+    NNTI_peer_t  peer_hdl;
+    busy_count_t busy;
+    if (usePeer(peer, &peer_hdl, &busy) != NNTI_OK) {
+        // nobody is told about a fire and forget send
+        return;
+    }
 
     NntiBufferLocal *msg_bl        = nullptr;
     uint32_t         msg_bl_offset = 0;
@@ -891,9 +1213,15 @@ void SendMsg(
     }
 
     base_wr.cb_context = new DataObject(msg);
-    nnti::datatype::nnti_work_request wr(t_, base_wr, *default_send_cb_);
+    nnti::datatype::nnti_event_callback *send_cb = default_send_cb_;
+    if (busy) {
+        send_cb = new nnti::datatype::nnti_event_callback(t_, default_callback(busy));
+    }
+    nnti::datatype::nnti_work_request wr(t_, base_wr, *send_cb);
 
-    t_->send(&wr, &wid);
+    if (t_->send(&wr, &wid) != NNTI_OK) {
+        releasePeer(busy);
+    }
 }
 
 /**
@@ -913,10 +1241,17 @@ void SendMsg(
 {
     volatile int rc;
 
+    opbox::internal::OpTracer::StampOutgoingMessage(msg);
+
     NNTI_work_request_t base_wr = NNTI_WR_INITIALIZER;
     NNTI_work_id_t      wid;
 
-    NNTI_peer_t peer_hdl = peer->p;
+    NNTI_peer_t  peer_hdl;
+    busy_count_t busy;
+    if (usePeer(peer, &peer_hdl, &busy) != NNTI_OK) {
+        failOp(user_cb, UpdateType::send_error);
+        return;
+    }
 
     NntiBufferLocal *msg_bl        = nullptr;
     uint32_t         msg_bl_offset = 0;
@@ -957,12 +1292,14 @@ void SendMsg(
         base_wr.length        = msg.GetDataSize() + msg.GetPaddingSize();
     }
 
-    user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(msg));
+    user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(msg), busy);
     nnti::datatype::nnti_event_callback *send_cb = new nnti::datatype::nnti_event_callback(t_, *uicb);
 
     nnti::datatype::nnti_work_request wr(t_, base_wr, *send_cb);
 
-    t_->send(&wr, &wid);
+    if (t_->send(&wr, &wid) != NNTI_OK) {
+        releasePeer(busy);
+    }
 }
 
 /**
@@ -989,7 +1326,12 @@ void Get(
 
     NntiBufferRemote *nbr = (NntiBufferRemote *)remote_buffer;
 
-    NNTI_peer_t peer_hdl = peer->p;
+    NNTI_peer_t  peer_hdl;
+    busy_count_t busy;
+    if (usePeer(peer, &peer_hdl, &busy) != NNTI_OK) {
+        failOp(user_cb, UpdateType::get_error);
+        return;
+    }
 
     NNTI_buffer_t remote_hdl;
     t_->dt_unpack((void*)&remote_hdl, &nbr->packed[0], MAX_NET_BUFFER_REMOTE_SIZE-8);
@@ -1012,10 +1354,10 @@ void Get(
 
     nnti::datatype::nnti_event_callback *get_cb = nullptr;
     if (user_cb) {
-        user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(local_ldo));
+        user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(local_ldo), busy);
         get_cb = new nnti::datatype::nnti_event_callback(t_, *uicb);
     } else {
-        default_callback *dcb = new default_callback();
+        default_callback *dcb = new default_callback(busy);
         get_cb = new nnti::datatype::nnti_event_callback(t_, *dcb);
     }
 
@@ -1044,7 +1386,9 @@ void Get(
     }
 #endif
 
-    t_->get(&wr, &wid);
+    if (t_->get(&wr, &wid) != NNTI_OK) {
+        releasePeer(busy);
+    }
 }
 
 /*
@@ -1075,7 +1419,12 @@ void Get(
 
     NntiBufferRemote *nbr = (NntiBufferRemote *)remote_buffer;
 
-    NNTI_peer_t peer_hdl = peer->p;
+    NNTI_peer_t  peer_hdl;
+    busy_count_t busy;
+    if (usePeer(peer, &peer_hdl, &busy) != NNTI_OK) {
+        failOp(user_cb, UpdateType::get_error);
+        return;
+    }
 
     NNTI_buffer_t remote_hdl;
     t_->dt_unpack((void*)&remote_hdl, &nbr->packed[0], MAX_NET_BUFFER_REMOTE_SIZE-8);
@@ -1096,10 +1445,10 @@ void Get(
 
     nnti::datatype::nnti_event_callback *get_cb = nullptr;
     if (user_cb) {
-        user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(local_ldo));
+        user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(local_ldo), busy);
         get_cb = new nnti::datatype::nnti_event_callback(t_, *uicb);
     } else {
-        default_callback *dcb = new default_callback();
+        default_callback *dcb = new default_callback(busy);
         get_cb = new nnti::datatype::nnti_event_callback(t_, *dcb);
     }
 
@@ -1135,7 +1484,9 @@ void Get(
     }
 #endif
 
-    t_->get(&wr, &wid);
+    if (t_->get(&wr, &wid) != NNTI_OK) {
+        releasePeer(busy);
+    }
 }
 
 /*
@@ -1162,7 +1513,12 @@ void Put(
 
     NntiBufferRemote *nbr = (NntiBufferRemote *)remote_buffer;
 
-    NNTI_peer_t peer_hdl = peer->p;
+    NNTI_peer_t  peer_hdl;
+    busy_count_t busy;
+    if (usePeer(peer, &peer_hdl, &busy) != NNTI_OK) {
+        failOp(user_cb, UpdateType::put_error);
+        return;
+    }
 
     NNTI_buffer_t remote_hdl;
     t_->dt_unpack((void*)&remote_hdl, &nbr->packed[0], MAX_NET_BUFFER_REMOTE_SIZE-8);
@@ -1184,16 +1540,18 @@ void Put(
 
     nnti::datatype::nnti_event_callback *put_cb = nullptr;
     if (user_cb) {
-        user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(local_ldo));
+        user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(local_ldo), busy);
         put_cb = new nnti::datatype::nnti_event_callback(t_, *uicb);
     } else {
-        default_callback *dcb = new default_callback();
+        default_callback *dcb = new default_callback(busy);
         put_cb = new nnti::datatype::nnti_event_callback(t_, *dcb);
     }
 
     nnti::datatype::nnti_work_request wr(t_, base_wr, *put_cb);
 
-    t_->put(&wr, &wid);
+    if (t_->put(&wr, &wid) != NNTI_OK) {
+        releasePeer(busy);
+    }
 }
 
 /*
@@ -1224,7 +1582,12 @@ void Put(
 
     NntiBufferRemote *nbr = (NntiBufferRemote *)remote_buffer;
 
-    NNTI_peer_t peer_hdl = peer->p;
+    NNTI_peer_t  peer_hdl;
+    busy_count_t busy;
+    if (usePeer(peer, &peer_hdl, &busy) != NNTI_OK) {
+        failOp(user_cb, UpdateType::put_error);
+        return;
+    }
 
     NNTI_buffer_t remote_hdl;
     t_->dt_unpack((void*)&remote_hdl, &nbr->packed[0], MAX_NET_BUFFER_REMOTE_SIZE-8);
@@ -1245,16 +1608,18 @@ void Put(
 
     nnti::datatype::nnti_event_callback *put_cb = nullptr;
     if (user_cb) {
-        user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(local_ldo));
+        user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(local_ldo), busy);
         put_cb = new nnti::datatype::nnti_event_callback(t_, *uicb);
     } else {
-        default_callback *dcb = new default_callback();
+        default_callback *dcb = new default_callback(busy);
         put_cb = new nnti::datatype::nnti_event_callback(t_, *dcb);
     }
 
     nnti::datatype::nnti_work_request wr(t_, base_wr, *put_cb);
 
-    t_->put(&wr, &wid);
+    if (t_->put(&wr, &wid) != NNTI_OK) {
+        releasePeer(busy);
+    }
 }
 
 /*
@@ -1317,7 +1682,12 @@ void Atomic(
 
     NntiBufferRemote *nbr = (NntiBufferRemote *)remote_buffer;
 
-    NNTI_peer_t peer_hdl = peer->p;
+    NNTI_peer_t  peer_hdl;
+    busy_count_t busy;
+    if (usePeer(peer, &peer_hdl, &busy) != NNTI_OK) {
+        failOp(user_cb, UpdateType::atomic_error);
+        return;
+    }
 
     NNTI_buffer_t remote_hdl;
     t_->dt_unpack((void*)&remote_hdl, &nbr->packed[0], MAX_NET_BUFFER_REMOTE_SIZE-8);
@@ -1339,16 +1709,18 @@ void Atomic(
 
     nnti::datatype::nnti_event_callback *atomic_cb = nullptr;
     if (user_cb) {
-        user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(local_ldo));
+        user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(local_ldo), busy);
         atomic_cb = new nnti::datatype::nnti_event_callback(t_, *uicb);
     } else {
-        default_callback *dcb = new default_callback();
+        default_callback *dcb = new default_callback(busy);
         atomic_cb = new nnti::datatype::nnti_event_callback(t_, *dcb);
     }
 
     nnti::datatype::nnti_work_request wr(t_, base_wr, *atomic_cb);
 
-    t_->atomic_fop(&wr, &wid);
+    if (t_->atomic_fop(&wr, &wid) != NNTI_OK) {
+        releasePeer(busy);
+    }
 }
 
 /*
@@ -1385,7 +1757,12 @@ void Atomic(
 
     NntiBufferRemote *nbr = (NntiBufferRemote *)remote_buffer;
 
-    NNTI_peer_t peer_hdl = peer->p;
+    NNTI_peer_t  peer_hdl;
+    busy_count_t busy;
+    if (usePeer(peer, &peer_hdl, &busy) != NNTI_OK) {
+        failOp(user_cb, UpdateType::atomic_error);
+        return;
+    }
 
     NNTI_buffer_t remote_hdl;
     t_->dt_unpack((void*)&remote_hdl, &nbr->packed[0], MAX_NET_BUFFER_REMOTE_SIZE-8);
@@ -1408,16 +1785,18 @@ void Atomic(
 
     nnti::datatype::nnti_event_callback *atomic_cb = nullptr;
     if (user_cb) {
-        user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(local_ldo));
+        user_invoking_callback *uicb = new user_invoking_callback(user_cb, new DataObject(local_ldo), busy);
         atomic_cb = new nnti::datatype::nnti_event_callback(t_, *uicb);
     } else {
-        default_callback *dcb = new default_callback();
+        default_callback *dcb = new default_callback(busy);
         atomic_cb = new nnti::datatype::nnti_event_callback(t_, *dcb);
     }
 
     nnti::datatype::nnti_work_request wr(t_, base_wr, *atomic_cb);
 
-    t_->atomic_cswap(&wr, &wid);
+    if (t_->atomic_cswap(&wr, &wid) != NNTI_OK) {
+        releasePeer(busy);
+    }
 }
 
 }
@@ -109,6 +109,8 @@ public:
   int GetSecondsSinceAccessed() const;                 ///< Report how many seconds since this was accessed
   mailbox_t GetAssignedMailbox();                      ///< Generate a node-unique id for this instance
   void touch();                                        ///< Updates the last accessed timestep
+  uint32_t GetTraceID() const { return trace_id; }     ///< Id used to correlate this op's spans across nodes (0 if untraced)
+  void SetTraceID(uint32_t id) { trace_id = id; }      ///< Set by OpBox when tracing is enabled
 
 
 protected:
@@ -116,6 +118,7 @@ protected:
   mailbox_t mailbox;     //!< A unique identifier for this op
   int ts_created;        //!< Millisecond timestamp of When the op was created
   int ts_lastaccessed;   //!< Millisecond timestamp of last time this op was touched
+  uint32_t trace_id = 0; //!< Trace id assigned at launch or inherited from the creating message
 
   int getMSTimeStamp() const;  ///< Generate a millisecond timestamp for this op
 
@@ -0,0 +1,424 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+/*
+ * sbl_async_stream.cpp
+ *
+ *  An sbl destination that moves formatting and I/O off the logging thread.
+ */
+
+#include "faodelConfig.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+#include "sbl/sbl_async_stream.hh"
+
+
+namespace sbl  {
+
+namespace {
+    // ids are never reused, so a thread's cached ring for a destroyed
+    // stream can never be mistaken for a ring in a new stream.
+    std::atomic<uint64_t> next_stream_id(1);
+
+    // a thread's rings, keyed by stream id.  the stream owns each ring.
+    // the weak reference lets the thread retire its rings at exit without
+    // keeping the rings of a destroyed stream alive.
+    struct cached_ring {
+        void                               *ring;
+        std::weak_ptr< std::atomic<bool> >  retired;
+    };
+    struct ring_cache {
+        uint64_t                                     last_id   = 0;
+        void                                        *last_ring = nullptr;
+        std::unordered_map< uint64_t, cached_ring >  rings;
+
+        ~ring_cache();
+    };
+    thread_local ring_cache my_rings;
+    thread_local bool       my_rings_released = false;
+
+    ring_cache::~ring_cache()
+    {
+        my_rings_released = true;
+        last_id   = 0;
+        last_ring = nullptr;
+        for (auto &kv : rings) {
+            auto retired = kv.second.retired.lock();
+            if (retired) {
+                retired->store(true, std::memory_order_release);
+            }
+        }
+    }
+
+    const char *severity_string(const severity_level severity)
+    {
+        static const char* strings[] =
+        {
+            "DEBUG",
+            "INFO",
+            "WARN",
+            "ERROR",
+            "FATAL"
+        };
+        if (static_cast< std::size_t >(severity) < sizeof(strings) / sizeof(*strings))
+            return strings[severity];
+        return "UNKNOWN";
+    }
+
+    // copy at most len-1 characters and always terminate.  returns the
+    // number of characters copied.
+    uint32_t copy_string(char *dst, const char *src, const uint32_t len)
+    {
+        uint32_t i=0;
+        if (src != nullptr) {
+            for (; (i < len-1) && (src[i] != '\0'); i++) {
+                dst[i] = src[i];
+            }
+        }
+        dst[i] = '\0';
+        return i;
+    }
+}
+
+    async_stream::async_stream(
+        const severity_level severity,
+        const uint32_t       ring_entries)
+    {
+        init(
+            std::shared_ptr< std::ostream > (&std::clog, [](std::ostream*){}),
+            severity,
+            ring_entries);
+    }
+    async_stream::async_stream(
+        std::ostream&        stream,
+        const severity_level severity,
+        const uint32_t       ring_entries)
+    {
+        init(
+            std::shared_ptr< std::ostream > (&stream, [](std::ostream*){}),
+            severity,
+            ring_entries);
+    }
+    async_stream::async_stream(
+        const std::string    filename,
+        const severity_level severity,
+        const uint32_t       ring_entries)
+    : filename_(filename)
+    {
+        init(
+            std::make_shared< std::ofstream > (filename_),
+            severity,
+            ring_entries);
+    }
+    async_stream::~async_stream()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stop_ = true;
+        }
+        wake_cv_.notify_all();
+        writer_.join();
+    }
+
+    void async_stream::set_severity(
+            const severity_level severity)
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        severity_ = severity;
+        update_min_severity();
+    }
+
+    severity_level async_stream::severity(void)
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        return severity_;
+    }
+
+    void async_stream::set_channel_severity(
+            const std::string    channel,
+            const severity_level severity)
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        severity_map_[channel] = severity;
+        update_min_severity();
+    }
+
+    /*
+     * Block until every record pushed before this call has been written.
+     */
+    void async_stream::flush(void)
+    {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        // the pass in progress may have missed our records, so wait for
+        // one more pass to start and finish after this point.
+        uint64_t target = completed_passes_ + 2;
+        wake_cv_.notify_all();
+        pass_cv_.wait(lock, [this, target] { return stop_ || (completed_passes_ >= target); });
+    }
+
+    uint64_t async_stream::dropped(void)
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        uint64_t total=retired_drops_.load(std::memory_order_relaxed);
+        for (auto &r : rings_) {
+            total += r->dropped.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /*
+     * Number of rings that have not been freed yet.
+     */
+    uint32_t async_stream::num_rings(void)
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        return rings_.size();
+    }
+
+    void async_stream::push(
+            const severity_level severity,
+            const char          *channel,
+            const char          *prefix,
+            const char          *msg)
+    {
+        if (!enabled(severity)) {
+            return;
+        }
+        ring   *r   = thread_ring();
+        if (r == nullptr) {
+            return;
+        }
+        record *rec = reserve(r, severity, channel);
+        if (rec == nullptr) {
+            return;
+        }
+        rec->length  = copy_string(rec->text, prefix, max_text_len);
+        rec->length += copy_string(rec->text + rec->length, msg, max_text_len - rec->length);
+
+        r->head.store(r->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void async_stream::push(
+            const severity_level severity,
+            const char          *channel,
+            const char          *prefix,
+            const char          *msg,
+            va_list              params)
+    {
+        if (!enabled(severity)) {
+            return;
+        }
+        ring   *r   = thread_ring();
+        if (r == nullptr) {
+            return;
+        }
+        record *rec = reserve(r, severity, channel);
+        if (rec == nullptr) {
+            return;
+        }
+        rec->length = copy_string(rec->text, prefix, max_text_len);
+        int n = vsnprintf(rec->text + rec->length, max_text_len - rec->length, msg, params);
+        if (n > 0) {
+            rec->length = std::min<uint32_t>(rec->length + n, max_text_len - 1);
+        }
+
+        r->head.store(r->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /* private methods */
+    void async_stream::init(
+            std::shared_ptr< std::ostream > stream,
+            const severity_level            severity,
+            const uint32_t                  ring_entries)
+    {
+        id_               = next_stream_id++;
+        ring_entries_     = (ring_entries > 0) ? ring_entries : 1;
+        stream_           = stream;
+        severity_         = severity;
+        min_severity_     = static_cast<int>(severity);
+        line_id_          = 1;
+        reported_drops_   = 0;
+        retired_drops_    = 0;
+        completed_passes_ = 0;
+        stop_             = false;
+
+        writer_ = std::thread(&async_stream::run, this);
+    }
+
+    /*
+     * Find the calling thread's ring in this stream, creating it on first use.
+     * Returns nullptr if the thread is exiting and its rings were released.
+     */
+    async_stream::ring *async_stream::thread_ring(void)
+    {
+        // checked first: after the cache's destructor runs, my_rings must
+        // not be read, and the stream may already have freed its rings.
+        if (my_rings_released) {
+            return nullptr;
+        }
+        if (my_rings.last_id == id_) {
+            return static_cast<ring*>(my_rings.last_ring);
+        }
+
+        ring *r;
+        auto it = my_rings.rings.find(id_);
+        if (it != my_rings.rings.end()) {
+            r = static_cast<ring*>(it->second.ring);
+        } else {
+            auto sr = std::make_shared<ring>(ring_entries_);
+            r = sr.get();
+            {
+                std::lock_guard<std::mutex> lock(rings_mutex_);
+                rings_.push_back(sr);
+            }
+            my_rings.rings[id_] = cached_ring{ r, std::shared_ptr< std::atomic<bool> >(sr, &sr->retired) };
+        }
+        my_rings.last_id   = id_;
+        my_rings.last_ring = r;
+        return r;
+    }
+
+    /*
+     * Claim the next free record in the calling thread's ring (r).  Returns
+     * nullptr (and counts a drop) if the ring is full.  The record is
+     * published when the caller advances the ring's head.
+     */
+    async_stream::record *async_stream::reserve(
+            ring                *r,
+            const severity_level severity,
+            const char          *channel)
+    {
+        uint64_t h = r->head.load(std::memory_order_relaxed);
+
+        if (h - r->tail.load(std::memory_order_acquire) >= ring_entries_) {
+            r->dropped.store(r->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        record *rec = &r->records[h % ring_entries_];
+        rec->severity = severity;
+        copy_string(rec->channel, channel, max_channel_len);
+        return rec;
+    }
+
+    /*
+     * Recompute the lowest severity any filter accepts.  Caller holds config_mutex_.
+     */
+    void async_stream::update_min_severity(void)
+    {
+        int min = static_cast<int>(severity_);
+        for (auto &kv : severity_map_) {
+            min = std::min(min, static_cast<int>(kv.second));
+        }
+        min_severity_.store(min, std::memory_order_relaxed);
+    }
+
+    /*
+     * Apply the same rule as sbl::stream: a channel severity takes
+     * precedence over the stream severity.  Caller holds config_mutex_.
+     */
+    bool async_stream::accept(
+            const record &rec)
+    {
+        auto it = severity_map_.find(rec.channel);
+        if (it != severity_map_.end()) {
+            return (rec.severity >= it->second);
+        }
+        return (rec.severity >= severity_);
+    }
+
+    /*
+     * Format and write everything currently in the rings.  Returns the
+     * number of records consumed.
+     */
+    uint64_t async_stream::drain(void)
+    {
+        std::vector< std::shared_ptr<ring> > rings;
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            rings = rings_;
+        }
+
+        uint64_t consumed=0;
+        uint64_t drops=0;
+        std::vector< ring * > finished;
+        std::ostream &os = *stream_;
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        for (auto &r : rings) {
+            // read retired before head, so a retired ring is empty after this pass
+            bool retired = r->retired.load(std::memory_order_acquire);
+            uint64_t t = r->tail.load(std::memory_order_relaxed);
+            uint64_t h = r->head.load(std::memory_order_acquire);
+            for (; t < h; t++) {
+                const record &rec = r->records[t % ring_entries_];
+                if (accept(rec)) {
+                    os << line_id_++ << ": <" << severity_string(rec.severity)
+                       << "> [" << rec.channel << "] ";
+                    os.write(rec.text, rec.length);
+                    os << '\n';
+                }
+                consumed++;
+            }
+            r->tail.store(t, std::memory_order_release);
+            if (retired) {
+                finished.push_back(r.get());
+            }
+        }
+        {
+            std::lock_guard<std::mutex> rlock(rings_mutex_);
+            // the producer threads are gone, so free their drained rings
+            for (auto f : finished) {
+                retired_drops_ += f->dropped.load(std::memory_order_relaxed);
+                rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                            [f](const std::shared_ptr<ring> &x) { return x.get() == f; }),
+                             rings_.end());
+            }
+            drops = retired_drops_.load(std::memory_order_relaxed);
+            for (auto &r : rings_) {
+                drops += r->dropped.load(std::memory_order_relaxed);
+            }
+        }
+        if (drops > reported_drops_) {
+            os << line_id_++ << ": <" << severity_string(severity_level::warning)
+               << "> [sbl] async_stream dropped " << (drops - reported_drops_)
+               << " records (ring buffer full)\n";
+            reported_drops_ = drops;
+            os.flush();
+        } else if (consumed > 0) {
+            os.flush();
+        }
+        return consumed;
+    }
+
+    void async_stream::run(void)
+    {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        while (true) {
+            bool stopping = stop_;
+            lock.unlock();
+            uint64_t consumed = drain();
+            lock.lock();
+
+            completed_passes_++;
+            pass_cv_.notify_all();
+
+            if (stopping) {
+                // stop_ was set before this pass began, so the pass picked
+                // up everything pushed before the destructor was called
+                break;
+            }
+            if (consumed == 0) {
+                // producers never signal us; poll so that the logging
+                // path stays free of syscalls
+                wake_cv_.wait_for(lock, std::chrono::milliseconds(10));
+            }
+        }
+    }
+}
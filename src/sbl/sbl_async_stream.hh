@@ -0,0 +1,166 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+/*
+ * sbl_async_stream.hh
+ *
+ *  An sbl destination that moves formatting and I/O off the logging thread.
+ */
+
+#ifndef SBL_ASYNC_STREAM_HH_
+#define SBL_ASYNC_STREAM_HH_
+
+#include "faodelConfig.h"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sbl/sbl_types.hh"
+
+namespace sbl  {
+
+/*
+ * async_stream is an alternative to sbl::stream for code that logs from
+ * latency sensitive paths (eg, NNTI progress threads).  Producers copy each
+ * message into a fixed-size binary record in a ring buffer owned by the
+ * calling thread.  Rings are single-producer/single-consumer, so a producer
+ * never takes a lock or touches the Boost.Log core.  A background thread
+ * drains the rings, applies the channel filters, formats the records and
+ * writes them to the destination.
+ *
+ * When a thread's ring is full the new record is dropped and counted.  The
+ * background thread reports the number of drops in the log itself and the
+ * total is available from dropped().
+ *
+ * Records from one thread are written in order.  Records from different
+ * threads are interleaved in the order the background thread finds them.
+ *
+ * Each ring costs ring_entries * sizeof(record) (about 1MB by default).
+ * When a thread exits its rings are retired, and the background thread
+ * frees them once they are drained.
+ */
+class async_stream {
+public:
+    static const uint32_t default_ring_entries = 1024;
+    static const uint32_t max_channel_len      = 32;
+    static const uint32_t max_text_len         = 984;
+
+    async_stream(
+        const severity_level severity,
+        const uint32_t       ring_entries=default_ring_entries);
+    async_stream(
+        std::ostream&        stream,
+        const severity_level severity,
+        const uint32_t       ring_entries=default_ring_entries);
+    async_stream(
+        const std::string    filename,
+        const severity_level severity,
+        const uint32_t       ring_entries=default_ring_entries);
+    ~async_stream();
+
+    void set_severity(
+            const severity_level severity);
+    severity_level severity(void);
+    void set_channel_severity(
+            const std::string    channel,
+            const severity_level severity);
+    void flush(void);
+    uint64_t dropped(void);
+    uint32_t num_rings(void);
+
+    /*
+     * Cheap check that producers use to skip work for records that no
+     * filter in this stream could accept.
+     */
+    bool enabled(
+            const severity_level severity) const
+    {
+        return (static_cast<int>(severity) >= min_severity_.load(std::memory_order_relaxed));
+    }
+
+    void push(
+            const severity_level severity,
+            const char          *channel,
+            const char          *prefix,
+            const char          *msg);
+    void push(
+            const severity_level severity,
+            const char          *channel,
+            const char          *prefix,
+            const char          *msg,
+            va_list              params);
+
+private:
+    struct record {
+        severity_level severity;
+        uint32_t       length;
+        char           channel[max_channel_len];
+        char           text[max_text_len];
+    };
+
+    struct ring {
+        explicit ring(uint32_t num_entries) : records(num_entries), head(0), pad_(), tail(0), dropped(0), retired(false) {}
+        std::vector<record>    records;
+        std::atomic<uint64_t>  head;     // only written by the producer
+        char                   pad_[64]; // keep head and tail on separate cache lines
+        std::atomic<uint64_t>  tail;     // only written by the background thread
+        std::atomic<uint64_t>  dropped;  // only written by the producer
+        std::atomic<bool>      retired;  // set when the producer thread exits
+    };
+
+    void init(
+            std::shared_ptr< std::ostream > stream,
+            const severity_level            severity,
+            const uint32_t                  ring_entries);
+    ring *thread_ring(void);
+    record *reserve(
+            ring                *r,
+            const severity_level severity,
+            const char          *channel);
+    void update_min_severity(void);
+    bool accept(
+            const record &rec);
+    uint64_t drain(void);
+    void run(void);
+
+private:
+    uint64_t                          id_;
+    uint32_t                          ring_entries_;
+
+    std::shared_ptr< std::ostream >   stream_;
+    std::string                       filename_;
+
+    std::mutex                               config_mutex_;  // guards severity_ and severity_map_
+    severity_level                           severity_;
+    std::map< std::string, severity_level >  severity_map_;
+    std::atomic<int>                         min_severity_;
+
+    std::mutex                        rings_mutex_;          // guards rings_ (registration and retirement)
+    std::vector< std::shared_ptr<ring> > rings_;
+    std::atomic<uint64_t>             retired_drops_;        // drops counted by rings that were freed
+
+    uint64_t                          line_id_;              // only used by the background thread
+    uint64_t                          reported_drops_;       // only used by the background thread
+
+    std::mutex                        wake_mutex_;
+    std::condition_variable           wake_cv_;
+    std::condition_variable           pass_cv_;
+    uint64_t                          completed_passes_;
+    bool                              stop_;
+    std::thread                       writer_;
+};
+
+} /* namespace sbl */
+
+#endif /* SBL_ASYNC_STREAM_HH_ */
@@ -24,7 +24,8 @@ namespace sbl  {
 
     logger::logger(
         const severity_level severity)
-    : stream_(severity),
+    : stream_(new sbl::stream(severity)),
+      async_stream_(nullptr),
       debug_source_(severity_level::debug),
       info_source_(severity_level::info),
       warning_source_(severity_level::warning),
@@ -41,7 +42,8 @@ namespace sbl  {
     logger::logger(
         std::ostream&        stream,
         const severity_level severity)
-    : stream_(stream, severity),
+    : stream_(new sbl::stream(stream, severity)),
+      async_stream_(nullptr),
       debug_source_(severity_level::debug),
       info_source_(severity_level::info),
       warning_source_(severity_level::warning),
@@ -58,7 +60,8 @@ namespace sbl  {
     logger::logger(
         const std::string    filename,
         const severity_level severity)
-    : stream_(filename, severity),
+    : stream_(new sbl::stream(filename, severity)),
+      async_stream_(nullptr),
       debug_source_(severity_level::debug),
       info_source_(severity_level::info),
       warning_source_(severity_level::warning),
@@ -72,21 +75,78 @@ namespace sbl  {
         // this shouldn't be necessary.  the severity should be set in the stream ctor.
         set_severity(severity);
     }
+    logger::logger(
+        const severity_level severity,
+        const uint32_t       async_ring_entries)
+    : stream_(nullptr),
+      async_stream_(new sbl::async_stream(severity, async_ring_entries)),
+      debug_source_(severity_level::debug),
+      info_source_(severity_level::info),
+      warning_source_(severity_level::warning),
+      error_source_(severity_level::error),
+      fatal_source_(severity_level::fatal)
+    {
+        logger::logger_id_++;
+
+        init(logger::logger_id_);
+    }
+    logger::logger(
+        std::ostream&        stream,
+        const severity_level severity,
+        const uint32_t       async_ring_entries)
+    : stream_(nullptr),
+      async_stream_(new sbl::async_stream(stream, severity, async_ring_entries)),
+      debug_source_(severity_level::debug),
+      info_source_(severity_level::info),
+      warning_source_(severity_level::warning),
+      error_source_(severity_level::error),
+      fatal_source_(severity_level::fatal)
+    {
+        logger::logger_id_++;
+
+        init(logger::logger_id_);
+    }
+    logger::logger(
+        const std::string    filename,
+        const severity_level severity,
+        const uint32_t       async_ring_entries)
+    : stream_(nullptr),
+      async_stream_(new sbl::async_stream(filename, severity, async_ring_entries)),
+      debug_source_(severity_level::debug),
+      info_source_(severity_level::info),
+      warning_source_(severity_level::warning),
+      error_source_(severity_level::error),
+      fatal_source_(severity_level::fatal)
+    {
+        logger::logger_id_++;
+
+        init(logger::logger_id_);
+    }
     logger::~logger()
     {
+        // the background thread writes everything still queued before it exits
+        delete async_stream_;
+        delete stream_;
     }
 
     void
     logger::set_severity(
             const severity_level severity)
     {
-        stream_.set_severity(severity);
+        if (async_stream_ != nullptr) {
+            async_stream_->set_severity(severity);
+        } else {
+            stream_->set_severity(severity);
+        }
     }
 
     severity_level
     logger::severity(void)
     {
-        return stream_.severity();
+        if (async_stream_ != nullptr) {
+            return async_stream_->severity();
+        }
+        return stream_->severity();
     }
 
     void
@@ -94,13 +154,40 @@ namespace sbl  {
             const std::string    channel,
             const severity_level severity)
     {
-        stream_.set_channel_severity(channel, severity);
+        if (async_stream_ != nullptr) {
+            async_stream_->set_channel_severity(channel, severity);
+        } else {
+            stream_->set_channel_severity(channel, severity);
+        }
     }
 
     void
     logger::flush(void)
     {
-        stream_.flush();
+        if (async_stream_ != nullptr) {
+            async_stream_->flush();
+        } else {
+            stream_->flush();
+        }
+    }
+
+    bool
+    logger::is_async(void)
+    {
+        return (async_stream_ != nullptr);
+    }
+
+    /*
+     * Number of records the async_stream discarded because a ring was full.
+     * Always zero for a synchronous logger.
+     */
+    uint64_t
+    logger::dropped(void)
+    {
+        if (async_stream_ != nullptr) {
+            return async_stream_->dropped();
+        }
+        return 0;
     }
 
     void
@@ -368,12 +455,20 @@ namespace sbl  {
     logger::init(
         uint64_t logger_id)
     {
-        stream_.set_logger_id(logger_id);
+        if (stream_ != nullptr) {
+            stream_->set_logger_id(logger_id);
+        }
 
         debug_source_.set_logger_id(logger_id);
         info_source_.set_logger_id(logger_id);
         warning_source_.set_logger_id(logger_id);
         error_source_.set_logger_id(logger_id);
         fatal_source_.set_logger_id(logger_id);
+
+        debug_source_.set_async_stream(async_stream_);
+        info_source_.set_async_stream(async_stream_);
+        warning_source_.set_async_stream(async_stream_);
+        error_source_.set_async_stream(async_stream_);
+        fatal_source_.set_async_stream(async_stream_);
     }
 }
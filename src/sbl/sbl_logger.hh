@@ -31,12 +31,19 @@
 #include "sbl/sbl_types.hh"
 #include "sbl/sbl_source.hh"
 #include "sbl/sbl_stream.hh"
+#include "sbl/sbl_async_stream.hh"
 
 namespace sbl  {
 
 /*
  * This is the simplified logger class.  It creates one stream with a
  * severity threshold and a source for each severity level.
+ *
+ * The constructors that take an async_ring_entries argument create an
+ * async_stream instead of an sbl::stream.  The sources then hand records to
+ * per-thread ring buffers and a background thread does the formatting and
+ * I/O.  Records are dropped (and counted by dropped()) when a thread logs
+ * faster than the background thread can write.
  */
 class logger {
 public:
@@ -48,6 +55,17 @@ public:
     logger(
         const std::string    filename,
         const severity_level severity);
+    logger(
+        const severity_level severity,
+        const uint32_t       async_ring_entries);
+    logger(
+        std::ostream&        stream,
+        const severity_level severity,
+        const uint32_t       async_ring_entries);
+    logger(
+        const std::string    filename,
+        const severity_level severity,
+        const uint32_t       async_ring_entries);
     ~logger();
 
     void
@@ -61,6 +79,10 @@ public:
             const severity_level severity);
     void
     flush(void);
+    bool
+    is_async(void);
+    uint64_t
+    dropped(void);
     void
     debug(
         const char *channel,
@@ -145,7 +167,8 @@ private:
 private:
     static uint64_t logger_id_;
 
-    sbl::stream stream_;
+    sbl::stream       *stream_;
+    sbl::async_stream *async_stream_;
 
     sbl::source debug_source_;
     sbl::source info_source_;
@@ -22,6 +22,7 @@ namespace sbl  {
     : logger_id_(0),
       logger_id_attr_(logger_id_),
       severity_(severity),
+      async_(nullptr),
       disabled(false)
     {
         boostlogger_.add_attribute("LoggerID", logger_id_attr_);
@@ -32,6 +33,7 @@ namespace sbl  {
     : logger_id_(logger_id),
       logger_id_attr_(logger_id_),
       severity_(severity),
+      async_(nullptr),
       disabled(false)
     {
         boostlogger_.add_attribute("LoggerID", logger_id_attr_);
@@ -61,6 +63,20 @@ namespace sbl  {
         logger_id_attr_.set(logger_id_);
     }
 
+    /*
+     * Route this source's messages to an async_stream instead of the
+     * Boost.Log core.  Pass nullptr to return to Boost.Log.
+     */
+    void source::set_async_stream(async_stream *s)
+    {
+        async_ = s;
+    }
+
+    async_stream *source::async_target(void)
+    {
+        return async_;
+    }
+
     void source::log(
         const char *channel,
         const char *func_name,
@@ -98,6 +114,10 @@ namespace sbl  {
         char buf1[256];
         char buf2[1024];
 
+        if (disabled || ((async_ != nullptr) && !async_->enabled(severity_))) {
+            return;
+        }
+
         /* path from last '/' */
         file = strrchr(file_name, '/');
 
@@ -114,6 +134,12 @@ namespace sbl  {
                 line_num);
 #endif
 
+        if (async_ != nullptr) {
+            // the async_stream formats the message directly into its record
+            async_->push(severity_, channel, buf1, msg, params);
+            return;
+        }
+
         vsprintf(buf2, msg, params);
 
         output(
@@ -179,6 +205,10 @@ namespace sbl  {
         if (disabled) {
             return;
         }
+        if (async_ != nullptr) {
+            async_->push(severity_, channel, "", msg);
+            return;
+        }
         try {
             BOOST_LOG_CHANNEL_SEV(boostlogger_, channel, severity_) << msg;
         }
@@ -197,6 +227,10 @@ namespace sbl  {
         if (disabled) {
             return;
         }
+        if (async_ != nullptr) {
+            async_->push(severity_, channel, prefix, msg);
+            return;
+        }
         try {
             BOOST_LOG_CHANNEL_SEV(boostlogger_, channel, severity_) << prefix << msg;
         }
@@ -217,6 +251,10 @@ namespace sbl  {
         if (disabled) {
             return;
         }
+        if (async_ != nullptr) {
+            async_->push(severity_, channel, "", msg, params);
+            return;
+        }
 
         vsprintf(buf, msg, params);
 
@@ -241,6 +279,10 @@ namespace sbl  {
         if (disabled) {
             return;
         }
+        if (async_ != nullptr) {
+            async_->push(severity_, channel, prefix, msg, params);
+            return;
+        }
 
         vsprintf(buf, msg, params);
 
@@ -253,4 +295,56 @@ namespace sbl  {
 
         return;
     }
+
+    stream_record::stream_record(
+        source            &src,
+        const char        *channel)
+    : src_(src),
+      open_(false)
+    {
+        if (src_.is_disabled()) {
+            return;
+        }
+        async_stream *async = src_.async_target();
+        if (async != nullptr) {
+            if (async->enabled(src_.severity())) {
+                // the channel may be a temporary, so keep a copy for commit()
+                strncpy(async_channel_, channel, sizeof(async_channel_) - 1);
+                async_channel_[sizeof(async_channel_) - 1] = '\0';
+                async_strm_.emplace();
+                open_ = true;
+            }
+            return;
+        }
+        try {
+            rec_ = src_.boostlogger().open_record(
+                (boost::log::keywords::channel = channel, boost::log::keywords::severity = src_.severity()));
+            if (rec_) {
+                boost_strm_.emplace(rec_);
+                open_ = true;
+            }
+        }
+        catch (std::exception &e) {
+            open_ = false;
+        }
+    }
+
+    std::ostream& stream_record::stream(void)
+    {
+        if (async_strm_) {
+            return *async_strm_;
+        }
+        return boost_strm_->stream();
+    }
+
+    void stream_record::commit(void)
+    {
+        if (async_strm_) {
+            src_.async_target()->push(src_.severity(), async_channel_, "", async_strm_->str().c_str());
+        } else {
+            boost_strm_->flush();
+            src_.boostlogger().push_record(boost::move(rec_));
+        }
+        open_ = false;
+    }
 }
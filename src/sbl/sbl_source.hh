@@ -15,6 +15,8 @@
 #include "faodelConfig.h"
 #include "sbl/sbl_boost_headers.hh"
 
+#include <boost/optional.hpp>
+
 #include <errno.h>
 #include <time.h>
 #include <stdint.h>
@@ -26,9 +28,11 @@
 #include <cstdarg>
 #include <fstream>
 #include <map>
+#include <sstream>
 #include <string>
 
 #include "sbl/sbl_types.hh"
+#include "sbl/sbl_async_stream.hh"
 
 /*
  * This is some serious voodoo.  The difficulty here is that we
@@ -50,7 +54,9 @@
 #endif
 
 #define SBL_LOG(s, ...) s.log("", __FUNCTION__,__FILE__,__LINE__, ## __VA_ARGS__)
-#define SBL_LOG_STREAM(s, c) BOOST_LOG_CHANNEL_SEV(s.boostlogger(), c, s.severity())
+#define SBL_LOG_STREAM(s, c) \
+    for (::sbl::stream_record _sbl_record((s), (c)); _sbl_record.is_open(); _sbl_record.commit()) \
+        _sbl_record.stream()
 
 namespace sbl  {
 
@@ -71,6 +77,9 @@ public:
     sbl_record_pump make_record_pump(boost::log::record &rec);
     severity_level severity(void);
     void set_logger_id(uint64_t id);
+    void set_async_stream(async_stream *s);
+    async_stream *async_target(void);
+    bool is_disabled(void) const { return disabled; }
 
     void log(
         const char *channel,
@@ -123,10 +132,42 @@ private:
 
     severity_level severity_;
     sbl_logger     boostlogger_;
+    async_stream  *async_;
 
     bool disabled;
 };
 
+/*
+ * The record behind SBL_LOG_STREAM().  Without an async_stream this is
+ * the same Boost.Log record that BOOST_LOG_CHANNEL_SEV() opens.  The
+ * async buffer and the copy of the channel name are only built when the
+ * source has an async_stream.  Either way, is_open() is false when the
+ * source is disabled or no destination would accept the message, so the
+ * stream operators are never evaluated.
+ */
+class stream_record {
+public:
+    stream_record(
+        source            &src,
+        const char        *channel);
+    stream_record(
+        source            &src,
+        const std::string &channel)
+    : stream_record(src, channel.c_str()) {}
+
+    bool is_open(void) const { return open_; }
+    std::ostream& stream(void);
+    void commit(void);
+
+private:
+    source                                         &src_;
+    bool                                            open_;
+    boost::log::record                              rec_;
+    boost::optional< boost::log::record_ostream >   boost_strm_;
+    boost::optional< std::ostringstream >           async_strm_;
+    char                                            async_channel_[async_stream::max_channel_len];
+};
+
 } /* namespace sbl */
 
 #endif /* SBL_SOURCE_HH_ */
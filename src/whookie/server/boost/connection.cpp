@@ -9,20 +9,147 @@
 //
 
 #include "whookie/server/boost/connection.hpp"
+#include <sys/socket.h>
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <streambuf>
 #include <utility>
 #include <vector>
 #include "whookie/server/boost/connection_manager.hpp"
+#include "whookie/server/boost/mime_types.hpp"
 #include "whookie/server/boost/request_handler.hpp"
 
 
 namespace http {
 namespace server {
 
+namespace {
+
+/// Decide whether the client wants to reuse the connection. HTTP/1.1 keeps
+/// connections open unless told otherwise, HTTP/1.0 closes them by default.
+bool wants_keep_alive(const request& req)
+{
+  bool keep_alive = (req.http_version_major > 1) ||
+                    ((req.http_version_major == 1) && (req.http_version_minor >= 1));
+  for (auto& h : req.headers)
+  {
+    std::string name = h.name, value = h.value;
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+    if (name != "connection") continue;
+    if (value.find("close") != std::string::npos)      keep_alive = false;
+    if (value.find("keep-alive") != std::string::npos) keep_alive = true;
+  }
+  return keep_alive;
+}
+
+/// A streambuf a hook writes its reply into. Output is buffered until it
+/// reaches the chunk size. At that point the reply headers are sent and the
+/// output goes out as HTTP/1.1 chunks, so a large page is never held in
+/// memory all at once. Small replies never reach the chunk size and are sent
+/// by the caller as a normal reply with a Content-Length.
+class chunk_streambuf
+  : public std::streambuf
+{
+public:
+  chunk_streambuf(boost::asio::ip::tcp::socket& socket, std::size_t chunk_size, bool keep_alive)
+    : socket_(socket), chunk_size_(chunk_size), keep_alive_(keep_alive),
+      streaming_(false), failed_(false)
+  {
+  }
+
+  /// True once the headers have gone out and the reply is being chunked.
+  bool streaming() const { return streaming_; }
+
+  /// True if the client went away while streaming.
+  bool failed() const { return failed_; }
+
+  /// Output that has not been sent yet.
+  std::string& content() { return content_; }
+
+  /// Send any remaining output and the terminating chunk.
+  void finish()
+  {
+    send_chunk();
+    write("0\r\n\r\n");
+  }
+
+protected:
+  int_type overflow(int_type c) override
+  {
+    if (c != traits_type::eof())
+    {
+      content_.push_back(traits_type::to_char_type(c));
+      check_size();
+    }
+    return traits_type::not_eof(c);
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize n) override
+  {
+    content_.append(s, n);
+    check_size();
+    return n;
+  }
+
+private:
+  void check_size()
+  {
+    if (content_.size() < chunk_size_) return;
+    if (!streaming_)
+    {
+      streaming_ = true;
+      write("HTTP/1.1 200 OK\r\n"
+            "Content-Type: " + mime_types::extension_to_type("html") + "\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "Connection: " + std::string(keep_alive_ ? "keep-alive" : "close") + "\r\n\r\n");
+    }
+    send_chunk();
+  }
+
+  void send_chunk()
+  {
+    if (content_.empty()) return;
+    std::stringstream size;
+    size << std::hex << content_.size() << "\r\n";
+    write(size.str());
+    write(content_);
+    write("\r\n");
+    content_.clear();
+  }
+
+  void write(const std::string& data)
+  {
+    if (failed_) return;
+    boost::system::error_code ec;
+    boost::asio::write(socket_, boost::asio::buffer(data), ec);
+    if (ec) failed_ = true;
+  }
+
+  boost::asio::ip::tcp::socket& socket_;
+  std::size_t chunk_size_;
+  bool keep_alive_;
+  bool streaming_;
+  bool failed_;
+  std::string content_;
+};
+
+} // namespace
+
 connection::connection(boost::asio::ip::tcp::socket socket,
-    connection_manager& manager, request_handler& handler)
+    connection_manager& manager, request_handler& handler,
+    boost::asio::thread_pool& hook_pool,
+    const connection_options& options)
   : socket_(std::move(socket)),
     connection_manager_(manager),
-    request_handler_(handler)
+    request_handler_(handler),
+    hook_pool_(hook_pool),
+    idle_timer_(socket_.get_executor()),
+    hook_running_(false),
+    stream_ok_(false),
+    options_(options),
+    keep_alive_(false)
 {
 }
 
@@ -33,35 +160,32 @@ void connection::start()
 
 void connection::stop()
 {
+  idle_timer_.cancel();
+  if (hook_running_)
+  {
+    // A hook thread may be writing to the socket. Closing it underneath that
+    // thread is unsafe, so just shut it down. The write fails, and the socket
+    // is closed once the hook hands the connection back.
+    ::shutdown(socket_.native_handle(), SHUT_RDWR);
+    return;
+  }
   socket_.close();
 }
 
 void connection::do_read()
 {
+  start_idle_timer();
+
   auto self(shared_from_this());
   socket_.async_read_some(boost::asio::buffer(buffer_),
       [this, self](boost::system::error_code ec, std::size_t bytes_transferred)
       {
+        // The client is active. Disarm until the next read starts
+        idle_timer_.expires_at(boost::asio::steady_timer::time_point::max());
+
         if (!ec)
         {
-          request_parser::result_type result;
-          std::tie(result, std::ignore) = request_parser_.parse(
-              request_, buffer_.data(), buffer_.data() + bytes_transferred);
-
-          if (result == request_parser::good)
-          {
-            request_handler_.handle_request(request_, reply_);
-            do_write();
-          }
-          else if (result == request_parser::bad)
-          {
-            reply_ = reply::stock_reply(reply::bad_request);
-            do_write();
-          }
-          else
-          {
-            do_read();
-          }
+          handle_data(buffer_.data(), buffer_.data() + bytes_transferred);
         }
         else if (ec != boost::asio::error::operation_aborted)
         {
@@ -70,12 +194,164 @@ void connection::do_read()
       });
 }
 
+void connection::start_idle_timer()
+{
+  if (options_.idle_timeout_ms == 0) return;
+
+  idle_timer_.expires_after(std::chrono::milliseconds(options_.idle_timeout_ms));
+  auto self(shared_from_this());
+  idle_timer_.async_wait(
+      [this, self](boost::system::error_code ec)
+      {
+        // A read that finished moves the expiry into the future, so a wait
+        // that was already queued when it finished is ignored here
+        if (ec || !socket_.is_open() ||
+            (idle_timer_.expiry() > boost::asio::steady_timer::clock_type::now()))
+        {
+          return;
+        }
+        connection_manager_.stop(shared_from_this());
+      });
+}
+
+void connection::handle_data(const char* begin, const char* end)
+{
+  request_parser::result_type result;
+  const char* rest;
+  std::tie(result, rest) = request_parser_.parse(request_, begin, end);
+
+  if (result == request_parser::good)
+  {
+    pending_.assign(rest, end);
+    keep_alive_ = options_.keep_alive && wants_keep_alive(request_);
+    handle_request();
+  }
+  else if (result == request_parser::bad)
+  {
+    keep_alive_ = false;
+    reply_ = reply::stock_reply(reply::bad_request);
+    do_write();
+  }
+  else
+  {
+    do_read();
+  }
+}
+
+void connection::handle_request()
+{
+  request_handler::hook_ptr hook;
+  std::map<std::string, std::string> args;
+  if (!request_handler_.find_hook(request_, reply_, &hook, &args))
+  {
+    do_write(); // reply_ holds the error
+    return;
+  }
+
+  // Hooks can be slow (eg, a large dump) and may block while streaming to a
+  // slow client, so they run on the hook pool. The io thread keeps serving
+  // other connections in the meantime.
+  auto self(shared_from_this());
+  hook_running_ = true;
+  boost::asio::post(hook_pool_,
+      [this, self, hook, args]()
+      {
+        bool send_reply = run_hook(hook, args);
+        auto io_executor = socket_.get_executor();
+        hook_running_ = false;
+        boost::asio::post(io_executor,
+            [this, self, send_reply]()
+            {
+              hook_done(send_reply);
+            });
+      });
+}
+
+bool connection::run_hook(const request_handler::hook_ptr& hook,
+    const std::map<std::string, std::string>& args)
+{
+  // Only HTTP/1.1 clients understand chunked replies
+  bool can_chunk = (options_.chunk_size > 0) &&
+                   ((request_.http_version_major > 1) ||
+                    ((request_.http_version_major == 1) && (request_.http_version_minor >= 1)));
+  std::size_t chunk_size = (can_chunk) ? options_.chunk_size : std::string::npos;
+
+  // Point the hook's stringstream at a buffer that streams to the socket
+  chunk_streambuf buf(socket_, chunk_size, keep_alive_);
+  std::stringstream ss;
+  ss.std::ios::rdbuf(&buf);
+  try
+  {
+    request_handler_.run_hook(hook, args, ss);
+  }
+  catch (const std::exception&)
+  {
+    ss.std::ios::rdbuf(nullptr);
+    if (buf.streaming())
+    {
+      stream_ok_ = false; // Headers already went out. All we can do is drop the connection
+      return false;
+    }
+    reply_ = reply::stock_reply(reply::internal_server_error);
+    return true;
+  }
+  ss.std::ios::rdbuf(nullptr);
+
+  if (!buf.streaming())
+  {
+    // Small reply. Send it normally
+    reply_.status = reply::ok;
+    reply_.content = std::move(buf.content());
+    reply_.headers.resize(2);
+    reply_.headers[0].name = "Content-Length";
+    reply_.headers[0].value = std::to_string(reply_.content.size());
+    reply_.headers[1].name = "Content-Type";
+    reply_.headers[1].value = mime_types::extension_to_type("html");
+    return true;
+  }
+
+  buf.finish();
+  stream_ok_ = !buf.failed();
+  return false;
+}
+
+void connection::hook_done(bool send_reply)
+{
+  if (!socket_.is_open())
+  {
+    return; // Stopped while the hook ran
+  }
+  if (send_reply)
+  {
+    do_write();
+    return;
+  }
+
+  // The hook streamed its reply
+  if (!stream_ok_ || !keep_alive_)
+  {
+    boost::system::error_code ignored_ec;
+    socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored_ec);
+    connection_manager_.stop(shared_from_this());
+    return;
+  }
+  next_request();
+}
+
 void connection::do_write()
 {
+  reply_.headers.push_back(header{"Connection", keep_alive_ ? "keep-alive" : "close"});
+
   auto self(shared_from_this());
   boost::asio::async_write(socket_, reply_.to_buffers(),
       [this, self](boost::system::error_code ec, std::size_t)
       {
+        if (!ec && keep_alive_)
+        {
+          next_request();
+          return;
+        }
+
         if (!ec)
         {
           // Initiate graceful connection closure.
@@ -91,5 +367,23 @@ void connection::do_write()
       });
 }
 
+void connection::next_request()
+{
+  request_ = request();
+  reply_ = reply();
+  request_parser_.reset();
+
+  if (pending_.empty())
+  {
+    do_read();
+  }
+  else
+  {
+    std::string data;
+    data.swap(pending_);
+    handle_data(data.data(), data.data() + data.size());
+  }
+}
+
 } // namespace server
 } // namespace http
@@ -12,6 +12,8 @@
 #define WHOOKIE_CONNECTION_HPP
 
 #include <array>
+#include <atomic>
+#include <map>
 #include <memory>
 #include <boost/asio.hpp>
 #include "whookie/server/boost/reply.hpp"
@@ -24,6 +26,19 @@ namespace server {
 
 class connection_manager;
 
+/// Settings that are shared by all connections.
+struct connection_options
+{
+  /// Keep a connection open for more requests after sending a reply.
+  bool keep_alive = true;
+
+  /// Stream replies larger than this many bytes as HTTP/1.1 chunks (0 disables).
+  std::size_t chunk_size = 64*1024;
+
+  /// Close a connection that waits this long for (the rest of) a request (0 disables).
+  std::size_t idle_timeout_ms = 30000;
+};
+
 /// Represents a single connection from a client.
 class connection
   : public std::enable_shared_from_this<connection>
@@ -32,9 +47,11 @@ public:
   connection(const connection&) = delete;
   connection& operator=(const connection&) = delete;
 
-  /// Construct a connection with the given socket.
+  /// Construct a connection with the given socket. Hooks run on hook_pool.
   explicit connection(boost::asio::ip::tcp::socket socket,
-      connection_manager& manager, request_handler& handler);
+      connection_manager& manager, request_handler& handler,
+      boost::asio::thread_pool& hook_pool,
+      const connection_options& options);
 
   /// Start the first asynchronous operation for the connection.
   void start();
@@ -46,9 +63,28 @@ private:
   /// Perform an asynchronous read operation.
   void do_read();
 
+  /// Close the connection if the read started by do_read() does not finish in time.
+  void start_idle_timer();
+
+  /// Parse incoming data and handle the request once it is complete.
+  void handle_data(const char* begin, const char* end);
+
+  /// Find the request's hook and hand it to the hook pool.
+  void handle_request();
+
+  /// Run a hook on a hook pool thread. Returns true if reply_ is ready to send.
+  bool run_hook(const request_handler::hook_ptr& hook,
+      const std::map<std::string, std::string>& args);
+
+  /// Back on the io thread, send the reply or finish a streamed one.
+  void hook_done(bool send_reply);
+
   /// Perform an asynchronous write operation.
   void do_write();
 
+  /// Reset for the next request on a keep-alive connection.
+  void next_request();
+
   /// Socket for the connection.
   boost::asio::ip::tcp::socket socket_;
 
@@ -58,6 +94,18 @@ private:
   /// The handler used to process the incoming request.
   request_handler& request_handler_;
 
+  /// Threads that run hooks, so a slow hook never stalls the io thread.
+  boost::asio::thread_pool& hook_pool_;
+
+  /// Expires when a connection has been waiting on its client for too long.
+  boost::asio::steady_timer idle_timer_;
+
+  /// Set while a hook owns the socket (it may be streaming chunks to it).
+  std::atomic<bool> hook_running_;
+
+  /// Whether the hook's streamed reply went out in full.
+  bool stream_ok_;
+
   /// Buffer for incoming data.
   std::array<char, 8192> buffer_;
 
@@ -69,6 +117,15 @@ private:
 
   /// The reply to be sent back to the client.
   reply reply_;
+
+  /// Settings shared by all connections.
+  const connection_options& options_;
+
+  /// Whether the connection stays open after the current reply.
+  bool keep_alive_;
+
+  /// Bytes that arrived after the current request (pipelined requests).
+  std::string pending_;
 };
 
 typedef std::shared_ptr<connection> connection_ptr;
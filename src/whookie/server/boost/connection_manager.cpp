@@ -20,19 +20,26 @@ connection_manager::connection_manager(){
 }
 
 void connection_manager::start(connection_ptr c){
+  connections_mutex_.lock();
   connections_.insert(c);
+  connections_mutex_.unlock();
   c->start();
 }
 
 void connection_manager::stop(connection_ptr c) {
+  connections_mutex_.lock();
   connections_.erase(c);
+  connections_mutex_.unlock();
   c->stop();
 }
 
 void connection_manager::stop_all() { 
-  for (auto c: connections_)
+  std::set<connection_ptr> connections;
+  connections_mutex_.lock();
+  connections.swap(connections_);
+  connections_mutex_.unlock();
+  for (auto c: connections)
     c->stop();
-  connections_.clear();
 }
 
 } // namespace server
@@ -11,6 +11,7 @@
 #ifndef WHOOKIE_CONNECTION_MANAGER_HPP
 #define WHOOKIE_CONNECTION_MANAGER_HPP
 
+#include <mutex>
 #include <set>
 #include "whookie/server/boost/connection.hpp"
 
@@ -40,6 +41,9 @@ public:
 private:
   /// The managed connections.
   std::set<connection_ptr> connections_;
+
+  /// Connections start and stop on different io_service threads.
+  std::mutex connections_mutex_;
 };
 
 } // namespace server
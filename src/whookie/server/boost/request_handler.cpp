@@ -28,7 +28,10 @@ using namespace std;
 namespace http {
 namespace server {
 
-
+namespace {
+/// The hook this thread is running, so a hook that deregisters itself does not wait on itself
+thread_local const request_handler::hook_entry *running_hook = nullptr;
+}
 
 
 request_handler::request_handler() {
@@ -50,6 +53,28 @@ request_handler::request_handler() {
 
 void request_handler::handle_request(const request& req, reply& rep) {
 
+  hook_ptr hook;
+  map<string,string> arg_map;
+  if(!find_hook(req, rep, &hook, &arg_map)) {
+    return;
+  }
+
+  stringstream ss;
+  run_hook(hook, arg_map, ss);
+  rep.content = ss.str();
+
+  // Fill out the reply to be sent to the client.
+  rep.status = reply::ok;
+  rep.headers.resize(2);
+  rep.headers[0].name = "Content-Length";
+  rep.headers[0].value = std::to_string(rep.content.size());
+  rep.headers[1].name = "Content-Type";
+  rep.headers[1].value = mime_types::extension_to_type("html");
+}
+
+bool request_handler::find_hook(const request& req, reply& rep,
+                                hook_ptr *hook, map<string,string> *args) {
+
   //  cout << "Request is method:"<<req.method<<"\n"
   //     << "              uri:"<<req.uri<<"\n"
   //     << "         versions:"<<req.http_version_major<<"/"<<req.http_version_minor<<"\n";
@@ -59,7 +84,7 @@ void request_handler::handle_request(const request& req, reply& rep) {
   string request_path;
   if (!url_decode(req.uri, request_path)) {
     rep = reply::stock_reply(reply::bad_request);
-    return;
+    return false;
   }
   //cout <<"Request path:"<<request_path<<"\n";
   
@@ -67,48 +92,62 @@ void request_handler::handle_request(const request& req, reply& rep) {
   if (request_path.empty() || request_path[0] != '/'
       || request_path.find("..") != string::npos) {
     rep = reply::stock_reply(reply::bad_request);
-    return;
+    return false;
   }
 
-  string extension; //What kind of result to make
-
-  
   size_t px=request_path.find('&');
   string tag=request_path.substr(0,px);
-  string args="";
+  string arg_string="";
   if(!((px==string::npos)||(px==request_path.size()))){
-    args = request_path.substr(px+1);
+    arg_string = request_path.substr(px+1);
   }
 
-  map<string,string> arg_map = parseArgString(args);
-
-  //cout<<"Tag is '"<<tag<<"' args are '"<<args<<"'\n";
-  //for(auto &k_v : arg_map){
-  //  cout <<"Key: "<<k_v.first<<" val: "<<k_v.second<<endl;
-  //}
+  *args = parseArgString(arg_string);
 
+  //cout<<"Tag is '"<<tag<<"' args are '"<<arg_string<<"'\n";
 
+  //Hand back the hook so it can run without holding the lock. This lets hooks
+  //run in parallel and keeps a slow hook from blocking registrations. The
+  //in-flight count keeps deregisterHook from returning while it runs.
   cbs_mutex.lock();
   auto name_func = cbs.find(tag);
-  if(name_func==cbs.end()){
-    cbs_mutex.unlock();
-    rep.status = reply::not_found;
-    return;
-  } else {
-    stringstream ss;
-    name_func->second(arg_map, ss);
-    rep.content = ss.str();
-    extension="html";
+  bool found = (name_func != cbs.end());
+  if(found) {
+    *hook = name_func->second;
+    (*hook)->in_flight++;
   }
   cbs_mutex.unlock();
-    
-  // Fill out the reply to be sent to the client.
-  rep.status = reply::ok;
-  rep.headers.resize(2);
-  rep.headers[0].name = "Content-Length";
-  rep.headers[0].value = std::to_string(rep.content.size());
-  rep.headers[1].name = "Content-Type";
-  rep.headers[1].value = mime_types::extension_to_type(extension);
+
+  if(!found) {
+    rep = reply::stock_reply(reply::not_found);
+  }
+  return found;
+}
+
+void request_handler::run_hook(const hook_ptr &hook, const map<string,string> &args, stringstream &results) {
+
+  //Release the hook even if it throws
+  struct release_on_exit {
+    request_handler *rh;
+    const hook_ptr &hook;
+    const hook_entry *prev_running;
+    ~release_on_exit() {
+      running_hook = prev_running;
+      std::lock_guard<std::mutex> lock(rh->cbs_mutex);
+      hook->in_flight--;
+      rh->cbs_idle.notify_all();
+    }
+  } release{this, hook, running_hook};
+
+  running_hook = hook.get();
+  hook->func(args, results);
+}
+
+/// Wait until no request is running a hook that was removed from cbs. The hook
+/// may capture an object that its owner is about to destroy.
+void request_handler::wait_until_idle(std::unique_lock<std::mutex> &lock, const hook_ptr &hook) {
+  int self = (running_hook == hook.get()) ? 1 : 0; //A hook may deregister itself
+  cbs_idle.wait(lock, [&hook, self] { return hook->in_flight <= self; });
 }
 
 bool request_handler::url_decode(const string& in, string& out) {
@@ -144,7 +183,8 @@ int request_handler::registerHook(const string &name, whookie::cb_web_handler_t
   cbs_mutex.lock();
   auto fptr = cbs.find(name);
   if(fptr == cbs.end()){
-    cbs[name] = func;
+    cbs[name] = std::make_shared<hook_entry>();
+    cbs[name]->func = func;
   } else {
     cout <<"Whookie: RegisterHandler detected double register of function '"<<name<<"'. Skipping.\n";
     rc=-1;
@@ -156,20 +196,28 @@ int request_handler::registerHook(const string &name, whookie::cb_web_handler_t
 int request_handler::updateHook(const string &name, whookie::cb_web_handler_t func){
 
   int rc=0;
-  cbs_mutex.lock();
-  //auto fptr = cbs.find(name);
-  cbs[name] = func;
-  cbs_mutex.unlock();
+  auto hook = std::make_shared<hook_entry>();
+  hook->func = func;
+  std::unique_lock<std::mutex> lock(cbs_mutex);
+  hook_ptr old_hook;
+  auto fptr = cbs.find(name);
+  if(fptr != cbs.end()) old_hook = fptr->second;
+  cbs[name] = hook;
+  if(old_hook) wait_until_idle(lock, old_hook);
   return rc;
-  
+
 }
 
 
+/// Remove a hook. Blocks until requests that are already running it finish.
 int request_handler::deregisterHook(const string &name){
-  cbs_mutex.lock();
-  int num=cbs.erase(name);
-  cbs_mutex.unlock();
-  return (num==0) ? -1 : 0;
+  std::unique_lock<std::mutex> lock(cbs_mutex);
+  auto fptr = cbs.find(name);
+  if(fptr == cbs.end()) return -1;
+  hook_ptr hook = fptr->second;
+  cbs.erase(fptr);
+  wait_until_idle(lock, hook);
+  return 0;
 }
 
 void request_handler::dumpRegisteredHandles(const map<string,string> &args, stringstream &results) {
@@ -177,9 +225,11 @@ void request_handler::dumpRegisteredHandles(const map<string,string> &args, stri
   faodel::ReplyStream rs(args, app_name+" Whookie", &results);
 
   vector<string> links;
+  cbs_mutex.lock();
   for(auto &name_hdlr : cbs) {
     links.push_back( rs.createLink(name_hdlr.first, name_hdlr.first));
   }
+  cbs_mutex.unlock();
   rs.mkSection(app_name,1);
   rs.mkText("The following hooks are known to this application:");
   rs.mkList(links);
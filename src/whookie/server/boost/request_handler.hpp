@@ -13,7 +13,9 @@
 
 #include <string>
 #include <map>
+#include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 
 #include "whookie/Server.hh"
@@ -36,9 +38,27 @@ public:
   /// Construct with a directory containing files to be served.
   explicit request_handler();
 
+  /// A registered hook. in_flight counts the requests running it, so
+  /// deregistration can wait until none are left.
+  struct hook_entry
+  {
+    whookie::cb_web_handler_t func;
+    int in_flight = 0;
+  };
+  typedef std::shared_ptr<hook_entry> hook_ptr;
+
   /// Handle a request and produce a reply.
   void handle_request(const request& req, reply& rep);
 
+  /// Find the hook for a request. On failure, rep holds the error reply.
+  /// On success the hook is marked in flight and must be passed to run_hook.
+  bool find_hook(const request& req, reply& rep,
+                 hook_ptr *hook, std::map<std::string,std::string> *args);
+
+  /// Run a hook returned by find_hook and mark it as no longer in flight.
+  void run_hook(const hook_ptr &hook, const std::map<std::string,std::string> &args,
+                std::stringstream &results);
+
   //CDU
   int updateAppName(std::string name) { app_name=name; return 0; }
   int registerHook(const std::string &name, whookie::cb_web_handler_t func);
@@ -55,8 +75,11 @@ private:
   /// invalid.
   static bool url_decode(const std::string& in, std::string& out);
 
-  std::map<std::string, whookie::cb_web_handler_t> cbs;
+  std::map<std::string, hook_ptr> cbs;
   std::mutex cbs_mutex;
+  std::condition_variable cbs_idle; //Signalled when a hook finishes running
+
+  void wait_until_idle(std::unique_lock<std::mutex> &lock, const hook_ptr &hook);
 
   std::pair<std::string,std::string> splitString(const std::string &item, char delim);
   std::map<std::string,std::string> parseArgString(const std::string &args);
@@ -31,7 +31,8 @@ server::server()
   : LoggingInterface("whookie"),
     configured_(false),
     port_(0),
-    num_starters_(0) {
+    num_starters_(0),
+    num_hook_threads_(2) {
 
   //faodel::bootstrap::RegisterComponent(this);
 
@@ -49,6 +50,8 @@ server::~server(){
 void server::InitAndModifyConfiguration(faodel::Configuration *config){
 
   int64_t port;
+  uint64_t num_threads, chunk_size, idle_timeout_ms;
+  bool keep_alive;
   string interfaces;
   string address;
   string interface_address("");
@@ -59,6 +62,10 @@ void server::InitAndModifyConfiguration(faodel::Configuration *config){
   config->GetInt(&port,                   "whookie.port",       "1990");
   config->GetLowercaseString(&address,    "whookie.address",    "0.0.0.0");
   config->GetLowercaseString(&interfaces, "whookie.interfaces", "eth,lo");
+  config->GetUInt(&num_threads,           "whookie.threads",    "2");
+  config->GetBool(&keep_alive,            "whookie.keep_alive", "true");
+  config->GetUInt(&chunk_size,            "whookie.chunk_size", "64K");
+  config->GetUInt(&idle_timeout_ms,       "whookie.idle_timeout_ms", "30000");
 
   /*
    * How whookie finds an address to bind to:
@@ -77,10 +84,12 @@ void server::InitAndModifyConfiguration(faodel::Configuration *config){
   requested_address = address;
   requested_port = port;
 
-  //config.GetAllSettings(&config_entries); //Copy all of the config settings for display
-  bootstrap_config_ptr = config; //Get a reference back to bootstrap
+  num_hook_threads_ = (num_threads>0) ? num_threads : 1;
 
-  asio_ = new asio_resources();
+  asio_ = new asio_resources(num_hook_threads_);
+  asio_->connection_options_.keep_alive = keep_alive;
+  asio_->connection_options_.chunk_size = chunk_size;
+  asio_->connection_options_.idle_timeout_ms = idle_timeout_ms;
   do_await_stop();
 
   whookie::Server::updateHook("/config", [this] (const map<string,string> &args, stringstream &results) {
@@ -116,7 +125,8 @@ void server::HandleWhookieConfig(const map<string,string> &args, stringstream &r
   rs.tableEnd();
 
   vector<pair<string,string>> config_entries;
-  bootstrap_config_ptr->GetAllSettings(&config_entries);
+  //Ask bootstrap each time: the config passed to Init may be a temporary copy
+  faodel::bootstrap::GetConfiguration().GetAllSettings(&config_entries);
 
   rs.mkTable(config_entries, "Current Configuration");
   rs.mkText(rs.createBold("Note:")+"These are the parameters provided to bootstrap. Some values "
@@ -204,6 +214,8 @@ int server::start(const std::string &address, unsigned int port){
   port_ = port;
   configured_mutex_.unlock();
 
+  //One thread does all the network io. Hooks run on the hook pool, so this
+  //thread never waits on a slow hook or a slow client
   th_http_server_ = std::thread(&http::server::server::run, this);
 
   my_nodeid = faodel::NodeID(this->address(), this->port());
@@ -284,7 +296,8 @@ void server::do_accept()
 
         if (!ec) {
           asio_->connection_manager_.start(std::make_shared<connection>(
-              std::move(asio_->socket_), asio_->connection_manager_, asio_->request_handler_));
+              std::move(asio_->socket_), asio_->connection_manager_, asio_->request_handler_,
+              asio_->hook_pool_, asio_->connection_options_));
         }
 
         do_accept();
@@ -314,8 +327,10 @@ int server::stop(){
       //cout << "Stopping whookie on port " << port_ << endl;
       do_await_stop(); //Kill all the connections
       asio_->io_service_.stop(); //Must manually stop
-      //cout << "Joining whookie thread " << th_http_server_.get_id() << endl;
       th_http_server_.join();
+      //Shut down connections so hooks that are streaming to them bail out, then let the hooks finish
+      asio_->connection_manager_.stop_all();
+      asio_->hook_pool_.join();
       delete asio_;
       configured_=false;
     }
@@ -15,6 +15,7 @@
 #include <string>
 #include <thread>
 #include <mutex>
+#include <vector>
 
 #include "whookie/server/boost/connection.hpp"
 #include "whookie/server/boost/connection_manager.hpp"
@@ -32,13 +33,14 @@ namespace server {
 
 class asio_resources {
 public:
-    asio_resources()
+    explicit asio_resources(unsigned int num_hook_threads)
     : io_service_(),
       signals_(io_service_),
       acceptor_(io_service_),
       connection_manager_(),
       socket_(io_service_),
-      request_handler_()
+      request_handler_(),
+      hook_pool_(num_hook_threads)
     {
     }
 public:
@@ -59,6 +61,13 @@ public:
 
     /// The handler for all incoming requests.
     request_handler request_handler_;
+
+    /// Settings shared by all connections.
+    connection_options connection_options_;
+
+    /// Threads that run hooks. Declared last so it is joined before the
+    /// connections its hooks use are torn down.
+    boost::asio::thread_pool hook_pool_;
 };
 
 /// The top-level class of the HTTP server.
@@ -120,7 +129,6 @@ private:
   faodel::nodeid_t my_nodeid = faodel::NODE_UNSPECIFIED;
   
   bool configured_;
-  faodel::Configuration *bootstrap_config_ptr;
 
   unsigned int port_;
   std::mutex configured_mutex_;
@@ -129,6 +137,7 @@ private:
   std::string app_name;
   std::string requested_address;
   unsigned int requested_port;
+  unsigned int num_hook_threads_;
   
   //Provide the configuration whookie was given
   void HandleWhookieConfig(const std::map<std::string,std::string> &args, std::stringstream &results);
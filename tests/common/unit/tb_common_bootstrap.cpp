@@ -6,8 +6,12 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 
 #include <mpi.h>
 
@@ -581,6 +585,120 @@ default.iom.path /this/is/path2
 }
 
 
+//Independent components should init/start at the same time when parallel bootstrap is on
+TEST_F(FaodelBootstrap, parallelIndependent) {
+
+  std::atomic<int> num_running(0);
+  std::atomic<int> max_running(0);
+  auto fn_slow = [&num_running, &max_running]() {
+    int now = ++num_running;
+    int prev = max_running.load();
+    while((now > prev) && !max_running.compare_exchange_weak(prev, now)) {}
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    num_running--;
+  };
+
+  for(auto name : {"a","b","c"}) {
+    bs->RegisterComponent(name, {}, {},
+                          [fn_slow](Configuration *conf) { fn_slow(); },
+                          [fn_slow]() { fn_slow(); },
+                          fn_fini_nop, true);
+  }
+  conf.Append("bootstrap.parallel.enable", "true");
+  conf.Append("bootstrap.parallel.threads", "3");
+
+  bs->Init(conf);
+  EXPECT_EQ(3, max_running.load());
+  max_running = 0;
+  bs->Start();
+  EXPECT_EQ(3, max_running.load());
+  bs->Finish(true);
+}
+
+//Dependencies must still finish before their dependents begin
+TEST_F(FaodelBootstrap, parallelDependencies) {
+
+  std::mutex m;
+  vector<string> order;
+  auto mk_init = [&m, &order](string name) {
+    return [&m, &order, name](Configuration *conf) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      std::lock_guard<std::mutex> lock(m);
+      order.push_back(name);
+    };
+  };
+  //Dependencies: c needs a and b, d needs b, e needs c and d
+  bs->RegisterComponent("e", {"c","d"}, {}, mk_init("e"), fn_start_nop, fn_fini_nop, true);
+  bs->RegisterComponent("d", {"b"},     {}, mk_init("d"), fn_start_nop, fn_fini_nop, true);
+  bs->RegisterComponent("c", {"a","b"}, {}, mk_init("c"), fn_start_nop, fn_fini_nop, true);
+  bs->RegisterComponent("b", {},        {}, mk_init("b"), fn_start_nop, fn_fini_nop, true);
+  bs->RegisterComponent("a", {},        {}, mk_init("a"), fn_start_nop, fn_fini_nop, true);
+
+  conf.Append("bootstrap.parallel.enable", "true");
+  bs->Start(conf);
+  bs->Finish(true);
+
+  ASSERT_EQ(5, order.size());
+  auto pos = [&order](string name) { return std::find(order.begin(), order.end(), name) - order.begin(); };
+  EXPECT_LT(pos("a"), pos("c"));
+  EXPECT_LT(pos("b"), pos("c"));
+  EXPECT_LT(pos("b"), pos("d"));
+  EXPECT_LT(pos("c"), pos("e"));
+  EXPECT_LT(pos("d"), pos("e"));
+}
+
+//Changes a component makes to its configuration are visible to its dependents
+TEST_F(FaodelBootstrap, parallelModifyConfiguration) {
+
+  string seen_by_c;
+  bs->RegisterComponent("a", {}, {},
+                        [](Configuration *conf) { conf->Set("a.runtime_value", "from_a"); conf->Unset("remove.me"); },
+                        fn_start_nop, fn_fini_nop, true);
+  bs->RegisterComponent("b", {}, {},
+                        [](Configuration *conf) { conf->Set("b.runtime_value", "from_b"); },
+                        fn_start_nop, fn_fini_nop, true);
+  bs->RegisterComponent("c", {"a","b"}, {},
+                        [&seen_by_c](Configuration *conf) {
+                          string a_val, b_val;
+                          conf->GetString(&a_val, "a.runtime_value");
+                          conf->GetString(&b_val, "b.runtime_value");
+                          seen_by_c = a_val + "," + b_val;
+                        },
+                        fn_start_nop, fn_fini_nop, true);
+
+  conf.Append("bootstrap.parallel.enable", "true");
+  conf.Append("remove.me", "please");
+  bs->Start(conf);
+
+  EXPECT_EQ("from_a,from_b", seen_by_c);
+  auto final_conf = bs->GetConfiguration();
+  EXPECT_TRUE(final_conf.Contains("a.runtime_value"));
+  EXPECT_TRUE(final_conf.Contains("b.runtime_value"));
+  EXPECT_FALSE(final_conf.Contains("remove.me"));
+  bs->Finish(true);
+}
+
+//A failing component stops the launch of its dependents and is reported to the caller
+TEST_F(FaodelBootstrap, parallelFailure) {
+
+  bool c_ran = false;
+  bs->RegisterComponent("a", {}, {},
+                        [](Configuration *conf) { throw std::runtime_error("a failed"); },
+                        fn_start_nop, fn_fini_nop, true);
+  bs->RegisterComponent("b", {}, {}, fn_init_nop, fn_start_nop, fn_fini_nop, true);
+  bs->RegisterComponent("c", {"a"}, {},
+                        [&c_ran](Configuration *conf) { c_ran = true; },
+                        fn_start_nop, fn_fini_nop, true);
+
+  conf.Append("bootstrap.parallel.enable", "true");
+  conf.Append("bootstrap.exit_on_errors", "false");
+  EXPECT_THROW(bs->Init(conf), std::runtime_error);
+  EXPECT_FALSE(c_ran);
+}
+
+
+
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -41,6 +41,25 @@ public:
 
 };
 
+//Counts how many times a log message actually gets built
+class Lazy
+  : public LoggingInterface {
+
+public:
+  Lazy(Configuration config)
+    : LoggingInterface("lazy"), num_built(0) {
+    ConfigureLogging(config);
+  }
+  void dump(){
+    dbg([this]() { num_built++; return string("Debug lambda"); });
+    info([this]() { num_built++; return string("Info lambda"); });
+    F_LOG_DBG(build("Debug macro"));
+    F_LOG_INFO(build("Info macro"));
+  }
+  string build(const string &s) { num_built++; return s; }
+  int num_built;
+};
+
 class Child
   : public Base {
 
@@ -98,3 +117,21 @@ TEST_F(FaodelLoggingInterface, childNone) {
 }
 
 
+
+
+TEST_F(FaodelLoggingInterface, lazyDisabled) {
+  Lazy l(Configuration("lazy.log.debug false"));
+  l.dump();
+  EXPECT_EQ(0, l.num_built);
+}
+
+TEST_F(FaodelLoggingInterface, lazyEnabled) {
+  Lazy l(Configuration("lazy.log.debug true\nlazy.log.info true"));
+  l.dump();
+  int expected = 0;
+  if(Faodel_LOGGINGINTERFACE_DISABLED==0) {
+    if(Faodel_LOGGINGINTERFACE_MIN_LEVEL<=0) expected+=2;
+    if(Faodel_LOGGINGINTERFACE_MIN_LEVEL<=1) expected+=2;
+  }
+  EXPECT_EQ(expected, l.num_built);
+}
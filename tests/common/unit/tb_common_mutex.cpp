@@ -443,6 +443,88 @@ TEST(Mutex, NoConflictThreadedRW) {
 
 
 
+TEST(Mutex, TypeIDs) {
+
+  EXPECT_EQ(MutexWrapperTypeID::NONE, GetMutexTypeID("none"));
+  #ifdef Faodel_THREADING_MODEL_PTHREADS
+  EXPECT_EQ(MutexWrapperTypeID::PTHREADS_LOCK,   GetMutexTypeID("pthreads", "lock"));
+  EXPECT_EQ(MutexWrapperTypeID::PTHREADS_RWLOCK, GetMutexTypeID("pthreads", "rwlock"));
+  EXPECT_EQ(MutexWrapperTypeID::ADAPTIVE_LOCK,   GetMutexTypeID("pthreads", "adaptive"));
+  EXPECT_EQ(MutexWrapperTypeID::TICKET_LOCK,     GetMutexTypeID("default",  "ticket"));
+  EXPECT_EQ(MutexWrapperTypeID::RB_RWLOCK,       GetMutexTypeID("pthreads", "rbrwlock"));
+
+  //Names should round trip through to_string and match the generated mutex
+  vector<MutexWrapperTypeID> ids = { MutexWrapperTypeID::PTHREADS_LOCK, MutexWrapperTypeID::PTHREADS_RWLOCK,
+                                     MutexWrapperTypeID::ADAPTIVE_LOCK, MutexWrapperTypeID::TICKET_LOCK,
+                                     MutexWrapperTypeID::RB_RWLOCK };
+  for(auto id : ids) {
+    MutexWrapper *m = GenerateMutexByTypeID(id);
+    EXPECT_EQ(id, m->GetTypeID());
+    EXPECT_EQ(to_string(id), m->GetType());
+    delete m;
+  }
+  #endif
+}
+
+#ifdef Faodel_THREADING_MODEL_PTHREADS
+TEST(Mutex, LightweightBurnThreaded) {
+
+  uint64_t num_threads=8;
+  for(string mutex_type : { "adaptive", "ticket", "rbrwlock" }) {
+
+    uint64_t count=0;
+    args_t args;
+    args.iterations = 20000;
+    args.count = &count;
+    args.mutex = faodel::GenerateMutex("pthreads", mutex_type);
+    EXPECT_EQ("pthreads-"+mutex_type, args.mutex->GetType());
+
+    pthread_t threads[num_threads];
+    void *status=NULL;
+    for(uint64_t i=0; i<num_threads; i++)
+      pthread_create(&threads[i], 0, th_burn, (void *)&args);
+    for(uint64_t i=0; i<num_threads; i++)
+      pthread_join(threads[i], &status);
+
+    EXPECT_EQ(num_threads*args.iterations, count) << "Lost updates with "<<mutex_type;
+    delete args.mutex;
+  }
+}
+
+TEST(Mutex, ReaderBiasedRW) {
+
+  uint64_t num_threads=8;
+  uint64_t count=0;
+  map<int,int> rw_map;
+
+  args_t args;
+  args.iterations = 20000;
+  args.count = &count;
+  args.rw_ratio = 5.0;
+  args.rw_map = &rw_map;
+  args.bad_count = 0;
+  args.mutex = faodel::GenerateMutex("pthreads","rbrwlock");
+
+  args_t args_array[num_threads];
+  pthread_t threads[num_threads];
+  void *status=NULL;
+  for(uint64_t i=0; i<num_threads; i++) {
+    args_array[i] = args;
+    args_array[i].id = i;
+    pthread_create(&threads[i], 0, th_burnRW, (void *)&args_array[i]);
+  }
+  for(uint64_t i=0; i<num_threads; i++)
+    pthread_join(threads[i], &status);
+
+  for(uint64_t i=0;i<num_threads; i++) {
+    EXPECT_EQ(0, args_array[i].bad_count);
+  }
+  delete args.mutex;
+}
+#endif
+
+
+
 //=============================================================================
 int main(int argc, char **argv) {
 
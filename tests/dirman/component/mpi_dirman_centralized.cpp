@@ -7,6 +7,10 @@
 //  Purpose: Test our ability to use central store for resource info
 
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <mpi.h>
 
 #include "gtest/gtest.h"
@@ -38,6 +42,9 @@ dirman.resources_mpi[] dht:/static/all&info="EVERYONE" ALL
 dirman.resources_mpi[] dht:/static/node0&info="Node0"  0
 dirman.resources_mpi[] dht:/static/root_node&info="RootNode"  LAST
 
+# Expire cached entries quickly and remember misses
+dirman.cache.lease_ttl_ms    1000
+dirman.cache.negative_ttl_ms 60000
 
 
 #bootstrap.debug true
@@ -106,6 +113,104 @@ TEST_F(DirManCentralized, Simple){
 
 }
 
+TEST_F(DirManCentralized, Batch){
+
+  bool ok;
+  vector<DirectoryInfo> dir_infos;
+
+  vector<ResourceURL> urls = { ResourceURL("/batch/one"), ResourceURL("/batch/two"), ResourceURL("/batch/three") };
+
+  //Nothing exists yet. Root should report all misses
+  ok = dirman::GetDirectoryInfo(urls, &dir_infos); EXPECT_FALSE(ok);
+  ASSERT_EQ(3, dir_infos.size());
+  for(auto &di : dir_infos)
+    EXPECT_TRUE(di.IsEmpty());
+
+  //Create two of them
+  ok = dirman::HostNewDir(DirectoryInfo("/batch/one&info=One")); EXPECT_TRUE(ok);
+  ok = dirman::HostNewDir(DirectoryInfo("/batch/two&info=Two")); EXPECT_TRUE(ok);
+
+  //Wait for the local copies' leases to expire so the lookup has to go to root
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  dir_infos.clear();
+  ok = dirman::GetLocalDirectoryInfo(urls, &dir_infos); EXPECT_FALSE(ok);
+  ASSERT_EQ(3, dir_infos.size());
+  EXPECT_TRUE(dir_infos[0].IsEmpty());
+
+  dir_infos.clear();
+  ok = dirman::GetDirectoryInfo(urls, &dir_infos); EXPECT_FALSE(ok);
+  ASSERT_EQ(3, dir_infos.size());
+  EXPECT_EQ("One", dir_infos[0].info);
+  EXPECT_EQ("Two", dir_infos[1].info);
+  EXPECT_TRUE(dir_infos[2].IsEmpty());
+
+  //Results from root are now cached locally
+  dir_infos.clear();
+  ok = dirman::GetLocalDirectoryInfo(vector<ResourceURL>(urls.begin(), urls.begin()+2), &dir_infos); EXPECT_TRUE(ok);
+  EXPECT_EQ(2, dir_infos.size());
+
+  //A resource this node creates is no longer treated as missing
+  ok = dirman::HostNewDir(DirectoryInfo("/batch/three&info=Three")); EXPECT_TRUE(ok);
+  dir_infos.clear();
+  ok = dirman::GetDirectoryInfo(urls, &dir_infos); EXPECT_TRUE(ok);
+  ASSERT_EQ(3, dir_infos.size());
+  EXPECT_EQ("Three", dir_infos[2].info);
+}
+
+TEST_F(DirManCentralized, Watch){
+
+  bool ok;
+  DirectoryInfo dir_info;
+
+  //Collect changes as root pushes them to us
+  mutex m;
+  condition_variable cv;
+  vector<dirman::DirectoryChange> changes;
+  auto waitForChanges = [&](size_t num) {
+    unique_lock<mutex> lk(m);
+    return cv.wait_for(lk, chrono::seconds(5), [&]() { return changes.size() >= num; });
+  };
+
+  ok = dirman::HostNewDir(DirectoryInfo("/watch/pool&info=Pool")); EXPECT_TRUE(ok);
+  ok = dirman::Watch(ResourceURL("/watch/pool"), [&](const dirman::DirectoryChange &change) {
+    lock_guard<mutex> lk(m);
+    changes.push_back(change);
+    cv.notify_all();
+  });
+  EXPECT_TRUE(ok);
+
+  ok = dirman::JoinDirWithName(ResourceURL("/watch/pool"), "first", &dir_info); EXPECT_TRUE(ok);
+  ASSERT_TRUE(waitForChanges(1));
+  EXPECT_EQ(dirman::DirectoryChange::Type::Joined, changes[0].type);
+  EXPECT_EQ("/watch/pool", changes[0].url.GetPathName());
+  EXPECT_EQ("first", changes[0].member.name);
+
+  ok = dirman::JoinDirWithName(ResourceURL("/watch/pool"), "second", &dir_info); EXPECT_TRUE(ok);
+  ASSERT_TRUE(waitForChanges(2));
+  EXPECT_EQ("second", changes[1].member.name);
+
+  ok = dirman::LeaveDir(ResourceURL("/watch/pool/first"), &dir_info); EXPECT_TRUE(ok);
+  ASSERT_TRUE(waitForChanges(3));
+  EXPECT_EQ(dirman::DirectoryChange::Type::Left, changes[2].type);
+  EXPECT_EQ("first", changes[2].member.name);
+
+  //Our cached copy tracks the changes
+  ok = dirman::GetLocalDirectoryInfo(ResourceURL("/watch/pool"), &dir_info); EXPECT_TRUE(ok);
+  ASSERT_EQ(1, dir_info.members.size());
+  EXPECT_EQ("second", dir_info.members[0].name);
+
+  ok = dirman::DropDir(ResourceURL("/watch/pool")); EXPECT_TRUE(ok);
+  ASSERT_TRUE(waitForChanges(4));
+  EXPECT_EQ(dirman::DirectoryChange::Type::Dropped, changes[3].type);
+
+  //No more changes after unwatching
+  ok = dirman::Unwatch(ResourceURL("/watch/pool")); EXPECT_TRUE(ok);
+  ok = dirman::Unwatch(ResourceURL("/watch/pool")); EXPECT_FALSE(ok);
+  ok = dirman::HostNewDir(DirectoryInfo("/watch/pool&info=Pool")); EXPECT_TRUE(ok);
+  ok = dirman::JoinDirWithName(ResourceURL("/watch/pool"), "third", &dir_info); EXPECT_TRUE(ok);
+  EXPECT_FALSE(waitForChanges(5));
+}
+
 void targetLoop(){
   //G.dump();
 }
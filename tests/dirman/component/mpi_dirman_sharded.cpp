@@ -0,0 +1,238 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+//
+//  Test: mpi_dirman_sharded
+//  Purpose: Test our ability to spread resource info across several dirman servers
+
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <mpi.h>
+
+#include "gtest/gtest.h"
+
+#include "faodel-common/Common.hh"
+#include "faodel-services/MPISyncStart.hh"
+#include "opbox/OpBox.hh"
+#include "dirman/DirMan.hh"
+
+using namespace std;
+using namespace faodel;
+
+
+
+
+string default_config_string = R"EOF(
+
+# Use mpi sync start to make it easier to plug in info
+mpisyncstart.enable true
+
+# Every rank is a server. Everything under /hot lives on all of them
+dirman.type               sharded
+dirman.sharded.nodes_mpi  ALL
+dirman.sharded.hot_paths  /hot
+dirman.sharded.hot_replicas 3
+
+# Plug in some static resources that mpisyncstart can resolve at boot
+dirman.resources_mpi[] dht:/static/all&info="EVERYONE" ALL
+dirman.resources_mpi[] dht:/static/node0&info="Node0"  0
+
+
+#bootstrap.debug true
+#whookie.debug true
+#opbox.debug true
+#dirman.debug true
+
+)EOF";
+
+int mpi_size;
+
+
+class DirManSharded : public testing::Test {
+protected:
+  virtual void SetUp(){  }
+  virtual void TearDown(){  }
+};
+
+TEST_F(DirManSharded, Locate){
+
+  bool ok;
+  nodeid_t ref_node;
+  DirectoryInfo dir_info;
+
+  //Every rank gets the static resources
+  ok = dirman::GetLocalDirectoryInfo(ResourceURL("ref:/static/all"), &dir_info); EXPECT_TRUE(ok);
+  EXPECT_EQ(mpi_size, dir_info.members.size());
+
+  //Entries should be spread over all the servers
+  set<nodeid_t> servers;
+  for(int i=0; i<64; i++) {
+    ok = dirman::Locate(ResourceURL("ref:/locate/item"+to_string(i)), &ref_node); EXPECT_TRUE(ok);
+    servers.insert(ref_node);
+  }
+  EXPECT_EQ(mpi_size, servers.size());
+
+  //Same url always goes to the same server
+  nodeid_t ref_node2;
+  dirman::Locate(ResourceURL("ref:/locate/item0"), &ref_node);
+  dirman::Locate(ResourceURL("ref:/locate/item0"), &ref_node2);
+  EXPECT_EQ(ref_node, ref_node2);
+}
+
+TEST_F(DirManSharded, HostJoinLeaveDrop){
+
+  bool ok;
+  DirectoryInfo dir_info;
+
+  //Create entries that land on different servers and read them back from the servers
+  for(int i=0; i<16; i++) {
+    string path = "/simple/dir"+to_string(i);
+    ok = dirman::HostNewDir(DirectoryInfo(path+"&info=Thing"+to_string(i))); EXPECT_TRUE(ok);
+    ok = dirman::GetRemoteDirectoryInfo(ResourceURL(path), &dir_info); EXPECT_TRUE(ok);
+    EXPECT_EQ("Thing"+to_string(i), dir_info.info);
+    EXPECT_EQ(0, dir_info.members.size());
+  }
+
+  //Missing items are reported as missing
+  ok = dirman::GetRemoteDirectoryInfo(ResourceURL("/simple/missing"), &dir_info); EXPECT_FALSE(ok);
+  EXPECT_TRUE(dir_info.IsEmpty());
+
+  //Join and leave go to the server that owns the parent
+  ok = dirman::HostNewDir(DirectoryInfo("/simple/pool&info=Pool")); EXPECT_TRUE(ok);
+  ok = dirman::JoinDirWithName(ResourceURL("/simple/pool"), "first", &dir_info); EXPECT_TRUE(ok);
+  EXPECT_EQ(1, dir_info.members.size());
+  ok = dirman::JoinDirWithName(ResourceURL("/simple/pool"), "second", &dir_info); EXPECT_TRUE(ok);
+  EXPECT_EQ(2, dir_info.members.size());
+  ok = dirman::GetRemoteDirectoryInfo(ResourceURL("/simple/pool"), &dir_info); EXPECT_TRUE(ok);
+  EXPECT_EQ(2, dir_info.members.size());
+  ok = dirman::LeaveDir(ResourceURL("/simple/pool/first"), &dir_info); EXPECT_TRUE(ok);
+  EXPECT_EQ(1, dir_info.members.size());
+
+  //Drop removes it from the server
+  ok = dirman::DropDir(ResourceURL("/simple/pool")); EXPECT_TRUE(ok);
+  ok = dirman::GetRemoteDirectoryInfo(ResourceURL("/simple/pool"), &dir_info); EXPECT_FALSE(ok);
+}
+
+TEST_F(DirManSharded, HotReplicas){
+
+  bool ok;
+  DirectoryInfo dir_info;
+
+  //Hot entries get pushed to every server, including this one
+  ok = dirman::HostNewDir(DirectoryInfo("/hot/pool&info=HotPool")); EXPECT_TRUE(ok);
+  ok = dirman::JoinDirWithName(ResourceURL("/hot/pool"), "member0", &dir_info); EXPECT_TRUE(ok);
+  EXPECT_EQ(1, dir_info.members.size());
+
+  //Pushes are asynchronous. Wait for them to land
+  for(int i=0; i<20; i++) {
+    ok = dirman::GetLocalDirectoryInfo(ResourceURL("/hot/pool"), &dir_info);
+    if(ok && (dir_info.members.size()==1)) break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  EXPECT_TRUE(ok);
+  EXPECT_EQ("HotPool", dir_info.info);
+  EXPECT_EQ(1, dir_info.members.size());
+
+  //Dropping a hot entry removes the copies too
+  ok = dirman::DropDir(ResourceURL("/hot/pool")); EXPECT_TRUE(ok);
+  for(int i=0; i<20; i++) {
+    ok = dirman::GetLocalDirectoryInfo(ResourceURL("/hot/pool"), &dir_info);
+    if(!ok) break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  EXPECT_FALSE(ok);
+}
+
+TEST_F(DirManSharded, Batch){
+
+  bool ok;
+  vector<DirectoryInfo> dir_infos;
+
+  vector<ResourceURL> urls;
+  for(int i=0; i<8; i++)
+    urls.push_back(ResourceURL("/batch/item"+to_string(i)));
+
+  //Nothing exists yet
+  ok = dirman::GetDirectoryInfo(urls, &dir_infos); EXPECT_FALSE(ok);
+  ASSERT_EQ(urls.size(), dir_infos.size());
+  for(auto &di : dir_infos)
+    EXPECT_TRUE(di.IsEmpty());
+
+  //Create half of them. The others stay missing
+  for(size_t i=0; i<urls.size(); i+=2) {
+    ok = dirman::HostNewDir(DirectoryInfo(urls[i].GetPathName()+"&info=Item"+to_string(i))); EXPECT_TRUE(ok);
+  }
+  dir_infos.clear();
+  ok = dirman::GetDirectoryInfo(urls, &dir_infos); EXPECT_FALSE(ok);
+  ASSERT_EQ(urls.size(), dir_infos.size());
+  for(size_t i=0; i<urls.size(); i++) {
+    if(i%2==0) EXPECT_EQ("Item"+to_string(i), dir_infos[i].info);
+    else       EXPECT_TRUE(dir_infos[i].IsEmpty());
+  }
+}
+
+TEST_F(DirManSharded, Watch){
+
+  bool ok;
+  atomic<int> num_joins(0);
+
+  //Watch entries owned by different servers. Each primary pushes its own changes
+  for(int i=0; i<8; i++) {
+    string path = "/watched/dir"+to_string(i);
+    ok = dirman::HostNewDir(DirectoryInfo(path)); EXPECT_TRUE(ok);
+    ok = dirman::Watch(ResourceURL(path), [&](const dirman::DirectoryChange &change) {
+      if(change.type == dirman::DirectoryChange::Type::Joined) num_joins++;
+    });
+    EXPECT_TRUE(ok);
+    ok = dirman::JoinDirWithName(ResourceURL(path), "member", nullptr); EXPECT_TRUE(ok);
+  }
+
+  for(int i=0; (i<100) && (num_joins<8); i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(8, num_joins);
+
+  for(int i=0; i<8; i++) {
+    ok = dirman::Unwatch(ResourceURL("/watched/dir"+to_string(i))); EXPECT_TRUE(ok);
+  }
+}
+
+void targetLoop(){
+}
+
+
+
+int main(int argc, char **argv){
+
+  int rc = 0;
+  int mpi_rank;
+  ::testing::InitGoogleTest(&argc, argv);
+
+  int provided;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+  MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+
+  mpisyncstart::bootstrap();
+
+  bootstrap::Start(faodel::Configuration(default_config_string), dirman::bootstrap);
+
+
+  //Split the work into two sections: the tester (node 0) and the servers
+  if(mpi_rank==0){
+    rc = RUN_ALL_TESTS();
+  } else {
+    targetLoop();
+  }
+
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  bootstrap::Finish();
+  MPI_Finalize();
+
+
+  return rc;
+}
@@ -7,6 +7,7 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <chrono>
 
 #include "gtest/gtest.h"
 
@@ -499,6 +500,67 @@ TEST_F(DirectoryCacheTest, JoinLeave) {
 
 }
 
+TEST_F(DirectoryCacheTest, LeasesAndMisses) {
+
+  ResourceURL url1(MakePathPair(nodeid_t(100,iuo),"/lease/one").second);
+  ResourceURL url2(MakePathPair(nodeid_t(101,iuo),"/lease/two").second);
+  ResourceURL url3(MakePathPair(nodeid_t(102,iuo),"/lease/three").second);
+
+  //Drive the cache's clock by hand instead of sleeping
+  auto now = std::chrono::steady_clock::now();
+  dc->SetClock(iuo, [&now]() { return now; });
+
+  //Entries written before leases are enabled never expire
+  EXPECT_TRUE(dc->Create(DirectoryInfo(url3)));
+
+  dc->SetLeaseTimes(500, 500);
+  EXPECT_TRUE(dc->Create(DirectoryInfo(url1)));
+  EXPECT_TRUE(dc->Lookup(url1));
+
+  //Remember a miss
+  EXPECT_FALSE(dc->IsKnownMissing(url2));
+  dc->MarkMissing(url2);
+  EXPECT_TRUE(dc->IsKnownMissing(url2));
+
+  //Let the lease and the miss expire
+  now += std::chrono::milliseconds(600);
+  EXPECT_FALSE(dc->Lookup(url1));
+  EXPECT_FALSE(dc->Lookup(vector<ResourceURL>{url1}));
+  EXPECT_FALSE(dc->IsKnownMissing(url2));
+  EXPECT_TRUE(dc->Lookup(url3));
+
+  //An update renews the lease
+  EXPECT_TRUE(dc->Update(DirectoryInfo(url1)));
+  EXPECT_TRUE(dc->Lookup(url1));
+
+  //Writing an entry clears its miss
+  dc->MarkMissing(url2);
+  EXPECT_TRUE(dc->IsKnownMissing(url2));
+  EXPECT_TRUE(dc->Create(DirectoryInfo(url2)));
+  EXPECT_FALSE(dc->IsKnownMissing(url2));
+  EXPECT_TRUE(dc->Lookup(url2));
+
+  //Expired entries and misses are eventually dropped, not just hidden
+  size_t num_before = dc->NumberOfResources();
+  for(int i=0; i<100; i++) {
+    EXPECT_TRUE(dc->Create(DirectoryInfo(ResourceURL(MakePathPair(nodeid_t(200,iuo),"/lease/e"+std::to_string(i)).second))));
+    dc->MarkMissing(ResourceURL(MakePathPair(nodeid_t(201,iuo),"/lease/m"+std::to_string(i)).second));
+  }
+  EXPECT_EQ(num_before+100, dc->NumberOfResources());
+  now += std::chrono::milliseconds(600);
+  for(int i=0; i<100; i++) {
+    dc->MarkMissing(ResourceURL(MakePathPair(nodeid_t(202,iuo),"/lease/n"+std::to_string(i)).second));
+  }
+  EXPECT_EQ(1, dc->NumberOfResources()); //Only url3, which has no lease
+  EXPECT_FALSE(dc->IsKnownMissing(ResourceURL(MakePathPair(nodeid_t(201,iuo),"/lease/m0").second)));
+  EXPECT_TRUE(dc->IsKnownMissing(ResourceURL(MakePathPair(nodeid_t(202,iuo),"/lease/n0").second)));
+
+  //Negative caching can be turned off
+  dc->SetLeaseTimes(0, 0);
+  dc->MarkMissing(ResourceURL(MakePathPair(nodeid_t(103,iuo),"/lease/four").second));
+  EXPECT_FALSE(dc->IsKnownMissing(ResourceURL(MakePathPair(nodeid_t(103,iuo),"/lease/four").second)));
+}
+
 TEST_F(DirectoryCacheTest, CreateAndLink ) {
 
   nodeid_t ref_node;
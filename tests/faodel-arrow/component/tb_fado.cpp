@@ -555,4 +555,215 @@ TEST_F(Fado, Wipe) {
       EXPECT_EQ(0, compareTables(t2, f1.ExtractTable(i).ValueOrDie()));
    }
 
-}
\ No newline at end of file
+}
+TEST_F(Fado, ExtractWithoutCopy) {
+
+   auto t1 = createParticleTable(64);
+   auto f1 = ArrowDataObject(t1);
+   auto ldo = f1.ExportDataObject();
+   auto *ldo_start = ldo.GetDataPtr<uint8_t *>();
+   auto *ldo_end   = ldo_start + ldo.GetDataSize();
+
+   auto tx = f1.ExtractTable(0).ValueOrDie();
+
+   //Column data should point into the ldo instead of a new allocation
+   auto data = tx->column(0)->chunk(0)->data()->buffers[1];
+   ASSERT_NE(nullptr, data);
+   EXPECT_GE(data->data(), ldo_start);
+   EXPECT_LT(data->data(), ldo_end);
+
+   //Table should hold a reference to the ldo, so it stays valid after the fado and ldo go away
+   auto refs_before = ldo.internal_use_only.GetRefCount();
+   EXPECT_GT(refs_before, 2); //ldo, f1, and the table
+   f1 = ArrowDataObject();
+   ldo = lunasa::DataObject();
+   EXPECT_EQ(0, compareTables(t1, tx));
+}
+
+TEST_F(Fado, ExtractAllTables) {
+
+   int num_tables=4;
+   auto t1 = createParticleTable(64);
+   vector<shared_ptr<arrow::Table>> tables;
+   for(int i=0; i<num_tables; i++)
+      tables.push_back(t1);
+
+   auto f1 = ArrowDataObject::Make(tables).ValueOrDie();
+   EXPECT_EQ(num_tables, f1.NumberOfTables());
+
+   auto tx = f1.ExtractAllTables().ValueOrDie();
+   EXPECT_EQ(num_tables*64, tx->num_rows());
+   EXPECT_EQ(t1->num_columns(), tx->num_columns());
+
+   //Each chunk becomes one piece of the combined table
+   auto expected_sums = sumTableColumns(t1);
+   auto sums = sumTableColumns(tx);
+   ASSERT_EQ(expected_sums.size(), sums.size());
+   for(size_t i=0; i<sums.size(); i++)
+      EXPECT_EQ(num_tables*expected_sums[i], sums[i]);
+
+   //Empty objects should report an error instead of an empty table
+   ArrowDataObject f2(1024);
+   EXPECT_FALSE(f2.ExtractAllTables().ok());
+}
+
+TEST_F(Fado, ColumnStats) {
+
+   //Build a table with a known range and a few nulls
+   arrow::Int64Builder builder_id;
+   arrow::DoubleBuilder builder_val;
+   arrow::StringBuilder builder_name;
+   for(int i=0; i<100; i++) {
+      EXPECT_TRUE(builder_id.Append(i+10).ok());
+      if(i%10==0) { EXPECT_TRUE(builder_val.AppendNull().ok()); }
+      else        { EXPECT_TRUE(builder_val.Append(i*0.5).ok()); }
+      EXPECT_TRUE(builder_name.Append("row").ok());
+   }
+   shared_ptr<arrow::Array> a_id, a_val, a_name;
+   EXPECT_TRUE(builder_id.Finish(&a_id).ok());
+   EXPECT_TRUE(builder_val.Finish(&a_val).ok());
+   EXPECT_TRUE(builder_name.Finish(&a_name).ok());
+   auto schema = arrow::schema({field("id", arrow::int64()), field("val", arrow::float64()), field("name", arrow::utf8())});
+   auto t1 = arrow::Table::Make(schema, {a_id, a_val, a_name});
+
+   auto f1 = ArrowDataObject::Make(t1).ValueOrDie();
+   EXPECT_EQ(2, f1.NumberOfColumnStats()); //Only numeric columns
+
+   ArrowDataObject::ColumnStats stats;
+   ASSERT_TRUE(f1.GetColumnStats(0, "id", &stats));
+   EXPECT_TRUE(stats.is_integer);
+   EXPECT_TRUE(stats.has_range);
+   EXPECT_EQ(10, stats.min_i);
+   EXPECT_EQ(109, stats.max_i);
+   EXPECT_EQ(0, stats.null_count);
+   EXPECT_EQ(100, stats.row_count);
+
+   ASSERT_TRUE(f1.GetColumnStats(0, "val", &stats));
+   EXPECT_FALSE(stats.is_integer);
+   EXPECT_DOUBLE_EQ(0.5, stats.min_d);
+   EXPECT_DOUBLE_EQ(49.5, stats.max_d);
+   EXPECT_EQ(10, stats.null_count);
+
+   EXPECT_FALSE(f1.GetColumnStats(0, "name", &stats));
+   EXPECT_FALSE(f1.GetColumnStats(1, "id", &stats));
+
+   //Appended chunks get their own entries, and copies keep them
+   ArrowDataObject f2(64*1024);
+   EXPECT_TRUE(f2.Append(t1).ok());
+   EXPECT_TRUE(f2.Append(t1->Slice(50)).ok());
+   ASSERT_TRUE(f2.GetColumnStats(1, "id", &stats));
+   EXPECT_EQ(60, stats.min_i);
+   EXPECT_EQ(50, stats.row_count);
+
+   auto f3 = ArrowDataObject::Make(vector<ArrowDataObject>{f1, f2}).ValueOrDie();
+   EXPECT_EQ(6, f3.NumberOfColumnStats());
+   ASSERT_TRUE(f3.GetColumnStats(2, "id", &stats));
+   EXPECT_EQ(60, stats.min_i);
+
+   //Object without room for stats still works, but has no zone map
+   ArrowDataObject f4(64*1024, 0);
+   EXPECT_TRUE(f4.Append(t1).ok());
+   EXPECT_EQ(0, f4.NumberOfColumnStats());
+   EXPECT_FALSE(f4.GetColumnStats(0, "id", &stats));
+   EXPECT_EQ(0, compareTables(t1, f4.ExtractTable(0).ValueOrDie()));
+}
+
+TEST_F(Fado, LegacyMetaLayout) {
+
+   //Objects written before zone maps only had num_chunks and object_status in their meta section
+   auto t1 = createParticleTable(64);
+   ArrowDataObject f1(t1);
+   auto src_ldo = f1.ExportDataObject();
+   const uint32_t old_meta_size = 2*sizeof(uint32_t);
+   lunasa::DataObject old_ldo(old_meta_size + src_ldo.GetDataSize(), old_meta_size, src_ldo.GetDataSize(),
+                              lunasa::DataObject::AllocatorType::eager, ArrowDataObject::object_type_id);
+   auto *old_meta = old_ldo.GetMetaPtr<uint32_t *>();
+   old_meta[0] = 1; //num_chunks
+   old_meta[1] = 7; //object_status
+   memcpy(old_ldo.GetDataPtr(), src_ldo.GetDataPtr(), src_ldo.GetDataSize());
+
+   ArrowDataObject f2(old_ldo);
+   ASSERT_TRUE(f2.Valid());
+   EXPECT_EQ(1, f2.NumberOfTables());
+   EXPECT_EQ(7, f2.GetObjectStatus());
+   EXPECT_EQ(0, f2.NumberOfColumnStats());
+   ArrowDataObject::ColumnStats stats;
+   EXPECT_FALSE(f2.GetColumnStats(0, "X", &stats));
+   EXPECT_EQ(0, compareTables(t1, f2.ExtractTable(0).ValueOrDie()));
+
+   //Old and new objects can be combined. Only the new chunks keep their stats
+   auto f3 = ArrowDataObject::Make(vector<ArrowDataObject>{f2, f1}).ValueOrDie();
+   EXPECT_EQ(2, f3.NumberOfTables());
+   EXPECT_FALSE(f3.GetColumnStats(0, "X", &stats));
+   EXPECT_TRUE(f3.GetColumnStats(1, "X", &stats));
+}
+
+TEST_F(Fado, ParallelEncode) {
+
+   //Use four threads, even on small tables
+   ArrowDataObject::SetThreadCount(4, 1000);
+
+   //Batches never cross the table's own chunks, so start with one big chunk
+   auto t1 = createParticleTable(10000)->CombineChunks().ValueOrDie();
+   vector<arrow::Compression::type> codecs = {arrow::Compression::UNCOMPRESSED, arrow::Compression::LZ4_FRAME, arrow::Compression::ZSTD};
+   for(auto codec : codecs) {
+      //The table is encoded as four record batches, but it's still a single chunk
+      ArrowDataObject f1(t1, codec);
+      ASSERT_TRUE(f1.Valid());
+      EXPECT_EQ(1, f1.NumberOfTables());
+      EXPECT_EQ(10000, f1.NumberOfRows());
+      EXPECT_TRUE(f1.dbgAllChunksValid());
+      EXPECT_EQ(t1->num_columns(), f1.NumberOfColumnStats());
+      auto tx = f1.ExtractTable(0).ValueOrDie();
+      EXPECT_EQ(4, tx->column(0)->num_chunks());
+      EXPECT_EQ(0, compareTables(t1, tx));
+
+      auto f2 = ArrowDataObject::Make(t1, codec).ValueOrDie();
+      EXPECT_EQ(0, compareTables(t1, f2.ExtractTable(0).ValueOrDie()));
+
+      ArrowDataObject f3(1024*1024);
+      EXPECT_TRUE(f3.Append(t1, codec).ok());
+      EXPECT_TRUE(f3.Append(t1, codec).ok());
+      EXPECT_EQ(2, f3.NumberOfTables());
+      EXPECT_EQ(0, compareTables(t1, f3.ExtractTable(1).ValueOrDie()));
+   }
+
+   //Merged tables share one chunk
+   auto t2 = createParticleTable(6000);
+   auto f4 = ArrowDataObject::MakeMerged({t1, t2}, arrow::Compression::LZ4_FRAME).ValueOrDie();
+   EXPECT_EQ(1, f4.NumberOfTables());
+   EXPECT_EQ(16000, f4.NumberOfRows());
+   ArrowDataObject::ColumnStats stats;
+   EXPECT_TRUE(f4.GetColumnStats(0, "Id", &stats));
+   EXPECT_EQ(16000, stats.row_count);
+
+   //All-or-nothing when the table doesn't fit
+   ArrowDataObject f5(1024);
+   auto status = f5.Append(t1);
+   EXPECT_TRUE(status.IsCapacityError());
+   EXPECT_EQ(0, f5.NumberOfTables());
+   EXPECT_EQ(0, f5.GetDataSize());
+
+   //One thread packs the table the same way as before
+   ArrowDataObject::SetThreadCount(1);
+   ArrowDataObject f6(t1, arrow::Compression::ZSTD);
+   auto t6 = f6.ExtractTable(0).ValueOrDie();
+   EXPECT_EQ(1, t6->column(0)->num_chunks());
+   EXPECT_EQ(0, compareTables(t1, t6));
+
+   ArrowDataObject::SetThreadCount(0);
+}
+
+TEST_F(Fado, ParallelDecode) {
+
+   auto t1 = createParticleTable(1000);
+   vector<shared_ptr<arrow::Table>> tables = {t1, t1, t1, t1};
+   auto f1 = ArrowDataObject::Make(tables, arrow::Compression::LZ4_FRAME).ValueOrDie();
+   EXPECT_EQ(4, f1.NumberOfTables());
+
+   //Parallel and serial decodes should both rebuild the same table
+   auto tx = f1.ExtractAllTables(arrow::ipc::IpcReadOptions::Defaults(), 4).ValueOrDie();
+   auto ty = f1.ExtractAllTables(arrow::ipc::IpcReadOptions::Defaults(), 1).ValueOrDie();
+   EXPECT_EQ(4000, tx->num_rows());
+   EXPECT_EQ(0, compareTables(tx, ty));
+}
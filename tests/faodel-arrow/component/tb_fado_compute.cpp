@@ -0,0 +1,182 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#include "gtest/gtest.h"
+
+#include "faodel-common/Common.hh"
+#include "lunasa/Lunasa.hh"
+#include "lunasa/DataObject.hh"
+#include "lunasa/common/Helpers.hh"
+
+#include "faodel-arrow/ArrowDataObject.hh"
+#include "faodel-arrow/ArrowComputeFunctions.hh"
+
+#include "support/ArrowHelpers.hh"
+
+using namespace std;
+using namespace faodel;
+
+string default_config_string = R"EOF(
+
+# Must use simple malloc for multiple start/stop tests
+lunasa.lazy_memory_manager malloc
+lunasa.eager_memory_manager malloc
+
+)EOF";
+
+
+class FadoCompute : public testing::Test {
+protected:
+   void SetUp() override {
+      bootstrap::Start(faodel::Configuration(default_config_string), lunasa::bootstrap);
+
+      //Two objects that a wildcard compute would hand to a function
+      t1 = createParticleTable(1000);
+      t2 = createParticleTable(500);
+      ldos[kelpie::Key("particles","a")] = ArrowDataObject(t1).ExportDataObject();
+      ldos[kelpie::Key("particles","b")] = ArrowDataObject(t2).ExportDataObject();
+   }
+
+   void TearDown() override {
+      ldos.clear();
+      bootstrap::FinishSoft();
+   }
+
+   //Count rows where the X column is above a threshold
+   static int64_t countX(const shared_ptr<arrow::Table> &table, float threshold) {
+      int64_t count = 0;
+      for(auto &chunk : table->GetColumnByName("X")->chunks()) {
+         auto xs = static_pointer_cast<arrow::FloatArray>(chunk);
+         for(int64_t i=0; i<xs->length(); i++)
+            if(xs->Value(i) > threshold) count++;
+      }
+      return count;
+   }
+
+   shared_ptr<arrow::Table> t1, t2;
+   map<kelpie::Key, lunasa::DataObject> ldos;
+};
+
+
+TEST_F(FadoCompute, Project) {
+   lunasa::DataObject ext_ldo;
+   auto rc = arrow_compute::fn_project(BUCKET_UNSPECIFIED, kelpie::Key("particles","*"), "X, Id", ldos, &ext_ldo);
+   ASSERT_EQ(kelpie::KELPIE_OK, rc);
+
+   ArrowDataObject result(ext_ldo);
+   ASSERT_EQ(2, result.NumberOfTables());
+   auto tx = result.ExtractTable(0).ValueOrDie();
+   EXPECT_EQ(2, tx->num_columns());
+   EXPECT_EQ("X",  tx->schema()->field(0)->name());
+   EXPECT_EQ("Id", tx->schema()->field(1)->name());
+   EXPECT_EQ(1000, tx->num_rows());
+   EXPECT_LT(ext_ldo.GetDataSize(), ldos.begin()->second.GetDataSize() + ldos.rbegin()->second.GetDataSize());
+
+   //Unknown columns are rejected
+   rc = arrow_compute::fn_project(BUCKET_UNSPECIFIED, kelpie::Key("particles","*"), "bogus", ldos, &ext_ldo);
+   EXPECT_EQ(kelpie::KELPIE_EINVAL, rc);
+}
+
+TEST_F(FadoCompute, Filter) {
+   lunasa::DataObject ext_ldo;
+   auto rc = arrow_compute::fn_filter(BUCKET_UNSPECIFIED, kelpie::Key("particles","*"), "X>0.5 && Id>=0", ldos, &ext_ldo);
+   ASSERT_EQ(kelpie::KELPIE_OK, rc);
+
+   ArrowDataObject result(ext_ldo);
+   ASSERT_EQ(2, result.NumberOfTables());
+   auto ta = result.ExtractTable(0).ValueOrDie();
+   auto tb = result.ExtractTable(1).ValueOrDie();
+   EXPECT_EQ(countX(t1, 0.5), ta->num_rows());
+   EXPECT_EQ(countX(t2, 0.5), tb->num_rows());
+   EXPECT_EQ(0, countX(ta, 1.0));
+   EXPECT_EQ(ta->num_rows(), countX(ta, 0.5)); //Every row passed the predicate
+
+   //Or clauses widen the result
+   rc = arrow_compute::fn_filter(BUCKET_UNSPECIFIED, kelpie::Key("particles","*"), "X>0.5 || X<=0.5", ldos, &ext_ldo);
+   ASSERT_EQ(kelpie::KELPIE_OK, rc);
+   EXPECT_EQ(1500, ArrowDataObject(ext_ldo).NumberOfRows());
+
+   //And binds tighter than or: this is X>0.5 || (Id<0 && X<0.5), not (X>0.5 || Id<0) && X<0.5
+   rc = arrow_compute::fn_filter(BUCKET_UNSPECIFIED, kelpie::Key("particles","*"), "X>0.5 || Id<0 && X<0.5", ldos, &ext_ldo);
+   ASSERT_EQ(kelpie::KELPIE_OK, rc);
+   EXPECT_EQ(countX(t1, 0.5) + countX(t2, 0.5), ArrowDataObject(ext_ldo).NumberOfRows());
+
+   //Parse problems
+   EXPECT_EQ(kelpie::KELPIE_EINVAL, arrow_compute::fn_filter(BUCKET_UNSPECIFIED, kelpie::Key("particles","*"), "X ~ 3", ldos, &ext_ldo));
+   EXPECT_EQ(kelpie::KELPIE_EINVAL, arrow_compute::fn_filter(BUCKET_UNSPECIFIED, kelpie::Key("particles","*"), "nope>3", ldos, &ext_ldo));
+}
+
+TEST_F(FadoCompute, FilterQuotedStrings) {
+   arrow::StringBuilder builder;
+   ASSERT_TRUE(builder.AppendValues({"a&&b", "c||d", "e<f", "g"}).ok());
+   auto names = builder.Finish().ValueOrDie();
+   auto table = arrow::Table::Make(arrow::schema({arrow::field("Name", arrow::utf8())}), {names});
+
+   map<kelpie::Key, lunasa::DataObject> name_ldos;
+   name_ldos[kelpie::Key("names","a")] = ArrowDataObject(table).ExportDataObject();
+
+   //Separators and operators inside quotes are part of the value
+   lunasa::DataObject ext_ldo;
+   auto rc = arrow_compute::fn_filter(BUCKET_UNSPECIFIED, kelpie::Key("names","*"), "Name=='a&&b' || Name==\"c||d\"", name_ldos, &ext_ldo);
+   ASSERT_EQ(kelpie::KELPIE_OK, rc);
+   EXPECT_EQ(2, ArrowDataObject(ext_ldo).NumberOfRows());
+
+   rc = arrow_compute::fn_filter(BUCKET_UNSPECIFIED, kelpie::Key("names","*"), "Name!='e<f'", name_ldos, &ext_ldo);
+   ASSERT_EQ(kelpie::KELPIE_OK, rc);
+   EXPECT_EQ(3, ArrowDataObject(ext_ldo).NumberOfRows());
+}
+
+TEST_F(FadoCompute, LimitAndSample) {
+   lunasa::DataObject ext_ldo;
+   auto rc = arrow_compute::fn_limit(BUCKET_UNSPECIFIED, kelpie::Key("particles","*"), "10", ldos, &ext_ldo);
+   ASSERT_EQ(kelpie::KELPIE_OK, rc);
+   EXPECT_EQ(20, ArrowDataObject(ext_ldo).NumberOfRows());
+
+   rc = arrow_compute::fn_sample(BUCKET_UNSPECIFIED, kelpie::Key("particles","*"), "0.1,42", ldos, &ext_ldo);
+   ASSERT_EQ(kelpie::KELPIE_OK, rc);
+   auto num_sampled = ArrowDataObject(ext_ldo).NumberOfRows();
+   EXPECT_GT(num_sampled, 50);
+   EXPECT_LT(num_sampled, 300);
+
+   //Same seed, same rows
+   lunasa::DataObject ext_ldo2;
+   rc = arrow_compute::fn_sample(BUCKET_UNSPECIFIED, kelpie::Key("particles","*"), "0.1,42", ldos, &ext_ldo2);
+   ASSERT_EQ(kelpie::KELPIE_OK, rc);
+   EXPECT_EQ(num_sampled, ArrowDataObject(ext_ldo2).NumberOfRows());
+
+   //Spaces around the fraction are ignored, like the seed
+   rc = arrow_compute::fn_sample(BUCKET_UNSPECIFIED, kelpie::Key("particles","*"), " 0.1 , 42", ldos, &ext_ldo2);
+   ASSERT_EQ(kelpie::KELPIE_OK, rc);
+   EXPECT_EQ(num_sampled, ArrowDataObject(ext_ldo2).NumberOfRows());
+
+   EXPECT_EQ(kelpie::KELPIE_EINVAL, arrow_compute::fn_sample(BUCKET_UNSPECIFIED, kelpie::Key("particles","*"), "2.0", ldos, &ext_ldo));
+}
+
+TEST_F(FadoCompute, NonArrowObjects) {
+   map<kelpie::Key, lunasa::DataObject> strings;
+   strings[kelpie::Key("s","1")] = lunasa::AllocateStringObject("not a table");
+   lunasa::DataObject ext_ldo;
+   EXPECT_EQ(kelpie::KELPIE_ENOENT, arrow_compute::fn_limit(BUCKET_UNSPECIFIED, kelpie::Key("s","*"), "10", strings, &ext_ldo));
+   EXPECT_EQ(kelpie::KELPIE_ENOENT, arrow_compute::fn_limit(BUCKET_UNSPECIFIED, kelpie::Key("s","*"), "10", {}, &ext_ldo));
+}
+
+TEST_F(FadoCompute, ZoneMapPruning) {
+
+   //Particle positions are in [0,1), so the zone maps rule these out
+   ArrowDataObject fa(ldos.begin()->second);
+   EXPECT_TRUE(arrow_compute::ChunkMayMatch(fa, 0, "X>0.5"));
+   EXPECT_FALSE(arrow_compute::ChunkMayMatch(fa, 0, "X>2"));
+   EXPECT_FALSE(arrow_compute::ChunkMayMatch(fa, 0, "X<0 && Y>0.5"));
+   EXPECT_TRUE(arrow_compute::ChunkMayMatch(fa, 0, "X<0 || Y>0.5"));
+   EXPECT_TRUE(arrow_compute::ChunkMayMatch(fa, 0, "unknown_column>2")); //No stats, must scan
+   EXPECT_FALSE(arrow_compute::ObjectMayMatch(fa, "Id<0"));
+
+   //Every chunk is pruned, so the result is empty but valid
+   lunasa::DataObject ext_ldo;
+   auto rc = arrow_compute::fn_filter(BUCKET_UNSPECIFIED, kelpie::Key("particles","*"), "X>2", ldos, &ext_ldo);
+   ASSERT_EQ(kelpie::KELPIE_OK, rc);
+   ArrowDataObject result(ext_ldo);
+   EXPECT_TRUE(result.Valid());
+   EXPECT_EQ(0, result.NumberOfTables());
+}
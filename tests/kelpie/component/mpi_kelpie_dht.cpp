@@ -21,6 +21,7 @@
 #include "kelpie/Kelpie.hh"
 
 #include "whookie/Server.hh"
+#include "whookie/client/Client.hh"
 
 #include "support/Globals.hh"
 
@@ -256,6 +257,63 @@ void checkWantUnbounded(kelpie::Pool dht, const vector<pair<kelpie::Key, lunasa:
 
 }
 
+void checkAtomics(kelpie::Pool dht, std::string key_prefix) {
+
+  kelpie::rc_t rc;
+  int64_t old_value;
+
+  //Counters start at zero and each add returns the value before it
+  vector<kelpie::Key> keys;
+  for(int i=0; i<8; i++)
+    keys.push_back(kelpie::Key(key_prefix, "counter"+to_string(i)));
+  for(int j=0; j<4; j++) {
+    for(int i=0; i<static_cast<int>(keys.size()); i++) {
+      rc = dht.AtomicAdd(keys[i], i+1, &old_value);
+      EXPECT_EQ(kelpie::KELPIE_OK, rc);
+      EXPECT_EQ(j*(i+1), old_value);
+    }
+  }
+
+  //Async adds all land exactly once
+  atomic<int> num_left(keys.size());
+  for(auto &k : keys) {
+    rc = dht.Atomic(k, kelpie::AtomicOp::Add, 100, 0,
+                    [&num_left] (kelpie::rc_t result, kelpie::Key key, int64_t value) {
+                      EXPECT_EQ(kelpie::KELPIE_OK, result);
+                      num_left--;
+                    });
+    EXPECT_EQ(kelpie::KELPIE_OK, rc);
+  }
+  while(num_left!=0) { sched_yield(); }
+  for(int i=0; i<static_cast<int>(keys.size()); i++) {
+    rc = dht.AtomicAdd(keys[i], 0, &old_value);
+    EXPECT_EQ(kelpie::KELPIE_OK, rc);
+    EXPECT_EQ(4*(i+1)+100, old_value);
+  }
+
+  //Swaps only happen when the expected value is there
+  kelpie::Key klock(key_prefix, "lock");
+  rc = dht.CompareAndSwap(klock, 5, 1, &old_value);
+  EXPECT_EQ(kelpie::KELPIE_RECHECK, rc);
+  EXPECT_EQ(0, old_value);
+  rc = dht.CompareAndSwap(klock, 0, 1, &old_value);
+  EXPECT_EQ(kelpie::KELPIE_OK, rc);
+  EXPECT_EQ(0, old_value);
+  rc = dht.CompareAndSwap(klock, 0, 2, &old_value);
+  EXPECT_EQ(kelpie::KELPIE_RECHECK, rc);
+  EXPECT_EQ(1, old_value);
+  rc = dht.CompareAndSwap(klock, 1, 0, &old_value);
+  EXPECT_EQ(kelpie::KELPIE_OK, rc);
+  EXPECT_EQ(1, old_value);
+
+  //Objects that aren't a single int64 are left alone
+  kelpie::Key kblob(key_prefix, "blob");
+  rc = dht.Publish(kblob, generateLDO(8, 1));
+  EXPECT_EQ(kelpie::KELPIE_OK, rc);
+  rc = dht.AtomicAdd(kblob, 1);
+  EXPECT_EQ(kelpie::KELPIE_EINVAL, rc);
+}
+
 TEST_F(MPIDHTTest, VerifySaneWhookieIP) {
   //If whookie chose the wrong port, it can get a bad ip address
 
@@ -351,6 +409,77 @@ TEST_F(MPIDHTTest, BasicSingleOtherWantUnbounded) {
   checkWantBounded(dht, kvs); //Do Wants, specifying length
 }
 
+//Ask a node's lkv whookie how many leases it has handed out
+int getActiveLeases(faodel::nodeid_t node) {
+  string result;
+  whookie::retrieveData(node, "/kelpie/lkv&format=txt", &result);
+  string label = "Active Leases:\t";
+  auto pos = result.find(label);
+  if(pos == string::npos) return -1;
+  return stoi(result.substr(pos + label.size()));
+}
+
+TEST_F(MPIDHTTest, LeaseSingleOtherNeed) {
+
+  //Don't cache reads locally, so every Need goes back to the owner
+  kelpie::Pool dht = kelpie::Connect("dht:/dht_single_other&lease=true&behavior=writetoremote");
+  faodel::nodeid_t owner = G.nodes[G.mpi_size-1];
+  int base_leases = getActiveLeases(owner);
+  ASSERT_LE(0, base_leases);
+
+  auto kvs = generateAndPublish(dht, "single_other_lease");
+  checkNeed(dht, kvs); //Asks for leases
+  EXPECT_EQ(base_leases + static_cast<int>(kvs.size()), getActiveLeases(owner));
+  checkNeed(dht, kvs); //Reads through leases. No new ones are handed out
+  EXPECT_EQ(base_leases + static_cast<int>(kvs.size()), getActiveLeases(owner));
+
+  //Replace the objects behind the lease pool's back. Its leases are now revoked
+  for(auto &kv : kvs) {
+    rc = dht_single_other.BlockingDrop(kv.first);
+    EXPECT_EQ(kelpie::KELPIE_OK, rc);
+  }
+  EXPECT_EQ(base_leases, getActiveLeases(owner));
+  auto kvs2 = generateAndPublish(dht_single_other, "single_other_lease");
+  checkNeed(dht, kvs2); //Revoked leases are replaced with new ones
+  EXPECT_EQ(base_leases + static_cast<int>(kvs2.size()), getActiveLeases(owner));
+  checkNeed(dht, kvs2); //Reads through the new leases
+  EXPECT_EQ(base_leases + static_cast<int>(kvs2.size()), getActiveLeases(owner));
+}
+
+TEST_F(MPIDHTTest, AtomicSingleSelf) {
+  checkAtomics(dht_single_self, "single_self_atomic");
+}
+
+TEST_F(MPIDHTTest, AtomicSingleOther) {
+  checkAtomics(dht_single_other, "single_other_atomic");
+}
+
+TEST_F(MPIDHTTest, AtomicFull) {
+  checkAtomics(dht_full, "full_atomic");
+}
+
+TEST_F(MPIDHTTest, AtomicReleasesWant) {
+
+  //A remote add creates the object, which should wake up anyone waiting on it
+  kelpie::Key key("single_other_atomic_want", "counter");
+  atomic<bool> done(false);
+  rc = dht_single_other.Want(key,
+                  [&done] (bool success, kelpie::Key key, lunasa::DataObject user_ldo,
+                           const kelpie::object_info_t &info) {
+                    EXPECT_TRUE(success);
+                    EXPECT_EQ(sizeof(int64_t), user_ldo.GetDataSize());
+                    if(user_ldo.GetDataSize() == sizeof(int64_t)) {
+                      EXPECT_EQ(7, *user_ldo.GetDataPtr<int64_t *>());
+                    }
+                    done = true;
+                  });
+  EXPECT_EQ(kelpie::KELPIE_OK, rc);
+  EXPECT_FALSE(done);
+  rc = dht_single_other.AtomicAdd(key, 7);
+  EXPECT_EQ(kelpie::KELPIE_OK, rc);
+  while(!done) { sched_yield(); }
+}
+
 TEST_F(MPIDHTTest, BasicFullNeed) {
 
   kelpie::Pool dht = dht_full; //alias
@@ -12,6 +12,7 @@
 #include "kelpie/Key.hh"
 
 #include "kelpie/ops/direct/msg_direct.hh"
+#include "kelpie/ops/direct/OpKelpieAtomic.hh"
 #include "kelpie/ops/direct/OpKelpiePublish.hh"
 
 
@@ -153,6 +154,37 @@ TEST_F(MsgDirectTest, BufferPub) {
 
 }
 
+TEST_F(MsgDirectTest, Atomic) {
+
+  bucket_t bucket(0x2112, iuo);
+  Key k1("This is the row","This is the Column");
+
+  lunasa::DataObject ldo_msg, ldo_reply;
+  bool exceeds = msg_direct_atomic_t::Alloc(ldo_msg, OpKelpieAtomic::op_id, NODE_LOCALHOST,
+                                            0x2064, bucket, k1, AtomicOp::CompareAndSwap, -5, 0x1971);
+  EXPECT_FALSE(exceeds);
+
+  auto *msg = ldo_msg.GetDataPtr<msg_direct_atomic_t *>();
+  EXPECT_EQ(static_cast<uint16_t>(DirectFlags::CMD_COMPUTE), DirectFlags::GetCommand(&msg->hdr));
+
+  Key k3 = msg->ExtractKey();
+  EXPECT_EQ(k1,k3);
+  EXPECT_EQ(15, msg->k1_size);
+  EXPECT_EQ(18, msg->k2_size);
+  EXPECT_EQ(0x2112, msg->bucket.bid);
+  EXPECT_EQ(AtomicOp::CompareAndSwap, msg->op);
+  EXPECT_EQ(-5, msg->operand);
+  EXPECT_EQ(0x1971, msg->compare);
+  EXPECT_EQ(0x2064, msg->hdr.src_mailbox);
+
+  //Replies carry the remote result and the old value back
+  auto *reply = msg_direct_atomic_t::AllocReply(ldo_reply, &msg->hdr, KELPIE_RECHECK, 0x2112);
+  EXPECT_EQ(static_cast<uint16_t>(DirectFlags::CMD_STATUS_NACK), DirectFlags::GetCommand(&reply->hdr));
+  EXPECT_EQ(KELPIE_RECHECK, reply->remote_rc);
+  EXPECT_EQ(0x2112, reply->old_value);
+  EXPECT_EQ(0x2064, reply->hdr.dst_mailbox);
+}
+
 int main(int argc, char **argv){
   int rc=0;
 
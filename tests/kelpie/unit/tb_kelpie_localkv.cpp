@@ -469,6 +469,69 @@ TEST_F(LocalKVTest, DropIndividual) {
 
 }
 
+TEST_F(LocalKVTest, Atomics) {
+
+  int rc;
+  bucket_t bucket("bucky");
+  int64_t old_value;
+
+  //A missing item starts at zero and is created by an add
+  Key k1("counters", "hits");
+  for(int i=0; i<10; i++) {
+    rc = lkv->atomic(bucket, k1, AtomicOp::Add, 3, 0, &old_value);
+    EXPECT_EQ(KELPIE_OK, rc);
+    EXPECT_EQ(3*i, old_value);
+  }
+  lunasa::DataObject ldo;
+  rc = lkv->get(bucket, k1, &ldo, nullptr);
+  EXPECT_EQ(KELPIE_OK, rc);
+  EXPECT_EQ(sizeof(int64_t), ldo.GetDataSize());
+  EXPECT_EQ(30, *ldo.GetDataPtr<int64_t *>());
+
+  //Updates install a new ldo, so an earlier reference keeps its value
+  rc = lkv->atomic(bucket, k1, AtomicOp::Add, -40, 0, &old_value);
+  EXPECT_EQ(KELPIE_OK, rc);
+  EXPECT_EQ(30, old_value);
+  EXPECT_EQ(30, *ldo.GetDataPtr<int64_t *>());
+
+  //Swap only happens when the value matches
+  rc = lkv->atomic(bucket, k1, AtomicOp::CompareAndSwap, 100, 5, &old_value);
+  EXPECT_EQ(KELPIE_RECHECK, rc);
+  EXPECT_EQ(-10, old_value);
+  rc = lkv->atomic(bucket, k1, AtomicOp::CompareAndSwap, 100, -10, &old_value);
+  EXPECT_EQ(KELPIE_OK, rc);
+  EXPECT_EQ(-10, old_value);
+  rc = lkv->atomic(bucket, k1, AtomicOp::Add, 0, 0, &old_value);
+  EXPECT_EQ(KELPIE_OK, rc);
+  EXPECT_EQ(100, old_value);
+
+  //Swapping a missing item only works if we expect zero
+  Key k2("counters", "lock");
+  rc = lkv->atomic(bucket, k2, AtomicOp::CompareAndSwap, 1, 7, &old_value);
+  EXPECT_EQ(KELPIE_RECHECK, rc);
+  EXPECT_EQ(0, old_value);
+  rc = lkv->get(bucket, k2, &ldo, nullptr);
+  EXPECT_EQ(KELPIE_ENOENT, rc);
+  rc = lkv->atomic(bucket, k2, AtomicOp::CompareAndSwap, 1, 0, &old_value);
+  EXPECT_EQ(KELPIE_OK, rc);
+  EXPECT_EQ(0, old_value);
+  rc = lkv->atomic(bucket, k2, AtomicOp::CompareAndSwap, 1, 0, &old_value);
+  EXPECT_EQ(KELPIE_RECHECK, rc);
+  EXPECT_EQ(1, old_value);
+
+  //Items that are not a single int64 are rejected and left alone
+  Key k3("counters", "blob");
+  lunasa::DataObject ldo_blob(100);
+  rc = lkv->put(bucket, k3, ldo_blob, PoolBehavior::WriteToLocal, nullptr, nullptr);
+  EXPECT_EQ(KELPIE_OK, rc);
+  rc = lkv->atomic(bucket, k3, AtomicOp::Add, 1, 0, &old_value);
+  EXPECT_EQ(KELPIE_EINVAL, rc);
+  rc = lkv->get(bucket, k3, &ldo, nullptr);
+  EXPECT_EQ(KELPIE_OK, rc);
+  EXPECT_EQ(100, ldo.GetDataSize());
+
+}
+
 TEST_F(LocalKVTest, DropRow) {
 
   int rc;
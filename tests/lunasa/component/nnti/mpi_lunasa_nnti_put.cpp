@@ -36,7 +36,7 @@ const int URL_SIZE = 128;
 char *debug_ptr = nullptr;
 
 #if NNTI_BUILD_MPI
-#define MAX_NET_BUFFER_REMOTE_SIZE 68 /* 4 + 4 + 60 */
+#define MAX_NET_BUFFER_REMOTE_SIZE 76 /* 4 + 4 + 68 */
 #elif NNTI_BUILD_UGNI
 #define MAX_NET_BUFFER_REMOTE_SIZE 48 /* 4 + 4 + 40 */
 #elif NNTI_BUILD_IBVERBS
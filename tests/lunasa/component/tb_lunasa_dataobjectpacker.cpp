@@ -139,7 +139,7 @@ TEST_F(LunasaDataObjectPacker, LongNames) {
 
 
 
-  for(int version=1; version<=2; version++) {
+  for(int version=1; version<=3; version++) {
 
     DataObjectPacker gp1(names, ptrs_flt, bytes, types_flt, const_hash32("My Stuff"), version);
     DataObjectPacker gp2(gp1.GetDataObject());
@@ -168,6 +168,7 @@ TEST_F(LunasaDataObjectPacker, LongNames) {
           EXPECT_EQ(EINVAL, rc);
           break;
         case 2:
+        case 3:
           EXPECT_EQ(0, rc);
           EXPECT_EQ(T_FLOAT, tst_type);
           compareArrays((float *) ptrs_flt[i], bytes[i], tst_ptr, tst_bytes);
@@ -183,6 +184,7 @@ TEST_F(LunasaDataObjectPacker, LongNames) {
         EXPECT_EQ(names.size(), pulled_names.size());
         break;
       case 2:
+      case 3:
         EXPECT_EQ(EINVAL, rc);
         EXPECT_EQ(0, pulled_names.size());
         break;
@@ -278,6 +280,90 @@ TEST_F(LunasaDataObjectPacker, AppendStyle) {
 
 }
 
+TEST_F(LunasaDataObjectPacker, Version3Index) {
+
+  //Pack variables of odd sizes so the data would not be aligned without padding
+  vector<string> names;
+  vector<size_t> bytes;
+  vector<const void *> ptrs_flt;
+  vector<uint8_t> types_flt;
+  for(int i=0; i<100; i++) {
+    int num = 3*i+1;
+    float *fptr = new float[num];
+    for(int j=0; j<num; j++)
+      fptr[j]=(float)(i*1000 + j);
+    names.push_back("var-"+std::to_string(i));
+    bytes.push_back(num*sizeof(float));
+    ptrs_flt.push_back(fptr);
+    types_flt.push_back(T_FLOAT);
+  }
+
+  DataObjectPacker gp1(names, ptrs_flt, bytes, types_flt, const_hash32("My Stuff"), 3);
+  DataObjectPacker gp2(gp1.GetDataObject());
+  auto ldo = gp2.GetDataObject();
+
+  for(size_t i=0; i<names.size(); i++) {
+    auto arr = gp2.GetArray<float>(names[i]);
+    EXPECT_EQ(bytes[i]/sizeof(float), arr.size());
+    compareArrays((float *) ptrs_flt[i], bytes[i], arr.data(), arr.size()*sizeof(float));
+
+    //Data should be aligned relative to the start of the user section. The allocator
+    //decides the absolute alignment, so that is not checked
+    size_t offset = reinterpret_cast<uint8_t *>(arr.data()) - ldo.GetMetaPtr<uint8_t *>();
+    EXPECT_EQ(0, offset % DataObjectPacker::v3_alignment);
+  }
+
+  //Wrong type size or missing name gives an empty array
+  EXPECT_TRUE(gp2.GetArray<double>("var-0").empty());
+  EXPECT_TRUE(gp2.GetArray<float>("not-here").empty());
+
+  //An index that claims more entries than the meta section holds is rejected
+  ldo.GetMetaPtr<uint32_t *>()[0] = 100000; //num_vars
+  EXPECT_ANY_THROW(DataObjectPacker gp3(ldo));
+
+  //Names must be unique, since lookups only see the hash
+  names[1] = names[0];
+  EXPECT_ANY_THROW(DataObjectPacker gp4(names, ptrs_flt, bytes, types_flt, const_hash32("My Stuff"), 3));
+
+  for(auto p : ptrs_flt)
+    delete[] (float *) p;
+}
+
+TEST_F(LunasaDataObjectPacker, Version3Append) {
+
+  double vals[8];
+  for(int j=0; j<8; j++) vals[j]=(double)j;
+
+  //Index has room for four items, data has room for more
+  DataObjectPacker dop(4096, const_hash32("My Stuff"), 3, DataObject::AllocatorType::eager, 4);
+  EXPECT_EQ(64, dop.ComputeEntrySize("x", 8*sizeof(double)));
+  EXPECT_EQ(128, dop.ComputeEntrySize("x", 9*sizeof(double)));
+
+  for(int i=0; i<4; i++) {
+    EXPECT_LT(0, dop.RemainingCapacity());
+    rc = dop.AppendVariable("thing-"+std::to_string(i), vals, 8*sizeof(double), T_DOUBLE);
+    EXPECT_EQ(0, rc);
+  }
+  EXPECT_EQ(0, dop.RemainingCapacity());
+  rc = dop.AppendVariable("thing-4", vals, 8*sizeof(double), T_DOUBLE);
+  EXPECT_EQ(-1, rc);
+
+  //Names already in the index are rejected
+  DataObjectPacker dop_dup(4096, const_hash32("My Stuff"), 3, DataObject::AllocatorType::eager, 4);
+  EXPECT_EQ(0, dop_dup.AppendVariable("thing-0", vals, 8*sizeof(double), T_DOUBLE));
+  EXPECT_EQ(-1, dop_dup.AppendVariable("thing-0", vals, 8*sizeof(double), T_DOUBLE));
+
+  //Lookups work from a new packer without any index rebuild
+  DataObjectPacker dop2(dop.GetDataObject());
+  for(int i=0; i<4; i++) {
+    auto arr = dop2.GetArray<double>("thing-"+std::to_string(i));
+    ASSERT_EQ(8, arr.size());
+    for(int j=0; j<8; j++)
+      EXPECT_EQ((double)j, arr[j]);
+  }
+  EXPECT_TRUE(dop2.GetArray<double>("thing-4").empty());
+}
+
 TEST_F(LunasaDataObjectPacker, RefCounts) {
 
   int count;
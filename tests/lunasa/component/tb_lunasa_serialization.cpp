@@ -0,0 +1,182 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "faodel-common/Common.hh"
+#include "faodel-common/SerializationHelpersBoost.hh"
+#include "lunasa/Lunasa.hh"
+#include "lunasa/DataObject.hh"
+
+#include "lunasa/common/DataObjectStreambuf.hh"
+#include "lunasa/common/SerializationHelpersBoost.hh"
+#include "lunasa/common/SerializationHelpersCereal.hh"
+
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+using namespace std;
+using namespace faodel;
+using namespace lunasa;
+
+string default_config = R"EOF(
+# IMPORTANT: this test won't work with tcmalloc implementation because it
+#            starts/finishes bootstrap multiple times.
+
+lunasa.lazy_memory_manager malloc
+lunasa.eager_memory_manager malloc
+)EOF";
+
+
+class LunasaSerialization : public testing::Test {
+protected:
+  void SetUp() override {
+    Configuration config(default_config);
+    config.AppendFromReferences();
+
+    bootstrap::Init(config, lunasa::bootstrap);
+    bootstrap::Start();
+  }
+
+  void TearDown() override {
+    bootstrap::Finish();
+  }
+};
+
+class Bundle {
+public:
+  Bundle() = default; //Need empty ctor for serialization
+  int id;
+  string name;
+  vector<double> values;
+
+  Bundle(int id, int num_values) : id(id), name("bundle_"+std::to_string(id)) {
+    for(int i=0; i<num_values; i++)
+      values.push_back(i*0.25);
+  }
+
+  //Serialization hook (works for both boost and cereal)
+  template <typename Archive>
+  void serialize(Archive &ar, const unsigned int version) {
+    ar & id;
+    ar & name;
+    ar & values;
+  }
+  bool operator==(const Bundle &other) const {
+    return (id==other.id) && (name==other.name) && (values==other.values);
+  }
+};
+
+
+TEST_F(LunasaSerialization, OutputStreambufGrows) {
+
+  DataObjectOutputStreambuf buf(16, 8, 0x1234);
+  std::ostream os(&buf);
+
+  string expected;
+  for(int i=0; i<100; i++) {
+    string s = "item_"+std::to_string(i)+";";
+    os << s;
+    expected += s;
+  }
+  os.put('!');
+  expected += "!";
+  EXPECT_TRUE(os.good());
+  EXPECT_GT(buf.GetNumGrows(), 0);
+  EXPECT_GT(buf.GetBytesCopied(), 0);
+  EXPECT_EQ(expected.size(), buf.GetBytesWritten());
+
+  auto ldo = buf.Finish();
+  EXPECT_EQ(8, ldo.GetMetaSize());
+  EXPECT_EQ(expected.size(), ldo.GetDataSize());
+  EXPECT_EQ(0x1234, ldo.GetTypeID());
+  EXPECT_EQ(expected, string(ldo.GetDataPtr<char *>(), ldo.GetDataSize()));
+
+  //Nothing to write into after finishing
+  os << "more";
+  EXPECT_FALSE(os.good());
+  EXPECT_EQ(expected.size(), ldo.GetDataSize());
+}
+
+TEST_F(LunasaSerialization, OutputStreambufNoGrow) {
+
+  DataObjectOutputStreambuf buf(1024);
+  std::ostream os(&buf);
+  os << "hello world";
+  EXPECT_EQ(0, buf.GetNumGrows());
+  EXPECT_EQ(0, buf.GetBytesCopied());
+  auto ldo = buf.Finish();
+  EXPECT_EQ(11, ldo.GetDataSize());
+  EXPECT_EQ(0, ldo.GetMetaSize());
+}
+
+TEST_F(LunasaSerialization, InputStreambuf) {
+
+  string s = "0123456789abcdef";
+  DataObject ldo(s.size());
+  memcpy(ldo.GetDataPtr(), s.c_str(), s.size());
+  char *ldo_data = ldo.GetDataPtr<char *>();
+
+  DataObjectInputStreambuf buf(ldo);
+  std::istream is(&buf);
+  char tmp[5] = {0};
+  is.read(tmp, 4);
+  EXPECT_EQ("0123", string(tmp));
+  EXPECT_EQ(4, static_cast<int>(is.tellg()));
+
+  is.seekg(-4, std::ios_base::end);
+  is.read(tmp, 4);
+  EXPECT_EQ("cdef", string(tmp));
+
+  is.read(tmp, 1);
+  EXPECT_TRUE(is.eof());
+
+  //Reads come from the ldo itself
+  ldo_data[0] = 'X';
+  is.clear();
+  is.seekg(0);
+  EXPECT_EQ('X', is.get());
+}
+
+TEST_F(LunasaSerialization, BoostRoundTrip) {
+
+  Bundle b1(42, 2000);
+
+  auto ldo = BoostPackToLDO(b1);
+  EXPECT_FALSE(ldo.isNull());
+
+  //Should be byte-for-byte what the string version makes
+  string packed = faodel::BoostPack(b1);
+  ASSERT_EQ(packed.size(), ldo.GetDataSize());
+  EXPECT_EQ(0, memcmp(packed.c_str(), ldo.GetDataPtr(), packed.size()));
+
+  auto b2 = BoostUnpackFromLDO<Bundle>(ldo);
+  EXPECT_TRUE(b1==b2);
+
+  //Big enough initial capacity, with a type id
+  auto ldo2 = BoostPackToLDO(b1, packed.size()+64, 0x42);
+  EXPECT_EQ(0x42, ldo2.GetTypeID());
+  EXPECT_TRUE(b1==BoostUnpackFromLDO<Bundle>(ldo2));
+}
+
+TEST_F(LunasaSerialization, CerealRoundTrip) {
+
+  vector<Bundle> bundles;
+  for(int i=0; i<10; i++)
+    bundles.emplace_back(i, i*100);
+
+  auto ldo = CerealPackToLDO(bundles, 32);
+  EXPECT_GT(ldo.GetDataSize(), 10*sizeof(int));
+
+  auto bundles2 = CerealUnpackFromLDO<vector<Bundle>>(ldo);
+  ASSERT_EQ(bundles.size(), bundles2.size());
+  for(size_t i=0; i<bundles.size(); i++)
+    EXPECT_TRUE(bundles[i]==bundles2[i]);
+}
@@ -0,0 +1,312 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#include "nnti/nnti_pch.hpp"
+
+#include <mpi.h>
+
+#include "nnti/nntiConfig.h"
+
+#include <unistd.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <assert.h>
+
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "faodel-common/Configuration.hh"
+
+#include "nnti/nnti_logger.hpp"
+
+#include "nnti/nnti_util.hpp"
+
+#include "nnti/nnti_transport.hpp"
+#include "nnti/nnti_buffer.hpp"
+#include "nnti/nnti_wid.hpp"
+#include "nnti/transport_factory.hpp"
+
+#include "bench_utils.hpp"
+
+using namespace std;
+using namespace faodel;
+
+bool success=true;
+
+/*
+ * The client keeps window_ sends in flight until total_ have completed.
+ * The server counts them as they arrive.  Both sides run entirely in
+ * callbacks on the transport's progress thread, so the message rate
+ * shows how well the transport copes with many outstanding requests.
+ */
+class test_context {
+public:
+    std::atomic<uint64_t> issued_;
+    uint64_t              completed_;
+    uint64_t              received_;
+    uint64_t              window_;
+    uint64_t              total_;
+
+    uint64_t length_;
+
+    nnti::datatype::nnti_event_callback *cb_;
+    nnti::transports::transport         *transport_;
+    struct buffer_properties             send_src_;
+    struct buffer_properties             send_target_;
+
+public:
+    test_context(
+        uint64_t                             total,
+        uint64_t                             length,
+        nnti::datatype::nnti_event_callback *cb,
+        nnti::transports::transport         *transport)
+    : issued_(0),
+      completed_(0),
+      received_(0),
+      window_(1),
+      total_(total),
+      length_(length),
+      cb_(cb),
+      transport_(transport)
+    {
+        return;
+    }
+
+    void
+    reset(uint64_t window)
+    {
+        issued_    = 0;
+        completed_ = 0;
+        received_  = 0;
+        window_    = window;
+    }
+
+    // start another send if there are any left to start
+    void
+    issue(NNTI_peer_t peer)
+    {
+        if (issued_.fetch_add(1) < total_) {
+            send_data_async(transport_, length_, 0, send_src_.hdl, send_target_.hdl, peer, *cb_, this);
+        }
+    }
+};
+
+class test_callback {
+public:
+    test_callback()
+    {
+        return;
+    }
+
+    NNTI_result_t operator() (NNTI_event_t *event, void *context) {
+
+        test_context *c = (test_context*)context;
+
+        switch (event->type) {
+            case NNTI_EVENT_SEND:
+                if (++c->completed_ == c->total_) {
+                    // we're done here.  return NNTI_ECANCEL to push an event on the EQ.
+                    return NNTI_ECANCELED;
+                }
+                c->issue(event->peer);
+                break;
+            case NNTI_EVENT_RECV:
+                if (++c->received_ == c->total_) {
+                    // we're done here.  return NNTI_ECANCEL to push an event on the EQ.
+                    return NNTI_ECANCELED;
+                }
+                break;
+            default:
+                break;
+        }
+
+        return NNTI_OK;
+    }
+};
+
+NNTI_result_t runbench(bool                         server,
+                       test_context                *c,
+                       nnti::transports::transport *t,
+                       NNTI_event_queue_t           rate_eq,
+                       NNTI_peer_t                  peer_hdl)
+{
+    NNTI_event_t event;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (!server) {
+        for (uint64_t i=0;i<c->window_;i++) {
+            c->issue(peer_hdl);
+        }
+    }
+
+    // the callbacks put an event on the eq when the last message is done
+    recv_data(t, rate_eq, &event);
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    uint64_t total_us     = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    float    total_sec    = (float)total_us/1000000.0;
+    float    msgs_per_sec = (float)c->total_ / total_sec;
+    float    us_per_msg   = (float)total_us/(float)c->total_;
+
+    log_info("MessageRate chrono", "%6lu       %6lu    %8luus   %6.3fus   %10.0f",
+        c->window_, c->total_,
+        total_us,
+        us_per_msg,
+        msgs_per_sec);
+
+    return NNTI_OK;
+}
+
+string default_config_string = R"EOF(
+# default to using mpi, but allow override in config file pointed to by CONFIG
+nnti.transport.name                           mpi
+)EOF";
+
+
+int main(int argc, char *argv[])
+{
+    Configuration config;
+
+    NNTI_result_t rc;
+    nnti::transports::transport *t=nullptr;
+
+    char                   server_url[1][NNTI_URL_LEN];
+    const uint32_t         num_servers = 1;
+    uint32_t               num_clients;
+    bool                   i_am_server = false;
+
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+
+    int mpi_rank,mpi_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+
+    config = Configuration(default_config_string);
+    config.AppendFromReferences();
+
+    test_setup(0,
+               NULL,
+               config,
+               "MessageRate",
+               server_url,
+               mpi_size,
+               mpi_rank,
+               num_servers,
+               num_clients,
+               i_am_server,
+               t);
+
+    nnti::datatype::nnti_event_callback null_cb(t);
+
+    uint64_t msg_count  = 20000;
+    uint64_t max_window = 1024;
+
+    NNTI_peer_t         peer_hdl;
+
+    NNTI_event_queue_t  unexpected_eq;
+    NNTI_event_queue_t  rate_eq;
+
+    struct buffer_properties src_buf;
+    struct buffer_properties my_rate_buf;
+    struct buffer_properties peer_rate_buf;
+
+    rc = t->eq_create(128, NNTI_EQF_UNEXPECTED, &unexpected_eq);
+    rc = t->eq_create(128, NNTI_EQF_UNSET, &rate_eq);
+
+    test_callback *cb = new test_callback();
+    nnti::datatype::nnti_event_callback *ratecb = new nnti::datatype::nnti_event_callback(t, *cb);
+    test_context                        *ctx    = new test_context(msg_count, 8, ratecb, t);
+
+    src_buf.size=64*1024;
+    rc = t->alloc(src_buf.size,
+                  (NNTI_buffer_flags_t)(NNTI_BF_LOCAL_READ|NNTI_BF_LOCAL_WRITE|NNTI_BF_REMOTE_READ|NNTI_BF_REMOTE_WRITE),
+                  unexpected_eq,
+                  null_cb,
+                  nullptr,
+                  &src_buf.base,
+                  &src_buf.hdl);
+    my_rate_buf.size=64*1024;
+    rc = t->alloc(my_rate_buf.size,
+                  (NNTI_buffer_flags_t)(NNTI_BF_LOCAL_READ|NNTI_BF_LOCAL_WRITE|NNTI_BF_REMOTE_READ|NNTI_BF_REMOTE_WRITE),
+                  rate_eq,
+                  *ratecb,
+                  ctx,
+                  &my_rate_buf.base,
+                  &my_rate_buf.hdl);
+
+    ctx->send_src_ = my_rate_buf;
+
+    if (i_am_server) {
+        rc = recv_target_hdl(t, src_buf.hdl, src_buf.base, &peer_rate_buf.hdl, &peer_hdl, unexpected_eq);
+        if (rc != NNTI_OK) {
+            log_error("MessageRate", "recv_target_hdl() failed: %d", rc);
+        }
+
+        ctx->send_target_ = peer_rate_buf;
+
+        rc = send_target_hdl(t, src_buf.hdl, src_buf.base, src_buf.size, my_rate_buf.hdl, peer_hdl, unexpected_eq);
+        if (rc != NNTI_OK) {
+            log_error("MessageRate", "send_target_hdl() failed: %d", rc);
+        }
+    } else {
+        rc = t->connect(server_url[0], 1000, &peer_hdl);
+
+        rc = send_target_hdl(t, src_buf.hdl, src_buf.base, src_buf.size, my_rate_buf.hdl, peer_hdl, unexpected_eq);
+        if (rc != NNTI_OK) {
+            log_error("MessageRate", "send_target_hdl() failed: %d", rc);
+        }
+
+        NNTI_peer_t recv_peer;
+        rc = recv_target_hdl(t, src_buf.hdl, src_buf.base, &peer_rate_buf.hdl, &recv_peer, unexpected_eq);
+        if (rc != NNTI_OK) {
+            log_error("MessageRate", "recv_target_hdl() failed: %d", rc);
+        }
+
+        ctx->send_target_ = peer_rate_buf;
+    }
+
+    log_info("MessageRate chrono", "outstanding   msgs      time        usec/msg   msgs/sec");
+
+    for (uint64_t window=1 ; window <= max_window ; window *= 2) {
+        ctx->reset(window);
+        MPI_Barrier(MPI_COMM_WORLD);
+        runbench(i_am_server, ctx, t, rate_eq, peer_hdl);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    if (!i_am_server) {
+        t->disconnect(peer_hdl);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    if (t->initialized()) {
+        t->stop();
+    } else {
+        success = false;
+    }
+
+    if (success) {
+        log_debug_stream("MessageRate") << "\nEnd Result: TEST PASSED";
+        std::cout << "\nEnd Result: TEST PASSED" << std::endl;
+    } else {
+        log_debug_stream("MessageRate") << "\nEnd Result: TEST FAILED";
+        std::cout << "\nEnd Result: TEST FAILED" << std::endl;
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    MPI_Finalize();
+
+    return (success ? 0 : 1 );
+}
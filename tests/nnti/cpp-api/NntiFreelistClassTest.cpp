@@ -9,7 +9,9 @@
 #include <unistd.h>
 
 #include <iostream>
+#include <set>
 #include <thread>
+#include <vector>
 
 #include "nnti/nnti_logger.hpp"
 #include "nnti/nnti_freelist.hpp"
@@ -20,6 +22,7 @@ bool success=true;
 static const auto freelist_size = 1024;
 static const auto test_iters    = 10000;
 static const auto num_workers   = 5;
+static const auto magazine_size = 8;
 
 std::atomic<int> events_popped(0);
 std::atomic<int> events_pushed(0);
@@ -90,6 +93,124 @@ test1()
     }
 }
 
+/*
+ * Each worker holds a different number of items at once, so the
+ * magazines keep spilling into and refilling from the depot.
+ */
+class MagazineWorker {
+private:
+    nnti::core::nnti_freelist<NNTI_event_t*> *fl_;
+    int                                       held_;
+
+public:
+    MagazineWorker(nnti::core::nnti_freelist<NNTI_event_t*> *fl, int held)
+    {
+        fl_   = fl;
+        held_ = held;
+        return;
+    }
+
+    void
+    operator()()
+    {
+        std::vector<NNTI_event_t*> events;
+        for (auto i=0;i < test_iters;i++) {
+            for (auto j=0;j < held_;j++) {
+                NNTI_event_t *e = nullptr;
+                if (fl_->pop(e)) {
+                    events.push_back(e);
+                }
+            }
+            for (auto e : events) {
+                fl_->push(e);
+            }
+            events.clear();
+        }
+    }
+};
+
+void
+test2()
+{
+    std::thread workers[num_workers];
+    nnti::core::nnti_freelist<NNTI_event_t*> fl(freelist_size, magazine_size);
+
+    for (auto i=0;i<freelist_size;i++) {
+        NNTI_event_t *e = new NNTI_event_t;
+        fl.push(e);
+    }
+
+    struct timeval tv0, tv1;
+    gettimeofday(&tv0, NULL);
+
+    for (auto i = 0; i < num_workers; ++i) {
+        workers[i] = std::thread(MagazineWorker(&fl, 1+i*magazine_size));
+    }
+
+    for (auto i = 0; i < num_workers; ++i) {
+        workers[i].join();
+    }
+
+    gettimeofday(&tv1, NULL);
+    std::cout << (tv_to_ms(tv1) - tv_to_ms(tv0)) << "ms" << std::endl;
+
+    uint64_t hits, misses;
+    fl.cache_stats(hits, misses);
+    std::cout << "magazine hits = " << hits << " misses = " << misses << std::endl;
+
+    // every item must come back exactly once
+    std::set<NNTI_event_t*> events;
+    fl.reclaim();
+    while (!fl.empty()) {
+        NNTI_event_t *e = nullptr;
+        if (fl.pop(e)) {
+            events.insert(e);
+        }
+    }
+    std::cout << "total reclaimed = " << events.size() << std::endl;
+    if (events.size() != freelist_size) {
+        success = false;
+    }
+    for (auto e : events) {
+        delete e;
+    }
+}
+
+/*
+ * A freelist with magazines is still bounded by its size.
+ */
+void
+test3()
+{
+    nnti::core::nnti_freelist<NNTI_event_t*> fl(4*magazine_size, magazine_size);
+
+    std::vector<NNTI_event_t*> events;
+    for (auto i=0;i<4*magazine_size;i++) {
+        NNTI_event_t *e = new NNTI_event_t;
+        events.push_back(e);
+        if (!fl.push(e)) {
+            success = false;
+        }
+    }
+
+    NNTI_event_t *extra = new NNTI_event_t;
+    if (fl.push(extra)) {
+        std::cout << "push succeeded on a full freelist" << std::endl;
+        success = false;
+    }
+
+    NNTI_event_t *e = nullptr;
+    if (!fl.pop(e) || !fl.push(extra)) {
+        std::cout << "push failed after a pop" << std::endl;
+        success = false;
+    }
+    delete extra;
+
+    for (auto e : events) {
+        delete e;
+    }
+}
+
 int main(int argc, char *argv[])
 {
     std::stringstream logfile;
@@ -97,6 +218,8 @@ int main(int argc, char *argv[])
     nnti::core::logger::init(logfile.str(), sbl::severity_level::error);
 
     test1();
+    test2();
+    test3();
 
     if (success)
         std::cout << "\nEnd Result: TEST PASSED" << std::endl;
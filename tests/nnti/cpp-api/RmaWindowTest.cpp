@@ -0,0 +1,231 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#include "nnti/nnti_pch.hpp"
+
+#include <mpi.h>
+
+#include "gtest/gtest.h"
+
+#include "nnti/nntiConfig.h"
+
+#include <mpi.h>
+
+#include <unistd.h>
+#include <string.h>
+#include <pthread.h>
+#include <zlib.h>
+
+#include <assert.h>
+
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "nnti/nnti_logger.hpp"
+
+#include "nnti/nnti_util.hpp"
+
+#include "nnti/nnti_transport.hpp"
+#include "nnti/nnti_buffer.hpp"
+#include "nnti/nnti_wid.hpp"
+#include "nnti/transport_factory.hpp"
+#include "nnti/transports/mpi/mpi_transport.hpp"
+
+#include "whookie/Server.hh"
+#include "whookie/client/Client.hh"
+
+#include "test_utils.hpp"
+
+using namespace std;
+using namespace faodel;
+
+string default_config_string = R"EOF(
+# the mpi transport is what is being tested, so it is set after the config file is read
+nnti.mpi.rma                                  true
+)EOF";
+
+const uint32_t msg_size=4096;
+const uint32_t msg_count=10;
+
+// Pull one counter out of this process's /nnti/mpi/stats page
+uint64_t
+mpi_stat(const string &name)
+{
+    string result;
+    whookie::retrieveData(whookie::Server::GetNodeID(), "/nnti/mpi/stats&format=txt", &result);
+
+    stringstream ss(result);
+    string line;
+    while (getline(ss, line)) {
+        if (line.compare(0, name.size()+1, name+"\t") == 0) {
+            return strtoull(line.c_str()+name.size()+1, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+class NntiRmaWindowTest : public testing::Test {
+protected:
+    Configuration config;
+
+    nnti::transports::transport *t=nullptr;
+
+    int mpi_rank, mpi_size;
+    int root_rank;
+
+    char                   server_url[1][NNTI_URL_LEN];
+    const uint32_t         num_servers = 1;
+    uint32_t               num_clients;
+    bool                   i_am_server = false;
+
+  void SetUp () override {
+        MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+        root_rank = 0;
+        config = Configuration(default_config_string);
+        config.AppendFromReferences();
+        config.Set("net.transport.name", "mpi");
+
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        test_setup(0,
+                   NULL,
+                   config,
+                   "RmaWindowTest",
+                   server_url,
+                   mpi_size,
+                   mpi_rank,
+                   num_servers,
+                   num_clients,
+                   i_am_server,
+                   t);
+    }
+
+  void TearDown () override {
+        NNTI_result_t nnti_rc = NNTI_OK;
+        bool init;
+
+        init = t->initialized();
+        EXPECT_TRUE(init);
+
+        if (init) {
+            nnti_rc = t->stop();
+            EXPECT_EQ(nnti_rc, NNTI_OK);
+        }
+    }
+};
+
+TEST_F(NntiRmaWindowTest, start1) {
+    NNTI_result_t rc;
+    NNTI_peer_t peer_hdl;
+
+    EXPECT_NE(nullptr, dynamic_cast<nnti::transports::mpi_transport *>(t));
+
+    nnti::datatype::nnti_event_callback func_cb(t, cb_func);
+    nnti::datatype::nnti_event_callback obj_cb(t, callback());
+
+    if (i_am_server) {
+        NNTI_event_queue_t  eq;
+        NNTI_buffer_t       buf_hdl;
+        char               *buf_base=nullptr;
+        uint32_t            buf_size=msg_size*msg_count;
+
+        rc = t->eq_create(128, NNTI_EQF_UNEXPECTED, &eq);
+        t->alloc(buf_size, (NNTI_buffer_flags_t)(NNTI_BF_LOCAL_READ|NNTI_BF_LOCAL_WRITE|NNTI_BF_REMOTE_READ|NNTI_BF_REMOTE_WRITE), eq, func_cb, nullptr, &buf_base, &buf_hdl);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        NNTI_buffer_t target_hdl;
+
+        rc = recv_target_hdl(t, buf_hdl, buf_base, &target_hdl, &peer_hdl, eq);
+        EXPECT_EQ(rc, NNTI_OK);
+        rc = send_target_hdl(t, buf_hdl, buf_base, buf_size, buf_hdl, peer_hdl, eq);
+        EXPECT_EQ(rc, NNTI_OK);
+
+        // the client puts into this buffer
+        MPI_Barrier(MPI_COMM_WORLD);
+        for (uint32_t i=0;i<msg_count;i++) {
+            EXPECT_TRUE(verify_buffer(buf_base, i*msg_size, buf_size, msg_size));
+        }
+
+        // the client gets it back
+        MPI_Barrier(MPI_COMM_WORLD);
+
+    } else {
+        NNTI_event_queue_t  eq;
+        NNTI_buffer_t       buf_hdl;
+        char               *buf_base=nullptr;
+        uint32_t            buf_size=msg_size*msg_count;
+
+        // give the server a chance to startup
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        rc = t->connect(server_url[0], 1000, &peer_hdl);
+        EXPECT_EQ(rc, NNTI_OK);
+        rc = t->eq_create(128, NNTI_EQF_UNEXPECTED, &eq);
+        rc = t->alloc(buf_size, (NNTI_buffer_flags_t)(NNTI_BF_LOCAL_READ|NNTI_BF_LOCAL_WRITE|NNTI_BF_REMOTE_READ|NNTI_BF_REMOTE_WRITE), eq, obj_cb, nullptr, &buf_base, &buf_hdl);
+
+        NNTI_buffer_t target_hdl;
+        NNTI_peer_t   recv_peer;
+
+        rc = send_target_hdl(t, buf_hdl, buf_base, buf_size, buf_hdl, peer_hdl, eq);
+        EXPECT_EQ(rc, NNTI_OK);
+        rc = recv_target_hdl(t, buf_hdl, buf_base, &target_hdl, &recv_peer, eq);
+        EXPECT_EQ(rc, NNTI_OK);
+
+        // put into the server's buffer.  the event means the data is there.
+        for (uint32_t i=0;i<msg_count;i++) {
+            rc = populate_buffer(t, i, msg_size, i, buf_hdl, buf_base, buf_size);
+            rc = put_data(t, buf_hdl, i*msg_size, target_hdl, i*msg_size, msg_size, peer_hdl, eq);
+            EXPECT_EQ(rc, NNTI_OK);
+        }
+
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        // and get it back
+        memset(buf_base, 0, buf_size);
+        for (uint32_t i=0;i<msg_count;i++) {
+            rc = get_data(t, target_hdl, i*msg_size, buf_hdl, i*msg_size, msg_size, peer_hdl, eq);
+            EXPECT_EQ(rc, NNTI_OK);
+        }
+        for (uint32_t i=0;i<msg_count;i++) {
+            EXPECT_TRUE(verify_buffer(buf_base, i*msg_size, buf_size, msg_size));
+        }
+
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        // none of it went through the target's progress thread
+        EXPECT_EQ(mpi_stat("rma_puts"), msg_count);
+        EXPECT_EQ(mpi_stat("rma_gets"), msg_count);
+
+        t->disconnect(peer_hdl);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+
+    int mpi_rank,mpi_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+    EXPECT_EQ(2, mpi_size);
+    assert(2==mpi_size);
+
+    int rc = RUN_ALL_TESTS();
+    cout <<"Tester completed all tests.\n";
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    bootstrap::Finish();
+
+    MPI_Finalize();
+
+    return (rc);
+}
@@ -82,6 +82,32 @@ TEST_F(OpboxConnectTest, start2) {
   MPI_Barrier(MPI_COMM_WORLD);
 }
 
+TEST_F(OpboxConnectTest, manyAtOnce) {
+  int rc;
+
+  faodel::nodeid_t myid = opbox::GetMyID();
+
+  std::vector<faodel::nodeid_t> gather_result(mpi_size);
+  MPI_Allgather(&myid, sizeof(faodel::nodeid_t), MPI_CHAR, gather_result.data(), sizeof(faodel::nodeid_t), MPI_CHAR,
+                MPI_COMM_WORLD);
+
+  if(mpi_rank != root_rank) {
+    //Asking for the same node several times should run one handshake and hand back one peer
+    std::vector<faodel::nodeid_t> nodeids(8, gather_result[root_rank]);
+    std::vector<opbox::net::peer_ptr_t> peers;
+    rc = opbox::net::Connect(&peers, nodeids);
+    EXPECT_EQ(rc, 0);
+    ASSERT_EQ(nodeids.size(), peers.size());
+    for(auto peer : peers) {
+      EXPECT_NE(nullptr, peer);
+      EXPECT_EQ(peers[0], peer);
+    }
+    rc = opbox::net::Disconnect(gather_result[root_rank]);
+    EXPECT_EQ(rc, 0);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
 int main(int argc, char **argv) {
 
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,124 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+
+#include <mpi.h>
+
+#include "gtest/gtest.h"
+
+#include <future>
+
+#include "faodel-common/Common.hh"
+#include "lunasa/Lunasa.hh"
+#include "opbox/OpBox.hh"
+
+using namespace std;
+using namespace faodel;
+using namespace lunasa;
+
+//The pool holds one connection and closes it as soon as another is needed
+string peer_pool_config_string = R"EOF(
+net.peer_pool.max_connected 1
+net.peer_pool.min_idle_ms   0
+)EOF";
+
+
+class OpboxPeerPoolTest : public testing::Test {
+protected:
+  int mpi_rank, mpi_size;
+  int root_rank;
+
+  void SetUp() override {
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+    root_rank = 0;
+  }
+
+  void TearDown() override {
+  }
+};
+
+TEST_F(OpboxPeerPoolTest, idlePeerReconnects) {
+  int rc;
+  const uint32_t length = 4096;
+
+  faodel::nodeid_t myid = opbox::GetMyID();
+
+  std::vector<faodel::nodeid_t> gather_result(mpi_size);
+  MPI_Allgather(&myid, sizeof(faodel::nodeid_t), MPI_CHAR, gather_result.data(), sizeof(faodel::nodeid_t), MPI_CHAR,
+                MPI_COMM_WORLD);
+
+  //The root exposes a buffer for the others to read
+  DataObject src(0, length, DataObject::AllocatorType::eager);
+  opbox::net::NetBufferLocal *nbl = nullptr;
+  opbox::net::NetBufferRemote nbr;
+  if(mpi_rank == root_rank) {
+    memset(src.GetDataPtr(), 7, length);
+    opbox::net::GetRdmaPtr(&src, &nbl, &nbr);
+  }
+  MPI_Bcast(&nbr, MAX_NET_BUFFER_REMOTE_SIZE, MPI_CHAR, root_rank, MPI_COMM_WORLD);
+
+  if(mpi_rank != root_rank) {
+    //Connecting to ourself closes the root's connection. The root's peer
+    //stays valid, and the Get on it has to reopen the connection.
+    opbox::net::peer_t *root_peer, *self_peer, *root_peer2;
+    rc = opbox::net::Connect(&root_peer, gather_result[root_rank]);
+    EXPECT_EQ(rc, 0);
+    rc = opbox::net::Connect(&self_peer, myid);
+    EXPECT_EQ(rc, 0);
+    EXPECT_NE(root_peer, self_peer);
+
+    DataObject dst(0, length, DataObject::AllocatorType::eager);
+    memset(dst.GetDataPtr(), 0, length);
+
+    std::promise<opbox::UpdateType> done;
+    std::future<opbox::UpdateType> done_future = done.get_future();
+    opbox::net::Get(root_peer, &nbr, dst,
+                    [&done](OpArgs *args) {
+                      done.set_value(args->type);
+                      return opbox::WaitingType::done_and_destroy;
+                    });
+    ASSERT_EQ(std::future_status::ready, done_future.wait_for(std::chrono::seconds(10)));
+    EXPECT_EQ(opbox::UpdateType::get_success, done_future.get());
+
+    char *payload = dst.GetDataPtr<char *>();
+    int mismatches = 0;
+    for(uint32_t i = 0; i<length; i++) {
+      if(payload[i] != 7) mismatches++;
+    }
+    EXPECT_EQ(0, mismatches);
+
+    rc = opbox::net::Connect(&root_peer2, gather_result[root_rank]);
+    EXPECT_EQ(rc, 0);
+    EXPECT_EQ(root_peer, root_peer2);
+
+    rc = opbox::net::Disconnect(gather_result[root_rank]);
+    EXPECT_EQ(rc, 0);
+    rc = opbox::net::Disconnect(myid);
+    EXPECT_EQ(rc, 0);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
+int main(int argc, char **argv) {
+
+  ::testing::InitGoogleTest(&argc, argv);
+  int provided;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+
+  int mpi_rank, mpi_size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+
+  bootstrap::Start(Configuration(peer_pool_config_string), opbox::bootstrap);
+
+  int rc = RUN_ALL_TESTS();
+  cout << "Tester completed all tests.\n";
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  bootstrap::Finish();
+
+  MPI_Finalize();
+  return rc;
+}
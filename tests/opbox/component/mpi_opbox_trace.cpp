@@ -0,0 +1,218 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+//
+//  Test: mpi_opbox_trace
+//  Purpose: Verify op trace ids travel from origin to target and back, and
+//           that each node writes a trace file at finish
+
+
+#include <mpi.h>
+
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iostream>
+
+#include "gtest/gtest.h"
+
+#include "faodel-common/Common.hh"
+#include "opbox/OpBox.hh"
+#include "opbox/common/MessageHelpers.hh"
+#include "opbox/core/OpTracer.hh"
+#include "opbox/ops/OpHelpers.hh"
+
+#include "support/Globals.hh"
+
+using namespace std;
+using namespace faodel;
+using namespace opbox;
+
+//Globals holds mpi info and manages connections (see ping example for info)
+Globals G;
+
+string default_config_string = R"EOF(
+# Note: node_role is defined when we determine if this is a client or a server
+
+tester.whookie.port 1991
+rooter.whookie.port 1992
+server.whookie.port 2000
+
+dirman.root_role rooter
+dirman.type centralized
+
+opbox.trace.enable       true
+opbox.trace.file_prefix  ./mpi_opbox_trace
+)EOF";
+
+
+//Trace ids observed by each leg of an echo exchange
+struct trace_report_t {
+  uint32_t origin_id;  //Id the origin op was given at launch
+  uint32_t target_id;  //Id the target op adopted from the request
+  uint32_t reply_id;   //Id carried in the target's reply header
+};
+
+/**
+ * @brief Minimal op that has the target report the trace id it adopted
+ */
+class OpTraceEcho : public Op {
+  enum class State : int { start=0, wait_reply, wait_sent, done };
+
+public:
+  explicit OpTraceEcho(net::peer_ptr_t dst) : Op(true), state(State::start), peer(dst) {
+    AllocateStringRequestMessage(ldo_msg, NODE_UNSPECIFIED, GetAssignedMailbox(), op_id, 0, "echo");
+  }
+  explicit OpTraceEcho(op_create_as_target_t t) : Op(t), state(State::start), peer(nullptr) {}
+
+  future<trace_report_t> GetFuture() { return report_promise.get_future(); }
+
+  const static unsigned int op_id;
+  const static string op_name;
+  unsigned int getOpID() const override { return op_id; }
+  string getOpName() const override { return op_name; }
+  string GetStateName() const override { return "State-"+to_string(static_cast<int>(state)); }
+
+  WaitingType UpdateOrigin(OpArgs *args) override {
+    switch(state) {
+      case State::start:
+        net::SendMsg(peer, std::move(ldo_msg));
+        state = State::wait_reply;
+        return WaitingType::waiting_on_cq;
+      case State::wait_reply: {
+        auto msg = args->ExpectMessageOrDie<message_t *>();
+        report_promise.set_value({GetTraceID(),
+                           static_cast<uint32_t>(stoul(UnpackStringMessage(msg))),
+                           msg->trace_id});
+        state = State::done;
+        return WaitingType::done_and_destroy;
+      }
+      default: break;
+    }
+    return WaitingType::error;
+  }
+
+  WaitingType UpdateTarget(OpArgs *args) override {
+    switch(state) {
+      case State::start: {
+        auto msg = args->ExpectMessageOrDie<message_t *>(&peer);
+        AllocateStringReplyMessage(ldo_msg, msg, 0, to_string(GetTraceID()));
+        net::SendMsg(peer, std::move(ldo_msg), AllEventsCallback(this));
+        state = State::wait_sent;
+        return WaitingType::waiting_on_cq;
+      }
+      case State::wait_sent:
+        state = State::done;
+        return WaitingType::done_and_destroy;
+      default: break;
+    }
+    return WaitingType::error;
+  }
+
+private:
+  State state;
+  net::peer_t *peer;
+  lunasa::DataObject ldo_msg;
+  promise<trace_report_t> report_promise;
+};
+const unsigned int OpTraceEcho::op_id = const_hash("OpTraceEcho");
+const string OpTraceEcho::op_name = "OpTraceEcho";
+
+
+class MPITraceTest : public testing::Test {
+protected:
+  void SetUp() override {  }
+  void TearDown() override {  }
+};
+
+TEST_F(MPITraceTest, IdsFollowExchange) {
+
+  auto op = new OpTraceEcho(G.peers[1]);
+  auto fut = op->GetFuture();
+  opbox::LaunchOp(op);
+
+  auto report = fut.get();
+  EXPECT_NE(0, report.origin_id);
+  EXPECT_EQ(report.origin_id, report.target_id);
+  EXPECT_EQ(report.origin_id, report.reply_id);
+}
+
+TEST_F(MPITraceTest, UniqueIds) {
+  const int num_ops = 8;
+  vector<future<trace_report_t>> futs;
+  for(int i=0; i<num_ops; i++) {
+    auto op = new OpTraceEcho(G.peers[1]);
+    futs.push_back(op->GetFuture());
+    opbox::LaunchOp(op);
+  }
+  set<uint32_t> ids;
+  for(auto &f : futs) {
+    auto report = f.get();
+    EXPECT_EQ(report.origin_id, report.target_id);
+    ids.insert(report.origin_id);
+  }
+  EXPECT_EQ(num_ops, ids.size());
+}
+
+TEST_F(MPITraceTest, OnlyMessagesStamped) {
+  opbox::internal::OpTracer::current_trace_id = 0x1234;
+
+  //Made by NewMessage, so it holds a message_t
+  auto ldo_msg = net::NewMessage(sizeof(message_t)+16);
+  opbox::internal::OpTracer::StampOutgoingMessage(ldo_msg);
+  EXPECT_EQ(0x1234, ldo_msg.GetDataPtr<message_t *>()->trace_id);
+
+  //Raw user data that happens to be big enough for a header
+  lunasa::DataObject ldo_raw(0, sizeof(message_t)+16, lunasa::DataObject::AllocatorType::eager);
+  memset(ldo_raw.GetDataPtr(), 0xAB, ldo_raw.GetDataSize());
+  opbox::internal::OpTracer::StampOutgoingMessage(ldo_raw);
+  auto *bytes = ldo_raw.GetDataPtr<uint8_t *>();
+  for(uint32_t i=0; i<ldo_raw.GetDataSize(); i++)
+    EXPECT_EQ(0xAB, bytes[i]);
+
+  opbox::internal::OpTracer::current_trace_id = 0;
+}
+
+void targetLoop(){
+  G.dump();
+}
+
+
+int main(int argc, char **argv){
+
+  int rc=0;
+
+  ::testing::InitGoogleTest(&argc, argv);
+
+  opbox::RegisterOp<OpTraceEcho>();
+  faodel::Configuration config(default_config_string);
+  G.StartAll(argc, argv, config);
+
+  if (G.mpi_size < 2) {
+      std::cerr << "This test requires at least two ranks.  Aborting..." << std::endl;
+      exit(-1);
+  }
+
+  string trace_file = "./mpi_opbox_trace."+G.myid.GetHex()+".json";
+
+  if(G.mpi_rank==0){
+    rc = RUN_ALL_TESTS();
+    sleep(1);
+  } else {
+    targetLoop();
+    sleep(1);
+  }
+
+  G.StopAll();
+
+  //Finish should have dumped this node's spans
+  ifstream f(trace_file);
+  string contents((istreambuf_iterator<char>(f)), istreambuf_iterator<char>());
+  if(contents.find("OpTraceEcho") == string::npos) {
+    cerr << "Rank "<<G.mpi_rank<<" trace file "<<trace_file<<" missing OpTraceEcho spans\n";
+    rc = -1;
+  }
+
+  return rc;
+}
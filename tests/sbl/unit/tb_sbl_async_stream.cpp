@@ -0,0 +1,175 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+/*
+ * tb_sbl_async_stream.cpp
+ *
+ *  Verify that an async logger filters, formats and counts drops like
+ *  a synchronous logger would.
+ */
+
+#include "faodelConfig.h"
+
+#include "sbl/sbl_boost_headers.hh"
+
+#include <unistd.h>
+#include <string.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sbl/sbl_logger.hh"
+
+
+bool success=true;
+
+#define CHECK(cond, msg) \
+    if (!(cond)) { std::cout << "FAILED: " << msg << std::endl; success=false; }
+
+int count_lines(const std::string &s, const std::string &pattern) {
+    int count=0;
+    std::istringstream iss(s);
+    std::string line;
+    while (std::getline(iss, line)) {
+        if (line.find(pattern) != std::string::npos)
+            count++;
+    }
+    return count;
+}
+
+void test_filter_and_format() {
+    std::stringstream ss;
+    sbl::logger l(ss, sbl::severity_level::info, 64);
+
+    CHECK(l.is_async(), "logger should be async");
+
+    l.debug("", "async.debug message #%d - you should NOT see this", 1);
+    l.info("", "async.info message #%d", 2);
+    l.error("", "async.error message #%d", 3);
+
+    l.set_channel_severity("my_channel", sbl::severity_level::debug);
+    l.debug("my_channel", "async.channel.debug message #%d", 4);
+
+    SBL_LOG_STREAM(l.warning_source(), "my_channel") << "async.stream message #" << 5;
+    SBL_LOG_STREAM(l.debug_source(), "") << "async.stream message #" << 6 << " - you should NOT see this";
+
+    l.flush();
+
+    std::string out = ss.str();
+    std::cout << out;
+    CHECK(count_lines(out, "NOT see this") == 0, "filtered messages were written");
+    CHECK(count_lines(out, "<INFO> [] async.info message #2") == 1, "missing info message");
+    CHECK(count_lines(out, "<ERROR> [] async.error message #3") == 1, "missing error message");
+    CHECK(count_lines(out, "<DEBUG> [my_channel] async.channel.debug message #4") == 1, "missing channel debug message");
+    CHECK(count_lines(out, "<WARN> [my_channel] async.stream message #5") == 1, "missing stream message");
+    CHECK(l.dropped() == 0, "nothing should have been dropped");
+}
+
+void test_drops() {
+    const int num_records=1000;
+    std::stringstream ss;
+    sbl::logger l(ss, sbl::severity_level::debug, 4);
+
+    // the background thread can't keep up with a 4 entry ring
+    for (int i=0;i<num_records;i++) {
+        l.debug("", "drop.debug message #%d", i);
+    }
+    l.flush();
+
+    std::string out = ss.str();
+    uint64_t written = count_lines(out, "drop.debug message");
+    CHECK(l.dropped() > 0, "expected drops with a tiny ring");
+    CHECK(written + l.dropped() == num_records, "written ("<<written<<") + dropped ("<<l.dropped()<<") != "<<num_records);
+    CHECK(count_lines(out, "async_stream dropped") > 0, "drops were not reported in the log");
+}
+
+void test_many_threads() {
+    const int num_threads=4;
+    const int num_records=500;
+    std::stringstream ss;
+    {
+        sbl::logger l(ss, sbl::severity_level::debug, 4096);
+
+        std::vector<std::thread> workers;
+        for (int t=0;t<num_threads;t++) {
+            workers.push_back(std::thread([&l, t, num_records]() {
+                for (int i=0;i<num_records;i++) {
+                    l.info("", "thread %d message %d", t, i);
+                }
+            }));
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+        CHECK(l.dropped() == 0, "nothing should have been dropped");
+        // destroying the logger writes everything that is still queued
+    }
+
+    std::string out = ss.str();
+    CHECK(count_lines(out, "thread ") == num_threads*num_records, "missing records");
+
+    // each thread's records must come out in the order they were logged
+    for (int t=0;t<num_threads;t++) {
+        std::string prefix = "thread "+std::to_string(t)+" message ";
+        std::istringstream iss(out);
+        std::string line;
+        int next=0;
+        while (std::getline(iss, line)) {
+            auto pos = line.find(prefix);
+            if (pos == std::string::npos)
+                continue;
+            int n = std::stoi(line.substr(pos+prefix.size()));
+            CHECK(n == next, "thread "<<t<<" out of order: expected "<<next<<" got "<<n);
+            next = n+1;
+        }
+    }
+}
+
+void test_thread_exit() {
+    const int num_threads=8;
+    const int num_records=200;
+    std::stringstream ss;
+    sbl::async_stream as(ss, sbl::severity_level::debug, 16);
+    sbl::source src(sbl::severity_level::info);
+    src.set_async_stream(&as);
+
+    // short lived threads with small rings, so some records are dropped
+    for (int t=0;t<num_threads;t++) {
+        std::thread worker([&src, t, num_records]() {
+            for (int i=0;i<num_records;i++) {
+                SBL_LOG_STREAM(src, "exit") << "exiting thread " << t << " message " << i;
+            }
+        });
+        worker.join();
+    }
+    as.flush();
+    as.flush();
+
+    std::string out = ss.str();
+    uint64_t written = count_lines(out, "exiting thread");
+    CHECK(as.num_rings() == 0, "rings of exited threads were not freed ("<<as.num_rings()<<" left)");
+    CHECK(written + as.dropped() == num_threads*num_records,
+          "written ("<<written<<") + dropped ("<<as.dropped()<<") != "<<num_threads*num_records);
+}
+
+int main(int argc, char *argv[])
+{
+    test_filter_and_format();
+
+    test_drops();
+
+    test_many_threads();
+
+    test_thread_exit();
+
+    if (success)
+        std::cout << "\nEnd Result: TEST PASSED" << std::endl;
+    else
+        std::cout << "\nEnd Result: TEST FAILED" << std::endl;
+
+    return (success ? 0 : 1 );
+}
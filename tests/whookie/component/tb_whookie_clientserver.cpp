@@ -6,8 +6,11 @@
 #include <fstream>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <chrono>
 
 #include <mpi.h>
+#include <boost/asio.hpp>
 
 #include <gtest/gtest.h>
 
@@ -26,6 +29,7 @@ int num_tests=0;
 
 string default_config = R"EOF(
 whookie.port 1996
+whookie.idle_timeout_ms 1000
 
 #bootstrap.debug true
 #whookie.debug true
@@ -232,6 +236,188 @@ TEST_F(ClientServer, ManyRequests){
 
 
 
+// Read one http reply off a socket that is kept open. Handles both
+// Content-Length and chunked replies
+int readReply(boost::asio::ip::tcp::socket &socket, boost::asio::streambuf &response,
+              map<string,string> *headers, string *content) {
+
+  boost::asio::read_until(socket, response, "\r\n\r\n");
+  istream response_stream(&response);
+  string http_version, line;
+  int status_code;
+  response_stream >> http_version >> status_code;
+  getline(response_stream, line);
+  while(getline(response_stream, line) && (line != "\r")) {
+    size_t p = line.find(": ");
+    if(p!=string::npos) (*headers)[line.substr(0,p)] = line.substr(p+2, line.size()-p-3);
+  }
+
+  auto readBytes = [&](size_t num) {
+    if(response.size() < num)
+      boost::asio::read(socket, response, boost::asio::transfer_at_least(num - response.size()));
+    string data(num, '\0');
+    response_stream.read(&data[0], num);
+    return data;
+  };
+
+  content->clear();
+  if(headers->count("Content-Length")) {
+    *content = readBytes(stoul((*headers)["Content-Length"]));
+  } else {
+    while(true) {
+      boost::asio::read_until(socket, response, "\r\n");
+      getline(response_stream, line);
+      size_t chunk_size = stoul(line, nullptr, 16);
+      *content += readBytes(chunk_size + 2).substr(0, chunk_size);
+      if(chunk_size==0) break;
+    }
+  }
+  return status_code;
+}
+
+// Make several requests over one connection and check large replies are chunked
+TEST_F(ClientServer, KeepAliveChunked){
+
+  whookie::Server::registerHook("/test_big", [] (const map<string,string> &args, stringstream &results) {
+      faodel::ReplyStream rs(args, "Big", &results);
+      for(int i=0; i<20000; i++)
+        rs.mkText("Line "+to_string(i));
+      rs.Finish();
+    });
+  whookie::Server::registerHook("/test_small", [] (const map<string,string> &args, stringstream &results) {
+      results<<"small";
+    });
+
+  string expected_big;
+  for(int i=0; i<20000; i++)
+    expected_big += "Line "+to_string(i)+"\n";
+
+  string server, port;
+  server_node.GetIPPort(&server, &port);
+
+  boost::asio::io_service io_service;
+  boost::asio::ip::tcp::resolver resolver(io_service);
+  boost::asio::ip::tcp::socket socket(io_service);
+  boost::asio::connect(socket, resolver.resolve({server, port}));
+  boost::asio::streambuf response;
+
+  for(int i=0; i<3; i++) {
+    map<string,string> headers;
+    string content;
+
+    string request = "GET /test_big&format=txt HTTP/1.1\r\nHost: "+server+"\r\n\r\n";
+    boost::asio::write(socket, boost::asio::buffer(request));
+    EXPECT_EQ(200, readReply(socket, response, &headers, &content));
+    EXPECT_EQ("chunked", headers["Transfer-Encoding"]);
+    EXPECT_EQ(expected_big, content);
+
+    headers.clear();
+    request = "GET /test_small HTTP/1.1\r\nHost: "+server+"\r\n\r\n";
+    boost::asio::write(socket, boost::asio::buffer(request));
+    EXPECT_EQ(200, readReply(socket, response, &headers, &content));
+    EXPECT_EQ("5", headers["Content-Length"]);
+    EXPECT_EQ("keep-alive", headers["Connection"]);
+    EXPECT_EQ("small", content);
+  }
+
+  //Missing hooks still get a reply with a length, so the connection stays usable
+  map<string,string> headers;
+  string content;
+  string request = "GET /test_missing HTTP/1.1\r\nHost: "+server+"\r\nConnection: close\r\n\r\n";
+  boost::asio::write(socket, boost::asio::buffer(request));
+  EXPECT_EQ(404, readReply(socket, response, &headers, &content));
+  EXPECT_EQ("close", headers["Connection"]);
+
+  int rc;
+  rc=whookie::Server::deregisterHook("/test_big");   EXPECT_EQ(0,rc);
+  rc=whookie::Server::deregisterHook("/test_small"); EXPECT_EQ(0,rc);
+}
+
+// The server closes a keep-alive connection once the client has been idle for whookie.idle_timeout_ms
+TEST_F(ClientServer, KeepAliveIdleTimeout){
+
+  whookie::Server::registerHook("/test_idle", [] (const map<string,string> &args, stringstream &results) {
+      results<<"idle";
+    });
+
+  string server, port;
+  server_node.GetIPPort(&server, &port);
+
+  boost::asio::io_service io_service;
+  boost::asio::ip::tcp::resolver resolver(io_service);
+  boost::asio::ip::tcp::socket socket(io_service);
+  boost::asio::connect(socket, resolver.resolve({server, port}));
+  boost::asio::streambuf response;
+
+  map<string,string> headers;
+  string content;
+  string request = "GET /test_idle HTTP/1.1\r\nHost: "+server+"\r\n\r\n";
+  boost::asio::write(socket, boost::asio::buffer(request));
+  EXPECT_EQ(200, readReply(socket, response, &headers, &content));
+  EXPECT_EQ("keep-alive", headers["Connection"]);
+  EXPECT_EQ("idle", content);
+
+  //Say nothing. The server should hang up on us after about a second
+  struct timeval tv = { 10, 0 }; //Don't hang the test if the server never closes
+  setsockopt(socket.native_handle(), SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  auto start = chrono::steady_clock::now();
+  boost::system::error_code ec;
+  char c;
+  socket.read_some(boost::asio::buffer(&c, 1), ec);
+  auto waited_ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(boost::asio::error::eof, ec);
+  EXPECT_GE(waited_ms, 500);
+  EXPECT_LT(waited_ms, 9000);
+
+  int rc=whookie::Server::deregisterHook("/test_idle"); EXPECT_EQ(0,rc);
+}
+
+// A slow hook should not block other hooks, and deregistering it waits for it to finish
+TEST_F(ClientServer, SlowHook){
+
+  atomic<bool> slow_started(false), release_slow(false), slow_finished(false), deregistered(false);
+
+  whookie::Server::registerHook("/test_slow", [&] (const map<string,string> &args, stringstream &results) {
+      slow_started = true;
+      for(int i=0; (i<1000) && (!release_slow); i++)
+        this_thread::sleep_for(chrono::milliseconds(10));
+      results<<"slow";
+      slow_finished = true;
+    });
+  whookie::Server::registerHook("/test_fast", [] (const map<string,string> &args, stringstream &results) {
+      results<<"fast";
+    });
+
+  string slow_result;
+  thread th_slow([&]() { whookie::retrieveData(server_node, "/test_slow", &slow_result); });
+  while(!slow_started) this_thread::sleep_for(chrono::milliseconds(1));
+
+  //Other hooks still get served while the slow one runs
+  string fast_result;
+  EXPECT_EQ(0, whookie::retrieveData(server_node, "/test_fast", &fast_result));
+  EXPECT_EQ("fast", fast_result);
+  EXPECT_FALSE(slow_finished);
+
+  //Deregistering must not return while the hook is still running
+  thread th_dereg([&]() {
+      EXPECT_EQ(0, whookie::Server::deregisterHook("/test_slow"));
+      EXPECT_TRUE(slow_finished);
+      deregistered = true;
+    });
+  this_thread::sleep_for(chrono::milliseconds(100));
+  EXPECT_FALSE(deregistered);
+
+  release_slow = true;
+  th_dereg.join();
+  th_slow.join();
+  EXPECT_TRUE(deregistered);
+  EXPECT_EQ("slow", slow_result);
+
+  int rc=whookie::Server::deregisterHook("/test_fast"); EXPECT_EQ(0,rc);
+}
+
+
+
 int main(int argc, char **argv){
 
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,200 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#include <algorithm>
+#include <iostream>
+#include <functional>
+
+#include "faodelConfig.h"
+#ifdef Faodel_ENABLE_MPI_SUPPORT
+#include <mpi.h>
+#endif
+
+
+#include "faodel-common/Configuration.hh"
+#include "faodel-common/Bootstrap.hh"
+#include "faodel-common/StringHelpers.hh"
+
+#include "opbox/OpBox.hh"
+
+#include "faodel_cli.hh"
+#include "NetBenchParams.hh"
+
+using namespace std;
+
+NetBenchParams::NetBenchParams(const std::vector<std::string> &args)
+        : mpi_rank(0), mpi_size(1),
+          max_size(0),
+          iterations(1000), warmup(100),
+          tolerance(0.10),
+          failed(false) {
+
+  //Parse our args
+  failed = (parseArgs(args) != 0);
+  if(failed) return;
+
+  #ifndef Faodel_ENABLE_MPI_SUPPORT
+    cerr << "net-bench runs as an MPI job, but this build does not have MPI support\n";
+    failed = true;
+    return;
+  #else
+
+    //The transport comes from the user's config (eg FAODEL_CONFIG), so any transport can be measured
+    faodel::Configuration config;
+    config.AppendFromReferences();
+    config.GetLowercaseString(&transport_name, "net.transport.name", "mpi");
+
+    if(global_verbose_level>1) {
+      config.Append("opbox.debug", "true");
+      config.Append("bootstrap.debug", "true");
+    }
+
+    //Launch MPI. The transport's progress thread may make MPI calls too.
+    int provided;
+    MPI_Init_thread(nullptr, nullptr, MPI_THREAD_MULTIPLE, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+    global_rank=mpi_rank;
+
+    if(mpi_size<2) {
+      warn0("net-bench needs at least two ranks. Rank 0 issues operations and rank 1 is the target");
+      MPI_Finalize();
+      failed = true;
+      return;
+    }
+
+    //Init opbox, but leave the Start to the caller so it can register a recv callback first
+    faodel::bootstrap::Init(config, opbox::bootstrap);
+  #endif
+}
+
+NetBenchParams::~NetBenchParams() {
+
+  if(!failed) {
+
+    #ifdef Faodel_ENABLE_MPI_SUPPORT
+      MPI_Barrier(MPI_COMM_WORLD);
+      faodel::bootstrap::Finish();
+
+      MPI_Barrier(MPI_COMM_WORLD);
+      dbg0("Finalizing");
+      MPI_Finalize();
+    #endif
+    dbg0("Exiting");
+
+  }
+}
+
+void NetBenchParams::dumpSettings() {
+  if((failed)||(mpi_rank!=0)) return;
+
+  cout << "# Runtime Configuration\n"
+       << "#   mpi_size:                   "<<mpi_size << endl
+       << "#   transport:                  "<<transport_name << endl
+       << "#   ops:                        "<<faodel::Join(ops, ',') << endl
+       << "#   sizes:                     ";
+  for(auto x:sizes)         cout <<" "<<x;
+  cout << endl
+       << "#   windows:                   ";
+  for(auto x:windows)       cout <<" "<<x;
+  cout << endl
+       << "#   threads:                   ";
+  for(auto x:thread_counts) cout <<" "<<x;
+  cout << endl
+       << "#   iterations:                 "<<iterations << endl
+       << "#   warmup:                     "<<warmup << endl
+       << "#   json_file:                  "<<json_file << endl
+       << "#   baseline_file:              "<<baseline_file << endl
+       << "#   tolerance:                  "<<tolerance << endl;
+}
+
+//Parse a comma-separated list of numbers that may have units (eg 1k,2M)
+static int parseList(vector<uint64_t> *vals, const string &s, const string &name) {
+  vals->clear();
+  for(auto sval : faodel::Split(s, ',', true)) {
+    uint64_t x;
+    if((faodel::StringToUInt64(&x, sval) != 0) || (x==0)) {
+      cerr << "Parse error with " << name << " for '" << sval << "'\n";
+      return EINVAL;
+    }
+    vals->push_back(x);
+  }
+  return 0;
+}
+
+int NetBenchParams::parseArgs(const std::vector<std::string> &args) {
+
+  string s_ops="send,get,put";
+  string s_sizes="8,1k,64k";
+  string s_windows="1,8";
+  string s_threads="1";
+  uint64_t tolerance_pct=10;
+  int rc=0;
+
+  struct ArgInfo { string short_name; string long_name; bool has_argument; std::function<int(const string&)> lambda; };
+  vector<ArgInfo> options {
+          { "-o", "--ops",        true,  [&s_ops](const string &s) { s_ops = s; return 0; } },
+          { "-s", "--sizes",      true,  [&s_sizes](const string &s) { s_sizes = s; return 0; } },
+          { "-w", "--windows",    true,  [&s_windows](const string &s) { s_windows = s; return 0; } },
+          { "-t", "--threads",    true,  [&s_threads](const string &s) { s_threads = s; return 0; } },
+          { "-i", "--iterations", true,  [=](const string &s) { return faodel::StringToUInt64(&this->iterations, s); } },
+          { "-W", "--warmup",     true,  [=](const string &s) { return faodel::StringToUInt64(&this->warmup, s); } },
+          { "-j", "--json",       true,  [=](const string &s) { this->json_file = s; return 0; } },
+          { "-b", "--baseline",   true,  [=](const string &s) { this->baseline_file = s; return 0; } },
+          { "-R", "--tolerance",  true,  [&tolerance_pct](const string &s) { return faodel::StringToUInt64(&tolerance_pct, s); } }
+  };
+  for(size_t i=0; i<args.size(); i++) {
+    bool found=false;
+    for(auto &option : options) {
+      if((option.short_name == args[i]) || (option.long_name == args[i])) {
+        if(option.has_argument) {
+          i++;
+          if(i >= args.size()) {
+            cerr << "Not enough arguments for " << option.short_name << "/" << option.long_name << endl;
+            return -1;
+          }
+        }
+        rc = option.lambda(args[i]);
+        if(rc != 0) {
+          cerr << "Problem parsing " << option.short_name << "/" << option.long_name << endl;
+          return -1;
+        }
+        found = true;
+        break;
+      }
+    }
+    if(!found) {
+      cerr <<"Unknown option "<<args[i]<<endl;
+      return -1;
+    }
+  }
+
+
+  //Verify values we were given
+  ops = faodel::Split(faodel::ToLowercase(s_ops), ',', true);
+  for(auto &op : ops) {
+    if((op!="send") && (op!="get") && (op!="put")) {
+      cerr << "Unknown op '" << op << "'. Valid ops are send, get, and put\n";
+      return EINVAL;
+    }
+  }
+  if(ops.empty()) { cerr << "No ops given\n"; return EINVAL; }
+
+  rc = parseList(&sizes, s_sizes, "sizes");           if(rc) return rc;
+  rc = parseList(&windows, s_windows, "windows");     if(rc) return rc;
+  rc = parseList(&thread_counts, s_threads, "threads"); if(rc) return rc;
+
+  max_size = *std::max_element(sizes.begin(), sizes.end());
+
+  if(iterations<1) { cerr<<"Iterations must be greater than 0\n"; return EINVAL; }
+  tolerance = (double)tolerance_pct / 100.0;
+
+  return 0;
+}
+
+void NetBenchParams::barrier() {
+  #ifdef Faodel_ENABLE_MPI_SUPPORT
+    MPI_Barrier(MPI_COMM_WORLD);
+  #endif
+}
@@ -0,0 +1,55 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#ifndef FAODEL_NETBENCHPARAMS_HH
+#define FAODEL_NETBENCHPARAMS_HH
+
+#include <string>
+#include <vector>
+
+#include "faodel-common/Common.hh"
+
+
+class NetBenchParams {
+public:
+
+  NetBenchParams() = delete;
+  NetBenchParams(const std::vector<std::string> &args);
+  ~NetBenchParams();
+
+
+  int mpi_rank;
+  int mpi_size;
+
+  std::string transport_name;
+
+  std::vector<std::string> ops;
+  std::vector<uint64_t> sizes;
+  std::vector<uint64_t> windows;
+  std::vector<uint64_t> thread_counts;
+  uint64_t max_size;
+
+  uint64_t iterations;
+  uint64_t warmup;
+
+  std::string json_file;
+  std::string baseline_file;
+  double tolerance; //Fraction a result may get worse than the baseline before it is a regression
+
+  void barrier();
+
+  void dumpSettings();
+
+  bool IsOk() { return !failed; }
+
+private:
+
+  bool failed;
+
+  int parseArgs(const std::vector<std::string> &args);
+
+};
+
+
+#endif //FAODEL_NETBENCHPARAMS_HH
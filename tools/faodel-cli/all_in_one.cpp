@@ -7,7 +7,10 @@
 #include <thread>
 #include <iostream>
 
+#include "faodelConfig.h"
+#ifdef Faodel_ENABLE_MPI_SUPPORT
 #include <mpi.h>
+#endif
 
 #include "whookie/client/Client.hh"
 #include "whookie/Server.hh"
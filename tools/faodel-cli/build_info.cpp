@@ -154,6 +154,26 @@ void show_cmake_nnti_config(void) {
 #  endif
 #endif
 
+#if (NNTI_BUILD_SHM)
+  fprintf(stdout, "     Building the SHM Transport\n");
+#else
+#  if(NNTI_DISABLE_SHM_TRANSPORT)
+  fprintf(stdout, "     SHM Transport explicitly disabled\n");
+#  else
+  fprintf(stdout, "     Not building the SHM Transport\n");
+#  endif
+#endif
+
+#if (NNTI_BUILD_SOCKETS)
+  fprintf(stdout, "     Building the Sockets Transport\n");
+#else
+#  if(NNTI_DISABLE_SOCKETS_TRANSPORT)
+  fprintf(stdout, "     Sockets Transport explicitly disabled\n");
+#  else
+  fprintf(stdout, "     Not building the Sockets Transport\n");
+#  endif
+#endif
+
 #if (NNTI_USE_XDR)
   fprintf(stdout, "     Using XDR for serialization\n");
 #elif (NNTI_USE_CEREAL)
@@ -97,6 +97,7 @@ int dumpHelp(string subcommand) {
   found |= dumpHelpKelpieServer(subcommand);
   found |= dumpHelpKelpieClient(subcommand);
   found |= dumpHelpKelpieBlast(subcommand);
+  found |= dumpHelpNetBench(subcommand);
   found |= dumpHelpAllInOne(subcommand);
   found |= dumpHelpPlay(subcommand);
 
@@ -215,6 +216,7 @@ int main(int argc, char **argv) {
     if(rc==ENOENT) rc = checkKelpieServerCommands(cmd, args);
     if(rc==ENOENT) rc = checkKelpieClientCommands(cmd, args);
     if(rc==ENOENT) rc = checkKelpieBlastCommands(cmd, args);
+    if(rc==ENOENT) rc = checkNetBenchCommands(cmd, args);
     if(rc==ENOENT) rc = checkPlayCommands(cmd, args);
 
 
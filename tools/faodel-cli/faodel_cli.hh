@@ -43,6 +43,7 @@ bool dumpHelpResource(std::string subcommand);
 bool dumpHelpKelpieServer(std::string subcommand);
 bool dumpHelpKelpieClient(std::string subcommand);
 bool dumpHelpKelpieBlast(std::string subcommand);
+bool dumpHelpNetBench(std::string subcommand);
 bool dumpHelpPlay(std::string subcommand);
 bool dumpHelpWhookieClient(std::string subcommand);
 
@@ -55,6 +56,7 @@ int checkResourceCommands(      const std::string &cmd, const std::vector<std::s
 int checkKelpieServerCommands(  const std::string &cmd, const std::vector<std::string> &args);
 int checkKelpieClientCommands(  const std::string &cmd, const std::vector<std::string> &args);
 int checkKelpieBlastCommands(   const std::string &cmd, const std::vector<std::string> &args);
+int checkNetBenchCommands(      const std::string &cmd, const std::vector<std::string> &args);
 int checkPlayCommands(          const std::string &cmd, const std::vector<std::string> &args);
 int checkWhookieClientCommands( const std::string &cmd, const std::vector<std::string> &args);
 
@@ -0,0 +1,496 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "faodelConfig.h"
+#ifdef Faodel_ENABLE_MPI_SUPPORT
+#include <mpi.h>
+#endif
+
+#include "faodel-common/StringHelpers.hh"
+#include "lunasa/DataObject.hh"
+#include "opbox/OpBox.hh"
+#include "opbox/net/net.hh"
+
+#include "faodel_cli.hh"
+#include "NetBenchParams.hh"
+
+using namespace std;
+using namespace faodel;
+
+int netBench(const vector<string> &args);
+
+bool dumpHelpNetBench(string subcommand) {
+   string help_nbench[5] = {
+          "net-bench", "nbench", "", "Run MPI job to measure opbox network performance",
+          R"(
+net-bench Options:
+ -o/--ops x,y            : Operations to measure: send, get, put (default = all)
+ -s/--sizes x,y          : Message/transfer sizes in bytes (default = 8,1k,64k)
+ -w/--windows x,y        : Operations each thread keeps in flight (default = 1,8)
+ -t/--threads x,y        : Number of issuing threads on rank 0 (default = 1)
+ -i/--iterations x       : Timed operations per thread per test (default = 1000)
+ -W/--warmup x           : Untimed operations per thread per test (default = 100)
+
+ -j/--json file          : Also write the results to file in json format
+ -b/--baseline file      : Compare results to a json file from an earlier run
+ -R/--tolerance x        : Percent a result may be worse than the baseline
+                           before it is reported as a regression (default = 10)
+
+The net-bench command measures the opbox network layer directly, so the same
+run can be repeated on every transport by changing net.transport.name in the
+configuration (eg, via FAODEL_CONFIG). Rank 0 issues operations and rank 1 is
+the target. Every combination of op, size, thread count, and window size is
+measured. A send is a round trip: the target replies with a message of the
+same size. Send sizes include a small header and are rounded up to fit it.
+
+When a baseline is given, a result is a regression if its P99 latency grew or
+its operation rate dropped by more than the tolerance. Regressions make the
+command exit with a nonzero value, so it can be used in nightly testing.
+
+Output Columns:
+ Op:      Which operation was measured
+ Size:    Bytes moved per operation
+ Window:  Operations each thread kept in flight
+ Threads: Number of threads issuing operations
+ Ops:     Number of timed operations
+ P50:     Median operation latency (US)
+ P99:     99th percentile operation latency (US)
+ P999:    99.9th percentile operation latency (US)
+ Ops/s:   Operations completed per second
+ MB/s:    Payload bandwidth (one direction for sends)
+
+Examples:
+ mpirun -n 2 faodel nbench -o get,put -s 1k,1M      # Measure RDMA at two sizes
+ mpirun -n 2 faodel nbench -t 1,4 -w 1,16 -j new.json   # Sweep and save results
+ mpirun -n 2 faodel nbench -j new.json -b old.json  # Check for regressions
+)"
+  };
+
+  bool found=false;
+  found |= dumpSpecificHelp(subcommand, help_nbench);
+  return found;
+}
+
+int checkNetBenchCommands(const std::string &cmd, const vector<string> &args) {
+  if(  (cmd == "net-bench") || (cmd=="nbench")) return netBench(args);
+  return ENOENT;
+}
+
+#ifndef Faodel_ENABLE_MPI_SUPPORT
+
+int netBench(const vector<string> &args) {
+  NetBenchParams p(args); //Reports that mpi is missing
+  return -1;
+}
+
+#else
+
+namespace {
+
+typedef std::chrono::high_resolution_clock bench_clock_t;
+
+//Header at the front of every send. The target copies it into its reply
+struct msg_net_bench_t {
+  opbox::message_t hdr;
+  uint32_t         thread;
+  uint32_t         slot;
+  uint64_t         size;
+};
+
+//Per-thread state on the origin. Slots track the operations in flight.
+struct BenchThread {
+  uint32_t                             id;
+  std::mutex                           mtx;
+  std::condition_variable              cv;
+  vector<bench_clock_t::time_point>    start;
+  vector<uint32_t>                     free_slots;
+  vector<double>                       latencies_us;
+  bool                                 record;
+  lunasa::DataObject                   ldo;
+
+  BenchThread(uint32_t thread_id, uint64_t window, uint64_t max_size)
+    : id(thread_id), start(window), record(false),
+      ldo(0, max_size, lunasa::DataObject::AllocatorType::eager) {
+    for(uint32_t i=0; i<window; i++) free_slots.push_back(i);
+  }
+
+  void Complete(uint32_t slot) {
+    auto now = bench_clock_t::now();
+    lock_guard<mutex> lock(mtx);
+    if(record) latencies_us.push_back(std::chrono::duration<double, std::micro>(now - start[slot]).count());
+    free_slots.push_back(slot);
+    cv.notify_one();
+  }
+};
+
+struct BenchResult {
+  string   op;
+  uint64_t size;
+  uint64_t window;
+  uint64_t threads;
+  uint64_t ops;
+  double   p50_us;
+  double   p99_us;
+  double   p999_us;
+  double   ops_per_sec;
+  double   mb_per_sec;
+
+  string Key() const {
+    return op+"/"+std::to_string(size)+"/"+std::to_string(window)+"/"+std::to_string(threads);
+  }
+};
+
+int                   my_rank = 0;
+vector<BenchThread *> *active_threads = nullptr; //Origin threads that replies are routed to
+
+
+void netBenchRecv(opbox::net::peer_ptr_t peer, opbox::message_t *message) {
+  auto *msg = reinterpret_cast<msg_net_bench_t *>(message);
+
+  if(my_rank==0) {
+    active_threads->at(msg->thread)->Complete(msg->slot);
+    return;
+  }
+
+  //Target: reply with the same size message
+  lunasa::DataObject reply = opbox::net::NewMessage(msg->size);
+  memcpy(reply.GetDataPtr(), msg, sizeof(msg_net_bench_t));
+  opbox::net::SendMsg(peer, reply);
+}
+
+void issueOp(const string &op, uint64_t size, BenchThread *t, uint32_t slot,
+             opbox::net::peer_ptr_t peer, opbox::net::NetBufferRemote *nbr) {
+
+  auto done = [t, slot](opbox::OpArgs *args) {
+    t->Complete(slot);
+    return opbox::WaitingType::done_and_destroy;
+  };
+
+  if(op=="send") {
+    lunasa::DataObject ldo = opbox::net::NewMessage(size);
+    auto *msg = ldo.GetDataPtr<msg_net_bench_t *>();
+    memset((void *)msg, 0, sizeof(msg_net_bench_t));
+    msg->hdr.body_len = sizeof(msg_net_bench_t) - sizeof(opbox::message_t);
+    msg->thread = t->id;
+    msg->slot = slot;
+    msg->size = size;
+    opbox::net::SendMsg(peer, ldo);
+
+  } else if(op=="get") {
+    opbox::net::Get(peer, nbr, 0, t->ldo, 0, size, done);
+
+  } else {
+    opbox::net::Put(peer, t->ldo, 0, nbr, 0, size, done);
+  }
+}
+
+//Keep window ops in flight until num_ops have been issued, then drain
+void runThread(const string &op, uint64_t size, uint64_t window, uint64_t num_ops, BenchThread *t,
+               opbox::net::peer_ptr_t peer, opbox::net::NetBufferRemote *nbr) {
+
+  for(uint64_t i=0; i<num_ops; i++) {
+    unique_lock<mutex> lock(t->mtx);
+    t->cv.wait(lock, [t] { return !t->free_slots.empty(); });
+    uint32_t slot = t->free_slots.back();
+    t->free_slots.pop_back();
+    t->start[slot] = bench_clock_t::now();
+    lock.unlock();
+
+    issueOp(op, size, t, slot, peer, nbr);
+  }
+
+  unique_lock<mutex> lock(t->mtx);
+  t->cv.wait(lock, [t, window] { return t->free_slots.size()==window; });
+}
+
+//Run all threads for one phase and return the wall time
+double runPhase(const NetBenchParams &p, const string &op, uint64_t size, uint64_t window,
+                vector<BenchThread *> &threads, uint64_t num_ops, bool record,
+                opbox::net::peer_ptr_t peer, opbox::net::NetBufferRemote *nbr) {
+
+  for(auto t : threads) t->record = record;
+
+  auto t_start = bench_clock_t::now();
+  vector<std::thread> workers;
+  for(auto t : threads) {
+    workers.push_back(std::thread(runThread, op, size, window, num_ops, t, peer, nbr));
+  }
+  for(auto &w : workers) w.join();
+  auto t_stop = bench_clock_t::now();
+
+  return std::chrono::duration<double>(t_stop - t_start).count();
+}
+
+double percentile(const vector<double> &sorted_vals, double fraction) {
+  if(sorted_vals.empty()) return 0.0;
+  auto idx = static_cast<size_t>(std::ceil(fraction * sorted_vals.size()));
+  if(idx>0) idx--;
+  return sorted_vals[std::min(idx, sorted_vals.size()-1)];
+}
+
+BenchResult runPoint(const NetBenchParams &p, const string &op, uint64_t size, uint64_t window, uint64_t num_threads,
+                     opbox::net::peer_ptr_t peer, opbox::net::NetBufferRemote *nbr) {
+
+  vector<BenchThread *> threads;
+  for(uint32_t i=0; i<num_threads; i++) {
+    threads.push_back(new BenchThread(i, window, p.max_size));
+  }
+  active_threads = &threads;
+
+  if(p.warmup>0) {
+    runPhase(p, op, size, window, threads, p.warmup, false, peer, nbr);
+  }
+  double secs = runPhase(p, op, size, window, threads, p.iterations, true, peer, nbr);
+
+  vector<double> lat;
+  for(auto t : threads) {
+    lat.insert(lat.end(), t->latencies_us.begin(), t->latencies_us.end());
+  }
+  sort(lat.begin(), lat.end());
+
+  active_threads = nullptr;
+  for(auto t : threads) delete t;
+
+  BenchResult r;
+  r.op = op;
+  r.size = size;
+  r.window = window;
+  r.threads = num_threads;
+  r.ops = lat.size();
+  r.p50_us  = percentile(lat, 0.50);
+  r.p99_us  = percentile(lat, 0.99);
+  r.p999_us = percentile(lat, 0.999);
+  r.ops_per_sec = (secs>0) ? static_cast<double>(r.ops) / secs : 0.0;
+  r.mb_per_sec = r.ops_per_sec * static_cast<double>(size) / (1024.0*1024.0);
+  return r;
+}
+
+string fmt(double x) {
+  stringstream ss;
+  ss << std::fixed << std::setprecision(2) << x;
+  return ss.str();
+}
+
+string jsonEscape(const string &s) {
+  string out;
+  for(auto c : s) {
+    if((c=='"') || (c=='\\')) out.push_back('\\');
+    out.push_back(c);
+  }
+  return out;
+}
+
+//Results go one per line so the baseline reader does not need a json parser
+int writeJson(const string &fname, const string &transport, const vector<BenchResult> &results) {
+  ofstream f(fname);
+  if(!f.is_open()) {
+    cerr << "Could not open json file '" << fname << "' for writing\n";
+    return EIO;
+  }
+  f << "{\n"
+    << "\"transport\":\"" << jsonEscape(transport) << "\",\n"
+    << "\"results\":[\n";
+  for(size_t i=0; i<results.size(); i++) {
+    auto &r = results[i];
+    f << "{\"op\":\"" << r.op << "\""
+      << ",\"size\":" << r.size
+      << ",\"window\":" << r.window
+      << ",\"threads\":" << r.threads
+      << ",\"ops\":" << r.ops
+      << ",\"p50_us\":" << fmt(r.p50_us)
+      << ",\"p99_us\":" << fmt(r.p99_us)
+      << ",\"p999_us\":" << fmt(r.p999_us)
+      << ",\"ops_per_sec\":" << fmt(r.ops_per_sec)
+      << ",\"mb_per_sec\":" << fmt(r.mb_per_sec)
+      << "}" << ((i+1<results.size()) ? "," : "") << "\n";
+  }
+  f << "]\n}\n";
+  return 0;
+}
+
+//Pull the value of "name":value out of a line written by writeJson
+string jsonField(const string &line, const string &name) {
+  string tag = "\"" + name + "\":";
+  auto pos = line.find(tag);
+  if(pos==string::npos) return "";
+  pos += tag.size();
+  if((pos<line.size()) && (line[pos]=='"')) {
+    auto end = line.find('"', pos+1);
+    return line.substr(pos+1, end-pos-1);
+  }
+  auto end = line.find_first_of(",}", pos);
+  return line.substr(pos, end-pos);
+}
+
+int readBaseline(const string &fname, string *transport, map<string, BenchResult> *results) {
+  ifstream f(fname);
+  if(!f.is_open()) {
+    cerr << "Could not open baseline file '" << fname << "'\n";
+    return EIO;
+  }
+  string line;
+  bool found_transport=false;
+  int line_num=0;
+  while(getline(f, line)) {
+    line_num++;
+    if(line.find("\"transport\":") != string::npos) {
+      *transport = jsonField(line, "transport");
+      found_transport=true;
+      continue;
+    }
+    if(line.find("\"op\":") == string::npos) continue;
+
+    //Every key writeJson emits has to be here, or the comparison means nothing
+    for(auto &key : {"op","size","window","threads","ops","p50_us","p99_us","p999_us","ops_per_sec","mb_per_sec"}) {
+      if(jsonField(line, key).empty()) {
+        cerr << "Baseline file '" << fname << "' line " << line_num << " is missing \"" << key << "\"\n";
+        return EINVAL;
+      }
+    }
+    BenchResult r;
+    r.op = jsonField(line, "op");
+    r.size        = strtoull(jsonField(line, "size").c_str(), nullptr, 10);
+    r.window      = strtoull(jsonField(line, "window").c_str(), nullptr, 10);
+    r.threads     = strtoull(jsonField(line, "threads").c_str(), nullptr, 10);
+    r.ops         = strtoull(jsonField(line, "ops").c_str(), nullptr, 10);
+    r.p50_us      = strtod(jsonField(line, "p50_us").c_str(), nullptr);
+    r.p99_us      = strtod(jsonField(line, "p99_us").c_str(), nullptr);
+    r.p999_us     = strtod(jsonField(line, "p999_us").c_str(), nullptr);
+    r.ops_per_sec = strtod(jsonField(line, "ops_per_sec").c_str(), nullptr);
+    r.mb_per_sec  = strtod(jsonField(line, "mb_per_sec").c_str(), nullptr);
+    (*results)[r.Key()] = r;
+  }
+  if(!found_transport) {
+    cerr << "Baseline file '" << fname << "' does not name a transport\n";
+    return EINVAL;
+  }
+  if(results->empty()) {
+    cerr << "Baseline file '" << fname << "' has no results\n";
+    return EINVAL;
+  }
+  return 0;
+}
+
+//Returns the number of regressions found
+int compareBaseline(const NetBenchParams &p, const vector<BenchResult> &results) {
+  char sep='\t';
+  string base_transport;
+  map<string, BenchResult> base;
+  if(readBaseline(p.baseline_file, &base_transport, &base) != 0) return 1;
+
+  if(base_transport != p.transport_name) {
+    warn0("Baseline was measured with transport '"+base_transport+"', but this run used '"+p.transport_name+"'");
+  }
+
+  cout << "# Baseline comparison with " << p.baseline_file << "\n";
+  cout << faodel::Join({"Op","Size","Window","Threads","P99","BaseP99","Ops/s","BaseOps/s","Status"}, sep) << "\n";
+
+  int num_regressions=0;
+  for(auto &r : results) {
+    auto it = base.find(r.Key());
+    if(it == base.end()) {
+      cout << faodel::Join({r.op, to_string(r.size), to_string(r.window), to_string(r.threads),
+                            fmt(r.p99_us), "-", fmt(r.ops_per_sec), "-", "new"}, sep) << "\n";
+      continue;
+    }
+    auto &b = it->second;
+    bool slower = (r.p99_us > b.p99_us * (1.0 + p.tolerance)) ||
+                  (r.ops_per_sec < b.ops_per_sec * (1.0 - p.tolerance));
+    if(slower) num_regressions++;
+    cout << faodel::Join({r.op, to_string(r.size), to_string(r.window), to_string(r.threads),
+                          fmt(r.p99_us), fmt(b.p99_us), fmt(r.ops_per_sec), fmt(b.ops_per_sec),
+                          (slower) ? "REGRESSION" : "ok"}, sep) << "\n";
+  }
+  cout << "# " << num_regressions << " regression(s) found\n";
+  return num_regressions;
+}
+
+} // namespace
+
+
+int netBench(const vector<string> &args) {
+
+  char sep='\t';
+
+  NetBenchParams p(args);
+  if(!p.IsOk()) return -1;
+
+  my_rank = p.mpi_rank;
+  opbox::net::RegisterRecvCallback(netBenchRecv);
+  faodel::bootstrap::Start();
+
+  //Exchange ids. Rank 0 connects to rank 1, which exposes a buffer for gets/puts
+  faodel::nodeid_t myid = opbox::net::GetMyID();
+  vector<faodel::nodeid_t> nodeids(p.mpi_size);
+  MPI_Allgather(&myid, sizeof(faodel::nodeid_t), MPI_CHAR, nodeids.data(), sizeof(faodel::nodeid_t), MPI_CHAR,
+                MPI_COMM_WORLD);
+
+  lunasa::DataObject target_ldo;
+  opbox::net::NetBufferRemote nbr;
+  if(p.mpi_rank==1) {
+    target_ldo = lunasa::DataObject(0, p.max_size, lunasa::DataObject::AllocatorType::eager);
+    opbox::net::NetBufferLocal *nbl = nullptr;
+    opbox::net::GetRdmaPtr(&target_ldo, &nbl, &nbr);
+  }
+  MPI_Bcast(&nbr, MAX_NET_BUFFER_REMOTE_SIZE, MPI_CHAR, 1, MPI_COMM_WORLD);
+
+  opbox::net::peer_ptr_t peer = nullptr;
+  if(p.mpi_rank==0) {
+    int rc = opbox::net::Connect(&peer, nodeids[1]);
+    if(rc!=0) {
+      cerr << "Could not connect to target " << nodeids[1].GetHex() << endl;
+      MPI_Abort(MPI_COMM_WORLD, rc);
+    }
+    p.dumpSettings();
+    cout << faodel::Join({"Op","Size","Window","Threads","Ops","P50","P99","P999","Ops/s","MB/s"}, sep) << "\n";
+  }
+
+  //Every rank walks the same sweep so the barriers line up
+  uint64_t min_send_size = sizeof(msg_net_bench_t);
+  vector<BenchResult> results;
+  for(auto &op : p.ops) {
+    for(auto size : p.sizes) {
+      if(op=="send") size = std::max(size, min_send_size);
+      for(auto num_threads : p.thread_counts) {
+        for(auto window : p.windows) {
+          p.barrier();
+          if(p.mpi_rank==0) {
+            auto r = runPoint(p, op, size, window, num_threads, peer, &nbr);
+            cout << faodel::Join({r.op, to_string(r.size), to_string(r.window), to_string(r.threads),
+                                  to_string(r.ops), fmt(r.p50_us), fmt(r.p99_us), fmt(r.p999_us),
+                                  fmt(r.ops_per_sec), fmt(r.mb_per_sec)}, sep) << endl;
+            results.push_back(r);
+          }
+          p.barrier();
+        }
+      }
+    }
+  }
+
+  int rc=0;
+  if(p.mpi_rank==0) {
+    if(!p.json_file.empty()) {
+      rc = writeJson(p.json_file, p.transport_name, results);
+    }
+    if((rc==0) && (!p.baseline_file.empty())) {
+      rc = (compareBaseline(p, results) == 0) ? 0 : 1;
+    }
+  }
+
+  return rc;
+}
+
+#endif
@@ -0,0 +1,78 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#include <iostream>
+#include <map>
+
+#include "Worker.hh"
+#include "JobMutex.hh"
+
+using namespace std;
+
+class WorkerMutex
+        : public Worker {
+
+public:
+  WorkerMutex() = default;
+  WorkerMutex(int id, JobMutex::params_t params)
+          : Worker(id, params.num_ops, 0, 255), params(params) {}
+  ~WorkerMutex() = default;
+
+  void server() {
+    auto mutex = params.mutex;
+    auto &data = *params.data;
+    uint32_t sum = 0;
+    uint32_t op = 0;
+    do {
+      for(uint32_t i=0; i<batch_size; i++) {
+        uint32_t key = prngGetRangedInteger();
+        if((++op % params.write_every) == 0) {
+          mutex->WriterLock();
+          data[key]++;
+          mutex->Unlock();
+        } else {
+          mutex->ReaderLock();
+          auto it = data.find(key);
+          if(it != data.end()) sum += it->second;
+          mutex->Unlock();
+        }
+      }
+      ops_completed += batch_size;
+    } while(!kill_server);
+    if(sum == 0xFFFFFFFF) cout << "";  //Keep the reads from being optimized away
+  }
+private:
+  JobMutex::params_t params;
+};
+
+
+
+JobMutex::JobMutex(const faodel::Configuration &config)
+        : Job(config, JobCategoryName()) {
+
+  for(auto &name_params : options)
+    job_names.push_back(name_params.first);
+
+}
+
+int JobMutex::Execute(const std::string &job_name) {
+
+  auto it = options.find(job_name);
+  if(it == options.end()) return -1;
+
+  //All workers share one mutex and one map
+  std::map<uint32_t,uint32_t> data;
+  for(uint32_t i=0; i<256; i+=2)
+    data[i] = i;
+
+  params_t params = it->second;
+  params.mutex = faodel::GenerateMutex("pthreads", params.mutex_type);
+  params.data = &data;
+
+  std::map<std::string, params_t> run_options = { {job_name, params} };
+  int rc = standardExecuteWorker<WorkerMutex, JobMutex::params_t>(job_name, run_options);
+
+  delete params.mutex;
+  return rc;
+}
@@ -0,0 +1,53 @@
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+
+#ifndef FAODEL_JOBMUTEX_HH
+#define FAODEL_JOBMUTEX_HH
+
+#include <map>
+
+#include "faodel-common/MutexWrapper.hh"
+
+#include "Job.hh"
+
+/***
+ * @brief Hammer a single shared MutexWrapper from all worker threads
+ *
+ * Faodel guards many small structures (eg, LocalKV rows and the DirMan
+ * cache) with a MutexWrapper whose type can be picked in the configuration.
+ * These tests have every worker lock the same mutex, do a tiny bit of work on
+ * a shared map, and unlock. The Exclusive tests always take the lock for
+ * writing while the ReadMostly tests only write 1 out of 10 times.
+ */
+class JobMutex :
+        public Job {
+
+public:
+  explicit JobMutex(const faodel::Configuration &config);
+
+  ~JobMutex() override = default;
+
+  int Execute(const std::string &job_name) override;
+
+  struct params_t {
+    uint32_t num_ops;
+    const char *mutex_type;
+    uint32_t write_every;                  //1: every op writes. N: 1 in N ops write
+    faodel::MutexWrapper *mutex;           //Filled in when the job runs
+    std::map<uint32_t,uint32_t> *data;     //Filled in when the job runs
+  };
+  const std::map<std::string, params_t> options = {
+          {"Exclusive-Lock",         { 1024, "lock",     1,  nullptr, nullptr}},
+          {"Exclusive-Adaptive",     { 1024, "adaptive", 1,  nullptr, nullptr}},
+          {"Exclusive-Ticket",       { 1024, "ticket",   1,  nullptr, nullptr}},
+          {"ReadMostly-RWLock",      { 1024, "rwlock",   10, nullptr, nullptr}},
+          {"ReadMostly-RBRWLock",    { 1024, "rbrwlock", 10, nullptr, nullptr}},
+          {"ReadMostly-Adaptive",    { 1024, "adaptive", 10, nullptr, nullptr}}
+  };
+  constexpr const char* JobCategoryName() { return "mutex"; }
+
+};
+
+
+#endif //FAODEL_JOBMUTEX_HH
@@ -28,17 +28,25 @@ int JobSerdes::Execute(const std::string &job_name) {
 
   auto it = options.find(job_name);
   if (it==options.end()) return -1;
-  dbg("Launching "+to_string(num_threads)+" worker threads");
 
-  vector<Worker *> w_serdes(num_threads);
-  for(int i=0; i<num_threads; i++) {
-    switch(it->second.obj_type) {
-      case 1: w_serdes.at(i) = new WorkerSerdes<SerdesStringObject>(i, it->second); break;
-      case 2: w_serdes.at(i) = new WorkerSerdes<SerdesParticleBundleObject>(i, it->second); break;
-      default:
-        F_ASSERT(0, "Unknown obj_type in JobSerdes");
-    }
+  switch(it->second.obj_type) {
+    case 1: return executeWorkers<SerdesStringObject>(job_name, it->second);
+    case 2: return executeWorkers<SerdesParticleBundleObject>(job_name, it->second);
+    default:
+      F_ASSERT(0, "Unknown obj_type in JobSerdes");
   }
+  return -1;
+}
+
+template<class T>
+int JobSerdes::executeWorkers(const std::string &job_name, const params_t &params) {
+
+  dbg("Launching "+to_string(num_threads)+" worker threads");
+
+  vector<WorkerSerdes<T> *> w_serdes(num_threads);
+  for(uint64_t i=0; i<num_threads; i++)
+    w_serdes.at(i) = new WorkerSerdes<T>(i, params);
+
   testStart();
   for(auto *w : w_serdes) w->Start();
 
@@ -47,15 +55,21 @@ int JobSerdes::Execute(const std::string &job_name) {
 
   testStop();
 
-
+  uint64_t bytes_packed = 0;
+  uint64_t bytes_copied = 0;
   for(auto *w : w_serdes) {
     ops_completed += w->GetOpsCompleted();
+    bytes_packed += w->GetBytesPacked();
+    bytes_copied += w->GetBytesCopied();
     dbg("Thread ops completed: "+std::to_string(w->GetOpsCompleted()));
     delete w;
   }
 
   DumpJobStats(job_name);
+  if((!dump_tsv) && (ops_completed>0)) {
+    std::cout << "    Average packed size: " << bytes_packed/(num_threads*params.num_iters) << " bytes."
+              << " Bytes copied outside the serializer per op: " << bytes_copied/ops_completed << "\n";
+  }
 
   return 0;
 }
-
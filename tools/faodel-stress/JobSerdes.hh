@@ -16,7 +16,10 @@
  * that object data is packed into a single, continuous buffer. There's always
  * a tradeoff between how easy it is to serdes an object and how quickly it
  * can be converted. This test packs a few different types of data structure
- * into LDOs, using Boost or Lunasa's serdes helpers.
+ * into LDOs, using Boost, Cereal, or Lunasa's serdes helpers. The Boost and
+ * Cereal tests either go through a std::string (Boost/Cereal) or stream
+ * straight into/out of the LDO (BoostLDO/CerealLDO). Each test reports how
+ * many bytes were copied outside of the serializer itself.
  */
 class JobSerdes :
         public Job {
@@ -38,6 +41,14 @@ public:
           {"Strings-Unpack-Small-Cereal",          {64, 1, 2, false,true, 16, 4, 16}},
           {"Strings-PackUnpack-Small-Cereal",      {64, 1, 2, true, true, 16, 4, 16}},
 
+          {"Strings-Pack-Small-BoostLDO",          {64, 1, 4, true, false,16, 4, 16}},
+          {"Strings-Unpack-Small-BoostLDO",        {64, 1, 4, false,true, 16, 4, 16}},
+          {"Strings-PackUnpack-Small-BoostLDO",    {64, 1, 4, true, true, 16, 4, 16}},
+
+          {"Strings-Pack-Small-CerealLDO",         {64, 1, 5, true, false,16, 4, 16}},
+          {"Strings-Unpack-Small-CerealLDO",       {64, 1, 5, false,true, 16, 4, 16}},
+          {"Strings-PackUnpack-Small-CerealLDO",   {64, 1, 5, true, true, 16, 4, 16}},
+
           {"Strings-Pack-Small-LDOPacker",         {64, 1, 3, true, false,16, 4, 16}},
           {"Strings-Unpack-Small-LDOPacker",       {64, 1, 3, false,true, 16, 4, 16}},
           {"Strings-PackUnpack-Small-LDOPacker",   {64, 1, 3, true, true, 16, 4, 16}},
@@ -51,6 +62,14 @@ public:
           {"Strings-Unpack-Large-Cereal",          {64, 1, 2, false,true, 256, 32, 256}},
           {"Strings-PackUnpack-Large-Cereal",      {64, 1, 2, true, true, 256, 32, 256}},
 
+          {"Strings-Pack-Large-BoostLDO",          {64, 1, 4, true, false,256, 32, 256}},
+          {"Strings-Unpack-Large-BoostLDO",        {64, 1, 4, false,true, 256, 32, 256}},
+          {"Strings-PackUnpack-Large-BoostLDO",    {64, 1, 4, true, true, 256, 32, 256}},
+
+          {"Strings-Pack-Large-CerealLDO",         {64, 1, 5, true, false,256, 32, 256}},
+          {"Strings-Unpack-Large-CerealLDO",       {64, 1, 5, false,true, 256, 32, 256}},
+          {"Strings-PackUnpack-Large-CerealLDO",   {64, 1, 5, true, true, 256, 32, 256}},
+
 
           {"Strings-Pack-Large-LDOPacker",         {64, 1, 3, true, false,256, 32, 256}},
           {"Strings-Unpack-Large-LDOPacker",       {64, 1, 3, false,true, 256, 32, 256}},
@@ -65,6 +84,14 @@ public:
           {"Particles-Unpack-Small-Cereal",        {64, 2, 2, false,true, 1024, 0, 0}},
           {"Particles-PackUnpack-Small-Cereal",    {64, 2, 2, true, true, 1024, 0, 0}},
 
+          {"Particles-Pack-Small-BoostLDO",        {64, 2, 4, true, false,1024, 0, 0}},
+          {"Particles-Unpack-Small-BoostLDO",      {64, 2, 4, false,true, 1024, 0, 0}},
+          {"Particles-PackUnpack-Small-BoostLDO",  {64, 2, 4, true, true, 1024, 0, 0}},
+
+          {"Particles-Pack-Small-CerealLDO",       {64, 2, 5, true, false,1024, 0, 0}},
+          {"Particles-Unpack-Small-CerealLDO",     {64, 2, 5, false,true, 1024, 0, 0}},
+          {"Particles-PackUnpack-Small-CerealLDO", {64, 2, 5, true, true, 1024, 0, 0}},
+
           {"Particles-Pack-Small-LDOPacker",       {64, 2, 3, true, false,1024, 0, 0}},
           {"Particles-Unpack-Small-LDOPacker",     {64, 2, 3, false,true, 1024, 0, 0}},
           {"Particles-PackUnpack-Small-LDOPacker", {64, 2, 3, true, true, 1024, 0, 0}}
@@ -73,6 +100,10 @@ public:
 
   constexpr const char* JobCategoryName() { return "serdes"; }
 
+private:
+  template<class T>
+  int executeWorkers(const std::string &job_name, const params_t &params);
+
 };
 
 
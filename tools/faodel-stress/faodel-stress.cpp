@@ -12,6 +12,7 @@
 #include "JobKeys.hh"
 #include "JobLocalPool.hh"
 #include "JobMemoryAlloc.hh"
+#include "JobMutex.hh"
 #include "JobWebClient.hh"
 #include "JobSerdes.hh"
 
@@ -102,6 +103,7 @@ int main(int argc, char **argv) {
   vector<Job *> stressors;
   stressors.push_back(new JobKeys(config));
   stressors.push_back(new JobMemoryAlloc(config));
+  stressors.push_back(new JobMutex(config));
   stressors.push_back(new JobLocalPool(config));
   stressors.push_back(new JobSerdes(config));
   stressors.push_back(new JobWebClient(config));
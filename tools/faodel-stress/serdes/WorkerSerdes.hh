@@ -14,6 +14,8 @@
 #include "faodel-common/SerializationHelpersBoost.hh"
 #include "faodel-common/SerializationHelpersCereal.hh"
 #include "lunasa/DataObject.hh"
+#include "lunasa/common/SerializationHelpersBoost.hh"
+#include "lunasa/common/SerializationHelpersCereal.hh"
 
 #include <boost/serialization/vector.hpp>
 
@@ -30,6 +32,10 @@
 // be one of the Serdes objects, which should have (1) a simple ctor,
 // (2) a templated serialize function for boost serialization, and
 // (3) pup functions for manually packing/unpacking using lunasa helpers.
+//
+// Each worker also tallies how many bytes it packed and how many bytes it
+// had to copy outside of the serializer itself (eg, moving a std::string
+// into an LDO), so the string and LDO-stream methods can be compared.
 
 
 template<class T>
@@ -43,32 +49,41 @@ public:
           : Worker(id, params.num_iters, params.item_len_min, params.item_len_max),
             params(params),
             pack_objects(params.pack),
-            unpack_objects(params.unpack) {
+            unpack_objects(params.unpack),
+            bytes_packed(0),
+            bytes_copied(0) {
 
+    //Note: the string methods copy the data twice in each direction. Packing copies the
+    //      stream's buffer into a string and the string into an LDO. Unpacking copies
+    //      the LDO into a string and the string into the input stream.
     if(params.method==1) { //Boost Serialization
-      f_pack = [](const T &obj) {
+      f_pack = [this](const T &obj) {
         //Have boost make a string that we then copy into an LDO
         std::string s=faodel::BoostPack<T>(obj);
         lunasa::DataObject ldo(s.length());
         std::memcpy(ldo.GetDataPtr(), s.c_str(), s.length());
+        bytes_copied += 2*s.length();
         return ldo;
       };
-      f_unpack = [](const lunasa::DataObject &ldo) {
+      f_unpack = [this](const lunasa::DataObject &ldo) {
         //Pull the string out and let boost do the hard work
         std::string s(ldo.GetDataPtr<char *>(), ldo.GetDataSize());
+        bytes_copied += 2*s.length();
         return faodel::BoostUnpack<T>(s);
       };
     } else if (params.method==2) { //Cereal Serialization
-      f_pack = [](const T &obj) {
+      f_pack = [this](const T &obj) {
           //Have Cereal make a string that we then copy into an LDO
           std::string s=faodel::CerealPack<T>(obj);
           lunasa::DataObject ldo(s.length());
           std::memcpy(ldo.GetDataPtr(), s.c_str(), s.length());
+          bytes_copied += 2*s.length();
           return ldo;
       };
-      f_unpack = [](const lunasa::DataObject &ldo) {
+      f_unpack = [this](const lunasa::DataObject &ldo) {
           //Pull the string out and let boost do the hard work
           std::string s(ldo.GetDataPtr<char *>(), ldo.GetDataSize());
+          bytes_copied += 2*s.length();
           return faodel::CerealUnpack<T>(s);
       };
     } else if (params.method==3) { //LDO Serialization
@@ -79,6 +94,20 @@ public:
         obj.pup(ldo);
         return obj;
       };
+    } else if (params.method==4) { //Boost Serialization straight into/out of an LDO
+      f_pack = [this](const T &obj) { return packToLDO(obj, [](const T &o, std::ostream &os) {
+          boost::archive::binary_oarchive archive(os);
+          archive & o;
+        });
+      };
+      f_unpack = [](const lunasa::DataObject &ldo) { return lunasa::BoostUnpackFromLDO<T>(ldo); };
+    } else if (params.method==5) { //Cereal Serialization straight into/out of an LDO
+      f_pack = [this](const T &obj) { return packToLDO(obj, [](const T &o, std::ostream &os) {
+          cereal::BinaryOutputArchive oarchive(os);
+          oarchive(o);
+        });
+      };
+      f_unpack = [](const lunasa::DataObject &ldo) { return lunasa::CerealUnpackFromLDO<T>(ldo); };
     } else {
       F_ASSERT(0, "Unknown method passed to WorkerSerdes?");
     }
@@ -96,6 +125,7 @@ public:
 
   void server() {
 
+    bytes_copied = 0; //Don't count the objects packed by the ctor
     do {
       if(pack_objects) {
         for(int i = 0; i<batch_size; i++) {
@@ -110,14 +140,31 @@ public:
       ops_completed += batch_size;
     } while(!kill_server);
 
+    for(auto &ldo : packed_objs)
+      bytes_packed += ldo.GetDataSize();
   }
+
+  uint64_t GetBytesPacked() const { return bytes_packed; } //!< Size of the last batch of packed objects
+  uint64_t GetBytesCopied() const { return bytes_copied; } //!< Bytes copied outside of the serializer
+
 private:
 
+  //Same as the lunasa PackToLDO helpers, but keeps track of the copies made when the LDO grows
+  lunasa::DataObject packToLDO(const T &obj, const std::function<void (const T &, std::ostream &)> &f_archive) {
+    lunasa::DataObjectOutputStreambuf buf;
+    std::ostream os(&buf);
+    f_archive(obj, os);
+    bytes_copied += buf.GetBytesCopied();
+    return buf.Finish();
+  }
+
   std::function<lunasa::DataObject (const T &)> f_pack;
   std::function<T (const lunasa::DataObject &)> f_unpack;
 
   bool pack_objects;
   bool unpack_objects;
+  uint64_t bytes_packed;
+  uint64_t bytes_copied;
 
   std::vector<T> objs;
   std::vector<lunasa::DataObject> packed_objs;